@@ -12,7 +12,6 @@
 #include "Common.h"
 #include <NvmHealth.h>
 
-DispInfo gDisplayInfo;
 extern int g_basic_commands;
 
 /* local fns */
@@ -33,7 +32,12 @@ UINT16 TargetMatchCount(struct Command *pInputCmd, struct Command *pCmdToMatch);
  * Global variables
  */
 static UINTN gCommandCount = 0;
+static UINTN gCommandCapacity = 0;
 static struct Command *gCommandList = NULL;
+// Indexes of gCommandList sorted by verb, built on the first lookup after a registration
+static UINTN *gpVerbIndex = NULL;
+// Released value blocks of parsed commands, linked through their first bytes
+static VOID *gpFreeValueBlocks = NULL;
 static CHAR16 *gSyntaxError = NULL;
 static UINTN gPossibleMatchCount = 0;
 static CHAR16 *gDetailedSyntaxError = NULL;
@@ -44,23 +48,29 @@ static CHAR16 *gDetailedSyntaxError = NULL;
 EFI_STATUS RegisterCommand(struct Command *pCommand)
 {
   EFI_STATUS Rc = EFI_SUCCESS;
+  struct Command *pNewCommandList = NULL;
+  UINTN NewCapacity = 0;
 
   /* make sure a verb is specified */
   if (NULL == pCommand || StrLen(pCommand->verb) == 0) {
     NVDIMM_WARN("Failed to register the command because it is invalid");
     Rc = EFI_ABORTED;
   } else {
-    /* allocate memory */
-    if (gCommandCount == 0) {
-      gCommandList = AllocatePool(sizeof(struct Command));
-    } else {
-      gCommandList = ReallocatePool(sizeof(struct Command) * gCommandCount,
-          sizeof(struct Command) * (gCommandCount + 1), gCommandList);
+    /* allocate memory, the list grows geometrically */
+    if (gCommandCount == gCommandCapacity) {
+      NewCapacity = (gCommandCapacity == 0) ? COMMAND_LIST_INITIAL_CAPACITY : gCommandCapacity * 2;
+      pNewCommandList = ReallocatePool(sizeof(struct Command) * gCommandCapacity,
+          sizeof(struct Command) * NewCapacity, gCommandList);
+      if (pNewCommandList != NULL) {
+        gCommandList = pNewCommandList;
+        gCommandCapacity = NewCapacity;
+      }
     }
-    if (gCommandList) {
+    if (gCommandCount < gCommandCapacity) {
       pCommand->CommandId = (UINT8)gCommandCount; // Save its index for better tracking.
       CopyMem_S(&gCommandList[gCommandCount], sizeof(struct Command), pCommand, sizeof(struct Command));
       gCommandCount++;
+      FREE_POOL_SAFE(gpVerbIndex);
     } else {
       NVDIMM_WARN("Failed to register the command due to lack of resources");
       Rc = EFI_OUT_OF_RESOURCES;
@@ -71,6 +81,165 @@ EFI_STATUS RegisterCommand(struct Command *pCommand)
   return Rc;
 }
 
+/*
+ * Check if the commands are registered
+ */
+BOOLEAN CommandsRegistered()
+{
+  return gCommandCount > 0;
+}
+
+/**
+  Compare two verbs without regard to case
+
+  Unlike StrICmp, which only reports whether the strings match, the result
+  orders the verbs consistently, as the verb index needs.
+
+  @param[in] pFirst First verb
+  @param[in] pSecond Second verb
+
+  @retval Negative, 0 or positive as the first verb sorts before, equal to or after the second
+**/
+STATIC
+INTN
+CompareVerbsNoCase(
+  IN     CONST CHAR16 *pFirst,
+  IN     CONST CHAR16 *pSecond
+  )
+{
+  while (*pFirst != L'\0' && NvmToUpper(*pFirst) == NvmToUpper(*pSecond)) {
+    pFirst++;
+    pSecond++;
+  }
+  return (INTN)NvmToUpper(*pFirst) - (INTN)NvmToUpper(*pSecond);
+}
+
+/**
+  Compare the verbs of two registered commands given by their gCommandList indexes
+
+  @param[in] pFirst First command index
+  @param[in] pSecond Second command index
+
+  @retval -1, 0 or 1 as the verbs compare without regard to case
+**/
+STATIC
+INT32
+CompareCommandVerbs(
+  IN     VOID *pFirst,
+  IN     VOID *pSecond
+  )
+{
+  INTN Result = CompareVerbsNoCase(gCommandList[*(UINTN *)pFirst].verb, gCommandList[*(UINTN *)pSecond].verb);
+
+  return (Result < 0) ? -1 : ((Result > 0) ? 1 : 0);
+}
+
+/**
+  Find the registered commands with the given verb
+
+  The commands are returned as a range of the verb index, in the order they were registered.
+
+  @param[in] pVerb Verb to look for
+  @param[out] pFirst First position of the range in gpVerbIndex
+  @param[out] pCount Number of commands with the verb
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+**/
+STATIC
+EFI_STATUS
+FindCommandsByVerb(
+  IN     CONST CHAR16 *pVerb,
+     OUT UINTN *pFirst,
+     OUT UINTN *pCount
+  )
+{
+  EFI_STATUS Rc = EFI_SUCCESS;
+  UINTN Index = 0;
+  UINTN Low = 0;
+  UINTN High = gCommandCount;
+  UINTN Middle = 0;
+
+  *pFirst = 0;
+  *pCount = 0;
+
+  if (gCommandCount == 0) {
+    return EFI_SUCCESS;
+  }
+
+  if (gpVerbIndex == NULL) {
+    gpVerbIndex = AllocatePool(sizeof(*gpVerbIndex) * gCommandCount);
+    if (gpVerbIndex == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+    for (Index = 0; Index < gCommandCount; Index++) {
+      gpVerbIndex[Index] = Index;
+    }
+    // The sort is stable so the commands of a verb keep their registration order
+    Rc = MergeSort(gpVerbIndex, (UINT32)gCommandCount, sizeof(*gpVerbIndex), CompareCommandVerbs);
+    if (EFI_ERROR(Rc)) {
+      FREE_POOL_SAFE(gpVerbIndex);
+      return Rc;
+    }
+  }
+
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (CompareVerbsNoCase(gCommandList[gpVerbIndex[Middle]].verb, pVerb) < 0) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+  for (High = Low; High < gCommandCount && CompareVerbsNoCase(gCommandList[gpVerbIndex[High]].verb, pVerb) == 0; High++);
+
+  *pFirst = Low;
+  *pCount = High - Low;
+  return EFI_SUCCESS;
+}
+
+/**
+  Assign the target and option value buffers of a command being parsed
+
+  All the buffers come from a single block, blocks released by FreeCommandStructure
+  are reused so that a parse does not allocate in batch and library usage.
+
+  @param[in out] pCommand pointer to the command structure
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+**/
+STATIC
+EFI_STATUS
+AllocateCommandValues(
+  IN OUT struct Command *pCommand
+  )
+{
+  CHAR16 *pBlock = NULL;
+  UINT32 Index = 0;
+
+  if (gpFreeValueBlocks != NULL) {
+    pBlock = gpFreeValueBlocks;
+    gpFreeValueBlocks = *(VOID **)pBlock;
+    ZeroMem(pBlock, COMMAND_VALUES_BLOCK_SIZE);
+  } else {
+    pBlock = AllocateZeroPool(COMMAND_VALUES_BLOCK_SIZE);
+    if (pBlock == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+
+  for (Index = 0; Index < MAX_TARGETS; Index++) {
+    pCommand->targets[Index].pTargetValueStr = pBlock;
+    pBlock += TARGET_VALUE_LEN;
+  }
+  for (Index = 0; Index < MAX_OPTIONS; Index++) {
+    pCommand->options[Index].pOptionValueStr = pBlock;
+    pBlock += PARSER_OPTION_VALUE_LEN;
+  }
+  return EFI_SUCCESS;
+}
+
 /**
   Free the allocated memory for target values
   in  the CLI command structure.
@@ -84,12 +253,16 @@ FreeCommandStructure(
 {
   UINT32 Index = 0;
 
-  if (pCommand != NULL) {
+  if (pCommand != NULL && pCommand->targets[0].pTargetValueStr != NULL) {
+    // The first target value is the start of the block, keep it for the next parse
+    *(VOID **)pCommand->targets[0].pTargetValueStr = gpFreeValueBlocks;
+    gpFreeValueBlocks = pCommand->targets[0].pTargetValueStr;
+
     for (Index = 0; Index < MAX_TARGETS; Index++) {
-      FREE_POOL_SAFE(pCommand->targets[Index].pTargetValueStr);
+      pCommand->targets[Index].pTargetValueStr = NULL;
     }
     for (Index = 0; Index < MAX_OPTIONS; Index++) {
-      FREE_POOL_SAFE(pCommand->options[Index].pOptionValueStr);
+      pCommand->options[Index].pOptionValueStr = NULL;
     }
   }
 }
@@ -154,9 +327,18 @@ VOID SetDetailedSyntaxError(
  */
 void FreeCommands()
 {
+  VOID *pBlock = NULL;
+
   NVDIMM_ENTRY();
   gCommandCount = 0;
+  gCommandCapacity = 0;
   FREE_POOL_SAFE(gCommandList);
+  FREE_POOL_SAFE(gpVerbIndex);
+  while (gpFreeValueBlocks != NULL) {
+    pBlock = gpFreeValueBlocks;
+    gpFreeValueBlocks = *(VOID **)pBlock;
+    FreePool(pBlock);
+  }
   FREE_POOL_SAFE(gSyntaxError);
   FREE_POOL_SAFE(gDetailedSyntaxError);
 
@@ -236,6 +418,9 @@ Parse(
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
   UINTN Start = 0;
   UINTN Index = 0;
+  UINTN FirstVerbCommand = 0;
+  UINTN VerbCommandsCount = 0;
+  struct Command *pMatch = NULL;
   CHAR16 *pHelpStr = NULL;
 
   NVDIMM_ENTRY();
@@ -246,7 +431,14 @@ Parse(
   gPossibleMatchCount = 0;
 
   /* check input parameters */
-  if (pCommand == NULL || pInput == NULL || pInput->ppTokens == NULL) {
+  if (pCommand == NULL) {
+    goto Finish;
+  }
+
+  // Cleared first so that FreeCommandStructure can always be called after Parse
+  ZeroMem(pCommand, sizeof(struct Command));
+
+  if (pInput == NULL || pInput->ppTokens == NULL) {
     goto Finish;
   }
 
@@ -257,21 +449,9 @@ Parse(
 
   /* parse the input */
   Start = 0;
-  ZeroMem(pCommand, sizeof(struct Command));
-  for (Index = 0; Index < MAX_TARGETS; Index++) {
-    pCommand->targets[Index].pTargetValueStr = AllocateZeroPool(TARGET_VALUE_LEN * sizeof(CHAR16));
-    if (!pCommand->targets[Index].pTargetValueStr) {
-      ReturnCode = EFI_OUT_OF_RESOURCES;
-      break;
-    }
-  }
-
-  for (Index = 0; Index < MAX_OPTIONS; Index++) {
-    pCommand->options[Index].pOptionValueStr = AllocateZeroPool(PARSER_OPTION_VALUE_LEN * sizeof(CHAR16));
-    if (!pCommand->options[Index].pOptionValueStr) {
-      ReturnCode = EFI_OUT_OF_RESOURCES;
-      break;
-    }
+  ReturnCode = AllocateCommandValues(pCommand);
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
   }
 
   ReturnCode = findVerb(&Start, pInput, pCommand);
@@ -322,26 +502,28 @@ Parse(
     goto Finish;
   }
 
-  /* try to match the parsed input against a registered command */
-  for (Index = 0; Index < gCommandCount; Index++) {
-    ReturnCode = MatchCommand(pCommand, &gCommandList[Index]);
+  /* try to match the parsed input against the registered commands with the same verb */
+  ReturnCode = FindCommandsByVerb(pCommand->verb, &FirstVerbCommand, &VerbCommandsCount);
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
+  }
+
+  ReturnCode = EFI_INVALID_PARAMETER;
+  for (Index = FirstVerbCommand; Index < FirstVerbCommand + VerbCommandsCount; Index++) {
+    pMatch = &gCommandList[gpVerbIndex[Index]];
+    ReturnCode = MatchCommand(pCommand, pMatch);
     if (!EFI_ERROR(ReturnCode)) {
-      pCommand->run = gCommandList[Index].run;
-      pCommand->PrinterCtrlSupported = gCommandList[Index].PrinterCtrlSupported;
-      pCommand->ExcludeDriverBinding = gCommandList[Index].ExcludeDriverBinding;
+      pCommand->run = pMatch->run;
+      pCommand->PrinterCtrlSupported = pMatch->PrinterCtrlSupported;
+      pCommand->ExcludeDriverBinding = pMatch->ExcludeDriverBinding;
       break;
     }
   }
 
-  if (EFI_ERROR(ReturnCode)) {
-    for (Index = 0; Index < gCommandCount; Index++) {
-      //if at least the verb matches, then set this command up for help display
-      if (StrICmp(pCommand->verb, gCommandList[Index].verb) == 0) {
-        pCommand->ShowHelp = TRUE;
-        ReturnCode = EFI_SUCCESS;
-        break;
-      }
-    }
+  //if at least the verb matches, then set this command up for help display
+  if (EFI_ERROR(ReturnCode) && VerbCommandsCount > 0) {
+    pCommand->ShowHelp = TRUE;
+    ReturnCode = EFI_SUCCESS;
   }
 
   /* try to give the user more useful help */
@@ -373,7 +555,8 @@ Finish:
 EFI_STATUS findVerb(UINTN *pStart, struct CommandInput *pInput, struct Command *pCommand)
 {
   EFI_STATUS rc = EFI_INVALID_PARAMETER;
-  UINTN i = 0;
+  UINTN First = 0;
+  UINTN Count = 0;
 
   NVDIMM_ENTRY();
   /* there has to be at least one verb */
@@ -382,16 +565,19 @@ EFI_STATUS findVerb(UINTN *pStart, struct CommandInput *pInput, struct Command *
     return rc;
   }
 
-  for (i = 0; i < gCommandCount; i++)
+  rc = FindCommandsByVerb(pInput->ppTokens[*pStart], &First, &Count);
+  if (EFI_ERROR(rc)) {
+    NVDIMM_EXIT_I64(rc);
+    return rc;
+  }
+
+  rc = EFI_INVALID_PARAMETER;
+  if (Count > 0)
   {
-    if (StrICmp(gCommandList[i].verb, pInput->ppTokens[*pStart]) == 0)
-    {
-      /* verb matches, so store it and move on */
-      StrnCpyS(pCommand->verb, VERB_LEN, pInput->ppTokens[*pStart], VERB_LEN - 1);
-      (*pStart)++;
-      rc = EFI_SUCCESS;
-      break;
-    }
+    /* verb matches, so store it and move on */
+    StrnCpyS(pCommand->verb, VERB_LEN, pInput->ppTokens[*pStart], VERB_LEN - 1);
+    (*pStart)++;
+    rc = EFI_SUCCESS;
   }
   /* more detailed error */
   if (EFI_ERROR(rc))
@@ -1779,63 +1965,6 @@ GetUnitsOption(
   return ReturnCode;
 }
 
-/**
-Sets a display information needed when outputting alternative formats like XML.
-@param[in] pName is a CHAR16 string that represents the output message.
-@param[in] Type represents the type of output being displayed.
-@param[in] pDelims is a CHAR16 string that represents deliminters to use when parsing text output
-@retval EFI_SUCCESS if the name was copied correctly.
-@retval EFI_INVALID_PARAMETER if any of the parameters is a NULL.
-**/
-EFI_STATUS
-SetDisplayInfo(
-    IN     CONST CHAR16 *pName,
-    IN     CONST UINT8 Type,
-    IN     CONST CHAR16 *pDelims
-)
-{
-    if (NULL == pName){
-        return EFI_INVALID_PARAMETER;
-    }
-    UnicodeSPrint(gDisplayInfo.Name, sizeof(gDisplayInfo.Name), FORMAT_STR, pName);
-    gDisplayInfo.Type = Type;
-    if(pDelims) {
-      UnicodeSPrint(gDisplayInfo.Delims, sizeof(gDisplayInfo.Delims), FORMAT_STR, pDelims);
-    }
-    else {
-      UnicodeSPrint(gDisplayInfo.Delims, sizeof(gDisplayInfo.Delims), L"");
-    }
-    return EFI_SUCCESS;
-}
-
-/**
-Get display information needed when outputting alternative formats like XML.
-@param[out] pName is a CHAR16 string that represents the output message.
-@param[int] NameSize is the size of pName in bytes
-@param[out] pType represents the type of output being displayed.
-@param[out] pDelims represents the deliminters to use when parsing text output.
-@param[int] DelimsSize is the size of pDelims in bytes
-@retval EFI_SUCCESS if the name was copied correctly.
-@retval EFI_INVALID_PARAMETER if any of the parameters is a NULL.
-**/
-EFI_STATUS
-GetDisplayInfo(
-   OUT    CHAR16 *pName,
-   IN     CONST UINT32 NameSize,
-   OUT    UINT8 *pType,
-   OUT    CHAR16 *pDelims,
-   IN     CONST UINT32 DelimnsSize
-)
-{
-   if (NULL == pName || NULL == pType || NULL == pDelims){
-      return EFI_INVALID_PARAMETER;
-   }
-   UnicodeSPrint(pName, NameSize, FORMAT_STR, gDisplayInfo.Name);
-   UnicodeSPrint(pDelims, DelimnsSize, FORMAT_STR, gDisplayInfo.Delims);
-   *pType = gDisplayInfo.Type;
-   return EFI_SUCCESS;
-}
-
 /**
 Execute UpdateCmdCtx (if defined), run, and RunCleanup (if defined).
 @param[in] pCommand pointer to the command structure
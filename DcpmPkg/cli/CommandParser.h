@@ -13,7 +13,6 @@
 #include <Utility.h>
 
 #define DISP_NAME_LEN             32    //!< Display string length (used when formatting output in alternative formats)
-#define DISP_DELIMS_LEN           10    //!< Deliminter string length (used when formatting output in alternative formats)
 #define VERB_LEN                  16    //!< Verb string length
 #define TARGET_LEN                32    //!< Target name string length
 #define TARGET_VALUE_LEN          4096  //!< Target value string length for maximum-possible DIMM IDs
@@ -24,6 +23,9 @@
 #define PROPERTY_VALUE_LEN        128   //!< Property value string length
 #define MAX_TARGETS               8     //!< Maximum number of targets in a single command
 #define MAX_OPTIONS               12     //!< Maximum number of options in a single command
+#define COMMAND_LIST_INITIAL_CAPACITY 64 //!< Number of registered commands the command list is first allocated for
+//! Size of the block holding all the target and option values of a parsed command
+#define COMMAND_VALUES_BLOCK_SIZE ((MAX_TARGETS * TARGET_VALUE_LEN + MAX_OPTIONS * PARSER_OPTION_VALUE_LEN) * sizeof(CHAR16))
 #define MAX_PROPERTIES            20    //!< Maximum number of properties in a single command
 #define MAX_TOKENS                50    //!< Maximum number of tokens per line
 
@@ -142,6 +144,8 @@
 #define PREFERENCES_TARGET                   L"-preferences"             //!< 'preferences' target value
 #define PERFORMANCE_TARGET                   L"-performance"             //!< 'performance' target value
 #define SESSION_TARGET                       L"-session"                 //!< 'session' target value
+#define NAMESPACE_IMAGE_TARGET               L"-namespaceimage"          //!< 'namespaceimage' target value
+#define TRANSLATE_TARGET                     L"-translate"               //!< 'translate' target value
 #define PBR_MODE_TARGET                      L"-mode"                    //!< 'mode' target value
 #define PBR_RECORD_MODE_VAL                  L"record"                   //!< 'mode' target value
 #define PBR_PLAYBACK_MODE_VAL                L"playback"                 //!< 'mode' target value
@@ -390,18 +394,6 @@ struct property
   UINT8 ValueRequirement;
 };
 
-enum DisplayType {
-  ResultsView   = 0,
-  ListView      = 1,
-  ListView2L    = 2,
-  TableView     = 3,
-  TableTabView  = 4,
-  ErrorView     = 5,
-  HelpView      = 6,
-  DiagView      = 7
-};
-
-
 /**
   Defines the parts of a CLI command
 **/
@@ -433,20 +425,18 @@ struct CommandInput
   CHAR16 **ppTokens;
 } COMMAND_INPUT;
 
-typedef
-struct _DispInfo
-{
-   CHAR16 Name[DISP_NAME_LEN];
-   UINT8 Type;
-   CHAR16 Delims[DISP_DELIMS_LEN];
-}DispInfo;
-
-extern DispInfo gDisplayInfo;
 /**
   Add the specified command to the list of supported commands
 **/
 EFI_STATUS RegisterCommand(struct Command *pCommand);
 
+/**
+  Check if the commands are registered
+
+  @retval TRUE if at least one command is registered
+**/
+BOOLEAN CommandsRegistered();
+
 /**
   Free the allocated memory for target values
   in  the CLI command structure.
@@ -656,40 +646,6 @@ GetUnitsOption(
      OUT UINT16 *pUnitsToDisplay
   );
 
-/**
-Sets a display information needed when outputting alternative formats like XML.
-@param[in] pName is a CHAR16 string that represents the output message.
-@param[in] Type represents the type of output being displayed.
-@param[in] pDelims is a CHAR16 string that represents deliminters to use when parsing text output
-@retval EFI_SUCCESS if the name was copied correctly.
-@retval EFI_INVALID_PARAMETER if any of the parameters is a NULL.
-**/
-EFI_STATUS
-SetDisplayInfo(
-  IN     CONST CHAR16 *pName,
-  IN     CONST UINT8 Type,
-  IN     CONST CHAR16 *pDelims
-);
-
-/**
-Get display information needed when outputting alternative formats like XML.
-@param[out] pName is a CHAR16 string that represents the output message.
-@param[int] NameSize is the size of pName in bytes
-@param[out] pType represents the type of output being displayed.
-@param[out] pDelims represents the deliminters to use when parsing text output.
-@param[int] DelimsSize is the size of pDelims in bytes
-@retval EFI_SUCCESS if the name was copied correctly.
-@retval EFI_INVALID_PARAMETER if any of the parameters is a NULL.
-**/
-EFI_STATUS
-GetDisplayInfo(
-  OUT    CHAR16 *pName,
-  IN     CONST UINT32 NameSize,
-  OUT    UINT8 *pType,
-  OUT    CHAR16 *pDelims,
-  IN     CONST UINT32 DelimnsSize
-);
-
 /**
 Execute UpdateCmdCtx (if defined), run, and RunCleanup (if defined).
 @param[in] pCommand pointer to the command structure
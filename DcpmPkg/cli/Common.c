@@ -179,7 +179,7 @@ GetDimmList(
     goto FinishError;
   }
 
-  ReturnCode = BubbleSort((VOID*)*ppDimms, *pDimmCount, sizeof(**ppDimms), CompareDimmIdInDimmInfo);
+  ReturnCode = MergeSort((VOID*)*ppDimms, *pDimmCount, sizeof(**ppDimms), CompareDimmIdInDimmInfo);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("Dimms list may not be sorted");
     goto FinishError;
@@ -289,7 +289,7 @@ GetAllDimmList(
     }
   }
 
-  ReturnCode = BubbleSort((VOID*)*ppDimms, *pDimmCount, sizeof(**ppDimms), CompareDimmIdInDimmInfo);
+  ReturnCode = MergeSort((VOID*)*ppDimms, *pDimmCount, sizeof(**ppDimms), CompareDimmIdInDimmInfo);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("Dimms list may not be sorted");
     goto FinishError;
@@ -849,7 +849,7 @@ Finish:
       }
     }
 
-    ReturnCode = BubbleSort((VOID*)pDimms, *pDimmIdsCount, sizeof(*pDimms), CompareDimmIdInDimmInfo);
+    ReturnCode = MergeSort((VOID*)pDimms, *pDimmIdsCount, sizeof(*pDimms), CompareDimmIdInDimmInfo);
     if (EFI_ERROR(ReturnCode)) {
       NVDIMM_DBG("Dimms list may not be sorted");
       goto Finish;
@@ -114,8 +114,6 @@ DeletePcdCmd(
 
   NVDIMM_ENTRY();
 
-  SetDisplayInfo(L"DeletePcd", ResultsView, NULL);
-
   ZeroMem(DimmStr, sizeof(DimmStr));
   ZeroMem(DimmIdsWithNamespaces, sizeof(DimmIdsWithNamespaces));
 
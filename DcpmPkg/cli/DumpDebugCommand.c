@@ -11,6 +11,16 @@
 #include "Debug.h"
 #include "Convert.h"
 #include "Nlog.h"
+#ifdef OS_BUILD
+#include <stdio.h>
+#include <Dimm.h>
+#include <NvmDimmDriver.h>
+
+extern NVMDIMMDRIVER_DATA *gNvmDimmData;
+
+/** Attempts to fetch a debug log source, interrupted streams resume from the last page **/
+#define DUMP_DEBUG_LOG_FETCH_ATTEMPTS   3
+#endif
 
  /**
    Get FW debug log syntax definition
@@ -55,6 +65,417 @@ RegisterDumpDebugCommand(
   return ReturnCode;
 }
 
+#ifdef OS_BUILD
+/**
+  Outcome of streaming one debug log source of a PMem module
+**/
+typedef struct _DUMP_DEBUG_SOURCE_RESULT {
+  EFI_STATUS ReturnCode;              //!< Result of fetching the log
+  EFI_STATUS HandlerReturnCode;       //!< Result of writing the fetched pages
+  COMMAND_STATUS *pCommandStatus;     //!< Detailed status of the fetch
+  CHAR16 *pRawFileName;               //!< Raw log file
+  CHAR16 *pDecodedFileName;           //!< Decoded log file
+  FILE *pRawFile;                     //!< Opened with the first fetched page
+  FILE *pDecodedFile;                 //!< NULL when no dictionary is given
+  nlog_dict_entry *pDictHead;         //!< NULL when no dictionary is given
+  UINT32 DictVersion;
+  nlog_decoder Decoder;
+  EFI_STATUS DecodeReturnCode;        //!< Result of finishing the decoder
+  UINT64 BytesWritten;
+} DUMP_DEBUG_SOURCE_RESULT;
+
+/**
+  Work of dumping all debug log sources of one PMem module
+**/
+typedef struct _DUMP_DEBUG_DIMM_CONTEXT {
+  EFI_DCPMM_CONFIG2_PROTOCOL *pNvmDimmConfigProtocol;
+  DIMM_INFO *pDimm;
+  CHAR16 *pDumpUserPath;
+  UINT32 DictVersion;
+  nlog_dict_entry *pDictHead;         //!< NULL when no dictionary is given
+  DUMP_DEBUG_SOURCE_RESULT Sources[NUM_FW_DEBUG_LOG_SOURCES];
+} DUMP_DEBUG_DIMM_CONTEXT;
+
+STATIC CHAR16 *gDebugLogSourceNames[NUM_FW_DEBUG_LOG_SOURCES] = {L"media", L"sram", L"spi"};
+
+/**
+  Open a dump file for writing
+
+  @param[in] pFileName path to the file
+  @param[out] ppFile opened file
+
+  @retval EFI_SUCCESS on success
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval EFI_INVALID_PARAMETER the file could not be opened
+**/
+STATIC
+EFI_STATUS
+OpenDumpFile(
+  IN     CHAR16 *pFileName,
+     OUT FILE **ppFile
+  )
+{
+  UINTN PathSize = StrLen(pFileName) + 1;
+  CHAR8 *pPath = AllocatePool(PathSize);
+
+  if (pPath == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  UnicodeStrToAsciiStrS(pFileName, pPath, PathSize);
+  *ppFile = fopen(pPath, "wb+");
+  FreePool(pPath);
+
+  return (*ppFile == NULL) ? EFI_INVALID_PARAMETER : EFI_SUCCESS;
+}
+
+/**
+  NLOG writer appending the decoded lines to the decoded file
+**/
+STATIC
+EFI_STATUS
+WriteDecodedDebugLog(
+  IN     VOID *pContext,
+  IN     CHAR8 *pData,
+  IN     UINT64 Size
+  )
+{
+  FILE *pFile = (FILE *)pContext;
+
+  if (fwrite(pData, 1, (size_t)Size, pFile) != Size) {
+    return EFI_VOLUME_FULL;
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Open the files of a debug log source and start its decoder
+
+  @param[in,out] pSource the debug log source
+
+  @retval EFI_SUCCESS on success
+  @retval other a file could not be opened or the decoder not started
+**/
+STATIC
+EFI_STATUS
+OpenDebugLogSourceFiles(
+  IN OUT DUMP_DEBUG_SOURCE_RESULT *pSource
+  )
+{
+  EFI_STATUS ReturnCode = OpenDumpFile(pSource->pRawFileName, &pSource->pRawFile);
+
+  if (EFI_ERROR(ReturnCode) || pSource->pDictHead == NULL) {
+    return ReturnCode;
+  }
+
+  ReturnCode = OpenDumpFile(pSource->pDecodedFileName, &pSource->pDecodedFile);
+  if (EFI_ERROR(ReturnCode)) {
+    return ReturnCode;
+  }
+  return nlog_decoder_init(&pSource->Decoder, pSource->DictVersion, pSource->pDictHead,
+      WriteDecodedDebugLog, pSource->pDecodedFile);
+}
+
+/**
+  Page handler writing every fetched page to the raw file and the decoder
+
+  The files are created with the first page, a module without logs or
+  failing before any page leaves nothing behind.
+**/
+STATIC
+EFI_STATUS
+WriteDebugLogPage(
+  IN     VOID *pContext,
+  IN     UINT32 LogPageOffset,
+  IN     UINT8 *pChunk,
+  IN     UINT64 ChunkSize,
+  IN     UINT64 LogSize
+  )
+{
+  DUMP_DEBUG_SOURCE_RESULT *pSource = (DUMP_DEBUG_SOURCE_RESULT *)pContext;
+
+  if (pSource->pRawFile == NULL) {
+    pSource->HandlerReturnCode = OpenDebugLogSourceFiles(pSource);
+    if (EFI_ERROR(pSource->HandlerReturnCode)) {
+      return pSource->HandlerReturnCode;
+    }
+  }
+
+  if (fwrite(pChunk, 1, (size_t)ChunkSize, pSource->pRawFile) != ChunkSize) {
+    pSource->HandlerReturnCode = EFI_VOLUME_FULL;
+    return pSource->HandlerReturnCode;
+  }
+  pSource->BytesWritten += ChunkSize;
+
+  if (pSource->pDecodedFile != NULL) {
+    pSource->HandlerReturnCode = nlog_decode_chunk(&pSource->Decoder, pChunk, ChunkSize);
+  }
+  return pSource->HandlerReturnCode;
+}
+
+/**
+  Stream one debug log source of a PMem module to its files
+
+  An interrupted fetch is resumed from the first page not yet written. The
+  files are opened by the page handler once the first page is fetched.
+
+  @param[in] pContext the PMem module to dump
+  @param[in] LogSource the debug log source
+**/
+STATIC
+VOID
+DumpDebugLogSource(
+  IN     DUMP_DEBUG_DIMM_CONTEXT *pContext,
+  IN     UINT8 LogSource
+  )
+{
+  DUMP_DEBUG_SOURCE_RESULT *pSource = &pContext->Sources[LogSource];
+  UINT32 PageOffset = 0;
+  UINT32 Attempt = 0;
+
+  pSource->ReturnCode = InitializeCommandStatus(&pSource->pCommandStatus);
+  if (EFI_ERROR(pSource->ReturnCode)) {
+    return;
+  }
+
+  pSource->pRawFileName = CatSPrint(pContext->pDumpUserPath, L"_" FORMAT_STR L"_0x%04x_" FORMAT_STR L".bin",
+      pContext->pDimm->DimmUid, pContext->pDimm->DimmHandle, gDebugLogSourceNames[LogSource]);
+  pSource->pDecodedFileName = CatSPrint(pContext->pDumpUserPath, L"_" FORMAT_STR L"_0x%04x_" FORMAT_STR L".txt",
+      pContext->pDimm->DimmUid, pContext->pDimm->DimmHandle, gDebugLogSourceNames[LogSource]);
+  if (pSource->pRawFileName == NULL || pSource->pDecodedFileName == NULL) {
+    pSource->ReturnCode = EFI_OUT_OF_RESOURCES;
+    return;
+  }
+
+  pSource->pDictHead = pContext->pDictHead;
+  pSource->DictVersion = pContext->DictVersion;
+
+  for (Attempt = 0; Attempt < DUMP_DEBUG_LOG_FETCH_ATTEMPTS; Attempt++) {
+    pSource->ReturnCode = pContext->pNvmDimmConfigProtocol->GetFwDebugLogStream(pContext->pNvmDimmConfigProtocol,
+        pContext->pDimm->DimmID, LogSource, PageOffset, WriteDebugLogPage, pSource, &PageOffset,
+        pSource->pCommandStatus);
+    // Only a failed fetch is worth another attempt
+    if (!EFI_ERROR(pSource->ReturnCode) || pSource->ReturnCode == EFI_NOT_STARTED ||
+        EFI_ERROR(pSource->HandlerReturnCode)) {
+      break;
+    }
+    NVDIMM_WARN("Fetching FW debug log interrupted at page %d, resuming", PageOffset);
+  }
+
+  if (pSource->Decoder.write != NULL) {
+    pSource->DecodeReturnCode = nlog_decoder_finish(&pSource->Decoder);
+  }
+}
+
+/**
+  RunOnDimms worker dumping all debug log sources of one PMem module
+
+  @param[in] pDimm the PMem module
+  @param[in] pArg the DUMP_DEBUG_DIMM_CONTEXT of the PMem module
+
+  @retval EFI_SUCCESS always, the outcome of each source is kept in the context
+**/
+STATIC
+EFI_STATUS
+DumpDebugDimmWorker(
+  IN     DIMM *pDimm,
+  IN     VOID *pArg
+  )
+{
+  DUMP_DEBUG_DIMM_CONTEXT *pContext = (DUMP_DEBUG_DIMM_CONTEXT *)pArg;
+  UINT8 IndexSource = 0;
+
+  for (IndexSource = 0; IndexSource < NUM_FW_DEBUG_LOG_SOURCES; IndexSource++) {
+    DumpDebugLogSource(pContext, IndexSource);
+    if (pContext->Sources[IndexSource].pRawFile != NULL) {
+      fclose(pContext->Sources[IndexSource].pRawFile);
+      pContext->Sources[IndexSource].pRawFile = NULL;
+    }
+    if (pContext->Sources[IndexSource].pDecodedFile != NULL) {
+      fclose(pContext->Sources[IndexSource].pDecodedFile);
+      pContext->Sources[IndexSource].pDecodedFile = NULL;
+    }
+  }
+  return EFI_SUCCESS;
+}
+
+/**
+  Report the dump of one debug log source
+
+  @param[in] pPrinterCtx printer context
+  @param[in] pSource outcome of the dump
+  @param[in] IndexSource the debug log source
+
+  @retval TRUE the log was dumped
+**/
+STATIC
+BOOLEAN
+PrintDebugLogSourceResult(
+  IN     PRINT_CONTEXT *pPrinterCtx,
+  IN     DUMP_DEBUG_SOURCE_RESULT *pSource,
+  IN     UINT8 IndexSource
+  )
+{
+  EFI_STATUS ReturnCode = pSource->ReturnCode;
+
+  if (ReturnCode == EFI_NOT_STARTED) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode,
+      L"No " FORMAT_STR L" FW debug logs found\n", gDebugLogSourceNames[IndexSource]);
+    return FALSE;
+  }
+
+  if (EFI_ERROR(pSource->HandlerReturnCode)) {
+    ReturnCode = pSource->HandlerReturnCode;
+    if (ReturnCode == EFI_VOLUME_FULL) {
+      PRINTER_SET_MSG(pPrinterCtx, ReturnCode,
+          L"Not enough space to save file " FORMAT_STR L"\n", pSource->pRawFileName);
+    }
+    else {
+      PRINTER_SET_MSG(pPrinterCtx, ReturnCode,
+          L"Failed to dump " FORMAT_STR L" FW debug logs to file " FORMAT_STR L"\n",
+          gDebugLogSourceNames[IndexSource], pSource->pRawFileName);
+    }
+    return FALSE;
+  }
+
+  if (EFI_ERROR(ReturnCode)) {
+    if (pSource->pCommandStatus != NULL && pSource->pCommandStatus->GeneralStatus != NVM_SUCCESS) {
+      ReturnCode = MatchCliReturnCode(pSource->pCommandStatus->GeneralStatus);
+      PRINTER_SET_MSG(pPrinterCtx, ReturnCode,
+        L"Unexpected error in retrieving " FORMAT_STR L" FW debug logs\n", gDebugLogSourceNames[IndexSource]);
+      PRINTER_SET_COMMAND_STATUS(pPrinterCtx, ReturnCode, CLI_INFO_DUMP_DEBUG_LOG, L" ", pSource->pCommandStatus);
+    }
+    else {
+      PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_INTERNAL_ERROR);
+    }
+    return FALSE;
+  }
+
+  PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Dumped " FORMAT_STR L" FW debug logs to file " FORMAT_STR L"\n",
+      gDebugLogSourceNames[IndexSource], pSource->pRawFileName);
+
+  if (pSource->pDecodedFileName != NULL && pSource->Decoder.write != NULL) {
+    if (pSource->DecodeReturnCode == EFI_END_OF_FILE) {
+      PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Unexpected end of buffer.\n");
+    }
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Decoded %lu records to file " FORMAT_STR "\n",
+        pSource->Decoder.node_count, pSource->pDecodedFileName);
+  }
+  return TRUE;
+}
+
+/**
+  Dump the debug logs of the specified PMem modules in parallel (see RunOnDimms)
+
+  The logs are streamed to disk page by page, so memory use does not depend
+  on the log size.
+
+  @param[in] pCmd command from CLI
+  @param[in] pNvmDimmConfigProtocol config protocol
+  @param[in] pDimms all PMem modules
+  @param[in] DimmCount number of PMem modules
+  @param[in] pDimmIds specified PMem modules, all when DimmIdsNum is 0
+  @param[in] DimmIdsNum number of specified PMem modules
+  @param[in] pDumpUserPath destination prefix
+  @param[in] pDictHead dictionary, NULL to skip decoding
+  @param[in] DictVersion version of the dictionary
+  @param[out] pSuccessesPerDimm number of dumped sources of each specified module
+
+  @retval EFI_SUCCESS on success
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+**/
+STATIC
+EFI_STATUS
+DumpDebugLogsParallel(
+  IN     struct Command *pCmd,
+  IN     EFI_DCPMM_CONFIG2_PROTOCOL *pNvmDimmConfigProtocol,
+  IN     DIMM_INFO *pDimms,
+  IN     UINT32 DimmCount,
+  IN     UINT16 *pDimmIds,
+  IN     UINT32 DimmIdsNum,
+  IN     CHAR16 *pDumpUserPath,
+  IN     nlog_dict_entry *pDictHead,
+  IN     UINT32 DictVersion,
+     OUT INT8 *pSuccessesPerDimm
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  DUMP_DEBUG_DIMM_CONTEXT *pContexts = NULL;
+  DIMM **ppDimms = NULL;
+  VOID **ppArgs = NULL;
+  EFI_STATUS *pReturnCodes = NULL;
+  UINT32 *pDimmIndexes = NULL;
+  UINT32 DimmsNum = 0;
+  UINT32 Index = 0;
+  UINT8 IndexSource = 0;
+
+  pContexts = AllocateZeroPool(sizeof(*pContexts) * DimmCount);
+  ppDimms = AllocateZeroPool(sizeof(*ppDimms) * DimmCount);
+  ppArgs = AllocateZeroPool(sizeof(*ppArgs) * DimmCount);
+  pReturnCodes = AllocateZeroPool(sizeof(*pReturnCodes) * DimmCount);
+  pDimmIndexes = AllocateZeroPool(sizeof(*pDimmIndexes) * DimmCount);
+  if (pContexts == NULL || ppDimms == NULL || ppArgs == NULL || pReturnCodes == NULL || pDimmIndexes == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    PRINTER_SET_MSG(pCmd->pPrintCtx, ReturnCode, FORMAT_STR_NL, CLI_ERR_OUT_OF_MEMORY);
+    goto Finish;
+  }
+
+  // -1 marks the modules that are not specified, they are not checked for successes
+  for (Index = 0; Index < DimmCount; Index++) {
+    pSuccessesPerDimm[Index] = -1;
+  }
+
+  for (Index = 0; Index < DimmCount; Index++) {
+    if (DimmIdsNum > 0 && !ContainUint(pDimmIds, DimmIdsNum, pDimms[Index].DimmID)) {
+      continue;
+    }
+    ppDimms[DimmsNum] = GetDimmByPid(pDimms[Index].DimmID, &gNvmDimmData->PMEMDev.Dimms);
+    if (ppDimms[DimmsNum] == NULL) {
+      pSuccessesPerDimm[Index] = 0;
+      PRINTER_SET_MSG(pCmd->pPrintCtx, EFI_NOT_FOUND, CLI_ERR_INTERNAL_ERROR);
+      continue;
+    }
+    pContexts[DimmsNum].pNvmDimmConfigProtocol = pNvmDimmConfigProtocol;
+    pContexts[DimmsNum].pDimm = &pDimms[Index];
+    pContexts[DimmsNum].pDumpUserPath = pDumpUserPath;
+    pContexts[DimmsNum].pDictHead = pDictHead;
+    pContexts[DimmsNum].DictVersion = DictVersion;
+    ppArgs[DimmsNum] = &pContexts[DimmsNum];
+    pDimmIndexes[DimmsNum] = Index;
+    DimmsNum++;
+  }
+
+  RunOnDimms(ppDimms, DimmsNum, DumpDebugDimmWorker, ppArgs, pReturnCodes);
+
+  for (Index = 0; Index < DimmsNum; Index++) {
+    pSuccessesPerDimm[pDimmIndexes[Index]] = 0;
+    // For easier reading
+    PRINTER_SET_MSG(pCmd->pPrintCtx, ReturnCode, L"\n");
+    for (IndexSource = 0; IndexSource < NUM_FW_DEBUG_LOG_SOURCES; IndexSource++) {
+      if (PrintDebugLogSourceResult(pCmd->pPrintCtx, &pContexts[Index].Sources[IndexSource], IndexSource)) {
+        pSuccessesPerDimm[pDimmIndexes[Index]]++;
+      }
+    }
+  }
+
+Finish:
+  if (pContexts != NULL) {
+    for (Index = 0; Index < DimmsNum; Index++) {
+      for (IndexSource = 0; IndexSource < NUM_FW_DEBUG_LOG_SOURCES; IndexSource++) {
+        FREE_POOL_SAFE(pContexts[Index].Sources[IndexSource].pRawFileName);
+        FREE_POOL_SAFE(pContexts[Index].Sources[IndexSource].pDecodedFileName);
+        FreeCommandStatus(&pContexts[Index].Sources[IndexSource].pCommandStatus);
+      }
+    }
+  }
+  FREE_POOL_SAFE(pContexts);
+  FREE_POOL_SAFE(ppDimms);
+  FREE_POOL_SAFE(ppArgs);
+  FREE_POOL_SAFE(pReturnCodes);
+  FREE_POOL_SAFE(pDimmIndexes);
+  return ReturnCode;
+}
+#endif
+
 /**
  Dump debug log command
 
@@ -71,7 +492,6 @@ DumpDebugCommand(
 )
 {
   EFI_DCPMM_CONFIG2_PROTOCOL *pNvmDimmConfigProtocol = NULL;
-  COMMAND_STATUS *pCommandStatus = NULL;
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
   UINT32 DimmCount = 0;
   UINT16 *pDimmIds = NULL;
@@ -83,18 +503,21 @@ DumpDebugCommand(
   nlog_dict_entry * next;
   BOOLEAN dictExists = FALSE;
   CHAR16 *pDictUserPath = NULL;
-  CHAR16 *raw_file_name = NULL;
-  CHAR16 *decoded_file_name = NULL;
   nlog_dict_entry* dict_head = NULL;
-  UINT32 dict_version;
+  UINT32 dict_version = 0;
   UINT64 dict_entries;
   PRINT_CONTEXT *pPrinterCtx = NULL;
+  INT8 SuccessesPerDimm[MAX_DIMMS];
+#ifndef OS_BUILD
+  COMMAND_STATUS *pCommandStatus = NULL;
+  CHAR16 *raw_file_name = NULL;
+  CHAR16 *decoded_file_name = NULL;
   CHAR16 *SourceNames[NUM_FW_DEBUG_LOG_SOURCES] = {L"media", L"sram", L"spi"};
   UINT8 IndexSource = 0;
   VOID *RawLogBuffer = NULL;
   UINT64 RawLogBufferSizeBytes = 0;
-  INT8 SuccessesPerDimm[MAX_DIMMS];
   UINT32 Reserved = 0;
+#endif
 
   NVDIMM_ENTRY();
 
@@ -191,6 +614,13 @@ DumpDebugCommand(
     PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Loaded %d dictionary entries\n", dict_entries);
   }
 
+#ifdef OS_BUILD
+  ReturnCode = DumpDebugLogsParallel(pCmd, pNvmDimmConfigProtocol, pDimms, DimmCount, pDimmIds, DimmIdsNum,
+      pDumpUserPath, dictExists ? dict_head : NULL, dict_version, SuccessesPerDimm);
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
+  }
+#else
   for (Index = 0; Index < DimmCount; Index++) {
     // Initialize to -1 so we can ignore dimms that aren't specified
     SuccessesPerDimm[Index] = -1;
@@ -285,9 +715,10 @@ FreeAndContinue:
       FreeCommandStatus(&pCommandStatus);
     }
   }
+#endif
   // Return success if any of 3 logs were retrieved on every specified dimm
   ReturnCode = EFI_SUCCESS;
-  for (Index = 0; Index < DimmCount; Index++)
+  for (Index = 0; Index < DimmCount && Index < MAX_DIMMS; Index++)
   {
     if (SuccessesPerDimm[Index] == 0)
     {
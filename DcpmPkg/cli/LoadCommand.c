@@ -126,8 +126,6 @@ Load(
   }
 
   NVDIMM_ENTRY();
-  SetDisplayInfo(L"LoadFw", ResultsView, NULL);
-
   for (Index = 0; Index < MAX_DIMMS; Index++) {
     ReturnCodes[Index] = EFI_SUCCESS;
     NvmCodes[Index] = NVM_SUCCESS;
@@ -80,11 +80,14 @@ extern int cov_dumpData(void);
 #endif
 #ifdef OS_BUILD
 #include "DumpSupportCommand.h"
+#include "ShowNamespaceImageCommand.h"
+#include "ShowAddressTranslationCommand.h"
 #include <stdio.h>
 extern void nvm_current_cmd(struct Command Command);
 extern BOOLEAN ConfigIsDdrtProtocolDisabled();
 extern BOOLEAN ConfigIsLargePayloadDisabled();
 extern int g_fast_path;
+extern int g_driver_bound;
 #else
 #include "DeletePcdCommand.h"
 EFI_GUID gNvmDimmConfigProtocolGuid = EFI_DCPMM_CONFIG2_PROTOCOL_GUID;
@@ -118,6 +121,7 @@ static EFI_STATUS GetPbrMode(UINT32 *Mode);
 static EFI_STATUS SetPbrTag(CHAR16 *pName, CHAR16 *pDescription);
 static EFI_STATUS ResetPbrSession(UINT32 TagId);
 static EFI_STATUS SetDefaultProtocolAndPayloadSizeOptions();
+static VOID PrintCliMessage(EFI_STATUS Status, CHAR16 *pMessage);
 
 /**
   Supported commands
@@ -259,6 +263,72 @@ VOID FixHelp(CHAR16** ppTokens, UINT32* pCount){
   *pCount = Index;
 }
 
+/*
+ * Print a message that does not come from a command's printer context
+ * (help text, syntax errors). When nvmxml/esx/esxtable output was requested
+ * on the command line the message is rendered by the printer the same way
+ * command results are, otherwise it is printed as plain text.
+ */
+static VOID PrintCliMessage(EFI_STATUS Status, CHAR16 *pMessage)
+{
+#ifdef OS_BUILD
+  PRINT_CONTEXT *pPrinterCtx = NULL;
+  CHAR16 **ppToks = NULL;
+  UINT32 NumToks = 0;
+  UINT32 TokIndex = 0;
+  UINTN Index = 0;
+  BOOLEAN XmlRequested = FALSE;
+#endif
+
+  if (NULL == pMessage) {
+    return;
+  }
+
+#ifdef OS_BUILD
+  for (Index = 1; Index + 1 < gEfiShellParametersProtocol->Argc; Index++) {
+    if (0 != StrICmp(gEfiShellParametersProtocol->Argv[Index], OUTPUT_OPTION_SHORT) &&
+        0 != StrICmp(gEfiShellParametersProtocol->Argv[Index], OUTPUT_OPTION)) {
+      continue;
+    }
+
+    if (NULL == pPrinterCtx && EFI_ERROR(PrinterCreateCtx(&pPrinterCtx))) {
+      break;
+    }
+
+    ppToks = StrSplit(gEfiShellParametersProtocol->Argv[Index + 1], L',', &NumToks);
+    if (NULL == ppToks) {
+      continue;
+    }
+    for (TokIndex = 0; TokIndex < NumToks; ++TokIndex) {
+      if (0 == StrICmp(ppToks[TokIndex], OUTPUT_OPTION_NVMXML)) {
+        XmlRequested = TRUE;
+      } else if (0 == StrICmp(ppToks[TokIndex], OUTPUT_OPTION_ESX_XML)) {
+        XmlRequested = TRUE;
+        PRINTER_ENABLE_ESX_XML_FORMAT(pPrinterCtx);
+      } else if (0 == StrICmp(ppToks[TokIndex], OUTPUT_OPTION_ESX_TABLE_XML)) {
+        XmlRequested = TRUE;
+        PRINTER_ENABLE_ESX_TABLE_XML_FORMAT(pPrinterCtx);
+      }
+    }
+    FreeStringArray(ppToks, NumToks);
+  }
+
+  if (XmlRequested) {
+    pPrinterCtx->FormatType = XML;
+    PRINTER_SET_MSG(pPrinterCtx, Status, FORMAT_STR, pMessage);
+    PRINTER_PROCESS_SET_BUFFER(pPrinterCtx);
+  } else {
+#endif
+    LongPrint(pMessage);
+#ifdef OS_BUILD
+  }
+
+  if (NULL != pPrinterCtx) {
+    PrinterDestroyCtx(pPrinterCtx);
+  }
+#endif
+}
+
 /*                                          ./
  * The entry point for the application.
  *
@@ -280,6 +350,7 @@ UefiMain(
   struct Command Command;
   INT32 Index = 0;
   CHAR16 *pLine = NULL;
+  CHAR16 *pSyntaxError = NULL;
   BOOLEAN MoreInput = TRUE;
   BOOLEAN HelpShown = FALSE;
   UINTN Argc = 0;
@@ -571,17 +642,11 @@ UefiMain(
         showHelp(&Command);
         HelpShown = TRUE;
       } else {
-#ifdef OS_BUILD //WA, remove after all CMDs convert to "unified printing" mechanism
-        if (Command.PrinterCtrlSupported) {
-          gOsShellParametersProtocol.StdOut = stdout;
-        }
-#endif
-
 #ifdef OS_BUILD
         // different handling of returncodes for version command so it works for regular users
         IsVersionCommand = (StrnCmp(Command.verb, VERSION_VERB, VERB_LEN) == 0);
 
-        if (!Command.ExcludeDriverBinding && !g_fast_path) {
+        if (!Command.ExcludeDriverBinding && !g_fast_path && !g_driver_bound) {
           Rc = NvmDimmDriverDriverBindingStart(&gNvmDimmDriverDriverBinding, FakeBindHandle, NULL);
           if (EFI_ERROR(Rc) && !IsVersionCommand) {
             NVDIMM_ERR("Issue with driver initialization");
@@ -597,7 +662,7 @@ UefiMain(
           Rc = ExecuteCmd(&Command);
         }
 #ifdef OS_BUILD
-        if (!Command.ExcludeDriverBinding && !g_fast_path) {
+        if (!Command.ExcludeDriverBinding && !g_fast_path && !g_driver_bound) {
           NvmDimmDriverDriverBindingStop(&gNvmDimmDriverDriverBinding, FakeBindHandle, 0, NULL);
         }
 #endif
@@ -608,8 +673,9 @@ UefiMain(
     } else { /* syntax error */
 
       /* print the error */
-      LongPrint(getSyntaxError());
-      Print(L"\n");
+      pSyntaxError = CatSPrint(NULL, FORMAT_STR FORMAT_NL, getSyntaxError());
+      PrintCliMessage(Rc, pSyntaxError);
+      FREE_POOL_SAFE(pSyntaxError);
       MoreInput = FALSE; /* stop on failures */
     }
 #ifdef OS_BUILD
@@ -824,6 +890,16 @@ RegisterCommands(
   if (EFI_ERROR(Rc)) {
     goto done;
   }
+
+  Rc = RegisterShowNamespaceImageCommand();
+  if (EFI_ERROR(Rc)) {
+    goto done;
+  }
+
+  Rc = RegisterShowAddressTranslationCommand();
+  if (EFI_ERROR(Rc)) {
+    goto done;
+  }
 #endif // OS_BUILD
 
   // Debug Commands
@@ -926,6 +1002,7 @@ EFI_STATUS showHelp(struct Command *pCmd)
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
   CHAR16 *pHelp = NULL;
+  CHAR16 *pOverallHelp = NULL;
 
   NVDIMM_ENTRY();
 
@@ -934,14 +1011,18 @@ EFI_STATUS showHelp(struct Command *pCmd)
     //Page break option only for UEFI
     ShellSetPageBreakMode(TRUE);
 #endif
-    Print(FORMAT_STR_SPACE FORMAT_STR_NL_NL L"    Usage: " FORMAT_STR L" <verb>[<options>][<targets>][<properties>]\n\nCommands:\n", PRODUCT_NAME, APP_DESCRIPTION, EXE_NAME);
-    pHelp = getOverallCommandHelp();
+    pHelp = CatSPrint(NULL, FORMAT_STR_SPACE FORMAT_STR_NL_NL L"    Usage: " FORMAT_STR L" <verb>[<options>][<targets>][<properties>]\n\nCommands:\n", PRODUCT_NAME, APP_DESCRIPTION, EXE_NAME);
+    pOverallHelp = getOverallCommandHelp();
+    if (pOverallHelp != NULL) {
+      pHelp = CatSPrintClean(pHelp, FORMAT_STR, pOverallHelp);
+      FreePool(pOverallHelp);
+    }
   } else {
     pHelp = getCommandHelp(pCmd, TRUE);
   }
 
   if (pHelp != NULL) {
-    LongPrint(pHelp);
+    PrintCliMessage(ReturnCode, pHelp);
     FreePool(pHelp);
   }
 
@@ -197,8 +197,6 @@ ShowPcd(
 
   NVDIMM_ENTRY();
 
-  SetDisplayInfo(L"ShowPcd", ResultsView, NULL);
-
   ZeroMem(DimmStr, sizeof(DimmStr));
 
   if (pCmd == NULL) {
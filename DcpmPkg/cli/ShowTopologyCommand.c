@@ -392,8 +392,6 @@ ShowTopology(
   // If we are here with an invalid PMTT, we are able to derive the topology from the SMBIOS table successfully.
   // Print in the style of a PMTT 0.1 table
   else if (IS_ACPI_REV_MAJ_0_MIN_1(Revision) || IS_PMTT_REVISION_INVALID(Revision)) {
-    SetDisplayInfo(L"DimmTopology", ListView, NULL);
-
     //Print detailed topology for DDR4 entries if no dimm target specified
     for (Index = 0; Index < TopologyDimmsNumber; Index++) {
       if (SocketsNum > 0 && !ContainUint(pSockets, SocketsNum, pTopologyDimms[Index].SocketID)) {
@@ -465,8 +463,6 @@ ShowTopology(
   }
   /** display detailed view for PMTT 0.2 **/
   else if (IS_ACPI_REV_MAJ_0_MIN_2(Revision)) {
-    SetDisplayInfo(L"DimmTopology", ListView, NULL);
-
     //Print detailed topology for DDR4 entries if no dimm target specified
     for (Index = 0; Index < TopologyDimmsNumber; Index++) {
       if (SocketsNum > 0 && !ContainUint(pSockets, SocketsNum, pTopologyDimms[Index].SocketID)) {
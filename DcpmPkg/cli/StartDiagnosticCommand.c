@@ -24,8 +24,6 @@
 #define SUBTEST_NAME_STR                   L"SubTest"
 #define RESULT_STR L"RESULT"
 
-#define DIAG_ENTRY_EOL                     L'\n'
-
    /*
     *  PRINT LIST ATTRIBUTES
     *  --Test = Quick
@@ -175,18 +173,11 @@ StartDiagnosticCmd(
   CHAR16 *pPath = NULL;
   UINT8 Id = 0;
   CHAR16 *MsgStr = NULL;
-  CHAR16 *EventCodeStr = NULL;
-  CHAR16 **ppSplitDiagResultLines = NULL;
-  CHAR16 **ppSplitDiagEventCode = NULL;
-  UINT32 NumTokens = 0;
-  UINT32 CodeTokens = 0;
-  UINT32 i = 0;
-  CHAR16** EventMesg = NULL;
+  UINT32 EventIndex = 0;
+  UINT32 MsgNum = 0;
 
   NVDIMM_ENTRY();
 
-  SetDisplayInfo(L"Diagnostic", DiagView, NULL);
-
   ZeroMem(&DisplayPreferences, sizeof(DisplayPreferences));
 
   if (pCmd == NULL) {
@@ -272,6 +263,9 @@ StartDiagnosticCmd(
     }
 
     DIAG_INFO *pLoc = pFinalDiagnosticsResult;
+    if (pLoc == NULL) {
+      continue;
+    }
 
     PRINTER_BUILD_KEY_PATH(pPath, DS_DIAGNOSTIC_INDEX_PATH, Index);
     PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, TEST_NAME_STR, pLoc->TestName);
@@ -279,49 +273,32 @@ StartDiagnosticCmd(
     if (pLoc->State != NULL) {
       PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, L"State", pLoc->State);
     }
-    EventMesg = StrSplit(pLoc->Message, DIAG_ENTRY_EOL, &i);
-    if(EventMesg != NULL){
-      PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath,L"Message" ,EventMesg[0]);
-      FREE_POOL_SAFE(EventMesg);
+    for (EventIndex = 0; EventIndex < pLoc->EventsNum; EventIndex++) {
+      if (pLoc->pEvents[EventIndex].SubTestIndex == DIAG_NO_SUBTEST) {
+        PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, L"Message", pLoc->pEvents[EventIndex].pMessage);
+        break;
+      }
     }
     for (Id = 0; Id < MAX_NO_OF_DIAGNOSTIC_SUBTESTS; Id++) {
-      if (pLoc->SubTestName[Id] != NULL) {
-        PRINTER_BUILD_KEY_PATH(pPath, DS_SUBTEST_INDEX_PATH, Index, Id);
-        PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, SUBTEST_NAME_STR, pLoc->SubTestName[Id]);
-        PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, L"State", pLoc->SubTestState[Id]);
-        // Split message string and set printer in unique key-> value form.
-        if (pLoc->SubTestMessage[Id] != NULL) {
-          ppSplitDiagResultLines = StrSplit(pLoc->SubTestMessage[Id], DIAG_ENTRY_EOL, &NumTokens);
-          if (pLoc->SubTestEventCode[Id] != NULL) {
-            ppSplitDiagEventCode = StrSplit(pLoc->SubTestEventCode[Id], DIAG_ENTRY_EOL, &CodeTokens);
-          }
-          for (i = 0; i < NumTokens; i++) {
-            if (ppSplitDiagResultLines != NULL) {
-              MsgStr = CatSPrint(NULL, L"Message.%d", i + 1);
-              PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, MsgStr, ppSplitDiagResultLines[i]);
-            }
-            if (ppSplitDiagEventCode != NULL) {
-              EventCodeStr = CatSPrint(NULL, L"EventCode.%d", i + 1);
-              PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, EventCodeStr, ppSplitDiagEventCode[i]);
-            }
-            FREE_POOL_SAFE(MsgStr);
-            FREE_POOL_SAFE(EventCodeStr);
-          }
-          FreeStringArray(ppSplitDiagResultLines, NumTokens);
-          if (ppSplitDiagEventCode != NULL) {
-            FreeStringArray(ppSplitDiagEventCode, CodeTokens);
-          }
+      if (pLoc->SubTestName[Id] == NULL) {
+        continue;
+      }
+      PRINTER_BUILD_KEY_PATH(pPath, DS_SUBTEST_INDEX_PATH, Index, Id);
+      PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, SUBTEST_NAME_STR, pLoc->SubTestName[Id]);
+      PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, L"State", pLoc->SubTestState[Id]);
+      // Set each event of the subtest in unique key-> value form.
+      MsgNum = 0;
+      for (EventIndex = 0; EventIndex < pLoc->EventsNum; EventIndex++) {
+        if (pLoc->pEvents[EventIndex].SubTestIndex != Id) {
+          continue;
         }
-        FREE_POOL_SAFE(pLoc->SubTestName[Id]);
-        FREE_POOL_SAFE(pLoc->SubTestMessage[Id]);
-        FREE_POOL_SAFE(pLoc->SubTestState[Id]);
-        FREE_POOL_SAFE(pLoc->SubTestEventCode[Id]);
+        MsgNum++;
+        MsgStr = CatSPrint(NULL, L"Message.%d", MsgNum);
+        PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, MsgStr, pLoc->pEvents[EventIndex].pMessage);
+        FREE_POOL_SAFE(MsgStr);
       }
     }
-    FREE_POOL_SAFE(pLoc->TestName);
-    FREE_POOL_SAFE(pLoc->Message);
-    FREE_POOL_SAFE(pLoc->State);
-    FREE_POOL_SAFE(pFinalDiagnosticsResult);
+    FreeDiagnosticResult(&pFinalDiagnosticsResult);
   }
 
   PRINTER_CONFIGURE_DATA_ATTRIBUTES(pPrinterCtx, DS_ROOT_PATH, &StartDiagDataSetAttribs);
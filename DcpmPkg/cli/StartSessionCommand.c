@@ -361,5 +361,6 @@ STATIC EFI_STATUS ExecuteCommand(CHAR16 *pCmdInput) {
   }
 
   FreeCommandInput(&Input);
+  FreeCommandStructure(&Command);
   return ReturnCode;
 }
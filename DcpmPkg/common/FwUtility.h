@@ -94,10 +94,19 @@ typedef struct {
 #ifdef OS_BUILD
   UINT8 DsmStatus;
 #endif
+  // Optional caller buffer of LargeOutputPayloadSize bytes, the large output
+  // payload is read straight into it instead of LargeOutputPayload
+  UINT8 *pLargeOutputBuffer;
 } NVM_FW_CMD;
 
 #pragma pack(pop)
 
+/**
+  Buffer receiving the large output payload of a firmware command
+**/
+#define FW_CMD_LARGE_OUTPUT(pCmd) \
+  (((pCmd)->pLargeOutputBuffer != NULL) ? (pCmd)->pLargeOutputBuffer : (pCmd)->LargeOutputPayload)
+
 /**
   Version struct definition
 **/
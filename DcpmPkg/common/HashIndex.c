@@ -0,0 +1,179 @@
+/*
+* Copyright (c) 2018, Intel Corporation.
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "HashIndex.h"
+#include <Library/MemoryAllocationLib.h>
+#include <Debug.h>
+
+#define FNV1A_OFFSET_BASIS  2166136261u
+#define FNV1A_PRIME         16777619u
+
+/**
+  Hash a 32 bit integer key
+
+  @param[in] Key Key to hash
+
+  @retval Hash value
+**/
+UINT32
+HashUint32(
+  IN     UINT32 Key
+  )
+{
+  Key ^= Key >> 16;
+  Key *= 0x45D9F3B;
+  Key ^= Key >> 16;
+  return Key;
+}
+
+/**
+  FNV-1a hash of an ASCII string
+
+  Gives the same value as HashUnicodeStr for the UCS-2 form of the string.
+
+  @param[in] pStr Null terminated string
+
+  @retval Hash value
+**/
+UINT32
+HashAsciiStr(
+  IN     CONST CHAR8 *pStr
+  )
+{
+  UINT32 Hash = FNV1A_OFFSET_BASIS;
+
+  for (; *pStr != '\0'; pStr++) {
+    Hash = (Hash ^ (UINT8)*pStr) * FNV1A_PRIME;
+  }
+  return Hash;
+}
+
+/**
+  FNV-1a hash of a UCS-2 string, one step per character
+
+  @param[in] pStr Null terminated string
+
+  @retval Hash value
+**/
+UINT32
+HashUnicodeStr(
+  IN     CONST CHAR16 *pStr
+  )
+{
+  UINT32 Hash = FNV1A_OFFSET_BASIS;
+
+  for (; *pStr != L'\0'; pStr++) {
+    Hash = (Hash ^ *pStr) * FNV1A_PRIME;
+  }
+  return Hash;
+}
+
+/**
+  Allocate an empty index for the given number of items
+
+  The load factor is kept at most one half so that the probe sequences stay short.
+
+  @param[out] pIndex Index to initialize
+  @param[in] ItemsNum Number of items that will be inserted
+
+  @retval EFI_SUCCESS Index allocated
+  @retval EFI_INVALID_PARAMETER pIndex is NULL
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure, pIndex is left without an index
+**/
+EFI_STATUS
+HashIndexInit(
+     OUT HASH_INDEX *pIndex,
+  IN     UINT32 ItemsNum
+  )
+{
+  UINT32 Capacity = 0;
+
+  if (pIndex == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Capacity = 1; Capacity < ItemsNum * 2; Capacity *= 2);
+
+  pIndex->ppSlots = AllocateZeroPool(Capacity * sizeof(VOID *));
+  if (pIndex->ppSlots == NULL) {
+    pIndex->Capacity = 0;
+    return EFI_OUT_OF_RESOURCES;
+  }
+  pIndex->Capacity = Capacity;
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the slots of the index, the items are not touched
+
+  @param[in, out] pIndex Index to free
+**/
+VOID
+HashIndexFree(
+  IN OUT HASH_INDEX *pIndex
+  )
+{
+  if (pIndex == NULL) {
+    return;
+  }
+  FREE_POOL_SAFE(pIndex->ppSlots);
+  pIndex->Capacity = 0;
+}
+
+/**
+  Put an item into the first free slot of the probe sequence of its hash
+
+  @param[in, out] pIndex Initialized index, with a free slot left
+  @param[in] Hash Hash of the item key
+  @param[in] pItem Item to insert
+**/
+VOID
+HashIndexInsert(
+  IN OUT HASH_INDEX *pIndex,
+  IN     UINT32 Hash,
+  IN     VOID *pItem
+  )
+{
+  UINT32 Slot = 0;
+
+  if (pIndex == NULL || pIndex->ppSlots == NULL || pItem == NULL) {
+    return;
+  }
+
+  for (Slot = Hash & (pIndex->Capacity - 1); pIndex->ppSlots[Slot] != NULL; Slot = (Slot + 1) & (pIndex->Capacity - 1));
+  pIndex->ppSlots[Slot] = pItem;
+}
+
+/**
+  Find the first item of the probe sequence of a hash that matches the key
+
+  @param[in] pIndex Index to search
+  @param[in] Hash Hash of the key
+  @param[in] Match Function checking whether an item matches the key
+  @param[in] pKey Key passed to the Match function
+
+  @retval Matching item, NULL if there is none or the index is not initialized
+**/
+VOID *
+HashIndexFind(
+  IN     HASH_INDEX *pIndex,
+  IN     UINT32 Hash,
+  IN     HASH_INDEX_MATCH Match,
+  IN     CONST VOID *pKey
+  )
+{
+  UINT32 Slot = 0;
+
+  if (pIndex == NULL || pIndex->ppSlots == NULL || Match == NULL) {
+    return NULL;
+  }
+
+  for (Slot = Hash & (pIndex->Capacity - 1); pIndex->ppSlots[Slot] != NULL; Slot = (Slot + 1) & (pIndex->Capacity - 1)) {
+    if (Match(pIndex->ppSlots[Slot], pKey)) {
+      return pIndex->ppSlots[Slot];
+    }
+  }
+  return NULL;
+}
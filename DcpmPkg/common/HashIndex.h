@@ -0,0 +1,136 @@
+/*
+* Copyright (c) 2018, Intel Corporation.
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#ifndef _HASH_INDEX_H_
+#define _HASH_INDEX_H_
+
+#include <Uefi.h>
+
+/**
+  Open addressing hash index with linear probing
+
+  Each slot points to an item owned by the caller, a NULL slot is free.
+  Items are only inserted while the index is built, so a lookup stops at the
+  first free slot of the probe sequence. Items put in first are found first.
+**/
+typedef struct _HASH_INDEX {
+  VOID **ppSlots;     //!< NULL when there is no index
+  UINT32 Capacity;    //!< Number of slots, power of two
+} HASH_INDEX;
+
+/**
+  Check if an item of the index matches the looked up key
+
+  @param[in] pItem Item found in the probe sequence of the key
+  @param[in] pKey Key passed to HashIndexFind
+
+  @retval TRUE if the item matches the key
+**/
+typedef
+BOOLEAN
+(*HASH_INDEX_MATCH) (
+  IN     VOID *pItem,
+  IN     CONST VOID *pKey
+  );
+
+/**
+  Hash a 32 bit integer key
+
+  @param[in] Key Key to hash
+
+  @retval Hash value
+**/
+UINT32
+HashUint32(
+  IN     UINT32 Key
+  );
+
+/**
+  FNV-1a hash of an ASCII string
+
+  Gives the same value as HashUnicodeStr for the UCS-2 form of the string.
+
+  @param[in] pStr Null terminated string
+
+  @retval Hash value
+**/
+UINT32
+HashAsciiStr(
+  IN     CONST CHAR8 *pStr
+  );
+
+/**
+  FNV-1a hash of a UCS-2 string, one step per character
+
+  @param[in] pStr Null terminated string
+
+  @retval Hash value
+**/
+UINT32
+HashUnicodeStr(
+  IN     CONST CHAR16 *pStr
+  );
+
+/**
+  Allocate an empty index for the given number of items
+
+  The load factor is kept at most one half so that the probe sequences stay short.
+
+  @param[out] pIndex Index to initialize
+  @param[in] ItemsNum Number of items that will be inserted
+
+  @retval EFI_SUCCESS Index allocated
+  @retval EFI_INVALID_PARAMETER pIndex is NULL
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure, pIndex is left without an index
+**/
+EFI_STATUS
+HashIndexInit(
+     OUT HASH_INDEX *pIndex,
+  IN     UINT32 ItemsNum
+  );
+
+/**
+  Free the slots of the index, the items are not touched
+
+  @param[in, out] pIndex Index to free
+**/
+VOID
+HashIndexFree(
+  IN OUT HASH_INDEX *pIndex
+  );
+
+/**
+  Put an item into the first free slot of the probe sequence of its hash
+
+  @param[in, out] pIndex Initialized index, with a free slot left
+  @param[in] Hash Hash of the item key
+  @param[in] pItem Item to insert
+**/
+VOID
+HashIndexInsert(
+  IN OUT HASH_INDEX *pIndex,
+  IN     UINT32 Hash,
+  IN     VOID *pItem
+  );
+
+/**
+  Find the first item of the probe sequence of a hash that matches the key
+
+  @param[in] pIndex Index to search
+  @param[in] Hash Hash of the key
+  @param[in] Match Function checking whether an item matches the key
+  @param[in] pKey Key passed to the Match function
+
+  @retval Matching item, NULL if there is none or the index is not initialized
+**/
+VOID *
+HashIndexFind(
+  IN     HASH_INDEX *pIndex,
+  IN     UINT32 Hash,
+  IN     HASH_INDEX_MATCH Match,
+  IN     CONST VOID *pKey
+  );
+
+#endif /** _HASH_INDEX_H_ **/
@@ -4,498 +4,582 @@
 */
 
 #include "Nlog.h"
+#include <Library/BaseMemoryLib.h>
 
+#define NLOG_SECTION_SIZE       256
+#define NLOG_V2_MAGIC_NUMBER    11928997
+#define NLOG_DECODE_HEADER      "TIMESTAMP ::              FILE           ::   LEVEL :: LOG\n=====================================================================================\n"
+
+/*
+Release the argument values of a record
+
+@param[in] record - the record to release the arguments of
+@param[in] args - the number of arguments
+*/
+STATIC
 VOID
-decode_nlog_binary(
-  struct Command *pCmd,
-  CHAR16* decoded_file_name,
-  UINT8* nlogbytes,
-  UINT64 size,
-  UINT32 dict_version,
-  nlog_dict_entry* dict_head
+free_nlog_record_args(
+  IN nlog_record *record,
+  IN UINT64 args
 )
 {
-  EFI_STATUS status;
-  BOOLEAN inv2section = FALSE;
-  UINT32 expectedMagicNum = 11928997;
-  UINT64 x = 0;
+  UINT64 z = 0;
+
+  if (record->ArgValues)
+  {
+    for (z = 0; z < args; z++)
+    {
+      FREE_POOL_SAFE(record->ArgValues[z]);
+    }
+    FREE_POOL_SAFE(record->ArgValues);
+  }
+}
+
+/*
+Release a dictionary entry made up for a word missing from the dictionary
+
+@param[in] entry - the entry to release
+*/
+STATIC
+VOID
+free_nlog_fake_entry(
+  IN nlog_dict_entry *entry
+)
+{
+  if (entry != NULL)
+  {
+    FREE_POOL_SAFE(entry->FileName);
+    FREE_POOL_SAFE(entry->LogLevel);
+    FREE_POOL_SAFE(entry->LogString);
+    FREE_POOL_SAFE(entry);
+  }
+}
+
+/*
+Decode the record starting at a word of the buffer
+
+@param[in,out] decoder - the decoder state
+@param[in] nlogbytes - the buffer
+@param[in] size - the number of bytes in the buffer
+@param[in,out] offset - IN: the word to decode, OUT: the last word of the record
+@param[out] formatted - the formatted record line
+@param[out] formatted_len - the length of the formatted record line
+
+@retval EFI_SUCCESS the record was decoded
+@retval EFI_NOT_FOUND the word does not start a record
+@retval EFI_BUFFER_TOO_SMALL the record continues past the end of the buffer
+@retval EFI_OUT_OF_RESOURCES memory allocation failure
+*/
+STATIC
+EFI_STATUS
+decode_nlog_record(
+  IN OUT nlog_decoder *decoder,
+  IN     UINT8 *nlogbytes,
+  IN     UINT64 size,
+  IN OUT UINT64 *offset,
+     OUT CHAR8 **formatted,
+     OUT UINT64 *formatted_len
+)
+{
+  EFI_STATUS ReturnCode = EFI_OUT_OF_RESOURCES;
+  UINT64 x = *offset;
   UINT64 y = 0;
   UINT64 z = 0;
+  UINT32 value = 0;
+  nlog_version_v1 v1;
+  UINT32 record_args = 0;
+  nlog_version_v2 v2;
   nlog_dict_entry* entry = NULL;
-  nlog_record* record = NULL;
-  nlog_record* head = NULL;
-  nlog_record* tail = NULL;
-  UINT64 total_formatted_string_size = 0;
-  CHAR8* total_formatted_string = NULL;
+  nlog_record record;
+  BOOLEAN dictionary_entry_was_allocated_here = FALSE;
+  BOOLEAN hash_not_found = FALSE;
   UINT64 elements = 0;
   CHAR8** append_strs = NULL;
-  UINT32** old_args = NULL;
-  UINT64 old_arg_count = 0;
-  nlog_version_v1 v1;
-  nlog_version_v2 v2;
   CHAR16* kernel_str = NULL;
   CHAR8* ascii_kernel_str = NULL;
   CHAR8* system_time_set_log = "System Time Set";
   UINTN ascii_kernel_str_size = 0;
-  UINT32 system_time_set = 0;
-  CHAR8* old_format_str = NULL;
-  CHAR8* decode_header = NULL;
-  UINT64 header_length = 0;
-  UINT32 value;
-  UINT64 node_count = 0;
-  CHAR8* formatted_string_head = NULL;
-  UINT64 bytes_needed = 0;
-  UINT64 appended_count = 0;
-  BOOLEAN dictionary_entry_was_allocated_here = FALSE;
-  BOOLEAN hash_not_found = FALSE;
-  nlog_record* next;
-  PRINT_CONTEXT *pPrinterCtx = NULL;
-  EFI_STATUS ReturnCode = EFI_SUCCESS;
 
-  if (pCmd != NULL) {
-    pPrinterCtx = pCmd->pPrintCtx;
-  }
+  ZeroMem(&record, sizeof(record));
+  ZeroMem(&v1, sizeof(v1));
 
-  node_count = 0;
-  for (x = 0; x < size; x += 4)
+  value = bytes_to_u32(&nlogbytes[x]);
+  if ((decoder->stream_offset + x) % NLOG_SECTION_SIZE == 0)
   {
-    record = NULL;
-    entry = NULL;
-    dictionary_entry_was_allocated_here = FALSE;
-    hash_not_found = FALSE;
-    value = bytes_to_u32(&nlogbytes[x]);
-    if (x % 256 == 0)
+    decoder->inv2section = FALSE;
+    v2.rawData = value;
+    if (v2.data.magic_number == NLOG_V2_MAGIC_NUMBER &&
+      v2.data.version == decoder->dict_version)
     {
-      inv2section = FALSE;
-      v2.rawData = value;
-      if (v2.data.magic_number == expectedMagicNum &&
-        v2.data.version == dict_version)
-      {
-        inv2section = TRUE;
-        continue;
-      }
+      decoder->inv2section = TRUE;
+      return EFI_NOT_FOUND;
     }
+  }
 
-    if (0 == value)
-    {
-      continue; //this is not a valid record
-    }
+  if (0 == value)
+  {
+    return EFI_NOT_FOUND; //this is not a valid record
+  }
 
-    /*
-    check for V2 dictionary entry if this is a V2 section. If there isn't one, create a fake one for logging purposes
+  /*
+  check for V2 dictionary entry if this is a V2 section. If there isn't one, create a fake one for logging purposes
 
-    If this is a V1 section and the value is valid for a V1 section, create a fake entry for logging purposes
-    */
-    if (inv2section)
+  If this is a V1 section and the value is valid for a V1 section, create a fake entry for logging purposes
+  */
+  if (decoder->inv2section)
+  {
+    entry = get_nlog_entry(value, decoder->dict_head);
+    hash_not_found = (entry == NULL);
+    if (!hash_not_found)
     {
-      entry = get_nlog_entry(value, dict_head);
-      if (entry == NULL)
-      {
-        hash_not_found = TRUE;
-        entry = AllocateZeroPool(sizeof(nlog_dict_entry));
-        if (NULL == entry)
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-          goto Finish;
-        }
+      record_args = entry->Args;
+    }
+  }
+  else
+  {
+    v1.rawData = value;
+    if (0 == v1.data.args && 0 == v1.data.line_number && 0 == v1.data.module_id)
+    {
+      return EFI_NOT_FOUND;
+    }
+    record_args = v1.data.args;
+  }
 
-        dictionary_entry_was_allocated_here = TRUE;
+  /** A record is its first word, the timestamp and the arguments, it may end in the next chunk **/
+  if (!hash_not_found && x + sizeof(UINT32) * (2 + record_args) > size)
+  {
+    return EFI_BUFFER_TOO_SMALL;
+  }
 
-        entry->Hash = value;
-        entry->Args = 1;
-        entry->LogLevel = string_copy("-");
-        entry->FileName = string_copy("-");
-        entry->LogString = string_copy("Hash %d not found in dictionary");
-        entry->next = NULL;
-        entry->prev = NULL;
+  if (decoder->inv2section && hash_not_found)
+  {
+    entry = AllocateZeroPool(sizeof(nlog_dict_entry));
+    if (NULL == entry)
+    {
+      goto Finish;
+    }
+    dictionary_entry_was_allocated_here = TRUE;
 
-        record = AllocateZeroPool(sizeof(nlog_record));
-        if (NULL == record)
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-          goto Finish;
-        }
+    entry->Hash = value;
+    entry->Args = 1;
+    entry->LogLevel = string_copy("-");
+    entry->FileName = string_copy("-");
+    entry->LogString = string_copy("Hash %d not found in dictionary");
 
-        record->DictEntry = entry;
-        record->KernelTime = 0;
-        record->ArgValues = AllocateZeroPool(record->DictEntry->Args * sizeof(UINT32*));
-        if (NULL == record->ArgValues)
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-          goto Finish;
-        }
-        record->ArgValues[0] = AllocateZeroPool(sizeof(UINT32));
-        if (NULL == record->ArgValues[0])
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-          goto Finish;
-        }
-        *record->ArgValues[0] = entry->Hash;
-        record->KernelTime = 0;
-        record->FormattedString = NULL;
-        record->prev = NULL;
-        record->next = NULL;
-      }
+    record.ArgValues = AllocateZeroPool(entry->Args * sizeof(UINT32*));
+    if (NULL == record.ArgValues)
+    {
+      goto Finish;
     }
-    else
+    record.ArgValues[0] = AllocateZeroPool(sizeof(UINT32));
+    if (NULL == record.ArgValues[0])
     {
-      v1.rawData = value;
-      if (0 == v1.data.args && 0 == v1.data.line_number && 0 == v1.data.module_id)
-      {
-        continue;
-      }
-
-      entry = AllocateZeroPool(sizeof(nlog_dict_entry));
-      if (NULL == entry)
-      {
-        PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-        goto Finish;
-      }
-
-      dictionary_entry_was_allocated_here = TRUE;
-
-      entry->Args = v1.data.args;
-      entry->Hash = 0;
-      entry->LogLevel = string_copy("-");
-      entry->FileName = string_copy("-");
-      entry->LogString = NULL;
-      entry->next = NULL;
-      entry->prev = NULL;
+      goto Finish;
     }
-
-    //Move the pointer index to the next U32 and allocate space for a record
-    if (record == NULL)
+    *record.ArgValues[0] = entry->Hash;
+  }
+  else if (!decoder->inv2section)
+  {
+    entry = AllocateZeroPool(sizeof(nlog_dict_entry));
+    if (NULL == entry)
     {
-      record = AllocateZeroPool(sizeof(nlog_record));
-      if (NULL == record)
-      {
-        PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-        goto Finish;
-      }
-
-      record->id = node_count;
-      record->ArgValues = NULL;
-      record->FormattedString = NULL;
-      record->prev = NULL;
-      record->next = NULL;
-      record->KernelTime = 0;
+      goto Finish;
     }
+    dictionary_entry_was_allocated_here = TRUE;
 
-    if (record->DictEntry == NULL && entry != NULL) {
-      record->DictEntry = entry;
-    }
+    entry->Args = v1.data.args;
+    entry->Hash = 0;
+    entry->LogLevel = string_copy("-");
+    entry->FileName = string_copy("-");
+    entry->LogString = NULL;
+  }
+  record.DictEntry = entry;
 
-    if (head == NULL) {
-      head = record;
-      tail = record;
-    }
-    else {
-      tail->next = record;
-      record->prev = tail;
-      tail = record;
-    }
+  //get the timestamp
+  if (FALSE == hash_not_found)
+  {
+    x += 4;
+    record.KernelTime = bytes_to_u32(&nlogbytes[x]);
 
-    //get the timestamp
-    if (FALSE == hash_not_found)
+    /*
+    Gather the arument U32s according to the discovered count
+    */
+    if (entry->Args > 0)
     {
-      x += 4;
-      if (x >= size)
+      record.ArgValues = AllocateZeroPool(entry->Args * sizeof(UINT32*));
+      if (NULL == record.ArgValues)
       {
-        PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Unexpected end of buffer. 1\n");
         goto Finish;
       }
-      record->KernelTime = bytes_to_u32(&nlogbytes[x]);
 
-      /*
-      Gather the arument U32s according to the discovered count
-      */
-      if (record->DictEntry->Args > 0)
+      for (y = 0; y < entry->Args; y++)
       {
-        record->ArgValues = AllocateZeroPool(record->DictEntry->Args * sizeof(UINT32*));
-        if (NULL == record->ArgValues)
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-          goto Finish;
-        }
-
-        for (y = 0; y < record->DictEntry->Args && x < size; y++)
-        {
-          x += 4;
-          if (x >= size)
-          {
-            PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Unexpected end of buffer. 3\n");
-            goto Finish;
-          }
-          record->ArgValues[y] = AllocateZeroPool(sizeof(UINT32));
-          if (NULL == record->ArgValues[y])
-          {
-            PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-            goto Finish;
-          }
-
-          *record->ArgValues[y] = bytes_to_u32(&nlogbytes[x]);
-        }
-      }
-
-
-      if (FALSE == inv2section)
-      {
-        elements = 3 + record->DictEntry->Args;
-        append_strs = AllocateZeroPool(sizeof(CHAR8*) * elements);
-        if (NULL == append_strs)
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-          goto Finish;
-        }
-
-        append_strs[0] = string_copy("V1 Log module: 0x%X, ");
-        append_strs[1] = string_copy("line: %d, ");
-        append_strs[2] = string_copy("args: ");
-        for (z = 3; z < elements; z++)
+        x += 4;
+        record.ArgValues[y] = AllocateZeroPool(sizeof(UINT32));
+        if (NULL == record.ArgValues[y])
         {
-          append_strs[z] = string_copy("0x%X ");
-        }
-
-        old_args = record->ArgValues;
-        old_arg_count = record->DictEntry->Args;
-
-        record->DictEntry->Args = old_arg_count + 2;
-        record->ArgValues = AllocateZeroPool(record->DictEntry->Args * sizeof(UINT32*));
-        if (NULL == record->ArgValues)
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-          goto Finish;
-        }
-
-        record->ArgValues[0] = AllocateZeroPool(sizeof(UINT32));
-        if (NULL == record->ArgValues[0])
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
           goto Finish;
         }
-        record->ArgValues[1] = AllocateZeroPool(sizeof(UINT32));
-        if (NULL == record->ArgValues[1])
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-          goto Finish;
-        }
-        *record->ArgValues[0] = v1.data.module_id;
-        *record->ArgValues[1] = v1.data.line_number;
-
-
-        for (z = 0; z < old_arg_count; z++)
-        {
-          record->ArgValues[z + 2] = AllocateZeroPool(sizeof(UINT32));
-          *record->ArgValues[z + 2] = *old_args[z];
-        }
-
-        for (z = 0; z < old_arg_count; z++)
-        {
-          FREE_POOL_SAFE(old_args[z]);
-        }
-
-        FREE_POOL_SAFE(old_args);
 
-        record->DictEntry->LogString = string_array_concat(append_strs, elements, TRUE, &z);
+        *record.ArgValues[y] = bytes_to_u32(&nlogbytes[x]);
       }
     }
 
-    record->FormattedString = nlog_format(record->DictEntry->LogString, record->ArgValues, record->DictEntry->Args);
-
-    if (TRUE == hash_not_found)
+    if (FALSE == decoder->inv2section)
     {
-      elements = 2;
-      old_format_str = record->FormattedString;
+      elements = 3 + entry->Args;
       append_strs = AllocateZeroPool(sizeof(CHAR8*) * elements);
       if (NULL == append_strs)
       {
-        PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
         goto Finish;
       }
-      append_strs[0] = old_format_str;
-      append_strs[1] = string_copy("\n");
-      record->FormattedString = string_array_concat(append_strs, elements, FALSE, &record->FormattedStringLen);
-    }
-    else
-    {
-      elements = 8;
-      old_format_str = record->FormattedString;
-      append_strs = AllocateZeroPool(sizeof(CHAR8*) * elements);
-      if (NULL == append_strs)
+
+      append_strs[0] = string_copy("V1 Log module: 0x%X, ");
+      append_strs[1] = string_copy("line: %d, ");
+      append_strs[2] = string_copy("args: ");
+      for (z = 3; z < elements; z++)
       {
-        PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
-        goto Finish;
+        append_strs[z] = string_copy("0x%X ");
       }
+      entry->LogString = string_array_concat(append_strs, elements, TRUE, &z);
+      append_strs = NULL;
 
-      // Look for log eg: \"System Time Set at boot. Time: 0x0_55bbb4a6\". Convert to time format string only for real kernel time and not system ticks.
-      if (((system_time_set != 0) && (record->KernelTime >= system_time_set)) || (AsciiStrnCmp(record->FormattedString + 1, system_time_set_log, string_length(system_time_set_log)) == 0))
+      // Prepend the module and the line to the arguments
+      UINT32 **old_args = record.ArgValues;
+      record.ArgValues = AllocateZeroPool((entry->Args + 2) * sizeof(UINT32*));
+      if (NULL == record.ArgValues)
       {
-        system_time_set = record->KernelTime;
-        kernel_str = GetTimeFormatString((UINT64)record->KernelTime, TRUE);
-        if (NULL == kernel_str)
-        {
-          PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to convert the timestamp into readable string format\n");
-          goto Finish;
-        }
-        ascii_kernel_str_size = StrLen(kernel_str) + 1;
-        ascii_kernel_str = AllocateZeroPool(sizeof(CHAR8) * ascii_kernel_str_size);
-        UnicodeStrToAsciiStrS(kernel_str, ascii_kernel_str, ascii_kernel_str_size);
-        append_strs[0] = pad_left(ascii_kernel_str, 28, ' ', TRUE);
+        record.ArgValues = old_args;
+        goto Finish;
       }
-      else
+      for (z = 0; z < entry->Args; z++)
       {
-        ascii_kernel_str = u32_to_a(record->KernelTime, FALSE, 0, FALSE);
-        append_strs[0] = pad_left(ascii_kernel_str, 28, ' ', TRUE);
+        record.ArgValues[z + 2] = old_args[z];
       }
-      append_strs[1] = string_copy(" :: ");
-      append_strs[2] = pad_left(record->DictEntry->FileName, 27, ' ', FALSE);
-      append_strs[3] = string_copy(" :: ");
-      append_strs[4] = pad_left(record->DictEntry->LogLevel, 7, ' ', FALSE);
-      append_strs[5] = string_copy(" :: ");
-      append_strs[6] = record->FormattedString;
-      append_strs[7] = string_copy("\n");
-
-      record->FormattedString = string_array_concat(append_strs, elements, FALSE, &record->FormattedStringLen);
+      FREE_POOL_SAFE(old_args);
+      entry->Args += 2;
+
+      record.ArgValues[0] = AllocateZeroPool(sizeof(UINT32));
+      record.ArgValues[1] = AllocateZeroPool(sizeof(UINT32));
+      if (NULL == record.ArgValues[0] || NULL == record.ArgValues[1])
+      {
+        goto Finish;
+      }
+      *record.ArgValues[0] = v1.data.module_id;
+      *record.ArgValues[1] = v1.data.line_number;
     }
+  }
 
-    total_formatted_string_size += record->FormattedStringLen;
+  record.FormattedString = nlog_format(entry->LogString, record.ArgValues, entry->Args);
 
-    FREE_POOL_SAFE(kernel_str);
-    if (append_strs)
+  if (TRUE == hash_not_found)
+  {
+    elements = 2;
+    append_strs = AllocateZeroPool(sizeof(CHAR8*) * elements);
+    if (NULL == append_strs)
     {
-      for (z = 0; z < elements; z++)
-      {
-        FREE_POOL_SAFE(append_strs[z]);
-      }
-      FREE_POOL_SAFE(append_strs);
+      goto Finish;
+    }
+    append_strs[0] = record.FormattedString;
+    append_strs[1] = string_copy("\n");
+  }
+  else
+  {
+    elements = 8;
+    append_strs = AllocateZeroPool(sizeof(CHAR8*) * elements);
+    if (NULL == append_strs)
+    {
+      goto Finish;
     }
 
-    if (record->ArgValues)
+    // Look for log eg: \"System Time Set at boot. Time: 0x0_55bbb4a6\". Convert to time format string only for real kernel time and not system ticks.
+    if (((decoder->system_time_set != 0) && (record.KernelTime >= decoder->system_time_set)) || (AsciiStrnCmp(record.FormattedString + 1, system_time_set_log, string_length(system_time_set_log)) == 0))
     {
-      for (z = 0; z < record->DictEntry->Args; z++)
+      decoder->system_time_set = record.KernelTime;
+      kernel_str = GetTimeFormatString((UINT64)record.KernelTime, TRUE);
+      if (NULL == kernel_str)
       {
-        FREE_POOL_SAFE(record->ArgValues[z]);
+        ReturnCode = EFI_ABORTED;
+        goto Finish;
       }
-
-      FREE_POOL_SAFE(record->ArgValues);
-      record->ArgValues = NULL;
+      ascii_kernel_str_size = StrLen(kernel_str) + 1;
+      ascii_kernel_str = AllocateZeroPool(sizeof(CHAR8) * ascii_kernel_str_size);
+      UnicodeStrToAsciiStrS(kernel_str, ascii_kernel_str, ascii_kernel_str_size);
+      append_strs[0] = pad_left(ascii_kernel_str, 28, ' ', TRUE);
     }
-
-    if (entry != NULL && dictionary_entry_was_allocated_here)
+    else
     {
-      FREE_POOL_SAFE(entry->FileName);
-      FREE_POOL_SAFE(entry->LogLevel);
-      FREE_POOL_SAFE(entry->LogString);
-      FREE_POOL_SAFE(entry);
-      entry = NULL;
-      record->DictEntry = NULL;
+      ascii_kernel_str = u32_to_a(record.KernelTime, FALSE, 0, FALSE);
+      append_strs[0] = pad_left(ascii_kernel_str, 28, ' ', TRUE);
     }
-
-    node_count++;
+    append_strs[1] = string_copy(" :: ");
+    append_strs[2] = pad_left(entry->FileName, 27, ' ', FALSE);
+    append_strs[3] = string_copy(" :: ");
+    append_strs[4] = pad_left(entry->LogLevel, 7, ' ', FALSE);
+    append_strs[5] = string_copy(" :: ");
+    append_strs[6] = record.FormattedString;
+    append_strs[7] = string_copy("\n");
   }
+  // The old formatted string is now owned by append_strs
+  record.FormattedString = NULL;
 
-  /*
-  build the output string and dump it to the file
-  */
-  decode_header = string_copy("TIMESTAMP ::              FILE           ::   LEVEL :: LOG\n=====================================================================================\n");
-  header_length = string_length(decode_header);
-  total_formatted_string_size += header_length;
-
-  bytes_needed = (sizeof(CHAR8*) * total_formatted_string_size) + sizeof(CHAR8*);
+  *formatted = string_array_concat(append_strs, elements, FALSE, formatted_len);
+  *offset = x;
+  decoder->node_count++;
+  ReturnCode = EFI_SUCCESS;
 
-  total_formatted_string = AllocateZeroPool(bytes_needed);
-  if (NULL == total_formatted_string)
+Finish:
+  FREE_POOL_SAFE(kernel_str);
+  if (append_strs)
   {
-    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate %lu bytes to dump the decoded output\n", bytes_needed);
-    goto Finish;
+    for (z = 0; z < elements; z++)
+    {
+      FREE_POOL_SAFE(append_strs[z]);
+    }
+    FREE_POOL_SAFE(append_strs);
   }
-
-  formatted_string_head = total_formatted_string;
-  appended_count = 0;
-  if (header_length > 0)
+  FREE_POOL_SAFE(record.FormattedString);
+  free_nlog_record_args(&record, (entry != NULL) ? entry->Args : 0);
+  if (dictionary_entry_was_allocated_here)
   {
-    MyMemCopy(formatted_string_head, header_length, decode_header);
-    formatted_string_head = formatted_string_head + header_length;
+    free_nlog_fake_entry(entry);
   }
-  FREE_POOL_SAFE(decode_header);
+  return ReturnCode;
+}
+
+/*
+Start decoding a NLOG stream, writes the decoded header
+
+@param[out] decoder - the decoder state
+@param[in] dict_version - the version of the loaded dictionary
+@param[in] dict_head - the head to the dictionary linked list
+@param[in] write - the writer of the decoded lines
+@param[in] write_context - the context passed to the writer
+
+@retval EFI_SUCCESS the decoder is ready
+@retval other errors returned by the writer
+*/
+EFI_STATUS
+nlog_decoder_init(
+  OUT nlog_decoder *decoder,
+  IN  UINT32 dict_version,
+  IN  nlog_dict_entry* dict_head,
+  IN  NLOG_WRITE_HANDLER write,
+  IN  VOID *write_context
+)
+{
+  CHAR8 *decode_header = NLOG_DECODE_HEADER;
+
+  ZeroMem(decoder, sizeof(*decoder));
+  decoder->dict_version = dict_version;
+  decoder->dict_head = dict_head;
+  decoder->write = write;
+  decoder->write_context = write_context;
+
+  return decoder->write(decoder->write_context, decode_header, string_length(decode_header));
+}
+
+/*
+Decode the next chunk of a NLOG stream
 
-  record = head;
-  while (record)
+A record cut at the end of the chunk is kept and decoded with the next chunk,
+so the chunks may be of any size.
+
+@param[in,out] decoder - the decoder state
+@param[in] nlogbytes - the next bytes of the stream
+@param[in] size - the number of bytes
+
+@retval EFI_SUCCESS the chunk was decoded
+@retval EFI_OUT_OF_RESOURCES memory allocation failure
+@retval other errors returned by the writer
+*/
+EFI_STATUS
+nlog_decode_chunk(
+  IN OUT nlog_decoder *decoder,
+  IN     UINT8* nlogbytes,
+  IN     UINT64 size
+)
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  UINT8 *buffer = nlogbytes;
+  UINT64 buffer_size = size;
+  UINT64 x = 0;
+  UINT64 record_end = 0;
+  CHAR8 *formatted = NULL;
+  UINT64 formatted_len = 0;
+  EFI_STATUS RecordCode = EFI_SUCCESS;
+
+  if (decoder->carry_size > 0)
   {
-    if (record->FormattedStringLen > 0)
+    buffer_size = decoder->carry_size + size;
+    buffer = AllocatePool(buffer_size);
+    if (NULL == buffer)
     {
-      MyMemCopy(formatted_string_head, record->FormattedStringLen, record->FormattedString);
-      formatted_string_head = formatted_string_head + record->FormattedStringLen;
+      return EFI_OUT_OF_RESOURCES;
     }
-
-    FREE_POOL_SAFE(record->FormattedString);
-    record->FormattedString = NULL;
-    appended_count++;
-    record = record->next;
+    CopyMem_S(buffer, buffer_size, decoder->carry, decoder->carry_size);
+    CopyMem_S(buffer + decoder->carry_size, size, nlogbytes, size);
   }
 
-  status = DumpToFile(decoded_file_name, total_formatted_string_size, total_formatted_string, TRUE);
-  if (EFI_ERROR(status))
+  for (x = 0; x + sizeof(UINT32) <= buffer_size; x += 4)
   {
-    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to write record to file %lu\n", status);
-    goto Finish;
-  }
-  PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Decoded %lu records to file " FORMAT_STR "\n", node_count, decoded_file_name);
+    record_end = x;
+    RecordCode = decode_nlog_record(decoder, buffer, buffer_size, &record_end, &formatted, &formatted_len);
+    if (RecordCode == EFI_NOT_FOUND)
+    {
+      continue;
+    }
+    if (RecordCode == EFI_BUFFER_TOO_SMALL)
+    {
+      break;
+    }
+    if (EFI_ERROR(RecordCode))
+    {
+      ReturnCode = RecordCode;
+      goto Finish;
+    }
 
-Finish:
+    ReturnCode = decoder->write(decoder->write_context, formatted, formatted_len);
+    FREE_POOL_SAFE(formatted);
+    if (EFI_ERROR(ReturnCode))
+    {
+      goto Finish;
+    }
+    x = record_end;
+  }
 
-  if (NULL != old_args)
+  /** Keep the unfinished record and any partial word for the next chunk **/
+  decoder->stream_offset += x;
+  decoder->carry_size = buffer_size - MIN(x, buffer_size);
+  if (decoder->carry_size > 0)
   {
-    for (z = 0; z < old_arg_count; z++)
+    VOID *carry = ReallocatePool(0, decoder->carry_size, NULL);
+    if (NULL == carry)
     {
-      FREE_POOL_SAFE(old_args[z]);
+      ReturnCode = EFI_OUT_OF_RESOURCES;
+      goto Finish;
     }
-    FREE_POOL_SAFE(old_args);
+    CopyMem_S(carry, decoder->carry_size, buffer + x, decoder->carry_size);
+    FREE_POOL_SAFE(decoder->carry);
+    decoder->carry = carry;
   }
-
-  if (NULL != total_formatted_string)
+  else
   {
-    FREE_POOL_SAFE(total_formatted_string);
+    FREE_POOL_SAFE(decoder->carry);
   }
 
-  if (NULL != append_strs)
+Finish:
+  if (buffer != nlogbytes)
   {
-    for (z = 0; z < elements; z++)
-    {
-      FREE_POOL_SAFE(append_strs[z]);
-    }
-    FREE_POOL_SAFE(append_strs);
+    FREE_POOL_SAFE(buffer);
   }
+  return ReturnCode;
+}
+
+/*
+Finish decoding a NLOG stream
+
+@param[in,out] decoder - the decoder state
 
-  while (head != NULL)
+@retval EFI_SUCCESS the whole stream was decoded
+@retval EFI_END_OF_FILE the stream ended in the middle of a record
+*/
+EFI_STATUS
+nlog_decoder_finish(
+  IN OUT nlog_decoder *decoder
+)
+{
+  EFI_STATUS ReturnCode = (decoder->carry_size > 0) ? EFI_END_OF_FILE : EFI_SUCCESS;
+
+  FREE_POOL_SAFE(decoder->carry);
+  decoder->carry_size = 0;
+  return ReturnCode;
+}
+
+/*
+Decoded output collected in memory by decode_nlog_binary
+*/
+typedef struct {
+  CHAR8 *buffer;
+  UINT64 size;
+} nlog_output_buffer;
+
+/*
+Writer appending decoded lines to a nlog_output_buffer
+*/
+STATIC
+EFI_STATUS
+append_nlog_output(
+  IN VOID *context,
+  IN CHAR8 *data,
+  IN UINT64 size
+)
+{
+  nlog_output_buffer *output = (nlog_output_buffer *)context;
+  CHAR8 *grown = NULL;
+
+  grown = ReallocatePool(output->size, output->size + size, output->buffer);
+  if (NULL == grown)
   {
-    next = head->next;
-    if (head->ArgValues)
-    {
-      for (z = 0; z < head->DictEntry->Args; z++)
-      {
-        FREE_POOL_SAFE(head->ArgValues[z]);
-      }
+    return EFI_OUT_OF_RESOURCES;
+  }
+  output->buffer = grown;
+  CopyMem_S(output->buffer + output->size, size, data, size);
+  output->size += size;
+  return EFI_SUCCESS;
+}
 
-      FREE_POOL_SAFE(head->ArgValues);
-    }
+VOID
+decode_nlog_binary(
+  struct Command *pCmd,
+  CHAR16* decoded_file_name,
+  UINT8* nlogbytes,
+  UINT64 size,
+  UINT32 dict_version,
+  nlog_dict_entry* dict_head
+)
+{
+  EFI_STATUS status;
+  nlog_decoder decoder;
+  nlog_output_buffer output;
+  PRINT_CONTEXT *pPrinterCtx = NULL;
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
 
-    if (head->FormattedString)
-    {
-      FREE_POOL_SAFE(head->FormattedString);
-    }
+  ZeroMem(&output, sizeof(output));
 
-    FREE_POOL_SAFE(head);
-    head = next;
+  if (pCmd != NULL) {
+    pPrinterCtx = pCmd->pPrintCtx;
   }
 
-  if (entry != NULL && dictionary_entry_was_allocated_here)
+  status = nlog_decoder_init(&decoder, dict_version, dict_head, append_nlog_output, &output);
+  if (!EFI_ERROR(status))
   {
-    FREE_POOL_SAFE(entry->FileName);
-    FREE_POOL_SAFE(entry->LogLevel);
-    FREE_POOL_SAFE(entry->LogString);
-    FREE_POOL_SAFE(entry);
+    status = nlog_decode_chunk(&decoder, nlogbytes, size);
+  }
+  if (EFI_ERROR(status))
+  {
+    nlog_decoder_finish(&decoder);
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to allocate space for decoded records\n");
+    goto Finish;
   }
+  if (EFI_ERROR(nlog_decoder_finish(&decoder)))
+  {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Unexpected end of buffer.\n");
+  }
+
+  /*
+  dump the decoded output to the file
+  */
+  status = DumpToFile(decoded_file_name, output.size, output.buffer, TRUE);
+  if (EFI_ERROR(status))
+  {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Failed to write record to file %lu\n", status);
+    goto Finish;
+  }
+  PRINTER_SET_MSG(pPrinterCtx, ReturnCode, L"Decoded %lu records to file " FORMAT_STR "\n", decoder.node_count, decoded_file_name);
+
+Finish:
+  FREE_POOL_SAFE(output.buffer);
 }
 
 nlog_dict_entry*
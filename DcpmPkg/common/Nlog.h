@@ -51,6 +51,77 @@ typedef struct {
   VOID* prev;
 } nlog_record;
 
+/*
+Writer of the lines decoded from a NLOG stream
+
+@param[in] context - the context given to nlog_decoder_init
+@param[in] data - the decoded characters
+@param[in] size - the number of characters
+
+@retval EFI_SUCCESS to continue decoding, any error stops the decoder
+*/
+typedef EFI_STATUS (*NLOG_WRITE_HANDLER)(VOID *context, CHAR8 *data, UINT64 size);
+
+/*
+State of an incremental NLOG decoder
+*/
+typedef struct {
+  UINT32 dict_version;            //!< Version of the loaded dictionary
+  nlog_dict_entry* dict_head;     //!< Head to the dictionary linked list
+  NLOG_WRITE_HANDLER write;       //!< Writer of the decoded lines
+  VOID* write_context;            //!< Context passed to the writer
+  BOOLEAN inv2section;            //!< The current section holds V2 records
+  UINT32 system_time_set;         //!< Kernel time the system time was set at
+  UINT64 node_count;              //!< Number of decoded records
+  UINT64 stream_offset;           //!< Stream offset of the first carried byte
+  UINT8* carry;                   //!< Unfinished record from the previous chunk
+  UINT64 carry_size;              //!< Size of the unfinished record
+} nlog_decoder;
+
+/*
+nlog_decoder_init command
+
+@param[out] decoder - the decoder state
+@param[in] dict_version - the version of the loaded dictionary
+@param[in] dict_head - the head to the dictionary linked list
+@param[in] write - the writer of the decoded lines
+@param[in] write_context - the context passed to the writer
+*/
+EFI_STATUS
+nlog_decoder_init(
+  OUT nlog_decoder *decoder,
+  IN  UINT32 dict_version,
+  IN  nlog_dict_entry* dict_head,
+  IN  NLOG_WRITE_HANDLER write,
+  IN  VOID *write_context
+);
+
+/*
+nlog_decode_chunk command, decodes the next bytes of a stream
+
+@param[in,out] decoder - the decoder state
+@param[in] nlogbytes - the next bytes of the stream
+@param[in] size - the number of bytes
+*/
+EFI_STATUS
+nlog_decode_chunk(
+  IN OUT nlog_decoder *decoder,
+  IN     UINT8* nlogbytes,
+  IN     UINT64 size
+);
+
+/*
+nlog_decoder_finish command
+
+@param[in,out] decoder - the decoder state
+
+@retval EFI_END_OF_FILE the stream ended in the middle of a record
+*/
+EFI_STATUS
+nlog_decoder_finish(
+  IN OUT nlog_decoder *decoder
+);
+
 /*
 decode_nlog_binary command
 
@@ -900,18 +900,40 @@ EFI_STATUS
      OUT COMMAND_STATUS *pCommandStatus
   );
 
+/** Diagnostics State bitmasks **/
+#define DIAG_STATE_MASK_OK         BIT0
+#define DIAG_STATE_MASK_WARNING    BIT1
+#define DIAG_STATE_MASK_FAILED     BIT2
+#define DIAG_STATE_MASK_ABORTED    BIT3
+#define DIAG_STATE_MASK_ALL (DIAG_STATE_MASK_OK |  DIAG_STATE_MASK_WARNING |  DIAG_STATE_MASK_FAILED |  DIAG_STATE_MASK_ABORTED)
+
+/** SubTestIndex of the events reported by a test itself rather than by one of its subtests **/
+#define DIAG_NO_SUBTEST            0xFF
+
+/**
+  A single event reported by a diagnostic test
+**/
+typedef struct _DIAG_EVENT
+{
+  UINT8 SubTestIndex;     ///< Index into the DIAG_INFO SubTest arrays or DIAG_NO_SUBTEST
+  UINT16 DimmId;          ///< PMem module the event is about, DIMM_PID_INVALID if it is not about one
+  UINT32 EventCode;       ///< Diagnostic event code
+  UINT8 StateMask;        ///< Severity of the event, one of DIAG_STATE_MASK_*
+  CHAR16 *pMessage;       ///< Message with the event parameters filled in
+} DIAG_EVENT;
+
 typedef struct DIAGNOSTIC_INFO
 {
   CHAR16 *TestName;
-  CHAR16 *Message;
   CHAR16 *State;
   UINT8 StateVal;
   UINT32  ResultCode;
   CHAR16 *SubTestName[MAX_NO_OF_DIAGNOSTIC_SUBTESTS];
   UINT8  SubTestStateVal[MAX_NO_OF_DIAGNOSTIC_SUBTESTS];
   CHAR16 *SubTestState[MAX_NO_OF_DIAGNOSTIC_SUBTESTS];
-  CHAR16 *SubTestMessage[MAX_NO_OF_DIAGNOSTIC_SUBTESTS];
-  CHAR16 *SubTestEventCode[MAX_NO_OF_DIAGNOSTIC_SUBTESTS];
+  DIAG_EVENT *pEvents;          ///< Events in the order they were reported
+  UINT32 EventsNum;
+  UINT32 EventsCapacity;
 } DIAG_INFO;
 
 /**
@@ -1416,6 +1438,38 @@ EFI_STATUS
   IN OUT UINT32 *pEntryCount
   );
 
+/**
+  Stream the debug log from a specified PMem module and fw debug log source
+
+  The log is handed to the page handler page by page as it is fetched, so
+  the caller never needs a buffer of the whole log size.
+
+  @param[in] pThis is a pointer to the EFI_DCPMM_CONFIG2_PROTOCOL instance.
+  @param[in] DimmID identifier of what PMem module to get log pages from
+  @param[in] LogSource debug log source buffer to retrieve
+  @param[in] StartPageOffset page to start from, non zero to resume an interrupted stream
+  @param[in] pHandler consumer of the fetched pages
+  @param[in] pContext context passed to the page handler
+  @param[out] pNextPageOffset page to resume from if the stream stopped early. OPTIONAL
+  @param[out] pCommandStatus structure containing detailed NVM error codes
+
+  @retval EFI_INVALID_PARAMETER One or more parameters are invalid
+  @retval EFI_NOT_STARTED No logs to fetch
+  @retval EFI_SUCCESS All ok
+**/
+typedef
+EFI_STATUS
+(EFIAPI *EFI_DCPMM_CONFIG_GET_FW_DEBUG_LOG_STREAM) (
+  IN     EFI_DCPMM_CONFIG2_PROTOCOL *pThis,
+  IN     UINT16 DimmID,
+  IN     UINT8 LogSource,
+  IN     UINT32 StartPageOffset,
+  IN     FW_DEBUG_LOG_PAGE_HANDLER pHandler,
+  IN     VOID *pContext,
+     OUT UINT32 *pNextPageOffset OPTIONAL,
+     OUT COMMAND_STATUS *pCommandStatus
+  );
+
 /**
   Pass Through command to FW
   Sends a command to FW and waits for response from firmware
@@ -1745,6 +1799,7 @@ struct _EFI_DCPMM_CONFIG2_PROTOCOL {
   EFI_DCPMM_CONFIG_SET_FIS_TRANSPORT_ATTRIBS SetFisTransportAttributes;
   EFI_DCPMM_CONFIG_GET_COMMAND_ACCESS_POLICY GetCommandAccessPolicy;
   EFI_DCPMM_CONFIG_GET_COMMAND_EFFECT_LOG GetCommandEffectLog;
+  EFI_DCPMM_CONFIG_GET_FW_DEBUG_LOG_STREAM GetFwDebugLogStream;
 };
 
 /**
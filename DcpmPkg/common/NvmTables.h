@@ -278,6 +278,18 @@ typedef struct {
   UINT32 Reserved_1;                  ///< Reserved
 } PlatformCapabilitiesTbl;
 
+/**
+  Lookup index over one of the parsed table arrays
+
+  Open addressing hash of a key to the position of a table in its array.
+  Positions are stored incremented by one so a zeroed slot is empty.
+**/
+typedef struct {
+  UINT32 SlotsNum;                                                ///< Count of slots, a power of two or 0
+  UINT32 *pKeys;                                                  ///< Key stored in each slot
+  UINT32 *pPositions;                                             ///< Table position + 1, 0 for an empty slot
+} ACPI_TABLE_INDEX;
+
 /** NFIT ACPI data */
 typedef struct {
   NFitHeader *pFit;                                               ///< NFIT Header
@@ -297,6 +309,13 @@ typedef struct {
   FlushHintTbl **ppFlushHintTbles;                                ///< Flush Hint tables
   UINT32 PlatformCapabilitiesTblesNum;                            ///< Count of PCAT tables
   PlatformCapabilitiesTbl **ppPlatformCapabilitiesTbles;          ///< PCAT tables
+  ACPI_TABLE_INDEX SpaRangeTblesIndex;                            ///< SPA Range tables by SPA range index
+  ACPI_TABLE_INDEX InterleaveTblesIndex;                          ///< Interleave tables by interleave index
+  ACPI_TABLE_INDEX ControlRegionTblesIndex;                       ///< Control Region tables by control region index
+  ACPI_TABLE_INDEX BWRegionTblesIndex;                            ///< BW Region tables by control region index
+  ACPI_TABLE_INDEX FlushHintTblesIndex;                           ///< Flush Hint tables by device handle
+  ACPI_TABLE_INDEX NvDimmRegionMappingStructuresIndex;            ///< First Region table of each physical ID
+  UINT32 *pNvDimmRegionMappingStructuresNext;                     ///< Position + 1 of the next Region table with the same physical ID
 } ParsedFitHeader;
 
 typedef struct {
@@ -885,6 +904,7 @@ typedef struct {
   PMTT_MODULE_INFO **ppDDRModules;        ///< DDR4 Module Type Data Tables
   UINT32 DCPMModulesNum;                  ///< Count of PMem module Devices
   PMTT_MODULE_INFO **ppDCPMModules;       ///< PMem module Type Data Tables
+  ACPI_TABLE_INDEX DCPMModulesIndex;      ///< PMem module Type Data Tables by SMBIOS handle
 } ParsedPmttHeader;
 
 
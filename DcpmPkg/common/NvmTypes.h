@@ -1311,6 +1311,27 @@ Start Diagnostic Command tests codes
 #define FW_DEBUG_LOG_SOURCE_MAX     2
 #define NUM_FW_DEBUG_LOG_SOURCES    3
 
+/**
+  Consumer of the FW debug log pages streamed by GetFwDebugLogStream
+
+  @param[in] pContext Context passed to GetFwDebugLogStream
+  @param[in] LogPageOffset Page offset of the chunk in the log
+  @param[in] pChunk Log bytes of the page
+  @param[in] ChunkSize Number of log bytes in the page
+  @param[in] LogSize Size of the whole log in bytes
+
+  @retval EFI_SUCCESS Continue with the next page, any error stops the stream
+**/
+typedef
+EFI_STATUS
+(*FW_DEBUG_LOG_PAGE_HANDLER) (
+  IN     VOID *pContext,
+  IN     UINT32 LogPageOffset,
+  IN     UINT8 *pChunk,
+  IN     UINT64 ChunkSize,
+  IN     UINT64 LogSize
+  );
+
 
 /** Defines for the ModifyPcdConfig API */
 #define DELETE_PCD_CONFIG_LSA_MASK    (BIT0) //!< Delete the namespace partition
@@ -92,6 +92,12 @@ PbrGetPassThruRecord(
   //should be pointing to the response header
   ptResp = (PbrPassThruResp *)((UINTN)pData + (UINTN)CurDataPos);
 
+  if (ptResp->OutputLargePayloadSize > pCmd->LargeOutputPayloadSize && pCmd->pLargeOutputBuffer != NULL) {
+    NVDIMM_ERR("Recorded large output payload does not fit the caller buffer\n");
+    ReturnCode = EFI_LOAD_ERROR;
+    goto Finish;
+  }
+
   pCmd->Status = ptResp->Status;
   pCmd->OutputPayloadSize = ptResp->OutputPayloadSize;
   pCmd->LargeOutputPayloadSize = ptResp->OutputLargePayloadSize;
@@ -124,7 +130,7 @@ PbrGetPassThruRecord(
 
   //there is a large output payload
   if (ptResp->OutputLargePayloadSize) {
-    CopyMem_S(pCmd->LargeOutputPayload,
+    CopyMem_S(FW_CMD_LARGE_OUTPUT(pCmd),
       OUT_MB_SIZE,
       (UINT8*)pData + CurDataPos,
       ptResp->OutputLargePayloadSize);
@@ -135,6 +141,55 @@ Finish:
   return ReturnCode;
 }
 
+/**
+  Check if the next FW_CMD of the playback buffer is a given command
+
+  The record is not consumed. A command sent only when the session has it,
+  like one a session recorded by an older version lacks, is looked up first
+  so the records after it stay in step.
+
+  @param[in] pContext: Pbr context
+  @param[in] Opcode: FIS Opcode of the command
+  @param[in] SubOpcode: FIS SubOpcode of the command
+
+  @retval TRUE if playing back and the next FW_CMD record is the command
+**/
+BOOLEAN
+PbrIsNextPassThruRecord(
+  IN    PbrContext *pContext,
+  IN    UINT8 Opcode,
+  IN    UINT8 SubOpcode
+)
+{
+  UINT32 CtxIndex = 0;
+  PbrPartitionContext *pPartition = NULL;
+  PbrPartitionLogicalDataItem *pDataItem = NULL;
+  PbrPassThruReq *ptReq = NULL;
+
+  if (PBR_PLAYBACK_MODE != pContext->PbrMode) {
+    return FALSE;
+  }
+
+  for (CtxIndex = 0; CtxIndex < MAX_PARTITIONS; ++CtxIndex) {
+    pPartition = &pContext->PartitionContexts[CtxIndex];
+    if (PBR_PASS_THRU_SIG != pPartition->PartitionSig) {
+      continue;
+    }
+    //verify a whole request header is left in the partition
+    if ((UINT64)pPartition->PartitionCurrentOffset + sizeof(PbrPartitionLogicalDataItem) + sizeof(PbrPassThruReq) >
+        pPartition->PartitionSize) {
+      return FALSE;
+    }
+    pDataItem = (PbrPartitionLogicalDataItem *)((UINTN)pPartition->PartitionData + (UINTN)pPartition->PartitionCurrentOffset);
+    if (PBR_LOGICAL_DATA_SIG != pDataItem->Signature || pDataItem->Size < sizeof(PbrPassThruReq)) {
+      return FALSE;
+    }
+    ptReq = (PbrPassThruReq *)pDataItem->Data;
+    return (Opcode == ptReq->Opcode && SubOpcode == ptReq->SubOpcode);
+  }
+  return FALSE;
+}
+
 /**
   Record a FW_CMD into the recording buffer
 
@@ -225,7 +280,7 @@ PbrSetPassThruRecord(
   {
     CopyMem_S((VOID*)((UINTN)pData + sizeof(PbrPassThruReq) + pCmd->InputPayloadSize + pCmd->LargeInputPayloadSize + sizeof(PbrPassThruResp) + pCmd->OutputPayloadSize),
       DataSize - sizeof(PbrPassThruReq) - pCmd->InputPayloadSize - pCmd->LargeInputPayloadSize - sizeof(PbrPassThruResp) - pCmd->OutputPayloadSize,
-      pCmd->LargeOutputPayload,
+      FW_CMD_LARGE_OUTPUT(pCmd),
       pCmd->LargeOutputPayloadSize);
   }
 Finish:
@@ -90,6 +90,22 @@ PbrSetPassThruRecord(
   EFI_STATUS PassthruReturnCode
 );
 
+/**
+  Check if the next FW_CMD of the playback buffer is a given command
+
+  @param[in] pContext: Pbr context
+  @param[in] Opcode: FIS Opcode of the command
+  @param[in] SubOpcode: FIS SubOpcode of the command
+
+  @retval TRUE if playing back and the next FW_CMD record is the command
+**/
+BOOLEAN
+PbrIsNextPassThruRecord(
+  IN    PbrContext *pContext,
+  IN    UINT8 Opcode,
+  IN    UINT8 SubOpcode
+);
+
 
 /**
   Return the current table from the playback buffer
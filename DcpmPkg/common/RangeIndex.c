@@ -0,0 +1,211 @@
+/*
+* Copyright (c) 2018, Intel Corporation.
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#include "RangeIndex.h"
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include <Debug.h>
+#include <Utility.h>
+
+/**
+  Compare two index entries by their start address
+
+  @param[in] pFirst First entry
+  @param[in] pSecond Second entry
+
+  @retval -1 if first is less than second
+  @retval 0 if first is equal to second
+  @retval 1 if first is greater than second
+**/
+STATIC
+INT32
+CompareRangeIndexEntryStart(
+  IN     VOID *pFirst,
+  IN     VOID *pSecond
+  )
+{
+  RANGE_INDEX_ENTRY *pFirstEntry = (RANGE_INDEX_ENTRY *)pFirst;
+  RANGE_INDEX_ENTRY *pSecondEntry = (RANGE_INDEX_ENTRY *)pSecond;
+
+  if (pFirstEntry->Start < pSecondEntry->Start) {
+    return -1;
+  } else if (pFirstEntry->Start > pSecondEntry->Start) {
+    return 1;
+  }
+  return 0;
+}
+
+/**
+  Allocate an empty index for the given number of ranges
+
+  @param[out] pIndex Index to initialize
+  @param[in] RangesNum Number of ranges that will be inserted
+
+  @retval EFI_SUCCESS Index allocated
+  @retval EFI_INVALID_PARAMETER pIndex is NULL
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure, pIndex is left without an index
+**/
+EFI_STATUS
+RangeIndexInit(
+     OUT RANGE_INDEX *pIndex,
+  IN     UINT32 RangesNum
+  )
+{
+  if (pIndex == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  ZeroMem(pIndex, sizeof(*pIndex));
+  // Keep an allocation for an empty index, a NULL pEntries means no index
+  pIndex->pEntries = AllocateZeroPool(MAX(RangesNum, 1) * sizeof(*pIndex->pEntries));
+  if (pIndex->pEntries == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  pIndex->Capacity = RangesNum;
+  return EFI_SUCCESS;
+}
+
+/**
+  Free the entries of the index
+
+  @param[in, out] pIndex Index to free
+**/
+VOID
+RangeIndexFree(
+  IN OUT RANGE_INDEX *pIndex
+  )
+{
+  if (pIndex == NULL) {
+    return;
+  }
+  FREE_POOL_SAFE(pIndex->pEntries);
+  pIndex->Capacity = 0;
+  pIndex->EntriesNum = 0;
+  pIndex->Built = FALSE;
+}
+
+/**
+  Add a range to an index that is not built yet
+
+  @param[in, out] pIndex Initialized index, with a free entry left
+  @param[in] Start First address of the range
+  @param[in] Length Size of the range, empty ranges are skipped
+
+  @retval EFI_SUCCESS Range added or skipped
+  @retval EFI_INVALID_PARAMETER pIndex is NULL, not initialized or already built
+  @retval EFI_BUFFER_TOO_SMALL All the entries are used
+**/
+EFI_STATUS
+RangeIndexInsert(
+  IN OUT RANGE_INDEX *pIndex,
+  IN     UINT64 Start,
+  IN     UINT64 Length
+  )
+{
+  RANGE_INDEX_ENTRY *pEntry = NULL;
+
+  if (pIndex == NULL || pIndex->pEntries == NULL || pIndex->Built) {
+    return EFI_INVALID_PARAMETER;
+  }
+  if (Length == 0) {
+    return EFI_SUCCESS;
+  }
+  if (pIndex->EntriesNum >= pIndex->Capacity) {
+    return EFI_BUFFER_TOO_SMALL;
+  }
+
+  pEntry = &pIndex->pEntries[pIndex->EntriesNum++];
+  pEntry->Start = Start;
+  // A range running past the end of the address space ends at its last address
+  pEntry->End = (Length - 1 > MAX_UINT64 - Start) ? MAX_UINT64 : Start + Length - 1;
+  return EFI_SUCCESS;
+}
+
+/**
+  Sort the inserted ranges and compute the running maximum end addresses
+
+  @param[in, out] pIndex Index to build
+
+  @retval EFI_SUCCESS Index built
+  @retval EFI_INVALID_PARAMETER pIndex is NULL or not initialized
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+**/
+EFI_STATUS
+RangeIndexBuild(
+  IN OUT RANGE_INDEX *pIndex
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  UINT64 MaxEnd = 0;
+  UINT32 Index = 0;
+
+  if (pIndex == NULL || pIndex->pEntries == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (pIndex->EntriesNum > 1) {
+    ReturnCode = MergeSort(pIndex->pEntries, pIndex->EntriesNum, sizeof(*pIndex->pEntries),
+      CompareRangeIndexEntryStart);
+    if (EFI_ERROR(ReturnCode)) {
+      return ReturnCode;
+    }
+  }
+
+  for (Index = 0; Index < pIndex->EntriesNum; Index++) {
+    if (Index == 0 || pIndex->pEntries[Index].End > MaxEnd) {
+      MaxEnd = pIndex->pEntries[Index].End;
+    }
+    pIndex->pEntries[Index].MaxEnd = MaxEnd;
+  }
+  pIndex->Built = TRUE;
+  return EFI_SUCCESS;
+}
+
+/**
+  Check if an address range overlaps any range of the index
+
+  Finds the entries starting at or before the end of the checked range with a
+  binary search. The range overlaps if the highest end address among them
+  reaches the start of the range.
+
+  @param[in] pIndex Built index
+  @param[in] Address The base address
+  @param[in] Length The address range size
+
+  @retval TRUE The range overlaps at least one range of the index
+  @retval FALSE The range does not overlap, is empty or the index is not built
+**/
+BOOLEAN
+RangeIndexOverlaps(
+  IN     RANGE_INDEX *pIndex,
+  IN     UINT64 Address,
+  IN     UINT64 Length
+  )
+{
+  UINT64 CheckEnd = 0;
+  UINT32 Low = 0;
+  UINT32 High = 0;
+  UINT32 Middle = 0;
+
+  if (pIndex == NULL || pIndex->pEntries == NULL || !pIndex->Built || Length == 0) {
+    return FALSE;
+  }
+
+  CheckEnd = (Length - 1 > MAX_UINT64 - Address) ? MAX_UINT64 : Address + Length - 1;
+  High = pIndex->EntriesNum;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (pIndex->pEntries[Middle].Start <= CheckEnd) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+
+  if (Low == 0) {
+    return FALSE;
+  }
+  return pIndex->pEntries[Low - 1].MaxEnd >= Address;
+}
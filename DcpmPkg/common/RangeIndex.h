@@ -0,0 +1,110 @@
+/*
+* Copyright (c) 2018, Intel Corporation.
+* SPDX-License-Identifier: BSD-3-Clause
+*/
+
+#ifndef _RANGE_INDEX_H_
+#define _RANGE_INDEX_H_
+
+#include <Uefi.h>
+
+/**
+  Address range of the index, End is inclusive
+**/
+typedef struct _RANGE_INDEX_ENTRY {
+  UINT64 Start;
+  UINT64 End;
+  UINT64 MaxEnd;      //!< Highest End of this and all the preceding entries
+} RANGE_INDEX_ENTRY;
+
+/**
+  Static interval index answering overlap queries with one binary search
+
+  Ranges are inserted while the index is built. RangeIndexBuild sorts them by
+  start address and keeps the running maximum end address, so a range overlaps
+  the index when the highest end among the entries starting before its end
+  reaches its start.
+**/
+typedef struct _RANGE_INDEX {
+  RANGE_INDEX_ENTRY *pEntries;  //!< NULL when there is no index
+  UINT32 Capacity;              //!< Number of allocated entries
+  UINT32 EntriesNum;            //!< Number of inserted entries
+  BOOLEAN Built;                //!< Entries are sorted and MaxEnd is valid
+} RANGE_INDEX;
+
+/**
+  Allocate an empty index for the given number of ranges
+
+  @param[out] pIndex Index to initialize
+  @param[in] RangesNum Number of ranges that will be inserted
+
+  @retval EFI_SUCCESS Index allocated
+  @retval EFI_INVALID_PARAMETER pIndex is NULL
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure, pIndex is left without an index
+**/
+EFI_STATUS
+RangeIndexInit(
+     OUT RANGE_INDEX *pIndex,
+  IN     UINT32 RangesNum
+  );
+
+/**
+  Free the entries of the index
+
+  @param[in, out] pIndex Index to free
+**/
+VOID
+RangeIndexFree(
+  IN OUT RANGE_INDEX *pIndex
+  );
+
+/**
+  Add a range to an index that is not built yet
+
+  @param[in, out] pIndex Initialized index, with a free entry left
+  @param[in] Start First address of the range
+  @param[in] Length Size of the range, empty ranges are skipped
+
+  @retval EFI_SUCCESS Range added or skipped
+  @retval EFI_INVALID_PARAMETER pIndex is NULL, not initialized or already built
+  @retval EFI_BUFFER_TOO_SMALL All the entries are used
+**/
+EFI_STATUS
+RangeIndexInsert(
+  IN OUT RANGE_INDEX *pIndex,
+  IN     UINT64 Start,
+  IN     UINT64 Length
+  );
+
+/**
+  Sort the inserted ranges and compute the running maximum end addresses
+
+  @param[in, out] pIndex Index to build
+
+  @retval EFI_SUCCESS Index built
+  @retval EFI_INVALID_PARAMETER pIndex is NULL or not initialized
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+**/
+EFI_STATUS
+RangeIndexBuild(
+  IN OUT RANGE_INDEX *pIndex
+  );
+
+/**
+  Check if an address range overlaps any range of the index
+
+  @param[in] pIndex Built index
+  @param[in] Address The base address
+  @param[in] Length The address range size
+
+  @retval TRUE The range overlaps at least one range of the index
+  @retval FALSE The range does not overlap, is empty or the index is not built
+**/
+BOOLEAN
+RangeIndexOverlaps(
+  IN     RANGE_INDEX *pIndex,
+  IN     UINT64 Address,
+  IN     UINT64 Length
+  );
+
+#endif /** _RANGE_INDEX_H_ **/
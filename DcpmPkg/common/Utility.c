@@ -39,6 +39,9 @@ int _fltused() {
 
 #define NOT_RFC4646_ABRV_LANGUAGE_LEN 3
 
+/** Longest format of a DiagnosticResultToStr line without its strings, %-20ls padding and %d included **/
+#define DIAG_RESULT_LINE_FORMAT_LEN 48
+
 #if defined(DYNAMIC_WA_ENABLE)
 /**
   Local define of the Shell Protocol GetEnv function. The local definition allows the driver to use
@@ -147,58 +150,128 @@ NamespaceTypeToString(
 }
 
 /**
-  Generates string from diagnostic output to print and frees the diagnostic structure
+  Length of a string printed by DiagnosticResultToStr, NULL prints nothing
 
-  @param[in] Type, pointer to type structure
+  @param[in] pStr String to measure
 
-  @retval Pointer to type string
+  @retval Number of characters
+**/
+STATIC
+UINTN
+DiagnosticStrLen(
+  IN     CONST CHAR16 *pStr
+)
+{
+  return (pStr == NULL) ? 0 : StrLen(pStr);
+}
+
+/**
+  Generates string from diagnostic output to print
+
+  The output is sized up front and printed into one buffer, instead of
+  reallocating the whole string for every line.
+
+  @param[in] pResult Pointer to the diagnostic result
+
+  @retval Pointer to the result string
 **/
 CHAR16 *DiagnosticResultToStr(
   IN    DIAG_INFO *pResult
 )
 {
   CHAR16 *pOutputLines = NULL;
-  UINT32 NumTokens = 0;
-  CHAR16 *MsgStr = NULL;
-  UINT8 index = 0;
+  UINTN OutputLen = 0;
+  UINTN Offset = 0;
+  UINT32 Index = 0;
+  UINT32 MsgNum = 0;
   UINT8 Id = 0;
+
+  if (pResult == NULL) {
+    return NULL;
+  }
+
+  // Every line adds at most DIAG_RESULT_LINE_FORMAT_LEN characters to its strings
+  if (pResult->TestName != NULL) {
+    OutputLen += DIAG_RESULT_LINE_FORMAT_LEN + DiagnosticStrLen(pResult->TestName) + DiagnosticStrLen(pResult->State);
+  }
+  for (Id = 0; Id < MAX_NO_OF_DIAGNOSTIC_SUBTESTS; Id++) {
+    if (pResult->SubTestName[Id] != NULL) {
+      OutputLen += DIAG_RESULT_LINE_FORMAT_LEN + DiagnosticStrLen(pResult->SubTestName[Id]) +
+        DiagnosticStrLen(pResult->SubTestState[Id]);
+    }
+  }
+  for (Index = 0; Index < pResult->EventsNum; Index++) {
+    OutputLen += DIAG_RESULT_LINE_FORMAT_LEN + DiagnosticStrLen(pResult->pEvents[Index].pMessage);
+  }
+
+  pOutputLines = AllocateZeroPool((OutputLen + 1) * sizeof(CHAR16));
+  if (pOutputLines == NULL) {
+    return NULL;
+  }
+
   if (pResult->TestName != NULL) {
-    pOutputLines = CatSPrintClean(pOutputLines,
+    Offset += UnicodeSPrint(pOutputLines + Offset, (OutputLen + 1 - Offset) * sizeof(CHAR16),
       L"\n***** %ls = %ls *****\n", pResult->TestName, pResult->State);
-    CHAR16 **TestEventMesg = StrSplit(pResult->Message, L'\n', &NumTokens);
-    if (TestEventMesg != NULL) {
-      pOutputLines = CatSPrintClean(pOutputLines,
-        L"Message : %ls\n", TestEventMesg[0]);
-      FreeStringArray(TestEventMesg, NumTokens);
+    for (Index = 0; Index < pResult->EventsNum; Index++) {
+      if (pResult->pEvents[Index].SubTestIndex == DIAG_NO_SUBTEST) {
+        Offset += UnicodeSPrint(pOutputLines + Offset, (OutputLen + 1 - Offset) * sizeof(CHAR16),
+          L"Message : %ls\n", pResult->pEvents[Index].pMessage);
+        break;
+      }
     }
   }
 
   for (Id = 0; Id < MAX_NO_OF_DIAGNOSTIC_SUBTESTS; Id++) {
-    if (pResult->SubTestName[Id] != NULL) {
-      pOutputLines = CatSPrintClean(pOutputLines,
-        L"  %-20ls = %ls\n", pResult->SubTestName[Id], pResult->SubTestState[Id]);
-      if (pResult->SubTestMessage[Id] != NULL) {
-        CHAR16 **ppSplitSubTestMessage = StrSplit(pResult->SubTestMessage[Id], L'\n', &NumTokens);
-        if (ppSplitSubTestMessage != NULL) {
-          for (index = 0; index < NumTokens; index++) {
-            MsgStr = CatSPrintClean(MsgStr, L"Message.%d", index + 1);
-            pOutputLines = CatSPrintClean(pOutputLines, L"  %ls = %ls\n", MsgStr, ppSplitSubTestMessage[index]);
-            FREE_POOL_SAFE(MsgStr);
-          }
-        }
-        FreeStringArray(ppSplitSubTestMessage, NumTokens);
+    if (pResult->SubTestName[Id] == NULL) {
+      continue;
+    }
+    Offset += UnicodeSPrint(pOutputLines + Offset, (OutputLen + 1 - Offset) * sizeof(CHAR16),
+      L"  %-20ls = %ls\n", pResult->SubTestName[Id], pResult->SubTestState[Id]);
+    MsgNum = 0;
+    for (Index = 0; Index < pResult->EventsNum; Index++) {
+      if (pResult->pEvents[Index].SubTestIndex == Id) {
+        MsgNum++;
+        Offset += UnicodeSPrint(pOutputLines + Offset, (OutputLen + 1 - Offset) * sizeof(CHAR16),
+          L"  Message.%d = %ls\n", MsgNum, pResult->pEvents[Index].pMessage);
       }
-      FREE_POOL_SAFE(pResult->SubTestName[Id]);
-      FREE_POOL_SAFE(pResult->SubTestMessage[Id]);
-      FREE_POOL_SAFE(pResult->SubTestState[Id]);
     }
   }
-  FREE_POOL_SAFE(pResult->TestName);
-  FREE_POOL_SAFE(pResult->Message);
-  FREE_POOL_SAFE(pResult->State);
 
   return pOutputLines;
 }
+
+/**
+  Free a diagnostic result with all its strings and events
+
+  @param[in out] ppResult Pointer to the diagnostic result, NULL afterwards
+**/
+VOID
+FreeDiagnosticResult(
+  IN OUT DIAG_INFO **ppResult
+)
+{
+  DIAG_INFO *pResult = NULL;
+  UINT32 Index = 0;
+  UINT8 Id = 0;
+
+  if (ppResult == NULL || *ppResult == NULL) {
+    return;
+  }
+  pResult = *ppResult;
+
+  for (Id = 0; Id < MAX_NO_OF_DIAGNOSTIC_SUBTESTS; Id++) {
+    FREE_POOL_SAFE(pResult->SubTestName[Id]);
+    FREE_POOL_SAFE(pResult->SubTestState[Id]);
+  }
+  for (Index = 0; Index < pResult->EventsNum; Index++) {
+    FREE_POOL_SAFE(pResult->pEvents[Index].pMessage);
+  }
+  FREE_POOL_SAFE(pResult->pEvents);
+  FREE_POOL_SAFE(pResult->TestName);
+  FREE_POOL_SAFE(pResult->State);
+  FREE_POOL_SAFE(*ppResult);
+}
+
 /**
   Generates pointer to string with value corresponding to health state
   Caller is responsible for FreePool on this pointer
@@ -3271,7 +3344,82 @@ MemoryTypeToStr(
 }
 
 /**
-  Sort Linked List by using Bubble Sort.
+  Merge two sorted, NULL terminated chains of list entries linked by ForwardLink
+
+  Entries of the first chain go first among equal ones, which keeps the sort stable.
+  BackLinks are not updated.
+
+  @param[in] pFirst First sorted chain
+  @param[in] pSecond Second sorted chain
+  @param[in] Compare Pointer to function that is needed for items comparing
+
+  @retval Head of the merged chain
+**/
+STATIC
+LIST_ENTRY *
+MergeListChains(
+  IN     LIST_ENTRY *pFirst,
+  IN     LIST_ENTRY *pSecond,
+  IN     INT32 (*Compare) (VOID *first, VOID *second)
+  )
+{
+  LIST_ENTRY Head;
+  LIST_ENTRY *pTail = &Head;
+
+  while (pFirst != NULL && pSecond != NULL) {
+    if (Compare(pFirst, pSecond) <= 0) {
+      pTail->ForwardLink = pFirst;
+      pFirst = pFirst->ForwardLink;
+    } else {
+      pTail->ForwardLink = pSecond;
+      pSecond = pSecond->ForwardLink;
+    }
+    pTail = pTail->ForwardLink;
+  }
+  pTail->ForwardLink = (pFirst != NULL) ? pFirst : pSecond;
+
+  return Head.ForwardLink;
+}
+
+/**
+  Sort a NULL terminated chain of list entries linked by ForwardLink
+
+  @param[in] pChain Chain to sort
+  @param[in] Count Number of entries in the chain
+  @param[in] Compare Pointer to function that is needed for items comparing
+
+  @retval Head of the sorted chain
+**/
+STATIC
+LIST_ENTRY *
+MergeSortListChain(
+  IN     LIST_ENTRY *pChain,
+  IN     UINT32 Count,
+  IN     INT32 (*Compare) (VOID *first, VOID *second)
+  )
+{
+  LIST_ENTRY *pSecond = NULL;
+  LIST_ENTRY *pLastOfFirst = pChain;
+  UINT32 Index = 0;
+
+  if (Count < 2) {
+    return pChain;
+  }
+
+  for (Index = 1; Index < Count / 2; Index++) {
+    pLastOfFirst = pLastOfFirst->ForwardLink;
+  }
+  pSecond = pLastOfFirst->ForwardLink;
+  pLastOfFirst->ForwardLink = NULL;
+
+  return MergeListChains(MergeSortListChain(pChain, Count / 2, Compare),
+    MergeSortListChain(pSecond, Count - Count / 2, Compare), Compare);
+}
+
+/**
+  Sort Linked List by using stable Merge Sort.
+
+  The entries are relinked in place, no memory is allocated.
 
   @param[in, out] LIST HEAD to sort
   @param[in] Compare Pointer to function that is needed for items comparing. It should return:
@@ -3280,51 +3428,40 @@ MemoryTypeToStr(
                      1  if "first > second"
 
   @retval EFI_SUCCESS Success
-  @retval EFI_INVALID_PARAMETER One or more parameters are NULL
-  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+  @retval EFI_INVALID_PARAMETER One or more parameters are NULL or the list is empty
 **/
 EFI_STATUS
-BubbleSortLinkedList(
+MergeSortLinkedList(
   IN OUT LIST_ENTRY *pList,
   IN     INT32 (*Compare) (VOID *first, VOID *second)
   )
 {
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
-  BOOLEAN Swapped = FALSE;
-  LIST_ENTRY *pNodeCurrentEntry = NULL;
-  LIST_ENTRY *pNodeNextEntry = NULL;
+  LIST_ENTRY *pNode = NULL;
+  LIST_ENTRY *pPrevious = NULL;
+  UINT32 Count = 0;
 
   NVDIMM_ENTRY();
 
-  if (IsListEmpty(pList) || Compare == NULL) {
+  if (pList == NULL || Compare == NULL || IsListEmpty(pList)) {
     goto Finish;
   }
 
-  do {
-    Swapped = FALSE;
-
-    pNodeCurrentEntry = pList->ForwardLink;
-    pNodeNextEntry = pNodeCurrentEntry->ForwardLink;
-
-    while (pNodeNextEntry != pList) {
-
-      if (Compare(pNodeCurrentEntry, pNodeNextEntry) > 0) {
+  for (pNode = pList->ForwardLink; pNode != pList; pNode = pNode->ForwardLink) {
+    Count++;
+  }
 
-      LIST_ENTRY *
-        EFIAPI
-        SwapListEntries(
-          IN OUT  LIST_ENTRY                *FirstEntry,
-          IN OUT  LIST_ENTRY                *SecondEntry
-        ); SwapListEntries(pNodeCurrentEntry, pNodeNextEntry);
-        pNodeCurrentEntry = pNodeNextEntry;
-        pNodeNextEntry = pNodeNextEntry->ForwardLink;
-        Swapped = TRUE;
-      }
+  // Sort the entries as a NULL terminated chain, then restore the circular list
+  pList->BackLink->ForwardLink = NULL;
+  pList->ForwardLink = MergeSortListChain(pList->ForwardLink, Count, Compare);
 
-      pNodeCurrentEntry = pNodeNextEntry;
-      pNodeNextEntry = pNodeNextEntry->ForwardLink;
-    }
-  } while (Swapped);
+  pPrevious = pList;
+  for (pNode = pList->ForwardLink; pNode != NULL; pNode = pNode->ForwardLink) {
+    pNode->BackLink = pPrevious;
+    pPrevious = pNode;
+  }
+  pPrevious->ForwardLink = pList;
+  pList->BackLink = pPrevious;
 
   ReturnCode = EFI_SUCCESS;
 
@@ -3334,7 +3471,10 @@ Finish:
 }
 
 /**
-  Sort an array by using Bubble Sort.
+  Sort an array by using stable bottom-up Merge Sort.
+
+  Runs of doubling width are merged back and forth between the array and
+  a buffer of the same size.
 
   @param[in, out] pArray Array to sort
   @param[in] Count Number of items in array
@@ -3349,7 +3489,7 @@ Finish:
   @retval EFI_OUT_OF_RESOURCES Memory allocation failure
 **/
 EFI_STATUS
-BubbleSort(
+MergeSort(
   IN OUT VOID *pArray,
   IN     UINT32 Count,
   IN     UINT32 ItemSize,
@@ -3357,11 +3497,18 @@ BubbleSort(
   )
 {
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
-  BOOLEAN Swapped = FALSE;
-  UINT32 Index = 0;
-  VOID *pTmpItem = NULL;
-  UINT8 *pFirst = NULL;
-  UINT8 *pSecond = NULL;
+  UINTN ArraySize = 0;
+  UINT8 *pBuffer = NULL;
+  UINT8 *pSource = NULL;
+  UINT8 *pDestination = NULL;
+  UINT8 *pSwap = NULL;
+  UINT64 Width = 0;
+  UINT64 Left = 0;
+  UINT64 Middle = 0;
+  UINT64 Right = 0;
+  UINT64 FirstIndex = 0;
+  UINT64 SecondIndex = 0;
+  UINT64 OutIndex = 0;
 
   NVDIMM_ENTRY();
 
@@ -3369,31 +3516,54 @@ BubbleSort(
     goto Finish;
   }
 
-  pTmpItem = AllocateZeroPool(ItemSize);
-  if (pTmpItem == NULL) {
+  if (Count < 2 || ItemSize == 0) {
+    ReturnCode = EFI_SUCCESS;
+    goto Finish;
+  }
+
+  ArraySize = (UINTN)Count * ItemSize;
+  pBuffer = AllocatePool(ArraySize);
+  if (pBuffer == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
   }
 
-  do {
-    Swapped = FALSE;
-    for (Index = 1; Index < Count; Index++) {
-      pFirst = (UINT8 *) pArray + (Index - 1) * ItemSize;
-      pSecond = (UINT8 *) pArray + Index * ItemSize;
-
-      if (Compare(pFirst, pSecond) > 0) {
-        CopyMem_S(pTmpItem, ItemSize, pFirst, ItemSize);
-        CopyMem_S(pFirst, ItemSize, pSecond, ItemSize);
-        CopyMem_S(pSecond, ItemSize, pTmpItem, ItemSize);
-        Swapped = TRUE;
+  pSource = (UINT8 *) pArray;
+  pDestination = pBuffer;
+
+  for (Width = 1; Width < Count; Width *= 2) {
+    for (Left = 0; Left < Count; Left += 2 * Width) {
+      Middle = MIN(Left + Width, Count);
+      Right = MIN(Left + 2 * Width, Count);
+      FirstIndex = Left;
+      SecondIndex = Middle;
+
+      for (OutIndex = Left; OutIndex < Right; OutIndex++) {
+        // Taking the first run on ties keeps the sort stable
+        if (FirstIndex < Middle &&
+            (SecondIndex >= Right || Compare(pSource + FirstIndex * ItemSize, pSource + SecondIndex * ItemSize) <= 0)) {
+          CopyMem_S(pDestination + OutIndex * ItemSize, ItemSize, pSource + FirstIndex * ItemSize, ItemSize);
+          FirstIndex++;
+        } else {
+          CopyMem_S(pDestination + OutIndex * ItemSize, ItemSize, pSource + SecondIndex * ItemSize, ItemSize);
+          SecondIndex++;
+        }
       }
     }
-  } while (Swapped);
+
+    pSwap = pSource;
+    pSource = pDestination;
+    pDestination = pSwap;
+  }
+
+  if (pSource != (UINT8 *) pArray) {
+    CopyMem_S(pArray, ArraySize, pSource, ArraySize);
+  }
 
   ReturnCode = EFI_SUCCESS;
 
 Finish:
-  FREE_POOL_SAFE(pTmpItem);
+  FREE_POOL_SAFE(pBuffer);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
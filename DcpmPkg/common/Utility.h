@@ -593,16 +593,27 @@ NamespaceTypeToString(
   );
 
 /**
-  Generates string from diagnostic output to print and frees the diagnostic structure
+  Generates string from diagnostic output to print
 
-  @param[in] Type, pointer to type structure
+  @param[in] pResult Pointer to the diagnostic result
 
-  @retval Pointer to type string
+  @retval Pointer to the result string
 **/
 CHAR16 *
 DiagnosticResultToStr(
   IN    DIAG_INFO *pResult
 );
+
+/**
+  Free a diagnostic result with all its strings and events
+
+  @param[in out] ppResult Pointer to the diagnostic result, NULL afterwards
+**/
+VOID
+FreeDiagnosticResult(
+  IN OUT DIAG_INFO **ppResult
+);
+
 /**
   Generates pointer to string with value corresponding to health state
   Caller is responsible for FreePool on this pointer
@@ -1588,7 +1599,9 @@ MemoryTypeToStr(
   );
 
 /**
-  Sort Linked List by using Bubble Sort.
+  Sort Linked List by using stable Merge Sort.
+
+  The entries are relinked in place, no memory is allocated.
 
   @param[in, out] LIST HEAD to sort
   @param[in] Compare Pointer to function that is needed for items comparing. It should return:
@@ -1597,17 +1610,16 @@ MemoryTypeToStr(
                      1  if "first > second"
 
   @retval EFI_SUCCESS Success
-  @retval EFI_INVALID_PARAMETER One or more parameters are NULL
-  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+  @retval EFI_INVALID_PARAMETER One or more parameters are NULL or the list is empty
 **/
 EFI_STATUS
-BubbleSortLinkedList(
+MergeSortLinkedList(
   IN OUT LIST_ENTRY *pList,
   IN     INT32 (*Compare) (VOID *first, VOID *second)
   );
 
 /**
-  Sort an array by using Bubble Sort.
+  Sort an array by using stable bottom-up Merge Sort.
 
   @param[in, out] pArray Array to sort
   @param[in] Count Number of items in array
@@ -1622,7 +1634,7 @@ BubbleSortLinkedList(
   @retval EFI_OUT_OF_RESOURCES Memory allocation failure
 **/
 EFI_STATUS
-BubbleSort(
+MergeSort(
   IN OUT VOID *pArray,
   IN     UINT32 Count,
   IN     UINT32 ItemSize,
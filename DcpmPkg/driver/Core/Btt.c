@@ -10,6 +10,9 @@
 #include "BttLayout.h"
 #include "Namespace.h"
 #include <Convert.h>
+#ifdef OS_BUILD
+#include <os.h>
+#endif
 GUID gBttAbstractionGuid = EFI_BTT_ABSTRACTION_GUID;
 
 /**
@@ -67,6 +70,7 @@ BttReadFlogs(
     @param [in] Lba Logical block address to be written
     @param [in] OldMap Previous map entry to be written
     @param [in] NewMap New map entry to be written
+    @param [in] Lane Lane owning the Flog entry to be updated
 **/
 STATIC
 EFI_STATUS
@@ -75,7 +79,8 @@ BttFlogUpdate(
   IN     ARENAS *pArena,
   IN     UINT32 Lba,
   IN     UINT32 OldMap,
-  IN     UINT32 NewMap
+  IN     UINT32 NewMap,
+  IN     UINT32 Lane
   );
 
 /**
@@ -95,6 +100,34 @@ BttBuildRtt(
   IN OUT ARENAS *pArena
   );
 
+/**
+    Creates the map locks of an arena
+
+    There is one lock for each free block (NFree), map cache lines share them
+
+    @retval EFI_SUCCESS if the routine succeeds
+
+    @param [in] pBtt namespace handle
+    @param [in,out] pArena Pointer to the Arena with map locks to be created
+**/
+STATIC
+EFI_STATUS
+BttBuildMapLocks(
+  IN     BTT *pBtt,
+  IN OUT ARENAS *pArena
+  );
+
+/**
+    Deletes the map locks of an arena
+
+    @param [in,out] pArena Pointer to the Arena with map locks to be deleted
+**/
+STATIC
+VOID
+BttFreeMapLocks(
+  IN OUT ARENAS *pArena
+  );
+
 /**
     Loads up an arena and build run-time state
 
@@ -192,21 +225,6 @@ BttLbaToArenaLba(
      OUT UINT32 *PreMapLba
   );
 
-/**
-  Performs a consistency check on an arena
-
-  @retval EFI_SUCCESS if the routine succeeds
-
-  @param [in] pBtt namespace handle
-  @param [in] pArena Pointer to the Arena to be checked
-**/
-STATIC
-EFI_STATUS
-BttCheckArena(
-  IN     BTT *pBtt,
-  IN     ARENAS *pArena
-  );
-
 /**
     Verifies if Lba is invalid
 
@@ -257,6 +275,14 @@ BttInit(
   pBtt->RawSize = RawSize;
   pBtt->LbaSize = LbaSize;
   pBtt->pNamespace = pNamespace;
+#ifdef OS_BUILD
+  pBtt->pLaneLock = os_mutex_init(NULL);
+  if (pBtt->pLaneLock == NULL) {
+    NVDIMM_DBG("Lane lock creation failed");
+    BttRelease(pBtt);
+    return NULL;
+  }
+#endif
 
   if ((((NAMESPACE *) pNamespace)->Major == NSINDEX_MAJOR) &&
       (((NAMESPACE *) pNamespace)->Minor == NSINDEX_MINOR_1)) {
@@ -559,7 +585,8 @@ BttFlogUpdate(
   IN     ARENAS *pArena,
   IN     UINT32 Lba,
   IN     UINT32 OldMap,
-  IN     UINT32 NewMap
+  IN     UINT32 NewMap,
+  IN     UINT32 Lane
   )
 {
   BTT_FLOG * pCurrentFlog = NULL;
@@ -569,22 +596,22 @@ BttFlogUpdate(
   UINT64 NextFlogOffset = 0;
 
   NVDIMM_DBG("pBttp=%p pArena=%p ", pBtt, pArena);
-  NVDIMM_DBG("LBA=%x OldMap=%d NewMap=%d", Lba, OldMap, NewMap);
+  NVDIMM_DBG("LBA=%x OldMap=%d NewMap=%d Lane=%d", Lba, OldMap, NewMap, Lane);
 
-  if(!pBtt || !pArena) {
+  if(!pBtt || !pArena || Lane >= pBtt->NFree) {
     return EFI_INVALID_PARAMETER;
   }
 
-  pFlogPair = &(pArena->pFlogs[FLOG_PAIR_0].FlogPair);
-  pNextFlog = &(pFlogPair->Flog[pArena->pFlogs[FLOG_PAIR_0].Next]);
-  if (FLOG_0 == pArena->pFlogs[FLOG_PAIR_0].Next) {
+  pFlogPair = &(pArena->pFlogs[Lane].FlogPair);
+  pNextFlog = &(pFlogPair->Flog[pArena->pFlogs[Lane].Next]);
+  if (FLOG_0 == pArena->pFlogs[Lane].Next) {
     pCurrentFlog = &(pFlogPair->Flog[FLOG_1]);
   }
-  else if (FLOG_1 == pArena->pFlogs[FLOG_PAIR_0].Next) {
+  else if (FLOG_1 == pArena->pFlogs[Lane].Next) {
     pCurrentFlog = &(pFlogPair->Flog[FLOG_0]);
   }
   else {
-    NVDIMM_ERR("ERROR: Invalid FLOG[0].Next index value:%d\n", pArena->pFlogs[0].Next);
+    NVDIMM_ERR("ERROR: Invalid FLOG[%d].Next index value:%d\n", Lane, pArena->pFlogs[Lane].Next);
     return EFI_BAD_BUFFER_SIZE;
   }
 
@@ -598,7 +625,7 @@ BttFlogUpdate(
 
   // Write out the pNextFlog entry to the dimm
 
-  NextFlogOffset = pArena->pFlogs[0].Entry + pArena->pFlogs[0].Next*sizeof(BTT_FLOG);
+  NextFlogOffset = pArena->pFlogs[Lane].Entry + pArena->pFlogs[Lane].Next*sizeof(BTT_FLOG);
 
   // write out first two fields first
   CHECK_RESULT(WriteNamespaceBytes(pBtt->pNamespace,
@@ -611,9 +638,9 @@ BttFlogUpdate(
     NextFlogOffset, &(pNextFlog->NewMap), sizeof(UINT32) * 2), Finish);
 
   // Flog Entry written successfully, update run-time state
-  pArena->pFlogs[0].Next = 1 - pArena->pFlogs[0].Next;
+  pArena->pFlogs[Lane].Next = 1 - pArena->pFlogs[Lane].Next;
 
-  NVDIMM_VERB("update Flog[0]: Lba=%d old=%d%s%s new %d%s%s", Lba,
+  NVDIMM_VERB("update Flog[%d]: Lba=%d old=%d%s%s new %d%s%s", Lane, Lba,
     OldMap & BTT_MAP_ENTRY_LBA_MASK,(OldMap & BTT_MAP_ENTRY_ERROR) ? " ERROR" : "",
      (OldMap & BTT_MAP_ENTRY_ZERO) ? " ZERO" : "", NewMap & BTT_MAP_ENTRY_LBA_MASK,
      (NewMap & BTT_MAP_ENTRY_ERROR) ? " ERROR" : "",(NewMap & BTT_MAP_ENTRY_ZERO) ? " ZERO" : "");
@@ -696,6 +723,62 @@ BttBuildRtt(
   return EFI_SUCCESS;
 }
 
+STATIC
+EFI_STATUS
+BttBuildMapLocks(
+  IN     BTT *pBtt,
+  IN OUT ARENAS *pArena
+  )
+{
+#ifdef OS_BUILD
+  UINT32 Index = 0;
+
+  if(!pBtt || !pArena) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  pArena->ppMapLocks = AllocateZeroPool(pBtt->NFree * sizeof(VOID *));
+  if(!pArena->ppMapLocks) {
+    NVDIMM_DBG("Memory allocation for %d map locks failed", pBtt->NFree);
+    return EFI_OUT_OF_RESOURCES;
+  }
+  pArena->NMapLocks = pBtt->NFree;
+
+  for(Index = 0; Index < pArena->NMapLocks; Index++) {
+    pArena->ppMapLocks[Index] = os_mutex_init(NULL);
+    if(!pArena->ppMapLocks[Index]) {
+      NVDIMM_DBG("Map lock %d creation failed", Index);
+      return EFI_OUT_OF_RESOURCES;
+    }
+  }
+#endif
+  return EFI_SUCCESS;
+}
+
+STATIC
+VOID
+BttFreeMapLocks(
+  IN OUT ARENAS *pArena
+  )
+{
+#ifdef OS_BUILD
+  UINT32 Index = 0;
+
+  if(!pArena || !pArena->ppMapLocks) {
+    return;
+  }
+
+  for(Index = 0; Index < pArena->NMapLocks; Index++) {
+    if(pArena->ppMapLocks[Index]) {
+      os_mutex_delete(pArena->ppMapLocks[Index], NULL);
+    }
+  }
+  FreePool(pArena->ppMapLocks);
+  pArena->ppMapLocks = NULL;
+  pArena->NMapLocks = 0;
+#endif
+}
+
 STATIC
 EFI_STATUS
 BttReadArena(
@@ -740,6 +823,7 @@ BttReadArena(
 
   CHECK_RESULT(BttReadFlogs(pBtt, pArena), Finish);
   CHECK_RESULT(BttBuildRtt(pBtt, pArena), Finish);
+  CHECK_RESULT(BttBuildMapLocks(pBtt, pArena), Finish);
 
 Finish:
   FREE_POOL_SAFE(pBttInfo);
@@ -789,6 +873,19 @@ BttReadArenas(
     pArena++;
   }
 
+  /* one lane per Flog entry, each lane owns its Flog and Rtt slot in every arena */
+  if (pBtt->pLaneInUse != NULL) {
+    FreePool((VOID *)pBtt->pLaneInUse);
+  }
+  pBtt->pLaneInUse = AllocateZeroPool(pBtt->NFree * sizeof(BOOLEAN));
+  if (pBtt->pLaneInUse == NULL) {
+    NVDIMM_DBG("Memory allocation for %d lanes failed", pBtt->NFree);
+    ErrorValue = EFI_OUT_OF_RESOURCES;
+    goto RetVal;
+  }
+  pBtt->NLanes = pBtt->NFree;
+  pBtt->NextLane = 0;
+
   pBtt->Laidout = TRUE;
   return EFI_SUCCESS;
 
@@ -804,6 +901,7 @@ RetVal:
         FreePool((void *)pBtt->Arenas[Index].pRtt);
         pBtt->Arenas[Index].pRtt = NULL;
       }
+      BttFreeMapLocks(&pBtt->Arenas[Index]);
     }
     FreePool(pBtt->Arenas);
     pBtt->Arenas = NULL;
@@ -1268,74 +1366,116 @@ BttLbaToArenaLba(
   return EFI_SUCCESS;
 }
 
+EFI_STATUS
+BttAcquireLane(
+  IN     BTT *pBtt,
+     OUT UINT32 *pLane
+  )
+{
+  EFI_STATUS ReturnCode = EFI_NOT_READY;
+  UINT32 Index = 0;
+  UINT32 Lane = 0;
+
+  if (pBtt == NULL || pLane == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  /* before the layout is written there is no Flog, any lane number will do */
+  if (pBtt->NLanes == 0 || pBtt->pLaneInUse == NULL) {
+    *pLane = 0;
+    return EFI_SUCCESS;
+  }
+
+  for (;;) {
+#ifdef OS_BUILD
+    os_mutex_lock(pBtt->pLaneLock);
+#endif
+    for (Index = 0; Index < pBtt->NLanes; Index++) {
+      Lane = (pBtt->NextLane + Index) % pBtt->NLanes;
+      if (!pBtt->pLaneInUse[Lane]) {
+        pBtt->pLaneInUse[Lane] = TRUE;
+        pBtt->NextLane = (Lane + 1) % pBtt->NLanes;
+        *pLane = Lane;
+        ReturnCode = EFI_SUCCESS;
+        break;
+      }
+    }
+#ifdef OS_BUILD
+    os_mutex_unlock(pBtt->pLaneLock);
+    if (!EFI_ERROR(ReturnCode)) {
+      break;
+    }
+    /* every lane is busy, wait for a thread to release one */
+    os_sleep(0);
+#else
+    /*
+      The UEFI driver runs on one CPU, a busy lane is held by the I/O this
+      call interrupted and is not released while waiting here
+    */
+    if (EFI_ERROR(ReturnCode)) {
+      NVDIMM_DBG("All %d lanes are in use", pBtt->NLanes);
+    }
+    break;
+#endif
+  }
+  return ReturnCode;
+}
+
+VOID
+BttReleaseLane(
+  IN     BTT *pBtt,
+  IN     UINT32 Lane
+  )
+{
+  if (pBtt == NULL || pBtt->pLaneInUse == NULL || Lane >= pBtt->NLanes) {
+    return;
+  }
+
+#ifdef OS_BUILD
+  os_mutex_lock(pBtt->pLaneLock);
+#endif
+  pBtt->pLaneInUse[Lane] = FALSE;
+#ifdef OS_BUILD
+  os_mutex_unlock(pBtt->pLaneLock);
+#endif
+}
+
 /**
-  Read a block from a btt namespace
+  Reads a block whose map entry has already been fetched
+
+  Records the post-map LBA in the lane's Rtt slot, re-reads the map entry to
+  make sure the block was not reallocated in the meantime and then reads the
+  data block.
 
   @param [in] pBtt namespace handle
-  @param [in] Lba Logical block address to be read
+  @param [in] pArena Arena the block lives in
+  @param [in] Lane Lane owning the Rtt slot used by the read
+  @param [in] PreMapLba Arena-internal LBA of the block
+  @param [in] CurrentMap Map entry of the block
   @param [out] pBuffer Read result Buffer pointer
 
   @retval EFI_SUCCESS if the routine succeeds
 **/
+STATIC
 EFI_STATUS
-BttRead(
+BttReadMappedBlock(
   IN     BTT *pBtt,
-  IN     UINT64 Lba,
+  IN     ARENAS *pArena,
+  IN     UINT32 Lane,
+  IN     UINT32 PreMapLba,
+  IN     UINT32 CurrentMap,
      OUT VOID *pBuffer
   )
 {
-  ARENAS *pArena = NULL;
-  UINT32 PreMapLba = 0;
   UINT64 MapEntryOffset = 0;
-  BTT_MAP_ENTRIES Entry;
-  UINT8 PosInPreMapLba = 0;
-  UINT32 CurrentMap = 0;
   INT8 MapCheck = 0;
-  BTT_MAP_ENTRIES LatestEntry;
   UINT32 LatestMap = 0;
   UINT64 DataBlockOffset = 0;
   UINT32 LbaOut = 0;
   EFI_STATUS RetVal = EFI_SUCCESS;
 
-  SetMem(&Entry, sizeof(Entry), 0x0);
-  SetMem(&LatestEntry, sizeof(LatestEntry), 0x0);
-
-  NVDIMM_VERB("pBtt=%p LBA=%x reading!", pBtt, Lba);
-
-  if(!pBtt || !pBuffer) {
-    return EFI_INVALID_PARAMETER;
-  }
-
-  EFI_STATUS Result = IsLbaValid(pBtt, Lba);
-  if(EFI_ERROR(Result)) {
-    return Result;
-  }
-
-  /* if there's no layout written yet, all reads come back as zeros */
-  if(!pBtt->Laidout) {
-    return BttZeroBlock(pBtt, pBuffer);
-  }
-
-  /* find which arena LBA lives in, and the offset to the map Entry */
-  Result = BttLbaToArenaLba(pBtt, Lba, &pArena, &PreMapLba);
-  if(EFI_ERROR(Result))
-    return Result;
-
-  /* convert pre-map LBA into an offset into the map */
-  MapEntryOffset = pArena->MapOffset + sizeof(BTT_MAP_ENTRIES) * BttGetMapFromLba(PreMapLba);
+  MapEntryOffset = pArena->MapOffset + (UINT64)PreMapLba * BTT_MAP_ENTRY_SIZE;
 
-  /*
-    Read the current map Entry to get the post-map LBA for the data
-    block read.
-  */
-
-  Result = ReadNamespaceBytes
-     (pBtt->pNamespace, MapEntryOffset, &Entry, sizeof(BTT_MAP_ENTRIES));
-  if(EFI_ERROR(Result)) {
-    return Result;
-  }
-  PosInPreMapLba = BttGetPositionInMapFromLba(PreMapLba);
-  CurrentMap = Entry.MapEntryLba[PosInPreMapLba];
   /*
     Retries come back to the top of this loop(for a rare case where
     the map is changed by another thread doing writes to the same LBA).
@@ -1343,11 +1483,13 @@ BttRead(
   while(MapCheck == 0) {
     if(MapEntryIsError(CurrentMap)) {
       NVDIMM_DBG("EIO due to map Entry Error flag");
-      return EFI_ABORTED;
+      RetVal = EFI_ABORTED;
+      goto Finish;
     }
 
     if(MapEntryIsZero(CurrentMap)) {
-      return BttZeroBlock(pBtt, pBuffer);
+      RetVal = BttZeroBlock(pBtt, pBuffer);
+      goto Finish;
     }
 
     /*
@@ -1358,7 +1500,7 @@ BttRead(
        No need to mask off ERROR and ZERO bits since the above
        checks make sure they are clear at this point.
     */
-    pArena->pRtt[0] = CurrentMap;
+    pArena->pRtt[Lane] = CurrentMap;
 
     /*
        In case this thread was preempted between reading Entry and
@@ -1368,14 +1510,11 @@ BttRead(
        undisturbed) and potentially allocated and being used for
        another write(data disturbed, so not okay to continue).
     */
-    Result = ReadNamespaceBytes
-       (pBtt->pNamespace,
-      MapEntryOffset, &LatestEntry, sizeof(BTT_MAP_ENTRIES));
-    if(EFI_ERROR(Result)) {
-      pArena->pRtt[0] = BTT_MAP_ENTRY_ERROR;
-      return Result;
+    RetVal = ReadNamespaceBytes
+       (pBtt->pNamespace, MapEntryOffset, &LatestMap, sizeof(LatestMap));
+    if(EFI_ERROR(RetVal)) {
+      goto Finish;
     }
-    LatestMap = LatestEntry.MapEntryLba [PosInPreMapLba];
     if(CurrentMap == LatestMap) {
       MapCheck++;          /* map stayed the same */
     }
@@ -1401,26 +1540,137 @@ BttRead(
   }
 
   DataBlockOffset = pArena->DataOffset + (UINT64)(LbaOut) * pArena->InternalLbaSize;
-  NVDIMM_DBG("LBA=%x->LBAbtt=%x, Offset[B]=%lx",
-      Lba, (UINT64) LbaOut, DataBlockOffset);
+  NVDIMM_DBG("PreMapLBA=%x->LBAbtt=%x, Offset[B]=%lx",
+      PreMapLba, (UINT64) LbaOut, DataBlockOffset);
 
   RetVal = ReadNamespaceBytes
      (pBtt->pNamespace, DataBlockOffset, pBuffer, pBtt->LbaSize);
 
-  /* done with read, so clear out Rtt Entry */
-  pArena->pRtt[0] = BTT_MAP_ENTRY_ERROR;
+Finish:
+  /*
+     Done with read, so clear out Rtt Entry. A retry may have set it before
+     finding the new map entry in error or zeroed, so clear it on every path.
+  */
+  pArena->pRtt[Lane] = BTT_MAP_ENTRY_ERROR;
 
   return RetVal;
 }
 
+/**
+  Read a block from a btt namespace
+
+  @param [in] pBtt namespace handle
+  @param [in] Lba Logical block address to be read
+  @param [out] pBuffer Read result Buffer pointer
+
+  @retval EFI_SUCCESS if the routine succeeds
+**/
+EFI_STATUS
+BttRead(
+  IN     BTT *pBtt,
+  IN     UINT64 Lba,
+     OUT VOID *pBuffer
+  )
+{
+  return BttReadBlocks(pBtt, Lba, 1, pBuffer);
+}
+
+/**
+  Read a number of consecutive blocks from a btt namespace
+
+  @param [in] pBtt namespace handle
+  @param [in] Lba First logical block address to be read
+  @param [in] NumBlocks Number of blocks to be read
+  @param [out] pBuffer Read result Buffer pointer, NumBlocks * LbaSize bytes
+
+  @retval EFI_SUCCESS if the routine succeeds
+**/
+EFI_STATUS
+BttReadBlocks(
+  IN     BTT *pBtt,
+  IN     UINT64 Lba,
+  IN     UINT64 NumBlocks,
+     OUT VOID *pBuffer
+  )
+{
+  ARENAS *pArena = NULL;
+  UINT32 PreMapLba = 0;
+  UINT32 *pMapChunk = NULL;
+  UINT32 ChunkEntries = 0;
+  UINT32 Index = 0;
+  UINT32 Lane = 0;
+  UINT64 BlockIndex = 0;
+  UINT8 *pByteBuffer = pBuffer;
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+
+  NVDIMM_VERB("pBtt=%p LBA=%x NumBlocks=%lld reading!", pBtt, Lba, NumBlocks);
+
+  if(!pBtt || !pBuffer) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (NumBlocks == 0) {
+    return EFI_SUCCESS;
+  }
+
+  ReturnCode = IsLbaValid(pBtt, Lba + NumBlocks - 1);
+  if(EFI_ERROR(ReturnCode)) {
+    return ReturnCode;
+  }
+
+  /* if there's no layout written yet, all reads come back as zeros */
+  if(!pBtt->Laidout) {
+    for (BlockIndex = 0; BlockIndex < NumBlocks; BlockIndex++) {
+      ReturnCode = BttZeroBlock(pBtt, pByteBuffer + BlockIndex * pBtt->LbaSize);
+      if (EFI_ERROR(ReturnCode)) {
+        break;
+      }
+    }
+    return ReturnCode;
+  }
+
+  pMapChunk = AllocatePool(BTT_MAP_READ_CHUNK_ENTRIES * BTT_MAP_ENTRY_SIZE);
+  if (pMapChunk == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+
+  CHECK_RESULT(BttAcquireLane(pBtt, &Lane), Finish);
+
+  while (BlockIndex < NumBlocks) {
+    /* find which arena LBA lives in, and the offset to the map Entry */
+    CHECK_RESULT(BttLbaToArenaLba(pBtt, Lba + BlockIndex, &pArena, &PreMapLba), FinishLane);
+
+    /*
+      Fetch the map entries of as many of the remaining blocks as fit in
+      the chunk and stay within this arena with a single read.
+    */
+    ChunkEntries = (UINT32)MIN(NumBlocks - BlockIndex, BTT_MAP_READ_CHUNK_ENTRIES);
+    ChunkEntries = MIN(ChunkEntries, pArena->ExternalNLbas - PreMapLba);
+
+    CHECK_RESULT(ReadNamespaceBytes(pBtt->pNamespace,
+        pArena->MapOffset + (UINT64)PreMapLba * BTT_MAP_ENTRY_SIZE,
+        pMapChunk, ChunkEntries * BTT_MAP_ENTRY_SIZE), FinishLane);
+
+    for (Index = 0; Index < ChunkEntries; Index++, BlockIndex++) {
+      CHECK_RESULT(BttReadMappedBlock(pBtt, pArena, Lane, PreMapLba + Index, pMapChunk[Index],
+          pByteBuffer + BlockIndex * pBtt->LbaSize), FinishLane);
+    }
+  }
+
+FinishLane:
+  BttReleaseLane(pBtt, Lane);
+Finish:
+  FREE_POOL_SAFE(pMapChunk);
+  return ReturnCode;
+}
+
 EFI_STATUS
 BttCheck(
   IN     BTT *pBtt
   )
 {
   EFI_STATUS retVal = EFI_SUCCESS;
-  ARENAS *pArena = NULL;
-  UINT8 Index = 0;
+  UINT32 Index = 0;
 
   NVDIMM_DBG("Btt %p", pBtt);
 
@@ -1435,10 +1685,9 @@ BttCheck(
   }
 
   // for each arena
-  pArena = pBtt->Arenas;
   for(Index = 0; Index < pBtt->NArenas; Index++) {
     // Perform the consistency checks for the arena.
-    retVal = BttCheckArena(pBtt, pArena);
+    retVal = BttCheckArena(pBtt, &pBtt->Arenas[Index]);
     if(EFI_ERROR(retVal)) {
       return retVal;
     }
@@ -1447,7 +1696,6 @@ BttCheck(
   return retVal;
 }
 
-STATIC
 EFI_STATUS
 BttCheckArena(
   IN     BTT *pBtt,
@@ -1458,14 +1706,11 @@ BttCheckArena(
   UINT32 Bitmapsize = 0;
   UINT8 *pBitmap = NULL;
   UINT32 MapEntry = 0;
-  UINT32 RemainingMaps = 0;
-  UINT32 MapsCount = 0;
-  UINT8 MapEndPosition = 0;
-  BTT_MAP_ENTRIES *pMap = NULL;
-  UINT64 MapSize = 0;
-  UINT32 MapBlock = 0;
+  UINT32 *pMapChunk = NULL;
+  UINT32 ChunkStart = 0;
+  UINT32 ChunkEntries = 0;
+  UINT32 PreMapLba = 0;
   UINT32 Index = 0;
-  UINT8 Position = 0;
   UINT8 CurrentFlogIndex = 0;
   UINT32 Entry = 0;
 
@@ -1475,8 +1720,8 @@ BttCheckArena(
     goto Finish;
   }
 
-  pMap = (BTT_MAP_ENTRIES *) AllocateZeroPool(BTT_ALIGNMENT);
-  if (pMap == NULL) {
+  pMapChunk = AllocatePool(BTT_MAP_CHECK_CHUNK_ENTRIES * BTT_MAP_ENTRY_SIZE);
+  if (pMapChunk == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
   }
@@ -1493,61 +1738,46 @@ BttCheckArena(
   /**
     Go through every post-map LBA mentioned in the map and make sure
     there are no duplicates.  Bitmap is used to track which LBAs have
-    been seen so far.
+    been seen so far. The map is a flat array of ExternalNLbas entries,
+    so it is streamed front to back in large chunks.
   **/
-  MapsCount = BttGetMapFromLba(pArena->ExternalNLbas);
-  MapEndPosition = BttGetPositionInMapFromLba(pArena->ExternalNLbas);
-  MapSize = ROUNDUP(pArena->ExternalNLbas * BTT_MAP_ENTRY_SIZE, BTT_ALIGNMENT);
-  // Read entire map layout in 4k blocks
-  for(MapBlock = 0; MapBlock <= MapSize / BTT_ALIGNMENT; MapBlock++) {
-    ReturnCode = ReadNamespaceBytes
-       (pBtt->pNamespace, pArena->MapOffset +(MapBlock * BTT_ALIGNMENT), pMap, BTT_ALIGNMENT);
+  for (ChunkStart = 0; ChunkStart < pArena->ExternalNLbas; ChunkStart += ChunkEntries) {
+    ChunkEntries = MIN(pArena->ExternalNLbas - ChunkStart, BTT_MAP_CHECK_CHUNK_ENTRIES);
+    ReturnCode = ReadNamespaceBytes(pBtt->pNamespace,
+        pArena->MapOffset + (UINT64) ChunkStart * BTT_MAP_ENTRY_SIZE, pMapChunk, ChunkEntries * BTT_MAP_ENTRY_SIZE);
     if(EFI_ERROR(ReturnCode)) {
       goto Finish;
     }
-    if(MapsCount > MapBlock * BTT_ALIGNMENT / sizeof(BTT_MAP_ENTRIES)) { //protect overturn
-      RemainingMaps = MapsCount - MapBlock * BTT_ALIGNMENT / sizeof(BTT_MAP_ENTRIES);
-    }
-    else {
-      break;
-    }
-    for (Index = 0; Index < BTT_ALIGNMENT / sizeof(BTT_MAP_ENTRIES); Index++) {
-      if(Index > RemainingMaps) {   //last BTT_MAP_ENTRIES within this MapBlock
-        break;
-      }
-      for (Position = 0; Position < BTT_MAP_LOCK_ALIGN / BTT_MAP_ENTRY_SIZE; Position++) {
-        //End the loop for the last Lba
-        if(Index == RemainingMaps && Position == MapEndPosition) {
-          break;
-        }
-        MapEntry = pMap [Index].MapEntryLba [Position];
 
-        /* for debug, dump zero map Entries */
-        if((MapEntry & BTT_MAP_ENTRY_ZERO) == 0) {
-          NVDIMM_VERB("map[%d]: %d%s%s", Index, MapEntry & BTT_MAP_ENTRY_LBA_MASK,
-             (MapEntry & BTT_MAP_ENTRY_ERROR) ? " ERROR" : "",(MapEntry & BTT_MAP_ENTRY_ZERO) ? " ZERO" : "");
-        }
+    for (Index = 0; Index < ChunkEntries; Index++) {
+      PreMapLba = ChunkStart + Index;
+      MapEntry = pMapChunk[Index];
 
-        if (MapEntryIsInitial(MapEntry)) {
-          MapEntry = MapBlock * (BTT_ALIGNMENT / BTT_MAP_ENTRY_SIZE) + Index *
-              (sizeof(BTT_MAP_ENTRIES) / BTT_MAP_ENTRY_SIZE) + Position;
-        } else {
-          MapEntry &= BTT_MAP_ENTRY_LBA_MASK;
-        }
+      /* for debug, dump zero map Entries */
+      if((MapEntry & BTT_MAP_ENTRY_ZERO) == 0) {
+        NVDIMM_VERB("map[%d]: %d%s%s", PreMapLba, MapEntry & BTT_MAP_ENTRY_LBA_MASK,
+           (MapEntry & BTT_MAP_ENTRY_ERROR) ? " ERROR" : "",(MapEntry & BTT_MAP_ENTRY_ZERO) ? " ZERO" : "");
+      }
 
-        /* check if entry is valid */
-        if(MapEntry >= pArena->ExternalNLbas) {
-          NVDIMM_DBG("map[%d] Entry out of bounds: %d", Index, MapEntry);
-          goto Finish;
-        }
+      if (MapEntryIsInitial(MapEntry)) {
+        MapEntry = PreMapLba;
+      } else {
+        MapEntry &= BTT_MAP_ENTRY_LBA_MASK;
+      }
 
-        if (IS_BIT_SET(pBitmap, MapEntry)) {
-          NVDIMM_DBG("map[%d] duplicate Entry: %d", Index, MapEntry);
-          ReturnCode = EFI_ABORTED;
-          goto Finish;
-        } else {
-          SET_BIT(pBitmap, MapEntry);
-        }
+      /* check if entry is valid, post-map LBAs address the whole data area */
+      if(MapEntry >= pArena->InternalNLbas) {
+        NVDIMM_DBG("map[%d] Entry out of bounds: %d", PreMapLba, MapEntry);
+        ReturnCode = EFI_ABORTED;
+        goto Finish;
+      }
+
+      if (IS_BIT_SET(pBitmap, MapEntry)) {
+        NVDIMM_DBG("map[%d] duplicate Entry: %d", PreMapLba, MapEntry);
+        ReturnCode = EFI_ABORTED;
+        goto Finish;
+      } else {
+        SET_BIT(pBitmap, MapEntry);
       }
     }
   }
@@ -1562,6 +1792,12 @@ BttCheckArena(
     Entry = pArena->pFlogs[Index].FlogPair.Flog[CurrentFlogIndex].OldMap;
     Entry &= BTT_MAP_ENTRY_LBA_MASK;
 
+    if (Entry >= pArena->InternalNLbas) {
+      NVDIMM_DBG("Flog[%d] Entry out of bounds: %d", Index, Entry);
+      ReturnCode = EFI_ABORTED;
+      goto Finish;
+    }
+
     if (IS_BIT_SET(pBitmap, Entry)) {
       NVDIMM_DBG("Flog[%d] duplicate Entry: %d", Index, Entry);
       ReturnCode = EFI_ABORTED;
@@ -1587,10 +1823,30 @@ BttCheckArena(
 
 Finish:
   FREE_POOL_SAFE(pBitmap);
-  FREE_POOL_SAFE(pMap);
+  FREE_POOL_SAFE(pMapChunk);
   return ReturnCode;
 }
 
+/**
+  Releases the map lock of the cache line holding a map entry
+
+  @param [in] pArena Pointer to the Arena of the map entry
+  @param [in] BttMapLockNum Map lock taken by BttMapLock()
+**/
+STATIC
+VOID
+BttMapLockRelease(
+  IN     ARENAS *pArena,
+  IN     UINT32 BttMapLockNum
+  )
+{
+#ifdef OS_BUILD
+  if(pArena->ppMapLocks != NULL && BttMapLockNum < pArena->NMapLocks) {
+    os_mutex_unlock(pArena->ppMapLocks[BttMapLockNum]);
+  }
+#endif
+}
+
 STATIC
 EFI_STATUS
 BttMapLock(
@@ -1614,19 +1870,25 @@ BttMapLock(
   MapEntryOffset = pArena->MapOffset + sizeof(BTT_MAP_ENTRIES) * MapNumber;
 
   /*
-    BttMapLock[] contains NFree locks which are used to protect the map
+    ppMapLocks[] contains NFree locks which are used to protect the map
     from concurrent access to the same cache line. The index into
-    BttMapLock[] is calculated by looking at the byte offset into the map
+    ppMapLocks[] is calculated by looking at the byte offset into the map
      (PreMapLba * BTT_MAP_ENTRY_SIZE), figuring out how many cache lines
     that is into the map that is(dividing by BTT_MAP_LOCK_ALIGN), and
     then selecting one of nfree locks(the modulo at the end).
   */
   BttMapLockNum = MapNumber % pBtt->NFree;
+#ifdef OS_BUILD
+  if(pArena->ppMapLocks != NULL && BttMapLockNum < pArena->NMapLocks) {
+    os_mutex_lock(pArena->ppMapLocks[BttMapLockNum]);
+  }
+#endif
 
   /* read the old map Entry */
   EFI_STATUS ReadResult = ReadNamespaceBytes
      (pBtt->pNamespace, MapEntryOffset, Entry, sizeof(BTT_MAP_ENTRIES));
   if(EFI_ERROR(ReadResult)) {
+    BttMapLockRelease(pArena, BttMapLockNum);
     return ReadResult;
   }
 
@@ -1669,24 +1931,27 @@ BttMapUnlock(
      (pBtt->pNamespace,
     MapEntryOffset, Entry, sizeof(BTT_MAP_ENTRIES));
 
- //pArena->BttMapLock [BttMapLockNum].IndSpinlockRelease(pMapLockHandle);
- NVDIMM_DBG("unlocked maps[%u], LBAs: %u - %u", BttMapLockNum, Entry->MapEntryLba [0] & BTT_MAP_ENTRY_LBA_MASK,
+  BttMapLockRelease(pArena, BttMapLockNum);
+  NVDIMM_DBG("unlocked maps[%u], LBAs: %u - %u", BttMapLockNum, Entry->MapEntryLba [0] & BTT_MAP_ENTRY_LBA_MASK,
     Entry->MapEntryLba [CACHE_LINE_SIZE / sizeof(UINT32) - 1] & BTT_MAP_ENTRY_LBA_MASK);
   return RetVal;
 }
 
 /**
-  Writes a block to a btt namespace
+  Writes a block to a btt namespace using the free block owned by the given lane
 
   @param [in] pBtt namespace handle
+  @param [in] Lane Lane owning the Flog entry used for the write
   @param [in] Lba Logical block address to be written
   @param [in] pBuffer Buffer pointer to the block to be written
 
   @retval EFI_SUCCESS if the routine succeeds
 **/
+STATIC
 EFI_STATUS
-BttWrite(
+BttWriteLane(
   IN     BTT *pBtt,
+  IN     UINT32 Lane,
   IN     UINT64 Lba,
   IN     VOID *pBuffer
   )
@@ -1743,17 +2008,21 @@ BttWrite(
      doesn't appear in the read tracking table, so scan that first
      and if found, wait for the thread reading from it to finish.
   */
-  CurrentFlogIndex = 1 - pArena->pFlogs[0].Next;
-  FreeMap = (pArena->pFlogs[0].FlogPair.Flog[CurrentFlogIndex].OldMap & BTT_MAP_ENTRY_LBA_MASK) | BTT_MAP_ENTRY_NORMAL;
+  if(Lane >= pBtt->NFree) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  CurrentFlogIndex = 1 - pArena->pFlogs[Lane].Next;
+  FreeMap = (pArena->pFlogs[Lane].FlogPair.Flog[CurrentFlogIndex].OldMap & BTT_MAP_ENTRY_LBA_MASK) | BTT_MAP_ENTRY_NORMAL;
 
-  NVDIMM_VERB("FreeMap=%x(before mask %x)", FreeMap, pArena->pFlogs[0].FlogPair.Flog[CurrentFlogIndex].OldMap);
+  NVDIMM_VERB("Lane=%d FreeMap=%x(before mask %x)", Lane, FreeMap, pArena->pFlogs[Lane].FlogPair.Flog[CurrentFlogIndex].OldMap);
 
-  /* wait for other threads to finish any reads on free block */
+  /* wait for other lanes to finish any reads on free block */
   for(Index = 0; Index < pBtt->NLanes; Index++) {
     while(pArena->pRtt[Index] == FreeMap) {
       ;
     }
-  } // to be deleted in UEFI
+  }
 
   // it is now safe to perform write to the free block
   DataBlockOffset = pArena->DataOffset + (UINT64)(FreeMap & BTT_MAP_ENTRY_LBA_MASK) * pArena->InternalLbaSize;
@@ -1775,8 +2044,9 @@ BttWrite(
   /* update the Flog */
   PosInEntry = BttGetPositionInMapFromLba(PreMapLba);
   OldMap = MapEntry.MapEntryLba[PosInEntry];
-  RetVal = BttFlogUpdate(pBtt, pArena, PreMapLba, OldMap, FreeMap);
+  RetVal = BttFlogUpdate(pBtt, pArena, PreMapLba, OldMap, FreeMap, Lane);
   if(EFI_ERROR(RetVal)) {
+    BttMapLockRelease(pArena, BttGetMapFromLba(PreMapLba) % pBtt->NFree);
     NVDIMM_DBG("Could not update the BTT Flog!\nBttp %p pArena %p PreMapLba %u", pBtt, pArena, PreMapLba);
     return RetVal;
   }
@@ -1791,6 +2061,85 @@ BttWrite(
   return EFI_SUCCESS;
 }
 
+/**
+  Writes a block to a btt namespace
+
+  @param [in] pBtt namespace handle
+  @param [in] Lba Logical block address to be written
+  @param [in] pBuffer Buffer pointer to the block to be written
+
+  @retval EFI_SUCCESS if the routine succeeds
+**/
+EFI_STATUS
+BttWrite(
+  IN     BTT *pBtt,
+  IN     UINT64 Lba,
+  IN     VOID *pBuffer
+  )
+{
+  return BttWriteBlocks(pBtt, Lba, 1, pBuffer);
+}
+
+/**
+  Writes a number of consecutive blocks to a btt namespace
+
+  @param [in] pBtt namespace handle
+  @param [in] Lba First logical block address to be written
+  @param [in] NumBlocks Number of blocks to be written
+  @param [in] pBuffer Buffer pointer to the blocks to be written, NumBlocks * LbaSize bytes
+
+  @retval EFI_SUCCESS if the routine succeeds
+**/
+EFI_STATUS
+BttWriteBlocks(
+  IN     BTT *pBtt,
+  IN     UINT64 Lba,
+  IN     UINT64 NumBlocks,
+  IN     VOID *pBuffer
+  )
+{
+  UINT32 Lane = 0;
+  UINT64 BlockIndex = 0;
+  UINT8 *pByteBuffer = pBuffer;
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+
+  if(!pBtt || !pBuffer) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  if (NumBlocks == 0) {
+    return EFI_SUCCESS;
+  }
+
+  ReturnCode = IsLbaValid(pBtt, Lba + NumBlocks - 1);
+  if(EFI_ERROR(ReturnCode)) {
+    return ReturnCode;
+  }
+
+  /* first write through here will initialize the metadata layout */
+  if(!pBtt->Laidout) {
+    ReturnCode = BttWriteLayout(pBtt, TRUE);
+    if(EFI_ERROR(ReturnCode)) {
+      return ReturnCode;
+    }
+  }
+
+  ReturnCode = BttAcquireLane(pBtt, &Lane);
+  if(EFI_ERROR(ReturnCode)) {
+    return ReturnCode;
+  }
+
+  for (BlockIndex = 0; BlockIndex < NumBlocks; BlockIndex++) {
+    ReturnCode = BttWriteLane(pBtt, Lane, Lba + BlockIndex, pByteBuffer + BlockIndex * pBtt->LbaSize);
+    if (EFI_ERROR(ReturnCode)) {
+      break;
+    }
+  }
+
+  BttReleaseLane(pBtt, Lane);
+  return ReturnCode;
+}
+
 EFI_STATUS
 BttArenaSetFlag(
   IN     BTT *pBtt,
@@ -1879,12 +2228,18 @@ BttRelease(
         if(pBtt->Arenas[Index].pRtt) {
           FreePool((UINT32 *)pBtt->Arenas[Index].pRtt);
         }
-        //if(pBtt->Arenas[Index].BttMapLock) {
-        //  FreePool(pBtt->Arenas[Index].BttMapLock);
-        //}
+        BttFreeMapLocks(&pBtt->Arenas[Index]);
       }
       FreePool(pBtt->Arenas);
     }
+    if(pBtt->pLaneInUse) {
+      FreePool((BOOLEAN *)pBtt->pLaneInUse);
+    }
+#ifdef OS_BUILD
+    if(pBtt->pLaneLock) {
+      os_mutex_delete(pBtt->pLaneLock, NULL);
+    }
+#endif
     FreePool(pBtt);
   }
 }
@@ -16,6 +16,9 @@ extern GUID gBttAbstractionGuid;
 
 #define FLOG_PAIR_0 0  //!< 0th Flog pair
 
+#define BTT_MAP_READ_CHUNK_ENTRIES 1024  //!< Number of map entries fetched with one read by multi-block reads
+#define BTT_MAP_CHECK_CHUNK_ENTRIES 65536  //!< Number of map entries fetched with one read by the consistency check
+
 #define EFI_BTT_ABSTRACTION_GUID \
   { 0x18633BFC, 0x1735, 0x4217, {0x8A, 0xC9, 0x17, 0x23, 0x92, 0x82, 0xD3, 0xF8} }
 
@@ -97,6 +100,17 @@ typedef struct _ARENAS {
         entry won't match any post-map LBA when checked.
     **/
     UINT32 volatile *pRtt;
+
+    /**
+        Map locks.
+        The write path updates a map entry by reading and writing back
+        the whole cache line holding it, so concurrent writes to LBAs
+        sharing the line take the lock of the line first.  A line uses
+        lock (line number % NMapLocks).  OS_MUTEX handles, NULL in the
+        UEFI driver.
+    **/
+    VOID **ppMapLocks;
+    UINT32 NMapLocks;       //!< Number of map locks, NFree
 } ARENAS;     //!< @see _ARENAS
 
 /**
@@ -114,10 +128,28 @@ typedef struct _BTT {
     BOOLEAN Laidout;
 
     /**
-      Number of concurrent threads allowed per btt
+      Number of concurrent threads allowed per btt. Each lane owns one Flog
+      entry and one Rtt slot in every arena, so NLanes equals NFree.
     **/
     UINT32 NLanes;
 
+    /**
+      Lane ownership table, one entry per lane. A lane is handed out by
+      BttAcquireLane() and returned by BttReleaseLane().
+    **/
+    BOOLEAN volatile *pLaneInUse;
+
+    /**
+      Lane the next lane acquisition starts searching from
+    **/
+    UINT32 NextLane;
+
+    /**
+      OS_MUTEX guarding pLaneInUse and NextLane against concurrent
+      BttAcquireLane() and BttReleaseLane() calls, NULL in the UEFI driver
+    **/
+    VOID *pLaneLock;
+
     /**
       UUID of the BTT
     **/
@@ -260,6 +292,74 @@ EFI_STATUS BttWrite (
   IN     VOID* pBuffer
   );
 
+/**
+  Read a number of consecutive blocks from a btt namespace
+
+  All blocks are read through a single lane and the map entries of blocks
+  that live in the same arena are fetched with one read per chunk.
+
+  @retval EFI_SUCCESS if the routine succeeds
+
+  @param [in] pBtt namespace handle
+  @param [in] Lba First logical block address to be read
+  @param [in] NumBlocks Number of blocks to be read
+  @param [out] pBuffer Read result Buffer pointer, NumBlocks * LbaSize bytes
+**/
+EFI_STATUS BttReadBlocks (
+  IN     BTT* pBtt,
+  IN     UINT64 Lba,
+  IN     UINT64 NumBlocks,
+     OUT VOID* pBuffer
+  );
+
+/**
+  Writes a number of consecutive blocks to a btt namespace
+
+  All blocks are written through a single lane.
+
+  @retval EFI_SUCCESS if the routine succeeds
+
+  @param [in] pBtt namespace handle
+  @param [in] Lba First logical block address to be written
+  @param [in] NumBlocks Number of blocks to be written
+  @param [in] pBuffer Buffer pointer to the blocks to be written, NumBlocks * LbaSize bytes
+**/
+EFI_STATUS BttWriteBlocks (
+  IN     BTT* pBtt,
+  IN     UINT64 Lba,
+  IN     UINT64 NumBlocks,
+  IN     VOID* pBuffer
+  );
+
+/**
+  Acquires a free lane of a btt namespace
+
+  The lane selects the Flog entry used by writes and the Rtt slot used by reads.
+  It has to be returned with BttReleaseLane() once the I/O is done. When all
+  lanes are in use the call waits for another thread to release one.
+
+  @retval EFI_SUCCESS if the routine succeeds
+  @retval EFI_NOT_READY if all lanes are in use in the UEFI driver
+
+  @param [in] pBtt namespace handle
+  @param [out] pLane Acquired lane number
+**/
+EFI_STATUS BttAcquireLane (
+  IN     BTT* pBtt,
+     OUT UINT32* pLane
+  );
+
+/**
+  Returns a lane acquired with BttAcquireLane()
+
+  @param [in] pBtt namespace handle
+  @param [in] Lane Lane number to be released
+**/
+VOID BttReleaseLane (
+  IN     BTT* pBtt,
+  IN     UINT32 Lane
+  );
+
 /**
   Deletes opaque Btt_Info, done using btt namespace
 
@@ -312,6 +412,38 @@ BttSetArenaError(
   IN OUT ARENAS *pArena
   );
 
+/**
+  Performs a consistency check on all arenas of a btt namespace
+
+  @retval EFI_SUCCESS if the routine succeeds
+  @retval EFI_ABORTED if an inconsistency was found
+
+  @param [in] pBtt namespace handle
+**/
+EFI_STATUS
+BttCheck(
+  IN     BTT *pBtt
+  );
+
+/**
+  Performs a consistency check on an arena
+
+  The map is streamed sequentially in chunks of BTT_MAP_CHECK_CHUNK_ENTRIES
+  entries. Arenas of one btt namespace share no check state, so they may be
+  checked concurrently.
+
+  @retval EFI_SUCCESS if the routine succeeds
+  @retval EFI_ABORTED if an inconsistency was found
+
+  @param [in] pBtt namespace handle
+  @param [in] pArena Pointer to the Arena to be checked
+**/
+EFI_STATUS
+BttCheckArena(
+  IN     BTT *pBtt,
+  IN     ARENAS *pArena
+  );
+
 UINT32
 BttGetMapFromLba(
   IN     UINT32 Lba
@@ -20,7 +20,8 @@ extern NVMDIMMDRIVER_DATA *gNvmDimmData;
   @param[in] pDimm Pointer to the DIMM
   @param[in] DimmCount DIMMs count
   @param[in] DimmIdPreference Preference for Dimm ID display (UID/Handle)
-  @param[in out] ppResult Pointer to the result string of platform config diagnostics message
+  @param[in out] pResult Pointer to the platform config diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the platform config diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -33,7 +34,8 @@ CheckNamespaceLabelAreaIndex(
   IN     DIMM **ppDimms,
   IN     CONST UINT16 DimmCount,
   IN     UINT8 DimmIdPreference,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
      OUT UINT8 *pDiagState
   )
 {
@@ -46,7 +48,7 @@ CheckNamespaceLabelAreaIndex(
   NVDIMM_ENTRY();
 
   if (DimmCount == 0 || ppDimms == NULL || DimmCount > MAX_DIMMS ||
-       ppResultStr == NULL || pDiagState == NULL) {
+       pResult == NULL || pDiagState == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
@@ -71,7 +73,7 @@ CheckNamespaceLabelAreaIndex(
 
     ReturnCode = ReadLabelStorageArea(ppDimms[Index]->DimmID, &pLabelStorageArea);
     if (EFI_ERROR(ReturnCode) && ReturnCode != EFI_NOT_FOUND) {
-      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_UNABLE_TO_READ_NS_INFO), EVENT_CODE_622, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState);
+      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_UNABLE_TO_READ_NS_INFO), EVENT_CODE_622, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState);
     } else {
       ReturnCode = EFI_SUCCESS;
     }
@@ -610,7 +612,8 @@ UpdateBrokenInterleaveSets(
   @param[in] pDimm Pointer to the DIMM
   @param[in] DimmCount DIMMs count
   @param[in] DimmIdPreference Preference for Dimm ID display (UID/Handle)
-  @param[in out] ppResult Pointer to the result string of platform config diagnostics message
+  @param[in out] pResult Pointer to the platform config diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the platform config diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -623,7 +626,8 @@ CheckPlatformConfigurationData(
   IN     DIMM **ppDimms,
   IN     CONST UINT16 DimmCount,
   IN     UINT8 DimmIdPreference,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
      OUT UINT8 *pDiagState
   )
 {
@@ -666,7 +670,7 @@ CheckPlatformConfigurationData(
   ZeroMem(&PcdRevision, sizeof(PcdRevision));
 
   if (DimmCount == 0 || ppDimms == NULL || DimmCount > MAX_DIMMS ||
-       ppResultStr == NULL || pDiagState == NULL) {
+       pResult == NULL || pDiagState == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
@@ -706,7 +710,7 @@ CheckPlatformConfigurationData(
     if (!EFI_ERROR(ReturnCode)) {
       if (pPcdConfHeader->CurrentConfStartOffset == 0 || pPcdConfHeader->CurrentConfDataSize == 0) {
         // Dimm not configured
-        APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_DIMM_NOT_CONFIGURED), EVENT_CODE_606, DIAG_STATE_MASK_OK, ppResultStr, pDiagState,
+        APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_DIMM_NOT_CONFIGURED), EVENT_CODE_606, DIAG_STATE_MASK_OK, pResult, SubTestIndex, pDiagState,
           DimmStr);
         FREE_POOL_SAFE(pPcdConfHeader);
         NVDIMM_WARN("There is no Current Config table");
@@ -759,7 +763,7 @@ CheckPlatformConfigurationData(
         ReturnCode = EFI_VOLUME_CORRUPTED;
       } else if (pPcdConfHeader->ConfOutputStartOffset == 0 || pPcdConfHeader->ConfOutputDataSize == 0) {
         // No Output table defined yet means the goal has not been applied yet
-        APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_NOT_APPLIED), EVENT_CODE_609, DIAG_STATE_MASK_OK, ppResultStr, pDiagState,
+        APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_NOT_APPLIED), EVENT_CODE_609, DIAG_STATE_MASK_OK, pResult, SubTestIndex, pDiagState,
           DimmStr);
       }
     }
@@ -777,13 +781,13 @@ CheckPlatformConfigurationData(
         ReturnCode = EFI_VOLUME_CORRUPTED;
       } else if (pPcdOutputConf->SequenceNumber != pPcdInputConf->SequenceNumber) {
         // The goal has not been applied yet
-        APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_NOT_APPLIED), EVENT_CODE_609, DIAG_STATE_MASK_OK, ppResultStr, pDiagState,
+        APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_NOT_APPLIED), EVENT_CODE_609, DIAG_STATE_MASK_OK, pResult, SubTestIndex, pDiagState,
           DimmStr);
       }
     }
 
     if (EFI_ERROR(ReturnCode)) {
-      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_INVALID_PCD_DATA), EVENT_CODE_621, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_INVALID_PCD_DATA), EVENT_CODE_621, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         DimmStr);
       continue;
     }
@@ -855,25 +859,25 @@ CheckPlatformConfigurationData(
       break;
     case PcdErrorFirmware:
       pDetailedStatusStr = GetCoutDetailedStatusStr(pPcdOutputConf->ValidationStatus, PartitionSizeChangeTableStatus, InterleaveInformationTableStatus_1, InterleaveInformationTableStatus_2);
-      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_FAILED_FIRMWARE), EVENT_CODE_626, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_FAILED_FIRMWARE), EVENT_CODE_626, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         DimmStr, pDetailedStatusStr);
       FREE_POOL_SAFE(pDetailedStatusStr);
       break;
     case PcdErrorGoalData:
       pDetailedStatusStr = GetCoutDetailedStatusStr(pPcdOutputConf->ValidationStatus, PartitionSizeChangeTableStatus, InterleaveInformationTableStatus_1, InterleaveInformationTableStatus_2);
-      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_FAILED_DATA), EVENT_CODE_624, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_FAILED_DATA), EVENT_CODE_624, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         DimmStr, pDetailedStatusStr);
       FREE_POOL_SAFE(pDetailedStatusStr);
       break;
     case PcdErrorCurConfig:
       pDetailedStatusStr = GetCCurDetailedStatusStr(pPcdCurrentConf->ConfigStatus);
-      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CURRENT_CONFIG_FAILED_DATA), EVENT_CODE_633, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CURRENT_CONFIG_FAILED_DATA), EVENT_CODE_633, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         DimmStr, pDetailedStatusStr);
       FREE_POOL_SAFE(pDetailedStatusStr);
       break;
     case PcdErrorInsufficientResources:
       pDetailedStatusStr = GetCoutDetailedStatusStr(pPcdOutputConf->ValidationStatus, PartitionSizeChangeTableStatus, InterleaveInformationTableStatus_1, InterleaveInformationTableStatus_2);
-      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_FAILED_INSUFFICIENT_RESOURCES), EVENT_CODE_625, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_FAILED_INSUFFICIENT_RESOURCES), EVENT_CODE_625, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         DimmStr, pDetailedStatusStr);
       FREE_POOL_SAFE(pDetailedStatusStr);
       break;
@@ -896,7 +900,7 @@ CheckPlatformConfigurationData(
     case PcdErrorUnknown:
     default:
       pDetailedStatusStr = GetCoutDetailedStatusStr(pPcdOutputConf->ValidationStatus, PartitionSizeChangeTableStatus, InterleaveInformationTableStatus_1, InterleaveInformationTableStatus_2);
-      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_FAILED_UNKNOWN), EVENT_CODE_627, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_GOAL_FAILED_UNKNOWN), EVENT_CODE_627, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         DimmStr, pDetailedStatusStr);
       FREE_POOL_SAFE(pDetailedStatusStr);
       break;
@@ -919,19 +923,19 @@ CheckPlatformConfigurationData(
 
         if (PcdErrorType == PcdErrorMissingDimm) {
           if (IS_ACPI_REV_MAJ_1_MIN_VALID(PcdRevision)) {
-            APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_IS_BROKEN_DIMMS_MISSING_LOCATION), EVENT_CODE_631, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+            APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_IS_BROKEN_DIMMS_MISSING_LOCATION), EVENT_CODE_631, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
               pBrokenISs[Index].InterleaveSetIndex, pTmpDimmIdStr, pBrokenISs[Index].MisplacedDimmLocations[Index2].Split.SocketId,
               pBrokenISs[Index].MisplacedDimmLocations[Index2].Split.DieId, pBrokenISs[Index].MisplacedDimmLocations[Index2].Split.MemControllerId,
               pBrokenISs[Index].MisplacedDimmLocations[Index2].Split.ChannelId, pBrokenISs[Index].MisplacedDimmLocations[Index2].Split.SlotId);
           }
           else {
-            APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_IS_BROKEN_DIMMS_MISSING), EVENT_CODE_628, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+            APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_IS_BROKEN_DIMMS_MISSING), EVENT_CODE_628, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
               pBrokenISs[Index].InterleaveSetIndex, pTmpDimmIdStr);
           }
         }
 
         if (PcdErrorType == PcdErrorDimmLocationIssue && (IS_ACPI_REV_MAJ_1_MIN_VALID(PcdRevision))) {
-          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_IS_BROKEN_DIMMS_MISPLACED_LOCATION), EVENT_CODE_632, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_IS_BROKEN_DIMMS_MISPLACED_LOCATION), EVENT_CODE_632, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
             pBrokenISs[Index].InterleaveSetIndex, pTmpDimmIdStr, pBrokenISs[Index].CurrentDimmLocations[Index2].Split.SocketId,
             pBrokenISs[Index].CurrentDimmLocations[Index2].Split.DieId, pBrokenISs[Index].CurrentDimmLocations[Index2].Split.MemControllerId,
             pBrokenISs[Index].CurrentDimmLocations[Index2].Split.ChannelId, pBrokenISs[Index].CurrentDimmLocations[Index2].Split.SlotId,
@@ -954,7 +958,9 @@ Finish:
 /**
   Check for uninitialized dimms in the system
 
-  @param[in out] ppResult Pointer to the result string of platform config diagnostics message
+  @param[in out] pResult Pointer to the platform config diagnostics results
+
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the platform config diagnostics test state
   @param  DimmIdPreference Dimm id preference value
 
@@ -965,7 +971,8 @@ Finish:
 STATIC
 EFI_STATUS
 CheckUninitializedDimms(
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
      OUT UINT8 *pDiagState,
   IN     UINT8 DimmIdPreference
   )
@@ -978,7 +985,7 @@ CheckUninitializedDimms(
 
   NVDIMM_ENTRY();
 
-  if (ppResultStr == NULL || pDiagState == NULL) {
+  if (pResult == NULL || pDiagState == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
@@ -1004,7 +1011,7 @@ CheckUninitializedDimms(
       NVDIMM_DBG("GetPreferredValueAsString function for DIMM ID 0x%x failed.", pCurDimm->DeviceHandle.AsUint32);
       continue;
     }
-    APPEND_RESULT_TO_THE_LOG(pCurDimm, STRING_TOKEN(STR_CONFIG_DIMM_FAILED_TO_INITIALIZE), EVENT_CODE_618, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pCurDimm, STRING_TOKEN(STR_CONFIG_DIMM_FAILED_TO_INITIALIZE), EVENT_CODE_618, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
       DimmStr);
   }
 
@@ -1019,7 +1026,8 @@ Finish:
   @param[in] pDimm Pointer to the DIMM
   @param[in] DimmCount DIMMs count
   @param[in] DimmIdPreference Preference for Dimm ID display (UID/Handle)
-  @param[in out] ppResult Pointer to the result string of platform config diagnostics message
+  @param[in out] pResult Pointer to the platform config diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the platform config diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -1032,7 +1040,8 @@ CheckSystemSupportedCapabilities(
   IN     DIMM **ppDimms,
   IN     CONST UINT16 DimmCount,
   IN     UINT8 DimmIdPreference,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
      OUT UINT8 *pDiagState
   )
 {
@@ -1042,7 +1051,7 @@ CheckSystemSupportedCapabilities(
   NVDIMM_ENTRY();
 
   if (DimmCount == 0 || ppDimms == NULL || DimmCount > MAX_DIMMS ||
-       ppResultStr == NULL || pDiagState == NULL) {
+       pResult == NULL || pDiagState == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
@@ -1056,7 +1065,7 @@ CheckSystemSupportedCapabilities(
     *pDiagState |= DIAG_STATE_MASK_ABORTED;
     goto Finish;
   } else if (!ConfigChangeSupported) {
-    APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_NO_OS_PROVISIONING), EVENT_CODE_623, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState);
+    APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_NO_OS_PROVISIONING), EVENT_CODE_623, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState);
     goto Finish;
   }
 
@@ -1072,7 +1081,8 @@ Finish:
 
   @param[in] pDimm Pointer to the DIMM
   @param[in] DimmCount DIMMs count
-  @param[in out] ppResult Pointer to the result string of platform config diagnostics message
+  @param[in out] pResult Pointer to the platform config diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the platform config diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -1084,7 +1094,8 @@ EFI_STATUS
 CheckDimmUIDDuplication(
   IN     DIMM **ppDimms,
   IN     CONST UINT16 DimmCount,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
      OUT UINT8 *pDiagState
   )
 {
@@ -1106,7 +1117,7 @@ CheckDimmUIDDuplication(
   ZeroMem(TestDimmUID, sizeof(TestDimmUID));
 
   if (DimmCount == 0 || ppDimms == NULL || DimmCount > MAX_DIMMS ||
-       ppResultStr == NULL || pDiagState == NULL) {
+       pResult == NULL || pDiagState == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
@@ -1173,7 +1184,7 @@ CheckDimmUIDDuplication(
       CopyMem_S(ppDuplicateDimmUids[TotalNumDuplicateUID], MAX_DIMM_UID_LENGTH * sizeof(CHAR16), CandidateDimmUID, MAX_DIMM_UID_LENGTH * sizeof(CHAR16));
       TotalNumDuplicateUID++;
 
-      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_DUPLICATE_DIMM_UID), EVENT_CODE_608, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_CONFIG_DUPLICATE_DIMM_UID), EVENT_CODE_608, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         NumDuplicateUID, CandidateDimmUID);
     }
   }
@@ -1227,28 +1238,28 @@ RunConfigDiagnostics(
   if (DimmCount == 0 || ppDimms == NULL) {
     ReturnCode = EFI_SUCCESS;
     APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_NO_MANAGEABLE_DIMMS), EVENT_CODE_601, DIAG_STATE_MASK_OK,
-      &pResult->Message, &pResult->StateVal);
+      pResult, DIAG_NO_SUBTEST, &pResult->StateVal);
     goto Finish;
   }
 
   pResult->SubTestName[DIMMSPECS_TEST_INDEX] = CatSPrint(NULL, L"PMem module specs");
-  ReturnCode = CheckUninitializedDimms(&pResult->SubTestMessage[DIMMSPECS_TEST_INDEX], &pResult->SubTestStateVal[DIMMSPECS_TEST_INDEX],DimmIdPreference);
+  ReturnCode = CheckUninitializedDimms(pResult, DIMMSPECS_TEST_INDEX, &pResult->SubTestStateVal[DIMMSPECS_TEST_INDEX],DimmIdPreference);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("The check for uninitialized dimms failed.");
     if ((pResult->SubTestStateVal[DIMMSPECS_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_ABORTED_INTERNAL_ERROR), EVENT_CODE_630, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[DIMMSPECS_TEST_INDEX], &pResult->SubTestStateVal[DIMMSPECS_TEST_INDEX]);
+        pResult, DIMMSPECS_TEST_INDEX, &pResult->SubTestStateVal[DIMMSPECS_TEST_INDEX]);
       goto Finish;
     }
   }
 
   pResult->SubTestName[DUPLICATE_DIMM_TEST_INDEX] = CatSPrint(NULL, L"Duplicate PMem module");
-  ReturnCode = CheckDimmUIDDuplication(ppDimms, DimmCount, &pResult->SubTestMessage[DUPLICATE_DIMM_TEST_INDEX], &pResult->SubTestStateVal[1]);
+  ReturnCode = CheckDimmUIDDuplication(ppDimms, DimmCount, pResult, DUPLICATE_DIMM_TEST_INDEX, &pResult->SubTestStateVal[1]);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("The check for duplicate UID numbers failed.");
     if ((pResult->SubTestStateVal[DUPLICATE_DIMM_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_ABORTED_INTERNAL_ERROR), EVENT_CODE_630, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[DUPLICATE_DIMM_TEST_INDEX], &pResult->SubTestStateVal[DUPLICATE_DIMM_TEST_INDEX]);
+        pResult, DUPLICATE_DIMM_TEST_INDEX, &pResult->SubTestStateVal[DUPLICATE_DIMM_TEST_INDEX]);
       goto Finish;
     }
   }
@@ -1257,43 +1268,43 @@ RunConfigDiagnostics(
   ReturnCode = GetSystemCapabilitiesInfo(&gNvmDimmDriverNvmDimmConfig, &SysCapInfo);
   if ((pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
     APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_ABORTED_INTERNAL_ERROR), EVENT_CODE_630, DIAG_STATE_MASK_ABORTED,
-      &pResult->SubTestMessage[SYSTEMCAP_TEST_INDEX], &pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX]);
+      pResult, SYSTEMCAP_TEST_INDEX, &pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX]);
     goto Finish;
   }
 
   if (!SysCapInfo.AdrSupported) {
     APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_NO_ADR_SUPPORT), EVENT_CODE_629, DIAG_STATE_MASK_FAILED,
-      &pResult->SubTestMessage[SYSTEMCAP_TEST_INDEX], &pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX]);
+      pResult, SYSTEMCAP_TEST_INDEX, &pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX]);
   }
 
-  ReturnCode = CheckSystemSupportedCapabilities(ppDimms, DimmCount, DimmIdPreference, &pResult->SubTestMessage[SYSTEMCAP_TEST_INDEX], &pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX]);
+  ReturnCode = CheckSystemSupportedCapabilities(ppDimms, DimmCount, DimmIdPreference, pResult, SYSTEMCAP_TEST_INDEX, &pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX]);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("The check for System supported capabilities failed.");
     if ((pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_ABORTED_INTERNAL_ERROR), EVENT_CODE_630, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[SYSTEMCAP_TEST_INDEX], &pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX]);
+        pResult, SYSTEMCAP_TEST_INDEX, &pResult->SubTestStateVal[SYSTEMCAP_TEST_INDEX]);
       goto Finish;
     }
   }
 
   pResult->SubTestName[NAMESPACE_LSA_TEST_INDEX] = CatSPrint(NULL, L"Namespace LSA");
-  ReturnCode = CheckNamespaceLabelAreaIndex(ppDimms, DimmCount, DimmIdPreference, &pResult->SubTestMessage[NAMESPACE_LSA_TEST_INDEX], &pResult->SubTestStateVal[NAMESPACE_LSA_TEST_INDEX]);
+  ReturnCode = CheckNamespaceLabelAreaIndex(ppDimms, DimmCount, DimmIdPreference, pResult, NAMESPACE_LSA_TEST_INDEX, &pResult->SubTestStateVal[NAMESPACE_LSA_TEST_INDEX]);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("The check for Namespace label retrieve failed.");
     if ((pResult->SubTestStateVal[NAMESPACE_LSA_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_ABORTED_INTERNAL_ERROR), EVENT_CODE_630, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[NAMESPACE_LSA_TEST_INDEX], &pResult->SubTestStateVal[NAMESPACE_LSA_TEST_INDEX]);
+        pResult, NAMESPACE_LSA_TEST_INDEX, &pResult->SubTestStateVal[NAMESPACE_LSA_TEST_INDEX]);
       goto Finish;
     }
   }
 
   pResult->SubTestName[PCD_TEST_INDEX] = CatSPrint(NULL, L"PCD");
-  ReturnCode = CheckPlatformConfigurationData(ppDimms, DimmCount, DimmIdPreference, &pResult->SubTestMessage[PCD_TEST_INDEX], &pResult->SubTestStateVal[PCD_TEST_INDEX]);
+  ReturnCode = CheckPlatformConfigurationData(ppDimms, DimmCount, DimmIdPreference, pResult, PCD_TEST_INDEX, &pResult->SubTestStateVal[PCD_TEST_INDEX]);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("The check for platform configuration data failed.");
     if ((pResult->SubTestStateVal[PCD_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_ABORTED_INTERNAL_ERROR), EVENT_CODE_630, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[PCD_TEST_INDEX], &pResult->SubTestStateVal[PCD_TEST_INDEX]);
+        pResult, PCD_TEST_INDEX, &pResult->SubTestStateVal[PCD_TEST_INDEX]);
       goto Finish;
     }
   }
@@ -11,17 +11,26 @@
 
 extern NVMDIMMDRIVER_DATA *gNvmDimmData;
 
-/**
-  Append to the results string for a paricular diagnostic test, and modify
-  the test state as per the message being appended.
+#define DIAG_EVENTS_INITIAL_CAPACITY 16
 
-  @param[in] pStrToAppend Pointer to the message string to be appended
-  @param[in] DiagStateMask State corresonding to the string that is being appended
-  @param[in out] ppResult Pointer to the result string of the particular test-suite's messages
+/**
+  Add an event record to the results of a particular diagnostic test, and modify
+  the test state as per the event being added.
+
+  The events array grows geometrically, so adding an event does not copy the
+  messages reported before it.
+
+  @param[in] pDimm PMem module the event is about, NULL if it is not about one
+  @param[in] Code Event code
+  @param[in] pStrToAppend Pointer to the message string, owned by the event afterwards
+  @param[in] DiagStateMask State corresponding to the event that is being added
+  @param[in out] pResult Pointer to the results of the test
+  @param[in] SubTestIndex Subtest reporting the event, DIAG_NO_SUBTEST for the test itself
   @param[in out] pDiagState Pointer to the particular test state
 
   @retval EFI_SUCCESS Success
   @retval EFI_INVALID_PARAMETER if any of the parameters is a NULL
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
 **/
 EFI_STATUS
 AppendToDiagnosticsResult (
@@ -29,20 +38,43 @@ AppendToDiagnosticsResult (
   IN     UINT32 Code OPTIONAL,
   IN     CHAR16 *pStrToAppend,
   IN     UINT8 DiagStateMask,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
   )
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
+  DIAG_EVENT *pEvents = NULL;
+  DIAG_EVENT *pEvent = NULL;
+  UINT32 NewCapacity = 0;
 
   NVDIMM_ENTRY();
 
-  if (pStrToAppend == NULL || ppResultStr == NULL || pDiagState == NULL) {
+  if (pStrToAppend == NULL || pResult == NULL || pDiagState == NULL ||
+      (SubTestIndex != DIAG_NO_SUBTEST && SubTestIndex >= MAX_NO_OF_DIAGNOSTIC_SUBTESTS)) {
     ReturnCode = EFI_INVALID_PARAMETER;
     goto Finish;
   }
 
-  *ppResultStr = CatSPrintClean(*ppResultStr, FORMAT_STR_NL, pStrToAppend);
+  if (pResult->EventsNum == pResult->EventsCapacity) {
+    NewCapacity = (pResult->EventsCapacity == 0) ? DIAG_EVENTS_INITIAL_CAPACITY : pResult->EventsCapacity * 2;
+    pEvents = ReallocatePool(pResult->EventsCapacity * sizeof(*pEvents), NewCapacity * sizeof(*pEvents),
+      pResult->pEvents);
+    if (pEvents == NULL) {
+      ReturnCode = EFI_OUT_OF_RESOURCES;
+      goto Finish;
+    }
+    pResult->pEvents = pEvents;
+    pResult->EventsCapacity = NewCapacity;
+  }
+
+  pEvent = &pResult->pEvents[pResult->EventsNum++];
+  pEvent->SubTestIndex = SubTestIndex;
+  pEvent->DimmId = (pDimm != NULL) ? pDimm->DimmID : DIMM_PID_INVALID;
+  pEvent->EventCode = Code;
+  pEvent->StateMask = DiagStateMask;
+  pEvent->pMessage = pStrToAppend;
+  pStrToAppend = NULL;
 
   *pDiagState |= DiagStateMask;
 
@@ -125,85 +157,6 @@ GetDiagnosticTestName(
   return pDiagTestStr;
 }
 
-/**
-  Add headers to the message results from all the tests that were run,
-  and then append those messages into one single Diagnostics result string
-
-  @param[in] pBuffer Array of the result messages for all tests
-  @param[in] DiagState Array of the result state for all tests
-  @param[out] ppResult Pointer to the final result string for all tests that were run
-
-  @retval EFI_SUCCESS Success
-  @retval EFI_INVALID_PARAMETER if any of the parameters is a NULL
-**/
-EFI_STATUS
-CombineDiagnosticsTestResults(
-  IN     CHAR16 *pBuffer[],
-  IN     UINT8 DiagState[],
-     OUT CHAR16 **ppResult
-  )
-{
-  EFI_STATUS ReturnCode = EFI_SUCCESS;
-  UINTN Index = 0;
-  CHAR16 *pColonMarkStr = NULL;
-  CHAR16 *pTestNameValueStr = NULL;
-  CHAR16 *pDiagStateValueStr = NULL;
-  CHAR16 *pTempHeaderStr = NULL;
-
-  NVDIMM_ENTRY();
-
-  if (pBuffer == NULL || ppResult == NULL) {
-    ReturnCode = EFI_INVALID_PARAMETER;
-    goto Finish;
-  }
-
-  pColonMarkStr = HiiGetString(gNvmDimmData->HiiHandle, STRING_TOKEN(STR_DCPMM_COLON_MARK), NULL);
-
-  for (Index = 0; Index < DIAGNOSTIC_TEST_COUNT; Index++) {
-    if (pBuffer[Index] != NULL) {
-
-      //creating test name string
-      pTestNameValueStr = GetDiagnosticTestName((UINT8)Index);
-      if (pTestNameValueStr == NULL) {
-        NVDIMM_DBG("Retrieval of the test name failed");
-        //log as warning state and a message
-        continue;
-      }
-
-      //creating state string
-      pDiagStateValueStr = GetDiagnosticState(DiagState[Index]);
-      if (pDiagStateValueStr == NULL) {
-        NVDIMM_DBG("Retrieval of the test state failed");
-        FREE_POOL_SAFE(pTestNameValueStr);
-        //log as warning state and a message
-        continue;
-      }
-
-      pTempHeaderStr = HiiGetString(gNvmDimmData->HiiHandle, STRING_TOKEN(STR_DIAGNOSTIC_TEST_NAME_HEADER), NULL);
-      *ppResult = CatSPrintClean(*ppResult, FORMAT_STR FORMAT_STR L" " FORMAT_STR_NL, pTempHeaderStr, pColonMarkStr, pTestNameValueStr);
-      FREE_POOL_SAFE(pTempHeaderStr);
-      FREE_POOL_SAFE(pTestNameValueStr);
-
-      pTempHeaderStr = HiiGetString(gNvmDimmData->HiiHandle, STRING_TOKEN(STR_DIAGNOSTIC_STATE_HEADER), NULL);
-      *ppResult = CatSPrintClean(*ppResult, FORMAT_STR FORMAT_STR L" " FORMAT_STR_NL, pTempHeaderStr, pColonMarkStr, pDiagStateValueStr);
-      FREE_POOL_SAFE(pTempHeaderStr);
-      FREE_POOL_SAFE(pDiagStateValueStr);
-
-      pTempHeaderStr = HiiGetString(gNvmDimmData->HiiHandle, STRING_TOKEN(STR_DIAGNOSTIC_MESSAGE_HEADER), NULL);
-      *ppResult = CatSPrintClean(*ppResult, FORMAT_STR  FORMAT_STR L"\n" FORMAT_STR_NL, pTempHeaderStr, pColonMarkStr, pBuffer[Index]);
-      FREE_POOL_SAFE(pTempHeaderStr);
-
-      FREE_POOL_SAFE(pTestNameValueStr);
-      FREE_POOL_SAFE(pDiagStateValueStr);
-    }
-  }
-
-Finish:
-  FREE_POOL_SAFE(pColonMarkStr);
-  NVDIMM_EXIT_I64(ReturnCode);
-  return ReturnCode;
-}
-
 /**
   The fundamental core diagnostics function that is used by both
   the NvmDimmConfig protocol and the DriverDiagnostic protoocls.
@@ -422,6 +375,7 @@ UpdateTestState(
   EFI_STATUS ReturnCode = EFI_SUCCESS;
   UINTN Id = 0;
   BOOLEAN IsTestPassed = TRUE;
+  BOOLEAN HasTestEvents = FALSE;
 
   if (pBuffer != NULL) {
     for (Id = 0; Id < MAX_NO_OF_DIAGNOSTIC_SUBTESTS; Id++) {
@@ -436,20 +390,27 @@ UpdateTestState(
     }
     pBuffer->State = GetDiagnosticState(pBuffer->StateVal);
 
-    if (pBuffer->Message == NULL) {
+    for (Id = 0; Id < pBuffer->EventsNum; Id++) {
+      if (pBuffer->pEvents[Id].SubTestIndex == DIAG_NO_SUBTEST) {
+        HasTestEvents = TRUE;
+        break;
+      }
+    }
+
+    if (!HasTestEvents) {
       if (IsTestPassed == TRUE) {
         switch (DiagnosticTestIndex) {
         case  QuickDiagnosticIndex:
-          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_QUICK_SUCCESS), EVENT_CODE_500, DIAG_STATE_MASK_OK, &pBuffer->Message, &pBuffer->StateVal);
+          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_QUICK_SUCCESS), EVENT_CODE_500, DIAG_STATE_MASK_OK, pBuffer, DIAG_NO_SUBTEST, &pBuffer->StateVal);
           break;
         case ConfigDiagnosticIndex:
-          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_SUCCESS), EVENT_CODE_600, DIAG_STATE_MASK_OK, &pBuffer->Message, &pBuffer->StateVal);
+          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_CONFIG_SUCCESS), EVENT_CODE_600, DIAG_STATE_MASK_OK, pBuffer, DIAG_NO_SUBTEST, &pBuffer->StateVal);
           break;
         case SecurityDiagnosticIndex:
-          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_SECURITY_SUCCESS), EVENT_CODE_800, DIAG_STATE_MASK_OK, &pBuffer->Message, &pBuffer->StateVal);
+          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_SECURITY_SUCCESS), EVENT_CODE_800, DIAG_STATE_MASK_OK, pBuffer, DIAG_NO_SUBTEST, &pBuffer->StateVal);
           break;
         case FwDiagnosticIndex:
-          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_SUCCESS), EVENT_CODE_900, DIAG_STATE_MASK_OK, &pBuffer->Message, &pBuffer->StateVal);
+          APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_SUCCESS), EVENT_CODE_900, DIAG_STATE_MASK_OK, pBuffer, DIAG_NO_SUBTEST, &pBuffer->StateVal);
           break;
         default:
           NVDIMM_DBG("invalid diagnostic test");
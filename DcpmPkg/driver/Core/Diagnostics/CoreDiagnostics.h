@@ -24,21 +24,14 @@
 #include <Protocol/Smbios.h>
 #include <Library/HiiLib.h>
 
-#define APPEND_RESULT_TO_THE_LOG(pDimm,String,Code,StateMask,ppResult,pState,...) { \
+#define APPEND_RESULT_TO_THE_LOG(pDimm,String,Code,StateMask,pResult,SubTestIndex,pState,...) { \
   CHAR16 *pTempHiiString = HiiGetString(gNvmDimmData->HiiHandle, String, NULL); \
   CHAR16 *pTempHiiString1 = CatSPrintClean(NULL, pTempHiiString, ## __VA_ARGS__); \
   FREE_POOL_SAFE(pTempHiiString); \
   if (pTempHiiString1) \
-    AppendToDiagnosticsResult(pDimm, Code, pTempHiiString1, StateMask, ppResult, pState); \
+    AppendToDiagnosticsResult(pDimm, Code, pTempHiiString1, StateMask, pResult, SubTestIndex, pState); \
 }
 
- /** Diagnostics State bitmasks **/
-#define DIAG_STATE_MASK_OK         BIT0
-#define DIAG_STATE_MASK_WARNING    BIT1
-#define DIAG_STATE_MASK_FAILED     BIT2
-#define DIAG_STATE_MASK_ABORTED    BIT3
-#define DIAG_STATE_MASK_ALL (DIAG_STATE_MASK_OK |  DIAG_STATE_MASK_WARNING |  DIAG_STATE_MASK_FAILED |  DIAG_STATE_MASK_ABORTED)
-
 /** Event Codes' definitions **/
 /* Diagnostic Quick Eve nts **/
 #define EVENT_CODE_500      500
@@ -168,16 +161,20 @@ CreateDiagnosticStr (
   );
 
 /**
-  Append to the results string for a particular diagnostic test, and modify
-  the test state as per the message being appended.
-
-  @param[in] pStrToAppend Pointer to the message string to be appended
-  @param[in] DiagStateMask State corresponding to the string that is being appended
-  @param[in out] ppResult Pointer to the result string of the particular test-suite's messages
+  Add an event record to the results of a particular diagnostic test, and modify
+  the test state as per the event being added.
+
+  @param[in] pDimm PMem module the event is about, NULL if it is not about one
+  @param[in] Code Event code
+  @param[in] pStrToAppend Pointer to the message string, owned by the event afterwards
+  @param[in] DiagStateMask State corresponding to the event that is being added
+  @param[in out] pResult Pointer to the results of the test
+  @param[in] SubTestIndex Subtest reporting the event, DIAG_NO_SUBTEST for the test itself
   @param[in out] pDiagState Pointer to the particular test state
 
   @retval EFI_SUCCESS Success
   @retval EFI_INVALID_PARAMETER if any of the parameters is a NULL
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
 **/
 EFI_STATUS
 AppendToDiagnosticsResult (
@@ -185,28 +182,11 @@ AppendToDiagnosticsResult (
   IN     UINT32 Code OPTIONAL,
   IN     CHAR16 *pStrToAppend,
   IN     UINT8 DiagStateMask,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
   );
 
-/**
-  Add headers to the message results from all the tests that were run,
-  and then append those messages into one single Diagnostics result string
-
-  @param[in] pBuffer Array of the result messages for all tests
-  @param[in] DiagState Array of the result state for all tests
-  @param[out] ppResult Pointer to the final result string for all tests that were run
-
-  @retval EFI_SUCCESS Success
-  @retval EFI_INVALID_PARAMETER if any of the parameters is a NULL
-**/
-EFI_STATUS
-CombineDiagnosticsTestResults(
-  IN     CHAR16 *pBuffer[],
-  IN     UINT8 DiagState[],
-     OUT CHAR16 **ppResult
-  );
-
 /**
   This function should be used to update status of the test based on information stored
   inside diagnostic information structure.
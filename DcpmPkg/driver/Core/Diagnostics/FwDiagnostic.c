@@ -52,28 +52,28 @@ RunFwDiagnostics(
 
   if (DimmCount == 0 || ppDimms == NULL) {
     ReturnCode = EFI_SUCCESS;
-    APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_NO_MANAGEABLE_DIMMS), EVENT_CODE_901, DIAG_STATE_MASK_OK, &pResult->Message, &pResult->StateVal);
+    APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_NO_MANAGEABLE_DIMMS), EVENT_CODE_901, DIAG_STATE_MASK_OK, pResult, DIAG_NO_SUBTEST, &pResult->StateVal);
     goto Finish;
   }
 
   pResult->SubTestName[FW_CONSIST_TEST_INDEX] = CatSPrint(NULL, L"FW Consistency");
-  ReturnCode = CheckFwConsistency(ppDimms, DimmCount, DimmIdPreference, &pResult->SubTestMessage[FW_CONSIST_TEST_INDEX], &pResult->SubTestStateVal[FW_CONSIST_TEST_INDEX]);
+  ReturnCode = CheckFwConsistency(ppDimms, DimmCount, DimmIdPreference, pResult, FW_CONSIST_TEST_INDEX, &pResult->SubTestStateVal[FW_CONSIST_TEST_INDEX]);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("The check for firmware consistency failed.");
     if ((pResult->SubTestStateVal[FW_CONSIST_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_ABORTED_INTERNAL_ERROR), EVENT_CODE_910, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[FW_CONSIST_TEST_INDEX], &pResult->SubTestStateVal[FW_CONSIST_TEST_INDEX]);
+        pResult, FW_CONSIST_TEST_INDEX, &pResult->SubTestStateVal[FW_CONSIST_TEST_INDEX]);
       goto Finish;
     }
   }
 
   pResult->SubTestName[VIRAL_POLICY_CONSIST_TEST_INDEX] = CatSPrint(NULL, L"Viral Policy");
-  ReturnCode = CheckViralPolicyConsistency(ppDimms, DimmCount, &pResult->SubTestMessage[VIRAL_POLICY_CONSIST_TEST_INDEX], &pResult->SubTestStateVal[VIRAL_POLICY_CONSIST_TEST_INDEX]);
+  ReturnCode = CheckViralPolicyConsistency(ppDimms, DimmCount, pResult, VIRAL_POLICY_CONSIST_TEST_INDEX, &pResult->SubTestStateVal[VIRAL_POLICY_CONSIST_TEST_INDEX]);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("The check for viral policy settings consistency failed");
     if ((pResult->SubTestStateVal[VIRAL_POLICY_CONSIST_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_ABORTED_INTERNAL_ERROR), EVENT_CODE_910, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[VIRAL_POLICY_CONSIST_TEST_INDEX], &pResult->SubTestStateVal[VIRAL_POLICY_CONSIST_TEST_INDEX]);
+        pResult, VIRAL_POLICY_CONSIST_TEST_INDEX, &pResult->SubTestStateVal[VIRAL_POLICY_CONSIST_TEST_INDEX]);
       goto Finish;
     }
   }
@@ -87,12 +87,12 @@ RunFwDiagnostics(
       goto Finish;
     }
 
-    ReturnCode = ThresholdsCheck(ppDimms[Index], &pResult->SubTestMessage[THRESHHOLD_TEST_INDEX], &pResult->SubTestStateVal[THRESHHOLD_TEST_INDEX]);
+    ReturnCode = ThresholdsCheck(ppDimms[Index], pResult, THRESHHOLD_TEST_INDEX, &pResult->SubTestStateVal[THRESHHOLD_TEST_INDEX]);
     if (EFI_ERROR(ReturnCode)) {
       NVDIMM_DBG("The check for firmware threshold settings failed. Dimm handle 0x%04x.", ppDimms[Index]->DeviceHandle.AsUint32);
       if ((pResult->SubTestStateVal[THRESHHOLD_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
         APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_ABORTED_INTERNAL_ERROR), EVENT_CODE_910, DIAG_STATE_MASK_ABORTED,
-          &pResult->SubTestMessage[THRESHHOLD_TEST_INDEX], &pResult->SubTestStateVal[THRESHHOLD_TEST_INDEX]);
+          pResult, THRESHHOLD_TEST_INDEX, &pResult->SubTestStateVal[THRESHHOLD_TEST_INDEX]);
         goto Finish;
       }
     }
@@ -264,7 +264,8 @@ Finish:
   @param[in] pDimm Pointer to the DIMM
   @param[in] pDimmStr Dimm string to be used in result messages
   @param[in] DimmIdPreference Preference for Dimm ID display (UID/Handle)
-  @param[in out] ppResult Pointer to the result string of fw diagnostics message
+  @param[in out] pResult Pointer to the fw diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the fw diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -276,7 +277,8 @@ CheckFwConsistency(
   IN     DIMM **ppDimms,
   IN     CONST UINT16 DimmCount,
   IN     UINT8 DimmIdPreference,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
      OUT UINT8 *pDiagState
   )
 {
@@ -300,7 +302,7 @@ CheckFwConsistency(
   ZeroMem(TmpFwVerStr, sizeof(TmpFwVerStr));
 
   if (DimmCount == 0 || ppDimms == NULL || DimmCount > MAX_DIMMS ||
-       ppResultStr == NULL || pDiagState == NULL) {
+       pResult == NULL || pDiagState == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
@@ -348,7 +350,7 @@ CheckFwConsistency(
     }
 
     if (pAppendedDimmsStr != NULL) {
-      APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_INCONSISTENT), EVENT_CODE_902, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState, pAppendedDimmsStr, SubsystemDeviceIdList[Index], OptimumFwVersionStr);
+      APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_INCONSISTENT), EVENT_CODE_902, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState, pAppendedDimmsStr, SubsystemDeviceIdList[Index], OptimumFwVersionStr);
       FREE_POOL_SAFE(pAppendedDimmsStr);
     }
   }
@@ -366,7 +368,8 @@ Also, accordingly modifies the test-state.
 
 @param[in] ppDimms The DIMM pointers list
 @param[in] DimmCount DIMMs count
-@param[in out] ppResultStr Pointer to the result string of fw diagnostics message
+@param[in out] pResult Pointer to the fw diagnostics results
+@param[in] SubTestIndex Subtest the events are reported for
 @param[out] pDiagState Pointer to the fw diagnostics test state. Possible states:
             DIAG_STATE_MASK_OK, DIAG_STATE_MASK_WARNING, DIAG_STATE_MASK_FAILED,
             DIAG_STATE_MASK_ABORTED
@@ -379,7 +382,8 @@ EFI_STATUS
 CheckViralPolicyConsistency(
   IN     DIMM **ppDimms,
   IN     CONST UINT16 DimmCount,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   OUT UINT8 *pDiagState
 )
 {
@@ -392,7 +396,7 @@ CheckViralPolicyConsistency(
   NVDIMM_ENTRY();
 
   if (DimmCount == 0 || ppDimms == NULL || DimmCount > MAX_DIMMS ||
-    ppResultStr == NULL || pDiagState == NULL) {
+    pResult == NULL || pDiagState == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
@@ -430,7 +434,7 @@ CheckViralPolicyConsistency(
       ViralPolicyState = pDimms[0].ViralPolicyEnable;
     }
     if (pDimms[Index].ViralPolicyEnable != ViralPolicyState) {
-      APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_INCONSISTENT_VIRAL_POLICY), EVENT_CODE_906, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState);
+      APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_FW_INCONSISTENT_VIRAL_POLICY), EVENT_CODE_906, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState);
       goto Finish;
     }
   }
@@ -447,7 +451,8 @@ Controller Temperature and Spare Block thresholds.
 Log proper events in case of any error.
 
 @param[in] pDimm Pointer to the DIMM
-@param[in out] ppResult Pointer to the result string of fw diagnostics message
+@param[in out] pResult Pointer to the fw diagnostics results
+@param[in] SubTestIndex Subtest the events are reported for
 @param[out] pDiagState Pointer to the quick diagnostics test state
 
 @retval EFI_SUCCESS Test executed correctly
@@ -456,7 +461,8 @@ Log proper events in case of any error.
 EFI_STATUS
 ThresholdsCheck(
   IN     DIMM *pDimm,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
 )
 {
@@ -471,7 +477,7 @@ ThresholdsCheck(
 
   ZeroMem(&HealthInfo, sizeof(HealthInfo));
 
-  if ((NULL == pDimm) || (NULL == pDiagState) || (NULL == ppResultStr)) {
+  if ((NULL == pDimm) || (NULL == pDiagState) || (NULL == pResult)) {
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
     }
@@ -500,7 +506,7 @@ ThresholdsCheck(
   }
 
   if (FALSE != AlarmEnabled && HealthInfo.MediaTempShutdownThresh < MediaTemperatureThreshold) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_FW_MEDIA_TEMPERATURE_THRESHOLD_ERROR), EVENT_CODE_903, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_FW_MEDIA_TEMPERATURE_THRESHOLD_ERROR), EVENT_CODE_903, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
       pDimm->DeviceHandle.AsUint32, MediaTemperatureThreshold, HealthInfo.MediaTempShutdownThresh);
   }
 
@@ -517,7 +523,7 @@ ThresholdsCheck(
   }
 
   if (FALSE != AlarmEnabled && HealthInfo.ContrTempShutdownThresh < ControllerTemperatureThreshold) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_FW_CONTROLLER_TEMPERATURE_THRESHOLD_ERROR), EVENT_CODE_904, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_FW_CONTROLLER_TEMPERATURE_THRESHOLD_ERROR), EVENT_CODE_904, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
       pDimm->DeviceHandle.AsUint32, ControllerTemperatureThreshold, HealthInfo.ContrTempShutdownThresh);
   }
 
@@ -534,7 +540,7 @@ ThresholdsCheck(
   }
 
   if (FALSE != AlarmEnabled && HealthInfo.PercentageRemainingValid && HealthInfo.PercentageRemaining < PercentageRemainingThreshold) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_FW_SPARE_BLOCK_THRESHOLD_ERROR), EVENT_CODE_905, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_FW_SPARE_BLOCK_THRESHOLD_ERROR), EVENT_CODE_905, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
       pDimm->DeviceHandle.AsUint32, HealthInfo.PercentageRemaining, PercentageRemainingThreshold);
   }
 
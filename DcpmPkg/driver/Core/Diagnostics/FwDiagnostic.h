@@ -37,7 +37,8 @@ RunFwDiagnostics(
   @param[in] pDimm Pointer to the DIMM
   @param[in] pDimmStr Dimm string to be used in result messages
   @param[in] DimmIdPreference Preference for Dimm ID display (UID/Handle)
-  @param[in out] ppResult Pointer to the result string of fw diagnostics message
+  @param[in out] pResult Pointer to the fw diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the fw diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -49,7 +50,8 @@ CheckFwConsistency(
   IN     DIMM **ppDimms,
   IN     CONST UINT16 DimmCount,
   IN     UINT8 DimmIdPreference,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
      OUT UINT8 *pDiagState
   );
 
@@ -60,7 +62,8 @@ Also, accordingly modifies the test-state.
 
 @param[in] ppDimms The DIMM pointers list
 @param[in] DimmCount DIMMs count
-@param[in out] ppResultStr Pointer to the result string of fw diagnostics message
+@param[in out] pResult Pointer to the fw diagnostics results
+@param[in] SubTestIndex Subtest the events are reported for
 @param[out] pDiagState Pointer to the fw diagnostics test state. Possible states:
             DIAG_STATE_MASK_OK, DIAG_STATE_MASK_WARNING, DIAG_STATE_MASK_FAILED,
             DIAG_STATE_MASK_ABORTED
@@ -73,7 +76,8 @@ EFI_STATUS
 CheckViralPolicyConsistency(
   IN     DIMM **ppDimms,
   IN     CONST UINT16 DimmCount,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   OUT UINT8 *pDiagState
 );
 
@@ -129,7 +133,8 @@ Controller Temperature and Spare Block thresholds.
 Log proper events in case of any error.
 
 @param[in] pDimm Pointer to the DIMM
-@param[in out] ppResult Pointer to the result string of fw diagnostics message
+@param[in out] pResult Pointer to the fw diagnostics results
+@param[in] SubTestIndex Subtest the events are reported for
 @param[out] pDiagState Pointer to the quick diagnostics test state
 
 @retval EFI_SUCCESS Test executed correctly
@@ -138,7 +143,8 @@ Log proper events in case of any error.
 EFI_STATUS
 ThresholdsCheck(
   IN     DIMM *pDimm,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
 );
 #endif
@@ -76,30 +76,30 @@ RunQuickDiagnostics(
     }
 
     pResult->SubTestName[MANAGEABILITY_TEST_INDEX] = CatSPrint(NULL, L"Manageability");
-    ReturnCode = DiagnosticsManageabilityCheck(ppDimms[Index], DimmStr, &pResult->SubTestMessage[MANAGEABILITY_TEST_INDEX], &pResult->SubTestStateVal[MANAGEABILITY_TEST_INDEX]);
+    ReturnCode = DiagnosticsManageabilityCheck(ppDimms[Index], DimmStr, pResult, MANAGEABILITY_TEST_INDEX, &pResult->SubTestStateVal[MANAGEABILITY_TEST_INDEX]);
     if (EFI_ERROR(ReturnCode) || (!IsDimmManageable(ppDimms[Index]))) {
       NVDIMM_DBG("The check for manageability for DIMM ID 0x%x failed.", ppDimms[Index]->DeviceHandle.AsUint32);
       continue;
     }
 
     pResult->SubTestName[BOOTSTATUS_TEST_INDEX] = CatSPrint(NULL, L"Boot status");
-    ReturnCode = BootStatusDiagnosticsCheck(ppDimms[Index], DimmStr, &pResult->SubTestMessage[BOOTSTATUS_TEST_INDEX], &pResult->SubTestStateVal[BOOTSTATUS_TEST_INDEX]);
+    ReturnCode = BootStatusDiagnosticsCheck(ppDimms[Index], DimmStr, pResult, BOOTSTATUS_TEST_INDEX, &pResult->SubTestStateVal[BOOTSTATUS_TEST_INDEX]);
     if (EFI_ERROR(ReturnCode)) {
       NVDIMM_DBG("The BSR check for DIMM ID 0x%x failed.", ppDimms[Index]->DeviceHandle.AsUint32);
       if ((pResult->SubTestStateVal[BOOTSTATUS_TEST_INDEX] & DIAG_STATE_MASK_ABORTED) != 0) {
         APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_QUICK_ABORTED_DIMM_INTERNAL_ERROR), EVENT_CODE_540, DIAG_STATE_MASK_ABORTED,
-          &pResult->SubTestMessage[BOOTSTATUS_TEST_INDEX], &pResult->SubTestStateVal[BOOTSTATUS_TEST_INDEX], DimmStr);
+          pResult, BOOTSTATUS_TEST_INDEX, &pResult->SubTestStateVal[BOOTSTATUS_TEST_INDEX], DimmStr);
       }
       continue;
     }
 
     pResult->SubTestName[SMARTHEALTH_TEST_INDEX] = CatSPrint(NULL, L"Health");
-    ReturnCode = SmartAndHealthCheck(ppDimms[Index], DimmStr, &pResult->SubTestMessage[SMARTHEALTH_TEST_INDEX], &pResult->SubTestStateVal[SMARTHEALTH_TEST_INDEX]);
+    ReturnCode = SmartAndHealthCheck(ppDimms[Index], DimmStr, pResult, SMARTHEALTH_TEST_INDEX, &pResult->SubTestStateVal[SMARTHEALTH_TEST_INDEX]);
     if (EFI_ERROR(ReturnCode)) {
       NVDIMM_DBG("The smart and health check for DIMM ID 0x%x failed.", ppDimms[Index]->DeviceHandle.AsUint32);
       if ((TmpDiagState & DIAG_STATE_MASK_ABORTED) != 0) {
         APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_QUICK_ABORTED_DIMM_INTERNAL_ERROR), EVENT_CODE_540, DIAG_STATE_MASK_ABORTED,
-          &pResult->SubTestMessage[SMARTHEALTH_TEST_INDEX], &pResult->SubTestStateVal[SMARTHEALTH_TEST_INDEX], DimmStr);
+          pResult, SMARTHEALTH_TEST_INDEX, &pResult->SubTestStateVal[SMARTHEALTH_TEST_INDEX], DimmStr);
       }
       continue;
     }
@@ -119,7 +119,8 @@ Finish:
 
   @param[in] pDimm Pointer to the DIMM
   @param[in] pDimmStr Dimm string to be used in result messages
-  @param[out] ppResult Pointer to the result string of quick diagnostics message
+  @param[in out] pResult Pointer to the quick diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the quick diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -129,7 +130,8 @@ EFI_STATUS
 DiagnosticsManageabilityCheck(
   IN     DIMM *pDimm,
   IN     CHAR16 *pDimmStr,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
   )
 {
@@ -138,7 +140,7 @@ DiagnosticsManageabilityCheck(
 
   NVDIMM_ENTRY();
 
-  if (pDimm == NULL || pDimmStr == NULL || ppResultStr == NULL || pDiagState == NULL) {
+  if (pDimm == NULL || pDimmStr == NULL || pResult == NULL || pDiagState == NULL) {
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
     }
@@ -148,18 +150,18 @@ DiagnosticsManageabilityCheck(
 
   if (!IsDimmManageable(pDimm)) {
     if (SPD_INTEL_VENDOR_ID != pDimm->SubsystemVendorId) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_UNMANAGEBALE_DIMM_SUBSYSTEM_VENDOR_ID), EVENT_CODE_501, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_UNMANAGEBALE_DIMM_SUBSYSTEM_VENDOR_ID), EVENT_CODE_501, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
         pDimmStr, EndianSwapUint16(pDimm->SubsystemVendorId));
     }
 
     if (!IsSubsystemDeviceIdSupported(pDimm)) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_UNMANAGEBALE_DIMM_SUBSYSTEM_DEVICE_ID), EVENT_CODE_502, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_UNMANAGEBALE_DIMM_SUBSYSTEM_DEVICE_ID), EVENT_CODE_502, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
         pDimmStr, EndianSwapUint16(pDimm->SubsystemDeviceId));
     }
 
     if (!IsFwApiVersionSupported(pDimm)) {
       ConvertFwApiVersion(TmpFwApiVerStr, pDimm->FwVer.FwApiMajor, pDimm->FwVer.FwApiMinor);
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_UNMANAGEBALE_DIMM_FW_API_VERSION), EVENT_CODE_503, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_UNMANAGEBALE_DIMM_FW_API_VERSION), EVENT_CODE_503, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
         pDimmStr, TmpFwApiVerStr);
     }
   }
@@ -176,7 +178,8 @@ Finish:
 
   @param[in] pDimm Pointer to the DIMM
   @param[in] pDimmStr Dimm string to be used in result messages
-  @param[out] ppResult Pointer to the result string of quick diagnostics message
+  @param[in out] pResult Pointer to the quick diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the quick diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -186,7 +189,8 @@ EFI_STATUS
 SmartAndHealthCheck(
   IN     DIMM *pDimm,
   IN     CHAR16 *pDimmStr,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
 )
 {
@@ -205,7 +209,7 @@ SmartAndHealthCheck(
   ZeroMem(&HealthInfo, sizeof(HealthInfo));
   ZeroMem(&DimmInfo, sizeof(DimmInfo));
 
-  if (pDimm == NULL || pDimmStr == NULL || ppResultStr == NULL || pDiagState == NULL) {
+  if (pDimm == NULL || pDimmStr == NULL || pResult == NULL || pDiagState == NULL) {
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
     }
@@ -216,7 +220,7 @@ SmartAndHealthCheck(
   ReturnCode = GetSmartAndHealth(NULL, pDimm->DimmID, &HealthInfo);
   if (EFI_ERROR(ReturnCode)) {
     if (EFI_NO_RESPONSE == ReturnCode) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_FW_BUSY), EVENT_CODE_541, DIAG_STATE_MASK_OK, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_FW_BUSY), EVENT_CODE_541, DIAG_STATE_MASK_OK, pResult, SubTestIndex, pDiagState,
         pDimm->DeviceHandle.AsUint32);
       goto Finish;
     }
@@ -226,7 +230,7 @@ SmartAndHealthCheck(
   }
   if (HealthInfo.LatchedLastShutdownStatus) {
     // LatchedLastShutdownStatus != 0 - Dirty Shutdown
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_DIRTY_SHUTDOWN), EVENT_CODE_530, DIAG_STATE_MASK_OK, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_DIRTY_SHUTDOWN), EVENT_CODE_530, DIAG_STATE_MASK_OK, pResult, SubTestIndex, pDiagState,
       pDimm->DeviceHandle.AsUint32);
   }
 
@@ -256,7 +260,7 @@ SmartAndHealthCheck(
 
       pActualHealthStr = CatSPrintClean(pActualHealthStr, FORMAT_STR_WITH_PARANTHESIS, pActualHealthReasonStr);
     }
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BAD_HEALTH_STATE), EVENT_CODE_504, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BAD_HEALTH_STATE), EVENT_CODE_504, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
       pDimmStr, pActualHealthStr);
 
     FREE_POOL_SAFE(pActualHealthStr);
@@ -265,7 +269,7 @@ SmartAndHealthCheck(
   }
   else if ((pDimm->NvDimmStateFlags & BIT6) == BIT6) {
     // If BIT6 is set FW did not map a region to SPAon DIMM
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_ACPI_NVDIMM_SPA_NOT_MAPPED), EVENT_CODE_542, DIAG_STATE_MASK_OK, ppResultStr, pDiagState, pDimmStr);
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_ACPI_NVDIMM_SPA_NOT_MAPPED), EVENT_CODE_542, DIAG_STATE_MASK_OK, pResult, SubTestIndex, pDiagState, pDimmStr);
   }
 
   ReturnCode = GetDimm(&gNvmDimmData->NvmDimmConfig, pDimm->DimmID,
@@ -282,7 +286,7 @@ SmartAndHealthCheck(
 
   //Last Fw Update Status
   if (DimmInfo.LastFwUpdateStatus == FW_UPDATE_STATUS_FAILED) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_FW_LOAD_FAILED), EVENT_CODE_536, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_FW_LOAD_FAILED), EVENT_CODE_536, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
       pDimmStr);
   }
 
@@ -300,7 +304,7 @@ SmartAndHealthCheck(
   }
 
   if (FALSE != AlarmEnabled && HealthInfo.MediaTemperatureValid && HealthInfo.MediaTemperature > MediaTemperatureThreshold) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_MEDIA_TEMP_EXCEEDS_ALARM_THR), EVENT_CODE_505, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_MEDIA_TEMP_EXCEEDS_ALARM_THR), EVENT_CODE_505, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
       pDimmStr, HealthInfo.MediaTemperature, MediaTemperatureThreshold);
   }
 
@@ -317,7 +321,7 @@ SmartAndHealthCheck(
   }
 
   if (FALSE != AlarmEnabled && HealthInfo.ControllerTemperatureValid && HealthInfo.ControllerTemperature > ControllerTemperatureThreshold) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_CONTROLLER_TEMP_EXCEEDS_ALARM_THR), EVENT_CODE_511, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_CONTROLLER_TEMP_EXCEEDS_ALARM_THR), EVENT_CODE_511, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
       pDimmStr, HealthInfo.ControllerTemperature, ControllerTemperatureThreshold);
   }
 
@@ -334,24 +338,24 @@ SmartAndHealthCheck(
   }
 
   if (FALSE != AlarmEnabled && HealthInfo.PercentageRemainingValid && HealthInfo.PercentageRemaining < PercentageRemainingThreshold) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_SPARE_CAPACITY_BELOW_ALARM_THR), EVENT_CODE_506, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_SPARE_CAPACITY_BELOW_ALARM_THR), EVENT_CODE_506, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
       pDimmStr, HealthInfo.PercentageRemaining, PercentageRemainingThreshold);
   }
 
   //Package spare availability check
   if ((DimmInfo.PackageSparingCapable == PACKAGE_SPARING_CAPABLE) && (DimmInfo.PackageSparesAvailable == PACKAGE_SPARES_NOT_AVAILABLE)) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_NO_PACKAGE_SPARES_AVAILABLE), EVENT_CODE_529, DIAG_STATE_MASK_WARNING, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_NO_PACKAGE_SPARES_AVAILABLE), EVENT_CODE_529, DIAG_STATE_MASK_WARNING, pResult, SubTestIndex, pDiagState,
       pDimmStr);
   }
 
   //Viral state check
   if (DimmInfo.ViralStatus) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_VIRAL_STATE), EVENT_CODE_523, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState, pDimmStr);
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_VIRAL_STATE), EVENT_CODE_523, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState, pDimmStr);
   }
 
   //AIT DRAM disbaled check
   if (HealthInfo.AitDramEnabled == AIT_DRAM_DISABLED) {
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_AIT_DISABLED), EVENT_CODE_535, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState, pDimmStr);
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_AIT_DISABLED), EVENT_CODE_535, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState, pDimmStr);
   }
 
 Finish:
@@ -366,7 +370,8 @@ Finish:
 
   @param[in] pDimm Pointer to the DIMM
   @param[in] pDimmStr Dimm string to be used in result messages
-  @param[out] ppResult Pointer to the result string of quick diagnostics message
+  @param[in out] pResult Pointer to the quick diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the quick diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -377,7 +382,8 @@ EFI_STATUS
 BootStatusDiagnosticsCheck(
   IN     DIMM *pDimm,
   IN     CHAR16 *pDimmStr,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
 )
 {
@@ -393,7 +399,7 @@ BootStatusDiagnosticsCheck(
 
   ZeroMem(&Bsr, sizeof(Bsr));
 
-  if (pDimm == NULL || pDimmStr == NULL || ppResultStr == NULL || pDiagState == NULL) {
+  if (pDimm == NULL || pDimmStr == NULL || pResult == NULL || pDiagState == NULL) {
     if (pDiagState != NULL) {
       *pDiagState |= DIAG_STATE_MASK_ABORTED;
     }
@@ -425,24 +431,24 @@ BootStatusDiagnosticsCheck(
   if (EFI_ERROR(ReturnCode) || (BSRStatusBitmask & DIMM_BOOT_STATUS_UNKNOWN)) {
     ReturnCode = EFI_DEVICE_ERROR;
     NVDIMM_WARN("Unable to get the DIMMs BSR.");
-    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_NOT_READABLE), EVENT_CODE_513, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+    APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_NOT_READABLE), EVENT_CODE_513, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
       pDimmStr);
   }
   else {
     if (Bsr.Separated_Current_FIS.Major == DIMM_BSR_MAJOR_NO_POST_CODE) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_BIOS_POST_TRAINING_FAILED), EVENT_CODE_519, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_BIOS_POST_TRAINING_FAILED), EVENT_CODE_519, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr);
     }
     else if (Bsr.Separated_Current_FIS.Major == DIMM_BSR_MAJOR_CHECKPOINT_INIT_FAILURE) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_FW_NOT_INITIALIZED), EVENT_CODE_520, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_FW_NOT_INITIALIZED), EVENT_CODE_520, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr, Bsr.Separated_Current_FIS.Major, Bsr.Separated_Current_FIS.Minor);
     }
     else if (Bsr.Separated_Current_FIS.Major == DIMM_BSR_MAJOR_CHECKPOINT_CPU_EXCEPTION) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_CPU_EXCEPTION), EVENT_CODE_537, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_CPU_EXCEPTION), EVENT_CODE_537, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr, Bsr.Separated_Current_FIS.Major, Bsr.Separated_Current_FIS.Minor);
     }
     if (Bsr.Separated_Current_FIS.DT == DIMM_BSR_DDRT_IO_INIT_NOT_STARTED) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_DDRT_IO_NOT_STARTED), EVENT_CODE_544, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_DDRT_IO_NOT_STARTED), EVENT_CODE_544, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr);
     }
     GetDdrtIoInitInfo(NULL, pDimm->DimmID, &DdrtTrainingStatus);
@@ -451,37 +457,37 @@ BootStatusDiagnosticsCheck(
     }
     if ((!FIS_GTE_2_01 && DdrtTrainingStatus != DDRT_TRAINING_COMPLETE && DdrtTrainingStatus != DDRT_S3_COMPLETE)
       || (FIS_GTE_2_01 && DdrtTrainingStatus != DDRT_TRAINING_COMPLETE && DdrtTrainingStatus != DDRT_S3_COMPLETE && DdrtTrainingStatus != NORMAL_MODE_COMPLETE)) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_DDRT_IO_NOT_COMPLETE), EVENT_CODE_538, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_DDRT_IO_NOT_COMPLETE), EVENT_CODE_538, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr);
     }
     if (Bsr.Separated_Current_FIS.MBR == DIMM_BSR_MAILBOX_NOT_READY) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_MAILBOX_NOT_READY), EVENT_CODE_539, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_MAILBOX_NOT_READY), EVENT_CODE_539, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr);
     }
     if (Bsr.Separated_Current_FIS.DR != DIMM_BSR_AIT_DRAM_TRAINED_LOADED_READY) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_AIT_DRAM_NOT_READY), EVENT_CODE_533, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_AIT_DRAM_NOT_READY), EVENT_CODE_533, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr);
     }
     if (FIS_GTE_1_14) {
       if ((Bsr.Separated_Current_FIS.DTS == DDRT_TRAINING_NOT_COMPLETE) ||
         (Bsr.Separated_Current_FIS.DTS == DDRT_TRAINING_FAILURE)) {
-        APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_DDRT_TRAINING_NOT_COMPLETE_FAILED), EVENT_CODE_543, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+        APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_DDRT_TRAINING_NOT_COMPLETE_FAILED), EVENT_CODE_543, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
           pDimmStr);
       }
     }
     if (Bsr.Separated_Current_FIS.MR == DIMM_BSR_MEDIA_NOT_TRAINED) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_MEDIA_NOT_READY), EVENT_CODE_514, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_MEDIA_NOT_READY), EVENT_CODE_514, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr);
     }
     if (Bsr.Separated_Current_FIS.MR == DIMM_BSR_MEDIA_ERROR) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_MEDIA_ERROR), EVENT_CODE_515, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState, pDimmStr);
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_MEDIA_ERROR), EVENT_CODE_515, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState, pDimmStr);
     }
     if (Bsr.Separated_Current_FIS.MD == DIMM_BSR_MEDIA_DISABLED) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_MEDIA_DISABLED), EVENT_CODE_534, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_MEDIA_DISABLED), EVENT_CODE_534, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr);
     }
     if (Bsr.Separated_Current_FIS.RR == DIMM_BSR_REBOOT_REQUIRED) {
-      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_REBOOT_REQUIRED), EVENT_CODE_507, DIAG_STATE_MASK_FAILED, ppResultStr, pDiagState,
+      APPEND_RESULT_TO_THE_LOG(pDimm, STRING_TOKEN(STR_QUICK_BSR_REBOOT_REQUIRED), EVENT_CODE_507, DIAG_STATE_MASK_FAILED, pResult, SubTestIndex, pDiagState,
         pDimmStr);
     }
   }
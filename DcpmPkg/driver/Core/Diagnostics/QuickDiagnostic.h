@@ -36,7 +36,8 @@ RunQuickDiagnostics(
 
   @param[in] pDimm Pointer to the DIMM
   @param[in] pDimmStr Dimm string to be used in result messages
-  @param[out] ppResult Pointer to the result string of quick diagnostics message
+  @param[in out] pResult Pointer to the quick diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the quick diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -46,7 +47,8 @@ EFI_STATUS
 DiagnosticsManageabilityCheck(
   IN     DIMM *pDimm,
   IN     CHAR16 *pDimmStr,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
   );
 
@@ -57,7 +59,8 @@ DiagnosticsManageabilityCheck(
 
   @param[in] pDimm Pointer to the DIMM
   @param[in] pDimmStr Dimm string to be used in result messages
-  @param[out] ppResult Pointer to the result string of quick diagnostics message
+  @param[in out] pResult Pointer to the quick diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the quick diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -67,7 +70,8 @@ EFI_STATUS
 SmartAndHealthCheck(
   IN     DIMM *pDimm,
   IN     CHAR16 *pDimmStr,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
   );
 
@@ -78,7 +82,8 @@ SmartAndHealthCheck(
 
   @param[in] pDimm Pointer to the DIMM
   @param[in] pDimmStr Dimm string to be used in result messages
-  @param[out] ppResult Pointer to the result string of quick diagnostics message
+  @param[in out] pResult Pointer to the quick diagnostics results
+  @param[in] SubTestIndex Subtest the events are reported for
   @param[out] pDiagState Pointer to the quick diagnostics test state
 
   @retval EFI_SUCCESS Test executed correctly
@@ -89,7 +94,8 @@ EFI_STATUS
 BootStatusDiagnosticsCheck(
   IN     DIMM *pDimm,
   IN     CHAR16 *pDimmStr,
-  IN OUT CHAR16 **ppResultStr,
+  IN OUT DIAG_INFO *pResult,
+  IN     UINT8 SubTestIndex,
   IN OUT UINT8 *pDiagState
   );
 #endif
@@ -51,7 +51,7 @@ RunSecurityDiagnostics(
   if (DimmCount == 0 || ppDimms == NULL) {
     ReturnCode = EFI_SUCCESS;
     APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_SECURITY_NO_MANAGEABLE_DIMMS), EVENT_CODE_801, DIAG_STATE_MASK_OK,
-      &pResult->Message, &pResult->StateVal);
+      pResult, DIAG_NO_SUBTEST, &pResult->StateVal);
     goto Finish;
   }
 
@@ -61,13 +61,13 @@ RunSecurityDiagnostics(
     if (ppDimms[Index] == NULL) {
       ReturnCode = EFI_INVALID_PARAMETER;
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_SECURITY_ABORTED_INTERNAL_ERROR), EVENT_CODE_805, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[ENCRYPTION_TEST_INDEX], &pResult->SubTestStateVal[ENCRYPTION_TEST_INDEX]);
+        pResult, ENCRYPTION_TEST_INDEX, &pResult->SubTestStateVal[ENCRYPTION_TEST_INDEX]);
       goto Finish;
     }
 
     if (ppDimms[Index]->SkuInformation.EncryptionEnabled == MODE_DISABLED) {
       APPEND_RESULT_TO_THE_LOG(ppDimms[Index], STRING_TOKEN(STR_SECURITY_NOT_SUPPORTED), EVENT_CODE_804, DIAG_STATE_MASK_OK,
-        &pResult->SubTestMessage[ENCRYPTION_TEST_INDEX], &pResult->SubTestStateVal[ENCRYPTION_TEST_INDEX]);
+        pResult, ENCRYPTION_TEST_INDEX, &pResult->SubTestStateVal[ENCRYPTION_TEST_INDEX]);
     }
 
     ReturnCode = GetDimmSecurityState(
@@ -77,7 +77,7 @@ RunSecurityDiagnostics(
     if (EFI_ERROR(ReturnCode)) {
       NVDIMM_DBG("Failed on GetDimmSecurityState of DIMM ID 0x%x", ppDimms[Index]->DeviceHandle.AsUint32);
       APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_SECURITY_ABORTED_INTERNAL_ERROR), EVENT_CODE_805, DIAG_STATE_MASK_ABORTED,
-        &pResult->SubTestMessage[INCONSISTANCY_TEST_INDEX], &pResult->SubTestStateVal[INCONSISTANCY_TEST_INDEX]);
+        pResult, INCONSISTANCY_TEST_INDEX, &pResult->SubTestStateVal[INCONSISTANCY_TEST_INDEX]);
       goto Finish;
     }
     ConvertSecurityBitmask(SecurityFlag, &DimmSecurityState);
@@ -98,7 +98,7 @@ RunSecurityDiagnostics(
 
   if (InconsistencyFlag) {
     APPEND_RESULT_TO_THE_LOG(NULL, STRING_TOKEN(STR_SECURITY_INCONSISTENT), EVENT_CODE_802, DIAG_STATE_MASK_WARNING,
-      &pResult->SubTestMessage[INCONSISTANCY_TEST_INDEX], &pResult->SubTestStateVal[INCONSISTANCY_TEST_INDEX], pInconsistentSecurityStatesStr);
+      pResult, INCONSISTANCY_TEST_INDEX, &pResult->SubTestStateVal[INCONSISTANCY_TEST_INDEX], pInconsistentSecurityStatesStr);
   }
 
   ReturnCode = EFI_SUCCESS;
@@ -17,23 +17,36 @@
 #include "AsmCommands.h"
 #include <NvmWorkarounds.h>
 #include <Convert.h>
+#include <HashIndex.h>
 #include <NvmDimmDriver.h>
 #ifdef OS_BUILD
 #include <os_types.h>
 #include <Common.h>
+#include <os.h>
+#include <Pbr.h>
+#include <PbrDcpmm.h>
+#include <os_efi_api.h>
 #endif
 
 #ifndef OS_BUILD
 #include "Smbus.h"
 #endif
 
-#define SMBIOS_TYPE_MEM_DEV             17
-#define SMBIOS_TYPE_MEM_DEV_MAPPED_ADDR 20
 #ifdef PCD_CACHE_ENABLED
 int gPCDCacheEnabled = 1;
 #else
 int gPCDCacheEnabled = 0;
 #endif
+/** Bumped by every PCD writer, a cache filled at an older generation is stale **/
+UINT32 gPcdCacheGeneration = 1;
+#ifdef OS_BUILD
+/** Serializes the bumps of gPcdCacheGeneration made by RunOnDimms workers **/
+STATIC OS_MUTEX *gpPcdCacheGenerationLock = NULL;
+#endif
+/** Bumped on every API entry, the cached PCD OEM data is probed once per epoch **/
+UINT32 gPcdCacheProbeEpoch = 1;
+/** Bumped once per invocation, a SMART snapshot taken at an older epoch is stale **/
+UINT32 gSmartSnapshotEpoch = 1;
 extern NVMDIMMDRIVER_DATA *gNvmDimmData;
 CONST UINT64 gSupportedBlockSizes[SUPPORTED_BLOCK_SIZES_COUNT] = {
   512,  //  512 (default)
@@ -108,6 +121,33 @@ BOOLEAN ConfigIsDdrtProtocolDisabled()
 
   return (BOOLEAN)ddrt_protocol_disabled;
 }
+
+/*
+* Function get the ini configuration only on the first call
+*
+* It returns the time in milliseconds a SMART snapshot is kept, 0 to keep it
+* for one invocation
+*/
+UINT32 ConfigSmartSnapshotTtlMs()
+{
+  static BOOLEAN config_smart_snapshot_ttl_initialized = FALSE;
+  static UINT32 smart_snapshot_ttl_ms = 0;
+  EFI_STATUS efi_status;
+  EFI_GUID guid = { 0 };
+  UINTN size;
+
+  if (config_smart_snapshot_ttl_initialized)
+    return smart_snapshot_ttl_ms;
+
+  size = sizeof(smart_snapshot_ttl_ms);
+  efi_status = GET_VARIABLE(INI_PREFERENCES_SMART_SNAPSHOT_TTL_MS, guid, &size, &smart_snapshot_ttl_ms);
+  if (EFI_SUCCESS != efi_status)
+    smart_snapshot_ttl_ms = 0;
+
+  config_smart_snapshot_ttl_initialized = TRUE;
+
+  return smart_snapshot_ttl_ms;
+}
 #endif // OS_BUILD
 
 /**
@@ -171,6 +211,174 @@ InitializeCpuCommands(
 
 STATIC EFI_STATUS PollOnArsDeviceBusy(IN DIMM *pDimm, IN UINT32 TimeoutSecs);
 
+/**
+  Hash indexes of the DIMM inventory list
+
+  The tables are rebuilt whenever the inventory changes and every hit is
+  verified against the DIMM fields, so a stale index only costs a fallback
+  scan of the list.
+**/
+typedef struct {
+  LIST_ENTRY *pDimms;           //!< Indexed list, NULL when there is no index
+  HASH_INDEX ByPid;
+  HASH_INDEX ByHandle;
+  HASH_INDEX BySerialNumber;    //!< Also used for lookups by unique identifier
+} DIMM_INDEX;
+
+STATIC DIMM_INDEX gDimmIndex;
+
+/**
+  Free the DIMM index
+**/
+STATIC
+VOID
+FreeDimmIndex(
+  )
+{
+  HashIndexFree(&gDimmIndex.ByPid);
+  HashIndexFree(&gDimmIndex.ByHandle);
+  HashIndexFree(&gDimmIndex.BySerialNumber);
+  gDimmIndex.pDimms = NULL;
+}
+
+/**
+  Build the hash indexes of a DIMM list
+
+  When the memory allocation fails the list is left without an index and the
+  lookups scan it.
+
+  @param[in] pDimms The head of the dimm list
+**/
+STATIC
+VOID
+BuildDimmIndex(
+  IN     LIST_ENTRY *pDimms
+  )
+{
+  DIMM *pCurDimm = NULL;
+  LIST_ENTRY *pCurDimmNode = NULL;
+  UINT32 DimmsNum = 0;
+
+  FreeDimmIndex();
+
+  LIST_FOR_EACH(pCurDimmNode, pDimms) {
+    DimmsNum++;
+  }
+
+  if (DimmsNum == 0) {
+    return;
+  }
+
+  if (EFI_ERROR(HashIndexInit(&gDimmIndex.ByPid, DimmsNum)) ||
+      EFI_ERROR(HashIndexInit(&gDimmIndex.ByHandle, DimmsNum)) ||
+      EFI_ERROR(HashIndexInit(&gDimmIndex.BySerialNumber, DimmsNum))) {
+    NVDIMM_WARN("Failed to allocate the DIMM index, lookups will scan the list");
+    FreeDimmIndex();
+    return;
+  }
+
+  // Inserting in list order keeps the first matching DIMM of the list first in a probe sequence
+  LIST_FOR_EACH(pCurDimmNode, pDimms) {
+    pCurDimm = DIMM_FROM_NODE(pCurDimmNode);
+    HashIndexInsert(&gDimmIndex.ByPid, HashUint32(pCurDimm->DimmID), pCurDimm);
+    HashIndexInsert(&gDimmIndex.ByHandle, HashUint32(pCurDimm->DeviceHandle.AsUint32), pCurDimm);
+    HashIndexInsert(&gDimmIndex.BySerialNumber, HashUint32(pCurDimm->SerialNumber), pCurDimm);
+  }
+  gDimmIndex.pDimms = pDimms;
+}
+
+/**
+  Check if the DIMM of the index has the looked up PID
+
+  @param[in] pItem DIMM found in the index
+  @param[in] pKey Pointer to the PID
+
+  @retval TRUE if the DIMM matches
+**/
+STATIC
+BOOLEAN
+IsDimmPidMatching(
+  IN     VOID *pItem,
+  IN     CONST VOID *pKey
+  )
+{
+  return ((DIMM *)pItem)->DimmID == *(CONST UINT32 *)pKey;
+}
+
+/**
+  Check if the DIMM of the index has the looked up device handle
+
+  @param[in] pItem DIMM found in the index
+  @param[in] pKey Pointer to the device handle
+
+  @retval TRUE if the DIMM matches
+**/
+STATIC
+BOOLEAN
+IsDimmHandleMatching(
+  IN     VOID *pItem,
+  IN     CONST VOID *pKey
+  )
+{
+  return ((DIMM *)pItem)->DeviceHandle.AsUint32 == *(CONST UINT32 *)pKey;
+}
+
+/**
+  Check if the DIMM of the index has the looked up serial number
+
+  @param[in] pItem DIMM found in the index
+  @param[in] pKey Pointer to the serial number
+
+  @retval TRUE if the DIMM matches
+**/
+STATIC
+BOOLEAN
+IsDimmSerialNumberMatching(
+  IN     VOID *pItem,
+  IN     CONST VOID *pKey
+  )
+{
+  return ((DIMM *)pItem)->SerialNumber == *(CONST UINT32 *)pKey;
+}
+
+/**
+  Check if the DIMM matches the unique identifier
+
+  @param[in] pDimm DIMM to check
+  @param[in] pDimmUniqueId The unique identifier structure of the dimm
+
+  @retval TRUE if the DIMM matches
+**/
+STATIC
+BOOLEAN
+IsDimmUniqueIdentifierMatching(
+  IN     DIMM *pDimm,
+  IN     DIMM_UNIQUE_IDENTIFIER *pDimmUniqueId
+  )
+{
+  return (pDimm->VendorId == pDimmUniqueId->ManufacturerId) && (pDimm->SerialNumber == pDimmUniqueId->SerialNumber) &&
+      (pDimm->ManufacturingInfoValid ? ((pDimm->ManufacturingLocation == pDimmUniqueId->ManufacturingLocation) &&
+                                        (pDimm->ManufacturingDate == pDimmUniqueId->ManufacturingDate)) : TRUE);
+}
+
+/**
+  Check if the DIMM of the index matches the looked up unique identifier
+
+  @param[in] pItem DIMM found in the index
+  @param[in] pKey Pointer to the unique identifier structure
+
+  @retval TRUE if the DIMM matches
+**/
+STATIC
+BOOLEAN
+IsDimmUniqueIdentifierIndexMatching(
+  IN     VOID *pItem,
+  IN     CONST VOID *pKey
+  )
+{
+  return IsDimmUniqueIdentifierMatching((DIMM *)pItem, (DIMM_UNIQUE_IDENTIFIER *)pKey);
+}
+
 /**
   Get dimm by Dimm ID
   Scan the dimm list for a dimm identified by Dimm ID
@@ -192,6 +400,13 @@ GetDimmByPid(
   LIST_ENTRY *pCurDimmNode = NULL;
 
   NVDIMM_ENTRY();
+  if (pDimms != NULL && pDimms == gDimmIndex.pDimms) {
+    pTargetDimm = HashIndexFind(&gDimmIndex.ByPid, HashUint32(DimmID), IsDimmPidMatching, &DimmID);
+    if (pTargetDimm != NULL) {
+      goto Finish;
+    }
+  }
+
   for (pCurDimmNode = GetFirstNode(pDimms);
       !IsNull(pDimms, pCurDimmNode);
       pCurDimmNode = GetNextNode(pDimms, pCurDimmNode)) {
@@ -204,6 +419,7 @@ GetDimmByPid(
     }
   }
 
+Finish:
   NVDIMM_EXIT();
   return pTargetDimm;
 }
@@ -228,6 +444,13 @@ GetDimmByHandle(
   DIMM *pTargetDimm = NULL;
   LIST_ENTRY *pCurDimmNode = NULL;
   NVDIMM_ENTRY();
+  if (pDimms != NULL && pDimms == gDimmIndex.pDimms) {
+    pTargetDimm = HashIndexFind(&gDimmIndex.ByHandle, HashUint32(DeviceHandle), IsDimmHandleMatching, &DeviceHandle);
+    if (pTargetDimm != NULL) {
+      goto Finish;
+    }
+  }
+
   for (pCurDimmNode = GetFirstNode(pDimms);
       !IsNull(pDimms, pCurDimmNode);
       pCurDimmNode = GetNextNode(pDimms, pCurDimmNode)) {
@@ -239,6 +462,7 @@ GetDimmByHandle(
       break;
     }
   }
+Finish:
   NVDIMM_EXIT();
   return pTargetDimm;
 }
@@ -263,6 +487,13 @@ GetDimmBySerialNumber(
 
   NVDIMM_ENTRY();
 
+  if (pDimms != NULL && pDimms == gDimmIndex.pDimms) {
+    pTargetDimm = HashIndexFind(&gDimmIndex.BySerialNumber, HashUint32(SerialNumber), IsDimmSerialNumberMatching, &SerialNumber);
+    if (pTargetDimm != NULL) {
+      goto Finish;
+    }
+  }
+
   LIST_FOR_EACH(pCurDimmNode, pDimms) {
     pCurDimm = DIMM_FROM_NODE(pCurDimmNode);
 
@@ -272,6 +503,7 @@ GetDimmBySerialNumber(
     }
   }
 
+Finish:
   NVDIMM_EXIT();
   return pTargetDimm;
 }
@@ -299,17 +531,25 @@ GetDimmByUniqueIdentifier(
 
   NVDIMM_ENTRY();
 
+  // The unique identifier contains the serial number, so the serial number table is searched
+  if (pDimms != NULL && pDimms == gDimmIndex.pDimms) {
+    pTargetDimm = HashIndexFind(&gDimmIndex.BySerialNumber, HashUint32(DimmUniqueId.SerialNumber),
+        IsDimmUniqueIdentifierIndexMatching, &DimmUniqueId);
+    if (pTargetDimm != NULL) {
+      goto Finish;
+    }
+  }
+
   LIST_FOR_EACH(pCurDimmNode, pDimms) {
     pCurDimm = DIMM_FROM_NODE(pCurDimmNode);
 
-    if ((pCurDimm->VendorId == DimmUniqueId.ManufacturerId) && (pCurDimm->SerialNumber == DimmUniqueId.SerialNumber) &&
-        (pCurDimm->ManufacturingInfoValid ? ((pCurDimm->ManufacturingLocation == DimmUniqueId.ManufacturingLocation) &&
-                                             (pCurDimm->ManufacturingDate == DimmUniqueId.ManufacturingDate)): TRUE)) {
+    if (IsDimmUniqueIdentifierMatching(pCurDimm, &DimmUniqueId)) {
       pTargetDimm = pCurDimm;
       break;
     }
   }
 
+Finish:
   NVDIMM_EXIT();
   return pTargetDimm;
 }
@@ -1080,6 +1320,10 @@ RemoveDimmInventory(
   EFI_STATUS TmpReturnCode = EFI_SUCCESS;
 
   NVDIMM_ENTRY();
+  if (gDimmIndex.pDimms == &pDev->Dimms) {
+    FreeDimmIndex();
+  }
+
   for (pCurDimmNode = GetFirstNode(&pDev->Dimms);
       !IsNull(&pDev->Dimms, pCurDimmNode) && pCurDimmNode != NULL;
       pCurDimmNode = pTempDimmNode) {
@@ -1243,6 +1487,10 @@ InitializeDimmInventory(
 
     // Create a new dimm struct for every NVDIMM, functional or not
     CHECK_RESULT_MALLOC(pNewDimm,(DIMM *) AllocateZeroPool(sizeof(*pNewDimm)), Finish);
+#ifdef OS_BUILD
+    // Without the lock the FW commands of the DIMM are not ordered
+    pNewDimm->pFwCmdOrderLock = os_mutex_init(NULL);
+#endif
 
     // Assume dimm is functional
     pNewDimm->NonFunctional = FALSE;
@@ -1267,6 +1515,8 @@ ErrorInitializeDimm:
 
   ReturnCode = EFI_SUCCESS;
 Finish:
+  // The DIMM fields the index is keyed on are only known once the DIMMs are initialized
+  BuildDimmIndex(&pDev->Dimms);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1299,7 +1549,7 @@ FwCmdGetViralPolicy(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
 
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -1322,7 +1572,7 @@ FwCmdGetViralPolicy(
   CopyMem_S(pViralPolicyPayload, sizeof(*pViralPolicyPayload), pFwCmd->OutPayload, sizeof(*pViralPolicyPayload));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1346,7 +1596,7 @@ FwCmdGetOptionalConfigurationDataPolicy(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -1370,7 +1620,7 @@ FwCmdGetOptionalConfigurationDataPolicy(
   pOptionalDataPolicyPayload->FisMinor = pDimm->FwVer.FwApiMinor;
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1394,7 +1644,7 @@ FwCmdSetOptionalConfigurationDataPolicy(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
 
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -1417,7 +1667,7 @@ FwCmdSetOptionalConfigurationDataPolicy(
   }
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1444,7 +1694,7 @@ FwCmdGetSecurityInfo(
   EFI_STATUS ReturnCode = EFI_SUCCESS;
 
   NVDIMM_ENTRY();
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
 
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -1466,7 +1716,7 @@ FwCmdGetSecurityInfo(
   CopyMem_S(pSecurityPayload, sizeof(*pSecurityPayload), pFwCmd->OutPayload, sizeof(*pSecurityPayload));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1537,7 +1787,7 @@ FwCmdGetSecurityOptIn(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
 
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -1571,7 +1821,7 @@ FwCmdGetSecurityOptIn(
   }
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1602,7 +1852,7 @@ FwCmdDisableARS(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -1629,7 +1879,7 @@ FwCmdDisableARS(
   NVDIMM_DBG("Finished polling long op, return val = %x", ReturnCode);
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1663,7 +1913,7 @@ FwCmdGetARS(
   }
 
   *pDimmARSStatus = ARS_STATUS_UNKNOWN;
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -1688,8 +1938,17 @@ FwCmdGetARS(
     goto Finish;
   }
 
+#ifndef OS_BUILD
+  // A scrub that started or ended may have changed the BIOS bad address list
+  if ((pDimm->ArsStatus != ARS_STATUS_UNKNOWN && pDimm->ArsStatus != *pDimmARSStatus) ||
+      (IsArsListPartial() && *pDimmARSStatus != ARS_STATUS_IN_PROGRESS)) {
+    InvalidateArsList();
+  }
+#endif
+  pDimm->ArsStatus = *pDimmARSStatus;
+
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1766,7 +2025,7 @@ FwCmdIdDimm (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
 
   if (!pFwCmd) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -1788,7 +2047,7 @@ FwCmdIdDimm (
   CopyMem_S(pPayload, sizeof(*pPayload), pFwCmd->OutPayload, sizeof(*pPayload));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
 
   return ReturnCode;
@@ -1820,7 +2079,7 @@ FwCmdDeviceCharacteristics (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -1853,7 +2112,7 @@ Finish:
   if (EFI_ERROR(ReturnCode) && (NULL != ppPayload)) {
     FREE_POOL_SAFE(*ppPayload);
   }
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1884,7 +2143,7 @@ FwCmdGetDimmPartitionInfo(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -1905,7 +2164,7 @@ FwCmdGetDimmPartitionInfo(
   CopyMem_S(pPayload, sizeof(*pPayload), pFwCmd->OutPayload, sizeof(*pPayload));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -1991,7 +2250,7 @@ FwGetPCDFromOffsetSmallPayload(
     }
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -2023,7 +2282,7 @@ FwGetPCDFromOffsetSmallPayload(
   }
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   return ReturnCode;
 }
 /**
@@ -2065,7 +2324,7 @@ FwCmdGetPcdLargePayload(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -2081,8 +2340,9 @@ FwCmdGetPcdLargePayload(
   InputPayload.CmdOptions.RetrieveOption = PCD_CMD_OPT_PARTITION_DATA;
   pFwCmd->InputPayloadSize = sizeof(InputPayload);
 
-  /** Get PCD by large payload in single call **/
+  /** Get PCD by large payload in single call, straight into the caller buffer **/
   pFwCmd->LargeOutputPayloadSize = PCD_PARTITION_SIZE;
+  pFwCmd->pLargeOutputBuffer = *ppRawData;
   InputPayload.Offset = 0;
   InputPayload.CmdOptions.PayloadType = PCD_CMD_OPT_LARGE_PAYLOAD;
 
@@ -2097,10 +2357,9 @@ FwCmdGetPcdLargePayload(
     FW_CMD_ERROR_TO_EFI_STATUS(pFwCmd, ReturnCode);
     goto Finish;
   }
-  CopyMem_S(*ppRawData, PCD_PARTITION_SIZE, pFwCmd->LargeOutputPayload, PCD_PARTITION_SIZE);
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -2182,13 +2441,14 @@ FwCmdGetPlatformConfigData(
   }
 
   if (gPCDCacheEnabled) {
-    if (pDimm->pPcdLsa && PartitionId == PCD_LSA_PARTITION_ID) {
+    if (pDimm->pPcdLsa && PartitionId == PCD_LSA_PARTITION_ID &&
+        pDimm->PcdLsaCacheGeneration == gPcdCacheGeneration) {
       CopyMem_S(*ppRawData, PcdSize, pDimm->pPcdLsa, PcdSize);
       goto Finish;
     }
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -2235,8 +2495,9 @@ FwCmdGetPlatformConfigData(
     gPCDCacheEnabled = 1;
 #endif
   } else {
-    /** Get PCD by large payload in single call **/
+    /** Get PCD by large payload in single call, straight into the caller buffer **/
     pFwCmd->LargeOutputPayloadSize = PcdSize;
+    pFwCmd->pLargeOutputBuffer = *ppRawData;
     InputPayload.Offset = 0;
     InputPayload.CmdOptions.PayloadType = PCD_CMD_OPT_LARGE_PAYLOAD;
     if (pFwCmd->InputPayloadSize > IN_PAYLOAD_SIZE) {
@@ -2262,9 +2523,12 @@ FwCmdGetPlatformConfigData(
     UINTN pTempCacheSz = 0;
 
     if (PartitionId == PCD_LSA_PARTITION_ID) {
-      pDimm->pPcdLsa = AllocateZeroPool(pDimm->PcdLsaPartitionSize);
+      if (NULL == pDimm->pPcdLsa) {
+        pDimm->pPcdLsa = AllocateZeroPool(pDimm->PcdLsaPartitionSize);
+      }
       pTempCache = pDimm->pPcdLsa;
       pTempCacheSz = pDimm->PcdLsaPartitionSize;
+      pDimm->PcdLsaCacheGeneration = gPcdCacheGeneration;
     }
 
     if (!LargePayloadAvailable) {
@@ -2274,22 +2538,17 @@ FwCmdGetPlatformConfigData(
       if (NULL != pTempCache) {
         CopyMem_S(pTempCache, pTempCacheSz, pBuffer, PcdSize);
       }
-    } else {
-      CopyMem_S(*ppRawData, PcdSize, pFwCmd->LargeOutputPayload, PcdSize);
-      if (NULL != pTempCache) {
-        CopyMem_S(pTempCache, pTempCacheSz, pFwCmd->LargeOutputPayload, PcdSize);
-      }
+    } else if (NULL != pTempCache) {
+      CopyMem_S(pTempCache, pTempCacheSz, *ppRawData, PcdSize);
     }
     goto Finish;
   }
   if (!LargePayloadAvailable) {
     CHECK_NOT_TRUE((NULL != *ppRawData && NULL != pBuffer), Finish);
     CopyMem_S(*ppRawData, PcdSize, pBuffer, PcdSize);
-  } else {
-    CopyMem_S(*ppRawData, PcdSize, pFwCmd->LargeOutputPayload, PcdSize);
   }
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   FREE_POOL_SAFE(pBuffer);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -2328,7 +2587,7 @@ FwCmdGetPlatformConfigDataSize (
   ZeroMem(&InputPayload, sizeof(InputPayload));
   ZeroMem(&OutputPcdSize, sizeof(OutputPcdSize));
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -2359,7 +2618,7 @@ FwCmdGetPlatformConfigDataSize (
   *pPcdSize = OutputPcdSize.Size;
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -2526,7 +2785,7 @@ FwCmdGetPcdSmallPayload(
   if (gPCDCacheEnabled && pDimm->PcdOemPartitionSize == 0) {
     gPCDCacheEnabled = 0;
   }
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -2559,11 +2818,82 @@ FwCmdGetPcdSmallPayload(
   CopyMem_S(pData, DataSize, pFwCmd->OutPayload, DataSize);
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
 
+/**
+Check if the cached PCD OEM config data still matches the DIMM
+
+The cache is stale once a PCD writer bumped the generation. Once per probe
+epoch the configuration header and the headers of the current config,
+config input and config output tables are read back and compared with the
+cache, which catches a goal written or processed outside of this library
+for a handful of small payload reads instead of the whole config data.
+
+@param[in] pDimm The Intel NVM Dimm the cache belongs to
+
+@retval TRUE the cached data can be used
+@retval FALSE the config data has to be read again
+**/
+STATIC
+BOOLEAN
+IsPcdOemCacheCurrent(
+  IN     DIMM *pDimm
+)
+{
+  NVDIMM_CONFIGURATION_HEADER *pCachedHeader = NULL;
+  UINT8 Block[PCD_GET_SMALL_PAYLOAD_DATA_SIZE];
+  UINT32 TableOffsets[3];
+  UINT32 TableSizes[3];
+  UINT32 CompareSize = 0;
+  UINT32 Index = 0;
+
+  if (pDimm->PcdOemCacheGeneration != gPcdCacheGeneration ||
+      pDimm->PcdOemSize < sizeof(NVDIMM_CONFIGURATION_HEADER)) {
+    return FALSE;
+  }
+
+  if (pDimm->PcdOemProbeEpoch == gPcdCacheProbeEpoch) {
+    return TRUE;
+  }
+
+  // The configuration header with the location of each table
+  CompareSize = MIN(pDimm->PcdOemSize, PCD_GET_SMALL_PAYLOAD_DATA_SIZE);
+  if (EFI_ERROR(FwCmdGetPcdSmallPayload(pDimm, PCD_OEM_PARTITION_ID, 0, Block, sizeof(Block))) ||
+      CompareMem(Block, pDimm->pPcdOem, CompareSize) != 0) {
+    return FALSE;
+  }
+
+  // The table headers carry the table checksum and the config input/output sequence number
+  pCachedHeader = (NVDIMM_CONFIGURATION_HEADER *) pDimm->pPcdOem;
+  TableOffsets[0] = pCachedHeader->CurrentConfStartOffset;
+  TableSizes[0] = pCachedHeader->CurrentConfDataSize;
+  TableOffsets[1] = pCachedHeader->ConfInputStartOffset;
+  TableSizes[1] = pCachedHeader->ConfInputDataSize;
+  TableOffsets[2] = pCachedHeader->ConfOutputStartOffset;
+  TableSizes[2] = pCachedHeader->ConfOutputDataSize;
+  CompareSize = sizeof(TABLE_HEADER) + sizeof(UINT32);
+
+  for (Index = 0; Index < ARRAY_SIZE(TableOffsets); Index++) {
+    if (TableSizes[Index] == 0 || TableOffsets[Index] < PCD_GET_SMALL_PAYLOAD_DATA_SIZE) {
+      continue;
+    }
+    if ((UINT64) TableOffsets[Index] + CompareSize > pDimm->PcdOemSize ||
+        (UINT64) TableOffsets[Index] + PCD_GET_SMALL_PAYLOAD_DATA_SIZE > PCD_PARTITION_SIZE) {
+      return FALSE;
+    }
+    if (EFI_ERROR(FwCmdGetPcdSmallPayload(pDimm, PCD_OEM_PARTITION_ID, TableOffsets[Index], Block, (UINT8) CompareSize)) ||
+        CompareMem(Block, (UINT8 *) pDimm->pPcdOem + TableOffsets[Index], CompareSize) != 0) {
+      return FALSE;
+    }
+  }
+
+  pDimm->PcdOemProbeEpoch = gPcdCacheProbeEpoch;
+  return TRUE;
+}
+
 /**
 Firmware command get Platform Config Data via small payload only.
 For OEM Config Data, small payload via ASL is faster than large payload via SMM.
@@ -2605,7 +2935,7 @@ GetPcdOemConfigDataUsingSmallPayload(
   }
 
   // Return the cached data
-  if (gPCDCacheEnabled && pDimm->pPcdOem) {
+  if (gPCDCacheEnabled && pDimm->pPcdOem && IsPcdOemCacheCurrent(pDimm)) {
     *ppRawData = AllocateZeroPool(pDimm->PcdOemSize);
     if (*ppRawData == NULL) {
       NVDIMM_WARN("Can't allocate memory for Platform Config Data (%d bytes)", pDimm->PcdOemSize);
@@ -2674,10 +3004,14 @@ GetPcdOemConfigDataUsingSmallPayload(
 
     // Save data cache info
     pDimm->PcdOemSize = OemDataSize;
-    pDimm->pPcdOem = AllocateZeroPool(PCD_OEM_PARTITION_INTEL_CFG_REGION_SIZE);
+    if (NULL == pDimm->pPcdOem) {
+      pDimm->pPcdOem = AllocateZeroPool(PCD_OEM_PARTITION_INTEL_CFG_REGION_SIZE);
+    }
     pTempCache = pDimm->pPcdOem;
     if ((NULL != pTempCache) && (OemDataSize <= PCD_OEM_PARTITION_INTEL_CFG_REGION_SIZE)) {
       CopyMem_S(pTempCache, PCD_OEM_PARTITION_INTEL_CFG_REGION_SIZE, pBuffer, OemDataSize);
+      pDimm->PcdOemCacheGeneration = gPcdCacheGeneration;
+      pDimm->PcdOemProbeEpoch = gPcdCacheProbeEpoch;
     }
   }
   //Assign new data to the requester data pointer
@@ -2727,6 +3061,7 @@ FwSetPCDFromOffsetSmallPayload(
   PT_INPUT_PAYLOAD_SET_DATA_PLATFORM_CONFIG_DATA InPayloadSetData;
   UINT32 StartingPageOffset = ((ReqOffset / PCD_SET_SMALL_PAYLOAD_DATA_SIZE)*PCD_SET_SMALL_PAYLOAD_DATA_SIZE);
   UINT32 WriteOffset = 0;
+  BOOLEAN KeepLsaCache = FALSE;
 
   SetMem(&InPayloadSetData, sizeof(InPayloadSetData), 0x0);
 
@@ -2760,12 +3095,18 @@ FwSetPCDFromOffsetSmallPayload(
     }
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
   }
 
+  // A current LSA cache is kept in step with the write, any other cached PCD becomes stale
+  KeepLsaCache = (gPCDCacheEnabled && PartitionId == PCD_LSA_PARTITION_ID && NULL != pDimm->pPcdLsa &&
+      pDimm->PcdLsaCacheGeneration == gPcdCacheGeneration &&
+      (ReqOffset + ReqDataSize) <= pDimm->PcdLsaPartitionSize);
+  BumpPcdCacheGeneration();
+
   /**
     Set the Platform Config Data
   **/
@@ -2790,8 +3131,13 @@ FwSetPCDFromOffsetSmallPayload(
     }
   }
 
+  if (KeepLsaCache) {
+    CopyMem_S((UINT8 *)pDimm->pPcdLsa + ReqOffset, pDimm->PcdLsaPartitionSize - ReqOffset, pRawData, ReqDataSize);
+    pDimm->PcdLsaCacheGeneration = gPcdCacheGeneration;
+  }
+
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   return ReturnCode;
 }
 
@@ -2879,7 +3225,7 @@ FwCmdSetPlatformConfigData (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -2891,6 +3237,9 @@ FwCmdSetPlatformConfigData (
     goto Finish;
   }
 
+  // The cache of the written partition is refreshed below, every other cached PCD becomes stale
+  BumpPcdCacheGeneration();
+
   /** Copy the data to 128KB partition. If the data is smaller, the rest of partition will be empty (filled with 0) **/
   CopyMem_S(pPartition, PcdSize, pRawData, RawDataSize);
 
@@ -2966,9 +3315,18 @@ FwCmdSetPlatformConfigData (
     }
   }
 
+  if (!EFI_ERROR(ReturnCode) && NULL != pTempCache) {
+    if (PartitionId == PCD_OEM_PARTITION_ID) {
+      pDimm->PcdOemCacheGeneration = gPcdCacheGeneration;
+      pDimm->PcdOemProbeEpoch = gPcdCacheProbeEpoch;
+    } else {
+      pDimm->PcdLsaCacheGeneration = gPcdCacheGeneration;
+    }
+  }
+
 Finish:
   FREE_POOL_SAFE(pPartition);
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   FREE_POOL_SAFE(pOEMPartitionData);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -3001,7 +3359,7 @@ FwCmdGetAlarmThresholds (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3031,7 +3389,7 @@ FinishAfterPayloadAlloc:
     FREE_POOL_SAFE(*ppPayloadAlarmThresholds);
   }
 FinishAfterFwCmdAlloc:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -3064,7 +3422,7 @@ FwCmdSetAlarmThresholds (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3084,7 +3442,7 @@ FwCmdSetAlarmThresholds (
   }
 
 FinishAfterFwCmdAlloc:
-  FreePool(pFwCmd);
+  FreeFwCmd(pFwCmd);
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -3132,7 +3490,7 @@ FwCmdUpdateFw(
     goto Finish;
   }
 
-  CHECK_RESULT_MALLOC(pFwCmd, AllocateZeroPool(sizeof(*pFwCmd)), Finish);
+  CHECK_RESULT_MALLOC(pFwCmd, AllocateFwCmd(), Finish);
 
   pFwCmd->Opcode = PtUpdateFw;       //!< Firmware update category
   pFwCmd->SubOpcode = SubopUpdateFw; //!< Execute the firmware image
@@ -3246,7 +3604,7 @@ Finish:
   if (NULL != pCommandStatus && NULL != pDimm) {
     ClearNvmStatus(GetObjectStatus(pCommandStatus, pDimm->DeviceHandle.AsUint32), NVM_OPERATION_IN_PROGRESS);
   }
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -3279,7 +3637,7 @@ FwCmdGetFwDebugLogSize(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3304,38 +3662,45 @@ FwCmdGetFwDebugLogSize(
   *pLogSizeInMb = pDbgSmallOutPayload->LogSize;
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
 
 /**
-  Firmware command to get a specified debug log
+  Firmware command to stream a specified debug log page by page
+
+  Every page is handed to the handler as soon as it arrives, so no buffer
+  of the whole log size is needed.
 
   @param[in]  pDimm Target DIMM structure pointer
   @param[in]  LogSource Debug log source buffer to retrieve
-  @param[out] ppDebugLogBuffer - an allocated buffer containing the raw debug logs
-  @param[out] pDebugLogBufferSize - the size of the raw debug log buffer
+  @param[in]  StartPageOffset Page to start from, non zero to resume an interrupted stream
+  @param[in]  pHandler Consumer of the fetched pages
+  @param[in]  pContext Context passed to the handler
+  @param[out] pNextPageOffset Page to resume from if the stream stopped early. OPTIONAL
   @param[out] pCommandStatus structure containing detailed NVM error codes
 
-  Note: The caller is responsible for freeing the returned buffers
-
   @retval EFI_SUCCESS Success
-  @retval EFI_DEVICE_ERROR if failed to open PassThru protocol
+  @retval EFI_NOT_STARTED No logs to fetch
+  @retval EFI_INVALID_PARAMETER NULL parameter or invalid log source
   @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval Other errors returned by the FW command or the handler
 **/
 EFI_STATUS
-FwCmdGetFwDebugLog (
+FwCmdGetFwDebugLogStream (
   IN     DIMM *pDimm,
   IN     UINT8 LogSource,
-     OUT VOID **ppDebugLogBuffer,
-     OUT UINTN *pDebugLogBufferSize,
+  IN     UINT32 StartPageOffset,
+  IN     FW_DEBUG_LOG_PAGE_HANDLER pHandler,
+  IN     VOID *pContext,
+     OUT UINT32 *pNextPageOffset OPTIONAL,
      OUT COMMAND_STATUS *pCommandStatus
   )
 {
   NVM_FW_CMD *pFwCmd = NULL;
   EFI_STATUS ReturnCode = EFI_SUCCESS;
-  UINT32 LogPageOffset = 0;
+  UINT32 LogPageOffset = StartPageOffset;
   UINT64 CurrentDebugLogSizeInMbs = 0;
   UINT64 LogSizeBytesToFetch = 0;
   PT_INPUT_PAYLOAD_FW_DEBUG_LOG *pInputPayload = NULL;
@@ -3348,12 +3713,12 @@ FwCmdGetFwDebugLog (
 
   NVDIMM_ENTRY();
 
-  if (pDimm == NULL || ppDebugLogBuffer == NULL || pDebugLogBufferSize == NULL) {
+  if (pDimm == NULL || pHandler == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3395,12 +3760,6 @@ FwCmdGetFwDebugLog (
     goto Finish;
   }
 
-  *ppDebugLogBuffer = AllocateZeroPool(LogSizeBytesToFetch);
-  if (*ppDebugLogBuffer == NULL) {
-    ReturnCode = EFI_OUT_OF_RESOURCES;
-    goto Finish;
-  }
-
   pFwCmd->Opcode = PtGetLog;
   pFwCmd->SubOpcode = SubopFwDbg;
   pFwCmd->InputPayloadSize = sizeof(*pInputPayload);
@@ -3423,9 +3782,8 @@ FwCmdGetFwDebugLog (
     pFwCmd->LargeOutputPayloadSize = OUT_MB_SIZE;
   }
 
-  /** Fetch whole buffer, iterate by chunk size **/
-  LogPageOffset = 0;
-  BytesReadTotal = 0;
+  /** Fetch the log page by page, starting from the requested page **/
+  BytesReadTotal = MIN((UINT64) StartPageOffset * ChunkSize, LogSizeBytesToFetch);
   while (BytesReadTotal < LogSizeBytesToFetch) {
 
     pInputPayload->LogPageOffset = LogPageOffset;
@@ -3438,67 +3796,165 @@ FwCmdGetFwDebugLog (
     }
 
     BytesToCopy = MIN(LogSizeBytesToFetch - BytesReadTotal, ChunkSize);
-    CopyMem_S((UINT8 *)*ppDebugLogBuffer + BytesReadTotal, BytesToCopy, OutputPayload, BytesToCopy);
+    CHECK_RESULT(pHandler(pContext, LogPageOffset, OutputPayload, BytesToCopy, LogSizeBytesToFetch), Finish);
     LogPageOffset++;
     BytesReadTotal += BytesToCopy;
   }
-  *(pDebugLogBufferSize) = BytesReadTotal;
-
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  if (pNextPageOffset != NULL) {
+    *pNextPageOffset = LogPageOffset;
+  }
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
 
 /**
-  Firmware command to get Error logs
+  Debug log collected in a single buffer by FwCmdGetFwDebugLog
+**/
+typedef struct _FW_DEBUG_LOG_BUFFER {
+  UINT8 *pBuffer;
+  UINT64 BytesRead;
+} FW_DEBUG_LOG_BUFFER;
 
-  Small and large payloads are optional, but at least one has to be provided.
+/**
+  Page handler copying the debug log into a buffer of the whole log size
 
-  @param[in] pDimm Target DIMM structure pointer
-  @param[in] pInputPayload - filled input payload
-  @param[out] pOutputPayload - small payload result data of get error log operation
-  @param[in] OutputPayloadSize - size of small payload
-  @param[out] pLargeOutputPayload - large payload result data of get error log operation
-  @param[in] LargeOutputPayloadSize - size of large payload
+  @param[in] pContext Pointer to the FW_DEBUG_LOG_BUFFER
+  @param[in] LogPageOffset Page offset of the chunk in the log
+  @param[in] pChunk Log bytes of the page
+  @param[in] ChunkSize Number of log bytes in the page
+  @param[in] LogSize Size of the whole log in bytes
 
   @retval EFI_SUCCESS Success
-  @retval EFI_DEVICE_ERROR if failed to open PassThru protocol
   @retval EFI_OUT_OF_RESOURCES memory allocation failure
 **/
+STATIC
 EFI_STATUS
-FwCmdGetErrorLog (
-  IN     DIMM *pDimm,
-  IN     PT_INPUT_PAYLOAD_GET_ERROR_LOG *pInputPayload,
-     OUT VOID *pOutputPayload OPTIONAL,
-  IN     UINT32 OutputPayloadSize OPTIONAL,
-     OUT VOID *pLargeOutputPayload OPTIONAL,
-  IN     UINT32 LargeOutputPayloadSize OPTIONAL
+CopyFwDebugLogPage(
+  IN     VOID *pContext,
+  IN     UINT32 LogPageOffset,
+  IN     UINT8 *pChunk,
+  IN     UINT64 ChunkSize,
+  IN     UINT64 LogSize
   )
 {
-  NVM_FW_CMD *pFwCmd = NULL;
-  EFI_STATUS ReturnCode = EFI_SUCCESS;
-
-  NVDIMM_ENTRY();
+  FW_DEBUG_LOG_BUFFER *pLog = (FW_DEBUG_LOG_BUFFER *) pContext;
 
-  if (pInputPayload == NULL || (pOutputPayload == NULL && pLargeOutputPayload == NULL)) {
-    ReturnCode = EFI_INVALID_PARAMETER;
-    goto Finish;
+  if (pLog->pBuffer == NULL) {
+    pLog->pBuffer = AllocateZeroPool(LogSize);
+    if (pLog->pBuffer == NULL) {
+      return EFI_OUT_OF_RESOURCES;
+    }
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
-  if (pFwCmd == NULL) {
-    ReturnCode = EFI_OUT_OF_RESOURCES;
-    goto Finish;
-  }
+  CopyMem_S(pLog->pBuffer + pLog->BytesRead, ChunkSize, pChunk, ChunkSize);
+  pLog->BytesRead += ChunkSize;
+  return EFI_SUCCESS;
+}
 
-  pFwCmd->DimmID = pDimm->DimmID;
-  pFwCmd->Opcode = PtGetLog;
+/**
+  Firmware command to get a specified debug log
+
+  @param[in]  pDimm Target DIMM structure pointer
+  @param[in]  LogSource Debug log source buffer to retrieve
+  @param[out] ppDebugLogBuffer - an allocated buffer containing the raw debug logs
+  @param[out] pDebugLogBufferSize - the size of the raw debug log buffer
+  @param[out] pCommandStatus structure containing detailed NVM error codes
+
+  Note: The caller is responsible for freeing the returned buffers
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_DEVICE_ERROR if failed to open PassThru protocol
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+**/
+EFI_STATUS
+FwCmdGetFwDebugLog (
+  IN     DIMM *pDimm,
+  IN     UINT8 LogSource,
+     OUT VOID **ppDebugLogBuffer,
+     OUT UINTN *pDebugLogBufferSize,
+     OUT COMMAND_STATUS *pCommandStatus
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  FW_DEBUG_LOG_BUFFER Log;
+
+  NVDIMM_ENTRY();
+
+  ZeroMem(&Log, sizeof(Log));
+
+  if (pDimm == NULL || ppDebugLogBuffer == NULL || pDebugLogBufferSize == NULL) {
+    ReturnCode = EFI_INVALID_PARAMETER;
+    goto Finish;
+  }
+
+  ReturnCode = FwCmdGetFwDebugLogStream(pDimm, LogSource, 0, CopyFwDebugLogPage, &Log, NULL, pCommandStatus);
+  if (EFI_ERROR(ReturnCode)) {
+    FREE_POOL_SAFE(Log.pBuffer);
+    goto Finish;
+  }
+
+  *ppDebugLogBuffer = Log.pBuffer;
+  *pDebugLogBufferSize = Log.BytesRead;
+
+Finish:
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Firmware command to get Error logs
+
+  Small and large payloads are optional, but at least one has to be provided.
+
+  @param[in] pDimm Target DIMM structure pointer
+  @param[in] pInputPayload - filled input payload
+  @param[out] pOutputPayload - small payload result data of get error log operation
+  @param[in] OutputPayloadSize - size of small payload
+  @param[out] pLargeOutputPayload - large payload result data of get error log operation
+  @param[in] LargeOutputPayloadSize - size of large payload
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_DEVICE_ERROR if failed to open PassThru protocol
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+**/
+EFI_STATUS
+FwCmdGetErrorLog (
+  IN     DIMM *pDimm,
+  IN     PT_INPUT_PAYLOAD_GET_ERROR_LOG *pInputPayload,
+     OUT VOID *pOutputPayload OPTIONAL,
+  IN     UINT32 OutputPayloadSize OPTIONAL,
+     OUT VOID *pLargeOutputPayload OPTIONAL,
+  IN     UINT32 LargeOutputPayloadSize OPTIONAL
+  )
+{
+  NVM_FW_CMD *pFwCmd = NULL;
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+
+  NVDIMM_ENTRY();
+
+  if (pInputPayload == NULL || (pOutputPayload == NULL && pLargeOutputPayload == NULL)) {
+    ReturnCode = EFI_INVALID_PARAMETER;
+    goto Finish;
+  }
+
+  pFwCmd = AllocateFwCmd();
+  if (pFwCmd == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+
+  pFwCmd->DimmID = pDimm->DimmID;
+  pFwCmd->Opcode = PtGetLog;
   pFwCmd->SubOpcode = SubopErrorLog;
   pFwCmd->InputPayloadSize = sizeof(*pInputPayload);
   pFwCmd->OutputPayloadSize = OutputPayloadSize;
   pFwCmd->LargeOutputPayloadSize = LargeOutputPayloadSize;
+  if (LargeOutputPayloadSize > 0) {
+    pFwCmd->pLargeOutputBuffer = pLargeOutputPayload;
+  }
   CopyMem_S(&pFwCmd->InputPayload, sizeof(pFwCmd->InputPayload), pInputPayload, pFwCmd->InputPayloadSize);
 
   ReturnCode = PassThru(pDimm, pFwCmd, PT_LONG_TIMEOUT_INTERVAL);
@@ -3512,12 +3968,8 @@ FwCmdGetErrorLog (
     CopyMem_S(pOutputPayload, OutputPayloadSize, &pFwCmd->OutPayload, OutputPayloadSize);
   }
 
-  if (pLargeOutputPayload != NULL && LargeOutputPayloadSize > 0) {
-    CopyMem_S(pLargeOutputPayload, LargeOutputPayloadSize, &pFwCmd->LargeOutputPayload, LargeOutputPayloadSize);
-  }
-
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -3558,7 +4010,7 @@ FwCmdGetCommandEffectLog(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3570,6 +4022,9 @@ FwCmdGetCommandEffectLog(
   pFwCmd->InputPayloadSize = sizeof(*pInputPayload);
   pFwCmd->OutputPayloadSize = OutputPayloadSize;
   pFwCmd->LargeOutputPayloadSize = LargeOutputPayloadSize;
+  if (LargeOutputPayloadSize > 0) {
+    pFwCmd->pLargeOutputBuffer = pLargeOutputPayload;
+  }
   CopyMem_S(&pFwCmd->InputPayload, sizeof(pFwCmd->InputPayload), pInputPayload, pFwCmd->InputPayloadSize);
 
   ReturnCode = PassThru(pDimm, pFwCmd, PT_TIMEOUT_INTERVAL);
@@ -3583,19 +4038,408 @@ FwCmdGetCommandEffectLog(
     CopyMem_S(pOutputPayload, OutputPayloadSize, &pFwCmd->OutPayload, OutputPayloadSize);
   }
 
-  if (pLargeOutputPayload != NULL && LargeOutputPayloadSize > 0) {
-    CopyMem_S(pLargeOutputPayload, LargeOutputPayloadSize, &pFwCmd->LargeOutputPayload, LargeOutputPayloadSize);
+  ReturnCode = EFI_SUCCESS;
+  goto Finish;
+
+Finish:
+  FreeFwCmd(pFwCmd);
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Command Effect Log of one FW build
+
+  The CEL only depends on the FW build, so all modules with the same subsystem
+  device ID and FW version share one entry, and a FW update selects another.
+  A failed read is kept too, so the passthrough path does not send it again
+  before every command.
+**/
+typedef struct {
+  UINT16 SubsystemDeviceId;
+  FIRMWARE_VERSION FwVer;
+  COMMAND_EFFECT_LOG_ENTRY *pEntries;
+  UINT32 EntryCount;
+  EFI_STATUS ReadReturnCode;
+} CEL_CACHE_ENTRY;
+
+STATIC CEL_CACHE_ENTRY *gpCelCache = NULL;
+STATIC UINT32 gCelCacheCount = 0;
+#ifdef OS_BUILD
+/** Guards gpCelCache, RunOnDimms workers look up and fetch the CEL of their DIMM **/
+STATIC OS_MUTEX *gpCelCacheLock = NULL;
+#endif
+
+/**
+  Create the lock of the CEL cache
+  Called from the main thread before any DIMM worker thread is started.
+**/
+STATIC
+VOID
+InitCelCacheLock(
+  )
+{
+#ifdef OS_BUILD
+  if (gpCelCacheLock == NULL) {
+    gpCelCacheLock = os_mutex_init(NULL);
   }
+#endif
+}
 
+STATIC
+VOID
+LockCelCache(
+  )
+{
+#ifdef OS_BUILD
+  // Without RunOnDimms the first lookup is made by the main thread
+  InitCelCacheLock();
+  if (gpCelCacheLock != NULL) {
+    os_mutex_lock(gpCelCacheLock);
+  }
+#endif
+}
+
+STATIC
+VOID
+UnlockCelCache(
+  )
+{
+#ifdef OS_BUILD
+  if (gpCelCacheLock != NULL) {
+    os_mutex_unlock(gpCelCacheLock);
+  }
+#endif
+}
+
+/**
+  Find the cached Command Effect Log of the FW running on a DIMM
+
+  @param[in] pDimm The DIMM
+
+  @retval Cached CEL, NULL when the CEL of the FW build is not cached yet
+**/
+STATIC
+CEL_CACHE_ENTRY *
+FindCachedCommandEffectLog(
+  IN     DIMM *pDimm
+  )
+{
+  UINT32 Index = 0;
+  CEL_CACHE_ENTRY *pCel = NULL;
+
+  for (Index = 0; Index < gCelCacheCount; Index++) {
+    pCel = &gpCelCache[Index];
+    if (pCel->SubsystemDeviceId == pDimm->SubsystemDeviceId &&
+        pCel->FwVer.FwProduct == pDimm->FwVer.FwProduct &&
+        pCel->FwVer.FwRevision == pDimm->FwVer.FwRevision &&
+        pCel->FwVer.FwSecurityVersion == pDimm->FwVer.FwSecurityVersion &&
+        pCel->FwVer.FwApiMajor == pDimm->FwVer.FwApiMajor &&
+        pCel->FwVer.FwApiMinor == pDimm->FwVer.FwApiMinor &&
+        pCel->FwVer.FwBuild == pDimm->FwVer.FwBuild) {
+      return pCel;
+    }
+  }
+  return NULL;
+}
+
+/**
+  Read the whole Command Effect Log from a DIMM
+
+  @param[in] pDimm The DIMM
+  @param[out] ppLogEntry Allocated CEL table, to be freed by the caller
+  @param[out] pEntryCount Number of entries of the table
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval other FW command failure
+**/
+STATIC
+EFI_STATUS
+ReadCommandEffectLog(
+  IN     DIMM *pDimm,
+     OUT COMMAND_EFFECT_LOG_ENTRY **ppLogEntry,
+     OUT UINT32 *pEntryCount
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  PT_INPUT_PAYLOAD_GET_COMMAND_EFFECT_LOG InputPayload;
+  PT_OUTPUT_PAYLOAD_GET_COMMAND_EFFECT_LOG OutPayload;
+  COMMAND_EFFECT_LOG_ENTRY *pLogEntry = NULL;
+  UINT32 EntryCount = 0;
+  UINT32 CelTableSize = 0;
+  BOOLEAN LargePayloadAvailable = FALSE;
+  UINT32 EntryCountRemaining = 0;
+  UINT8 CelEntriesPerSmallPayload = (sizeof(PT_OUTPUT_PAYLOAD_GET_COMMAND_EFFECT_LOG) / sizeof(COMMAND_EFFECT_LOG_ENTRY));
+  UINT32 OutputBytes = 0;
+
+  ZeroMem(&InputPayload, sizeof(InputPayload));
+  ZeroMem(&OutPayload, sizeof(OutPayload));
+
+  // Format InputPayload for small payload entry count retrieval if necessary
+  CHECK_RESULT(IsLargePayloadAvailable(pDimm, &LargePayloadAvailable), Finish);
+  if (!LargePayloadAvailable) {
+    InputPayload.PayloadType = SmallPayload;
+    InputPayload.LogAction = EntriesCount;
+    InputPayload.EntryOffset = 0;
+  }
+
+  CHECK_RESULT(FwCmdGetCommandEffectLog(pDimm, &InputPayload, &OutPayload, sizeof(OutPayload), NULL, 0), Finish);
+  EntryCount = OutPayload.LogTypeData.CelCount.LogEntryCount;
+  CelTableSize = sizeof(COMMAND_EFFECT_LOG_ENTRY) * EntryCount;
+
+  pLogEntry = AllocateZeroPool(CelTableSize);
+  if (pLogEntry == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+
+  if (!LargePayloadAvailable) {
+    EntryCountRemaining = EntryCount;
+    InputPayload.PayloadType = SmallPayload;
+    InputPayload.LogAction = CelEntries;
+    InputPayload.EntryOffset = 0;
+
+    while (EntryCountRemaining > 0) {
+      CHECK_RESULT(FwCmdGetCommandEffectLog(pDimm, &InputPayload, &OutPayload, sizeof(OutPayload), NULL, 0), Finish);
+      OutputBytes = EntryCountRemaining > CelEntriesPerSmallPayload ? sizeof(OutPayload) : sizeof(COMMAND_EFFECT_LOG_ENTRY) * EntryCountRemaining;
+      CopyMem_S(pLogEntry + InputPayload.EntryOffset, sizeof(COMMAND_EFFECT_LOG_ENTRY) * EntryCountRemaining, &OutPayload, OutputBytes);
+      EntryCountRemaining = EntryCountRemaining > CelEntriesPerSmallPayload ? EntryCountRemaining - CelEntriesPerSmallPayload : 0;
+      InputPayload.EntryOffset += CelEntriesPerSmallPayload;
+    }
+  }
+  else {
+    CHECK_RESULT(FwCmdGetCommandEffectLog(pDimm, &InputPayload, &OutPayload, sizeof(OutPayload), pLogEntry, CelTableSize), Finish);
+  }
+
+  *ppLogEntry = pLogEntry;
+  *pEntryCount = EntryCount;
+  pLogEntry = NULL;
   ReturnCode = EFI_SUCCESS;
-  goto Finish;
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FREE_POOL_SAFE(pLogEntry);
+  return ReturnCode;
+}
+
+/**
+  Find or read the Command Effect Log of the FW running on a DIMM
+
+  Called with the CEL cache locked. The read of the CEL is classified without
+  the cache, so it does not come back here through the passthrough.
+
+  @param[in] pDimm The DIMM
+  @param[in] RetryFailedRead Read the CEL again if its last read failed
+
+  @retval Cached CEL, its ReadReturnCode tells if the CEL could be read
+  @retval NULL memory allocation failure
+**/
+STATIC
+CEL_CACHE_ENTRY *
+CacheCommandEffectLog(
+  IN     DIMM *pDimm,
+  IN     BOOLEAN RetryFailedRead
+  )
+{
+  CEL_CACHE_ENTRY *pCel = NULL;
+  CEL_CACHE_ENTRY *pNewCache = NULL;
+
+  pCel = FindCachedCommandEffectLog(pDimm);
+  if (pCel != NULL && (!EFI_ERROR(pCel->ReadReturnCode) || !RetryFailedRead)) {
+    return pCel;
+  }
+
+  if (pCel == NULL) {
+    pNewCache = ReallocatePool(sizeof(*gpCelCache) * gCelCacheCount,
+        sizeof(*gpCelCache) * (gCelCacheCount + 1), gpCelCache);
+    if (pNewCache == NULL) {
+      return NULL;
+    }
+    gpCelCache = pNewCache;
+    pCel = &gpCelCache[gCelCacheCount++];
+    ZeroMem(pCel, sizeof(*pCel));
+    pCel->SubsystemDeviceId = pDimm->SubsystemDeviceId;
+    pCel->FwVer = pDimm->FwVer;
+  }
+
+  pCel->ReadReturnCode = ReadCommandEffectLog(pDimm, &pCel->pEntries, &pCel->EntryCount);
+  if (EFI_ERROR(pCel->ReadReturnCode)) {
+    // Commands of this FW build are classified as unknown, nothing else depends on the CEL
+    NVDIMM_DBG("Failed to read the Command Effect Log of dimm 0x%x: " FORMAT_EFI_STATUS "",
+        pDimm->DeviceHandle.AsUint32, pCel->ReadReturnCode);
+  }
+  return pCel;
+}
+
+/**
+  Get the Command Effect Log of a DIMM
+
+  The CEL is read from the DIMM only once per FW build, later calls for any
+  DIMM running the same FW return the cached table. A read that failed before
+  is retried.
+
+  @param[in] pDimm The DIMM
+  @param[out] ppLogEntry Cached CEL table, owned by the cache and not to be freed
+  @param[out] pEntryCount Number of entries of the table
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER one or more parameters are NULL
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval other FW command failure
+**/
+EFI_STATUS
+GetDimmCommandEffectLog(
+  IN     DIMM *pDimm,
+     OUT COMMAND_EFFECT_LOG_ENTRY **ppLogEntry,
+     OUT UINT32 *pEntryCount
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  CEL_CACHE_ENTRY *pCel = NULL;
+
+  NVDIMM_ENTRY();
+
+  if (pDimm == NULL || ppLogEntry == NULL || pEntryCount == NULL) {
+    goto Finish;
+  }
+
+  LockCelCache();
+  pCel = CacheCommandEffectLog(pDimm, TRUE);
+  if (pCel == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+  } else {
+    ReturnCode = pCel->ReadReturnCode;
+    *ppLogEntry = pCel->pEntries;
+    *pEntryCount = pCel->EntryCount;
+  }
+  UnlockCelCache();
+
+Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
 
+/**
+  Check if the Command Effect Log of a DIMM may be read to classify a command
+
+  The CEL is keyed by the FW version, which is unknown until the DIMM is
+  identified. A session recorded without the CEL read is played back without
+  it, reading it there would take the records of the commands that follow.
+
+  @param[in] pDimm The DIMM
+
+  @retval TRUE the CEL may be read
+**/
+STATIC
+BOOLEAN
+MayFetchCommandEffectLog(
+  IN     DIMM *pDimm
+  )
+{
+#ifdef OS_BUILD
+  UINT32 PbrMode = PBR_NORMAL_MODE;
+#endif
+
+  if (pDimm->FwVer.FwProduct == 0 && pDimm->FwVer.FwRevision == 0 &&
+      pDimm->FwVer.FwSecurityVersion == 0 && pDimm->FwVer.FwBuild == 0) {
+    return FALSE;
+  }
+#ifdef OS_BUILD
+  PbrGetMode(&PbrMode);
+  if (PbrMode == PBR_PLAYBACK_MODE) {
+    return PbrIsNextPassThruRecord(PBR_CTX(), PtGetLog, SubopCommandEffectLog);
+  }
+#endif
+  return TRUE;
+}
+
+/**
+  Classify a FW command by its entry in the Command Effect Log
+
+  The CEL of the FW build of the DIMM is read by the first lookup and cached,
+  the passthrough classifies every command before sending it. Read-only
+  commands may be reordered, retried or sent to several DIMMs in parallel.
+
+  @param[in] pDimm The DIMM the command is sent to
+  @param[in] Opcode Opcode of the command
+  @param[in] SubOpcode SubOpcode of the command
+
+  @retval FwCmdEffectReadOnly the command has no effects
+  @retval FwCmdEffectMutating the command changes the state of the DIMM
+  @retval FwCmdEffectUnknown the CEL could not be read or has no entry for the command
+**/
+FW_CMD_EFFECT
+GetFwCmdEffect(
+  IN     DIMM *pDimm,
+  IN     UINT8 Opcode,
+  IN     UINT8 SubOpcode
+  )
+{
+  FW_CMD_EFFECT Effect = FwCmdEffectUnknown;
+  CEL_CACHE_ENTRY *pCel = NULL;
+  COMMAND_EFFECT_LOG_ENTRY *pEntry = NULL;
+  UINT32 Index = 0;
+
+  if (pDimm == NULL) {
+    return FwCmdEffectUnknown;
+  }
+  // The CEL is read while its cache is locked, so its read is classified without it
+  if (Opcode == PtGetLog && SubOpcode == SubopCommandEffectLog) {
+    return FwCmdEffectReadOnly;
+  }
+
+  LockCelCache();
+  if (MayFetchCommandEffectLog(pDimm)) {
+    pCel = CacheCommandEffectLog(pDimm, FALSE);
+  } else {
+    pCel = FindCachedCommandEffectLog(pDimm);
+  }
+
+  for (Index = 0; pCel != NULL && Index < pCel->EntryCount; Index++) {
+    pEntry = &pCel->pEntries[Index];
+    if (pEntry->Opcode.Separated.Opcode != Opcode || pEntry->Opcode.Separated.SubOpcode != SubOpcode) {
+      continue;
+    }
+    // An empty effect set marks an unsupported command
+    if (pEntry->EffectName.AsUint32 == 0) {
+      Effect = FwCmdEffectUnknown;
+    } else if (pEntry->EffectName.Separated.NoEffects &&
+        !pEntry->EffectName.Separated.SecurityStateChange &&
+        !pEntry->EffectName.Separated.DimmConfigChangeAfterReboot &&
+        !pEntry->EffectName.Separated.ImmediateDimmConfigChange &&
+        !pEntry->EffectName.Separated.QuiesceAllIo &&
+        !pEntry->EffectName.Separated.ImmediateDimmDataChange &&
+        !pEntry->EffectName.Separated.TestMode &&
+        !pEntry->EffectName.Separated.DebugMode &&
+        !pEntry->EffectName.Separated.ImmediateDimmPolicyChange) {
+      Effect = FwCmdEffectReadOnly;
+    } else {
+      Effect = FwCmdEffectMutating;
+    }
+    break;
+  }
+  UnlockCelCache();
+  return Effect;
+}
+
+/**
+  Free all cached Command Effect Logs
+**/
+VOID
+FreeCommandEffectLogCache(
+  )
+{
+  UINT32 Index = 0;
+
+  LockCelCache();
+  for (Index = 0; Index < gCelCacheCount; Index++) {
+    FREE_POOL_SAFE(gpCelCache[Index].pEntries);
+  }
+  FREE_POOL_SAFE(gpCelCache);
+  gCelCacheCount = 0;
+  UnlockCelCache();
+}
+
 /**
   Firmware command to get SMART and Health Info
 
@@ -3623,7 +4467,7 @@ FwCmdGetSmartAndHealth (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3649,7 +4493,7 @@ FwCmdGetSmartAndHealth (
   CopyMem_S(*ppPayloadSmartAndHealth, sizeof(**ppPayloadSmartAndHealth), pFwCmd->OutPayload, sizeof(**ppPayloadSmartAndHealth));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -3693,7 +4537,7 @@ FwCmdGetMemoryInfoPage (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3723,7 +4567,7 @@ FwCmdGetMemoryInfoPage (
   CopyMem_S(*ppPayloadMemoryInfoPage, PageSize, pFwCmd->OutPayload, pFwCmd->OutputPayloadSize);
 
 FinishAfterFwCmdAlloc:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -3756,7 +4600,7 @@ FwCmdGetFirmwareImageInfo (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3782,7 +4626,7 @@ FwCmdGetFirmwareImageInfo (
   CopyMem_S(*ppPayloadFwImage, sizeof(**ppPayloadFwImage), pFwCmd->OutPayload, sizeof(**ppPayloadFwImage));
 
 FinishError:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -3815,7 +4659,7 @@ FwCmdGetPowerManagementPolicy(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3849,7 +4693,7 @@ Finish:
   if (EFI_ERROR(ReturnCode) && (NULL != ppPayloadPowerManagementPolicy)) {
     FREE_POOL_SAFE(*ppPayloadPowerManagementPolicy);
   }
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -3884,7 +4728,7 @@ FwCmdGetPMONRegisters(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3907,7 +4751,7 @@ FwCmdGetPMONRegisters(
   CopyMem_S(pPayloadPMONRegisters, sizeof(*pPayloadPMONRegisters), pFwCmd->OutPayload, sizeof(*pPayloadPMONRegisters));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -3942,7 +4786,7 @@ FwCmdSetPMONRegisters(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -3962,7 +4806,7 @@ FwCmdSetPMONRegisters(
   }
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -3994,7 +4838,7 @@ FwCmdGetPackageSparingPolicy (
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -4020,7 +4864,7 @@ FwCmdGetPackageSparingPolicy (
   CopyMem_S(*ppPayloadPackageSparingPolicy, sizeof(**ppPayloadPackageSparingPolicy), pFwCmd->OutPayload, sizeof(**ppPayloadPackageSparingPolicy));
 
 FinishAfterFwCmdAlloc:
-  FreePool(pFwCmd);
+  FreeFwCmd(pFwCmd);
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -4053,7 +4897,7 @@ FwCmdGetLongOperationStatus(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -4082,7 +4926,7 @@ FwCmdGetLongOperationStatus(
   ReturnCode = EFI_SUCCESS;
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -4277,6 +5121,67 @@ Finish:
   return ReturnCode;
 }
 
+/**
+  Refreshes the inventory entry of a single DIMM without rebuilding the
+  whole DIMM list: rereads the identify and security information and drops
+  the cached PCD of that DIMM.
+
+  @param[in,out] pDimm the DIMM that we want to refresh.
+
+  @retval EFI_SUCCESS - the DIMM was refreshed successfully.
+  @retval EFI_INVALID_PARAMETER - pDimm is NULL.
+  @retval EFI_OUT_OF_RESOURCES - the memory allocation failed.
+  @retval Other errors from the FW commands
+**/
+EFI_STATUS
+RefreshDimmInventoryEntry(
+  IN OUT DIMM *pDimm
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  PT_GET_SECURITY_PAYLOAD *pSecurityPayload = NULL;
+
+  NVDIMM_ENTRY();
+  if (pDimm == NULL) {
+    ReturnCode = EFI_INVALID_PARAMETER;
+    goto Finish;
+  }
+
+#ifdef PCD_CACHE_ENABLED
+  FREE_POOL_SAFE(pDimm->pPcdOem);
+  FREE_POOL_SAFE(pDimm->pPcdLsa);
+#endif // PCD_CACHE_ENABLED
+  pDimm->PcdOemCacheGeneration = 0;
+  pDimm->PcdLsaCacheGeneration = 0;
+
+  if (!IsDimmManageable(pDimm)) {
+    goto Finish;
+  }
+
+  ReturnCode = RefreshDimm(pDimm);
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
+  }
+
+  pSecurityPayload = AllocateZeroPool(sizeof(*pSecurityPayload));
+  if (pSecurityPayload == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+
+  ReturnCode = FwCmdGetSecurityInfo(pDimm, pSecurityPayload);
+  if (EFI_ERROR(ReturnCode)) {
+    NVDIMM_WARN("Failed to get the security state for dimm: 0x%x.", pDimm->DeviceHandle.AsUint32);
+    goto Finish;
+  }
+  pDimm->EncryptionEnabled = (BOOLEAN) pSecurityPayload->SecurityStatus.Separated.SecurityEnabled;
+
+Finish:
+  FREE_POOL_SAFE(pSecurityPayload);
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
 /**
   Create and configure block window
   Create the block window structure. This includes locating
@@ -4616,6 +5521,26 @@ BlockWindowProgrammingDelay(volatile UINT64 *pBlockWindowCmdRegAddress)
   }
 }
 
+/**
+  Compare two error log sequence numbers that wrap around at MAX_UINT16
+
+  Serial number arithmetic: SequenceNumber is after OtherSequenceNumber when
+  it is less than half of the UINT16 range ahead of it.
+
+  @param[in] SequenceNumber - sequence number to check
+  @param[in] OtherSequenceNumber - sequence number to compare with
+
+  @retval TRUE if SequenceNumber was logged after OtherSequenceNumber
+**/
+BOOLEAN
+IsSequenceNumberAfter(
+  IN     UINT16 SequenceNumber,
+  IN     UINT16 OtherSequenceNumber
+  )
+{
+  return (INT16)(UINT16)(SequenceNumber - OtherSequenceNumber) > 0;
+}
+
 /**
   Get error logs for given dimm parse it and save in common error log structure
 
@@ -4692,12 +5617,18 @@ GetAndParseFwErrorLogForDimm(
     UINT16 PayloadsProcessed = 0;
     InputPayload.LogParameters.Separated.LogInfo = ErrorLogInfoEntries;
     InputPayload.LogParameters.Separated.LogEntriesPayloadReturn = ErrorLogSmallPayload;
-    InputPayload.SequenceNumber = OutPayloadGetErrorLogInfoData.OldestSequenceNum;
+    /** Resume from the requested sequence number when it is still in the log **/
+    if (IsSequenceNumberAfter(SequenceNumber, OutPayloadGetErrorLogInfoData.OldestSequenceNum)) {
+      InputPayload.SequenceNumber = SequenceNumber;
+    } else {
+      InputPayload.SequenceNumber = OutPayloadGetErrorLogInfoData.OldestSequenceNum;
+    }
     UINT16 LogEntrySize = ThermalError ? sizeof(PT_OUTPUT_PAYLOAD_GET_ERROR_LOG_THERMAL_ENTRY) : sizeof(PT_OUTPUT_PAYLOAD_GET_ERROR_LOG_MEDIA_ENTRY);
     UINT16 SmallPayloadRawSize = 0;
     UINT64 LargeOutputOffset = (UINT64)pLargeOutputPayload;
 
-    while (ReturnCount < OutPayloadGetErrorLogInfoData.MaxLogEntries) {
+    while (ReturnCount < OutPayloadGetErrorLogInfoData.MaxLogEntries && ReturnCount < MaxErrorsToSave) {
+      InputPayload.RequestCount = (UINT16) MIN(InputPayload.RequestCount, MaxErrorsToSave - ReturnCount);
       ReturnCode = FwCmdGetErrorLog(pDimm, &InputPayload, &OutPayloadGetErrorLog, sizeof(OutPayloadGetErrorLog),
         pLargeOutputPayload, 0);
 
@@ -4742,7 +5673,7 @@ GetAndParseFwErrorLogForDimm(
       goto Finish;
     }
 
-    ReturnCount = OutPayloadGetErrorLog.ReturnCount;
+    ReturnCount = (UINT16) MIN(OutPayloadGetErrorLog.ReturnCount, MaxErrorsToSave);
   }
 
   if (ReturnCount > 0) {
@@ -5485,6 +6416,11 @@ FreeDimm(
     return;
   }
   FreeBlockWindow(pDimm->pBw);
+#ifdef OS_BUILD
+  if (pDimm->pFwCmdOrderLock != NULL) {
+    os_mutex_delete(pDimm->pFwCmdOrderLock, NULL);
+  }
+#endif
   FREE_POOL_SAFE(pDimm);
   NVDIMM_EXIT();
 }
@@ -6543,77 +7479,303 @@ GetOverwriteDimmStatus(
         *pOverwriteDimmStatus = OVERWRITE_DIMM_STATUS_COMPLETED;
         break;
     }
-  } else {
-    *pOverwriteDimmStatus = OVERWRITE_DIMM_STATUS_UNKNOWN;
+  } else {
+    *pOverwriteDimmStatus = OVERWRITE_DIMM_STATUS_UNKNOWN;
+  }
+
+  ReturnCode = EFI_SUCCESS;
+
+Finish:
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Poll while ARS long operation status reports DEVICE BUSY
+
+  @param[in] pDimm DIMM to retrieve overwrite DIMM operation status from
+  @parma[in] TimeoutSecs - Poll timeout in seconds
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_TIMEOUT Timeout expired and did not receive something other than FW_DEVICE_BUSY
+  @retval EFI_INVALID_PARAMETER One or more parameters are NULL
+  @retval EFI_DEVICE_ERROR Retrieved an unexpeced opcode/subopcode when requesting long op status
+**/
+
+EFI_STATUS
+PollOnArsDeviceBusy(
+  IN     DIMM *pDimm,
+  IN     UINT32 TimeoutSecs
+)
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  EFI_STATUS DimmReturnCode = EFI_SUCCESS;
+
+  NVDIMM_ENTRY();
+
+  if (pDimm == NULL) {
+    goto Finish;
+  }
+
+  ReturnCode = PollLongOpStatusOnDimms(&pDimm, 1, PtSetFeatures, SubopAddressRangeScrub,
+    TimeoutSecs, NULL, NULL, &DimmReturnCode);
+  if (EFI_ERROR(ReturnCode) && ReturnCode != EFI_TIMEOUT) {
+    NVDIMM_ERR("Error occurred while polling for ARS enable/disable state.\n");
+  }
+
+Finish:
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Poll the long operation status of several DIMMs in one loop
+
+  Every round requests the long operation status of each DIMM that is still
+  busy, then waits POLL_LONG_OP_DELAY_US once for all of them, so the DIMMs
+  share one timeout instead of being waited on one after another.
+
+  @param[in] ppDimms DIMMs running the long operation
+  @param[in] DimmsNum Number of DIMMs in ppDimms
+  @param[in] OpcodeToPoll Opcode of the long operation, 0 to accept any
+  @param[in] SubOpcodeToPoll Subopcode of the long operation
+  @param[in] TimeoutSecs Timeout shared by all DIMMs, 0 to read the status once
+  @param[in] pHandler Optional per DIMM completion callback
+  @param[in] pContext Context passed to pHandler
+  @param[out] pReturnCodes Per DIMM result, DimmsNum entries:
+    EFI_SUCCESS the operation is no longer busy,
+    EFI_NOT_STARTED no long operation is reported by the DIMM,
+    EFI_DEVICE_ERROR the DIMM reports a different operation,
+    EFI_TIMEOUT the DIMM was still busy when the timeout expired,
+    or the error of the status request
+
+  @retval EFI_SUCCESS All DIMMs finished their operation
+  @retval EFI_INVALID_PARAMETER One or more parameters are NULL
+  @retval Other the first error found in pReturnCodes
+**/
+EFI_STATUS
+PollLongOpStatusOnDimms(
+  IN     DIMM **ppDimms,
+  IN     UINT32 DimmsNum,
+  IN     UINT8 OpcodeToPoll OPTIONAL,
+  IN     UINT8 SubOpcodeToPoll OPTIONAL,
+  IN     UINT32 TimeoutSecs,
+  IN     LONG_OP_COMPLETION_HANDLER pHandler OPTIONAL,
+  IN     VOID *pContext OPTIONAL,
+     OUT EFI_STATUS *pReturnCodes
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  BOOLEAN *pDone = NULL;
+  PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *pLongOpStatus = NULL;
+  UINT8 FwStatus = FW_SUCCESS;
+  UINT32 PendingNum = 0;
+  UINT32 RetryMax = 0;
+  UINT32 RetryCount = 0;
+  UINT32 Index = 0;
+
+  NVDIMM_ENTRY();
+
+  if (ppDimms == NULL || pReturnCodes == NULL || DimmsNum == 0) {
+    goto Finish;
+  }
+
+  pDone = AllocateZeroPool(DimmsNum * sizeof(*pDone));
+  pLongOpStatus = AllocateZeroPool(DimmsNum * sizeof(*pLongOpStatus));
+  if (pDone == NULL || pLongOpStatus == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+
+  for (Index = 0; Index < DimmsNum; Index++) {
+    pReturnCodes[Index] = EFI_TIMEOUT;
+  }
+
+  PendingNum = DimmsNum;
+  RetryMax = MAX(1, (UINT32)(((UINT64)TimeoutSecs * 1000000) / POLL_LONG_OP_DELAY_US));
+
+  for (RetryCount = 0; RetryCount < RetryMax && PendingNum > 0; ++RetryCount) {
+    if (RetryCount > 0) {
+      gBS->Stall(POLL_LONG_OP_DELAY_US);
+    }
+
+    for (Index = 0; Index < DimmsNum; Index++) {
+      if (pDone[Index]) {
+        continue;
+      }
+
+      ZeroMem(&pLongOpStatus[Index], sizeof(pLongOpStatus[Index]));
+      ReturnCode = FwCmdGetLongOperationStatus(ppDimms[Index], &FwStatus, &pLongOpStatus[Index]);
+      if (EFI_ERROR(ReturnCode)) {
+        if ((ppDimms[Index]->FwVer.FwApiMajor == 1 && ppDimms[Index]->FwVer.FwApiMinor <= 4 && FwStatus == FW_INTERNAL_DEVICE_ERROR) ||
+          FwStatus == FW_DATA_NOT_SET) {
+          ReturnCode = EFI_NOT_STARTED;
+        }
+      } else if (OpcodeToPoll != 0 &&
+          (pLongOpStatus[Index].CmdOpcode != OpcodeToPoll || pLongOpStatus[Index].CmdSubcode != SubOpcodeToPoll)) {
+        NVDIMM_ERR("Unexpected opcode/subopcodes retrieved with Get Long Op Status on dimm 0x%x\n",
+          ppDimms[Index]->DeviceHandle.AsUint32);
+        ReturnCode = EFI_DEVICE_ERROR;
+      } else if (FW_DEVICE_BUSY == pLongOpStatus[Index].Status) {
+        continue;
+      }
+
+      pReturnCodes[Index] = ReturnCode;
+      pDone[Index] = TRUE;
+      PendingNum--;
+      if (pHandler != NULL) {
+        pHandler(pContext, ppDimms[Index], &pLongOpStatus[Index], ReturnCode);
+      }
+    }
   }
 
   ReturnCode = EFI_SUCCESS;
+  for (Index = 0; Index < DimmsNum; Index++) {
+    if (!pDone[Index]) {
+      NVDIMM_DBG("Timed out polling long operation status on dimm 0x%x", ppDimms[Index]->DeviceHandle.AsUint32);
+      if (pHandler != NULL) {
+        pHandler(pContext, ppDimms[Index], &pLongOpStatus[Index], EFI_TIMEOUT);
+      }
+    }
+    KEEP_ERROR(ReturnCode, pReturnCodes[Index]);
+  }
 
 Finish:
+  FREE_POOL_SAFE(pDone);
+  FREE_POOL_SAFE(pLongOpStatus);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
 
+typedef struct _DIMM_WORKER_CONTEXT {
+  DIMM *pDimm;
+  DIMM_WORKER pWorker;
+  VOID *pArg;
+  EFI_STATUS ReturnCode;
+  unsigned long long ThreadId;
+  BOOLEAN ThreadStarted;
+} DIMM_WORKER_CONTEXT;
+
 /**
-  Poll while ARS long operation status reports DEVICE BUSY
+  Thread entry of RunOnDimms, runs the worker on one DIMM
 
-  @param[in] pDimm DIMM to retrieve overwrite DIMM operation status from
-  @parma[in] TimeoutSecs - Poll timeout in seconds
+  @param[in,out] pArg DIMM_WORKER_CONTEXT of the DIMM
 
-  @retval EFI_SUCCESS Success
-  @retval EFI_TIMEOUT Timeout expired and did not receive something other than FW_DEVICE_BUSY
-  @retval EFI_INVALID_PARAMETER One or more parameters are NULL
-  @retval EFI_DEVICE_ERROR Retrieved an unexpeced opcode/subopcode when requesting long op status
+  @retval NULL
 **/
+STATIC
+VOID *
+DimmWorkerThread(
+  IN OUT VOID *pArg
+  )
+{
+  DIMM_WORKER_CONTEXT *pContext = (DIMM_WORKER_CONTEXT *)pArg;
+
+  pContext->ReturnCode = pContext->pWorker(pContext->pDimm, pContext->pArg);
+  return NULL;
+}
+
+/**
+  Run a worker on each DIMM of an array
+
+  In the OS build every DIMM gets its own thread, so FW commands of different
+  DIMMs overlap. A recorded or replayed session needs the FW commands in a
+  fixed order, so there and in UEFI the DIMMs are worked on one after another.
+  The worker must only touch its own DIMM; results are gathered in
+  pReturnCodes and are expected to be reported by the caller afterwards.
 
+  @param[in] ppDimms DIMMs to work on
+  @param[in] DimmsNum Number of DIMMs in ppDimms
+  @param[in] pWorker Function run for each DIMM
+  @param[in] ppArgs Optional per DIMM arguments, DimmsNum entries
+  @param[out] pReturnCodes Per DIMM result of pWorker, DimmsNum entries
+
+  @retval EFI_SUCCESS pWorker succeeded on all DIMMs
+  @retval EFI_INVALID_PARAMETER One or more parameters are NULL
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+  @retval Other the first error found in pReturnCodes
+**/
 EFI_STATUS
-PollOnArsDeviceBusy(
-  IN     DIMM *pDimm,
-  IN     UINT32 TimeoutSecs
-)
+RunOnDimms(
+  IN     DIMM **ppDimms,
+  IN     UINT32 DimmsNum,
+  IN     DIMM_WORKER pWorker,
+  IN     VOID **ppArgs OPTIONAL,
+     OUT EFI_STATUS *pReturnCodes
+  )
 {
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
-  UINT8 FwStatus = FW_SUCCESS;
-  PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS LongOpStatus;
-  UINT32 RetryMax = 0;
-  UINT32 RetryCount = 0;
+  DIMM_WORKER_CONTEXT *pContexts = NULL;
+  UINT32 Index = 0;
+#ifdef OS_BUILD
+  UINT32 PbrMode = PBR_NORMAL_MODE;
+  BOOLEAN Parallel = FALSE;
+  UINT32 PcdCacheGeneration = 0;
+#endif
 
   NVDIMM_ENTRY();
 
-  ZeroMem(&LongOpStatus, sizeof(LongOpStatus));
+  if (ppDimms == NULL || pWorker == NULL || pReturnCodes == NULL) {
+    goto Finish;
+  }
 
-  if (pDimm == NULL) {
+  if (DimmsNum == 0) {
+    ReturnCode = EFI_SUCCESS;
     goto Finish;
   }
 
-  RetryMax = (TimeoutSecs * 1000000) / POLL_ARS_LONG_OP_DELAY_US;
+  pContexts = AllocateZeroPool(DimmsNum * sizeof(*pContexts));
+  if (pContexts == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
 
-  for(RetryCount = 0; RetryCount < RetryMax; ++RetryCount) {
-    ReturnCode = FwCmdGetLongOperationStatus(pDimm, &FwStatus, &LongOpStatus);
-    if (EFI_ERROR(ReturnCode)) {
-        NVDIMM_ERR("Error occurred while polling for ARS enable/disable state.\n");
-        break;
-    }
+#ifdef OS_BUILD
+  // Recorded sessions must keep the order of the FW commands
+  PbrGetMode(&PbrMode);
+  Parallel = (PbrMode == PBR_NORMAL_MODE && DimmsNum > 1);
+  if (Parallel) {
+    // Workers may write the PCD and fetch the CEL, create the locks before they exist
+    InitPcdCacheGenerationLock();
+    InitCelCacheLock();
+    PcdCacheGeneration = gPcdCacheGeneration;
+  }
+#endif
 
-    if (LongOpStatus.CmdOpcode == PtSetFeatures && LongOpStatus.CmdSubcode == SubopAddressRangeScrub) {
-      if (FW_DEVICE_BUSY != LongOpStatus.Status) {
-        ReturnCode = EFI_SUCCESS;
-        goto Finish;
-      }
+  for (Index = 0; Index < DimmsNum; Index++) {
+    pContexts[Index].pDimm = ppDimms[Index];
+    pContexts[Index].pWorker = pWorker;
+    pContexts[Index].pArg = (ppArgs == NULL) ? NULL : ppArgs[Index];
+#ifdef OS_BUILD
+    if (Parallel && 0 == os_create_thread(&pContexts[Index].ThreadId, DimmWorkerThread, &pContexts[Index])) {
+      pContexts[Index].ThreadStarted = TRUE;
+      continue;
     }
-    else {
-      NVDIMM_ERR("Unexpected opcode/subopcodes retrieved with Get Long Op Status\n");
-      ReturnCode = EFI_DEVICE_ERROR;
-      break;
+#endif
+    // Not parallel or the thread could not be started, work on the DIMM here
+    DimmWorkerThread(&pContexts[Index]);
+  }
+
+  ReturnCode = EFI_SUCCESS;
+  for (Index = 0; Index < DimmsNum; Index++) {
+#ifdef OS_BUILD
+    if (pContexts[Index].ThreadStarted) {
+      os_join_thread(pContexts[Index].ThreadId);
     }
-    gBS->Stall(POLL_ARS_LONG_OP_DELAY_US);
-    ZeroMem(&LongOpStatus, sizeof(LongOpStatus));
+#endif
+    pReturnCodes[Index] = pContexts[Index].ReturnCode;
+    KEEP_ERROR(ReturnCode, pReturnCodes[Index]);
   }
 
-  if (EFI_SUCCESS == ReturnCode && RetryCount == RetryMax) {
-    ReturnCode = EFI_TIMEOUT;
+#ifdef OS_BUILD
+  if (Parallel && PcdCacheGeneration != gPcdCacheGeneration) {
+    // Caches filled by a worker while another one was writing are stale
+    BumpPcdCacheGeneration();
   }
+#endif
+
 Finish:
+  FREE_POOL_SAFE(pContexts);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -6642,7 +7804,7 @@ FwCmdFormatDimm(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
 
   if (!pFwCmd) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -6659,7 +7821,7 @@ FwCmdFormatDimm(
   }
 
   Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -6690,7 +7852,7 @@ FwCmdGetDdrtIoInitInfo(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -6711,7 +7873,7 @@ FwCmdGetDdrtIoInitInfo(
   CopyMem_S(pDdrtIoInitInfo, sizeof(*pDdrtIoInitInfo), pFwCmd->OutPayload, sizeof(*pDdrtIoInitInfo));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -6747,7 +7909,7 @@ FwCmdGetCommandAccessPolicy(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -6780,7 +7942,7 @@ FwCmdGetCommandAccessPolicy(
   *pRestriction = pOutputCAP->Restriction;
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -6815,7 +7977,7 @@ FwCmdInjectError(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
 
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -6841,7 +8003,7 @@ FwCmdInjectError(
   }
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -6873,7 +8035,7 @@ FwCmdGetSystemTime(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
 
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -6895,7 +8057,7 @@ FwCmdGetSystemTime(
   CopyMem_S(pSystemTimePayload, sizeof(*pSystemTimePayload), pFwCmd->OutPayload, sizeof(*pSystemTimePayload));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -6933,7 +8095,7 @@ FwCmdGetExtendedAdrInfo(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -6954,7 +8116,7 @@ FwCmdGetExtendedAdrInfo(
   CopyMem_S(pExtendedAdrInfo, sizeof(*pExtendedAdrInfo), pFwCmd->OutPayload, sizeof(*pExtendedAdrInfo));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -6985,7 +8147,7 @@ FwCmdGetLatchSystemShutdownStateInfo(
     goto Finish;
   }
 
-  pFwCmd = AllocateZeroPool(sizeof(*pFwCmd));
+  pFwCmd = AllocateFwCmd();
   if (pFwCmd == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
@@ -7006,7 +8168,7 @@ FwCmdGetLatchSystemShutdownStateInfo(
   CopyMem_S(pLastSystemShutdownStateInfo, sizeof(*pLastSystemShutdownStateInfo), pFwCmd->OutPayload, sizeof(*pLastSystemShutdownStateInfo));
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -7193,14 +8355,168 @@ EFI_STATUS ClearPcdCacheOnDimmList(VOID)
         if (NULL != pDimm) {
           // Free memory and set to NULL so won't be used by Get PCD calls
           FREE_POOL_SAFE(pDimm->pPcdOem);
+          FREE_POOL_SAFE(pDimm->pPcdLsa);
         }
       }
     }
   }
 #endif // PCD_CACHE_ENABLED
+  BumpPcdCacheGeneration();
   return EFI_SUCCESS;
 }
 
+/**
+Invalidates the PCD cache of every DIMM without freeing it.
+Called by every writer of the PCD, the next read fetches the PCD again.
+**/
+VOID BumpPcdCacheGeneration(VOID)
+{
+#ifdef OS_BUILD
+  if (gpPcdCacheGenerationLock != NULL) {
+    os_mutex_lock(gpPcdCacheGenerationLock);
+    gPcdCacheGeneration++;
+    os_mutex_unlock(gpPcdCacheGenerationLock);
+    return;
+  }
+#endif
+  gPcdCacheGeneration++;
+}
+
+/**
+Creates the lock serializing the PCD cache generation bumps.
+Called from the main thread before any DIMM worker thread is started.
+**/
+VOID InitPcdCacheGenerationLock(VOID)
+{
+#ifdef OS_BUILD
+  if (gpPcdCacheGenerationLock == NULL) {
+    gpPcdCacheGenerationLock = os_mutex_init(NULL);
+  }
+#endif
+}
+
+/**
+Requests a validity probe of the cached PCD before its next use.
+The probe compares the cached table headers with the ones on the DIMM, so
+changes made outside of this library are noticed without a full reread.
+**/
+VOID RequestPcdCacheProbe(VOID)
+{
+  gPcdCacheProbeEpoch++;
+}
+
+/**
+Starts a new invocation, the SMART snapshots taken before are read again on
+their next use unless a TTL is configured.
+**/
+VOID StartSmartSnapshotEpoch(VOID)
+{
+  gSmartSnapshotEpoch++;
+}
+
+/**
+  Check if the SMART snapshot of a DIMM can still be used
+
+  @param[in] pDimm The DIMM
+
+  @retval TRUE the snapshot was taken in the current invocation, or within the
+          configured TTL, and no FW command changed the DIMM since
+**/
+BOOLEAN
+IsSmartSnapshotValid(
+  IN     DIMM *pDimm
+  )
+{
+#ifdef OS_BUILD
+  UINT32 TtlMs = ConfigSmartSnapshotTtlMs();
+
+  return IsSmartSnapshotFresh(pDimm, TtlMs, (TtlMs > 0) ? GetCurrentMilliseconds() : 0);
+#else
+  return IsSmartSnapshotFresh(pDimm, 0, 0);
+#endif
+}
+
+/**
+  Check if the SMART snapshot of a DIMM is fresh for a given TTL
+
+  @param[in] pDimm The DIMM
+  @param[in] TtlMs Time in milliseconds a snapshot is kept, 0 to keep it for one invocation
+  @param[in] NowMs Current time in milliseconds, unused without a TTL
+
+  @retval TRUE the snapshot was taken in the current invocation, or less than
+          TtlMs before NowMs, and no FW command changed the DIMM since
+**/
+BOOLEAN
+IsSmartSnapshotFresh(
+  IN     DIMM *pDimm,
+  IN     UINT32 TtlMs,
+  IN     UINT64 NowMs
+  )
+{
+  if (pDimm == NULL || !pDimm->SmartSnapshotValid) {
+    return FALSE;
+  }
+  if (TtlMs > 0) {
+    return NowMs - pDimm->SmartSnapshotTimeMs < TtlMs;
+  }
+  return pDimm->SmartSnapshotEpoch == gSmartSnapshotEpoch;
+}
+
+/**
+  Mark the SMART snapshot of a DIMM as just taken
+
+  The snapshot is only valid when it was read successfully.
+
+  @param[in, out] pDimm The DIMM
+**/
+VOID
+StampSmartSnapshot(
+  IN OUT DIMM *pDimm
+  )
+{
+  pDimm->SmartSnapshotEpoch = gSmartSnapshotEpoch;
+#ifdef OS_BUILD
+  pDimm->SmartSnapshotTimeMs = GetCurrentMilliseconds();
+#endif
+  pDimm->SmartSnapshotValid = !EFI_ERROR(pDimm->SmartSnapshotReturnCode);
+  pDimm->SmartSnapshotFetches++;
+}
+
+/**
+  Check if a FW command leaves the SMART and health data of a DIMM unchanged
+
+  Get commands keep the snapshot unless the Command Effect Log marks them as
+  mutating, any other command has to be known as read-only.
+
+  @param[in] Opcode Opcode of the command
+  @param[in] SubOpcode SubOpcode of the command
+  @param[in] Effect Effect of the command from GetFwCmdEffect()
+
+  @retval TRUE the SMART snapshot of the DIMM is still valid
+**/
+STATIC
+BOOLEAN
+IsFwCmdSmartNeutral(
+  IN     UINT8 Opcode,
+  IN     UINT8 SubOpcode,
+  IN     FW_CMD_EFFECT Effect
+  )
+{
+  switch (Opcode) {
+  case PtIdentifyDimm:
+  case PtGetSecInfo:
+  case PtGetFeatures:
+  case PtGetAdminFeatures:
+  case PtGetLog:
+    return Effect != FwCmdEffectMutating;
+  case PtEmulatedBiosCommands:
+    // Only the vendor specific command reaches the DIMM FW, the others access the mailbox
+    return SubOpcode != SubopExtVendorSpecific;
+  default:
+    return Effect == FwCmdEffectReadOnly;
+  }
+}
+
 /**
   Return what passthru method will be used to send the command.
 
@@ -7315,6 +8631,162 @@ Finish:
   return ReturnCode;
 }
 
+#ifdef OS_BUILD
+#ifdef DEBUG_BUILD
+#define FW_CMD_POOL_STATS
+#endif
+#elif !defined(MDEPKG_NDEBUG)
+#define FW_CMD_POOL_STATS
+#endif
+
+/**
+  Firmware command buffers kept for reuse. Each buffer embeds both large
+  payloads (2MB), so allocating and releasing one per command dominates read
+  heavy flows. The pool holds one buffer per command in flight, worker threads
+  included, up to FW_CMD_POOL_MAX.
+**/
+#define FW_CMD_POOL_MAX 8
+
+STATIC NVM_FW_CMD *gpFwCmdPool[FW_CMD_POOL_MAX];
+STATIC UINT32 gFwCmdPoolCount = 0;
+#ifdef OS_BUILD
+STATIC OS_MUTEX *gpFwCmdPoolLock = NULL;
+#endif
+#ifdef FW_CMD_POOL_STATS
+STATIC UINT32 gFwCmdPoolAllocations = 0;
+STATIC UINT32 gFwCmdPoolReuses = 0;
+#endif
+
+STATIC
+VOID
+LockFwCmdPool(
+  )
+{
+#ifdef OS_BUILD
+  // The first command is sent from the main thread while the DIMMs are
+  // initialized, before any worker thread exists
+  if (gpFwCmdPoolLock == NULL) {
+    gpFwCmdPoolLock = os_mutex_init(NULL);
+  }
+  if (gpFwCmdPoolLock != NULL) {
+    os_mutex_lock(gpFwCmdPoolLock);
+  }
+#endif
+}
+
+STATIC
+VOID
+UnlockFwCmdPool(
+  )
+{
+#ifdef OS_BUILD
+  if (gpFwCmdPoolLock != NULL) {
+    os_mutex_unlock(gpFwCmdPoolLock);
+  }
+#endif
+}
+
+/**
+  Get a cleared firmware command buffer, reusing a pooled one when available
+
+  The large payload areas of a reused buffer are only cleared up to the large
+  payload sizes of its previous command, so callers provide large input data
+  for the whole LargeInputPayloadSize they set.
+
+  @retval Pointer to the buffer, to be released with FreeFwCmd
+  @retval NULL memory allocation failure
+**/
+NVM_FW_CMD *
+AllocateFwCmd(
+  )
+{
+  NVM_FW_CMD *pFwCmd = NULL;
+
+  LockFwCmdPool();
+  if (gFwCmdPoolCount > 0) {
+    pFwCmd = gpFwCmdPool[--gFwCmdPoolCount];
+    gpFwCmdPool[gFwCmdPoolCount] = NULL;
+#ifdef FW_CMD_POOL_STATS
+    gFwCmdPoolReuses++;
+#endif
+  }
+#ifdef FW_CMD_POOL_STATS
+  else {
+    gFwCmdPoolAllocations++;
+  }
+#endif
+  UnlockFwCmdPool();
+
+  if (pFwCmd == NULL) {
+    pFwCmd = AllocateZeroPool(sizeof(NVM_FW_CMD));
+  }
+  return pFwCmd;
+}
+
+/**
+  Release a firmware command buffer from AllocateFwCmd back to the pool
+
+  @param[in] pFwCmd Buffer to release, may be NULL
+**/
+VOID
+FreeFwCmd(
+  IN     NVM_FW_CMD *pFwCmd
+  )
+{
+  if (pFwCmd == NULL) {
+    return;
+  }
+
+  // Clear what the command may have used, the payloads can hold secrets
+  ZeroMem(pFwCmd->LargeInputPayload, MIN(pFwCmd->LargeInputPayloadSize, IN_MB_SIZE));
+  if (pFwCmd->pLargeOutputBuffer == NULL) {
+    ZeroMem(pFwCmd->LargeOutputPayload, MIN(pFwCmd->LargeOutputPayloadSize, OUT_MB_SIZE));
+  }
+  ZeroMem(pFwCmd->InputPayload, sizeof(pFwCmd->InputPayload));
+  ZeroMem(pFwCmd->OutPayload, sizeof(pFwCmd->OutPayload));
+  pFwCmd->InputPayloadSize = 0;
+  pFwCmd->LargeInputPayloadSize = 0;
+  pFwCmd->OutputPayloadSize = 0;
+  pFwCmd->LargeOutputPayloadSize = 0;
+  pFwCmd->DimmID = 0;
+  pFwCmd->Opcode = 0;
+  pFwCmd->SubOpcode = 0;
+  pFwCmd->Status = 0;
+#ifdef OS_BUILD
+  pFwCmd->DsmStatus = 0;
+#endif
+  pFwCmd->pLargeOutputBuffer = NULL;
+
+  LockFwCmdPool();
+  if (gFwCmdPoolCount < FW_CMD_POOL_MAX) {
+    gpFwCmdPool[gFwCmdPoolCount++] = pFwCmd;
+    pFwCmd = NULL;
+  }
+  UnlockFwCmdPool();
+
+  FREE_POOL_SAFE(pFwCmd);
+}
+
+/**
+  Free the firmware command buffers kept in the pool
+**/
+VOID
+FreeFwCmdPool(
+  )
+{
+  UINT32 Index = 0;
+
+  LockFwCmdPool();
+#ifdef FW_CMD_POOL_STATS
+  NVDIMM_DBG("FW command buffers: %d allocated, %d reused", gFwCmdPoolAllocations, gFwCmdPoolReuses);
+#endif
+  for (Index = 0; Index < gFwCmdPoolCount; Index++) {
+    FREE_POOL_SAFE(gpFwCmdPool[Index]);
+  }
+  gFwCmdPoolCount = 0;
+  UnlockFwCmdPool();
+}
+
 EFI_STATUS
 PassThru(
   IN     struct _DIMM *pDimm,
@@ -7325,10 +8797,27 @@ PassThru(
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
   DIMM_PASSTHRU_METHOD Method = DimmPassthruDdrtLargePayload;
   BOOLEAN IsLargePayloadCommand = FALSE;
+  FW_CMD_EFFECT Effect = FwCmdEffectUnknown;
 
 #ifdef OS_BUILD
   UINT8 InputPayloadTemp[IN_PAYLOAD_SIZE];
   NVM_INPUT_PAYLOAD_SMBUS_OS_PASSTHRU *pInputPayloadSOP = NULL;
+  BOOLEAN OrderLocked = FALSE;
+#endif
+
+  if (pDimm == NULL || pCmd == NULL) {
+    goto Finish;
+  }
+
+  // Classified before it is sent, the first command of a FW build fetches its CEL
+  Effect = GetFwCmdEffect(pDimm, pCmd->Opcode, pCmd->SubOpcode);
+#ifdef OS_BUILD
+  // Read-only commands may overlap and pass each other, the others are sent
+  // one at a time per DIMM in the order the threads get to them
+  if (Effect != FwCmdEffectReadOnly && pDimm->pFwCmdOrderLock != NULL) {
+    os_mutex_lock(pDimm->pFwCmdOrderLock);
+    OrderLocked = TRUE;
+  }
 #endif
 
   IsLargePayloadCommand = pCmd->LargeInputPayloadSize > 0;
@@ -7397,6 +8886,23 @@ PassThru(
 #endif // OS_BUILD
 
 Finish:
+#ifdef OS_BUILD
+  if (OrderLocked) {
+    os_mutex_unlock(pDimm->pFwCmdOrderLock);
+  }
+#endif
+  if (pDimm != NULL && pCmd != NULL && !IsFwCmdSmartNeutral(pCmd->Opcode, pCmd->SubOpcode, Effect)) {
+    pDimm->SmartSnapshotValid = FALSE;
+  }
+#ifdef FW_CMD_POOL_STATS
+  if (pCmd != NULL) {
+    // Each payload crosses the transport buffers once, the large output is
+    // not copied again when it lands in the caller buffer
+    NVDIMM_DBG("FW command 0x%x:0x%x copied %d bytes, large output into caller buffer %d", pCmd->Opcode, pCmd->SubOpcode,
+      pCmd->InputPayloadSize + pCmd->LargeInputPayloadSize + pCmd->OutputPayloadSize + pCmd->LargeOutputPayloadSize,
+      pCmd->pLargeOutputBuffer != NULL);
+  }
+#endif
   return ReturnCode;
 }
 
@@ -7428,7 +8934,7 @@ FwCmdGetBsr(
   }
 
 
-  CHECK_RESULT_MALLOC(pFwCmd, AllocateZeroPool(sizeof(*pFwCmd)), Finish);
+  CHECK_RESULT_MALLOC(pFwCmd, AllocateFwCmd(), Finish);
 
   pFwCmd->DimmID = pDimm->DimmID;
   pFwCmd->Opcode = PtEmulatedBiosCommands;
@@ -7445,7 +8951,7 @@ FwCmdGetBsr(
   NVDIMM_ERR("Bsr received is 0x%x", *pBsrValue);
 
 Finish:
-  FREE_POOL_SAFE(pFwCmd);
+  FreeFwCmd(pFwCmd);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -7641,7 +9147,7 @@ DcpmmCmd(
       goto Finish;
     } else {
       ReturnCode = DcpmmLargePayloadRead(pDimm, pCmd->LargeOutputPayloadSize, pLargePayloadInfo->Data.LpInfo.DataChunkSize,
-        Timeout, DcpmmInterface, pCmd->LargeOutputPayload, &pCmd->Status);
+        Timeout, DcpmmInterface, FW_CMD_LARGE_OUTPUT(pCmd), &pCmd->Status);
       if (EFI_ERROR(ReturnCode)) {
         NVDIMM_ERR("Error detected when sending DcpmmLargePayloadRead");
         FW_CMD_ERROR_TO_EFI_STATUS(pCmd, ReturnCode);
@@ -249,6 +249,7 @@ typedef struct _DIMM {
   BOOLEAN FlushRequired;          //!< The boolean value indicating when the Aperature needs to be flushed before IO
   BOOLEAN ControlWindowLatch;
   BOOLEAN EncryptionEnabled;      //!< True if the DIMMs security is enabled
+  UINT8 ArsStatus;                //!< Last ARS status read from the DIMM, ARS_STATUS_UNKNOWN until then
   UINT16 NvDimmStateFlags;
 
   /** Current regions config **/
@@ -281,9 +282,22 @@ typedef struct _DIMM {
   UINT8 GoalConfigStatus;                         //!< Active only if RegionsGoalConfig is TRUE
 
   VOID *pPcdLsa;
+  UINT32 PcdLsaCacheGeneration;                   //!< gPcdCacheGeneration the pPcdLsa cache was filled at
   // Always allocated to be size of PCD_OEM_PARTITION_INTEL_CFG_REGION_SIZE
   VOID *pPcdOem;
   UINT32 PcdOemSize;
+  UINT32 PcdOemCacheGeneration;                   //!< gPcdCacheGeneration the pPcdOem cache was filled at
+  UINT32 PcdOemProbeEpoch;                        //!< gPcdCacheProbeEpoch the pPcdOem cache was last probed at
+
+  SMART_AND_HEALTH_INFO SmartSnapshot;            //!< Last SMART and health info read from the DIMM
+  EFI_STATUS SmartSnapshotReturnCode;             //!< Result of reading the SmartSnapshot
+  BOOLEAN SmartSnapshotValid;                     //!< Cleared by every FW command that may change the SMART data
+  UINT32 SmartSnapshotEpoch;                      //!< gSmartSnapshotEpoch the SmartSnapshot was taken at
+  UINT64 SmartSnapshotTimeMs;                     //!< Time the SmartSnapshot was taken at, used with a TTL
+  UINT32 SmartSnapshotFetches;                    //!< Number of SMART and health reads from the DIMM
+  UINT32 SmartSnapshotHits;                       //!< Number of reads served from the SmartSnapshot
+
+  VOID *pFwCmdOrderLock;                          //!< OS_MUTEX sending the FW commands not known as read-only one at a time
 
   UINT16 ControllerRid;             //!< Revision ID of the subsystem memory controller from FIS
 
@@ -345,7 +359,7 @@ typedef struct _MEMMAP_RANGE {
 #define MEMMAP_RANGE_FROM_NODE(a)  CR(a, MEMMAP_RANGE, MemmapNode, MEMMAP_RANGE_SIGNATURE)
 
 #define DISABLE_ARS_TOTAL_TIMEOUT_SEC     2
-#define POLL_ARS_LONG_OP_DELAY_US         100000  //100ms delay between calls to retrieve long op
+#define POLL_LONG_OP_DELAY_US             100000  //100ms delay between rounds of long op status requests
 #define MAX_FW_UPDATE_RETRY_ON_DEV_BUSY   10 // Account for ARS potentially getting restarted a few times in the background
 #define DSM_RETRY_SUGGESTED               0x5
 
@@ -366,6 +380,15 @@ BOOLEAN ConfigIsLargePayloadDisabled();
 * It returns TRUE in case of DDRT protocol access is disabled and FALSE otherwise
 */
 BOOLEAN ConfigIsDdrtProtocolDisabled();
+
+#define INI_PREFERENCES_SMART_SNAPSHOT_TTL_MS L"SMART_SNAPSHOT_TTL_MS"
+/*
+* Function get the ini configuration only on the first call
+*
+* It returns the time in milliseconds a SMART snapshot is kept, 0 to keep it
+* for one invocation
+*/
+UINT32 ConfigSmartSnapshotTtlMs();
 #endif // OS_BUILD
 
 EFI_STATUS
@@ -638,6 +661,23 @@ RefreshDimm(
   IN OUT DIMM *pDimm
   );
 
+/**
+  Refreshes the inventory entry of a single DIMM without rebuilding the
+  whole DIMM list: rereads the identify and security information and drops
+  the cached PCD of that DIMM.
+
+  @param[in,out] pDimm the DIMM that we want to refresh.
+
+  @retval EFI_SUCCESS - the DIMM was refreshed successfully.
+  @retval EFI_INVALID_PARAMETER - pDimm is NULL.
+  @retval EFI_OUT_OF_RESOURCES - the memory allocation failed.
+  @retval Other errors from the FW commands
+**/
+EFI_STATUS
+RefreshDimmInventoryEntry(
+  IN OUT DIMM *pDimm
+  );
+
 EFI_STATUS
 RemoveDimm(
      OUT DIMM *pDimm,
@@ -852,6 +892,98 @@ FwCmdGetCommandEffectLog(
   IN      UINT32 LargeOutputPayloadSize OPTIONAL
 );
 
+/**
+  Effect of a FW command on the PMem module, from its Command Effect Log
+**/
+typedef enum _FW_CMD_EFFECT {
+  FwCmdEffectUnknown = 0,       //!< CEL not readable yet, or no CEL entry for the command
+  FwCmdEffectReadOnly = 1,      //!< No effects, safe to reorder, retry or run in parallel
+  FwCmdEffectMutating = 2       //!< Changes the state of the PMem module
+} FW_CMD_EFFECT;
+
+/**
+  Get the Command Effect Log of a DIMM
+
+  The CEL is read from the DIMM only once per FW build, later calls for any
+  DIMM running the same FW return the cached table. A read that failed before
+  is retried.
+
+  @param[in] pDimm The DIMM
+  @param[out] ppLogEntry Cached CEL table, owned by the cache and not to be freed
+  @param[out] pEntryCount Number of entries of the table
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER one or more parameters are NULL
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval other FW command failure
+**/
+EFI_STATUS
+GetDimmCommandEffectLog(
+  IN     DIMM *pDimm,
+     OUT COMMAND_EFFECT_LOG_ENTRY **ppLogEntry,
+     OUT UINT32 *pEntryCount
+  );
+
+/**
+  Classify a FW command by its entry in the Command Effect Log
+
+  The CEL of the FW build of the DIMM is read by the first lookup and cached,
+  the passthrough classifies every command before sending it. Read-only
+  commands may be reordered, retried or sent to several DIMMs in parallel.
+
+  @param[in] pDimm The DIMM the command is sent to
+  @param[in] Opcode Opcode of the command
+  @param[in] SubOpcode SubOpcode of the command
+
+  @retval FwCmdEffectReadOnly the command has no effects
+  @retval FwCmdEffectMutating the command changes the state of the DIMM
+  @retval FwCmdEffectUnknown the CEL could not be read or has no entry for the command
+**/
+FW_CMD_EFFECT
+GetFwCmdEffect(
+  IN     DIMM *pDimm,
+  IN     UINT8 Opcode,
+  IN     UINT8 SubOpcode
+  );
+
+/**
+  Free all cached Command Effect Logs
+**/
+VOID
+FreeCommandEffectLogCache(
+  );
+
+/**
+  Get a cleared firmware command buffer, reusing a pooled one when available
+
+  The large payload areas of a reused buffer are only cleared up to the large
+  payload sizes of its previous command, so callers provide large input data
+  for the whole LargeInputPayloadSize they set.
+
+  @retval Pointer to the buffer, to be released with FreeFwCmd
+  @retval NULL memory allocation failure
+**/
+NVM_FW_CMD *
+AllocateFwCmd(
+  );
+
+/**
+  Release a firmware command buffer from AllocateFwCmd back to the pool
+
+  @param[in] pFwCmd Buffer to release, may be NULL
+**/
+VOID
+FreeFwCmd(
+  IN     NVM_FW_CMD *pFwCmd
+  );
+
+/**
+  Free the firmware command buffers kept in the pool
+**/
+VOID
+FreeFwCmdPool(
+  );
+
 /**
   Firmware command to get a specified debug log
 
@@ -876,6 +1008,37 @@ FwCmdGetFwDebugLog (
      OUT COMMAND_STATUS *pCommandStatus
   );
 
+/**
+  Firmware command to stream a specified debug log page by page
+
+  Every page is handed to the handler as soon as it arrives, so no buffer
+  of the whole log size is needed.
+
+  @param[in]  pDimm Target DIMM structure pointer
+  @param[in]  LogSource Debug log source buffer to retrieve
+  @param[in]  StartPageOffset Page to start from, non zero to resume an interrupted stream
+  @param[in]  pHandler Consumer of the fetched pages
+  @param[in]  pContext Context passed to the handler
+  @param[out] pNextPageOffset Page to resume from if the stream stopped early. OPTIONAL
+  @param[out] pCommandStatus structure containing detailed NVM error codes
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_NOT_STARTED No logs to fetch
+  @retval EFI_INVALID_PARAMETER NULL parameter or invalid log source
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval Other errors returned by the FW command or the handler
+**/
+EFI_STATUS
+FwCmdGetFwDebugLogStream (
+  IN     DIMM *pDimm,
+  IN     UINT8 LogSource,
+  IN     UINT32 StartPageOffset,
+  IN     FW_DEBUG_LOG_PAGE_HANDLER pHandler,
+  IN     VOID *pContext,
+     OUT UINT32 *pNextPageOffset OPTIONAL,
+     OUT COMMAND_STATUS *pCommandStatus
+  );
+
  /**
   Firmware command to get debug logs size in MB
 
@@ -1229,6 +1392,105 @@ FwCmdGetLongOperationStatus(
      OUT PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *pLongOpStatus
   );
 
+/**
+  Called by PollLongOpStatusOnDimms as soon as the long operation of a DIMM
+  stops being busy, fails to be polled or times out.
+
+  @param[in] pContext Context passed to PollLongOpStatusOnDimms
+  @param[in] pDimm DIMM whose long operation finished
+  @param[in] pLongOpStatus Last long operation status read from the DIMM
+  @param[in] ReturnCode Result for the DIMM, as stored in pReturnCodes
+**/
+typedef
+VOID
+(*LONG_OP_COMPLETION_HANDLER) (
+  IN     VOID *pContext,
+  IN     DIMM *pDimm,
+  IN     PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *pLongOpStatus,
+  IN     EFI_STATUS ReturnCode
+  );
+
+/**
+  Poll the long operation status of several DIMMs in one loop
+
+  Every round requests the long operation status of each DIMM that is still
+  busy, then waits POLL_LONG_OP_DELAY_US once for all of them, so the DIMMs
+  share one timeout instead of being waited on one after another.
+
+  @param[in] ppDimms DIMMs running the long operation
+  @param[in] DimmsNum Number of DIMMs in ppDimms
+  @param[in] OpcodeToPoll Opcode of the long operation, 0 to accept any
+  @param[in] SubOpcodeToPoll Subopcode of the long operation
+  @param[in] TimeoutSecs Timeout shared by all DIMMs, 0 to read the status once
+  @param[in] pHandler Optional per DIMM completion callback
+  @param[in] pContext Context passed to pHandler
+  @param[out] pReturnCodes Per DIMM result, DimmsNum entries:
+    EFI_SUCCESS the operation is no longer busy,
+    EFI_NOT_STARTED no long operation is reported by the DIMM,
+    EFI_DEVICE_ERROR the DIMM reports a different operation,
+    EFI_TIMEOUT the DIMM was still busy when the timeout expired,
+    or the error of the status request
+
+  @retval EFI_SUCCESS All DIMMs finished their operation
+  @retval EFI_INVALID_PARAMETER One or more parameters are NULL
+  @retval Other the first error found in pReturnCodes
+**/
+EFI_STATUS
+PollLongOpStatusOnDimms(
+  IN     DIMM **ppDimms,
+  IN     UINT32 DimmsNum,
+  IN     UINT8 OpcodeToPoll OPTIONAL,
+  IN     UINT8 SubOpcodeToPoll OPTIONAL,
+  IN     UINT32 TimeoutSecs,
+  IN     LONG_OP_COMPLETION_HANDLER pHandler OPTIONAL,
+  IN     VOID *pContext OPTIONAL,
+     OUT EFI_STATUS *pReturnCodes
+  );
+
+/**
+  Work done on a single DIMM by RunOnDimms
+
+  @param[in] pDimm DIMM to work on
+  @param[in] pArg Argument of this DIMM, as passed to RunOnDimms
+
+  @retval Result of the work on the DIMM
+**/
+typedef
+EFI_STATUS
+(*DIMM_WORKER) (
+  IN     DIMM *pDimm,
+  IN     VOID *pArg
+  );
+
+/**
+  Run a worker on each DIMM of an array
+
+  In the OS build every DIMM gets its own thread, so FW commands of different
+  DIMMs overlap. A recorded or replayed session needs the FW commands in a
+  fixed order, so there and in UEFI the DIMMs are worked on one after another.
+  The worker must only touch its own DIMM; results are gathered in
+  pReturnCodes and are expected to be reported by the caller afterwards.
+
+  @param[in] ppDimms DIMMs to work on
+  @param[in] DimmsNum Number of DIMMs in ppDimms
+  @param[in] pWorker Function run for each DIMM
+  @param[in] ppArgs Optional per DIMM arguments, DimmsNum entries
+  @param[out] pReturnCodes Per DIMM result of pWorker, DimmsNum entries
+
+  @retval EFI_SUCCESS pWorker succeeded on all DIMMs
+  @retval EFI_INVALID_PARAMETER One or more parameters are NULL
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+  @retval Other the first error found in pReturnCodes
+**/
+EFI_STATUS
+RunOnDimms(
+  IN     DIMM **ppDimms,
+  IN     UINT32 DimmsNum,
+  IN     DIMM_WORKER pWorker,
+  IN     VOID **ppArgs OPTIONAL,
+     OUT EFI_STATUS *pReturnCodes
+  );
+
 /**
   Execute Firmware command to Get DIMM Partition Info
 
@@ -1559,6 +1821,23 @@ FwCmdSetOptionalConfigurationDataPolicy(
   IN     PT_OPTIONAL_DATA_POLICY_PAYLOAD *pOptionalDataPolicyPayload
   );
 
+/**
+  Compare two error log sequence numbers that wrap around at MAX_UINT16
+
+  Serial number arithmetic: SequenceNumber is after OtherSequenceNumber when
+  it is less than half of the UINT16 range ahead of it.
+
+  @param[in] SequenceNumber - sequence number to check
+  @param[in] OtherSequenceNumber - sequence number to compare with
+
+  @retval TRUE if SequenceNumber was logged after OtherSequenceNumber
+**/
+BOOLEAN
+IsSequenceNumberAfter(
+  IN     UINT16 SequenceNumber,
+  IN     UINT16 OtherSequenceNumber
+  );
+
 /**
   Get error logs for given dimm parse it and save in common error log structure
 
@@ -1961,6 +2240,73 @@ Clears the PCD Cache on each DIMM in the global DIMM list
 **/
 EFI_STATUS ClearPcdCacheOnDimmList(VOID);
 
+/**
+Invalidates the PCD cache of every DIMM without freeing it.
+Called by every writer of the PCD, the next read fetches the PCD again.
+**/
+VOID BumpPcdCacheGeneration(VOID);
+
+/**
+Creates the lock serializing the PCD cache generation bumps.
+Called from the main thread before any DIMM worker thread is started.
+**/
+VOID InitPcdCacheGenerationLock(VOID);
+
+/**
+Requests a validity probe of the cached PCD before its next use.
+The probe compares the cached table headers with the ones on the DIMM, so
+changes made outside of this library are noticed without a full reread.
+**/
+VOID RequestPcdCacheProbe(VOID);
+
+/**
+Starts a new invocation, the SMART snapshots taken before are read again on
+their next use unless a TTL is configured.
+**/
+VOID StartSmartSnapshotEpoch(VOID);
+
+/**
+  Check if the SMART snapshot of a DIMM can still be used
+
+  @param[in] pDimm The DIMM
+
+  @retval TRUE the snapshot was taken in the current invocation, or within the
+          configured TTL, and no FW command changed the DIMM since
+**/
+BOOLEAN
+IsSmartSnapshotValid(
+  IN     DIMM *pDimm
+  );
+
+/**
+  Check if the SMART snapshot of a DIMM is fresh for a given TTL
+
+  @param[in] pDimm The DIMM
+  @param[in] TtlMs Time in milliseconds a snapshot is kept, 0 to keep it for one invocation
+  @param[in] NowMs Current time in milliseconds, unused without a TTL
+
+  @retval TRUE the snapshot was taken in the current invocation, or less than
+          TtlMs before NowMs, and no FW command changed the DIMM since
+**/
+BOOLEAN
+IsSmartSnapshotFresh(
+  IN     DIMM *pDimm,
+  IN     UINT32 TtlMs,
+  IN     UINT64 NowMs
+  );
+
+/**
+  Mark the SMART snapshot of a DIMM as just taken
+
+  The snapshot is only valid when it was read successfully.
+
+  @param[in, out] pDimm The DIMM
+**/
+VOID
+StampSmartSnapshot(
+  IN OUT DIMM *pDimm
+  );
+
 /**
   Set Obj Status when DIMM is not found using Id expected by end user
 
@@ -28,7 +28,6 @@ extern EFI_BLOCK_IO_MEDIA gNvmDimmDriverBlockIoMedia;
 extern CONST UINT64 gSupportedBlockSizes[SUPPORTED_BLOCK_SIZES_COUNT];
 
 #ifndef OS_BUILD
-extern DCPMM_ARS_ERROR_RECORD * gArsBadRecords;
 extern INT32 gArsBadRecordsCount;
 #endif
 
@@ -2621,6 +2620,7 @@ IoNamespaceBlock(
 /**
   Performs a read or write to the AppDirect Namespace.
   The data is read/written from/to Interlave Set mapped in system memory.
+  In the OS build the data comes from the namespace image mapped into pImage.
 
   @param[in] pNamespace Intel NVM Dimm Namespace to perform the IO operation.
   @param[in] Offset Offset of AppDirect Namespace
@@ -2630,6 +2630,7 @@ IoNamespaceBlock(
 
   @retval EFI_SUCCESS If the IO operation was performed without errors.
   @retval EFI_INVALID_PARAMETER Input parameter is NULL
+  @retval EFI_UNSUPPORTED OS build without a mapped namespace image
 **/
 EFI_STATUS
 AppDirectIo(
@@ -2686,7 +2687,25 @@ Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 #else
-  return EFI_UNSUPPORTED;
+  UINT8 *pAddress = NULL;
+
+  /** The OS build only supports I/O against a mapped namespace image **/
+  if (pNamespace == NULL || pNamespace->pImage == NULL) {
+    return EFI_UNSUPPORTED;
+  }
+
+  if (pBuffer == NULL || Offset > pNamespace->ImageSize || Nbytes > pNamespace->ImageSize - Offset) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  pAddress = (UINT8 *) pNamespace->pImage + Offset;
+  if (ReadOperation) {
+    CopyMem(pBuffer, pAddress, Nbytes);
+  } else {
+    CopyMem(pAddress, pBuffer, Nbytes);
+  }
+
+  return EFI_SUCCESS;
 #endif
 }
 
@@ -2807,6 +2826,90 @@ WriteBlockDevice(
   }
 }
 
+/**
+  Read a number of consecutive blocks from the namespace
+  BTT namespaces serve the whole range through a single lane with coalesced
+  map reads, other namespace types are read block by block.
+
+  @param[in] pNamespace Namespace that data will be read from
+  @param[in] Lba First LBA to read
+  @param[in] NumBlocks Number of blocks to read
+  @param[out] pBuffer pointer to the memory where the result should be stored,
+    at least NumBlocks * Namespace block size bytes
+
+  @retval EFI_SUCCESS on a successful read
+  @retval Error return values from ReadBlockDevice or BttReadBlocks function
+**/
+EFI_STATUS
+ReadBlockDeviceRange(
+  IN     NAMESPACE *pNamespace,
+  IN     UINT64 Lba,
+  IN     UINT64 NumBlocks,
+     OUT CHAR8 *pBuffer
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  UINT64 Index = 0;
+
+  if (pNamespace->IsBttEnabled) {
+    if (pNamespace->pBtt == NULL) {
+      return EFI_NOT_READY;
+    }
+    return BttReadBlocks(pNamespace->pBtt, Lba, NumBlocks, pBuffer);
+  }
+
+  for (Index = 0; Index < NumBlocks; Index++) {
+    ReturnCode = ReadBlockDevice(pNamespace, Lba + Index, pBuffer + (Index * pNamespace->Media.BlockSize));
+    if (EFI_ERROR(ReturnCode)) {
+      break;
+    }
+  }
+
+  return ReturnCode;
+}
+
+/**
+  Write a number of consecutive blocks to the namespace
+  BTT namespaces serve the whole range through a single lane, other
+  namespace types are written block by block.
+
+  @param[in] pNamespace Namespace that data will be written to
+  @param[in] Lba First LBA to write
+  @param[in] NumBlocks Number of blocks to write
+  @param[in] pBuffer pointer to the memory where the source data resides,
+    at least NumBlocks * Namespace block size bytes
+
+  @retval EFI_SUCCESS on a successful write
+  @retval Error return values from WriteBlockDevice or BttWriteBlocks function
+**/
+EFI_STATUS
+WriteBlockDeviceRange(
+  IN     NAMESPACE *pNamespace,
+  IN     UINT64 Lba,
+  IN     UINT64 NumBlocks,
+  IN     CHAR8 *pBuffer
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  UINT64 Index = 0;
+
+  if (pNamespace->IsBttEnabled) {
+    if (pNamespace->pBtt == NULL) {
+      return EFI_NOT_READY;
+    }
+    return BttWriteBlocks(pNamespace->pBtt, Lba, NumBlocks, pBuffer);
+  }
+
+  for (Index = 0; Index < NumBlocks; Index++) {
+    ReturnCode = WriteBlockDevice(pNamespace, Lba + Index, pBuffer + (Index * pNamespace->Media.BlockSize));
+    if (EFI_ERROR(ReturnCode)) {
+      break;
+    }
+  }
+
+  return ReturnCode;
+}
+
 /**
   Compare region length field in MemoryMapRange Struct
 
@@ -2977,9 +3080,9 @@ FindADMemmapRangeInIS(
   ISEndDpa = ISStartDpa + pDimmRegion->PartitionSize;
 
   if (Size == MAX_UINT64_VALUE) {
-    ReturnCode = BubbleSortLinkedList(ppFreemapList[0], CompareRegionLengthInMemoryRange);
+    ReturnCode = MergeSortLinkedList(ppFreemapList[0], CompareRegionLengthInMemoryRange);
   } else {
-    ReturnCode = BubbleSortLinkedList(ppFreemapList[0], CompareRegionDpaStartInMemoryRange);
+    ReturnCode = MergeSortLinkedList(ppFreemapList[0], CompareRegionDpaStartInMemoryRange);
   }
 
   if (EFI_ERROR(ReturnCode)) {
@@ -3695,9 +3798,60 @@ Finish:
   return ReturnCode;
 }
 
+typedef struct _LSA_INIT_ARG {
+  UINT16 LabelVersionMajor;
+  UINT16 LabelVersionMinor;
+} LSA_INIT_ARG;
+
+/**
+  DIMM_WORKER initializing and verifying the label storage area of one DIMM
+
+  Sets LsaStatus of the DIMM.
+
+  @param[in] pDimm Target DIMM
+  @param[in] pArg LSA_INIT_ARG with the label version to init
+
+  @retval EFI_SUCCESS LSA initialized and read back correctly
+  @retval return codes from InitializeLabelStorageArea and ReadLabelStorageArea
+**/
+STATIC
+EFI_STATUS
+InitializeLabelStorageAreaWorker(
+  IN     DIMM *pDimm,
+  IN     VOID *pArg
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  LSA_INIT_ARG *pInitArg = (LSA_INIT_ARG *)pArg;
+  LABEL_STORAGE_AREA *pLsa = NULL;
+
+  ReturnCode = InitializeLabelStorageArea(pDimm, pInitArg->LabelVersionMajor, pInitArg->LabelVersionMinor, TRUE);
+  if (EFI_ERROR(ReturnCode)) {
+    NVDIMM_DBG("Unable to initialize LSA data on a DIMM 0x%x", pDimm->DeviceHandle.AsUint32);
+    pDimm->LsaStatus = LSA_COULD_NOT_INIT;
+    goto Finish;
+  }
+
+  // Check if the LSA was written properly and is not corrupted
+  ReturnCode = ReadLabelStorageArea(pDimm->DimmID, &pLsa);
+  if (EFI_ERROR(ReturnCode)) {
+    pDimm->LsaStatus = LSA_CORRUPTED_AFTER_INIT;
+    NVDIMM_DBG("LSA corrupted after initialization on DIMM 0x%x", pDimm->DeviceHandle.AsUint32);
+    goto Finish;
+  }
+  pDimm->LsaStatus = LSA_OK;
+
+Finish:
+  FreeLsaSafe(&pLsa);
+  return ReturnCode;
+}
+
 /**
   Clear and initialize all label storage areas
 
+  The DIMMs are initialized in parallel where supported (see RunOnDimms).
+  Every manageable DIMM gets its own object status.
+
   @param[in] ppDimms Array of DIMMs
   @param[in] DimmsNum Number of DIMMs
   @param[in] LabelVersionMajor Major version of label to init
@@ -3706,7 +3860,8 @@ Finish:
 
   @retval EFI_SUCCESS success
   @retval EFI_INVALID_PARAMETER pDimmList is NULL
-  @retval return codes from SendConfigInputToDimm
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval return codes from InitializeLabelStorageArea and ReadLabelStorageArea
 **/
 
 EFI_STATUS
@@ -3719,7 +3874,11 @@ ClearAndInitializeAllLabelStorageAreas(
   )
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
-  LABEL_STORAGE_AREA *pLsa = NULL;
+  LSA_INIT_ARG InitArg;
+  DIMM **ppManageableDimms = NULL;
+  VOID **ppArgs = NULL;
+  EFI_STATUS *pReturnCodes = NULL;
+  UINT32 ManageableDimmsNum = 0;
   UINT32 Index = 0;
 
   NVDIMM_ENTRY();
@@ -3728,34 +3887,48 @@ ClearAndInitializeAllLabelStorageAreas(
     return EFI_INVALID_PARAMETER;
   }
 
+  InitArg.LabelVersionMajor = LabelVersionMajor;
+  InitArg.LabelVersionMinor = LabelVersionMinor;
+
+  if (DimmsNum == 0) {
+    SetCmdStatus(pCommandStatus, NVM_SUCCESS);
+    goto Finish;
+  }
+
+  ppManageableDimms = AllocateZeroPool(DimmsNum * sizeof(*ppManageableDimms));
+  ppArgs = AllocateZeroPool(DimmsNum * sizeof(*ppArgs));
+  pReturnCodes = AllocateZeroPool(DimmsNum * sizeof(*pReturnCodes));
+  if (ppManageableDimms == NULL || ppArgs == NULL || pReturnCodes == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+
   for (Index = 0; Index < DimmsNum; Index++) {
     if (!IsDimmManageable(ppDimms[Index])) {
       continue;
     }
+    ppManageableDimms[ManageableDimmsNum] = ppDimms[Index];
+    ppArgs[ManageableDimmsNum] = &InitArg;
+    ManageableDimmsNum++;
+  }
 
-    ReturnCode = InitializeLabelStorageArea(ppDimms[Index], LabelVersionMajor, LabelVersionMinor, TRUE);
-    if (EFI_ERROR(ReturnCode)) {
-      NVDIMM_DBG("Unable to initialize LSA data on a DIMM 0x%x", ppDimms[Index]->DeviceHandle.AsUint32);
-      ppDimms[Index]->LsaStatus = LSA_COULD_NOT_INIT;
-      SetObjStatusForDimm(pCommandStatus, ppDimms[Index], NVM_ERR_FAILED_TO_INIT_NS_LABELS);
-      goto Finish;
-    }
+  ReturnCode = RunOnDimms(ppManageableDimms, ManageableDimmsNum, InitializeLabelStorageAreaWorker, ppArgs, pReturnCodes);
+  if (ReturnCode == EFI_OUT_OF_RESOURCES) {
+    goto Finish;
+  }
 
-    // Check if the LSA was written properly and is not corrupted
-    ReturnCode = ReadLabelStorageArea(ppDimms[Index]->DimmID, &pLsa);
-    if (EFI_ERROR(ReturnCode)) {
-      ppDimms[Index]->LsaStatus = LSA_CORRUPTED_AFTER_INIT;
-      NVDIMM_DBG("LSA corrupted after initialization on DIMM 0x%x", ppDimms[Index]->DeviceHandle.AsUint32);
-      SetObjStatusForDimm(pCommandStatus, ppDimms[Index], NVM_ERR_FAILED_TO_INIT_NS_LABELS);
-      goto Finish;
-    }
-    FREE_POOL_SAFE(pLsa);
-    ppDimms[Index]->LsaStatus = LSA_OK;
-    SetObjStatusForDimm(pCommandStatus, ppDimms[Index], NVM_SUCCESS);
+  for (Index = 0; Index < ManageableDimmsNum; Index++) {
+    SetObjStatusForDimm(pCommandStatus, ppManageableDimms[Index],
+      EFI_ERROR(pReturnCodes[Index]) ? NVM_ERR_FAILED_TO_INIT_NS_LABELS : NVM_SUCCESS);
+  }
+  if (!EFI_ERROR(ReturnCode)) {
+    SetCmdStatus(pCommandStatus, NVM_SUCCESS);
   }
-  SetCmdStatus(pCommandStatus, NVM_SUCCESS);
 
 Finish:
+  FREE_POOL_SAFE(ppManageableDimms);
+  FREE_POOL_SAFE(ppArgs);
+  FREE_POOL_SAFE(pReturnCodes);
   return ReturnCode;
 }
 
@@ -4622,7 +4795,7 @@ CalculateISetCookie(
     Index++;
   }
 
-  ReturnCode = BubbleSort(ISetCookieData, RegionCount,
+  ReturnCode = MergeSort(ISetCookieData, RegionCount,
       sizeof(NVM_COOKIE_DATA), CompareRegionSpaOffsetInISet);
   if (EFI_ERROR(ReturnCode)) {
     goto Finish;
@@ -4710,7 +4883,7 @@ CalculateISetCookieVer1_1(
     Index++;
   }
 
-  ReturnCode = BubbleSort(ISetCookieData, RegionCount,
+  ReturnCode = MergeSort(ISetCookieData, RegionCount,
       sizeof(NVM_COOKIE_DATA_1_1), CompareRegionSpaOffsetInISet);
   if (EFI_ERROR(ReturnCode)) {
     goto Finish;
@@ -5189,8 +5362,10 @@ GetRawCapacity(
 /**
   Checks to see if a given address block collides with one or more of the addresses BIOS has marked as bad
 
-  @param[in] Address an array of bad addresses as returned from BIOS
-  @param[in] Length the number of bad addresses
+  The ARS list is kept as a sorted interval index, so the check is O(log n) in the number of records.
+
+  @param[in] Address The base address
+  @param[in] Length The address range size
 
   @retval EFI_SUCCESS If the range does not collide
   @retval EFI_DEVICE_ERROR If the range is found to collide with one or more addresses from BIOS
@@ -5202,11 +5377,6 @@ IsAddressRangeInArsList(
 )
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
-  INT32 Index = 0;
-  UINT64 BadBlockStart = 0;
-  UINT64 BadBlockEnd = 0;
-  UINT64 CheckBlockStart = Address;
-  UINT64 CheckBlockEnd = Address + Length - 1;
 
   if (gArsBadRecordsCount == 0) {
       return ReturnCode;
@@ -5234,24 +5404,11 @@ IsAddressRangeInArsList(
     goto Finish;
   }
 
-  if (NULL != gArsBadRecords && gArsBadRecordsCount > 0) {
-    //Check that address range does not contain one of the bad addresses identified by BIOS
-    for (Index = 0; Index < gArsBadRecordsCount; Index++) {
-      BadBlockStart = gArsBadRecords[Index].SpaOfErrLoc;
-      BadBlockEnd = gArsBadRecords[Index].SpaOfErrLoc + gArsBadRecords[Index].Length - 1;
-
-      NVDIMM_DBG("Checking address 0x%llx, len 0x%llx against bad ARS address 0x%llx, len 0x%llx", Address, Length, gArsBadRecords[Index].SpaOfErrLoc, gArsBadRecords[Index].Length);
-
-      if ((CheckBlockStart >= BadBlockStart   && CheckBlockStart <= BadBlockEnd)   || //the request starts at an address in the bad range
-          (CheckBlockStart >= BadBlockStart   && CheckBlockEnd   <= BadBlockEnd)   || //the request fits entirly in a bad range
-          (BadBlockStart   >= CheckBlockStart && BadBlockEnd     <= CheckBlockEnd) || //the bad range fits entirely in the check range
-          (CheckBlockEnd   >= BadBlockStart   && CheckBlockEnd   <= BadBlockEnd))     //the request ends at an address in the bad range
-      {
-        ReturnCode = EFI_DEVICE_ERROR;
-        NVDIMM_DBG("Collision detected with the ARS list");
-        goto Finish;
-      }
-    }
+  //Check that address range does not contain one of the bad addresses identified by BIOS
+  if (ArsBadRecordsOverlap(Address, Length)) {
+    ReturnCode = EFI_DEVICE_ERROR;
+    NVDIMM_DBG("Address 0x%llx, len 0x%llx collides with the ARS list", Address, Length);
+    goto Finish;
   }
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
@@ -70,6 +70,10 @@ typedef struct _NAMESPACE {
   PFN *pPfn;
   BOOLEAN IsRawNamespace;
   UINT64 UsableSize;
+#ifdef OS_BUILD
+  VOID *pImage;       //!< Mapped namespace image backing the I/O in tool mode
+  UINT64 ImageSize;   //!< Size of the mapped namespace image
+#endif
 } NAMESPACE;
 
 typedef struct _NVM_COOKIE_DATA {
@@ -497,6 +501,50 @@ WriteBlockDevice(
   IN     UINT64 Lba,
      OUT CHAR8 *pBuffer
   );
+
+/**
+  Read a number of consecutive blocks from the namespace
+  BTT namespaces serve the whole range through a single lane with coalesced
+  map reads, other namespace types are read block by block.
+
+  @param[in] pNamespace Namespace that data will be read from
+  @param[in] Lba First LBA to read
+  @param[in] NumBlocks Number of blocks to read
+  @param[out] pBuffer pointer to the memory where the result should be stored,
+    at least NumBlocks * Namespace block size bytes
+
+  @retval EFI_SUCCESS on a successful read
+  @retval Error return values from ReadBlockDevice or BttReadBlocks function
+**/
+EFI_STATUS
+ReadBlockDeviceRange(
+  IN     NAMESPACE *pNamespace,
+  IN     UINT64 Lba,
+  IN     UINT64 NumBlocks,
+     OUT CHAR8 *pBuffer
+  );
+
+/**
+  Write a number of consecutive blocks to the namespace
+  BTT namespaces serve the whole range through a single lane, other
+  namespace types are written block by block.
+
+  @param[in] pNamespace Namespace that data will be written to
+  @param[in] Lba First LBA to write
+  @param[in] NumBlocks Number of blocks to write
+  @param[in] pBuffer pointer to the memory where the source data resides,
+    at least NumBlocks * Namespace block size bytes
+
+  @retval EFI_SUCCESS on a successful write
+  @retval Error return values from WriteBlockDevice or BttWriteBlocks function
+**/
+EFI_STATUS
+WriteBlockDeviceRange(
+  IN     NAMESPACE *pNamespace,
+  IN     UINT64 Lba,
+  IN     UINT64 NumBlocks,
+  IN     CHAR8 *pBuffer
+  );
 /**
 Checks whether NamespaceType is AppDirect
 
@@ -596,6 +644,9 @@ InitializeLabelStorageArea(
 /**
   Initialize all label storage areas
 
+  The DIMMs are initialized in parallel where supported (see RunOnDimms).
+  Every manageable DIMM gets its own object status.
+
   @param[in] ppDimms Array of DIMMs
   @param[in] DimmsNum Number of DIMMs
   @param[in] LabelVersionMajor Major version of label to init
@@ -604,7 +655,8 @@ InitializeLabelStorageArea(
 
   @retval EFI_SUCCESS success
   @retval EFI_INVALID_PARAMETER pDimmList is NULL
-  @retval return codes from SendConfigInputToDimm
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval return codes from InitializeLabelStorageArea and ReadLabelStorageArea
 **/
 
 EFI_STATUS
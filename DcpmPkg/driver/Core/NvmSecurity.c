@@ -4,6 +4,7 @@
  */
 
 #include <Uefi.h>
+#include <Library/BaseLib.h>
 #include <Library/BaseMemoryLib.h>
 #include "NvmDimmDriverData.h"
 #include "NvmDimmPassThru.h"
@@ -44,7 +45,7 @@ GetDimmSecurityState(
     goto Finish;
   }
 
-  pPassThruCommand = AllocateZeroPool(sizeof(*pPassThruCommand));
+  pPassThruCommand = AllocateFwCmd();
   if (pPassThruCommand == NULL) {
     NVDIMM_ERR("Out of memory.");
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -71,7 +72,7 @@ GetDimmSecurityState(
   ReturnCode = EFI_SUCCESS;
 
 FinishFreeMem:
-  FREE_POOL_SAFE(pPassThruCommand);
+  FreeFwCmd(pPassThruCommand);
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -118,7 +119,7 @@ SetDimmSecurityState(
     goto Finish;
   }
 
-  pPassThruCommand = AllocateZeroPool(sizeof(*pPassThruCommand));
+  pPassThruCommand = AllocateFwCmd();
   if (pPassThruCommand == NULL) {
     NVDIMM_ERR("Out of memory.");
     ReturnCode = EFI_OUT_OF_RESOURCES;
@@ -146,7 +147,106 @@ SetDimmSecurityState(
   ReturnCode = EFI_SUCCESS;
 
 FinishFreeMem:
-  FREE_POOL_SAFE(pPassThruCommand);
+  FreeFwCmd(pPassThruCommand);
+Finish:
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Erase work of one DIMM dispatched by SecureEraseDimms
+**/
+typedef struct _SECURE_ERASE_CONTEXT {
+  UINT16 PayloadBufferSize;
+  PT_SET_SECURITY_PAYLOAD *pSecurityPayload;  //!< Shared by all DIMMs, only read
+  SECURE_ERASE_RESULT *pResult;
+} SECURE_ERASE_CONTEXT;
+
+/**
+  RunOnDimms worker erasing one DIMM and reading its security state back
+
+  @param[in] pDimm the DIMM to erase
+  @param[in] pArg the SECURE_ERASE_CONTEXT of the DIMM
+
+  @retval EFI_SUCCESS the DIMM was erased and its state read back
+  @retval Other the erase or the state read failed
+**/
+STATIC
+EFI_STATUS
+SecureEraseDimmWorker(
+  IN     DIMM *pDimm,
+  IN     VOID *pArg
+  )
+{
+  SECURE_ERASE_CONTEXT *pContext = (SECURE_ERASE_CONTEXT *)pArg;
+  SECURE_ERASE_RESULT *pResult = pContext->pResult;
+
+  pResult->StateReturnCode = EFI_NOT_STARTED;
+#ifndef OS_BUILD
+  /** Need to call WBINVD before secure erase **/
+  AsmWbinvd();
+#endif
+  pResult->EraseReturnCode = SetDimmSecurityState(pDimm, PtSetSecInfo, SubopSecEraseUnit,
+      pContext->PayloadBufferSize, pContext->pSecurityPayload, PT_TIMEOUT_INTERVAL);
+  if (EFI_ERROR(pResult->EraseReturnCode)) {
+    return pResult->EraseReturnCode;
+  }
+#ifndef OS_BUILD
+  /** Need to call WBINVD after secure erase **/
+  AsmWbinvd();
+#endif
+  pResult->StateReturnCode = GetDimmSecurityState(pDimm, PT_TIMEOUT_INTERVAL, &pResult->SecurityState);
+  return pResult->StateReturnCode;
+}
+
+/**
+  Secure erase several DIMMs in parallel (see RunOnDimms)
+
+  Every DIMM gets the erase command with the same payload, then its security
+  state is read back. The DIMMs are expected to be checked by the caller.
+
+  @param [in]  ppDimms DIMMs to erase
+  @param [in]  DimmsNum Number of DIMMs in ppDimms
+  @param [in]  PayloadBufferSize Size of the erase payload
+  @param [in]  pSecurityPayload Erase payload with the passphrase and its type
+  @param [out] pResults Per DIMM outcome, DimmsNum entries
+
+  @retval EFI_INVALID_PARAMETER Input parameters are not correct
+  @retval EFI_SUCCESS All DIMMs were erased and their state read back
+  @retval Other the first error of a DIMM, see pResults
+**/
+EFI_STATUS
+SecureEraseDimms(
+  IN     DIMM **ppDimms,
+  IN     UINT32 DimmsNum,
+  IN     UINT16 PayloadBufferSize,
+  IN     PT_SET_SECURITY_PAYLOAD *pSecurityPayload,
+     OUT SECURE_ERASE_RESULT *pResults
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  SECURE_ERASE_CONTEXT Contexts[MAX_DIMMS];
+  VOID *pArgs[MAX_DIMMS];
+  EFI_STATUS ReturnCodes[MAX_DIMMS];
+  UINT32 Index = 0;
+
+  NVDIMM_ENTRY();
+
+  if (ppDimms == NULL || pSecurityPayload == NULL || pResults == NULL || DimmsNum > MAX_DIMMS) {
+    goto Finish;
+  }
+
+  for (Index = 0; Index < DimmsNum; Index++) {
+    Contexts[Index].PayloadBufferSize = PayloadBufferSize;
+    Contexts[Index].pSecurityPayload = pSecurityPayload;
+    Contexts[Index].pResult = &pResults[Index];
+    pArgs[Index] = &Contexts[Index];
+    pResults[Index].EraseReturnCode = EFI_NOT_STARTED;
+    pResults[Index].StateReturnCode = EFI_NOT_STARTED;
+  }
+
+  ReturnCode = RunOnDimms(ppDimms, DimmsNum, SecureEraseDimmWorker, pArgs, ReturnCodes);
+
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -55,6 +55,40 @@ SetDimmSecurityState(
   IN     UINT64 Timeout
   );
 
+/**
+  Outcome of the secure erase of one DIMM
+**/
+typedef struct _SECURE_ERASE_RESULT {
+  EFI_STATUS EraseReturnCode;     //!< Result of the erase command, EFI_NOT_STARTED if not sent
+  EFI_STATUS StateReturnCode;     //!< Result of reading the security state back, EFI_NOT_STARTED if not read
+  UINT32 SecurityState;           //!< Security state after the erase
+} SECURE_ERASE_RESULT;
+
+/**
+  Secure erase several DIMMs in parallel (see RunOnDimms)
+
+  Every DIMM gets the erase command with the same payload, then its security
+  state is read back. The DIMMs are expected to be checked by the caller.
+
+  @param [in]  ppDimms DIMMs to erase
+  @param [in]  DimmsNum Number of DIMMs in ppDimms
+  @param [in]  PayloadBufferSize Size of the erase payload
+  @param [in]  pSecurityPayload Erase payload with the passphrase and its type
+  @param [out] pResults Per DIMM outcome, DimmsNum entries
+
+  @retval EFI_INVALID_PARAMETER Input parameters are not correct
+  @retval EFI_SUCCESS All DIMMs were erased and their state read back
+  @retval Other the first error of a DIMM, see pResults
+**/
+EFI_STATUS
+SecureEraseDimms(
+  IN     DIMM **ppDimms,
+  IN     UINT32 DimmsNum,
+  IN     UINT16 PayloadBufferSize,
+  IN     PT_SET_SECURITY_PAYLOAD *pSecurityPayload,
+     OUT SECURE_ERASE_RESULT *pResults
+  );
+
 /**
   Convert security bitmask to a defined state
 
@@ -814,7 +814,7 @@ RetrieveISsFromNfit(
       }
     }
 
-    ReturnCode = BubbleSortLinkedList(&pIS->DimmRegionList, CompareRegionOffsetInDimmRegion);
+    ReturnCode = MergeSortLinkedList(&pIS->DimmRegionList, CompareRegionOffsetInDimmRegion);
     if (EFI_ERROR(ReturnCode)) {
       NVDIMM_DBG("Failed to sort DIMM regions in interleave set: 0x%x", pIS->InterleaveSetIndex);
     }
@@ -1105,7 +1105,7 @@ RetrieveISFromInterleaveInformationTable(
         }
       }
 
-      Rc = BubbleSortLinkedList(&pIS->DimmRegionList, CompareRegionOffsetInDimmRegion);
+      Rc = MergeSortLinkedList(&pIS->DimmRegionList, CompareRegionOffsetInDimmRegion);
 
       if (EFI_ERROR(Rc)) {
         goto Finish;
@@ -3786,18 +3786,61 @@ Finish:
   return ReturnCode;
 }
 
+/**
+  DIMM_WORKER removing the Configuration Input of one DIMM
+
+  @param[in] pDimm dimm that we replace Platform Config Data for
+  @param[in] pArg not used
+
+  @retval return codes from SendConfigInputToDimm
+**/
+STATIC
+EFI_STATUS
+ClearConfigInputWorker(
+  IN     DIMM *pDimm,
+  IN     VOID *pArg
+  )
+{
+  return SendConfigInputToDimm(pDimm, NULL);
+}
+
+/**
+  DIMM_WORKER sending a new Configuration Input to one DIMM
+
+  @param[in] pDimm dimm that we replace Platform Config Data for
+  @param[in] pArg new NVDIMM_PLATFORM_CONFIG_INPUT for dimm, NULL to leave the dimm untouched
+
+  @retval EFI_SUCCESS pArg is NULL
+  @retval return codes from SendConfigInputToDimm
+**/
+STATIC
+EFI_STATUS
+SendConfigInputWorker(
+  IN     DIMM *pDimm,
+  IN     VOID *pArg
+  )
+{
+  if (pArg == NULL) {
+    return EFI_SUCCESS;
+  }
+  return SendConfigInputToDimm(pDimm, (NVDIMM_PLATFORM_CONFIG_INPUT *)pArg);
+}
+
 /**
   Clear previous regions goal configs and - if regions goal configs is specified - replace them with new one.
 
   1. Clear previous regions goal configs on all affected dimms
-  2. [OPTIONAL] Send new regions goal configs to dimms
+  2. [OPTIONAL] Generate new regions goal configs, one dimm after another, and send them to dimms
   3. Set information about synchronization with dimms
 
+  Platform Config Data of different dimms is written in parallel where supported (see RunOnDimms).
+
   @param[in] pDimmList Head of the list of all NVM DIMMs in the system
   @param[out] pCommandStatus Pointer to command status structure
 
   @retval EFI_SUCCESS success
   @retval EFI_INVALID_PARAMETER pDimmList is NULL
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
   @retval return codes from SendConfigInputToDimm
 **/
 EFI_STATUS
@@ -3809,7 +3852,11 @@ ApplyGoalConfigsToDimms(
   EFI_STATUS ReturnCode = EFI_SUCCESS;
   DIMM *pDimm = NULL;
   LIST_ENTRY *pDimmNode = NULL;
-  NVDIMM_PLATFORM_CONFIG_INPUT *pNewConfigInput = NULL;
+  DIMM **ppDimms = NULL;
+  NVDIMM_PLATFORM_CONFIG_INPUT **ppNewConfigInputs = NULL;
+  EFI_STATUS *pReturnCodes = NULL;
+  UINT32 DimmsNum = 0;
+  UINT32 Index = 0;
 
   NVDIMM_ENTRY();
 
@@ -3818,83 +3865,96 @@ ApplyGoalConfigsToDimms(
     goto Finish;
   }
 
-  /**
-    Clear previous regions goal configs
-  **/
   LIST_FOR_EACH(pDimmNode, pDimmList) {
     pDimm = DIMM_FROM_NODE(pDimmNode);
-    if (!IsDimmManageable(pDimm)) {
-      continue;
-    }
-    if (pDimm->PcdSynced) {
-      continue;
+    if (IsDimmManageable(pDimm) && !pDimm->PcdSynced) {
+      DimmsNum++;
     }
+  }
 
-    /** Remove Configuration Input table from Platform Config Data **/
-    ReturnCode = SendConfigInputToDimm(pDimm, NULL);
-    if (EFI_ERROR(ReturnCode)) {
-      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_REGION_CONF_APPLYING_FAILED);
-      goto Finish;
-    }
+  if (DimmsNum == 0) {
+    SetCmdStatus(pCommandStatus, NVM_SUCCESS);
+    goto Finish;
   }
 
-  /**
-    Send new regions goal configs to dimms
-  **/
+  ppDimms = AllocateZeroPool(DimmsNum * sizeof(*ppDimms));
+  ppNewConfigInputs = AllocateZeroPool(DimmsNum * sizeof(*ppNewConfigInputs));
+  pReturnCodes = AllocateZeroPool(DimmsNum * sizeof(*pReturnCodes));
+  if (ppDimms == NULL || ppNewConfigInputs == NULL || pReturnCodes == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+
+  Index = 0;
   LIST_FOR_EACH(pDimmNode, pDimmList) {
     pDimm = DIMM_FROM_NODE(pDimmNode);
-    if (!IsDimmManageable(pDimm) || !pDimm->RegionsGoalConfig) {
-      continue;
+    if (IsDimmManageable(pDimm) && !pDimm->PcdSynced) {
+      ppDimms[Index++] = pDimm;
     }
-    if (pDimm->PcdSynced) {
+  }
+
+  /**
+    Clear previous regions goal configs
+  **/
+  ReturnCode = RunOnDimms(ppDimms, DimmsNum, ClearConfigInputWorker, NULL, pReturnCodes);
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
+  }
+
+  /**
+    Generate new regions goal configs. Sequence numbers are read back from each dimm,
+    so the generation stays sequential and does not depend on thread timing.
+  **/
+  for (Index = 0; Index < DimmsNum; Index++) {
+    if (!ppDimms[Index]->RegionsGoalConfig) {
       continue;
     }
 
-    ReturnCode = GeneratePcdConfInput(pDimm, &pNewConfigInput);
+    ReturnCode = GeneratePcdConfInput(ppDimms[Index], &ppNewConfigInputs[Index]);
     if (EFI_ERROR(ReturnCode)) {
       NVDIMM_DBG("Generating Platform Config Data Configuration Input failed.");
-      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_REGION_CONF_APPLYING_FAILED);
+      SetObjStatusForDimm(pCommandStatus, ppDimms[Index], NVM_ERR_REGION_CONF_APPLYING_FAILED);
       goto Finish;
     }
+  }
 
-    ReturnCode = SendConfigInputToDimm(pDimm, pNewConfigInput);
-    if (EFI_ERROR(ReturnCode)) {
-      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_REGION_CONF_APPLYING_FAILED);
-      goto Finish;
-    }
+  /**
+    Send new regions goal configs to dimms
+  **/
+  ReturnCode = RunOnDimms(ppDimms, DimmsNum, SendConfigInputWorker, (VOID **)ppNewConfigInputs, pReturnCodes);
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
   }
 
   /**
     If all data has been sent to dimms successfully, then we are synchronized
   **/
-  LIST_FOR_EACH(pDimmNode, pDimmList) {
-    pDimm = DIMM_FROM_NODE(pDimmNode);
-    if (!IsDimmManageable(pDimm)) {
-      continue;
-    }
-    if (pDimm->PcdSynced) {
-      continue;
-    }
-    SetObjStatusForDimm(pCommandStatus, pDimm, NVM_SUCCESS);
-    pDimm->PcdSynced = TRUE;
+  for (Index = 0; Index < DimmsNum; Index++) {
+    SetObjStatusForDimm(pCommandStatus, ppDimms[Index], NVM_SUCCESS);
+    ppDimms[Index]->PcdSynced = TRUE;
   }
   SetCmdStatus(pCommandStatus, NVM_SUCCESS);
 
 Finish:
-  if (EFI_ERROR(ReturnCode) && (EFI_INVALID_PARAMETER != ReturnCode)) {
-    // Create Goal ERROR! Try to remove Configuration Input table from Platform Config Data
-    LIST_FOR_EACH(pDimmNode, pDimmList) {
-      pDimm = DIMM_FROM_NODE(pDimmNode);
-      if (!IsDimmManageable(pDimm)) {
-        continue;
-      }
-      if (pDimm->PcdSynced) {
-        continue;
+  if (EFI_ERROR(ReturnCode) && (EFI_INVALID_PARAMETER != ReturnCode) &&
+      ppDimms != NULL && pReturnCodes != NULL) {
+    // Status of each dimm a worker failed on
+    for (Index = 0; Index < DimmsNum; Index++) {
+      if (EFI_ERROR(pReturnCodes[Index])) {
+        SetObjStatusForDimm(pCommandStatus, ppDimms[Index], NVM_ERR_REGION_CONF_APPLYING_FAILED);
       }
-      SendConfigInputToDimm(pDimm, NULL);
     }
+    // Create Goal ERROR! Try to remove Configuration Input table from Platform Config Data
+    RunOnDimms(ppDimms, DimmsNum, ClearConfigInputWorker, NULL, pReturnCodes);
   }
-  FREE_POOL_SAFE(pNewConfigInput);
+  if (ppNewConfigInputs != NULL) {
+    for (Index = 0; Index < DimmsNum; Index++) {
+      FREE_POOL_SAFE(ppNewConfigInputs[Index]);
+    }
+  }
+  FREE_POOL_SAFE(ppNewConfigInputs);
+  FREE_POOL_SAFE(ppDimms);
+  FREE_POOL_SAFE(pReturnCodes);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
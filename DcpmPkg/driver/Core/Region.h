@@ -374,11 +374,14 @@ RetrieveISFromInterleaveInformationTable(
   2. [OPTIONAL] Send new pools goal configs to dimms
   3. Set information about synchronization with dimms
 
+  Platform Config Data of different dimms is written in parallel where supported (see RunOnDimms).
+
   @param[in] pDimmList Head of the list of all NVM DIMMs in the system
   @param[out] pCommandStatus Pointer to command status structure
 
   @retval EFI_SUCCESS success
   @retval EFI_INVALID_PARAMETER pDimmList is NULL
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
   @retval return codes from SendConfigInputToDimm
 **/
 EFI_STATUS
@@ -217,6 +217,7 @@ CleanNamespacesAndISs(
   }
 
   CleanNamespacesList(&gNvmDimmData->PMEMDev.Namespaces);
+#endif
 
   /**
     Remove Interleave Sets
@@ -227,6 +228,7 @@ CleanNamespacesAndISs(
   CleanISLists(&gNvmDimmData->PMEMDev.Dimms, &gNvmDimmData->PMEMDev.ISsNfit);
   gNvmDimmData->PMEMDev.RegionsNfitInitialized = FALSE;
 
+#ifndef OS_BUILD
 Finish:
 #endif
   return ReturnCode;
@@ -294,6 +296,15 @@ ReenumerateNamespacesAndISs(
   gNvmDimmData->PMEMDev.RegionsAndNsInitialized = TRUE;
   NVDIMM_EXIT_I64(ReturnCode);
 Finish:
+#else
+  /**
+    The OS driver does not enumerate namespaces and builds the regions on
+    first use, so a cleanup only has to drop the cached regions. This keeps
+    a driver binding that persists across commands in sync with the PCD.
+  **/
+  if (DoDriverCleanup == TRUE) {
+    ReturnCode = CleanNamespacesAndISs();
+  }
 #endif
   return ReturnCode;
 }
@@ -312,6 +323,9 @@ NvmDimmDriverUnload(
   /** Uninitialize data associated with Playback and Record**/
   PbrUninit();
 
+  /** Release the SMBIOS memory device index **/
+  FreeSmbiosIndex();
+
 #ifndef OS_BUILD
   EFI_STATUS TempReturnCode = EFI_SUCCESS;
   EFI_HANDLE *pHandleBuffer = NULL;
@@ -1860,6 +1874,10 @@ NvmDimmDriverDriverBindingStop(
 Finish:
 #else //not OS_BUILD
 
+  /**
+   Remove the regions first, they reference the DIMMs
+  **/
+  CleanNamespacesAndISs();
 
   /**
    Remove the DIMM from memory
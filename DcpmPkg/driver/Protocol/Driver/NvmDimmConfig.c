@@ -32,6 +32,7 @@
 #include <CoreDiagnostics.h>
 #include <NvmHealth.h>
 #include <Utility.h>
+#include <RangeIndex.h>
 #include <PbrDcpmm.h>
 #ifndef OS_BUILD
 #include <SpiRecovery.h>
@@ -42,6 +43,7 @@
 
 #ifdef OS_BUILD
 #include <os_efi_api.h>
+#include <os.h>
 #endif // OS_BUILD
 
 #define INVALID_SOCKET_ID 0xFFFF
@@ -75,11 +77,6 @@ typedef struct _REGION_GOAL_APPDIRECT_INDEX_TABLE {
   UINT32 AppDirectIndex;
 } REGION_GOAL_APPDIRECT_INDEX_TABLE;
 
-/** Memory Device SMBIOS Table **/
-#define SMBIOS_TYPE_MEM_DEV             17
-/** Memory Device Mapped Address SMBIOS Table **/
-#define SMBIOS_TYPE_MEM_DEV_MAPPED_ADDR 20
-
 #define TEST_NAMESPACE_NAME_LEN         14
 
 EFI_GUID gNvmDimmConfigProtocolGuid = EFI_DCPMM_CONFIG2_PROTOCOL_GUID;
@@ -92,8 +89,11 @@ EFI_DCPMM_CONFIG_TRANSPORT_ATTRIBS gTransportAttribs = { FisTransportAuto, FisTr
 
 #ifndef OS_BUILD
 
-DCPMM_ARS_ERROR_RECORD * gArsBadRecords = NULL;
 INT32 gArsBadRecordsCount = ARS_LIST_NOT_INITIALIZED;
+/** Interval index over the bad address ranges reported by BIOS **/
+STATIC RANGE_INDEX gArsBadRangeIndex = { NULL, 0, 0, FALSE };
+/** Set when the BIOS returned the list while ARS was still running **/
+STATIC BOOLEAN gArsBadRecordsPartial = FALSE;
 #endif
 
 /**
@@ -158,7 +158,8 @@ EFI_DCPMM_CONFIG2_PROTOCOL gNvmDimmDriverNvmDimmConfig =
   GetFisTransportAttributes,
   SetFisTransportAttributes,
   GetCommandAccessPolicy,
-  GetCommandEffectLog
+  GetCommandEffectLog,
+  GetFwDebugLogStream
 };
 
 
@@ -1730,8 +1731,10 @@ GetDimms(
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
   UINT32 Index = 0;
+  UINT32 ListedDimmsNum = 0;
   LIST_ENTRY *pNode = NULL;
   DIMM *pCurDimm = NULL;
+  DIMM *pListedDimms[MAX_DIMMS];
 
   NVDIMM_ENTRY();
 
@@ -1742,6 +1745,11 @@ GetDimms(
     goto Finish;
   }
 
+#ifndef OS_BUILD
+  // Every CLI command starts by listing the DIMMs, the driver outlives the command
+  StartSmartSnapshotEpoch();
+#endif // !OS_BUILD
+
   LIST_COUNT(pNode, &gNvmDimmData->PMEMDev.Dimms, Index);
 
   if (DimmCount > Index)
@@ -1760,16 +1768,25 @@ GetDimms(
       continue;
     }
 
-    if (DimmCount <= Index) {
+    if (DimmCount <= Index || MAX_DIMMS <= Index) {
       NVDIMM_DBG("Array is too small to hold entire DIMM list");
       ReturnCode = EFI_INVALID_PARAMETER;
       goto Finish;
     }
 
-    GetDimmInfo(pCurDimm, dimmInfoCategories, &pDimms[Index]);
+    pListedDimms[Index] = pCurDimm;
     Index++;
   }
 
+  if (dimmInfoCategories & DIMM_INFO_CATEGORY_SMART_AND_HEALTH) {
+    // Read the SMART data of the listed DIMMs together instead of one after another
+    RefreshSmartSnapshots(pListedDimms, Index);
+  }
+
+  for (ListedDimmsNum = Index, Index = 0; Index < ListedDimmsNum; Index++) {
+    GetDimmInfo(pListedDimms[Index], dimmInfoCategories, &pDimms[Index]);
+  }
+
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -2678,59 +2695,28 @@ Finish:
 }
 
 /**
-  Get NVM DIMM Health Info
-
-  This FW command is used to retrieve current health of system, including SMART information:
-  * Overall health status
-  * Temperature
-  * Spare blocks
-  * Alarm Trips set (Temperature/Spare Blocks)
-  * Device life span as a percentage
-  * Latched Last shutdown status
-  * Dirty shutdowns
-  * Last shutdown time.
-  * AIT DRAM status
-  * Power Cycles (does not include warm resets or S3 resumes)
-  * Power on time (life of DIMM has been powered on)
-  * Uptime for current power cycle in seconds
+  Read the SMART and health info of a DIMM from its FW
 
-  @param[in]  pThis is a pointer to the EFI_DCPMM_CONFIG2_PROTOCOL instance.
-  @param[in]  DimmPid The ID of the DIMM
+  @param[in]  pDimm The DIMM
   @param[out] pHealthInfo - pointer to structure containing all Health and Smarth variables
 
-  @retval EFI_INVALID_PARAMETER if no DIMM found for DimmPid.
   @retval EFI_OUT_OF_RESOURCES memory allocation failure
   @retval EFI_DEVICE_ERROR device error detected
-  @retval EFI_NOT_READY the specified DIMM is unmanageable
   @retval EFI_SUCCESS Success
 **/
+STATIC
 EFI_STATUS
-EFIAPI
-GetSmartAndHealth (
-  IN     EFI_DCPMM_CONFIG2_PROTOCOL *pThis,
-  IN     UINT16 DimmPid,
+ReadSmartAndHealth (
+  IN     DIMM *pDimm,
      OUT SMART_AND_HEALTH_INFO *pHealthInfo
   )
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
-
-  DIMM *pDimm = NULL;
   PT_PAYLOAD_SMART_AND_HEALTH *pPayloadSmartAndHealth = NULL;
   PT_DEVICE_CHARACTERISTICS_OUT *pDevCharacteristics = NULL;
 
   NVDIMM_ENTRY();
 
-  pDimm = GetDimmByPid(DimmPid, &gNvmDimmData->PMEMDev.Dimms);
-  if (pDimm == NULL || pHealthInfo == NULL) {
-    ReturnCode = EFI_INVALID_PARAMETER;
-    goto Finish;
-  }
-
-  if (!IsDimmManageable(pDimm)) {
-    ReturnCode = EFI_NOT_READY;
-    goto Finish;
-  }
-
   ReturnCode = FwCmdGetSmartAndHealth(pDimm, &pPayloadSmartAndHealth);
   if (EFI_ERROR(ReturnCode)) {
     goto Finish;
@@ -2816,11 +2802,227 @@ Finish:
   return ReturnCode;
 }
 
+/**
+  Read the SMART and health info of a DIMM into its snapshot
+
+  @param[in, out] pDimm The DIMM
+**/
+STATIC
+VOID
+TakeSmartSnapshot(
+  IN OUT DIMM *pDimm
+  )
+{
+  ZeroMem(&pDimm->SmartSnapshot, sizeof(pDimm->SmartSnapshot));
+  pDimm->SmartSnapshotReturnCode = ReadSmartAndHealth(pDimm, &pDimm->SmartSnapshot);
+  StampSmartSnapshot(pDimm);
+}
+
+/**
+  RunOnDimms worker taking the SMART snapshot of one DIMM
+
+  @param[in, out] pDimm The DIMM
+  @param[in] pArg Unused
+
+  @retval Result of reading the SMART and health info
+**/
+STATIC
+EFI_STATUS
+TakeSmartSnapshotWorker(
+  IN OUT DIMM *pDimm,
+  IN     VOID *pArg
+  )
+{
+  TakeSmartSnapshot(pDimm);
+  return pDimm->SmartSnapshotReturnCode;
+}
+
+/**
+  Take the SMART snapshots of the requested DIMMs without a valid one
+
+  The stale DIMMs are read in parallel where supported (see RunOnDimms), so a
+  consumer of several DIMMs only waits for the slowest one. A read error is
+  kept in the snapshot of its DIMM.
+
+  @param[in] ppDimms The DIMMs a consumer asked for
+  @param[in] DimmsNum Number of DIMMs in ppDimms
+
+  @retval EFI_SUCCESS The stale snapshots were taken
+  @retval EFI_INVALID_PARAMETER ppDimms is NULL or DimmsNum is above MAX_DIMMS
+**/
+EFI_STATUS
+RefreshSmartSnapshots(
+  IN     DIMM **ppDimms,
+  IN     UINT32 DimmsNum
+  )
+{
+  DIMM *pStaleDimms[MAX_DIMMS];
+  EFI_STATUS ReturnCodes[MAX_DIMMS];
+  UINT32 StaleDimmsNum = 0;
+  UINT32 Index = 0;
+
+  if (ppDimms == NULL || DimmsNum > MAX_DIMMS) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < DimmsNum; Index++) {
+    if (IsDimmManageable(ppDimms[Index]) && !IsSmartSnapshotValid(ppDimms[Index])) {
+      pStaleDimms[StaleDimmsNum++] = ppDimms[Index];
+    }
+  }
+
+  RunOnDimms(pStaleDimms, StaleDimmsNum, TakeSmartSnapshotWorker, NULL, ReturnCodes);
+  return EFI_SUCCESS;
+}
+
+/**
+  Get NVM DIMM Health Info
+
+  This FW command is used to retrieve current health of system, including SMART information:
+  * Overall health status
+  * Temperature
+  * Spare blocks
+  * Alarm Trips set (Temperature/Spare Blocks)
+  * Device life span as a percentage
+  * Latched Last shutdown status
+  * Dirty shutdowns
+  * Last shutdown time.
+  * AIT DRAM status
+  * Power Cycles (does not include warm resets or S3 resumes)
+  * Power on time (life of DIMM has been powered on)
+  * Uptime for current power cycle in seconds
+
+  The data is served from the snapshot of the DIMM, which is read once per
+  invocation, or once per configured TTL, and dropped by any FW command that
+  may change it.
+
+  @param[in]  pThis is a pointer to the EFI_DCPMM_CONFIG2_PROTOCOL instance.
+  @param[in]  DimmPid The ID of the DIMM
+  @param[out] pHealthInfo - pointer to structure containing all Health and Smarth variables
+
+  @retval EFI_INVALID_PARAMETER if no DIMM found for DimmPid.
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval EFI_DEVICE_ERROR device error detected
+  @retval EFI_NOT_READY the specified DIMM is unmanageable
+  @retval EFI_SUCCESS Success
+**/
+EFI_STATUS
+EFIAPI
+GetSmartAndHealth (
+  IN     EFI_DCPMM_CONFIG2_PROTOCOL *pThis,
+  IN     UINT16 DimmPid,
+     OUT SMART_AND_HEALTH_INFO *pHealthInfo
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  DIMM *pDimm = NULL;
+
+  NVDIMM_ENTRY();
+
+  pDimm = GetDimmByPid(DimmPid, &gNvmDimmData->PMEMDev.Dimms);
+  if (pDimm == NULL || pHealthInfo == NULL) {
+    ReturnCode = EFI_INVALID_PARAMETER;
+    goto Finish;
+  }
+
+  if (!IsDimmManageable(pDimm)) {
+    ReturnCode = EFI_NOT_READY;
+    goto Finish;
+  }
+
+  if (IsSmartSnapshotValid(pDimm)) {
+    pDimm->SmartSnapshotHits++;
+  } else {
+    RefreshSmartSnapshots(&pDimm, 1);
+  }
+  NVDIMM_DBG("SMART snapshot of DIMM 0x%x: %d reads, %d served from the snapshot",
+      pDimm->DeviceHandle.AsUint32, pDimm->SmartSnapshotFetches, pDimm->SmartSnapshotHits);
+
+  CopyMem_S(pHealthInfo, sizeof(*pHealthInfo), &pDimm->SmartSnapshot, sizeof(pDimm->SmartSnapshot));
+  ReturnCode = pDimm->SmartSnapshotReturnCode;
+
+Finish:
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Report the outcome of a security operation on one PMem module
+
+  @param[in,out] pCommandStatus Structure containing detailed NVM error codes
+  @param[in,out] pDimm the PMem module, its encryption state is updated on success
+  @param[in] SecurityOperation Security Operation code
+  @param[in] SetReturnCode result of the set security command
+  @param[in] StateReturnCode result of reading the security state back, EFI_NOT_STARTED if not read
+  @param[in] SecurityState security state read back
+
+  @retval EFI_SUCCESS the operation succeeded
+  @retval EFI_ACCESS_DENIED invalid passphrase
+  @retval EFI_DEVICE_ERROR the set security command failed
+  @retval EFI_ABORTED the state could not be read back or a passphrase count expired
+**/
+STATIC
+EFI_STATUS
+ReportSecurityOperationResult(
+  IN OUT COMMAND_STATUS *pCommandStatus,
+  IN OUT DIMM *pDimm,
+  IN     UINT16 SecurityOperation,
+  IN     EFI_STATUS SetReturnCode,
+  IN     EFI_STATUS StateReturnCode,
+  IN     UINT32 SecurityState
+  )
+{
+  if (EFI_ERROR(SetReturnCode)) {
+    NVDIMM_DBG("Failed on SetDimmSecurityState, ReturnCode=" FORMAT_EFI_STATUS "", SetReturnCode);
+    if (SetReturnCode == EFI_ACCESS_DENIED) {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_INVALID_PASSPHRASE);
+      return EFI_ACCESS_DENIED;
+    } else if (EFI_NO_RESPONSE == SetReturnCode) {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_BUSY_DEVICE);
+    } else if (SetReturnCode == EFI_UNSUPPORTED) {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_OPERATION_NOT_SUPPORTED);
+    } else {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_OPERATION_FAILED);
+    }
+    return EFI_DEVICE_ERROR;
+  }
+
+  /** @todo(check on real HW)
+    WARNING: SetDimmSecurityState will not return EFI_ERROR on SECURITY_MASK_COUNTEXPIRED
+    so we have to check it additionally with GetDimmSecurityState.
+    It could be Simics/FW bug. Check how it is done on real HW.
+  **/
+  if (EFI_ERROR(StateReturnCode)) {
+    NVDIMM_DBG("Failed on GetDimmSecurityState, ReturnCode=" FORMAT_EFI_STATUS "", StateReturnCode);
+    SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_OPERATION_FAILED);
+    return EFI_ABORTED;
+  }
+  else if ((SecurityOperation == SECURITY_OPERATION_CHANGE_MASTER_PASSPHRASE) || (SecurityOperation == SECURITY_OPERATION_MASTER_ERASE_DEVICE)) {
+    if (SecurityState & SECURITY_MASK_MASTER_COUNTEXPIRED) {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_SECURITY_MASTER_PP_COUNT_EXPIRED);
+      return EFI_ABORTED;
+    }
+  }
+  else {
+    if (SecurityState & SECURITY_MASK_COUNTEXPIRED) {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_SECURITY_USER_PP_COUNT_EXPIRED);
+      return EFI_ABORTED;
+    }
+  }
+
+  SetObjStatusForDimm(pCommandStatus, pDimm, NVM_SUCCESS);
+
+  pDimm->EncryptionEnabled = ((SecurityState & SECURITY_MASK_ENABLED) != 0);
+  return EFI_SUCCESS;
+}
+
 /**
   Set security state on multiple PMem modules.
 
-  If there is a failure on one of the PMem modules, the function does not
-  continue onto the remaining modules but exits with an error.
+  All PMem modules are checked before a secure erase, which then runs on all
+  of them at once; a failed erase of one module does not stop the others.
+  For the other operations, if there is a failure on one of the PMem modules,
+  the function does not continue onto the remaining modules but exits with an error.
 
   @param[in] pThis a pointer to EFI_DCPMM_CONFIG2_PROTOCOL instance
   @param[in] pDimmIds Pointer to an array of DIMM IDs - if NULL, execute operation on all dimms
@@ -2863,6 +3065,12 @@ SetSecurityState(
   BOOLEAN NamespaceFound = FALSE;
   BOOLEAN AreNotPartOfPendingGoal = TRUE;
   BOOLEAN IsSupported = FALSE;
+  BOOLEAN SecurityStateUnknown = FALSE;
+  BOOLEAN IsEraseOperation = (SecurityOperation == SECURITY_OPERATION_ERASE_DEVICE ||
+      SecurityOperation == SECURITY_OPERATION_MASTER_ERASE_DEVICE);
+  EFI_STATUS SetReturnCode = EFI_NOT_STARTED;
+  EFI_STATUS StateReturnCode = EFI_NOT_STARTED;
+  SECURE_ERASE_RESULT EraseResults[MAX_DIMMS];
   REQUIRE_DCPMMS RequireDcpmmsBitfield = REQUIRE_DCPMMS_MANAGEABLE | REQUIRE_DCPMMS_FUNCTIONAL;
   DIMM *pCurrentDimm = NULL;
   LIST_ENTRY *pCurrentDimmNode = NULL;
@@ -3132,10 +3340,6 @@ SetSecurityState(
       if (!(DimmSecurityState & SECURITY_MASK_FROZEN)) {
         SubOpcode = SubopSecEraseUnit;
         pSecurityPayload->PassphraseType = SECURITY_USER_PASSPHRASE;
-#ifndef OS_BUILD
-        /** Need to call WBINVD before secure erase **/
-        AsmWbinvd();
-#endif
       } else {
         SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_INVALID_SECURITY_STATE);
         ReturnCode = EFI_DEVICE_ERROR;
@@ -3218,10 +3422,6 @@ SetSecurityState(
 
         SubOpcode = SubopSecEraseUnit;
         pSecurityPayload->PassphraseType = SECURITY_MASTER_PASSPHRASE;
-#ifndef OS_BUILD
-        /** Need to call WBINVD before secure erase **/
-        AsmWbinvd();
-#endif
       } else {
         SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_INVALID_SECURITY_STATE);
         ReturnCode = EFI_DEVICE_ERROR;
@@ -3234,60 +3434,50 @@ SetSecurityState(
       goto Finish;
     }
 
-    ReturnCode = SetDimmSecurityState(pDimms[Index], PtSetSecInfo, SubOpcode, PayloadBufferSize,
-        pSecurityPayload, PT_TIMEOUT_INTERVAL);
-    if (EFI_ERROR(ReturnCode)) {
-      NVDIMM_DBG("Failed on SetDimmSecurityState, ReturnCode=" FORMAT_EFI_STATUS "", ReturnCode);
-      if (ReturnCode == EFI_ACCESS_DENIED) {
-        SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_INVALID_PASSPHRASE);
-        goto Finish;
-      } else if (EFI_NO_RESPONSE == ReturnCode) {
-        SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_BUSY_DEVICE);
-      } else if (ReturnCode == EFI_UNSUPPORTED) {
-        SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_OPERATION_NOT_SUPPORTED);
-      } else {
-        SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_OPERATION_FAILED);
-      }
-      ReturnCode = EFI_DEVICE_ERROR;
-      goto Finish;
+    if (IsEraseOperation) {
+      // Erased together once every DIMM passed the checks
+      continue;
     }
+
+    // Until the state is read back the inventory entry of this DIMM may be stale
+    SecurityStateUnknown = TRUE;
+    SetReturnCode = SetDimmSecurityState(pDimms[Index], PtSetSecInfo, SubOpcode, PayloadBufferSize,
+        pSecurityPayload, PT_TIMEOUT_INTERVAL);
+    StateReturnCode = EFI_NOT_STARTED;
+    if (!EFI_ERROR(SetReturnCode)) {
 #ifndef OS_BUILD
-    /** Need to call WBINVD after unlock or secure erase **/
-    if (SecurityOperation == SECURITY_OPERATION_ERASE_DEVICE ||
-        SecurityOperation == SECURITY_OPERATION_UNLOCK_DEVICE) {
-      AsmWbinvd();
-    }
+      /** Need to call WBINVD after unlock **/
+      if (SecurityOperation == SECURITY_OPERATION_UNLOCK_DEVICE) {
+        AsmWbinvd();
+      }
 #endif
-    /** @todo(check on real HW)
-      WARNING: SetDimmSecurityState will not return EFI_ERROR on SECURITY_MASK_COUNTEXPIRED
-      so we have to check it additionally with GetDimmSecurityState.
-      It could be Simics/FW bug. Check how it is done on real HW.
-    **/
-    ReturnCode = GetDimmSecurityState(pDimms[Index], PT_TIMEOUT_INTERVAL, &DimmSecurityState);
+      StateReturnCode = GetDimmSecurityState(pDimms[Index], PT_TIMEOUT_INTERVAL, &DimmSecurityState);
+    }
+    ReturnCode = ReportSecurityOperationResult(pCommandStatus, pDimms[Index], SecurityOperation,
+        SetReturnCode, StateReturnCode, DimmSecurityState);
     if (EFI_ERROR(ReturnCode)) {
-      NVDIMM_DBG("Failed on GetDimmSecurityState, ReturnCode=" FORMAT_EFI_STATUS "", ReturnCode);
-      SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_OPERATION_FAILED);
-      ReturnCode = EFI_ABORTED;
       goto Finish;
     }
-    else if ((SecurityOperation == SECURITY_OPERATION_CHANGE_MASTER_PASSPHRASE) || (SecurityOperation == SECURITY_OPERATION_MASTER_ERASE_DEVICE)) {
-      if (DimmSecurityState & SECURITY_MASK_MASTER_COUNTEXPIRED) {
-        SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_SECURITY_MASTER_PP_COUNT_EXPIRED);
-        ReturnCode = EFI_ABORTED;
-        goto Finish;
-      }
-    }
-    else {
-      if (DimmSecurityState & SECURITY_MASK_COUNTEXPIRED) {
-        SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_ERR_SECURITY_USER_PP_COUNT_EXPIRED);
-        ReturnCode = EFI_ABORTED;
-        goto Finish;
+    SecurityStateUnknown = FALSE;
+  }
+
+  if (IsEraseOperation) {
+    // The erase of one DIMM takes long, so all DIMMs are erased at once
+    SecureEraseDimms(pDimms, DimmsNum, PayloadBufferSize, pSecurityPayload, EraseResults);
+    for (Index = 0; Index < DimmsNum; Index++) {
+      TempReturnCode = ReportSecurityOperationResult(pCommandStatus, pDimms[Index], SecurityOperation,
+          EraseResults[Index].EraseReturnCode, EraseResults[Index].StateReturnCode, EraseResults[Index].SecurityState);
+      if (EFI_ERROR(TempReturnCode)) {
+        if (!EFI_ERROR(ReturnCode)) {
+          ReturnCode = TempReturnCode;
+        }
+        // The erase may have reached the DIMM, reread what it may have changed
+        TempReturnCode = RefreshDimmInventoryEntry(pDimms[Index]);
+        if (EFI_ERROR(TempReturnCode)) {
+          NVDIMM_DBG("Unable to refresh the DIMM after a failed secure erase. ReturnCode=" FORMAT_EFI_STATUS "", TempReturnCode);
+        }
       }
     }
-
-    SetObjStatusForDimm(pCommandStatus, pDimms[Index], NVM_SUCCESS);
-
-    pDimms[Index]->EncryptionEnabled = ((DimmSecurityState & SECURITY_MASK_ENABLED) != 0);
   }
 
   if (!EFI_ERROR(ReturnCode)) {
@@ -3295,6 +3485,13 @@ SetSecurityState(
   }
 
 Finish:
+  if (SecurityStateUnknown && Index < DimmsNum) {
+    // The operation failed after reaching the DIMM, reread what it may have changed
+    TempReturnCode = RefreshDimmInventoryEntry(pDimms[Index]);
+    if (EFI_ERROR(TempReturnCode)) {
+      NVDIMM_DBG("Unable to refresh the DIMM after a failed security operation. ReturnCode=" FORMAT_EFI_STATUS "", TempReturnCode);
+    }
+  }
   if (SecurityOperation == SECURITY_OPERATION_UNLOCK_DEVICE || SecurityOperation == SECURITY_OPERATION_ERASE_DEVICE ||
     SecurityOperation == SECURITY_OPERATION_MASTER_ERASE_DEVICE) {
     TempReturnCode = ReenumerateNamespacesAndISs(TRUE);
@@ -3842,6 +4039,7 @@ ModifyPcdConfig(
   ReenumerateNamespacesAndISs(TRUE);
 
 Finish:
+  BumpPcdCacheGeneration();
   FREE_POOL_SAFE(pConfigHeader);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -3912,7 +4110,7 @@ GetRegionMinimalInfo(
     pRegionMin->DimmId[pRegionMin->DimmIdCount] = (UINT16)pDimm->DeviceHandle.AsUint32;
     pRegionMin->DimmIdCount++;
   }
-  BubbleSort(pRegionMin->DimmId, pRegionMin->DimmIdCount, sizeof(pRegionMin->DimmId[0]), SortRegionDimmId);
+  MergeSort(pRegionMin->DimmId, pRegionMin->DimmIdCount, sizeof(pRegionMin->DimmId[0]), SortRegionDimmId);
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
@@ -4106,7 +4304,7 @@ GetRegions(
     Index++;
   }
 
-  BubbleSort(pRegions, Count, sizeof(*pRegions), SortRegionInfoById);
+  MergeSort(pRegions, Count, sizeof(*pRegions), SortRegionInfoById);
 
 Finish:
   NVDIMM_EXIT_I64(Rc);
@@ -5607,6 +5805,10 @@ UpdateFw(
     else
     {
       SetObjStatusForDimmWithErase(pCommandStatus, pDimms[Index], NvmStatus, TRUE);
+      // Reread the inventory entry, the FW version also keys the Command Effect Log cache
+      if (EFI_ERROR(RefreshDimmInventoryEntry(pDimms[Index]))) {
+        NVDIMM_DBG("Failed to refresh dimm 0x%x after the update", pDimms[Index]->DeviceHandle.AsUint32);
+      }
     }
   }
 
@@ -6572,7 +6774,7 @@ CreateGoalConfig(
 
 Finish:
   ClearInternalGoalConfigsInfo(&gNvmDimmData->PMEMDev.Dimms);
-  ClearPcdCacheOnDimmList();
+  BumpPcdCacheGeneration();
   FREE_POOL_SAFE(ppDimms);
   FREE_POOL_SAFE(pDimmsSym);
   FREE_POOL_SAFE(pDimmsAsym);
@@ -6684,6 +6886,7 @@ DeleteGoalConfig (
 
 Finish:
   ClearInternalGoalConfigsInfo(&gNvmDimmData->PMEMDev.Dimms);
+  BumpPcdCacheGeneration();
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -7950,6 +8153,83 @@ Finish:
   return ReturnCode;
 }
 
+/**
+  Stream the debug log from a specified PMem module and fw debug log source
+
+  The log is handed to the page handler page by page as it is fetched, so
+  the caller never needs a buffer of the whole log size.
+
+  @param[in] pThis is a pointer to the EFI_DCPMM_CONFIG2_PROTOCOL instance.
+  @param[in] DimmID identifier of what PMem module to get log pages from
+  @param[in] LogSource debug log source buffer to retrieve
+  @param[in] StartPageOffset page to start from, non zero to resume an interrupted stream
+  @param[in] pHandler consumer of the fetched pages
+  @param[in] pContext context passed to the page handler
+  @param[out] pNextPageOffset page to resume from if the stream stopped early. OPTIONAL
+  @param[out] pCommandStatus structure containing detailed NVM error codes
+
+  @retval EFI_INVALID_PARAMETER One or more parameters are invalid
+  @retval EFI_NOT_STARTED No logs to fetch
+  @retval EFI_SUCCESS All ok
+**/
+EFI_STATUS
+EFIAPI
+GetFwDebugLogStream(
+  IN     EFI_DCPMM_CONFIG2_PROTOCOL *pThis,
+  IN     UINT16 DimmID,
+  IN     UINT8 LogSource,
+  IN     UINT32 StartPageOffset,
+  IN     FW_DEBUG_LOG_PAGE_HANDLER pHandler,
+  IN     VOID *pContext,
+     OUT UINT32 *pNextPageOffset OPTIONAL,
+     OUT COMMAND_STATUS *pCommandStatus
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  DIMM *pDimm = NULL;
+
+  NVDIMM_ENTRY();
+
+  if (pThis == NULL || pHandler == NULL || pCommandStatus == NULL || LogSource > FW_DEBUG_LOG_SOURCE_MAX) {
+    ResetCmdStatus(pCommandStatus, NVM_ERR_INVALID_PARAMETER);
+    goto Finish;
+  }
+
+  if (!gNvmDimmData->PMEMDev.DimmSkuConsistency) {
+    ReturnCode = EFI_UNSUPPORTED;
+    ResetCmdStatus(pCommandStatus, NVM_ERR_OPERATION_NOT_SUPPORTED_BY_MIXED_SKU);
+    goto Finish;
+  }
+
+  pDimm = GetDimmByPid(DimmID, &gNvmDimmData->PMEMDev.Dimms);
+  if (pDimm == NULL) {
+    ResetCmdStatus(pCommandStatus, NVM_ERR_DIMM_NOT_FOUND);
+    goto Finish;
+  }
+
+  if (!IsDimmManageable(pDimm)) {
+    SetObjStatus(pCommandStatus, pDimm->DeviceHandle.AsUint32, NULL, 0, NVM_ERR_MANAGEABLE_DIMM_NOT_FOUND);
+    goto Finish;
+  }
+
+  ReturnCode = FwCmdGetFwDebugLogStream(pDimm, LogSource, StartPageOffset, pHandler, pContext,
+      pNextPageOffset, pCommandStatus);
+
+  if (EFI_ERROR(ReturnCode) && ReturnCode != EFI_NOT_STARTED) {
+    if (ReturnCode == EFI_SECURITY_VIOLATION) {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_FW_DBG_LOG_FAILED_TO_GET_SIZE);
+    } else if (ReturnCode == EFI_NO_MEDIA) {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_MEDIA_DISABLED);
+    } else {
+      SetObjStatusForDimm(pCommandStatus, pDimm, NVM_ERR_OPERATION_FAILED);
+    }
+  }
+
+Finish:
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
 /**
   Set Optional Configuration Data Policy using FW command
 
@@ -8322,6 +8602,8 @@ FreeDimmList(
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_DBG("Unable to remove dimm inventory.");
   }
+  FreeCommandEffectLogCache();
+  FreeFwCmdPool();
   if (gNvmDimmData->PMEMDev.pFitHead != NULL) {
     FreeParsedNfit(&gNvmDimmData->PMEMDev.pFitHead);
     gNvmDimmData->PMEMDev.pFitHead = NULL;
@@ -8780,42 +9062,14 @@ GetDmiMemdevInfo(
 {
   EFI_STATUS ReturnCode = EFI_DEVICE_ERROR;
 
-  SMBIOS_STRUCTURE_POINTER SmBiosStruct;
-  SMBIOS_STRUCTURE_POINTER BoundSmBiosStruct;
-
   NVDIMM_ENTRY();
 
-  ZeroMem(&SmBiosStruct, sizeof(SmBiosStruct));
-  ZeroMem(&BoundSmBiosStruct, sizeof(BoundSmBiosStruct));
-
   if (pDmiPhysicalDev == NULL || pDmiDeviceMappedAddr == NULL || pSmbiosVersion == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     goto Finish;
   }
 
-  GetFirstAndBoundSmBiosStructPointer(&SmBiosStruct, &BoundSmBiosStruct, pSmbiosVersion);
-  if (SmBiosStruct.Raw == NULL || BoundSmBiosStruct.Raw == NULL) {
-    goto Finish;
-  }
-  while (SmBiosStruct.Raw < BoundSmBiosStruct.Raw) {
-    if (SmBiosStruct.Hdr != NULL) {
-      if (SmBiosStruct.Hdr->Type == SMBIOS_TYPE_MEM_DEV && SmBiosStruct.Hdr->Handle == DimmPid) {
-        pDmiPhysicalDev->Raw = SmBiosStruct.Raw;
-      } else if (SmBiosStruct.Hdr->Type == SMBIOS_TYPE_MEM_DEV_MAPPED_ADDR &&
-                 SmBiosStruct.Type20->MemoryDeviceHandle == DimmPid) {
-        pDmiDeviceMappedAddr->Raw = SmBiosStruct.Raw;
-      }
-    } else {
-      NVDIMM_ERR("SmBios entry has invalid pointers set");
-    }
-
-    ReturnCode = GetNextSmbiosStruct(&SmBiosStruct);
-    if (EFI_ERROR(ReturnCode)) {
-      goto Finish;
-    }
-  }
-
-  ReturnCode = EFI_SUCCESS;
+  ReturnCode = GetSmbiosMemdevStructs(DimmPid, pDmiPhysicalDev, pDmiDeviceMappedAddr, pSmbiosVersion);
 
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
@@ -9048,7 +9302,9 @@ GetSystemTopologyFromSmbios(
   EFI_STATUS ReturnCode = EFI_DEVICE_ERROR;
 
   SMBIOS_STRUCTURE_POINTER SmBiosStruct;
-  SMBIOS_STRUCTURE_POINTER BoundSmBiosStruct;
+  SMBIOS_STRUCTURE_POINTER *pMemdevs = NULL;
+  UINT32 MemdevCount = 0;
+  UINT32 MemdevIndex = 0;
   SMBIOS_VERSION SmbiosVersion;
   UINT8 CorrectedMemoryType;
   UINT16 Index = 0;
@@ -9068,18 +9324,16 @@ GetSystemTopologyFromSmbios(
   }
 
   ZeroMem(&SmBiosStruct, sizeof(SmBiosStruct));
-  ZeroMem(&BoundSmBiosStruct, sizeof(BoundSmBiosStruct));
   ZeroMem(&SmbiosVersion, sizeof(SmbiosVersion));
 
-  GetFirstAndBoundSmBiosStructPointer(&SmBiosStruct, &BoundSmBiosStruct, &SmbiosVersion);
-  if (SmBiosStruct.Raw == NULL || BoundSmBiosStruct.Raw == NULL) {
+  ReturnCode = GetSmbiosMemdevs(&pMemdevs, &MemdevCount, &SmbiosVersion);
+  if (EFI_ERROR(ReturnCode)) {
     goto Finish;
   }
 
-  while (SmBiosStruct.Raw < BoundSmBiosStruct.Raw) {
-    if ((SmBiosStruct.Hdr != NULL) &&
-        (SmBiosStruct.Hdr->Type == SMBIOS_TYPE_MEM_DEV) &&
-        ((SmBiosStruct.Type17->MemoryType == SMBIOS_MEMORY_TYPE_DDR4) ||
+  for (MemdevIndex = 0; MemdevIndex < MemdevCount; MemdevIndex++) {
+    SmBiosStruct = pMemdevs[MemdevIndex];
+    if (((SmBiosStruct.Type17->MemoryType == SMBIOS_MEMORY_TYPE_DDR4) ||
          (SmBiosStruct.Type17->MemoryType == SMBIOS_MEMORY_TYPE_LOGICAL_NON_VOLATILE) ||
          (SmBiosStruct.Type17->MemoryType == SMBIOS_MEMORY_TYPE_DCPM))) {
         (*ppTopologyDimm)[Index].DimmID = SmBiosStruct.Hdr->Handle;
@@ -9134,14 +9388,9 @@ GetSystemTopologyFromSmbios(
         Index++;
         (*pTopologyDimmsNumber) = Index;
     }
-
-    ReturnCode = GetNextSmbiosStruct(&SmBiosStruct);
-    if (EFI_ERROR(ReturnCode)) {
-      goto Finish;
-    }
   }
 
-  ReturnCode = BubbleSort(*ppTopologyDimm, *pTopologyDimmsNumber, sizeof(**ppTopologyDimm), SortDimmTopologyByMemType);
+  ReturnCode = MergeSort(*ppTopologyDimm, *pTopologyDimmsNumber, sizeof(**ppTopologyDimm), SortDimmTopologyByMemType);
 
 Finish:
 
@@ -9254,7 +9503,7 @@ GetSystemTopology(
     (*pTopologyDimmsNumber) = Index;
   }
 
-  ReturnCode = BubbleSort(*ppTopologyDimm, *pTopologyDimmsNumber, sizeof(**ppTopologyDimm), SortDimmTopologyByMemType);
+  ReturnCode = MergeSort(*ppTopologyDimm, *pTopologyDimmsNumber, sizeof(**ppTopologyDimm), SortDimmTopologyByMemType);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_WARN("Error in sorting the DIMM topology list");
     goto Finish;
@@ -10758,16 +11007,10 @@ GetCommandEffectLog(
 {
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
   DIMM *pDimm = NULL;
-  PT_INPUT_PAYLOAD_GET_COMMAND_EFFECT_LOG InputPayload;
-  PT_OUTPUT_PAYLOAD_GET_COMMAND_EFFECT_LOG OutPayload;
-  VOID *pLargeOutputPayload = NULL;
-  UINT32 CelTableSize = 0;
-  BOOLEAN LargePayloadAvailable = FALSE;
-
-  ZeroMem(&InputPayload, sizeof(InputPayload));
-  ZeroMem(&OutPayload, sizeof(OutPayload));
+  COMMAND_EFFECT_LOG_ENTRY *pCachedLogEntry = NULL;
+  UINT32 EntryCount = 0;
 
-  if (pThis == NULL) {
+  if (pThis == NULL || ppLogEntry == NULL || pEntryCount == NULL) {
     NVDIMM_DBG("One or more parameters are NULL");
     goto Finish;
   }
@@ -10778,56 +11021,16 @@ GetCommandEffectLog(
     goto Finish;
   }
 
-  // Format InputPayload for small payload entry count retrieval if necessary
-  CHECK_RESULT(IsLargePayloadAvailable(pDimm, &LargePayloadAvailable), Finish);
-  if (!LargePayloadAvailable) {
-    InputPayload.PayloadType = SmallPayload;
-    InputPayload.LogAction = EntriesCount;
-    InputPayload.EntryOffset = 0;
-  }
-
-  ReturnCode = FwCmdGetCommandEffectLog(pDimm, &InputPayload, &OutPayload, sizeof(OutPayload), NULL, 0);
-  if (EFI_ERROR(ReturnCode)) {
-    goto Finish;
-  }
-  *pEntryCount = OutPayload.LogTypeData.CelCount.LogEntryCount;
-  CelTableSize = sizeof(COMMAND_EFFECT_LOG_ENTRY) * (*pEntryCount);
+  // The CEL only changes with the FW build, so it is read from the DIMM once per build
+  CHECK_RESULT(GetDimmCommandEffectLog(pDimm, &pCachedLogEntry, &EntryCount), Finish);
 
-  pLargeOutputPayload = AllocateZeroPool(CelTableSize);
-  if (pLargeOutputPayload == NULL) {
+  *ppLogEntry = AllocateCopyPool(sizeof(COMMAND_EFFECT_LOG_ENTRY) * EntryCount, pCachedLogEntry);
+  if (*ppLogEntry == NULL) {
     ReturnCode = EFI_OUT_OF_RESOURCES;
     goto Finish;
   }
-  *ppLogEntry = (COMMAND_EFFECT_LOG_ENTRY*)pLargeOutputPayload;
-
-  if (!LargePayloadAvailable) {
-    UINT32 EntryCountRemaining = *pEntryCount;
-    UINT8 CelEntriesPerSmallPayload = (sizeof(PT_OUTPUT_PAYLOAD_GET_COMMAND_EFFECT_LOG) / sizeof(COMMAND_EFFECT_LOG_ENTRY));
-    UINT32 OutputBytes = 0;
-    InputPayload.PayloadType = SmallPayload;
-    InputPayload.LogAction = CelEntries;
-    InputPayload.EntryOffset = 0;
-
-    while (EntryCountRemaining > 0) {
-      ReturnCode = FwCmdGetCommandEffectLog(pDimm, &InputPayload, &OutPayload, sizeof(OutPayload), NULL, 0);
-      if (EFI_ERROR(ReturnCode)) {
-        goto Finish;
-      }
-      OutputBytes = EntryCountRemaining > CelEntriesPerSmallPayload ? sizeof(OutPayload) : sizeof(COMMAND_EFFECT_LOG_ENTRY) * EntryCountRemaining;
-      CopyMem_S((*ppLogEntry) + InputPayload.EntryOffset, sizeof(COMMAND_EFFECT_LOG_ENTRY) * EntryCountRemaining, &OutPayload, OutputBytes);
-      EntryCountRemaining = EntryCountRemaining > CelEntriesPerSmallPayload ? EntryCountRemaining - CelEntriesPerSmallPayload : 0;
-      InputPayload.EntryOffset += CelEntriesPerSmallPayload;
-    }
-  }
-  else {
-    ReturnCode = FwCmdGetCommandEffectLog(pDimm, &InputPayload, &OutPayload, sizeof(OutPayload), pLargeOutputPayload, CelTableSize);
-    if (EFI_ERROR(ReturnCode)) {
-      goto Finish;
-    }
-  }
-
+  *pEntryCount = EntryCount;
   ReturnCode = EFI_SUCCESS;
-  goto Finish;
 
 Finish:
   NVDIMM_EXIT_I64(ReturnCode);
@@ -10835,6 +11038,24 @@ Finish:
 }
 
 #ifndef OS_BUILD
+/**
+  Check if an address range overlaps any record in the ARS interval index
+
+  @param[in] Address The base address
+  @param[in] Length The address range size
+
+  @retval TRUE The range overlaps at least one ARS record
+  @retval FALSE The range does not overlap any ARS record
+**/
+BOOLEAN
+ArsBadRecordsOverlap(
+  IN     UINT64 Address,
+  IN     UINT64 Length
+  )
+{
+  return RangeIndexOverlaps(&gArsBadRangeIndex, Address, Length);
+}
+
 /**
   This function makes calls to the dimms required to initialize the driver.
 
@@ -10847,6 +11068,7 @@ LoadArsList()
   UINT32 x = 0;
   UINT32 records = 0;
   EFI_STATUS ReturnCode = EFI_SUCCESS;
+  DCPMM_ARS_ERROR_RECORD *pRecords = NULL;
 
   NVDIMM_ENTRY();
 
@@ -10861,6 +11083,7 @@ LoadArsList()
   if (ReturnCode == EFI_NOT_READY)
   {
     NVDIMM_WARN("BIOS reports not ready for full ARS list. The returned list may be partial.");
+    gArsBadRecordsPartial = TRUE;
     ReturnCode = EFI_SUCCESS;
   }
 
@@ -10871,38 +11094,78 @@ LoadArsList()
 
   //if there are records, allocate the space for them and obtain them
   if (records > 0) {
-    gArsBadRecords = (DCPMM_ARS_ERROR_RECORD *)AllocateZeroPool(sizeof(DCPMM_ARS_ERROR_RECORD) * records);
-    if (gArsBadRecords == NULL) {
+    pRecords = (DCPMM_ARS_ERROR_RECORD *)AllocateZeroPool(sizeof(DCPMM_ARS_ERROR_RECORD) * records);
+    if (pRecords == NULL) {
       NVDIMM_WARN("Failed to allocate memory for the bad ARS records");
       ReturnCode = EFI_OUT_OF_RESOURCES;
       goto Finish;
     }
 
-    ReturnCode = gNvmDimmData->pDcpmmProtocol->DcpmmArsStatus(&records, gArsBadRecords);
+    ReturnCode = gNvmDimmData->pDcpmmProtocol->DcpmmArsStatus(&records, pRecords);
     if (ReturnCode == EFI_NOT_READY)
     {
       NVDIMM_WARN("BIOS reports not ready for full ARS list. The returned list may be partial.");
+      gArsBadRecordsPartial = TRUE;
       ReturnCode = EFI_SUCCESS;
     }
 
     if (EFI_ERROR(ReturnCode)) {
       NVDIMM_WARN("Could not obtain the ARS bad address list");
-      FreePool(gArsBadRecords);
       goto Finish;
     }
 
-    gArsBadRecordsCount = records;
+    ReturnCode = RangeIndexInit(&gArsBadRangeIndex, records);
+    if (EFI_ERROR(ReturnCode)) {
+      NVDIMM_WARN("Failed to build the ARS bad address index");
+      goto Finish;
+    }
     for (; x < records; x++)
     {
       NVDIMM_DBG("ArsBadRecords[%d] = 0x%llx, len = 0x%llx, nfit handle = 0x%llx",
-        x, gArsBadRecords[x].SpaOfErrLoc, gArsBadRecords[x].Length, gArsBadRecords[x].NfitHandle);
+        x, pRecords[x].SpaOfErrLoc, pRecords[x].Length, pRecords[x].NfitHandle);
+      RangeIndexInsert(&gArsBadRangeIndex, pRecords[x].SpaOfErrLoc, pRecords[x].Length);
     }
+    ReturnCode = RangeIndexBuild(&gArsBadRangeIndex);
+    if (EFI_ERROR(ReturnCode)) {
+      NVDIMM_WARN("Failed to build the ARS bad address index");
+      RangeIndexFree(&gArsBadRangeIndex);
+      goto Finish;
+    }
+    gArsBadRecordsCount = (INT32)gArsBadRangeIndex.EntriesNum;
   }
 
 Finish:
+  FREE_POOL_SAFE(pRecords);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
+
+/**
+  Drop the ARS interval index, the next collision check reloads the list from BIOS.
+  Called when the ARS status of a PMem module changes.
+**/
+VOID
+InvalidateArsList(
+  )
+{
+  NVDIMM_DBG("ARS list invalidated.\n");
+  RangeIndexFree(&gArsBadRangeIndex);
+  gArsBadRecordsCount = ARS_LIST_NOT_INITIALIZED;
+  gArsBadRecordsPartial = FALSE;
+}
+
+/**
+  Check if the loaded ARS list was returned by BIOS while ARS was running
+
+  @retval TRUE The list may miss the records of the running ARS
+  @retval FALSE The list is complete or not loaded
+**/
+BOOLEAN
+IsArsListPartial(
+  )
+{
+  return gArsBadRecordsPartial;
+}
 #endif
 
 /**
@@ -755,6 +755,23 @@ GetSmartAndHealth (
   OUT SMART_AND_HEALTH_INFO *pHealthInfo
   );
 
+/**
+  Take the SMART snapshots of the requested PMem modules without a valid one
+
+  The stale modules are read in parallel where supported (see RunOnDimms).
+
+  @param[in] ppDimms The PMem modules a consumer asked for
+  @param[in] DimmsNum Number of PMem modules in ppDimms
+
+  @retval EFI_SUCCESS The stale snapshots were taken
+  @retval EFI_INVALID_PARAMETER ppDimms is NULL or DimmsNum is above MAX_DIMMS
+**/
+EFI_STATUS
+RefreshSmartSnapshots(
+  IN     DIMM **ppDimms,
+  IN     UINT32 DimmsNum
+  );
+
 /**
   Get Driver API Version
 
@@ -1116,6 +1133,38 @@ GetFwDebugLog(
      OUT COMMAND_STATUS *pCommandStatus
   );
 
+/**
+  Stream the debug log from a specified PMem module and fw debug log source
+
+  The log is handed to the page handler page by page as it is fetched, so
+  the caller never needs a buffer of the whole log size.
+
+  @param[in] pThis is a pointer to the EFI_DCPMM_CONFIG2_PROTOCOL instance.
+  @param[in] DimmID identifier of what PMem module to get log pages from
+  @param[in] LogSource debug log source buffer to retrieve
+  @param[in] StartPageOffset page to start from, non zero to resume an interrupted stream
+  @param[in] pHandler consumer of the fetched pages
+  @param[in] pContext context passed to the page handler
+  @param[out] pNextPageOffset page to resume from if the stream stopped early. OPTIONAL
+  @param[out] pCommandStatus structure containing detailed NVM error codes
+
+  @retval EFI_INVALID_PARAMETER One or more parameters are invalid
+  @retval EFI_NOT_STARTED No logs to fetch
+  @retval EFI_SUCCESS All ok
+**/
+EFI_STATUS
+EFIAPI
+GetFwDebugLogStream(
+  IN     EFI_DCPMM_CONFIG2_PROTOCOL *pThis,
+  IN     UINT16 DimmID,
+  IN     UINT8 LogSource,
+  IN     UINT32 StartPageOffset,
+  IN     FW_DEBUG_LOG_PAGE_HANDLER pHandler,
+  IN     VOID *pContext,
+     OUT UINT32 *pNextPageOffset OPTIONAL,
+     OUT COMMAND_STATUS *pCommandStatus
+  );
+
 /**
   Set Optional Configuration Data Policy using FW command
 
@@ -1598,6 +1647,39 @@ GetCommandEffectLog(
 **/
 EFI_STATUS
 LoadArsList();
+
+/**
+  Check if an address range overlaps any record in the ARS interval index
+
+  @param[in] Address The base address
+  @param[in] Length The address range size
+
+  @retval TRUE The range overlaps at least one ARS record
+  @retval FALSE The range does not overlap any ARS record
+**/
+BOOLEAN
+ArsBadRecordsOverlap(
+  IN     UINT64 Address,
+  IN     UINT64 Length
+  );
+
+/**
+  Drop the ARS interval index, the next collision check reloads the list from BIOS.
+  Called when the ARS status of a PMem module changes.
+**/
+VOID
+InvalidateArsList(
+  );
+
+/**
+  Check if the loaded ARS list was returned by BIOS while ARS was running
+
+  @retval TRUE The list may miss the records of the running ARS
+  @retval FALSE The list is complete or not loaded
+**/
+BOOLEAN
+IsArsListPartial(
+  );
 #endif
 
 /**
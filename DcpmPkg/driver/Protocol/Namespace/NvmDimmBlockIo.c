@@ -88,7 +88,6 @@ NvmDimmDriverBlockIoReadBlocks(
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
   NAMESPACE *pNamespace = NULL;
-  UINT32 Index = 0;
   UINT64 BlocksToRead = 0;
   CHAR8 *pByteBuffer = pBuffer;
 
@@ -133,13 +132,7 @@ NvmDimmDriverBlockIoReadBlocks(
     goto Finish;
   }
 
-  for (Index = 0; Index < BlocksToRead; Index++) {
-    ReturnCode = ReadBlockDevice(pNamespace, Lba + Index, pByteBuffer + (Index *pThis->Media->BlockSize));
-
-    if (EFI_ERROR(ReturnCode)) {
-      goto Finish;
-    }
-  }
+  ReturnCode = ReadBlockDeviceRange(pNamespace, Lba, BlocksToRead, pByteBuffer);
 
 Finish:
   if (EFI_ERROR(ReturnCode)) {
@@ -179,7 +172,6 @@ NvmDimmDriverBlockIoWriteBlocks(
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
   NAMESPACE *pNamespace = NULL;
-  UINT32 Index = 0;
   UINT64 BlocksToWrite = 0;
   CHAR8 *pByteBuffer = pBuffer;
 
@@ -224,13 +216,7 @@ NvmDimmDriverBlockIoWriteBlocks(
     goto Finish;
   }
 
-  for (Index = 0; Index < BlocksToWrite; Index++) {
-    ReturnCode = WriteBlockDevice(pNamespace, Lba + Index, pByteBuffer + (Index * pThis->Media->BlockSize));
-
-    if (EFI_ERROR(ReturnCode)) {
-      goto Finish;
-    }
-  }
+  ReturnCode = WriteBlockDeviceRange(pNamespace, Lba, BlocksToWrite, pByteBuffer);
 
 Finish:
   if (EFI_ERROR(ReturnCode)) {
@@ -42,150 +42,429 @@ GUID gChannelTypeDeviceGuid = PMTT_TYPE_CHANNEL_GUID;
 GUID gSlotTypeDeviceGuid = PMTT_TYPE_SLOT_GUID;
 
 /**
-  CopyMemoryAndAddPointerToArray - Copies the data and adds the result pointer to an array of pointers.
+  Arena used to store a parsed ACPI table in a single allocation
 
-  @param[in, out] ppTable pointer to the pointers. Warning! This pointer will be freed.
-  @param[in] pToAdd pointer to the data that the caller wants to add to the array.
-  @param[in] DataSize size of the data that are supposed to be copied.
-  @param[in] NewPointerIndex index in the table that the new pointer should have.
+  The parsers walk a table twice with the same arena. While pCursor is NULL
+  the arena only accumulates the size of the requested blocks. Once the
+  memory is allocated the second walk hands out the blocks in the same order.
+**/
+typedef struct {
+  UINT8 *pCursor;     //!< Next free byte, NULL while sizing the arena
+  UINT8 *pBound;      //!< End of the arena
+  UINTN Size;         //!< Bytes requested while sizing the arena
+} ACPI_PARSE_ARENA;
+
+#define ACPI_PARSE_ARENA_ALIGNMENT  8
+
+/**
+  Reserve a block of the arena
 
-  @retval NULL - if a memory allocation failed.
-  @retval pointer to the new array of pointers (with the new one at the end).
+  @param[in, out] pArena arena to reserve the block from
+  @param[in] Size size of the block in bytes
+
+  @retval NULL - while sizing the arena or if the arena is exhausted
+  @retval pointer to the zeroed block
+**/
+STATIC
+VOID *
+ArenaAlloc(
+  IN OUT ACPI_PARSE_ARENA *pArena,
+  IN     UINTN Size
+  )
+{
+  VOID *pBlock = NULL;
+
+  Size = ALIGN_VALUE(Size, ACPI_PARSE_ARENA_ALIGNMENT);
+
+  if (pArena->pCursor == NULL) {
+    pArena->Size += Size;
+    return NULL;
+  }
+
+  if (Size > (UINTN)(pArena->pBound - pArena->pCursor)) {
+    NVDIMM_ERR("ACPI parse arena exhausted.");
+    return NULL;
+  }
+
+  pBlock = pArena->pCursor;
+  pArena->pCursor += Size;
+  return pBlock;
+}
+
+/**
+  Reserve an array of table pointers in the arena
+
+  @param[in, out] pArena arena to reserve the array from
+  @param[in] Count number of pointers in the array
+
+  @retval NULL - if Count is 0, while sizing the arena or if the arena is exhausted
+  @retval pointer to the array
 **/
 STATIC
 VOID **
-CopyMemoryAndAddPointerToArray(
-  IN OUT VOID **ppTable,
-  IN     VOID *pToAdd,
-  IN     UINT32 DataSize,
-  IN     UINT32 *pNewPointerIndex
-  );
+ArenaAllocPointerArray(
+  IN OUT ACPI_PARSE_ARENA *pArena,
+  IN     UINT32 Count
+  )
+{
+  if (Count == 0) {
+    return NULL;
+  }
+  return (VOID **)ArenaAlloc(pArena, sizeof(VOID *) * Count);
+}
 
 /**
-  ParseNfitTable - Performs deserialization from binary memory block into parsed structure of pointers.
+  Copy a sub-table into the arena and add its pointer to an array of pointers.
+  While sizing the arena only the count and the arena size are updated.
 
-  @param[in] pTable pointer to the memory containing the NFIT binary representation.
-  @param[out] ppParsedNfit Pointer to a pointer where the allocated and parsed NFIT table will be stored
+  @param[in, out] pArena arena the sub-table is copied to
+  @param[in, out] ppTables array of pointers sized in the previous walk
+  @param[in, out] pTablesNum count of pointers in the array, incremented
+  @param[in] pToAdd pointer to the sub-table
+  @param[in] DataSize size of the sub-table in bytes
+  @param[out] ppCopy optional pointer to the copied sub-table
 
-  @retval EFI_INVALID_PARAMETER One of the provided parameters is invalid
-  @retval EFI_VOLUME_CORRUPTED If the table checksum is invalid
-  @retval EFI_INCOMPATIBLE_VERSION If the table is not compatible with this ipmctl version
   @retval EFI_SUCCESS
+  @retval EFI_OUT_OF_RESOURCES The arena does not match the sizing walk
 **/
+STATIC
 EFI_STATUS
-ParseNfitTable(
-  IN     VOID *pTable,
-     OUT ParsedFitHeader **ppParsedNfit
+ArenaAddSubTable(
+  IN OUT ACPI_PARSE_ARENA *pArena,
+  IN OUT VOID **ppTables,
+  IN OUT UINT32 *pTablesNum,
+  IN     VOID *pToAdd,
+  IN     UINT32 DataSize,
+     OUT VOID **ppCopy OPTIONAL
   )
 {
-  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
-  ParsedFitHeader *pParsedNfit = NULL;
-  NFitHeader *pNFit = NULL;
-  UINT8 *pTabPointer = NULL;
-  SubTableHeader *pTableHeader = NULL;
-  UINT32 RemainingNFITBytes = 0;
+  VOID *pData = NULL;
 
-  NVDIMM_ENTRY();
+  pData = ArenaAlloc(pArena, DataSize);
+  if (pArena->pCursor == NULL) {
+    (*pTablesNum)++;
+    return EFI_SUCCESS;
+  }
 
-  CHECK_NULL_ARG(pTable, Finish);
-  CHECK_NULL_ARG(ppParsedNfit, Finish);
+  if (pData == NULL || ppTables == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
 
-  pNFit = (NFitHeader *)pTable;
+  CopyMem_S(pData, DataSize, pToAdd, DataSize);
+  ppTables[*pTablesNum] = pData;
+  (*pTablesNum)++;
 
-  if (!IsChecksumValid(pNFit, pNFit->Header.Length)) {
-    NVDIMM_DBG("The checksum of the NFIT table is invalid.");
-    ReturnCode = EFI_VOLUME_CORRUPTED;
-    goto Finish;
+  if (ppCopy != NULL) {
+    *ppCopy = pData;
   }
+  return EFI_SUCCESS;
+}
 
-  if (IS_NFIT_REVISION_INVALID(pNFit->Header.Revision)) {
-    NVDIMM_DBG("NFIT table revision is invalid");
-    ReturnCode = EFI_INCOMPATIBLE_VERSION;
-    goto Finish;
+/**
+  Reserve the slots of a lookup index in the arena
+
+  The index is kept at most half full.
+
+  @param[in, out] pArena arena the slots are reserved from
+  @param[out] pIndex index to set up
+  @param[in] Count number of tables that will be indexed
+**/
+STATIC
+VOID
+ArenaAllocIndex(
+  IN OUT ACPI_PARSE_ARENA *pArena,
+     OUT ACPI_TABLE_INDEX *pIndex,
+  IN     UINT32 Count
+  )
+{
+  ZeroMem(pIndex, sizeof(*pIndex));
+
+  if (Count == 0) {
+    return;
   }
 
-  pTabPointer = (UINT8 *)pTable + sizeof(NFitHeader);
-  pTableHeader = (SubTableHeader *)pTabPointer;
-  RemainingNFITBytes = pNFit->Header.Length - sizeof(*pNFit);
-  CHECK_RESULT_MALLOC(*ppParsedNfit, (ParsedFitHeader *)AllocateZeroPool(sizeof(**ppParsedNfit)), Finish);
-  pParsedNfit = *ppParsedNfit;
+  pIndex->SlotsNum = 1;
+  while (pIndex->SlotsNum < 2 * Count) {
+    pIndex->SlotsNum <<= 1;
+  }
+  pIndex->pKeys = (UINT32 *)ArenaAlloc(pArena, sizeof(UINT32) * pIndex->SlotsNum);
+  pIndex->pPositions = (UINT32 *)ArenaAlloc(pArena, sizeof(UINT32) * pIndex->SlotsNum);
+  if (pIndex->pKeys == NULL || pIndex->pPositions == NULL) {
+    pIndex->SlotsNum = 0;
+  }
+}
+
+/**
+  Find the slot of a key in a lookup index
 
-  CHECK_RESULT_MALLOC(pParsedNfit->pFit, (NFitHeader *)AllocateZeroPool(sizeof(*(pParsedNfit->pFit))), Finish);
+  @param[in] pIndex index to search
+  @param[in] Key key to look for
 
-  CopyMem_S(pParsedNfit->pFit, sizeof(*(pParsedNfit->pFit)), pNFit, sizeof(*(pParsedNfit->pFit)));
+  @retval slot holding the key or the empty slot where it belongs
+**/
+STATIC
+UINT32
+AcpiIndexSlot(
+  IN     ACPI_TABLE_INDEX *pIndex,
+  IN     UINT32 Key
+  )
+{
+  UINT32 Hash = Key * 0x9E3779B1;
+  UINT32 Slot = (Hash ^ (Hash >> 16)) & (pIndex->SlotsNum - 1);
+
+  while (pIndex->pPositions[Slot] != 0 && pIndex->pKeys[Slot] != Key) {
+    Slot = (Slot + 1) & (pIndex->SlotsNum - 1);
+  }
+  return Slot;
+}
+
+/**
+  Add a table position to a lookup index
+
+  @param[in, out] pIndex index to add the position to
+  @param[in] Key key of the table
+  @param[in] Position position of the table in its array
+  @param[in] Replace TRUE to replace a position already stored for the key
+**/
+STATIC
+VOID
+AcpiIndexInsert(
+  IN OUT ACPI_TABLE_INDEX *pIndex,
+  IN     UINT32 Key,
+  IN     UINT32 Position,
+  IN     BOOLEAN Replace
+  )
+{
+  UINT32 Slot = 0;
+
+  if (pIndex->SlotsNum == 0) {
+    return;
+  }
+
+  Slot = AcpiIndexSlot(pIndex, Key);
+  if (pIndex->pPositions[Slot] == 0 || Replace) {
+    pIndex->pKeys[Slot] = Key;
+    pIndex->pPositions[Slot] = Position + 1;
+  }
+}
+
+/**
+  Look up a table position in a lookup index
+
+  @param[in] pIndex index to search
+  @param[in] Key key of the table
+
+  @retval position of the table + 1, 0 if the key is not indexed
+**/
+STATIC
+UINT32
+AcpiIndexFind(
+  IN     ACPI_TABLE_INDEX *pIndex,
+  IN     UINT32 Key
+  )
+{
+  if (pIndex->SlotsNum == 0) {
+    return 0;
+  }
+  return pIndex->pPositions[AcpiIndexSlot(pIndex, Key)];
+}
+
+/**
+  Walk the NFIT sub-tables and add them to the parsed NFIT
+
+  @param[in] pNFit pointer to the NFIT binary representation
+  @param[in, out] pParsedNfit parsed NFIT, counts only while sizing the arena
+  @param[in, out] pArena arena the sub-tables are copied to
+
+  @retval EFI_INVALID_PARAMETER A sub-table has an invalid length
+  @retval EFI_OUT_OF_RESOURCES The arena does not match the sizing walk
+  @retval EFI_SUCCESS
+**/
+STATIC
+EFI_STATUS
+WalkNfitSubTables(
+  IN     NFitHeader *pNFit,
+  IN OUT ParsedFitHeader *pParsedNfit,
+  IN OUT ACPI_PARSE_ARENA *pArena
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  UINT8 *pTabPointer = NULL;
+  SubTableHeader *pTableHeader = NULL;
+  UINT32 RemainingNFITBytes = 0;
+
+  pTabPointer = (UINT8 *)pNFit + sizeof(NFitHeader);
+  pTableHeader = (SubTableHeader *)pTabPointer;
+  RemainingNFITBytes = pNFit->Header.Length - sizeof(*pNFit);
 
   while (RemainingNFITBytes > 0) {
-    if (pTableHeader->Length == 0) {
-      NVDIMM_DBG("Zero size entry found in nfit region.");
-      goto Finish;
+    if (pTableHeader->Length == 0 || pTableHeader->Length > RemainingNFITBytes) {
+      NVDIMM_DBG("Invalid size entry found in nfit region.");
+      return EFI_INVALID_PARAMETER;
     }
 
     RemainingNFITBytes -= pTableHeader->Length;
 
     switch(pTableHeader->Type) {
     case NVDIMM_SPA_RANGE_TYPE:
-      CHECK_RESULT_MALLOC(pParsedNfit->ppSpaRangeTbles, (SpaRangeTbl **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedNfit->ppSpaRangeTbles, pTabPointer,
-          pTableHeader->Length, &pParsedNfit->SpaRangeTblesNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedNfit->ppSpaRangeTbles,
+          &pParsedNfit->SpaRangeTblesNum, pTabPointer, pTableHeader->Length, NULL);
       break;
     case NVDIMM_NVDIMM_REGION_TYPE:
-      CHECK_RESULT_MALLOC(pParsedNfit->ppNvDimmRegionMappingStructures, (NvDimmRegionMappingStructure **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedNfit->ppNvDimmRegionMappingStructures, pTabPointer,
-          pTableHeader->Length, &pParsedNfit->NvDimmRegionMappingStructuresNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedNfit->ppNvDimmRegionMappingStructures,
+          &pParsedNfit->NvDimmRegionMappingStructuresNum, pTabPointer, pTableHeader->Length, NULL);
       break;
     case NVDIMM_INTERLEAVE_TYPE:
-      CHECK_RESULT_MALLOC(pParsedNfit->ppInterleaveTbles, (InterleaveStruct **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedNfit->ppInterleaveTbles, pTabPointer,
-          pTableHeader->Length, &pParsedNfit->InterleaveTblesNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedNfit->ppInterleaveTbles,
+          &pParsedNfit->InterleaveTblesNum, pTabPointer, pTableHeader->Length, NULL);
       break;
     case NVDIMM_SMBIOS_MGMT_INFO_TYPE:
-      CHECK_RESULT_MALLOC(pParsedNfit->ppSmbiosTbles, (SmbiosTbl **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedNfit->ppSmbiosTbles, pTabPointer,
-          pTableHeader->Length, &pParsedNfit->SmbiosTblesNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedNfit->ppSmbiosTbles,
+          &pParsedNfit->SmbiosTblesNum, pTabPointer, pTableHeader->Length, NULL);
       break;
     case NVDIMM_CONTROL_REGION_TYPE:
-      CHECK_RESULT_MALLOC(pParsedNfit->ppControlRegionTbles, (ControlRegionTbl **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedNfit->ppControlRegionTbles, pTabPointer,
-          pTableHeader->Length, &pParsedNfit->ControlRegionTblesNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedNfit->ppControlRegionTbles,
+          &pParsedNfit->ControlRegionTblesNum, pTabPointer, pTableHeader->Length, NULL);
       break;
     case NVDIMM_BW_DATA_WINDOW_REGION_TYPE:
-      CHECK_RESULT_MALLOC(pParsedNfit->ppBWRegionTbles, (BWRegionTbl **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedNfit->ppBWRegionTbles, pTabPointer,
-          pTableHeader->Length, &pParsedNfit->BWRegionTblesNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedNfit->ppBWRegionTbles,
+          &pParsedNfit->BWRegionTblesNum, pTabPointer, pTableHeader->Length, NULL);
       break;
     case NVDIMM_FLUSH_HINT_TYPE:
-      CHECK_RESULT_MALLOC(pParsedNfit->ppFlushHintTbles, (FlushHintTbl **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedNfit->ppFlushHintTbles, pTabPointer,
-          pTableHeader->Length, &pParsedNfit->FlushHintTblesNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedNfit->ppFlushHintTbles,
+          &pParsedNfit->FlushHintTblesNum, pTabPointer, pTableHeader->Length, NULL);
       break;
     case NVDIMM_PLATFORM_CAPABILITIES_TYPE:
-      CHECK_RESULT_MALLOC(pParsedNfit->ppPlatformCapabilitiesTbles, (PlatformCapabilitiesTbl **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedNfit->ppPlatformCapabilitiesTbles, pTabPointer,
-          pTableHeader->Length, &pParsedNfit->PlatformCapabilitiesTblesNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedNfit->ppPlatformCapabilitiesTbles,
+          &pParsedNfit->PlatformCapabilitiesTblesNum, pTabPointer, pTableHeader->Length, NULL);
       break;
     default:
       break;
     }
 
+    if (EFI_ERROR(ReturnCode)) {
+      return ReturnCode;
+    }
+
     pTabPointer += pTableHeader->Length;
     pTableHeader = (SubTableHeader *)pTabPointer;
   }
 
-  ReturnCode = EFI_SUCCESS;
+  return EFI_SUCCESS;
+}
 
-Finish:
-  if (EFI_ERROR(ReturnCode) && ppParsedNfit != NULL && *ppParsedNfit != NULL) {
-    FreeParsedNfit(ppParsedNfit);
+/**
+  Reserve the arrays of sub-table pointers of the parsed NFIT
+
+  @param[out] pParsedNfit parsed NFIT the arrays are assigned to
+  @param[in] pCounts parsed NFIT holding the counts from the sizing walk
+  @param[in, out] pArena arena the arrays are reserved from
+**/
+STATIC
+VOID
+AllocNfitPointerArrays(
+     OUT ParsedFitHeader *pParsedNfit,
+  IN     ParsedFitHeader *pCounts,
+  IN OUT ACPI_PARSE_ARENA *pArena
+  )
+{
+  pParsedNfit->ppSpaRangeTbles = (SpaRangeTbl **)ArenaAllocPointerArray(pArena, pCounts->SpaRangeTblesNum);
+  pParsedNfit->ppNvDimmRegionMappingStructures = (NvDimmRegionMappingStructure **)ArenaAllocPointerArray(pArena,
+      pCounts->NvDimmRegionMappingStructuresNum);
+  pParsedNfit->ppInterleaveTbles = (InterleaveStruct **)ArenaAllocPointerArray(pArena, pCounts->InterleaveTblesNum);
+  pParsedNfit->ppSmbiosTbles = (SmbiosTbl **)ArenaAllocPointerArray(pArena, pCounts->SmbiosTblesNum);
+  pParsedNfit->ppControlRegionTbles = (ControlRegionTbl **)ArenaAllocPointerArray(pArena, pCounts->ControlRegionTblesNum);
+  pParsedNfit->ppBWRegionTbles = (BWRegionTbl **)ArenaAllocPointerArray(pArena, pCounts->BWRegionTblesNum);
+  pParsedNfit->ppFlushHintTbles = (FlushHintTbl **)ArenaAllocPointerArray(pArena, pCounts->FlushHintTblesNum);
+  pParsedNfit->ppPlatformCapabilitiesTbles = (PlatformCapabilitiesTbl **)ArenaAllocPointerArray(pArena,
+      pCounts->PlatformCapabilitiesTblesNum);
+}
+
+/**
+  Reserve the lookup indexes of the parsed NFIT
+
+  @param[out] pParsedNfit parsed NFIT the indexes are assigned to
+  @param[in] pCounts parsed NFIT holding the counts from the sizing walk
+  @param[in, out] pArena arena the indexes are reserved from
+**/
+STATIC
+VOID
+AllocNfitIndexes(
+     OUT ParsedFitHeader *pParsedNfit,
+  IN     ParsedFitHeader *pCounts,
+  IN OUT ACPI_PARSE_ARENA *pArena
+  )
+{
+  ArenaAllocIndex(pArena, &pParsedNfit->SpaRangeTblesIndex, pCounts->SpaRangeTblesNum);
+  ArenaAllocIndex(pArena, &pParsedNfit->InterleaveTblesIndex, pCounts->InterleaveTblesNum);
+  ArenaAllocIndex(pArena, &pParsedNfit->ControlRegionTblesIndex, pCounts->ControlRegionTblesNum);
+  ArenaAllocIndex(pArena, &pParsedNfit->BWRegionTblesIndex, pCounts->BWRegionTblesNum);
+  ArenaAllocIndex(pArena, &pParsedNfit->FlushHintTblesIndex, pCounts->FlushHintTblesNum);
+  ArenaAllocIndex(pArena, &pParsedNfit->NvDimmRegionMappingStructuresIndex, pCounts->NvDimmRegionMappingStructuresNum);
+  pParsedNfit->pNvDimmRegionMappingStructuresNext = NULL;
+  if (pCounts->NvDimmRegionMappingStructuresNum > 0) {
+    pParsedNfit->pNvDimmRegionMappingStructuresNext = (UINT32 *)ArenaAlloc(pArena,
+        sizeof(UINT32) * pCounts->NvDimmRegionMappingStructuresNum);
   }
-  NVDIMM_EXIT_I64(ReturnCode);
-  return ReturnCode;
 }
 
 /**
-  Performs deserialization from binary memory block, containing PCAT tables, into parsed structure of pointers.
+  Fill the lookup indexes of the parsed NFIT
 
-  @param[in] pTable pointer to the memory containing the PCAT binary representation.
-  @param[out] ppParsedPcat Pointer to a pointer where the allocated and parsed PCAT table will be stored
+  Lookups by table index return the first matching table, lookups by device
+  handle the last one, the same as the linear scans they replace. The Region
+  tables of a physical ID are chained in table order.
+
+  @param[in, out] pParsedNfit parsed NFIT with all sub-tables copied
+**/
+STATIC
+VOID
+BuildNfitIndexes(
+  IN OUT ParsedFitHeader *pParsedNfit
+  )
+{
+  UINT32 Index = 0;
+  UINT32 Pid = 0;
+
+  for (Index = 0; Index < pParsedNfit->SpaRangeTblesNum; Index++) {
+    AcpiIndexInsert(&pParsedNfit->SpaRangeTblesIndex,
+        pParsedNfit->ppSpaRangeTbles[Index]->SpaRangeDescriptionTableIndex, Index, FALSE);
+  }
+  for (Index = 0; Index < pParsedNfit->InterleaveTblesNum; Index++) {
+    AcpiIndexInsert(&pParsedNfit->InterleaveTblesIndex,
+        pParsedNfit->ppInterleaveTbles[Index]->InterleaveStructureIndex, Index, FALSE);
+  }
+  for (Index = 0; Index < pParsedNfit->ControlRegionTblesNum; Index++) {
+    AcpiIndexInsert(&pParsedNfit->ControlRegionTblesIndex,
+        pParsedNfit->ppControlRegionTbles[Index]->ControlRegionDescriptorTableIndex, Index, FALSE);
+  }
+  for (Index = 0; Index < pParsedNfit->BWRegionTblesNum; Index++) {
+    AcpiIndexInsert(&pParsedNfit->BWRegionTblesIndex,
+        pParsedNfit->ppBWRegionTbles[Index]->ControlRegionStructureIndex, Index, FALSE);
+  }
+  for (Index = 0; Index < pParsedNfit->FlushHintTblesNum; Index++) {
+    AcpiIndexInsert(&pParsedNfit->FlushHintTblesIndex,
+        pParsedNfit->ppFlushHintTbles[Index]->DeviceHandle.AsUint32, Index, TRUE);
+  }
+
+  // Walk backwards so each physical ID ends up pointing at its first Region table
+  for (Index = pParsedNfit->NvDimmRegionMappingStructuresNum; Index > 0; Index--) {
+    Pid = pParsedNfit->ppNvDimmRegionMappingStructures[Index - 1]->NvDimmPhysicalId;
+    pParsedNfit->pNvDimmRegionMappingStructuresNext[Index - 1] =
+        AcpiIndexFind(&pParsedNfit->NvDimmRegionMappingStructuresIndex, Pid);
+    AcpiIndexInsert(&pParsedNfit->NvDimmRegionMappingStructuresIndex, Pid, Index - 1, TRUE);
+  }
+}
+
+/**
+  ParseNfitTable - Performs deserialization from binary memory block into parsed structure of pointers.
+
+  The table is walked twice: the first walk counts the sub-tables, the second
+  one copies them into a single allocation holding the parsed header, the
+  pointer arrays and the sub-tables.
+
+  @param[in] pTable pointer to the memory containing the NFIT binary representation.
+  @param[out] ppParsedNfit Pointer to a pointer where the allocated and parsed NFIT table will be stored
 
   @retval EFI_INVALID_PARAMETER One of the provided parameters is invalid
   @retval EFI_VOLUME_CORRUPTED If the table checksum is invalid
@@ -193,126 +472,275 @@ Finish:
   @retval EFI_SUCCESS
 **/
 EFI_STATUS
-ParsePcatTable (
+ParseNfitTable(
   IN     VOID *pTable,
-     OUT ParsedPcatHeader **ppParsedPcat
+     OUT ParsedFitHeader **ppParsedNfit
   )
 {
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
-  ParsedPcatHeader *pParsedPcat = NULL;                 //!< Output Parsed PCAT structures
-  PLATFORM_CONFIG_ATTRIBUTES_TABLE *pPcatHeader = NULL; //!< PCAT header
-  PCAT_TABLE_HEADER *pPcatSubTableHeader = NULL;        //!< PCAT subtable header
-  UINT32 RemainingPcatBytes = 0;
-  UINT32 Length = 0;
+  ParsedFitHeader *pParsedNfit = NULL;
+  ParsedFitHeader Counts;
+  ACPI_PARSE_ARENA Arena;
+  NFitHeader *pNFit = NULL;
+  VOID *pArenaBase = NULL;
 
   NVDIMM_ENTRY();
 
+  ZeroMem(&Counts, sizeof(Counts));
+  ZeroMem(&Arena, sizeof(Arena));
+
   CHECK_NULL_ARG(pTable, Finish);
-  CHECK_NULL_ARG(ppParsedPcat, Finish);
+  CHECK_NULL_ARG(ppParsedNfit, Finish);
 
-  pPcatHeader = (PLATFORM_CONFIG_ATTRIBUTES_TABLE *) pTable;
+  pNFit = (NFitHeader *)pTable;
 
-  if (!IsChecksumValid(pPcatHeader, pPcatHeader->Header.Length)) {
-    NVDIMM_DBG("The checksum of PCAT table is invalid.");
+  if (!IsChecksumValid(pNFit, pNFit->Header.Length)) {
+    NVDIMM_DBG("The checksum of the NFIT table is invalid.");
     ReturnCode = EFI_VOLUME_CORRUPTED;
     goto Finish;
   }
 
-  if (IS_PCAT_REVISION_INVALID(pPcatHeader->Header.Revision)) {
-    NVDIMM_DBG("PCAT table revision is invalid");
+  if (IS_NFIT_REVISION_INVALID(pNFit->Header.Revision)) {
+    NVDIMM_DBG("NFIT table revision is invalid");
     ReturnCode = EFI_INCOMPATIBLE_VERSION;
     goto Finish;
   }
 
-  pPcatSubTableHeader = (PCAT_TABLE_HEADER *) &pPcatHeader->pPcatTables;
+  // Size the arena
+  ArenaAlloc(&Arena, sizeof(*pParsedNfit));
+  ArenaAlloc(&Arena, sizeof(*(pParsedNfit->pFit)));
+  CHECK_RESULT(WalkNfitSubTables(pNFit, &Counts, &Arena), Finish);
+  AllocNfitPointerArrays(&Counts, &Counts, &Arena);
+  AllocNfitIndexes(&Counts, &Counts, &Arena);
 
-  RemainingPcatBytes = pPcatHeader->Header.Length - sizeof(*pPcatHeader);
+  // The parsed header is the first block, freeing it frees the whole arena
+  CHECK_RESULT_MALLOC(pArenaBase, AllocateZeroPool(Arena.Size), Finish);
+  Arena.pCursor = (UINT8 *)pArenaBase;
+  Arena.pBound = Arena.pCursor + Arena.Size;
 
-  CHECK_RESULT_MALLOC(*ppParsedPcat, (ParsedPcatHeader *)AllocateZeroPool(sizeof(*pParsedPcat)), Finish);
-  pParsedPcat = *ppParsedPcat;
+  *ppParsedNfit = (ParsedFitHeader *)ArenaAlloc(&Arena, sizeof(*pParsedNfit));
+  pParsedNfit = *ppParsedNfit;
+  pParsedNfit->pFit = (NFitHeader *)ArenaAlloc(&Arena, sizeof(*(pParsedNfit->pFit)));
+  CopyMem_S(pParsedNfit->pFit, sizeof(*(pParsedNfit->pFit)), pNFit, sizeof(*(pParsedNfit->pFit)));
+  AllocNfitPointerArrays(pParsedNfit, &Counts, &Arena);
+  AllocNfitIndexes(pParsedNfit, &Counts, &Arena);
 
-  CHECK_RESULT_MALLOC(pParsedPcat->pPlatformConfigAttr, (PLATFORM_CONFIG_ATTRIBUTES_TABLE *)AllocateZeroPool(
-      sizeof(*pParsedPcat->pPlatformConfigAttr)), Finish);
+  CHECK_RESULT(WalkNfitSubTables(pNFit, pParsedNfit, &Arena), Finish);
+  BuildNfitIndexes(pParsedNfit);
 
-  // Copying PCAT header to parsed structure
-  CopyMem_S(pParsedPcat->pPlatformConfigAttr, sizeof(*pParsedPcat->pPlatformConfigAttr), pPcatHeader, sizeof(*pParsedPcat->pPlatformConfigAttr));
+  ReturnCode = EFI_SUCCESS;
+
+Finish:
+  if (EFI_ERROR(ReturnCode) && ppParsedNfit != NULL && *ppParsedNfit != NULL) {
+    FreeParsedNfit(ppParsedNfit);
+  }
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Walk the PCAT sub-tables and add them to the parsed PCAT
+
+  @param[in] pPcatHeader pointer to the PCAT binary representation
+  @param[in, out] pParsedPcat parsed PCAT, counts only while sizing the arena
+  @param[in, out] pArena arena the sub-tables are copied to
+
+  @retval EFI_INVALID_PARAMETER A sub-table has an invalid length or unknown type
+  @retval EFI_OUT_OF_RESOURCES The arena does not match the sizing walk
+  @retval EFI_SUCCESS
+**/
+STATIC
+EFI_STATUS
+WalkPcatSubTables(
+  IN     PLATFORM_CONFIG_ATTRIBUTES_TABLE *pPcatHeader,
+  IN OUT ParsedPcatHeader *pParsedPcat,
+  IN OUT ACPI_PARSE_ARENA *pArena
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  PCAT_TABLE_HEADER *pPcatSubTableHeader = NULL;        //!< PCAT subtable header
+  PLATFORM_CAPABILITY_INFO3 *pPlatformCapabilityInfo3 = NULL;
+  UINT32 RemainingPcatBytes = 0;
+  UINT32 Length = 0;
+
+  pPcatSubTableHeader = (PCAT_TABLE_HEADER *) &pPcatHeader->pPcatTables;
+
+  RemainingPcatBytes = pPcatHeader->Header.Length - sizeof(*pPcatHeader);
 
   // Looking for sub tables
   while (RemainingPcatBytes > 0) {
     Length = pPcatSubTableHeader->Length;
 
-    if (Length == 0) {
-      NVDIMM_DBG("Length can't be 0.");
-      goto Finish;
+    if (Length == 0 || Length > RemainingPcatBytes) {
+      NVDIMM_DBG("Invalid PCAT sub-table length.");
+      return EFI_INVALID_PARAMETER;
     }
 
     switch(pPcatSubTableHeader->Type) {
     case PCAT_TYPE_PLATFORM_CAPABILITY_INFO_TABLE:
       if (IS_ACPI_HEADER_REV_MAJ_0_MIN_VALID(pPcatHeader)) {
-        CHECK_RESULT_MALLOC(pParsedPcat->pPcatVersion.Pcat2Tables.ppPlatformCapabilityInfo, (PLATFORM_CAPABILITY_INFO **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPcat->pPcatVersion.Pcat2Tables.ppPlatformCapabilityInfo, pPcatSubTableHeader, Length,
-          &pParsedPcat->PlatformCapabilityInfoNum), Finish);
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPcat->pPcatVersion.Pcat2Tables.ppPlatformCapabilityInfo,
+          &pParsedPcat->PlatformCapabilityInfoNum, pPcatSubTableHeader, Length, NULL);
       }
       else if (IS_ACPI_HEADER_REV_MAJ_1_MIN_VALID(pPcatHeader)) {
-        CHECK_RESULT_MALLOC(pParsedPcat->pPcatVersion.Pcat3Tables.ppPlatformCapabilityInfo, (PLATFORM_CAPABILITY_INFO3 **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPcat->pPcatVersion.Pcat3Tables.ppPlatformCapabilityInfo, pPcatSubTableHeader, Length,
-          &pParsedPcat->PlatformCapabilityInfoNum), Finish);
+        pPlatformCapabilityInfo3 = NULL;
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPcat->pPcatVersion.Pcat3Tables.ppPlatformCapabilityInfo,
+          &pParsedPcat->PlatformCapabilityInfoNum, pPcatSubTableHeader, Length, (VOID **)&pPlatformCapabilityInfo3);
 
-        if (IS_ACPI_HEADER_REV_MAJ_1_MIN_1_OR_2(pPcatHeader)) {
+        if (pPlatformCapabilityInfo3 != NULL && IS_ACPI_HEADER_REV_MAJ_1_MIN_1_OR_2(pPcatHeader)) {
           // Backwards compatability. Platforms with PCAT revison < 1.3 always support mixed mode
-          pParsedPcat->pPcatVersion.Pcat3Tables.ppPlatformCapabilityInfo[pParsedPcat->PlatformCapabilityInfoNum - 1]->
-            MemoryModeCapabilities.MemoryModesFlags.MixedMode = MIXED_MODE_CAPABILITY_SUPPORTED;
+          pPlatformCapabilityInfo3->MemoryModeCapabilities.MemoryModesFlags.MixedMode = MIXED_MODE_CAPABILITY_SUPPORTED;
         }
       }
       break;
 
     case PCAT_TYPE_INTERLEAVE_CAPABILITY_INFO_TABLE:
       if (IS_ACPI_HEADER_REV_MAJ_0_MIN_VALID(pPcatHeader)) {
-        CHECK_RESULT_MALLOC(pParsedPcat->pPcatVersion.Pcat2Tables.ppMemoryInterleaveCapabilityInfo, (MEMORY_INTERLEAVE_CAPABILITY_INFO **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPcat->pPcatVersion.Pcat2Tables.ppMemoryInterleaveCapabilityInfo, pPcatSubTableHeader, Length,
-          &pParsedPcat->MemoryInterleaveCapabilityInfoNum), Finish);
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPcat->pPcatVersion.Pcat2Tables.ppMemoryInterleaveCapabilityInfo,
+          &pParsedPcat->MemoryInterleaveCapabilityInfoNum, pPcatSubTableHeader, Length, NULL);
       }
       else if (IS_ACPI_HEADER_REV_MAJ_1_MIN_VALID(pPcatHeader)) {
-        CHECK_RESULT_MALLOC(pParsedPcat->pPcatVersion.Pcat3Tables.ppMemoryInterleaveCapabilityInfo, (MEMORY_INTERLEAVE_CAPABILITY_INFO3 **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPcat->pPcatVersion.Pcat3Tables.ppMemoryInterleaveCapabilityInfo, pPcatSubTableHeader, Length,
-          &pParsedPcat->MemoryInterleaveCapabilityInfoNum), Finish);
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPcat->pPcatVersion.Pcat3Tables.ppMemoryInterleaveCapabilityInfo,
+          &pParsedPcat->MemoryInterleaveCapabilityInfoNum, pPcatSubTableHeader, Length, NULL);
       }
       break;
 
     case PCAT_TYPE_RUNTIME_INTERFACE_TABLE:
-      CHECK_RESULT_MALLOC(pParsedPcat->ppRuntimeInterfaceValConfInput, (RECONFIGURATION_INPUT_VALIDATION_INTERFACE_TABLE **) CopyMemoryAndAddPointerToArray(
-          (VOID **) pParsedPcat->ppRuntimeInterfaceValConfInput, pPcatSubTableHeader, Length,
-          &pParsedPcat->RuntimeInterfaceValConfInputNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPcat->ppRuntimeInterfaceValConfInput,
+          &pParsedPcat->RuntimeInterfaceValConfInputNum, pPcatSubTableHeader, Length, NULL);
       break;
 
     case PCAT_TYPE_CONFIG_MANAGEMENT_ATTRIBUTES_TABLE:
-      CHECK_RESULT_MALLOC(pParsedPcat->ppConfigManagementAttributesInfo, (CONFIG_MANAGEMENT_ATTRIBUTES_EXTENSION_TABLE **) CopyMemoryAndAddPointerToArray(
-          (VOID **) pParsedPcat->ppConfigManagementAttributesInfo, pPcatSubTableHeader, Length,
-          &pParsedPcat->ConfigManagementAttributesInfoNum), Finish);
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPcat->ppConfigManagementAttributesInfo,
+          &pParsedPcat->ConfigManagementAttributesInfoNum, pPcatSubTableHeader, Length, NULL);
       break;
 
     case PCAT_TYPE_SOCKET_SKU_INFO_TABLE:
       if (IS_ACPI_HEADER_REV_MAJ_0_MIN_VALID(pPcatHeader)) {
-        CHECK_RESULT_MALLOC(pParsedPcat->pPcatVersion.Pcat2Tables.ppSocketSkuInfoTable, (SOCKET_SKU_INFO_TABLE **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPcat->pPcatVersion.Pcat2Tables.ppSocketSkuInfoTable, pPcatSubTableHeader, Length,
-          &pParsedPcat->SocketSkuInfoNum), Finish);
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPcat->pPcatVersion.Pcat2Tables.ppSocketSkuInfoTable,
+          &pParsedPcat->SocketSkuInfoNum, pPcatSubTableHeader, Length, NULL);
       }
       else if (IS_ACPI_HEADER_REV_MAJ_1_MIN_VALID(pPcatHeader)) {
-        CHECK_RESULT_MALLOC(pParsedPcat->pPcatVersion.Pcat3Tables.ppDieSkuInfoTable, (DIE_SKU_INFO_TABLE **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPcat->pPcatVersion.Pcat3Tables.ppDieSkuInfoTable, pPcatSubTableHeader, Length,
-          &pParsedPcat->SocketSkuInfoNum), Finish);
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPcat->pPcatVersion.Pcat3Tables.ppDieSkuInfoTable,
+          &pParsedPcat->SocketSkuInfoNum, pPcatSubTableHeader, Length, NULL);
       }
       break;
 
     default:
       NVDIMM_WARN("Unknown type of PCAT table.");
-      goto Finish;
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if (EFI_ERROR(ReturnCode)) {
+      return ReturnCode;
     }
 
     RemainingPcatBytes -= Length;
     pPcatSubTableHeader = (PCAT_TABLE_HEADER *) ((UINT8 *)pPcatSubTableHeader + Length);
   }
 
+  return EFI_SUCCESS;
+}
+
+/**
+  Reserve the arrays of sub-table pointers of the parsed PCAT
+
+  The revision 2 and 3 arrays share storage in the PCAT_VERSION union.
+
+  @param[out] pParsedPcat parsed PCAT the arrays are assigned to
+  @param[in] pCounts parsed PCAT holding the counts from the sizing walk
+  @param[in, out] pArena arena the arrays are reserved from
+**/
+STATIC
+VOID
+AllocPcatPointerArrays(
+     OUT ParsedPcatHeader *pParsedPcat,
+  IN     ParsedPcatHeader *pCounts,
+  IN OUT ACPI_PARSE_ARENA *pArena
+  )
+{
+  pParsedPcat->pPcatVersion.Pcat3Tables.ppPlatformCapabilityInfo = (PLATFORM_CAPABILITY_INFO3 **)ArenaAllocPointerArray(
+      pArena, pCounts->PlatformCapabilityInfoNum);
+  pParsedPcat->pPcatVersion.Pcat3Tables.ppMemoryInterleaveCapabilityInfo = (MEMORY_INTERLEAVE_CAPABILITY_INFO3 **)ArenaAllocPointerArray(
+      pArena, pCounts->MemoryInterleaveCapabilityInfoNum);
+  pParsedPcat->pPcatVersion.Pcat3Tables.ppDieSkuInfoTable = (DIE_SKU_INFO_TABLE **)ArenaAllocPointerArray(
+      pArena, pCounts->SocketSkuInfoNum);
+  pParsedPcat->ppRuntimeInterfaceValConfInput = (RECONFIGURATION_INPUT_VALIDATION_INTERFACE_TABLE **)ArenaAllocPointerArray(
+      pArena, pCounts->RuntimeInterfaceValConfInputNum);
+  pParsedPcat->ppConfigManagementAttributesInfo = (CONFIG_MANAGEMENT_ATTRIBUTES_EXTENSION_TABLE **)ArenaAllocPointerArray(
+      pArena, pCounts->ConfigManagementAttributesInfoNum);
+}
+
+/**
+  Performs deserialization from binary memory block, containing PCAT tables, into parsed structure of pointers.
+
+  The parsed header, pointer arrays and sub-tables share a single allocation.
+
+  @param[in] pTable pointer to the memory containing the PCAT binary representation.
+  @param[out] ppParsedPcat Pointer to a pointer where the allocated and parsed PCAT table will be stored
+
+  @retval EFI_INVALID_PARAMETER One of the provided parameters is invalid
+  @retval EFI_VOLUME_CORRUPTED If the table checksum is invalid
+  @retval EFI_INCOMPATIBLE_VERSION If the table is not compatible with this ipmctl version
+  @retval EFI_SUCCESS
+**/
+EFI_STATUS
+ParsePcatTable (
+  IN     VOID *pTable,
+     OUT ParsedPcatHeader **ppParsedPcat
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  ParsedPcatHeader *pParsedPcat = NULL;                 //!< Output Parsed PCAT structures
+  ParsedPcatHeader Counts;
+  ACPI_PARSE_ARENA Arena;
+  PLATFORM_CONFIG_ATTRIBUTES_TABLE *pPcatHeader = NULL; //!< PCAT header
+  VOID *pArenaBase = NULL;
+
+  NVDIMM_ENTRY();
+
+  ZeroMem(&Counts, sizeof(Counts));
+  ZeroMem(&Arena, sizeof(Arena));
+
+  CHECK_NULL_ARG(pTable, Finish);
+  CHECK_NULL_ARG(ppParsedPcat, Finish);
+
+  pPcatHeader = (PLATFORM_CONFIG_ATTRIBUTES_TABLE *) pTable;
+
+  if (!IsChecksumValid(pPcatHeader, pPcatHeader->Header.Length)) {
+    NVDIMM_DBG("The checksum of PCAT table is invalid.");
+    ReturnCode = EFI_VOLUME_CORRUPTED;
+    goto Finish;
+  }
+
+  if (IS_PCAT_REVISION_INVALID(pPcatHeader->Header.Revision)) {
+    NVDIMM_DBG("PCAT table revision is invalid");
+    ReturnCode = EFI_INCOMPATIBLE_VERSION;
+    goto Finish;
+  }
+
+  // Size the arena
+  ArenaAlloc(&Arena, sizeof(*pParsedPcat));
+  ArenaAlloc(&Arena, sizeof(*pParsedPcat->pPlatformConfigAttr));
+  CHECK_RESULT(WalkPcatSubTables(pPcatHeader, &Counts, &Arena), Finish);
+  AllocPcatPointerArrays(&Counts, &Counts, &Arena);
+
+  // The parsed header is the first block, freeing it frees the whole arena
+  CHECK_RESULT_MALLOC(pArenaBase, AllocateZeroPool(Arena.Size), Finish);
+  Arena.pCursor = (UINT8 *)pArenaBase;
+  Arena.pBound = Arena.pCursor + Arena.Size;
+
+  *ppParsedPcat = (ParsedPcatHeader *)ArenaAlloc(&Arena, sizeof(*pParsedPcat));
+  pParsedPcat = *ppParsedPcat;
+  pParsedPcat->pPlatformConfigAttr = (PLATFORM_CONFIG_ATTRIBUTES_TABLE *)ArenaAlloc(&Arena,
+      sizeof(*pParsedPcat->pPlatformConfigAttr));
+
+  // Copying PCAT header to parsed structure
+  CopyMem_S(pParsedPcat->pPlatformConfigAttr, sizeof(*pParsedPcat->pPlatformConfigAttr), pPcatHeader, sizeof(*pParsedPcat->pPlatformConfigAttr));
+  AllocPcatPointerArrays(pParsedPcat, &Counts, &Arena);
+
+  CHECK_RESULT(WalkPcatSubTables(pPcatHeader, pParsedPcat, &Arena), Finish);
+
   ReturnCode = EFI_SUCCESS;
 
 Finish:
@@ -324,9 +752,183 @@ Finish:
   return ReturnCode;
 }
 
+/**
+  Walk the PMTT 0.2 devices and add them to the parsed PMTT
+
+  @param[in] pPmttHeader pointer to the PMTT binary representation
+  @param[in, out] pParsedPmtt parsed PMTT, counts only while sizing the arena
+  @param[in, out] pArena arena the devices are copied to
+
+  @retval EFI_INVALID_PARAMETER A device has an invalid length or unknown type
+  @retval EFI_OUT_OF_RESOURCES The arena does not match the sizing walk
+  @retval EFI_SUCCESS
+**/
+STATIC
+EFI_STATUS
+WalkPmttDevices(
+  IN     PMTT_TABLE2 *pPmttHeader,
+  IN OUT ParsedPmttHeader *pParsedPmtt,
+  IN OUT ACPI_PARSE_ARENA *pArena
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  PMTT_COMMON_HEADER2 *pPmttCommonTableHeader = NULL;        //!< PMTT common header
+  PMTT_MODULE_INFO ModuleInfo;
+  UINT32 RemainingPmttBytes = 0;
+  UINT32 Length = 0;
+  UINT16 SocketID = 0;
+  UINT16 DieID = 0;
+  UINT16 CpuID = 0;
+  UINT16 iMCID = 0;
+  UINT16 ChannelID = 0;
+  UINT16 SlotID = 0;
+  UINT32 NumOfMemoryDevices = 0;
+  UINT32 DieLevelNumOfMemoryDevices = 0;
+
+  pPmttCommonTableHeader = (PMTT_COMMON_HEADER2 *)&pPmttHeader->pPmttDevices;
+  RemainingPmttBytes = pPmttHeader->Header.Length - sizeof(*pPmttHeader);
+
+  // Looking for sub tables
+  while (RemainingPmttBytes > 0) {
+    Length = pPmttCommonTableHeader->Length;
+    if (Length == 0 || Length > RemainingPmttBytes) {
+      NVDIMM_DBG("Invalid length of PMTT common header.");
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if (!(pPmttCommonTableHeader->Flags & PMTT_PHYSICAL_ELEMENT_OF_TOPOLOGY)) {
+      NVDIMM_DBG("Not a physical element of the topology!");
+      RemainingPmttBytes -= Length;
+      pPmttCommonTableHeader = (PMTT_COMMON_HEADER2 *)((UINT8 *)pPmttCommonTableHeader + Length);
+      continue;
+    }
+
+    switch (pPmttCommonTableHeader->Type) {
+    case PMTT_TYPE_SOCKET:
+    {
+      PMTT_SOCKET2 *pSocket = (PMTT_SOCKET2 *)pPmttCommonTableHeader;
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPmtt->ppSockets,
+        &pParsedPmtt->SocketsNum, pPmttCommonTableHeader, Length, NULL);
+      SocketID = pSocket->SocketId;
+      DieLevelNumOfMemoryDevices += NumOfMemoryDevices;
+      NumOfMemoryDevices = pSocket->Header.NoOfMemoryDevices;
+      DieID = MAX_DIEID_SINGLE_DIE_SOCKET;
+      break;
+    }
+
+    case PMTT_TYPE_VENDOR_SPECIFIC:
+    {
+      PMTT_VENDOR_SPECIFIC2 *pVendorDevice = (PMTT_VENDOR_SPECIFIC2 *)((UINT8 *)pPmttCommonTableHeader);
+      if (CompareMem(&pVendorDevice->TypeUUID, &gDieTypeDeviceGuid, sizeof(pVendorDevice->TypeUUID)) == 0) {
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPmtt->ppDies,
+          &pParsedPmtt->DiesNum, pPmttCommonTableHeader, Length, NULL);
+        DieID = pVendorDevice->DeviceID;
+        CpuID = (DieLevelNumOfMemoryDevices & MAX_UINT16) + DieID;
+      }
+      else if (CompareMem(&pVendorDevice->TypeUUID, &gChannelTypeDeviceGuid, sizeof(pVendorDevice->TypeUUID)) == 0) {
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPmtt->ppChannels,
+          &pParsedPmtt->ChannelsNum, pPmttCommonTableHeader, Length, NULL);
+        ChannelID = pVendorDevice->DeviceID;
+        SlotID = 0;
+      }
+      else if (CompareMem(&pVendorDevice->TypeUUID, &gSlotTypeDeviceGuid, sizeof(pVendorDevice->TypeUUID)) == 0) {
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPmtt->ppSlots,
+          &pParsedPmtt->SlotsNum, pPmttCommonTableHeader, Length, NULL);
+        SlotID = pVendorDevice->DeviceID;
+      }
+      else {
+        NVDIMM_DBG("Unknown PMTT Vendor Specific Data");
+      }
+      break;
+    }
+
+    case PMTT_TYPE_iMC:
+      ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPmtt->ppiMCs,
+        &pParsedPmtt->iMCsNum, pPmttCommonTableHeader, Length, NULL);
+      iMCID = ((PMTT_iMC2 *)pPmttCommonTableHeader)->MemControllerID;
+      ChannelID = 0;
+      break;
+
+    case PMTT_TYPE_MODULE:
+    {
+      PMTT_MODULE2 *pModule = (PMTT_MODULE2 *)pPmttCommonTableHeader;
+
+      // skip if Bits [3:2] are reserved
+      if ((pPmttCommonTableHeader->Flags & PMTT_TYPE_RESERVED) == PMTT_TYPE_RESERVED) {
+        NVDIMM_DBG("Reserved. No indication in PMTT if this module is volatile or non-volatile memory!");
+        break;
+      }
+
+      ZeroMem(&ModuleInfo, sizeof(ModuleInfo));
+      ModuleInfo.Header = pModule->Header;
+      ModuleInfo.SmbiosHandle = pModule->SmbiosHandle & SMBIOS_HANDLE_MASK;
+      ModuleInfo.SocketId = SocketID;
+      ModuleInfo.DieId = DieID;
+      ModuleInfo.CpuId = CpuID;
+      ModuleInfo.MemControllerId = iMCID;
+      ModuleInfo.ChannelId = ChannelID;
+      ModuleInfo.SlotId = SlotID;
+
+      // BIT 2 is set then DCPMM or else DDR type
+      if (pPmttCommonTableHeader->Flags & PMTT_DDR_DCPM_FLAG) {
+        ModuleInfo.MemoryType = MEMORYTYPE_DCPM;
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPmtt->ppDCPMModules,
+          &pParsedPmtt->DCPMModulesNum, &ModuleInfo, sizeof(ModuleInfo), NULL);
+      }
+      else {
+        ModuleInfo.MemoryType = MEMORYTYPE_DDR4;
+        ReturnCode = ArenaAddSubTable(pArena, (VOID **)pParsedPmtt->ppDDRModules,
+          &pParsedPmtt->DDRModulesNum, &ModuleInfo, sizeof(ModuleInfo), NULL);
+      }
+      break;
+    }
+
+    default:
+      NVDIMM_WARN("Unknown type of PMTT table.");
+      return EFI_INVALID_PARAMETER;
+    }
+
+    if (EFI_ERROR(ReturnCode)) {
+      return ReturnCode;
+    }
+
+    RemainingPmttBytes -= Length;
+    pPmttCommonTableHeader = (PMTT_COMMON_HEADER2 *)((UINT8 *)pPmttCommonTableHeader + Length);
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Reserve the arrays of device pointers and the lookup index of the parsed PMTT
+
+  @param[out] pParsedPmtt parsed PMTT the arrays are assigned to
+  @param[in] pCounts parsed PMTT holding the counts from the sizing walk
+  @param[in, out] pArena arena the arrays are reserved from
+**/
+STATIC
+VOID
+AllocPmttPointerArrays(
+     OUT ParsedPmttHeader *pParsedPmtt,
+  IN     ParsedPmttHeader *pCounts,
+  IN OUT ACPI_PARSE_ARENA *pArena
+  )
+{
+  pParsedPmtt->ppSockets = (PMTT_SOCKET2 **)ArenaAllocPointerArray(pArena, pCounts->SocketsNum);
+  pParsedPmtt->ppDies = (PMTT_VENDOR_SPECIFIC2 **)ArenaAllocPointerArray(pArena, pCounts->DiesNum);
+  pParsedPmtt->ppiMCs = (PMTT_iMC2 **)ArenaAllocPointerArray(pArena, pCounts->iMCsNum);
+  pParsedPmtt->ppChannels = (PMTT_VENDOR_SPECIFIC2 **)ArenaAllocPointerArray(pArena, pCounts->ChannelsNum);
+  pParsedPmtt->ppSlots = (PMTT_VENDOR_SPECIFIC2 **)ArenaAllocPointerArray(pArena, pCounts->SlotsNum);
+  pParsedPmtt->ppDDRModules = (PMTT_MODULE_INFO **)ArenaAllocPointerArray(pArena, pCounts->DDRModulesNum);
+  pParsedPmtt->ppDCPMModules = (PMTT_MODULE_INFO **)ArenaAllocPointerArray(pArena, pCounts->DCPMModulesNum);
+  ArenaAllocIndex(pArena, &pParsedPmtt->DCPMModulesIndex, pCounts->DCPMModulesNum);
+}
+
 /**
   Performs deserialization from binary memory block, containing PMTT tables, into parsed structure of pointers.
 
+  The parsed header, pointer arrays and devices share a single allocation.
+
   @param[in] pTable pointer to the memory containing the PMTT binary representation.
   @param[out] ppParsedPmtt Pointer to a pointer where the allocated and parsed PMTT table will be stored
 
@@ -343,22 +945,17 @@ ParsePmttTable(
 {
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
   ParsedPmttHeader *pParsedPmtt = NULL;                 //!< Output Parsed PMTT structures
+  ParsedPmttHeader Counts;
+  ACPI_PARSE_ARENA Arena;
   PMTT_TABLE2 *pPmttHeader = NULL; //!< PMTT header
-  PMTT_COMMON_HEADER2 *pPmttCommonTableHeader = NULL;        //!< PMTT common header
-  PMTT_MODULE_INFO *pModuleInfo = NULL;
-  UINT32 RemainingPmttBytes = 0;
-  UINT32 Length = 0;
-  UINT16 SocketID = 0;
-  UINT16 DieID = 0;
-  UINT16 CpuID = 0;
-  UINT16 iMCID = 0;
-  UINT16 ChannelID = 0;
-  UINT16 SlotID = 0;
-  UINT32 NumOfMemoryDevices = 0;
-  UINT32 DieLevelNumOfMemoryDevices = 0;
+  VOID *pArenaBase = NULL;
+  UINT32 Index = 0;
 
   NVDIMM_ENTRY();
 
+  ZeroMem(&Counts, sizeof(Counts));
+  ZeroMem(&Arena, sizeof(Arena));
+
   CHECK_NULL_ARG(pTable, Finish);
   CHECK_NULL_ARG(ppParsedPmtt, Finish);
   // Prepare for error scenario first
@@ -390,135 +987,32 @@ ParsePmttTable(
 
   // PMTT == 0.2
 
-  pPmttCommonTableHeader = (PMTT_COMMON_HEADER2 *)&pPmttHeader->pPmttDevices;
-  RemainingPmttBytes = pPmttHeader->Header.Length - sizeof(*pPmttHeader);
+  // Size the arena
+  ArenaAlloc(&Arena, sizeof(*pParsedPmtt));
+  ArenaAlloc(&Arena, sizeof(*pParsedPmtt->pPmtt));
+  CHECK_RESULT(WalkPmttDevices(pPmttHeader, &Counts, &Arena), Finish);
+  AllocPmttPointerArrays(&Counts, &Counts, &Arena);
 
-  CHECK_RESULT_MALLOC(*ppParsedPmtt, (ParsedPmttHeader *)AllocateZeroPool(sizeof(*pParsedPmtt)), Finish);
-  pParsedPmtt = *ppParsedPmtt;
+  // The parsed header is the first block, freeing it frees the whole arena
+  CHECK_RESULT_MALLOC(pArenaBase, AllocateZeroPool(Arena.Size), Finish);
+  Arena.pCursor = (UINT8 *)pArenaBase;
+  Arena.pBound = Arena.pCursor + Arena.Size;
 
-  CHECK_RESULT_MALLOC(pParsedPmtt->pPmtt, (PMTT_TABLE2 *)AllocateZeroPool(sizeof(*pParsedPmtt->pPmtt)), Finish);
+  *ppParsedPmtt = (ParsedPmttHeader *)ArenaAlloc(&Arena, sizeof(*pParsedPmtt));
+  pParsedPmtt = *ppParsedPmtt;
+  pParsedPmtt->pPmtt = (PMTT_TABLE2 *)ArenaAlloc(&Arena, sizeof(*pParsedPmtt->pPmtt));
 
   // Copying PMTT header to parsed structure
   CopyMem_S(pParsedPmtt->pPmtt, sizeof(*pParsedPmtt->pPmtt), pPmttHeader, sizeof(*pParsedPmtt->pPmtt));
+  AllocPmttPointerArrays(pParsedPmtt, &Counts, &Arena);
 
-  // Looking for sub tables
-  while (RemainingPmttBytes > 0) {
-    Length = pPmttCommonTableHeader->Length;
-    if (Length == 0) {
-      NVDIMM_DBG("Length of PMTT common header is zero.");
-      goto Finish;
-    }
-
-    if (!(pPmttCommonTableHeader->Flags & PMTT_PHYSICAL_ELEMENT_OF_TOPOLOGY)) {
-      NVDIMM_DBG("Not a physical element of the topology!");
-      RemainingPmttBytes -= Length;
-      pPmttCommonTableHeader = (PMTT_COMMON_HEADER2 *)((UINT8 *)pPmttCommonTableHeader + Length);
-      continue;
-    }
-
-    switch (pPmttCommonTableHeader->Type) {
-    case PMTT_TYPE_SOCKET:
-    {
-      CHECK_RESULT_MALLOC(pParsedPmtt->ppSockets, (PMTT_SOCKET2 **)CopyMemoryAndAddPointerToArray(
-        (VOID **)pParsedPmtt->ppSockets, pPmttCommonTableHeader, Length,
-        &pParsedPmtt->SocketsNum), Finish);
-      SocketID = pParsedPmtt->ppSockets[pParsedPmtt->SocketsNum - 1]->SocketId;
-      DieLevelNumOfMemoryDevices += NumOfMemoryDevices;
-      NumOfMemoryDevices = pParsedPmtt->ppSockets[pParsedPmtt->SocketsNum - 1]->Header.NoOfMemoryDevices;
-      DieID = MAX_DIEID_SINGLE_DIE_SOCKET;
-      break;
-    }
-
-    case PMTT_TYPE_VENDOR_SPECIFIC:
-    {
-      PMTT_VENDOR_SPECIFIC2 *pVendorDevice = (PMTT_VENDOR_SPECIFIC2 *)((UINT8 *)pPmttCommonTableHeader);
-      if (CompareMem(&pVendorDevice->TypeUUID, &gDieTypeDeviceGuid, sizeof(pVendorDevice->TypeUUID)) == 0) {
-        CHECK_RESULT_MALLOC(pParsedPmtt->ppDies, (PMTT_VENDOR_SPECIFIC2 **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPmtt->ppDies, pPmttCommonTableHeader, Length,
-          &pParsedPmtt->DiesNum), Finish);
-        DieID = pParsedPmtt->ppDies[pParsedPmtt->DiesNum - 1]->DeviceID;
-        CpuID = (DieLevelNumOfMemoryDevices & MAX_UINT16) + DieID;
-      }
-      else if (CompareMem(&pVendorDevice->TypeUUID, &gChannelTypeDeviceGuid, sizeof(pVendorDevice->TypeUUID)) == 0) {
-        CHECK_RESULT_MALLOC(pParsedPmtt->ppChannels, (PMTT_VENDOR_SPECIFIC2 **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPmtt->ppChannels, pPmttCommonTableHeader, Length,
-          &pParsedPmtt->ChannelsNum), Finish);
-        ChannelID = pParsedPmtt->ppChannels[pParsedPmtt->ChannelsNum - 1]->DeviceID;
-        SlotID = 0;
-      }
-      else if (CompareMem(&pVendorDevice->TypeUUID, &gSlotTypeDeviceGuid, sizeof(pVendorDevice->TypeUUID)) == 0) {
-        CHECK_RESULT_MALLOC(pParsedPmtt->ppSlots, (PMTT_VENDOR_SPECIFIC2 **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPmtt->ppSlots, pPmttCommonTableHeader, Length,
-          &pParsedPmtt->SlotsNum), Finish);
-        SlotID = pParsedPmtt->ppSlots[pParsedPmtt->SlotsNum - 1]->DeviceID;
-      }
-      else {
-        NVDIMM_DBG("Unknown PMTT Vendor Specific Data");
-        continue;
-      }
-      break;
-    }
-
-    case PMTT_TYPE_iMC:
-      CHECK_RESULT_MALLOC(pParsedPmtt->ppiMCs, (PMTT_iMC2 **)CopyMemoryAndAddPointerToArray(
-        (VOID **)pParsedPmtt->ppiMCs, pPmttCommonTableHeader, Length,
-        &pParsedPmtt->iMCsNum), Finish);
-      iMCID = pParsedPmtt->ppiMCs[pParsedPmtt->iMCsNum - 1]->MemControllerID;
-      ChannelID = 0;
-      break;
-
-    case PMTT_TYPE_MODULE:
-    {
-      PMTT_MODULE2 *pModule = (PMTT_MODULE2 *)pPmttCommonTableHeader;
-
-      // skip if Bits [3:2] are reserved
-      if ((pPmttCommonTableHeader->Flags & PMTT_TYPE_RESERVED) == PMTT_TYPE_RESERVED) {
-        NVDIMM_DBG("Reserved. No indication in PMTT if this module is volatile or non-volatile memory!");
-        break;
-      }
-
-      pModuleInfo = (PMTT_MODULE_INFO *)AllocateZeroPool(sizeof(*pModuleInfo));
-      if (pModuleInfo == NULL) {
-        NVDIMM_DBG("Memory allocation error.");
-        goto Finish;
-      }
-      pModuleInfo->Header = pModule->Header;
-      pModuleInfo->SmbiosHandle = pModule->SmbiosHandle & SMBIOS_HANDLE_MASK;
-      pModuleInfo->SocketId = SocketID;
-      pModuleInfo->DieId = DieID;
-      pModuleInfo->CpuId = CpuID;
-      pModuleInfo->MemControllerId = iMCID;
-      pModuleInfo->ChannelId = ChannelID;
-      pModuleInfo->SlotId = SlotID;
-
-      // BIT 2 is set then DCPMM or else DDR type
-      if (pPmttCommonTableHeader->Flags & PMTT_DDR_DCPM_FLAG) {
-        pModuleInfo->MemoryType = MEMORYTYPE_DCPM;
-        CHECK_RESULT_MALLOC(pParsedPmtt->ppDCPMModules, (PMTT_MODULE_INFO **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPmtt->ppDCPMModules, pModuleInfo, sizeof(*pModuleInfo),
-          &pParsedPmtt->DCPMModulesNum), Finish);
-      }
-      else {
-        pModuleInfo->MemoryType = MEMORYTYPE_DDR4;
-        CHECK_RESULT_MALLOC(pParsedPmtt->ppDDRModules, (PMTT_MODULE_INFO **)CopyMemoryAndAddPointerToArray(
-          (VOID **)pParsedPmtt->ppDDRModules, pModuleInfo, sizeof(*pModuleInfo),
-          &pParsedPmtt->DDRModulesNum), Finish);
-      }
-      FREE_POOL_SAFE(pModuleInfo);
-      break;
-    }
-
-    default:
-      NVDIMM_WARN("Unknown type of PMTT table.");
-      goto Finish;
-    }
-
+  CHECK_RESULT(WalkPmttDevices(pPmttHeader, pParsedPmtt, &Arena), Finish);
 
-    RemainingPmttBytes -= Length;
-    pPmttCommonTableHeader = (PMTT_COMMON_HEADER2 *)((UINT8 *)pPmttCommonTableHeader + Length);
+  // The last module with a handle wins, the same as the linear scan
+  for (Index = 0; Index < pParsedPmtt->DCPMModulesNum; Index++) {
+    AcpiIndexInsert(&pParsedPmtt->DCPMModulesIndex, pParsedPmtt->ppDCPMModules[Index]->SmbiosHandle, Index, TRUE);
   }
 
-
   ReturnCode = EFI_SUCCESS;
 
 Finish:
@@ -546,7 +1040,7 @@ GetDimmModuleByPidFromPmtt(
   IN     ParsedPmttHeader *pPmttHead
   )
 {
-  UINT32 Index = 0;
+  UINT32 Position = 0;
   PMTT_MODULE_INFO *pModuleInfo = NULL;
   NVDIMM_ENTRY();
 
@@ -555,10 +1049,9 @@ GetDimmModuleByPidFromPmtt(
     goto Finish;
   }
 
-  for (Index = 0; Index < pPmttHead->DCPMModulesNum; Index++) {
-    if (pPmttHead->ppDCPMModules[Index]->SmbiosHandle == DimmID) {
-      pModuleInfo = pPmttHead->ppDCPMModules[Index];
-    }
+  Position = AcpiIndexFind(&pPmttHead->DCPMModulesIndex, DimmID);
+  if (Position != 0) {
+    pModuleInfo = pPmttHead->ppDCPMModules[Position - 1];
   }
 
   Finish:
@@ -781,18 +1274,17 @@ GetFlushHintTableForNvDimmRegionTable(
   )
 {
   EFI_STATUS ReturnCode = EFI_NOT_FOUND;
-  UINT32 Index = 0;
+  UINT32 Position = 0;
 
   if (pFitHead == NULL || pNvDimmRegionMappingStructure == NULL || ppFlushHintTable == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     goto Finish;
   }
 
-  for (Index = 0; Index < pFitHead->FlushHintTblesNum; Index++) {
-    if (pNvDimmRegionMappingStructure->DeviceHandle.AsUint32 == pFitHead->ppFlushHintTbles[Index]->DeviceHandle.AsUint32) {
-      *ppFlushHintTable = pFitHead->ppFlushHintTbles[Index];
-      ReturnCode = EFI_SUCCESS;
-    }
+  Position = AcpiIndexFind(&pFitHead->FlushHintTblesIndex, pNvDimmRegionMappingStructure->DeviceHandle.AsUint32);
+  if (Position != 0) {
+    *ppFlushHintTable = pFitHead->ppFlushHintTbles[Position - 1];
+    ReturnCode = EFI_SUCCESS;
   }
 
 Finish:
@@ -818,22 +1310,17 @@ GetBlockDataWindowRegDescTabl(
   )
 {
   EFI_STATUS ReturnCode = EFI_NOT_FOUND;
-  UINT16 Index = 0;
-  UINT16 ControlTableIndex = 0;
+  UINT32 Position = 0;
 
   if (pFitHead == NULL || pControlRegTbl == NULL || ppBlockDataWindowTable == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
     goto Finish;
   }
 
-  ControlTableIndex = pControlRegTbl->ControlRegionDescriptorTableIndex;
-
-  for (Index = 0; Index < pFitHead->BWRegionTblesNum; Index++) {
-    if (pFitHead->ppBWRegionTbles[Index]->ControlRegionStructureIndex == ControlTableIndex) {
-      *ppBlockDataWindowTable = pFitHead->ppBWRegionTbles[Index];
-      ReturnCode = EFI_SUCCESS;
-      break;
-    }
+  Position = AcpiIndexFind(&pFitHead->BWRegionTblesIndex, pControlRegTbl->ControlRegionDescriptorTableIndex);
+  if (Position != 0) {
+    *ppBlockDataWindowTable = pFitHead->ppBWRegionTbles[Position - 1];
+    ReturnCode = EFI_SUCCESS;
   }
 
 Finish:
@@ -859,8 +1346,7 @@ GetControlRegionTableForNvDimmRegionTable(
   )
 {
   EFI_STATUS ReturnCode = EFI_NOT_FOUND;
-  UINT16 Index = 0;
-  UINT16 ControlTableIndex = 0;
+  UINT32 Position = 0;
 
   if (pFitHead == NULL || pNvDimmRegionMappingStructure == NULL || ppControlRegionTable == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
@@ -868,14 +1354,12 @@ GetControlRegionTableForNvDimmRegionTable(
   }
 
   *ppControlRegionTable = NULL;
-  ControlTableIndex = pNvDimmRegionMappingStructure->NvdimmControlRegionDescriptorTableIndex;
 
-  for (Index = 0; Index < pFitHead->ControlRegionTblesNum; Index++) {
-    if (pFitHead->ppControlRegionTbles[Index]->ControlRegionDescriptorTableIndex == ControlTableIndex) {
-      *ppControlRegionTable = pFitHead->ppControlRegionTbles[Index];
-      ReturnCode = EFI_SUCCESS;
-      break;
-    }
+  Position = AcpiIndexFind(&pFitHead->ControlRegionTblesIndex,
+      pNvDimmRegionMappingStructure->NvdimmControlRegionDescriptorTableIndex);
+  if (Position != 0) {
+    *ppControlRegionTable = pFitHead->ppControlRegionTbles[Position - 1];
+    ReturnCode = EFI_SUCCESS;
   }
 
 Finish:
@@ -903,7 +1387,7 @@ GetControlRegionTablesForPID(
   )
 {
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
-  UINT32 Index = 0;
+  UINT32 Position = 0;
   UINT32 Index2 = 0;
   UINT32 CurrentArrayNum = 0;
   ControlRegionTbl *pCtrlTable = NULL;
@@ -915,28 +1399,27 @@ GetControlRegionTablesForPID(
     goto Finish;
   }
 
-  for (Index = 0; Index < pFitHead->NvDimmRegionMappingStructuresNum; Index++) {
-    if (Pid == pFitHead->ppNvDimmRegionMappingStructures[Index]->NvDimmPhysicalId) {
-      ReturnCode = GetControlRegionTableForNvDimmRegionTable(
-          pFitHead, pFitHead->ppNvDimmRegionMappingStructures[Index], &pCtrlTable);
+  for (Position = AcpiIndexFind(&pFitHead->NvDimmRegionMappingStructuresIndex, Pid); Position != 0;
+       Position = pFitHead->pNvDimmRegionMappingStructuresNext[Position - 1]) {
+    ReturnCode = GetControlRegionTableForNvDimmRegionTable(
+        pFitHead, pFitHead->ppNvDimmRegionMappingStructures[Position - 1], &pCtrlTable);
 
-      /** Make sure the found Control Region table is not in the array already. **/
-      ContainedAlready = FALSE;
-      for (Index2 = 0; Index2 < CurrentArrayNum; Index2++) {
-        if (pCtrlTable == pControlRegionTables[Index2]) {
-          ContainedAlready = TRUE;
-        }
+    /** Make sure the found Control Region table is not in the array already. **/
+    ContainedAlready = FALSE;
+    for (Index2 = 0; Index2 < CurrentArrayNum; Index2++) {
+      if (pCtrlTable == pControlRegionTables[Index2]) {
+        ContainedAlready = TRUE;
       }
+    }
 
-      if (!ContainedAlready) {
-        if (CurrentArrayNum >= *pControlRegionTablesNum) {
-          NVDIMM_ERR("There are more Control Region tables than length of the input array.");
-          ReturnCode = EFI_BUFFER_TOO_SMALL;
-          goto Finish;
-        }
-        pControlRegionTables[CurrentArrayNum] = pCtrlTable;
-        CurrentArrayNum++;
+    if (!ContainedAlready) {
+      if (CurrentArrayNum >= *pControlRegionTablesNum) {
+        NVDIMM_ERR("There are more Control Region tables than length of the input array.");
+        ReturnCode = EFI_BUFFER_TOO_SMALL;
+        goto Finish;
       }
+      pControlRegionTables[CurrentArrayNum] = pCtrlTable;
+      CurrentArrayNum++;
     }
   }
 
@@ -967,7 +1450,7 @@ GetSpaRangeTable(
   )
 {
   EFI_STATUS ReturnCode = EFI_NOT_FOUND;
-  UINT16 Index = 0;
+  UINT32 Position = 0;
 
   if (pFitHead == NULL || ppSpaRangeTbl == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
@@ -976,12 +1459,10 @@ GetSpaRangeTable(
 
   *ppSpaRangeTbl = NULL;
 
-  for (Index = 0; Index < pFitHead->SpaRangeTblesNum; Index++) {
-    if (pFitHead->ppSpaRangeTbles[Index]->SpaRangeDescriptionTableIndex == SpaRangeTblIndex) {
-      *ppSpaRangeTbl = pFitHead->ppSpaRangeTbles[Index];
-      ReturnCode = EFI_SUCCESS;
-      break;
-    }
+  Position = AcpiIndexFind(&pFitHead->SpaRangeTblesIndex, SpaRangeTblIndex);
+  if (Position != 0) {
+    *ppSpaRangeTbl = pFitHead->ppSpaRangeTbles[Position - 1];
+    ReturnCode = EFI_SUCCESS;
   }
 
 Finish:
@@ -1007,7 +1488,7 @@ GetInterleaveTable(
   )
 {
   EFI_STATUS ReturnCode = EFI_NOT_FOUND;
-  UINT16 Index = 0;
+  UINT32 Position = 0;
 
   if (pFitHead == NULL || ppInterleaveTbl == NULL) {
     ReturnCode = EFI_INVALID_PARAMETER;
@@ -1016,12 +1497,10 @@ GetInterleaveTable(
 
   *ppInterleaveTbl = NULL;
 
-  for (Index = 0; Index < pFitHead->InterleaveTblesNum; Index++) {
-    if (pFitHead->ppInterleaveTbles[Index]->InterleaveStructureIndex == InterleaveTblIndex) {
-      *ppInterleaveTbl = pFitHead->ppInterleaveTbles[Index];
-      ReturnCode = EFI_SUCCESS;
-      break;
-    }
+  Position = AcpiIndexFind(&pFitHead->InterleaveTblesIndex, InterleaveTblIndex);
+  if (Position != 0) {
+    *ppInterleaveTbl = pFitHead->ppInterleaveTbles[Position - 1];
+    ReturnCode = EFI_SUCCESS;
   }
 
 Finish:
@@ -1055,7 +1534,7 @@ GetNvDimmRegionMappingStructureForPid(
   )
 {
   EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
-  UINT16 Index = 0;
+  UINT32 Position = 0;
   SpaRangeTbl *pSpaRangeTbl = NULL;
   UINT16 SpaIndexInNvDimmRegion = 0;
   BOOLEAN Found = FALSE;
@@ -1066,12 +1545,9 @@ GetNvDimmRegionMappingStructureForPid(
 
   *ppNvDimmRegionMappingStructure = NULL;
 
-  for (Index = 0; Index < pFitHead->NvDimmRegionMappingStructuresNum; Index++) {
-    if (pFitHead->ppNvDimmRegionMappingStructures[Index]->NvDimmPhysicalId != Pid) {
-      continue;
-    }
-
-    SpaIndexInNvDimmRegion = pFitHead->ppNvDimmRegionMappingStructures[Index]->SpaRangeDescriptionTableIndex;
+  for (Position = AcpiIndexFind(&pFitHead->NvDimmRegionMappingStructuresIndex, Pid); Position != 0;
+       Position = pFitHead->pNvDimmRegionMappingStructuresNext[Position - 1]) {
+    SpaIndexInNvDimmRegion = pFitHead->ppNvDimmRegionMappingStructures[Position - 1]->SpaRangeDescriptionTableIndex;
     Found = TRUE;
 
     if (SpaRangeIndexProvided && SpaIndexInNvDimmRegion != SpaRangeIndex) {
@@ -1090,7 +1566,7 @@ GetNvDimmRegionMappingStructureForPid(
     }
 
     if (Found) {
-      *ppNvDimmRegionMappingStructure = pFitHead->ppNvDimmRegionMappingStructures[Index];
+      *ppNvDimmRegionMappingStructure = pFitHead->ppNvDimmRegionMappingStructures[Position - 1];
       ReturnCode = EFI_SUCCESS;
       break;
     } else {
@@ -1164,61 +1640,367 @@ RdpaToSpa(
 }
 
 /**
-  CopyMemoryAndAddPointerToArray - Copies the data and adds the result pointer to an array of pointers.
+  Check if the SPA range maps PMem module memory that can be translated
 
-  @param[in, out] ppTable pointer to the array of pointers. Warning! This pointer will be freed.
-  @param[in] pToAdd pointer to the data that the caller wants to add to the array.
-  @param[in] DataSize size of the data that are supposed to be copied.
-  @param[in] NewPointerIndex index in the table that the new pointer should have.
+  @param[in] pSpaRangeTable SPA range
 
-  @retval NULL - if a memory allocation failed.
-  @retval pointer to the new array of pointers (with the new one at the end).
+  @retval TRUE for persistent and volatile memory ranges
 **/
 STATIC
-VOID **
-CopyMemoryAndAddPointerToArray(
-  IN OUT VOID **ppTable,
-  IN     VOID *pToAdd,
-  IN     UINT32 DataSize,
-  IN     UINT32 *pNewPointerIndex
+BOOLEAN
+IsTranslatableSpaRange(
+  IN     SpaRangeTbl *pSpaRangeTable
   )
 {
-  VOID **ppNewTable = NULL;
-  VOID *pData = NULL;
+  return CompareGuid(&pSpaRangeTable->AddressRangeTypeGuid, &gSpaRangePmRegionGuid) ||
+      CompareGuid(&pSpaRangeTable->AddressRangeTypeGuid, &gSpaRangeVolatileRegionGuid);
+}
 
-  if (pToAdd == NULL) {
-    NVDIMM_ERR("Pointer to data for adding cannot be NULL.");
-    goto Finish;
+/**
+  Compare address translation ranges by their SPA base
+
+  @param[in] pFirst first ADDRESS_TRANSLATION_RANGE
+  @param[in] pSecond second ADDRESS_TRANSLATION_RANGE
+
+  @retval -1 if the first range starts lower, 0 if equal, 1 otherwise
+**/
+STATIC
+INT32
+CompareTranslationRanges(
+  IN     VOID *pFirst,
+  IN     VOID *pSecond
+  )
+{
+  UINT64 FirstBase = ((ADDRESS_TRANSLATION_RANGE *)pFirst)->pSpaRangeTable->SystemPhysicalAddressRangeBase;
+  UINT64 SecondBase = ((ADDRESS_TRANSLATION_RANGE *)pSecond)->pSpaRangeTable->SystemPhysicalAddressRangeBase;
+
+  if (FirstBase < SecondBase) {
+    return -1;
+  } else if (FirstBase > SecondBase) {
+    return 1;
   }
+  return 0;
+}
 
-  // Allocate the memory for the new entry to list of tables and for the contents of new entry
-  ppNewTable = AllocatePool(sizeof(VOID *) * (*pNewPointerIndex + 1));
-  pData = AllocatePool(DataSize);
+/**
+  Precompute the translation data of a region
 
-  if (ppNewTable == NULL || pData == NULL) {
-    NVDIMM_DBG("Could not allocate the memory.");
-    goto Finish;
+  @param[in] pFitHead pointer to the parsed NFit Header structure
+  @param[in] pSpaRangeTable SPA range of the region
+  @param[in] pNvDimmRegionTable region to set up
+  @param[out] pRegion translation data of the region
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER The interleave table is invalid
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+**/
+STATIC
+EFI_STATUS
+InitTranslationRegion(
+  IN     ParsedFitHeader *pFitHead,
+  IN     SpaRangeTbl *pSpaRangeTable,
+  IN     NvDimmRegionMappingStructure *pNvDimmRegionTable,
+     OUT ADDRESS_TRANSLATION_REGION *pRegion
+  )
+{
+  InterleaveStruct *pInterleaveTable = NULL;
+  UINT32 Ways = 0;
+  UINT32 Index = 0;
+
+  pRegion->pNvDimmRegionTable = pNvDimmRegionTable;
+  pRegion->SpaStart = pSpaRangeTable->SystemPhysicalAddressRangeBase + pNvDimmRegionTable->RegionOffset;
+
+  if (pNvDimmRegionTable->InterleaveStructureIndex == 0 ||
+      EFI_ERROR(GetInterleaveTable(pFitHead, pNvDimmRegionTable->InterleaveStructureIndex, &pInterleaveTable))) {
+    return EFI_SUCCESS;
   }
 
-  // Copy the array beginning only if there is any
-  if (*pNewPointerIndex > 0 && ppTable != NULL) {
-    CopyMem_S(ppNewTable, sizeof(VOID *) * (*pNewPointerIndex + 1), ppTable, sizeof(VOID *) * *pNewPointerIndex);
+  if (pInterleaveTable->LineSize == 0 || pInterleaveTable->NumberOfLinesDescribed == 0) {
+    NVDIMM_DBG("Invalid interleave table %d", pInterleaveTable->InterleaveStructureIndex);
+    return EFI_INVALID_PARAMETER;
   }
 
-  // Make a copy of the table to add
-  CopyMem_S(pData, DataSize, pToAdd, DataSize);
+  Ways = MAX(pNvDimmRegionTable->InterleaveWays, 1);
+  pRegion->pInterleaveTable = pInterleaveTable;
+  pRegion->RotationSize = (UINT64)pInterleaveTable->LineSize * pInterleaveTable->NumberOfLinesDescribed;
+  pRegion->SpaRotationSize = pRegion->RotationSize * Ways;
+  pRegion->SpaLinesNum = pInterleaveTable->NumberOfLinesDescribed * Ways;
+
+  pRegion->pRegionLines = AllocatePool(sizeof(UINT32) * pRegion->SpaLinesNum);
+  if (pRegion->pRegionLines == NULL) {
+    return EFI_OUT_OF_RESOURCES;
+  }
+  for (Index = 0; Index < pRegion->SpaLinesNum; Index++) {
+    pRegion->pRegionLines[Index] = MAX_UINT32;
+  }
+
+  // Invert the line offsets, a SPA line of the rotation maps to at most one line of the region
+  for (Index = 0; Index < pInterleaveTable->NumberOfLinesDescribed; Index++) {
+    if (pInterleaveTable->LinesOffsets[Index] < pRegion->SpaLinesNum) {
+      pRegion->pRegionLines[pInterleaveTable->LinesOffsets[Index]] = Index;
+    }
+  }
+
+  return EFI_SUCCESS;
+}
+
+/**
+  Build the address translation map of the persistent and volatile SPA ranges
+
+  The inverse of the interleave line offsets is computed once per region,
+  so every translation done with the map is a lookup instead of a search
+  through the interleave tables.
+
+  @param[in] pFitHead pointer to the parsed NFit Header structure
+  @param[out] ppMap pointer to the allocated map, free with FreeAddressTranslationMap
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER NULL parameter or invalid interleave table
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+**/
+EFI_STATUS
+BuildAddressTranslationMap(
+  IN     ParsedFitHeader *pFitHead,
+     OUT ADDRESS_TRANSLATION_MAP **ppMap
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  ADDRESS_TRANSLATION_MAP *pMap = NULL;
+  ADDRESS_TRANSLATION_RANGE *pRange = NULL;
+  SpaRangeTbl *pSpaRangeTable = NULL;
+  NvDimmRegionMappingStructure *pNvDimmRegionTable = NULL;
+  UINT32 SpaIndex = 0;
+  UINT32 RegionIndex = 0;
+  UINT32 RegionsNum = 0;
+
+  NVDIMM_ENTRY();
+
+  CHECK_NULL_ARG(pFitHead, Finish);
+  CHECK_NULL_ARG(ppMap, Finish);
+
+  CHECK_RESULT_MALLOC(pMap, AllocateZeroPool(sizeof(*pMap)), Finish);
+
+  for (SpaIndex = 0; SpaIndex < pFitHead->SpaRangeTblesNum; SpaIndex++) {
+    if (IsTranslatableSpaRange(pFitHead->ppSpaRangeTbles[SpaIndex])) {
+      pMap->RangesNum++;
+    }
+  }
+  for (RegionIndex = 0; RegionIndex < pFitHead->NvDimmRegionMappingStructuresNum; RegionIndex++) {
+    pNvDimmRegionTable = pFitHead->ppNvDimmRegionMappingStructures[RegionIndex];
+    if (!EFI_ERROR(GetSpaRangeTable(pFitHead, pNvDimmRegionTable->SpaRangeDescriptionTableIndex, &pSpaRangeTable)) &&
+        IsTranslatableSpaRange(pSpaRangeTable)) {
+      pMap->RegionsNum++;
+    }
+  }
+
+  if (pMap->RangesNum > 0) {
+    CHECK_RESULT_MALLOC(pMap->pRanges, AllocateZeroPool(sizeof(*pMap->pRanges) * pMap->RangesNum), Finish);
+  }
+  if (pMap->RegionsNum > 0) {
+    CHECK_RESULT_MALLOC(pMap->pRegions, AllocateZeroPool(sizeof(*pMap->pRegions) * pMap->RegionsNum), Finish);
+  }
 
-  // Assign the new copied table to the array
-  ppNewTable[*pNewPointerIndex] = pData;
+  // Keep the regions of a range next to each other
+  pRange = pMap->pRanges;
+  for (SpaIndex = 0; SpaIndex < pFitHead->SpaRangeTblesNum; SpaIndex++) {
+    pSpaRangeTable = pFitHead->ppSpaRangeTbles[SpaIndex];
+    if (!IsTranslatableSpaRange(pSpaRangeTable)) {
+      continue;
+    }
+
+    pRange->pSpaRangeTable = pSpaRangeTable;
+    pRange->pRegions = &pMap->pRegions[RegionsNum];
+    for (RegionIndex = 0; RegionIndex < pFitHead->NvDimmRegionMappingStructuresNum; RegionIndex++) {
+      pNvDimmRegionTable = pFitHead->ppNvDimmRegionMappingStructures[RegionIndex];
+      if (pNvDimmRegionTable->SpaRangeDescriptionTableIndex != pSpaRangeTable->SpaRangeDescriptionTableIndex ||
+          RegionsNum >= pMap->RegionsNum) {
+        continue;
+      }
+      CHECK_RESULT(InitTranslationRegion(pFitHead, pSpaRangeTable, pNvDimmRegionTable, &pMap->pRegions[RegionsNum]), Finish);
+      RegionsNum++;
+      pRange->RegionsNum++;
+    }
+    pRange++;
+  }
+
+  if (pMap->RangesNum > 1) {
+    CHECK_RESULT(MergeSort(pMap->pRanges, pMap->RangesNum, sizeof(*pMap->pRanges), CompareTranslationRanges), Finish);
+  }
 
-  (*pNewPointerIndex)++; // Increment the array index
+  *ppMap = pMap;
+  ReturnCode = EFI_SUCCESS;
 
 Finish:
-  FREE_POOL_SAFE(ppTable);
+  if (EFI_ERROR(ReturnCode)) {
+    FreeAddressTranslationMap(&pMap);
+  }
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Free an address translation map
 
-  return ppNewTable;
+  @param[in, out] ppMap pointer to the map, set to NULL
+**/
+VOID
+FreeAddressTranslationMap(
+  IN OUT ADDRESS_TRANSLATION_MAP **ppMap
+  )
+{
+  UINT32 Index = 0;
+
+  if (ppMap == NULL || *ppMap == NULL) {
+    return;
+  }
+
+  for (Index = 0; Index < (*ppMap)->RegionsNum && (*ppMap)->pRegions != NULL; Index++) {
+    FREE_POOL_SAFE((*ppMap)->pRegions[Index].pRegionLines);
+  }
+  FREE_POOL_SAFE((*ppMap)->pRegions);
+  FREE_POOL_SAFE((*ppMap)->pRanges);
+  FREE_POOL_SAFE(*ppMap);
+}
+
+/**
+  Translate a system physical address to a PMem module device physical address
+
+  @param[in] pMap address translation map
+  @param[in] Spa system physical address
+  @param[out] ppNvDimmRegionTable region of the PMem module holding the address
+  @param[out] pDpa device physical address on the PMem module
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER NULL parameter
+  @retval EFI_NOT_FOUND The address is not in a PMem module SPA range
+**/
+EFI_STATUS
+TranslateSpaToDpa(
+  IN     ADDRESS_TRANSLATION_MAP *pMap,
+  IN     UINT64 Spa,
+     OUT NvDimmRegionMappingStructure **ppNvDimmRegionTable,
+     OUT UINT64 *pDpa
+  )
+{
+  ADDRESS_TRANSLATION_RANGE *pRange = NULL;
+  ADDRESS_TRANSLATION_REGION *pRegion = NULL;
+  SpaRangeTbl *pSpaRangeTable = NULL;
+  UINT32 Low = 0;
+  UINT32 High = 0;
+  UINT32 Middle = 0;
+  UINT32 Index = 0;
+  UINT32 RegionLine = 0;
+  UINT64 Offset = 0;
+  UINT64 Rdpa = 0;
+
+  if (pMap == NULL || ppNvDimmRegionTable == NULL || pDpa == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  // Find the last range starting at or below the address
+  High = pMap->RangesNum;
+  while (Low < High) {
+    Middle = Low + (High - Low) / 2;
+    if (pMap->pRanges[Middle].pSpaRangeTable->SystemPhysicalAddressRangeBase <= Spa) {
+      Low = Middle + 1;
+    } else {
+      High = Middle;
+    }
+  }
+  if (Low == 0) {
+    return EFI_NOT_FOUND;
+  }
+  pRange = &pMap->pRanges[Low - 1];
+  pSpaRangeTable = pRange->pSpaRangeTable;
+  if (Spa - pSpaRangeTable->SystemPhysicalAddressRangeBase >= pSpaRangeTable->SystemPhysicalAddressRangeLength) {
+    return EFI_NOT_FOUND;
+  }
+
+  for (Index = 0; Index < pRange->RegionsNum; Index++) {
+    pRegion = &pRange->pRegions[Index];
+    if (Spa < pRegion->SpaStart) {
+      continue;
+    }
+    Offset = Spa - pRegion->SpaStart;
+
+    if (pRegion->pInterleaveTable == NULL) {
+      Rdpa = Offset;
+    } else {
+      RegionLine = pRegion->pRegionLines[(Offset % pRegion->SpaRotationSize) / pRegion->pInterleaveTable->LineSize];
+      if (RegionLine == MAX_UINT32) {
+        continue;
+      }
+      Rdpa = (Offset / pRegion->SpaRotationSize) * pRegion->RotationSize
+          + (UINT64)RegionLine * pRegion->pInterleaveTable->LineSize
+          + Offset % pRegion->pInterleaveTable->LineSize;
+    }
+
+    if (Rdpa >= pRegion->pNvDimmRegionTable->NvDimmRegionSize) {
+      continue;
+    }
+
+    *ppNvDimmRegionTable = pRegion->pNvDimmRegionTable;
+    *pDpa = pRegion->pNvDimmRegionTable->NvDimmPhysicalAddressRegionBase + Rdpa;
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
 }
 
+/**
+  Translate a PMem module device physical address to a system physical address
+
+  @param[in] pMap address translation map
+  @param[in] DeviceHandle NFIT device handle of the PMem module
+  @param[in] Dpa device physical address on the PMem module
+  @param[out] pSpa system physical address
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER NULL parameter
+  @retval EFI_NOT_FOUND The address is not mapped to a SPA range
+**/
+EFI_STATUS
+TranslateDpaToSpa(
+  IN     ADDRESS_TRANSLATION_MAP *pMap,
+  IN     UINT32 DeviceHandle,
+  IN     UINT64 Dpa,
+     OUT UINT64 *pSpa
+  )
+{
+  ADDRESS_TRANSLATION_REGION *pRegion = NULL;
+  NvDimmRegionMappingStructure *pNvDimmRegionTable = NULL;
+  UINT32 Index = 0;
+  UINT32 LineNum = 0;
+  UINT64 Rdpa = 0;
+
+  if (pMap == NULL || pSpa == NULL) {
+    return EFI_INVALID_PARAMETER;
+  }
+
+  for (Index = 0; Index < pMap->RegionsNum; Index++) {
+    pRegion = &pMap->pRegions[Index];
+    pNvDimmRegionTable = pRegion->pNvDimmRegionTable;
+    if (pNvDimmRegionTable->DeviceHandle.AsUint32 != DeviceHandle ||
+        Dpa < pNvDimmRegionTable->NvDimmPhysicalAddressRegionBase ||
+        Dpa - pNvDimmRegionTable->NvDimmPhysicalAddressRegionBase >= pNvDimmRegionTable->NvDimmRegionSize) {
+      continue;
+    }
+
+    Rdpa = Dpa - pNvDimmRegionTable->NvDimmPhysicalAddressRegionBase;
+    if (pRegion->pInterleaveTable == NULL) {
+      *pSpa = pRegion->SpaStart + Rdpa;
+    } else {
+      LineNum = (UINT32)((Rdpa % pRegion->RotationSize) / pRegion->pInterleaveTable->LineSize);
+      *pSpa = pRegion->SpaStart
+          + (Rdpa / pRegion->RotationSize) * pRegion->SpaRotationSize
+          + (UINT64)pRegion->pInterleaveTable->LinesOffsets[LineNum] * pRegion->pInterleaveTable->LineSize
+          + Rdpa % pRegion->pInterleaveTable->LineSize;
+    }
+    return EFI_SUCCESS;
+  }
+
+  return EFI_NOT_FOUND;
+}
 
 /**
   Return the current memory mode chosen by the BIOS during boot-up. 1LM is
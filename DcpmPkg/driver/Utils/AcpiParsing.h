@@ -328,6 +328,109 @@ RdpaToSpa(
      OUT UINT64 *pSpaAddr
   );
 
+/**
+  Translation data of one NVDIMM region of a SPA range
+**/
+typedef struct {
+  NvDimmRegionMappingStructure *pNvDimmRegionTable;   //!< Region of the PMem module
+  InterleaveStruct *pInterleaveTable;                 //!< NULL if the region is not interleaved
+  UINT64 SpaStart;                                    //!< SPA range base plus the region offset
+  UINT64 RotationSize;                                //!< Bytes of the region in one interleave rotation
+  UINT64 SpaRotationSize;                             //!< Bytes of the SPA range in one interleave rotation
+  UINT32 SpaLinesNum;                                 //!< Lines of the SPA range in one interleave rotation
+  UINT32 *pRegionLines;                               //!< Region line of each SPA line of a rotation, MAX_UINT32 if not in this region
+} ADDRESS_TRANSLATION_REGION;
+
+/**
+  Translation data of one SPA range
+**/
+typedef struct {
+  SpaRangeTbl *pSpaRangeTable;                        //!< SPA range
+  UINT32 RegionsNum;                                  //!< Count of regions interleaved in the range
+  ADDRESS_TRANSLATION_REGION *pRegions;               //!< Regions interleaved in the range
+} ADDRESS_TRANSLATION_RANGE;
+
+/**
+  Precomputed SPA to DPA and DPA to SPA translation of the persistent and
+  volatile SPA ranges of a parsed NFIT
+**/
+typedef struct {
+  UINT32 RangesNum;                                   //!< Count of SPA ranges
+  ADDRESS_TRANSLATION_RANGE *pRanges;                 //!< SPA ranges sorted by base address
+  UINT32 RegionsNum;                                  //!< Count of regions of all ranges
+  ADDRESS_TRANSLATION_REGION *pRegions;               //!< Regions of all ranges
+} ADDRESS_TRANSLATION_MAP;
+
+/**
+  Build the address translation map of the persistent and volatile SPA ranges
+
+  The inverse of the interleave line offsets is computed once per region,
+  so every translation done with the map is a lookup instead of a search
+  through the interleave tables.
+
+  @param[in] pFitHead pointer to the parsed NFit Header structure
+  @param[out] ppMap pointer to the allocated map, free with FreeAddressTranslationMap
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER NULL parameter or invalid interleave table
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+**/
+EFI_STATUS
+BuildAddressTranslationMap(
+  IN     ParsedFitHeader *pFitHead,
+     OUT ADDRESS_TRANSLATION_MAP **ppMap
+  );
+
+/**
+  Free an address translation map
+
+  @param[in, out] ppMap pointer to the map, set to NULL
+**/
+VOID
+FreeAddressTranslationMap(
+  IN OUT ADDRESS_TRANSLATION_MAP **ppMap
+  );
+
+/**
+  Translate a system physical address to a PMem module device physical address
+
+  @param[in] pMap address translation map
+  @param[in] Spa system physical address
+  @param[out] ppNvDimmRegionTable region of the PMem module holding the address
+  @param[out] pDpa device physical address on the PMem module
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER NULL parameter
+  @retval EFI_NOT_FOUND The address is not in a PMem module SPA range
+**/
+EFI_STATUS
+TranslateSpaToDpa(
+  IN     ADDRESS_TRANSLATION_MAP *pMap,
+  IN     UINT64 Spa,
+     OUT NvDimmRegionMappingStructure **ppNvDimmRegionTable,
+     OUT UINT64 *pDpa
+  );
+
+/**
+  Translate a PMem module device physical address to a system physical address
+
+  @param[in] pMap address translation map
+  @param[in] DeviceHandle NFIT device handle of the PMem module
+  @param[in] Dpa device physical address on the PMem module
+  @param[out] pSpa system physical address
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER NULL parameter
+  @retval EFI_NOT_FOUND The address is not mapped to a SPA range
+**/
+EFI_STATUS
+TranslateDpaToSpa(
+  IN     ADDRESS_TRANSLATION_MAP *pMap,
+  IN     UINT32 DeviceHandle,
+  IN     UINT64 Dpa,
+     OUT UINT64 *pSpa
+  );
+
 /**
   Return the current memory mode chosen by the BIOS during boot-up. 1LM is
   the fallback option and will always be available. 2LM will only be enabled
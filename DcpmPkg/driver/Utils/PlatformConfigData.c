@@ -205,11 +205,11 @@ GeneratePcdConfInput(
 
       /** Sort Dimms list according to BIOS requirement for Dimms order in interleave set **/
       if (pDimm->pRegionsGoal[Index]->DimmsNum == NUM_OF_DIMMS_IN_SIX_WAY_INTERLEAVE_SET) {
-        Rc = BubbleSort(pDimm->pRegionsGoal[Index]->pDimms, pDimm->pRegionsGoal[Index]->DimmsNum,
+        Rc = MergeSort(pDimm->pRegionsGoal[Index]->pDimms, pDimm->pRegionsGoal[Index]->DimmsNum,
           sizeof(DIMM *), CompareDimmOrderInInterleaveSet6Way);
       }
       else {
-        Rc = BubbleSort(pDimm->pRegionsGoal[Index]->pDimms, pDimm->pRegionsGoal[Index]->DimmsNum,
+        Rc = MergeSort(pDimm->pRegionsGoal[Index]->pDimms, pDimm->pRegionsGoal[Index]->DimmsNum,
           sizeof(DIMM *), CompareDimmOrderInInterleaveSet);
       }
       if (EFI_ERROR(Rc)) {
@@ -269,11 +269,11 @@ GeneratePcdConfInput(
 
       /** Sort Dimms list according to BIOS requirement for Dimms order in interleave set **/
       if (pDimm->pRegionsGoal[Index]->DimmsNum == NUM_OF_DIMMS_IN_SIX_WAY_INTERLEAVE_SET) {
-        Rc = BubbleSort(pDimm->pRegionsGoal[Index]->pDimms, pDimm->pRegionsGoal[Index]->DimmsNum,
+        Rc = MergeSort(pDimm->pRegionsGoal[Index]->pDimms, pDimm->pRegionsGoal[Index]->DimmsNum,
           sizeof(DIMM *), CompareDimmOrderInInterleaveSet6Way);
       }
       else {
-        Rc = BubbleSort(pDimm->pRegionsGoal[Index]->pDimms, pDimm->pRegionsGoal[Index]->DimmsNum,
+        Rc = MergeSort(pDimm->pRegionsGoal[Index]->pDimms, pDimm->pRegionsGoal[Index]->DimmsNum,
           sizeof(DIMM *), CompareDimmOrderInInterleaveSet);
       }
       if (EFI_ERROR(Rc)) {
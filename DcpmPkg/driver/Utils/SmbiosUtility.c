@@ -9,6 +9,33 @@
 #include <Library/UefiBootServicesTableLib.h>
 #include <Debug.h>
 #include <PbrDcpmm.h>
+#ifdef OS_BUILD
+#include <os_efi_api.h>
+#endif
+
+#define SMBIOS_INDEX_SLOT_EMPTY MAX_UINT32
+
+/**
+  Memory device structures of the SMBIOS table indexed by handle.
+
+  Type 17 structures are kept in table order and hashed by their handle,
+  type 20 structures are hashed by the handle of the memory device they map.
+  The hash tables use open addressing and store indexes into the arrays.
+**/
+typedef struct _SMBIOS_INDEX {
+  UINT8 *pTableStart;                             //!< SMBIOS table the index was built for
+  UINT8 *pTableBound;
+  SMBIOS_VERSION Version;
+  SMBIOS_STRUCTURE_POINTER *pMemdevs;             //!< Type 17 structures in table order
+  UINT32 MemdevCount;
+  SMBIOS_STRUCTURE_POINTER *pMemdevMappedAddrs;   //!< Type 20 structures in table order
+  UINT32 MemdevMappedAddrCount;
+  UINT32 *pMemdevSlots;                           //!< Hash of pMemdevs by handle
+  UINT32 *pMemdevMappedAddrSlots;                 //!< Hash of pMemdevMappedAddrs by memory device handle
+  UINT32 SlotCount;                               //!< Power of two
+} SMBIOS_INDEX;
+
+STATIC SMBIOS_INDEX gSmbiosIndex;
 
 /**
   Retrieve Capacity for the given SMBIOS version.
@@ -200,21 +227,23 @@ GetFirstAndBoundSmBiosStructPointer(
       TableSize = pTableEntry->TableLength;
     }
 
-    pSmbiosRecord = (PbrSmbiosTableRecord *)AllocateZeroPool(sizeof(PbrSmbiosTableRecord) + TableSize);
-    if (NULL == pSmbiosRecord) {
-      NVDIMM_DBG("Failed to allocate memory\n");
-    }
-    else {
-      pSmbiosRecord->Size = TableSize;
-      pSmbiosRecord->Minor = pSmbiosVersion->Minor;
-      pSmbiosRecord->Major = pSmbiosVersion->Major;
-      pSmbiosRecord->Minor = pSmbiosVersion->Minor;
-      CopyMem_S(pSmbiosRecord->Table, TableSize, pSmBiosStruct->Raw, TableSize);
-      ReturnCode = PbrSetTableRecord(pContext, PBR_RECORD_TYPE_SMBIOS, pSmbiosRecord, sizeof(PbrSmbiosTableRecord) + TableSize);
-      if (EFI_ERROR(ReturnCode)) {
-        NVDIMM_DBG("Failed to record SMBIOS2");
+    if (PBR_RECORD_MODE == PBR_GET_MODE(pContext)) {
+      pSmbiosRecord = (PbrSmbiosTableRecord *)AllocateZeroPool(sizeof(PbrSmbiosTableRecord) + TableSize);
+      if (NULL == pSmbiosRecord) {
+        NVDIMM_DBG("Failed to allocate memory\n");
+      }
+      else {
+        pSmbiosRecord->Size = TableSize;
+        pSmbiosRecord->Major = pSmbiosVersion->Major;
+        pSmbiosRecord->Minor = pSmbiosVersion->Minor;
+        CopyMem_S(pSmbiosRecord->Table, TableSize, pSmBiosStruct->Raw, TableSize);
+        // The record is copied into the recording buffer
+        ReturnCode = PbrSetTableRecord(pContext, PBR_RECORD_TYPE_SMBIOS, pSmbiosRecord, sizeof(PbrSmbiosTableRecord) + TableSize);
+        if (EFI_ERROR(ReturnCode)) {
+          NVDIMM_DBG("Failed to record SMBIOS2");
+        }
+        FREE_POOL_SAFE(pSmbiosRecord);
       }
-      //need to free?
     }
   }
   else {
@@ -273,3 +302,273 @@ GetNextSmbiosStruct(
 Finish:
   return ReturnCode;
 }
+
+/**
+  Hash a SMBIOS handle into a slot of the index
+
+  @param[in] Handle SMBIOS handle
+  @param[in] SlotCount Number of slots, power of two
+
+  @retval First slot to probe
+**/
+STATIC
+UINT32
+SmbiosHandleSlot(
+  IN     UINT16 Handle,
+  IN     UINT32 SlotCount
+  )
+{
+  return ((UINT32)Handle * 0x9E3779B1) & (SlotCount - 1);
+}
+
+/**
+  Insert a structure into a handle hash, a later structure with the same
+  handle replaces the earlier one
+
+  @param[in,out] pSlots Hash table
+  @param[in] SlotCount Number of slots, power of two
+  @param[in] pStructs Structures the slots point into
+  @param[in] Handle Handle the structure is looked up by
+  @param[in] StructIndex Index of the structure in pStructs
+  @param[in] IsMappedAddr TRUE if pStructs holds type 20 structures
+**/
+STATIC
+VOID
+SmbiosIndexInsert(
+  IN OUT UINT32 *pSlots,
+  IN     UINT32 SlotCount,
+  IN     SMBIOS_STRUCTURE_POINTER *pStructs,
+  IN     UINT16 Handle,
+  IN     UINT32 StructIndex,
+  IN     BOOLEAN IsMappedAddr
+  )
+{
+  UINT32 Slot = SmbiosHandleSlot(Handle, SlotCount);
+  UINT16 SlotHandle = 0;
+
+  while (pSlots[Slot] != SMBIOS_INDEX_SLOT_EMPTY) {
+    SlotHandle = IsMappedAddr ? pStructs[pSlots[Slot]].Type20->MemoryDeviceHandle :
+      pStructs[pSlots[Slot]].Hdr->Handle;
+    if (SlotHandle == Handle) {
+      break;
+    }
+    Slot = (Slot + 1) & (SlotCount - 1);
+  }
+  pSlots[Slot] = StructIndex;
+}
+
+/**
+  Find a structure in a handle hash
+
+  @param[in] pSlots Hash table
+  @param[in] SlotCount Number of slots, power of two
+  @param[in] pStructs Structures the slots point into
+  @param[in] Handle Handle to look up
+  @param[in] IsMappedAddr TRUE if pStructs holds type 20 structures
+
+  @retval Pointer to the structure or NULL if not found
+**/
+STATIC
+UINT8 *
+SmbiosIndexFind(
+  IN     UINT32 *pSlots,
+  IN     UINT32 SlotCount,
+  IN     SMBIOS_STRUCTURE_POINTER *pStructs,
+  IN     UINT16 Handle,
+  IN     BOOLEAN IsMappedAddr
+  )
+{
+  UINT32 Slot = SmbiosHandleSlot(Handle, SlotCount);
+  UINT16 SlotHandle = 0;
+
+  while (pSlots[Slot] != SMBIOS_INDEX_SLOT_EMPTY) {
+    SlotHandle = IsMappedAddr ? pStructs[pSlots[Slot]].Type20->MemoryDeviceHandle :
+      pStructs[pSlots[Slot]].Hdr->Handle;
+    if (SlotHandle == Handle) {
+      return pStructs[pSlots[Slot]].Raw;
+    }
+    Slot = (Slot + 1) & (SlotCount - 1);
+  }
+  return NULL;
+}
+
+VOID
+FreeSmbiosIndex(
+  )
+{
+  FREE_POOL_SAFE(gSmbiosIndex.pMemdevs);
+  FREE_POOL_SAFE(gSmbiosIndex.pMemdevMappedAddrs);
+  FREE_POOL_SAFE(gSmbiosIndex.pMemdevSlots);
+  FREE_POOL_SAFE(gSmbiosIndex.pMemdevMappedAddrSlots);
+  ZeroMem(&gSmbiosIndex, sizeof(gSmbiosIndex));
+}
+
+/**
+  Make sure the SMBIOS index matches the current SMBIOS table
+
+  The table is walked twice when it is seen for the first time, once to count
+  the memory device structures and once to index them. Later calls only
+  compare the table location, length and version. A table fetched again by
+  the OS layer may reuse the same memory, so the OS layer frees the index on
+  every fresh fetch.
+
+  @retval EFI_SUCCESS The index is up to date
+  @retval EFI_DEVICE_ERROR The SMBIOS table is not available
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+**/
+STATIC
+EFI_STATUS
+LoadSmbiosIndex(
+  )
+{
+  EFI_STATUS ReturnCode = EFI_DEVICE_ERROR;
+  SMBIOS_STRUCTURE_POINTER FirstSmBiosStruct;
+  SMBIOS_STRUCTURE_POINTER SmBiosStruct;
+  SMBIOS_STRUCTURE_POINTER BoundSmBiosStruct;
+  SMBIOS_VERSION SmbiosVersion;
+  UINT32 MemdevCount = 0;
+  UINT32 MemdevMappedAddrCount = 0;
+  UINT32 Index = 0;
+  BOOLEAN Fill = FALSE;
+
+  ZeroMem(&FirstSmBiosStruct, sizeof(FirstSmBiosStruct));
+  ZeroMem(&BoundSmBiosStruct, sizeof(BoundSmBiosStruct));
+  ZeroMem(&SmbiosVersion, sizeof(SmbiosVersion));
+
+  GetFirstAndBoundSmBiosStructPointer(&FirstSmBiosStruct, &BoundSmBiosStruct, &SmbiosVersion);
+  if (FirstSmBiosStruct.Raw == NULL || BoundSmBiosStruct.Raw == NULL) {
+    return EFI_DEVICE_ERROR;
+  }
+
+  if (gSmbiosIndex.pTableStart == FirstSmBiosStruct.Raw && gSmbiosIndex.pTableBound == BoundSmBiosStruct.Raw &&
+      gSmbiosIndex.Version.Major == SmbiosVersion.Major && gSmbiosIndex.Version.Minor == SmbiosVersion.Minor) {
+    return EFI_SUCCESS;
+  }
+
+  FreeSmbiosIndex();
+
+  for (Fill = FALSE; ; Fill = TRUE) {
+    MemdevCount = 0;
+    MemdevMappedAddrCount = 0;
+    SmBiosStruct = FirstSmBiosStruct;
+    while (SmBiosStruct.Raw < BoundSmBiosStruct.Raw) {
+      if (SmBiosStruct.Hdr == NULL) {
+        NVDIMM_ERR("SmBios entry has invalid pointers set");
+      } else if (SmBiosStruct.Hdr->Type == SMBIOS_TYPE_MEM_DEV) {
+        if (Fill) {
+          gSmbiosIndex.pMemdevs[MemdevCount] = SmBiosStruct;
+        }
+        MemdevCount++;
+      } else if (SmBiosStruct.Hdr->Type == SMBIOS_TYPE_MEM_DEV_MAPPED_ADDR) {
+        if (Fill) {
+          gSmbiosIndex.pMemdevMappedAddrs[MemdevMappedAddrCount] = SmBiosStruct;
+        }
+        MemdevMappedAddrCount++;
+      }
+
+      ReturnCode = GetNextSmbiosStruct(&SmBiosStruct);
+      if (EFI_ERROR(ReturnCode)) {
+        goto Finish;
+      }
+    }
+
+    if (Fill) {
+      break;
+    }
+
+    /** Keep the hash tables at most half full **/
+    gSmbiosIndex.SlotCount = 1;
+    while (gSmbiosIndex.SlotCount < 2 * MAX(MemdevCount, MemdevMappedAddrCount)) {
+      gSmbiosIndex.SlotCount <<= 1;
+    }
+
+    gSmbiosIndex.pMemdevs = AllocateZeroPool(MAX(MemdevCount, 1) * sizeof(SMBIOS_STRUCTURE_POINTER));
+    gSmbiosIndex.pMemdevMappedAddrs = AllocateZeroPool(MAX(MemdevMappedAddrCount, 1) * sizeof(SMBIOS_STRUCTURE_POINTER));
+    gSmbiosIndex.pMemdevSlots = AllocatePool(gSmbiosIndex.SlotCount * sizeof(UINT32));
+    gSmbiosIndex.pMemdevMappedAddrSlots = AllocatePool(gSmbiosIndex.SlotCount * sizeof(UINT32));
+    if (gSmbiosIndex.pMemdevs == NULL || gSmbiosIndex.pMemdevMappedAddrs == NULL ||
+        gSmbiosIndex.pMemdevSlots == NULL || gSmbiosIndex.pMemdevMappedAddrSlots == NULL) {
+      ReturnCode = EFI_OUT_OF_RESOURCES;
+      goto Finish;
+    }
+    SetMem(gSmbiosIndex.pMemdevSlots, gSmbiosIndex.SlotCount * sizeof(UINT32), 0xFF);
+    SetMem(gSmbiosIndex.pMemdevMappedAddrSlots, gSmbiosIndex.SlotCount * sizeof(UINT32), 0xFF);
+  }
+
+  for (Index = 0; Index < MemdevCount; Index++) {
+    SmbiosIndexInsert(gSmbiosIndex.pMemdevSlots, gSmbiosIndex.SlotCount, gSmbiosIndex.pMemdevs,
+      gSmbiosIndex.pMemdevs[Index].Hdr->Handle, Index, FALSE);
+  }
+  for (Index = 0; Index < MemdevMappedAddrCount; Index++) {
+    SmbiosIndexInsert(gSmbiosIndex.pMemdevMappedAddrSlots, gSmbiosIndex.SlotCount, gSmbiosIndex.pMemdevMappedAddrs,
+      gSmbiosIndex.pMemdevMappedAddrs[Index].Type20->MemoryDeviceHandle, Index, TRUE);
+  }
+
+  gSmbiosIndex.MemdevCount = MemdevCount;
+  gSmbiosIndex.MemdevMappedAddrCount = MemdevMappedAddrCount;
+  gSmbiosIndex.Version = SmbiosVersion;
+  gSmbiosIndex.pTableStart = FirstSmBiosStruct.Raw;
+  gSmbiosIndex.pTableBound = BoundSmBiosStruct.Raw;
+  ReturnCode = EFI_SUCCESS;
+
+Finish:
+  if (EFI_ERROR(ReturnCode)) {
+    FreeSmbiosIndex();
+  }
+  return ReturnCode;
+}
+
+EFI_STATUS
+GetSmbiosMemdevStructs(
+  IN     UINT16 MemdevHandle,
+     OUT SMBIOS_STRUCTURE_POINTER *pMemdev,
+     OUT SMBIOS_STRUCTURE_POINTER *pMemdevMappedAddr,
+     OUT SMBIOS_VERSION *pSmbiosVersion
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+
+  if (pMemdev == NULL || pMemdevMappedAddr == NULL || pSmbiosVersion == NULL) {
+    goto Finish;
+  }
+
+  ReturnCode = LoadSmbiosIndex();
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
+  }
+
+  pMemdev->Raw = SmbiosIndexFind(gSmbiosIndex.pMemdevSlots, gSmbiosIndex.SlotCount,
+    gSmbiosIndex.pMemdevs, MemdevHandle, FALSE);
+  pMemdevMappedAddr->Raw = SmbiosIndexFind(gSmbiosIndex.pMemdevMappedAddrSlots, gSmbiosIndex.SlotCount,
+    gSmbiosIndex.pMemdevMappedAddrs, MemdevHandle, TRUE);
+  *pSmbiosVersion = gSmbiosIndex.Version;
+
+Finish:
+  return ReturnCode;
+}
+
+EFI_STATUS
+GetSmbiosMemdevs(
+     OUT SMBIOS_STRUCTURE_POINTER **ppMemdevs,
+     OUT UINT32 *pMemdevCount,
+     OUT SMBIOS_VERSION *pSmbiosVersion
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+
+  if (ppMemdevs == NULL || pMemdevCount == NULL || pSmbiosVersion == NULL) {
+    goto Finish;
+  }
+
+  ReturnCode = LoadSmbiosIndex();
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
+  }
+
+  *ppMemdevs = gSmbiosIndex.pMemdevs;
+  *pMemdevCount = gSmbiosIndex.MemdevCount;
+  *pSmbiosVersion = gSmbiosIndex.Version;
+
+Finish:
+  return ReturnCode;
+}
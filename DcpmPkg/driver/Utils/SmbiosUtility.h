@@ -11,6 +11,11 @@
 
 #define SMBIOS_STRING_INVALID 0
 
+/** Memory Device SMBIOS Table **/
+#define SMBIOS_TYPE_MEM_DEV             17
+/** Memory Device Mapped Address SMBIOS Table **/
+#define SMBIOS_TYPE_MEM_DEV_MAPPED_ADDR 20
+
 typedef struct {
   UINT8   AnchorString[5];
   UINT8   EntryPointStructureChecksum;
@@ -100,4 +105,58 @@ GetFirstAndBoundSmBiosStructPointer(
 );
 #endif
 
+/**
+  Get the memory device (type 17) and memory device mapped address (type 20)
+  structures of a memory device.
+
+  The memory device structures are indexed by handle when the SMBIOS table is
+  seen for the first time, so the lookup does not walk the table.
+
+  @param[in]  MemdevHandle Handle of the memory device (type 17) structure
+  @param[out] pMemdev Memory device structure, Raw is NULL if not found
+  @param[out] pMemdevMappedAddr Memory device mapped address structure, Raw is NULL if not found
+  @param[out] pSmbiosVersion The SMBIOS version
+
+  @retval EFI_SUCCESS Lookup done
+  @retval EFI_INVALID_PARAMETER NULL parameter passed
+  @retval EFI_DEVICE_ERROR The SMBIOS table is not available
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure while building the index
+**/
+EFI_STATUS
+GetSmbiosMemdevStructs(
+  IN     UINT16 MemdevHandle,
+     OUT SMBIOS_STRUCTURE_POINTER *pMemdev,
+     OUT SMBIOS_STRUCTURE_POINTER *pMemdevMappedAddr,
+     OUT SMBIOS_VERSION *pSmbiosVersion
+  );
+
+/**
+  Get all memory device (type 17) structures in SMBIOS table order
+
+  The returned array is owned by the SMBIOS index and must not be freed. It
+  stays valid until the SMBIOS table changes or FreeSmbiosIndex() is called.
+
+  @param[out] ppMemdevs Array of memory device structures
+  @param[out] pMemdevCount Number of memory device structures
+  @param[out] pSmbiosVersion The SMBIOS version
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER NULL parameter passed
+  @retval EFI_DEVICE_ERROR The SMBIOS table is not available
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure while building the index
+**/
+EFI_STATUS
+GetSmbiosMemdevs(
+     OUT SMBIOS_STRUCTURE_POINTER **ppMemdevs,
+     OUT UINT32 *pMemdevCount,
+     OUT SMBIOS_VERSION *pSmbiosVersion
+  );
+
+/**
+  Free the SMBIOS index
+**/
+VOID
+FreeSmbiosIndex(
+  );
+
 #endif /* _SMBIOSUTILITY_H_ */
@@ -11,8 +11,11 @@
 #include "Debug.h"
 #include "Convert.h"
 #include <stdio.h>
+#include <Dimm.h>
+#include <NvmDimmDriver.h>
 
 extern EFI_SHELL_PARAMETERS_PROTOCOL gOsShellParametersProtocol;
+extern NVMDIMMDRIVER_DATA *gNvmDimmData;
 
 /**
   Get FW debug log syntax definition
@@ -51,8 +54,9 @@ typedef struct _DUMP_SUPPORT_CMD
 #define APPEND_TO_FILE_NAME L"platform_support_info"
 #define PLATFORM_INFO_STR L"Platform information"
 #define DIMM_SPECIFIC_INFO L"Dimm Specific information - UUID: "
-#define WITH_DIC_OPTION  DICTIONARY_OPTION SPACE_FORMAT_STR_SPACE DEBUG_TARGET L" " DIMM_TARGET SPACE_FORMAT_HEX
-#define WITHOUT_DICT_OPTION DEBUG_TARGET L" " DIMM_TARGET SPACE_FORMAT_HEX
+#define APPEND_TO_DIMM_FILE_NAME L"support_info"
+#define WITH_DIC_OPTION  DICTIONARY_OPTION SPACE_FORMAT_STR_SPACE DEBUG_TARGET
+#define WITHOUT_DICT_OPTION DEBUG_TARGET
 #define STR_DUMP_DEST L"dump -destination %ls "
 
 DUMP_SUPPORT_CMD DumpPlatformLevelCmds[MAX_PLAFORM_SUPPORT_CMDS] = {
@@ -113,7 +117,290 @@ STATIC VOID PrintAndExecuteCommand(CHAR16 *pCmdInputWithDimmId) {
     ReturnCode = ExecuteCmd(&Command);
   }
   FreeCommandInput(&Input);
+  FreeCommandStructure(&Command);
 }
+
+/**
+  Work of collecting the raw data of one PMem module
+**/
+typedef struct _DUMP_SUPPORT_DIMM_CONTEXT {
+  EFI_DCPMM_CONFIG2_PROTOCOL *pNvmDimmConfigProtocol;
+  DIMM_INFO *pDimm;
+  CHAR16 *pDumpUserPath;
+} DUMP_SUPPORT_DIMM_CONTEXT;
+
+/**
+  Write one raw file of a PMem module
+
+  The file is named <prefix>_<uid>_<handle>_<name>.bin like the FW debug
+  log files written by dump -debug.
+
+  @param[in] pContext the PMem module
+  @param[in] pName name of the data
+  @param[in] pData data to write
+  @param[in] Size size of the data in bytes
+
+  @retval EFI_SUCCESS on success
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval EFI_INVALID_PARAMETER the file could not be opened
+  @retval EFI_VOLUME_FULL the data could not be written
+**/
+STATIC
+EFI_STATUS
+WriteDimmRawFile(
+  IN     DUMP_SUPPORT_DIMM_CONTEXT *pContext,
+  IN     CHAR16 *pName,
+  IN     VOID *pData,
+  IN     UINT64 Size
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  CHAR16 *pFileName = NULL;
+  CHAR8 *pFileNameAscii = NULL;
+  UINTN FileNameAsciiLength = 0;
+  FILE *pFile = NULL;
+
+  pFileName = CatSPrint(pContext->pDumpUserPath, L"_" FORMAT_STR L"_0x%04x_" FORMAT_STR L".bin",
+      pContext->pDimm->DimmUid, pContext->pDimm->DimmHandle, pName);
+  if (pFileName == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+  FileNameAsciiLength = StrLen(pFileName) + 1;
+  pFileNameAscii = AllocatePool(FileNameAsciiLength);
+  if (pFileNameAscii == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+  UnicodeStrToAsciiStrS(pFileName, pFileNameAscii, FileNameAsciiLength);
+
+  pFile = fopen(pFileNameAscii, "wb+");
+  if (pFile == NULL) {
+    ReturnCode = EFI_INVALID_PARAMETER;
+    goto Finish;
+  }
+  if (fwrite(pData, 1, (size_t)Size, pFile) != Size) {
+    ReturnCode = EFI_VOLUME_FULL;
+  }
+  fclose(pFile);
+
+Finish:
+  FREE_POOL_SAFE(pFileName);
+  FREE_POOL_SAFE(pFileNameAscii);
+  return ReturnCode;
+}
+
+/**
+  Dump the raw configuration partition of the PCD of one PMem module
+
+  Only the configuration header and the current, input and output
+  configurations are written, not the whole partition.
+
+  @param[in] pContext the PMem module
+
+  @retval EFI_SUCCESS on success
+  @retval other the PCD could not be read or written
+**/
+STATIC
+EFI_STATUS
+DumpDimmRawPcd(
+  IN     DUMP_SUPPORT_DIMM_CONTEXT *pContext
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  COMMAND_STATUS *pCommandStatus = NULL;
+  DIMM_PCD_INFO *pDimmPcdInfo = NULL;
+  UINT32 DimmPcdInfoCount = 0;
+  NVDIMM_CONFIGURATION_HEADER *pConfHeader = NULL;
+  UINT16 DimmId = pContext->pDimm->DimmID;
+  UINT64 Size = 0;
+
+  CHECK_RESULT(InitializeCommandStatus(&pCommandStatus), Finish);
+  CHECK_RESULT(pContext->pNvmDimmConfigProtocol->GetPcd(pContext->pNvmDimmConfigProtocol, PCD_TARGET_CONFIG,
+      &DimmId, 1, &pDimmPcdInfo, &DimmPcdInfoCount, pCommandStatus), Finish);
+
+  if (pDimmPcdInfo == NULL || DimmPcdInfoCount == 0 || pDimmPcdInfo[0].pConfHeader == NULL) {
+    ReturnCode = EFI_NOT_FOUND;
+    goto Finish;
+  }
+  pConfHeader = pDimmPcdInfo[0].pConfHeader;
+
+  Size = sizeof(*pConfHeader);
+  Size = MAX(Size, (UINT64)pConfHeader->CurrentConfStartOffset + pConfHeader->CurrentConfDataSize);
+  Size = MAX(Size, (UINT64)pConfHeader->ConfInputStartOffset + pConfHeader->ConfInputDataSize);
+  Size = MAX(Size, (UINT64)pConfHeader->ConfOutputStartOffset + pConfHeader->ConfOutputDataSize);
+  Size = MIN(Size, PCD_OEM_PARTITION_INTEL_CFG_REGION_SIZE);
+
+  ReturnCode = WriteDimmRawFile(pContext, L"pcd", pConfHeader, Size);
+
+Finish:
+  FreeDimmPcdInfoArray(pDimmPcdInfo, DimmPcdInfoCount);
+  FreeCommandStatus(&pCommandStatus);
+  return ReturnCode;
+}
+
+/**
+  RunOnDimms worker collecting the raw data of one PMem module
+
+  @param[in] pDimm the PMem module
+  @param[in] pArg the DUMP_SUPPORT_DIMM_CONTEXT of the PMem module
+
+  @retval EFI_SUCCESS on success
+  @retval other the PCD could not be read or written
+**/
+STATIC
+EFI_STATUS
+DumpSupportDimmWorker(
+  IN     DIMM *pDimm,
+  IN     VOID *pArg
+  )
+{
+  return DumpDimmRawPcd((DUMP_SUPPORT_DIMM_CONTEXT *)pArg);
+}
+
+/**
+  Collect the raw PCD of all PMem modules in parallel (see RunOnDimms)
+
+  All modules come from the same inventory snapshot, so the collection takes
+  as long as the slowest module. The PCD read here stays in the PCD cache, so
+  the show -pcd commands of the text pass do not read it again. The error
+  logs are only read by the show -error commands.
+
+  @param[in] pPrinterCtx printer context
+  @param[in] pNvmDimmConfigProtocol config protocol
+  @param[in] pDimms all PMem modules
+  @param[in] DimmCount number of PMem modules
+  @param[in] pDumpUserPath destination prefix
+
+  @retval EFI_SUCCESS on success
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+**/
+STATIC
+EFI_STATUS
+DumpSupportRawDataParallel(
+  IN     PRINT_CONTEXT *pPrinterCtx,
+  IN     EFI_DCPMM_CONFIG2_PROTOCOL *pNvmDimmConfigProtocol,
+  IN     DIMM_INFO *pDimms,
+  IN     UINT32 DimmCount,
+  IN     CHAR16 *pDumpUserPath
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  DUMP_SUPPORT_DIMM_CONTEXT *pContexts = NULL;
+  DIMM **ppDimms = NULL;
+  VOID **ppArgs = NULL;
+  EFI_STATUS *pReturnCodes = NULL;
+  UINT32 DimmsNum = 0;
+  UINT32 Index = 0;
+
+  pContexts = AllocateZeroPool(sizeof(*pContexts) * DimmCount);
+  ppDimms = AllocateZeroPool(sizeof(*ppDimms) * DimmCount);
+  ppArgs = AllocateZeroPool(sizeof(*ppArgs) * DimmCount);
+  pReturnCodes = AllocateZeroPool(sizeof(*pReturnCodes) * DimmCount);
+  if (pContexts == NULL || ppDimms == NULL || ppArgs == NULL || pReturnCodes == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, FORMAT_STR_NL, CLI_ERR_OUT_OF_MEMORY);
+    goto Finish;
+  }
+
+  for (Index = 0; Index < DimmCount; Index++) {
+    pContexts[DimmsNum].pNvmDimmConfigProtocol = pNvmDimmConfigProtocol;
+    pContexts[DimmsNum].pDimm = &pDimms[Index];
+    pContexts[DimmsNum].pDumpUserPath = pDumpUserPath;
+    ppDimms[DimmsNum] = GetDimmByPid(pDimms[Index].DimmID, &gNvmDimmData->PMEMDev.Dimms);
+    ppArgs[DimmsNum] = &pContexts[DimmsNum];
+    if (ppDimms[DimmsNum] == NULL) {
+      PRINTER_SET_MSG(pPrinterCtx, EFI_SUCCESS, L"Failed to dump the raw PCD of PMem module 0x%04x\n",
+          pDimms[Index].DimmHandle);
+      continue;
+    }
+    DimmsNum++;
+  }
+
+  RunOnDimms(ppDimms, DimmsNum, DumpSupportDimmWorker, ppArgs, pReturnCodes);
+
+  for (Index = 0; Index < DimmsNum; Index++) {
+    if (EFI_ERROR(pReturnCodes[Index])) {
+      PRINTER_SET_MSG(pPrinterCtx, EFI_SUCCESS, L"Failed to dump the raw PCD of PMem module 0x%04x\n",
+          pContexts[Index].pDimm->DimmHandle);
+    }
+  }
+
+Finish:
+  FREE_POOL_SAFE(pContexts);
+  FREE_POOL_SAFE(ppDimms);
+  FREE_POOL_SAFE(ppArgs);
+  FREE_POOL_SAFE(pReturnCodes);
+  return ReturnCode;
+}
+
+/**
+  Run the text commands of one PMem module into its own file
+
+  @param[in] pDumpUserPath destination prefix
+  @param[in] pDimm the PMem module
+
+  @retval EFI_SUCCESS on success
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval EFI_INVALID_PARAMETER the file could not be opened
+**/
+STATIC
+EFI_STATUS
+DumpDimmSupportInfo(
+  IN     CHAR16 *pDumpUserPath,
+  IN     DIMM_INFO *pDimm
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  CHAR16 *pFileName = NULL;
+  CHAR8 *pFileNameAscii = NULL;
+  UINTN FileNameAsciiLength = 0;
+  CHAR16 *pPrintDIMMHeaderInfo = NULL;
+  CHAR16 *pCmdInputWithDimmId = NULL;
+  SHELL_FILE_HANDLE PreviousStdOut = gOsShellParametersProtocol.StdOut;
+  FILE *hFile = NULL;
+  UINT32 Index = 0;
+
+  pFileName = CatSPrint(pDumpUserPath, L"_" FORMAT_STR L"_0x%04x_" FORMAT_STR L".txt",
+      pDimm->DimmUid, pDimm->DimmHandle, APPEND_TO_DIMM_FILE_NAME);
+  if (pFileName == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+  FileNameAsciiLength = StrLen(pFileName) + 1;
+  pFileNameAscii = AllocatePool(FileNameAsciiLength);
+  if (pFileNameAscii == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+  CHECK_RESULT(UnicodeStrToAsciiStrS(pFileName, pFileNameAscii, FileNameAsciiLength), Finish);
+
+  if (NULL == (hFile = fopen(pFileNameAscii, "w+"))) {
+    ReturnCode = EFI_INVALID_PARAMETER;
+    goto Finish;
+  }
+  gOsShellParametersProtocol.StdOut = (SHELL_FILE_HANDLE) hFile;
+
+  pPrintDIMMHeaderInfo = CatSPrint(NULL, DIMM_SPECIFIC_INFO FORMAT_STR, pDimm->DimmUid);
+  if (pPrintDIMMHeaderInfo != NULL) {
+    PrintHeaderInfo(pPrintDIMMHeaderInfo);
+  }
+  for (Index = 0; Index < MAX_DIMM_SPECIFIC_CMDS; ++Index) {
+    pCmdInputWithDimmId = CatSPrint(NULL, DumpCmdsPerDimm[Index].cmd, pDimm->DimmHandle);
+    PrintAndExecuteCommand(pCmdInputWithDimmId);
+    FREE_POOL_SAFE(pCmdInputWithDimmId);
+  }
+
+  fclose(hFile);
+  gOsShellParametersProtocol.StdOut = PreviousStdOut;
+
+Finish:
+  FREE_POOL_SAFE(pPrintDIMMHeaderInfo);
+  FREE_POOL_SAFE(pFileName);
+  FREE_POOL_SAFE(pFileNameAscii);
+  return ReturnCode;
+}
+
 /**
   Dump support command
 
@@ -134,7 +421,6 @@ DumpSupportCommand(
   COMMAND_STATUS *pCommandStatus = NULL;
   CHAR16 *pDumpUserPath = NULL;
   CHAR16 *pPlatformSupportFileName = NULL;
-  CHAR16 *pPrintDIMMHeaderInfo = NULL;
   UINT32 Index = 0;
   UINT32 DimmIndex = 0;
 
@@ -198,6 +484,10 @@ DumpSupportCommand(
     PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_PARSER_ERR_INVALID_OPTION_VALUES);
     goto Finish;
   }
+
+  /* The raw PCD of the modules is fetched in parallel before any text command runs */
+  CHECK_RESULT(DumpSupportRawDataParallel(pPrinterCtx, pNvmDimmConfigProtocol, pDimms, DimmCount, pDumpUserPath), Finish);
+
   pPlatformSupportFileName = CatSPrint(pDumpUserPath, L"_" FORMAT_STR L".txt",
     APPEND_TO_FILE_NAME);
 
@@ -228,27 +518,23 @@ DumpSupportCommand(
   gOsShellParametersProtocol.StdOut = (SHELL_FILE_HANDLE) hFile;
   PrintHeaderInfo(PLATFORM_INFO_STR);
   for(Index = 0; Index < MAX_PLAFORM_SUPPORT_CMDS; ++Index) {
-	PrintAndExecuteCommand(DumpPlatformLevelCmds[Index].cmd);
+    PrintAndExecuteCommand(DumpPlatformLevelCmds[Index].cmd);
   }
 
   for (DimmIndex = 0; DimmIndex < DimmCount; ++DimmIndex) {
-    pPrintDIMMHeaderInfo = CatSPrint(NULL, DIMM_SPECIFIC_INFO FORMAT_STR, pDimms[DimmIndex].DimmUid);
-    PrintHeaderInfo(pPrintDIMMHeaderInfo);
-    FREE_POOL_SAFE(pPrintDIMMHeaderInfo);
-    for (Index = 0; Index < MAX_DIMM_SPECIFIC_CMDS; ++Index) {
-      pCmdInputWithDimmId = CatSPrint(NULL, DumpCmdsPerDimm[Index].cmd, pDimms[DimmIndex].DimmHandle);
-      PrintAndExecuteCommand(pCmdInputWithDimmId);
-    }
-    if (pDictUserPath != NULL) {
-      pCmdInputWithDimmId = CatSPrintClean(NULL, STR_DUMP_DEST, pDumpUserPath);
-      pCmdInputWithDimmId = CatSPrintClean(pCmdInputWithDimmId, WITH_DIC_OPTION, pDictUserPath, pDimms[DimmIndex].DimmHandle);
-    } else {
-      pCmdInputWithDimmId = CatSPrintClean(NULL, STR_DUMP_DEST, pDumpUserPath);
-      pCmdInputWithDimmId = CatSPrintClean(pCmdInputWithDimmId, WITHOUT_DICT_OPTION, pDimms[DimmIndex].DimmHandle);
+    if (EFI_ERROR(DumpDimmSupportInfo(pDumpUserPath, &pDimms[DimmIndex]))) {
+      Print(L"Failed to dump the support information of PMem module 0x%04x\n", pDimms[DimmIndex].DimmHandle);
     }
-    PrintAndExecuteCommand(pCmdInputWithDimmId);
-    FREE_POOL_SAFE(pCmdInputWithDimmId);
-  } //end for dimmIndex
+  }
+
+  /* A single dump of all modules fetches their FW debug logs in parallel */
+  pCmdInputWithDimmId = CatSPrintClean(NULL, STR_DUMP_DEST, pDumpUserPath);
+  if (pDictUserPath != NULL) {
+    pCmdInputWithDimmId = CatSPrintClean(pCmdInputWithDimmId, WITH_DIC_OPTION, pDictUserPath);
+  } else {
+    pCmdInputWithDimmId = CatSPrintClean(pCmdInputWithDimmId, WITHOUT_DICT_OPTION);
+  }
+  PrintAndExecuteCommand(pCmdInputWithDimmId);
 
   fclose(gOsShellParametersProtocol.StdOut);
   gOsShellParametersProtocol.StdOut = stdout;
@@ -262,6 +548,8 @@ Finish:
   FREE_POOL_SAFE(pPlatformSupportFilenameAscii);
   FREE_POOL_SAFE(pDumpUserPath);
   FREE_POOL_SAFE(pDictUserPath);
+  FREE_POOL_SAFE(pCmdInputWithDimmId);
+  FREE_POOL_SAFE(pDimms);
   NVDIMM_EXIT_I64(ReturnCode);
   return ReturnCode;
 }
@@ -0,0 +1,315 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include "ShowAddressTranslationCommand.h"
+#include "NvmDimmCli.h"
+#include "NvmInterface.h"
+#include "Debug.h"
+#include "Convert.h"
+#include <AcpiParsing.h>
+#include "os.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define DS_ROOT_PATH                        L"/AddressTranslation"
+#define DS_ADDRESS_INDEX_PATH               L"/AddressTranslation/Address[%d]"
+
+#define TRANSLATE_SPA_VAL                   L"SPA"
+#define TRANSLATE_DPA_VAL                   L"DPA"
+#define STDIN_SOURCE_VAL                    L"-"
+
+#define ADDRESS_STR                         L"Address"
+#define SPA_STR                             L"SPA"
+#define DPA_STR                             L"DPA"
+#define DIMM_HANDLE_STR                     L"DimmHandle"
+#define SOCKET_ID_STR                       L"SocketID"
+#define MEMORY_CONTROLLER_ID_STR            L"MemControllerID"
+#define CHANNEL_ID_STR                      L"ChannelID"
+#define CHANNEL_POS_STR                     L"ChannelPos"
+#define TRANSLATION_STR                     L"Translation"
+
+#define TRANSLATION_OK_STR                  L"OK"
+#define TRANSLATION_NOT_MAPPED_STR          L"NotMapped"
+#define TRANSLATION_INVALID_STR             L"InvalidInput"
+
+#define TRANSLATE_LINE_MAX                  256
+
+#define CLI_ERR_INCORRECT_VALUE_TARGET_TRANSLATE  L"Syntax Error: Incorrect value for target -translate."
+#define CLI_ERR_TRANSLATE_SOURCE            L"Error: Unable to open the address source %ls."
+#define CLI_ERR_TRANSLATE_NO_NFIT           L"Error: Failed to find the NVDIMM Firmware Interface ACPI tables."
+
+/*
+ *  PRINT LIST ATTRIBUTES
+ *  ---Address=0x...---
+ *     DimmHandle=0x0001
+ *     DPA=0x...
+ *     Translation=OK
+ */
+PRINTER_LIST_ATTRIB ShowAddressTranslationListAttributes =
+{
+ {
+    {
+      ADDRESS_STR,                                        //GROUP LEVEL TYPE
+      L"---" ADDRESS_STR L"=$(" ADDRESS_STR L")---",      //NULL or GROUP LEVEL HEADER
+      SHOW_LIST_IDENT L"%ls=%ls",                         //NULL or KEY VAL FORMAT STR
+      ADDRESS_STR                                         //NULL or IGNORE KEY LIST (K1;K2)
+    }
+  }
+};
+
+PRINTER_DATA_SET_ATTRIBS ShowAddressTranslationDataSetAttribs =
+{
+  &ShowAddressTranslationListAttributes,
+  NULL
+};
+
+/**
+  Show address translation syntax definition
+**/
+struct Command ShowAddressTranslationCommandSyntax = {
+  SHOW_VERB,                                                        //!< verb
+  {                                                                 //!< options
+    { L"", SOURCE_OPTION, L"", SOURCE_OPTION_HELP, L"File with one address per line, or - for stdin", TRUE, ValueRequired },
+    { OUTPUT_OPTION_SHORT, OUTPUT_OPTION, L"", OUTPUT_OPTION_HELP, HELP_OPTIONS_DETAILS_TEXT, FALSE, ValueRequired }
+  },
+  {                                                                 //!< targets
+    { TRANSLATE_TARGET, L"", TRANSLATE_SPA_VAL L"|" TRANSLATE_DPA_VAL, TRUE, ValueRequired }
+  },
+  {                                                                 //!< properties
+    { L"", L"", L"", FALSE, ValueOptional }
+  },
+  L"Translate system physical addresses to DIMM addresses or back", //!< help
+  ShowAddressTranslation,                                           //!< run function
+  TRUE                                                              //!< printer control supported
+};
+
+/**
+  Register syntax of show -translate
+**/
+EFI_STATUS
+RegisterShowAddressTranslationCommand(
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  NVDIMM_ENTRY();
+
+  ReturnCode = RegisterCommand(&ShowAddressTranslationCommandSyntax);
+
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Parse a single unsigned number, decimal or 0x prefixed hex
+
+  @param[in] pStr String to parse
+  @param[out] ppEnd First character after the number
+  @param[out] pValue Parsed value
+
+  @retval TRUE A number was parsed
+  @retval FALSE No number at the start of the string
+**/
+STATIC
+BOOLEAN
+ParseAddressToken(
+  IN     CHAR8 *pStr,
+     OUT CHAR8 **ppEnd,
+     OUT UINT64 *pValue
+  )
+{
+  *pValue = strtoull(pStr, ppEnd, 0);
+  return *ppEnd != pStr;
+}
+
+/**
+  Print a single translated address
+
+  @param[in] pPrinterCtx Printer context
+  @param[in] Index Index of the address in the input
+  @param[in] SpaToDpa Direction of the translation
+  @param[in] Spa System physical address
+  @param[in] DeviceHandle NFIT device handle
+  @param[in] Dpa Device physical address
+  @param[in] pStatus Result of the translation
+**/
+STATIC
+VOID
+PrintTranslatedAddress(
+  IN     PRINT_CONTEXT *pPrinterCtx,
+  IN     UINT32 Index,
+  IN     BOOLEAN SpaToDpa,
+  IN     UINT64 Spa,
+  IN     NfitDeviceHandle DeviceHandle,
+  IN     UINT64 Dpa,
+  IN     CHAR16 *pStatus
+  )
+{
+  CHAR16 *pPath = NULL;
+
+  PRINTER_BUILD_KEY_PATH(pPath, DS_ADDRESS_INDEX_PATH, Index);
+  if (SpaToDpa) {
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, ADDRESS_STR, FORMAT_UINT64_HEX_NOWIDTH, Spa);
+  } else {
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, ADDRESS_STR, FORMAT_HEX_NOWIDTH L"/" FORMAT_UINT64_HEX_NOWIDTH,
+        DeviceHandle.AsUint32, Dpa);
+  }
+  PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, TRANSLATION_STR, pStatus);
+  if (StrCmp(pStatus, TRANSLATION_OK_STR) == 0) {
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, SPA_STR, FORMAT_UINT64_HEX_NOWIDTH, Spa);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, DIMM_HANDLE_STR, FORMAT_HEX_NOWIDTH, DeviceHandle.AsUint32);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, SOCKET_ID_STR, FORMAT_HEX_NOWIDTH, DeviceHandle.NfitDeviceHandle.SocketId);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, MEMORY_CONTROLLER_ID_STR, FORMAT_HEX_NOWIDTH, DeviceHandle.NfitDeviceHandle.MemControllerId);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, CHANNEL_ID_STR, FORMAT_HEX_NOWIDTH, DeviceHandle.NfitDeviceHandle.MemChannel);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, CHANNEL_POS_STR, FORMAT_HEX_NOWIDTH, DeviceHandle.NfitDeviceHandle.DimmNumber);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, DPA_STR, FORMAT_UINT64_HEX_NOWIDTH, Dpa);
+  }
+
+  FREE_POOL_SAFE(pPath);
+}
+
+/**
+  Execute the show address translation command
+
+  The translation map is built once from the NFIT and every input line is
+  translated against it, so large batches of machine check or ARS addresses
+  cost one lookup each. With a PBR session in playback mode the recorded
+  NFIT is used, so no platform is needed.
+
+  @param[in] pCmd command from CLI
+
+  @retval EFI_SUCCESS success
+  @retval EFI_INVALID_PARAMETER pCmd is NULL or invalid command line parameters
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval EFI_NOT_FOUND the source could not be opened or no NFIT is available
+**/
+EFI_STATUS
+ShowAddressTranslation(
+  IN    struct Command *pCmd
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  EFI_STATUS TranslateReturnCode = EFI_SUCCESS;
+  EFI_DCPMM_CONFIG2_PROTOCOL *pNvmDimmConfigProtocol = NULL;
+  PRINT_CONTEXT *pPrinterCtx = NULL;
+  ParsedFitHeader *pNFit = NULL;
+  ADDRESS_TRANSLATION_MAP *pMap = NULL;
+  NvDimmRegionMappingStructure *pNvDimmRegionTable = NULL;
+  CHAR16 *pTargetValue = NULL;
+  CHAR16 *pSourcePath = NULL;
+  OS_PATH SourcePathAscii;
+  CHAR8 Line[TRANSLATE_LINE_MAX];
+  CHAR8 *pEnd = NULL;
+  FILE *hFile = NULL;
+  BOOLEAN SpaToDpa = TRUE;
+  NfitDeviceHandle DeviceHandle;
+  UINT64 Spa = 0;
+  UINT64 Dpa = 0;
+  UINT64 Value = 0;
+  UINT32 Index = 0;
+
+  NVDIMM_ENTRY();
+
+  ZeroMem(SourcePathAscii, sizeof(SourcePathAscii));
+
+  if (pCmd == NULL) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_NO_COMMAND);
+    goto Finish;
+  }
+
+  pPrinterCtx = pCmd->pPrintCtx;
+
+  pTargetValue = GetTargetValue(pCmd, TRANSLATE_TARGET);
+  if (pTargetValue != NULL && StrICmp(pTargetValue, TRANSLATE_DPA_VAL) == 0) {
+    SpaToDpa = FALSE;
+  } else if (pTargetValue == NULL || StrICmp(pTargetValue, TRANSLATE_SPA_VAL) != 0) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_INCORRECT_VALUE_TARGET_TRANSLATE);
+    goto Finish;
+  }
+
+  pSourcePath = getOptionValue(pCmd, SOURCE_OPTION);
+  if (pSourcePath == NULL) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_WRONG_FILE_PATH);
+    goto Finish;
+  }
+
+  ReturnCode = OpenNvmDimmProtocol(gNvmDimmConfigProtocolGuid, (VOID **)&pNvmDimmConfigProtocol, NULL);
+  if (EFI_ERROR(ReturnCode)) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_OPENING_CONFIG_PROTOCOL);
+    ReturnCode = EFI_NOT_FOUND;
+    goto Finish;
+  }
+
+  ReturnCode = pNvmDimmConfigProtocol->GetAcpiNFit(pNvmDimmConfigProtocol, &pNFit);
+  if (EFI_ERROR(ReturnCode) || pNFit == NULL) {
+    ReturnCode = EFI_NOT_FOUND;
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_TRANSLATE_NO_NFIT);
+    goto Finish;
+  }
+
+  ReturnCode = BuildAddressTranslationMap(pNFit, &pMap);
+  if (EFI_ERROR(ReturnCode)) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_INTERNAL_ERROR);
+    goto Finish;
+  }
+
+  if (StrCmp(pSourcePath, STDIN_SOURCE_VAL) == 0) {
+    hFile = stdin;
+  } else {
+    CHECK_RESULT(UnicodeStrToAsciiStrS(pSourcePath, SourcePathAscii, sizeof(SourcePathAscii)), Finish);
+    hFile = fopen(SourcePathAscii, "r");
+  }
+  if (hFile == NULL) {
+    ReturnCode = EFI_NOT_FOUND;
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_TRANSLATE_SOURCE, pSourcePath);
+    goto Finish;
+  }
+
+  /** SPA lines hold a single address, DPA lines a device handle and a DPA **/
+  while (fgets(Line, sizeof(Line), hFile) != NULL) {
+    pEnd = Line + strspn(Line, " \t\r\n");
+    if (*pEnd == '\0' || *pEnd == '#') {
+      continue;
+    }
+
+    Spa = 0;
+    Dpa = 0;
+    DeviceHandle.AsUint32 = 0;
+
+    if (SpaToDpa) {
+      if (!ParseAddressToken(pEnd, &pEnd, &Spa)) {
+        PrintTranslatedAddress(pPrinterCtx, Index++, SpaToDpa, Spa, DeviceHandle, Dpa, TRANSLATION_INVALID_STR);
+        continue;
+      }
+      TranslateReturnCode = TranslateSpaToDpa(pMap, Spa, &pNvDimmRegionTable, &Dpa);
+      if (!EFI_ERROR(TranslateReturnCode)) {
+        DeviceHandle = pNvDimmRegionTable->DeviceHandle;
+      }
+    } else {
+      if (!ParseAddressToken(pEnd, &pEnd, &Value) || !ParseAddressToken(pEnd, &pEnd, &Dpa) || Value > MAX_UINT32) {
+        PrintTranslatedAddress(pPrinterCtx, Index++, SpaToDpa, Spa, DeviceHandle, Dpa, TRANSLATION_INVALID_STR);
+        continue;
+      }
+      DeviceHandle.AsUint32 = (UINT32) Value;
+      TranslateReturnCode = TranslateDpaToSpa(pMap, DeviceHandle.AsUint32, Dpa, &Spa);
+    }
+
+    PrintTranslatedAddress(pPrinterCtx, Index++, SpaToDpa, Spa, DeviceHandle, Dpa,
+        EFI_ERROR(TranslateReturnCode) ? TRANSLATION_NOT_MAPPED_STR : TRANSLATION_OK_STR);
+  }
+
+  PRINTER_CONFIGURE_DATA_ATTRIBUTES(pPrinterCtx, DS_ROOT_PATH, &ShowAddressTranslationDataSetAttribs);
+
+Finish:
+  PRINTER_PROCESS_SET_BUFFER(pPrinterCtx);
+  if (hFile != NULL && hFile != stdin) {
+    fclose(hFile);
+  }
+  FreeAddressTranslationMap(&pMap);
+  FREE_POOL_SAFE(pSourcePath);
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
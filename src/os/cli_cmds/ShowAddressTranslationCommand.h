@@ -0,0 +1,42 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _SHOW_ADDRESS_TRANSLATION_COMMAND_H_
+#define _SHOW_ADDRESS_TRANSLATION_COMMAND_H_
+
+#include <Uefi.h>
+#include "NvmInterface.h"
+#include "Common.h"
+
+/**
+  Register show -translate command
+
+  @retval EFI_SUCCESS success
+  @retval EFI_ABORTED registering failure
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+**/
+EFI_STATUS
+RegisterShowAddressTranslationCommand(
+  );
+
+/**
+  Show address translation command
+
+  Reads system physical addresses, or device handle and DPA pairs, one per
+  line from a file or stdin and translates all of them against the NFIT.
+
+  @param[in] pCmd Command from CLI
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER pCmd NULL or invalid command line parameters
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+  @retval EFI_NOT_FOUND The source could not be opened or no NFIT is available
+**/
+EFI_STATUS
+ShowAddressTranslation(
+  IN    struct Command *pCmd
+  );
+
+#endif //_SHOW_ADDRESS_TRANSLATION_COMMAND_H_
@@ -0,0 +1,417 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <Library/BaseMemoryLib.h>
+#include <Library/MemoryAllocationLib.h>
+#include "ShowNamespaceImageCommand.h"
+#include "NvmDimmCli.h"
+#include "NvmInterface.h"
+#include "Debug.h"
+#include "Convert.h"
+#include <LbaCommon.h>
+#include <Namespace.h>
+#include <Btt.h>
+#include <BttLayout.h>
+#include <Pfn.h>
+#include <PfnLayout.h>
+#include "os.h"
+
+#define DS_ROOT_PATH                        L"/NamespaceImage"
+#define DS_LAYOUT_INDEX_PATH                L"/NamespaceImage/Layout[%d]"
+
+#define LAYOUT_STR                          L"Layout"
+#define IMAGE_SOURCE_STR                    L"Source"
+#define IMAGE_SIZE_STR                      L"RawSize"
+#define ARENA_ID_STR                        L"ArenaID"
+#define LBA_SIZE_STR                        L"LbaSize"
+#define EXTERNAL_NLBAS_STR                  L"ExternalNLbas"
+#define INTERNAL_LBA_SIZE_STR               L"InternalLbaSize"
+#define INTERNAL_NLBAS_STR                  L"InternalNLbas"
+#define NFREE_STR                           L"NFree"
+#define START_OFFSET_STR                    L"StartOffset"
+#define DATA_OFFSET_STR                     L"DataOffset"
+#define MAP_OFFSET_STR                      L"MapOffset"
+#define FLOG_OFFSET_STR                     L"FlogOffset"
+#define ARENA_FLAGS_STR                     L"Flags"
+#define PFN_START_PAD_STR                   L"StartPad"
+#define PFN_END_TRUNC_STR                   L"EndTrunc"
+#define PFN_NPFNS_STR                       L"Npfns"
+#define PFN_MODE_STR                        L"Mode"
+#define PFN_ALIGN_STR                       L"Align"
+#define USABLE_SIZE_STR                     L"UsableSize"
+#define CONSISTENCY_STR                     L"ConsistencyCheck"
+
+#define LAYOUT_BTT_STR                      L"BTT"
+#define LAYOUT_PFN_STR                      L"PFN"
+#define CONSISTENCY_PASSED_STR              L"Passed"
+#define CONSISTENCY_FAILED_STR              L"Failed"
+
+#define CLI_ERR_NAMESPACE_IMAGE_MAP         L"Error: Unable to map the namespace image %ls."
+#define CLI_ERR_NAMESPACE_IMAGE_NO_LAYOUT   L"Error: No BTT or PFN metadata found in the namespace image %ls."
+#define CLI_ERR_NAMESPACE_IMAGE_CORRUPTED   L"Error: The namespace image %ls failed the consistency check."
+
+/*
+ *  PRINT LIST ATTRIBUTES
+ *  ---Layout=BTT---
+ *     ArenaID=0
+ *     ExternalNLbas=...
+ *     ConsistencyCheck=Passed
+ */
+PRINTER_LIST_ATTRIB ShowNamespaceImageListAttributes =
+{
+ {
+    {
+      LAYOUT_STR,                                         //GROUP LEVEL TYPE
+      L"---" LAYOUT_STR L"=$(" LAYOUT_STR L")---",        //NULL or GROUP LEVEL HEADER
+      SHOW_LIST_IDENT L"%ls=%ls",                         //NULL or KEY VAL FORMAT STR
+      LAYOUT_STR                                          //NULL or IGNORE KEY LIST (K1;K2)
+    }
+  }
+};
+
+PRINTER_DATA_SET_ATTRIBS ShowNamespaceImageDataSetAttribs =
+{
+  &ShowNamespaceImageListAttributes,
+  NULL
+};
+
+/**
+  Show namespace image syntax definition
+**/
+struct Command ShowNamespaceImageCommandSyntax = {
+  SHOW_VERB,                                                        //!< verb
+  {                                                                 //!< options
+    { L"", SOURCE_OPTION, L"", SOURCE_OPTION_HELP, L"Namespace image file or pmem block device", TRUE, ValueRequired },
+    { OUTPUT_OPTION_SHORT, OUTPUT_OPTION, L"", OUTPUT_OPTION_HELP, HELP_OPTIONS_DETAILS_TEXT, FALSE, ValueRequired }
+  },
+  {                                                                 //!< targets
+    { NAMESPACE_IMAGE_TARGET, L"", L"", TRUE, ValueEmpty }
+  },
+  {                                                                 //!< properties
+    { L"", L"", L"", FALSE, ValueOptional }
+  },
+  L"Check and show the BTT or PFN metadata of a namespace image",   //!< help
+  ShowNamespaceImage,                                               //!< run function
+  TRUE,                                                             //!< printer control supported
+  TRUE                                                              //!< exclude driver binding, no DIMM is accessed
+};
+
+/**
+  Per arena state of the parallel BTT consistency check
+**/
+typedef struct _ARENA_CHECK_CONTEXT {
+  BTT *pBtt;
+  ARENAS *pArena;
+  UINT64 ThreadId;
+  BOOLEAN ThreadStarted;
+  EFI_STATUS ReturnCode;
+} ARENA_CHECK_CONTEXT;
+
+/**
+  Register syntax of show -namespaceimage
+**/
+EFI_STATUS
+RegisterShowNamespaceImageCommand(
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  NVDIMM_ENTRY();
+
+  ReturnCode = RegisterCommand(&ShowNamespaceImageCommandSyntax);
+
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
+
+/**
+  Thread routine checking a single BTT arena
+
+  @param[in,out] pArg Pointer to the ARENA_CHECK_CONTEXT of the arena
+**/
+STATIC
+VOID *
+CheckArenaThread(
+  IN OUT VOID *pArg
+  )
+{
+  ARENA_CHECK_CONTEXT *pContext = (ARENA_CHECK_CONTEXT *) pArg;
+
+  pContext->ReturnCode = BttCheckArena(pContext->pBtt, pContext->pArena);
+  return NULL;
+}
+
+/**
+  Look for a valid BTT info block at one of the first arena offsets
+
+  Sets the label version of the namespace according to the offset the info
+  block was found at, so BttInit() picks the same offset up.
+
+  @param[in,out] pNamespace Namespace backed by the mapped image
+  @param[out] pBttInfo Buffer for the BTT info block
+
+  @retval EFI_SUCCESS A valid BTT info block was found
+  @retval EFI_NOT_FOUND No valid BTT info block
+**/
+STATIC
+EFI_STATUS
+FindImageBttInfo(
+  IN OUT NAMESPACE *pNamespace,
+     OUT BTT_INFO *pBttInfo
+  )
+{
+  UINT64 InfoOffsets[] = { BTT_PRIMARY_INFO_BLOCK_OFFSET, BTT_PRIMARY_INFO_BLOCK_OFFSET_1_1 };
+  UINT16 InfoMinors[] = { NSINDEX_MINOR_2, NSINDEX_MINOR_1 };
+  UINT32 Index = 0;
+
+  for (Index = 0; Index < ARRAY_SIZE(InfoOffsets); Index++) {
+    if (EFI_ERROR(ReadNamespaceBytes(pNamespace, InfoOffsets[Index], pBttInfo, sizeof(BTT_INFO)))) {
+      continue;
+    }
+    if (!EFI_ERROR(BttReadInfo(pBttInfo, NULL))) {
+      pNamespace->Major = NSINDEX_MAJOR;
+      pNamespace->Minor = InfoMinors[Index];
+      return EFI_SUCCESS;
+    }
+  }
+
+  return EFI_NOT_FOUND;
+}
+
+/**
+  Load the BTT layout of the image, check all arenas in parallel and print them
+
+  @param[in] pPrinterCtx Printer context
+  @param[in,out] pNamespace Namespace backed by the mapped image
+  @param[in] pBttInfo Valid BTT info block of the first arena
+
+  @retval EFI_SUCCESS All arenas are consistent
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+  @retval EFI_VOLUME_CORRUPTED Layout could not be loaded or an arena is inconsistent
+**/
+STATIC
+EFI_STATUS
+ShowImageBtt(
+  IN     PRINT_CONTEXT *pPrinterCtx,
+  IN OUT NAMESPACE *pNamespace,
+  IN     BTT_INFO *pBttInfo
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  BTT *pBtt = NULL;
+  ARENA_CHECK_CONTEXT *pContexts = NULL;
+  ARENAS *pArena = NULL;
+  CHAR16 *pPath = NULL;
+  UINT32 Index = 0;
+
+  pBtt = BttInit(pNamespace->ImageSize, pBttInfo->ExternalLbaSize, &pBttInfo->ParentUuid, pNamespace);
+  if (pBtt == NULL || !pBtt->Laidout) {
+    ReturnCode = EFI_VOLUME_CORRUPTED;
+    goto Finish;
+  }
+
+  pContexts = AllocateZeroPool(pBtt->NArenas * sizeof(ARENA_CHECK_CONTEXT));
+  if (pContexts == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    goto Finish;
+  }
+
+  /** Arenas are independent, so each one is checked by its own thread **/
+  for (Index = 0; Index < pBtt->NArenas; Index++) {
+    pContexts[Index].pBtt = pBtt;
+    pContexts[Index].pArena = &pBtt->Arenas[Index];
+    pContexts[Index].ThreadStarted =
+      (0 == os_create_thread(&pContexts[Index].ThreadId, CheckArenaThread, &pContexts[Index]));
+    if (!pContexts[Index].ThreadStarted) {
+      // Check the arena here rather than reporting an unchecked one
+      CheckArenaThread(&pContexts[Index]);
+    }
+  }
+
+  for (Index = 0; Index < pBtt->NArenas; Index++) {
+    if (pContexts[Index].ThreadStarted) {
+      os_join_thread(pContexts[Index].ThreadId);
+    }
+  }
+
+  for (Index = 0; Index < pBtt->NArenas; Index++) {
+    pArena = pContexts[Index].pArena;
+    PRINTER_BUILD_KEY_PATH(pPath, DS_LAYOUT_INDEX_PATH, Index);
+    PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, LAYOUT_STR, LAYOUT_BTT_STR);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, ARENA_ID_STR, FORMAT_UINT32, Index);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, LBA_SIZE_STR, FORMAT_UINT32, pBtt->LbaSize);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, EXTERNAL_NLBAS_STR, FORMAT_UINT32, pArena->ExternalNLbas);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, INTERNAL_LBA_SIZE_STR, FORMAT_UINT32, pArena->InternalLbaSize);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, INTERNAL_NLBAS_STR, FORMAT_UINT32, pArena->InternalNLbas);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, NFREE_STR, FORMAT_UINT32, pBtt->NFree);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, START_OFFSET_STR, FORMAT_UINT64_HEX_NOWIDTH, pArena->StartOffset);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, DATA_OFFSET_STR, FORMAT_UINT64_HEX_NOWIDTH, pArena->DataOffset);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, MAP_OFFSET_STR, FORMAT_UINT64_HEX_NOWIDTH, pArena->MapOffset);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, FLOG_OFFSET_STR, FORMAT_UINT64_HEX_NOWIDTH, pArena->FlogOffset);
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, ARENA_FLAGS_STR, FORMAT_HEX_NOWIDTH, pArena->Flags);
+    if (EFI_ERROR(pContexts[Index].ReturnCode)) {
+      PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, CONSISTENCY_STR, CONSISTENCY_FAILED_STR);
+      ReturnCode = EFI_VOLUME_CORRUPTED;
+    } else {
+      PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, CONSISTENCY_STR, CONSISTENCY_PASSED_STR);
+    }
+  }
+
+Finish:
+  FREE_POOL_SAFE(pPath);
+  FREE_POOL_SAFE(pContexts);
+  if (pBtt != NULL) {
+    BttRelease(pBtt);
+  }
+  return ReturnCode;
+}
+
+/**
+  Load the PFN metadata of the image and print it
+
+  @param[in] pPrinterCtx Printer context
+  @param[in,out] pNamespace Namespace backed by the mapped image
+  @param[in] pPfnInfo Valid PFN info block
+
+  @retval EFI_SUCCESS The PFN metadata is consistent
+  @retval EFI_VOLUME_CORRUPTED The PFN metadata describes more data than the image holds
+  @retval Other errors returned by PfnInit
+**/
+STATIC
+EFI_STATUS
+ShowImagePfn(
+  IN     PRINT_CONTEXT *pPrinterCtx,
+  IN OUT NAMESPACE *pNamespace,
+  IN     PFN_INFO *pPfnInfo
+  )
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  CHAR16 *pPath = NULL;
+  UINT64 MetadataSize = 0;
+
+  ReturnCode = PfnInit(pNamespace->ImageSize, (UINT32) pNamespace->Media.BlockSize, &pPfnInfo->ParentUuid, pNamespace);
+  if (EFI_ERROR(ReturnCode)) {
+    goto Finish;
+  }
+
+  MetadataSize = (UINT64) pPfnInfo->StartPad + pPfnInfo->EndTrunc + pPfnInfo->DataOff;
+
+  PRINTER_BUILD_KEY_PATH(pPath, DS_LAYOUT_INDEX_PATH, 0);
+  PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, LAYOUT_STR, LAYOUT_PFN_STR);
+  PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, DATA_OFFSET_STR, FORMAT_UINT64_HEX_NOWIDTH, pPfnInfo->DataOff);
+  PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, PFN_START_PAD_STR, FORMAT_HEX_NOWIDTH, pPfnInfo->StartPad);
+  PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, PFN_END_TRUNC_STR, FORMAT_HEX_NOWIDTH, pPfnInfo->EndTrunc);
+  PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, PFN_NPFNS_STR, FORMAT_UINT64, pPfnInfo->Npfns);
+  PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, PFN_MODE_STR, FORMAT_UINT32, pPfnInfo->Mode);
+  PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, PFN_ALIGN_STR, FORMAT_HEX_NOWIDTH, pPfnInfo->Align);
+  if (MetadataSize > pNamespace->ImageSize) {
+    PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, CONSISTENCY_STR, CONSISTENCY_FAILED_STR);
+    ReturnCode = EFI_VOLUME_CORRUPTED;
+  } else {
+    PRINTER_SET_KEY_VAL_WIDE_STR_FORMAT(pPrinterCtx, pPath, USABLE_SIZE_STR, FORMAT_UINT64, pNamespace->UsableSize);
+    PRINTER_SET_KEY_VAL_WIDE_STR(pPrinterCtx, pPath, CONSISTENCY_STR, CONSISTENCY_PASSED_STR);
+  }
+
+Finish:
+  FREE_POOL_SAFE(pPath);
+  FREE_POOL_SAFE(pNamespace->pPfn);
+  return ReturnCode;
+}
+
+/**
+  Execute the show namespace image command
+
+  @param[in] pCmd command from CLI
+
+  @retval EFI_SUCCESS success
+  @retval EFI_INVALID_PARAMETER pCmd is NULL or invalid command line parameters
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+  @retval EFI_NOT_FOUND no BTT or PFN metadata found in the image
+  @retval EFI_VOLUME_CORRUPTED the metadata failed the consistency check
+**/
+EFI_STATUS
+ShowNamespaceImage(
+  IN    struct Command *pCmd
+  )
+{
+  EFI_STATUS ReturnCode = EFI_INVALID_PARAMETER;
+  PRINT_CONTEXT *pPrinterCtx = NULL;
+  CHAR16 *pSourcePath = NULL;
+  OS_PATH SourcePathAscii;
+  NAMESPACE *pNamespace = NULL;
+  BTT_INFO *pBttInfo = NULL;
+  PFN_INFO *pPfnInfo = NULL;
+
+  NVDIMM_ENTRY();
+
+  ZeroMem(SourcePathAscii, sizeof(SourcePathAscii));
+
+  if (pCmd == NULL) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_NO_COMMAND);
+    goto Finish;
+  }
+
+  pPrinterCtx = pCmd->pPrintCtx;
+
+  pSourcePath = getOptionValue(pCmd, SOURCE_OPTION);
+  if (pSourcePath == NULL) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_WRONG_FILE_PATH);
+    goto Finish;
+  }
+
+  CHECK_RESULT(UnicodeStrToAsciiStrS(pSourcePath, SourcePathAscii, sizeof(SourcePathAscii)), Finish);
+
+  pNamespace = AllocateZeroPool(sizeof(NAMESPACE));
+  pBttInfo = AllocateZeroPool(sizeof(BTT_INFO));
+  pPfnInfo = AllocateZeroPool(sizeof(PFN_INFO));
+  if (pNamespace == NULL || pBttInfo == NULL || pPfnInfo == NULL) {
+    ReturnCode = EFI_OUT_OF_RESOURCES;
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_OUT_OF_MEMORY);
+    goto Finish;
+  }
+
+  /**
+    The image is mapped copy-on-write, so any recovery done while loading
+    the layout stays in memory and the image itself is never modified.
+  **/
+  pNamespace->pImage = os_map_file(SourcePathAscii, &pNamespace->ImageSize);
+  if (pNamespace->pImage == NULL) {
+    ReturnCode = EFI_NOT_FOUND;
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_NAMESPACE_IMAGE_MAP, pSourcePath);
+    goto Finish;
+  }
+  pNamespace->Media.BlockSize = 1;
+  pNamespace->BlockSize = 1;
+  pNamespace->BlockCount = pNamespace->ImageSize;
+
+  if (!EFI_ERROR(FindImageBttInfo(pNamespace, pBttInfo))) {
+    ReturnCode = ShowImageBtt(pPrinterCtx, pNamespace, pBttInfo);
+  } else if (!EFI_ERROR(ReadNamespaceBytes(pNamespace, PFN_INFO_BLOCK_OFFSET, pPfnInfo, sizeof(PFN_INFO))) &&
+      !EFI_ERROR(PfnValidateInfo(pPfnInfo, NULL))) {
+    ReturnCode = ShowImagePfn(pPrinterCtx, pNamespace, pPfnInfo);
+  } else {
+    ReturnCode = EFI_NOT_FOUND;
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_NAMESPACE_IMAGE_NO_LAYOUT, pSourcePath);
+    goto Finish;
+  }
+
+  if (ReturnCode == EFI_VOLUME_CORRUPTED) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_NAMESPACE_IMAGE_CORRUPTED, pSourcePath);
+  } else if (EFI_ERROR(ReturnCode)) {
+    PRINTER_SET_MSG(pPrinterCtx, ReturnCode, CLI_ERR_INTERNAL_ERROR);
+  }
+
+  PRINTER_CONFIGURE_DATA_ATTRIBUTES(pPrinterCtx, DS_ROOT_PATH, &ShowNamespaceImageDataSetAttribs);
+
+Finish:
+  PRINTER_PROCESS_SET_BUFFER(pPrinterCtx);
+  if (pNamespace != NULL && pNamespace->pImage != NULL) {
+    os_unmap_file(pNamespace->pImage, pNamespace->ImageSize);
+  }
+  FREE_POOL_SAFE(pSourcePath);
+  FREE_POOL_SAFE(pNamespace);
+  FREE_POOL_SAFE(pBttInfo);
+  FREE_POOL_SAFE(pPfnInfo);
+  NVDIMM_EXIT_I64(ReturnCode);
+  return ReturnCode;
+}
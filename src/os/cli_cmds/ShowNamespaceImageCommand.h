@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _SHOW_NAMESPACE_IMAGE_COMMAND_H_
+#define _SHOW_NAMESPACE_IMAGE_COMMAND_H_
+
+#include <Uefi.h>
+#include "NvmInterface.h"
+#include "Common.h"
+
+/**
+  Register show -namespaceimage command
+
+  @retval EFI_SUCCESS success
+  @retval EFI_ABORTED registering failure
+  @retval EFI_OUT_OF_RESOURCES memory allocation failure
+**/
+EFI_STATUS
+RegisterShowNamespaceImageCommand(
+  );
+
+/**
+  Show namespace image command
+
+  Maps a raw namespace image or a pmem block device, detects the BTT or PFN
+  metadata stored in it and checks its consistency without touching any DIMM.
+
+  @param[in] pCmd Command from CLI
+
+  @retval EFI_SUCCESS Success
+  @retval EFI_INVALID_PARAMETER pCmd NULL or invalid command line parameters
+  @retval EFI_OUT_OF_RESOURCES Memory allocation failure
+  @retval EFI_NOT_FOUND No BTT or PFN metadata found in the image
+  @retval EFI_VOLUME_CORRUPTED The metadata failed the consistency check
+**/
+EFI_STATUS
+ShowNamespaceImage(
+  IN    struct Command *pCmd
+  );
+
+#endif //_SHOW_NAMESPACE_IMAGE_COMMAND_H_
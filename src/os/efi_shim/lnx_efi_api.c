@@ -27,7 +27,6 @@ extern UINT8 gSmbiosMinorVersion;
 extern UINT8 gSmbiosMajorVersion;
 
 
-extern int get_acpi_table(const char *signature, struct acpi_table *p_table, const unsigned int size);
 
 /**
 Gets the current timestamp in terms of milliseconds
@@ -133,19 +132,13 @@ get_table(
 
   *table = NULL;
 
-  int buf_size = get_acpi_table(currentTableName, NULL, 0);
+  int buf_size = get_acpi_table_alloc(currentTableName, (struct acpi_table **)table);
   if (buf_size <= 0)
   {
     return EFI_END_OF_FILE;
   }
 
-  *table = AllocatePool(buf_size);
-  if (NULL == *table)
-  {
-    return EFI_END_OF_FILE;
-  }
   *tablesize = (UINT32)buf_size;
-  get_acpi_table(currentTableName, (struct acpi_table*)*table, buf_size);
   return EFI_SUCCESS;
 }
 
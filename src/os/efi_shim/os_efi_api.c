@@ -20,6 +20,7 @@
 #include <Convert.h>
 #include <Dimm.h>
 #include <NvmDimmDriver.h>
+#include <SmbiosUtility.h>
 #include <Common.h>
 #include <wchar.h>
 #ifdef _MSC_VER
@@ -155,6 +156,79 @@ DefaultPassThru(
 }
 
 
+/**
+  Raw ACPI table read from the OS once per process. The cache owns the buffer
+  and hands out read-only views, so repeated driver binding starts in the same
+  process don't go back to the OS for the tables.
+**/
+typedef struct _ACPI_TABLE_CACHE_ENTRY {
+  BOOLEAN Loaded;
+  EFI_STATUS ReturnCode;
+  EFI_ACPI_DESCRIPTION_HEADER *pTable;
+  UINT32 Size;
+} ACPI_TABLE_CACHE_ENTRY;
+
+typedef EFI_STATUS (*GET_ACPI_TABLE_FUNC)(EFI_ACPI_DESCRIPTION_HEADER **ppTable, UINT32 *pSize);
+
+enum {
+  ACPI_TABLE_CACHE_NFIT = 0,
+  ACPI_TABLE_CACHE_PCAT,
+  ACPI_TABLE_CACHE_PMTT,
+  ACPI_TABLE_CACHE_MAX
+};
+
+STATIC ACPI_TABLE_CACHE_ENTRY gAcpiTableCache[ACPI_TABLE_CACHE_MAX];
+
+/**
+  Get a view of an ACPI table, loading it on first use
+
+  @param[in] CacheIndex Index of the table in the cache
+  @param[in] GetTable OS specific function reading the table
+  @param[out] ppTable View of the table, must not be freed by the caller
+  @param[out] pSize Size of the table
+
+  @retval EFI_SUCCESS The table is available
+  @retval Other errors returned by GetTable, the next call tries to load the table again
+**/
+STATIC
+EFI_STATUS
+GetCachedAcpiTable(
+  IN     UINT32 CacheIndex,
+  IN     GET_ACPI_TABLE_FUNC GetTable,
+     OUT EFI_ACPI_DESCRIPTION_HEADER **ppTable,
+     OUT UINT32 *pSize
+)
+{
+  ACPI_TABLE_CACHE_ENTRY *pEntry = &gAcpiTableCache[CacheIndex];
+
+  if (!pEntry->Loaded) {
+    pEntry->ReturnCode = GetTable(&pEntry->pTable, &pEntry->Size);
+    if (EFI_ERROR(pEntry->ReturnCode)) {
+      // Not cached, a transient failure must not outlive this call
+      FREE_POOL_SAFE(pEntry->pTable);
+      pEntry->Size = 0;
+    } else {
+      pEntry->Loaded = TRUE;
+    }
+  }
+
+  *ppTable = pEntry->pTable;
+  *pSize = pEntry->Size;
+  return pEntry->ReturnCode;
+}
+
+VOID
+InvalidateAcpiTableCache(
+)
+{
+  UINT32 Index;
+
+  for (Index = 0; Index < ACPI_TABLE_CACHE_MAX; Index++) {
+    FREE_POOL_SAFE(gAcpiTableCache[Index].pTable);
+    ZeroMem(&gAcpiTableCache[Index], sizeof(gAcpiTableCache[Index]));
+  }
+}
+
 EFI_STATUS
 initAcpiTables()
 {
@@ -188,7 +262,7 @@ initAcpiTables()
   }
   else
   {
-    if (EFI_ERROR(get_nfit_table(&PtrNfitTable, &Size)))
+    if (EFI_ERROR(GetCachedAcpiTable(ACPI_TABLE_CACHE_NFIT, get_nfit_table, &PtrNfitTable, &Size)))
     {
       NVDIMM_WARN("Failed to get the NFIT table.\n");
       failures++;
@@ -203,7 +277,7 @@ initAcpiTables()
       }
     }
 
-    if (EFI_ERROR(get_pcat_table(&PtrPcatTable, &Size)))
+    if (EFI_ERROR(GetCachedAcpiTable(ACPI_TABLE_CACHE_PCAT, get_pcat_table, &PtrPcatTable, &Size)))
     {
       NVDIMM_WARN("Failed to get the PCAT table.\n");
       failures++;
@@ -218,7 +292,7 @@ initAcpiTables()
       }
     }
 
-    if (EFI_ERROR(get_pmtt_table(&PtrPMTTTable, &Size)))
+    if (EFI_ERROR(GetCachedAcpiTable(ACPI_TABLE_CACHE_PMTT, get_pmtt_table, &PtrPMTTTable, &Size)))
     {
       NVDIMM_WARN("Failed to get the PMTT table.\n");
       //failures++; //table allowed to be empty. Not a failure
@@ -258,11 +332,7 @@ initAcpiTables()
   }
 
 Finish:
-  if (PBR_PLAYBACK_MODE != PBR_GET_MODE(pContext)) {
-    FREE_POOL_SAFE(PtrNfitTable);
-    FREE_POOL_SAFE(PtrPcatTable);
-    FREE_POOL_SAFE(PtrPMTTTable);
-  }
+  // The tables are views into the PBR buffer or the process wide table cache
   return ReturnCode;
 }
 
@@ -295,6 +365,8 @@ GetFirstAndBoundSmBiosStructPointer(
   // One time initialization
   if (NULL == gSmbiosTable && PBR_PLAYBACK_MODE != PBR_GET_MODE(pContext))
   {
+    // A fresh table may reuse the address of the one the index was built for
+    FreeSmbiosIndex();
     get_smbios_table();
   }
 
@@ -351,6 +423,7 @@ GetFirstAndBoundSmBiosStructPointer(
         else
         {
           CopyMem(gSmbiosTable, recording->table, recording->size);
+          FreeSmbiosIndex();
         }
 
         gSmbiosMajorVersion = recording->major;
@@ -141,6 +141,15 @@ UINT32
 get_smbios_table(
 );
 
+/**
+Drops the ACPI tables read from the OS, the next driver binding start
+reads them again. The parsed tables of a bound driver must not point
+into the dropped tables.
+**/
+VOID
+InvalidateAcpiTableCache(
+);
+
 /**
 
 provides os-specific passthru functionality which also applies
@@ -42,7 +42,6 @@ EFI_SHELL_PARAMETERS_PROTOCOL gOsShellParametersProtocol;
 EFI_SHELL_PARAMETERS_PROTOCOL *gEfiShellParametersProtocol = &gOsShellParametersProtocol;
 
 int g_fast_path = 0;
-int g_file_io = 0;
 
 static BOOLEAN g_verbose_debug_print_enabled = FALSE;
 
@@ -55,12 +54,6 @@ typedef enum {
 RecordingDirMode g_rec_file_creation_mode = DefaultMode;
 
 
-#define STR_DASH_OUTPUT_SHORT   "-o"
-#define STR_DASH_OUTPUT_LONG    "-output"
-#define STR_NVMXML              "nvmxml"
-#define STR_ESXXML              "esx"
-#define STR_ESXTABLE            "esxtable"
-#define STR_TEXT                "text"
 #define STR_DASH_VERBOSE_LONG   "-verbose"
 #define STR_DASH_VERBOSE_SHORT  "-v"
 #define STR_DASH_FAST_LONG      "-fast"
@@ -68,7 +61,6 @@ RecordingDirMode g_rec_file_creation_mode = DefaultMode;
 
 EFI_STATUS init_protocol_shell_parameters_protocol(int argc, char *argv[])
 {
-  char *p_tok_context = NULL;
   int new_argv_index = 1;
   int stripped_args = 0;
   VOID * ptr = NULL;
@@ -89,27 +81,7 @@ EFI_STATUS init_protocol_shell_parameters_protocol(int argc, char *argv[])
 
   for (int Index = 1; Index < argc; Index++) {
     stripped_args = 0;
-    if ((0 == s_strncmpi(argv[Index], STR_DASH_OUTPUT_SHORT, strlen(STR_DASH_OUTPUT_SHORT) + 1) ||
-      0 == s_strncmpi(argv[Index], STR_DASH_OUTPUT_LONG, strlen(STR_DASH_OUTPUT_LONG + 1))) &&
-      Index + 1 != argc)
-    {
-      char *tok;
-      tok = os_strtok(argv[Index + 1], ",", &p_tok_context);
-
-      while (tok)
-      {
-        if (0 == s_strncmpi(tok, STR_NVMXML, strlen(STR_NVMXML) + 1) ||
-          0 == s_strncmpi(tok, STR_ESXXML, strlen(STR_ESXXML) + 1) ||
-          0 == s_strncmpi(tok, STR_ESXTABLE, strlen(STR_ESXTABLE) + 1))
-        {
-          g_file_io = 1;
-          gOsShellParametersProtocol.StdOut = fopen("output.tmp", "w+");
-        }
-
-        tok = os_strtok(NULL, ",", &p_tok_context);
-      }
-    }
-    else if (0 == s_strncmpi(argv[Index], STR_DASH_FAST_LONG, strlen(STR_DASH_FAST_LONG) + 1))
+    if (0 == s_strncmpi(argv[Index], STR_DASH_FAST_LONG, strlen(STR_DASH_FAST_LONG) + 1))
     {
       --gOsShellParametersProtocol.Argc;
       g_fast_path = 1;
@@ -155,8 +127,6 @@ Final:
 int uninit_protocol_shell_parameters_protocol()
 {
   int Index = 0;
-  if (g_file_io)
-    fclose(gOsShellParametersProtocol.StdOut);
 
   for (Index = 0; Index < gOsShellParametersProtocol.Argc; ++Index)
   {
@@ -169,7 +139,9 @@ int uninit_protocol_shell_parameters_protocol()
   if (NULL != gOsShellParametersProtocol.Argv)
   {
     FreePool(gOsShellParametersProtocol.Argv);
+    gOsShellParametersProtocol.Argv = NULL;
   }
+  gOsShellParametersProtocol.Argc = 0;
   return EFI_SUCCESS;
 }
 
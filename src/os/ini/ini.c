@@ -105,38 +105,98 @@ inline static int nvm_set_value(char **pp_dest_val, const char *p_src_val, size_
   return -1;
 }
 
+/**
+@brief Check if the dictionary entry has the looked up key
+*/
+static BOOLEAN nvm_ini_key_matching(VOID *p_item, CONST VOID *p_key)
+{
+  return 0 == strcmp((const char *)p_key, ((dictionary *)p_item)->p_key);
+}
+
+/**
+@brief Build the hash index of the keyed entries, kept in the first entry.
+When the allocation fails the lookups walk the list.
+*/
+static void nvm_ini_build_index(dictionary *p_dictionary)
+{
+  dictionary *p_entry = NULL;
+  unsigned int keys_num = 0;
+
+  if ((NULL == p_dictionary) || (NULL != p_dictionary->index.ppSlots)) {
+    return;
+  }
+
+  for (p_entry = p_dictionary; p_entry; p_entry = p_entry->p_next) {
+    if (p_entry->p_key) {
+      keys_num++;
+    }
+  }
+
+  if (EFI_ERROR(HashIndexInit(&p_dictionary->index, keys_num))) {
+    return;
+  }
+
+  // Inserting in the file order keeps the first entry of a duplicated key first in its probe sequence
+  for (p_entry = p_dictionary; p_entry; p_entry = p_entry->p_next) {
+    if (NULL != p_entry->p_key) {
+      HashIndexInsert(&p_dictionary->index, HashAsciiStr(p_entry->p_key), p_entry);
+    }
+  }
+}
+
+/**
+@brief Find the entry of the key in the dictionary
+*/
+static dictionary * nvm_ini_find_entry(dictionary *p_dictionary, const char *p_key)
+{
+  dictionary *p_entry = NULL;
+
+  if (NULL != p_dictionary->index.ppSlots) {
+    return (dictionary *)HashIndexFind(&p_dictionary->index, HashAsciiStr(p_key), nvm_ini_key_matching, p_key);
+  }
+
+  for (p_entry = p_dictionary; p_entry; p_entry = p_entry->p_next) {
+    if (p_entry->p_key && (0 == strcmp(p_key, p_entry->p_key))) {
+      return p_entry;
+    }
+  }
+  return NULL;
+}
+
 /**
 @brief Find the key in the dictionary and reuturn the value
 */
 inline static const char * nvm_dictionary_get_set_value(dictionary *p_dict, const char *p_key, const char *p_value)
 {
-  size_t string_size;
+  dictionary *p_entry = NULL;
+  char *p_old_value = NULL;
 
   if ((NULL == p_key) || (NULL == p_dict)) {
     return NULL;
   }
-  while (p_dict) {
-    string_size = (size_t)(strlen(p_key));
-    if (p_dict->p_key && (0 == strncmp(p_key, p_dict->p_key, string_size))) {
-      if (NULL == p_value) {
-        // Get function call
-        return p_dict->p_value;
-      }
-      else {
-        // Set function call
-        string_size = (size_t)(strlen(p_value));
-        if (0 == nvm_set_value(&p_dict->p_value, p_value, string_size)) {
-          // Value set successfully
-          return p_dict->p_value;
-        }
-        return NULL;
-      }
-    }
-    else {
-      p_dict = p_dict->p_next;
-    }
+  p_entry = nvm_ini_find_entry(p_dict, p_key);
+  if (NULL == p_entry) {
+    return NULL;
   }
-  return NULL;
+  if (NULL == p_value) {
+    // Get function call
+    return p_entry->p_value;
+  }
+
+  // Set function call
+  p_old_value = p_entry->p_value;
+  p_entry->p_value = NULL;
+  if (0 != nvm_set_value(&p_entry->p_value, p_value, strlen(p_value))) {
+    p_entry->p_value = p_old_value;
+    return NULL;
+  }
+  // Only a changed value makes the file to be written back
+  if ((NULL == p_old_value) || (0 != strcmp(p_old_value, p_entry->p_value))) {
+    p_entry->modified = 1;
+  }
+  NVM_INI_FREE(p_old_value);
+  // Value set successfully
+  return p_entry->p_value;
 }
 
 /**
@@ -351,6 +411,8 @@ Finish:
     fclose(h_file);
   }
 
+  nvm_ini_build_index(*pp_dictionary);
+
   return *pp_dictionary;
 }
 
@@ -364,6 +426,9 @@ void nvm_ini_free_dictionary(dictionary *p_dictionary)
   dictionary *p_current_entry = p_dictionary;
   dictionary *p_previous_entry;
 
+  if (p_dictionary) {
+    HashIndexFree(&p_dictionary->index);
+  }
   while (p_current_entry) {
     NVM_INI_FREE(p_current_entry->p_key);
     NVM_INI_FREE(p_current_entry->p_value);
@@ -432,66 +497,139 @@ int nvm_ini_set_value(dictionary *p_dictionary, const char *p_key, const char *p
 }
 
 /**
-@brief    Dump the dictionary to the file
+@brief Serialize the dictionary to a newly allocated buffer, NULL on error
+*/
+static char * nvm_ini_serialize(dictionary *p_dictionary, size_t *p_size)
+{
+  dictionary *p_entry = NULL;
+  char *p_buffer = NULL;
+  size_t buffer_size = 1;
+  size_t offset = 0;
+
+  // Space for the strings and the " = ", " # " and new line separators
+  for (p_entry = p_dictionary; p_entry; p_entry = p_entry->p_next) {
+    buffer_size += (p_entry->p_key ? strlen(p_entry->p_key) : 0) +
+      (p_entry->p_value ? strlen(p_entry->p_value) : 0) +
+      (p_entry->p_comment ? strlen(p_entry->p_comment) : 0) + 7;
+  }
+  p_buffer = (char *)malloc(buffer_size);
+  if (NULL == p_buffer) {
+    return NULL;
+  }
+
+  for (p_entry = p_dictionary; p_entry; p_entry = p_entry->p_next) {
+    if (p_entry->p_key && p_entry->p_value && p_entry->p_comment) {
+      offset += snprintf(p_buffer + offset, buffer_size - offset, "%s = %s # %s\n", p_entry->p_key, p_entry->p_value, p_entry->p_comment);
+    }
+    else if (p_entry->p_key && p_entry->p_value) {
+      offset += snprintf(p_buffer + offset, buffer_size - offset, "%s = %s\n", p_entry->p_key, p_entry->p_value);
+    }
+    else if (p_entry->p_comment) {
+      offset += snprintf(p_buffer + offset, buffer_size - offset, "# %s\n", p_entry->p_comment);
+    }
+    else {
+      offset += snprintf(p_buffer + offset, buffer_size - offset, "\n");
+    }
+  }
+
+  *p_size = offset;
+  return p_buffer;
+}
+
+/**
+@brief    Dump the modified values of the dictionary to the file
 @param    p_dictionary Pointer to the dictionary
 @param    p_ini_file_name Pointer to the name of the ini file to read
+@param    force_file_update Create the file in the install path if it does not exist
 @return   int 0 if Ok, -1 otherwise
 */
 int nvm_ini_dump_to_file(dictionary *p_dictionary, const char *p_ini_file_name, int force_file_update)
 {
   FILE *h_file;
   NVM_INI_FILENAME ini_path_filename = { 0 };
+  dictionary *p_entry = NULL;
+  dictionary *p_file_dictionary = NULL;
+  dictionary *p_output_dictionary = NULL;
+  void *p_lock = NULL;
+  char *p_buffer = NULL;
+  size_t buffer_size = 0;
+  BOOLEAN modified = FALSE;
+  int rc = -1;
 
   // Check inputs
   if ((NULL == p_dictionary) || (NULL == p_ini_file_name)) {
     return -1;
   }
 
+  for (p_entry = p_dictionary; p_entry; p_entry = p_entry->p_next) {
+    if (p_entry->modified) {
+      modified = TRUE;
+      break;
+    }
+  }
+
   // nothing to do if no entries or no modified values
-  if (p_dictionary->numb_of_entries == 0) {
+  if ((p_dictionary->numb_of_entries == 0) || (FALSE == modified)) {
     return 0;
   }
 
-  // Open and truncated the file
-  // Try to open the file
+  // Find the file to update, it is replaced as a whole so it is only opened to check it is writable
   snprintf(ini_path_filename, sizeof(ini_path_filename), "%s", p_ini_file_name);
-  h_file = fopen(ini_path_filename, "r");
-  if ((NULL == h_file) || (NULL == (h_file = freopen(ini_path_filename, "w", h_file)))) {
+  h_file = fopen(ini_path_filename, "r+");
+  if (NULL == h_file) {
     if (force_file_update) {
       snprintf(ini_path_filename, sizeof(ini_path_filename), "%s%s", APP_DATA_FILE_PATH, INI_INSTALL_FILEPATH);
       os_mkdir(ini_path_filename);
       snprintf(ini_path_filename, sizeof(ini_path_filename), "%s%s%s", APP_DATA_FILE_PATH, INI_INSTALL_FILEPATH, p_ini_file_name);
-      h_file = fopen(ini_path_filename, "w");
     }
     else {
       snprintf(ini_path_filename, sizeof(ini_path_filename), "%s%s%s", APP_DATA_FILE_PATH, INI_INSTALL_FILEPATH, p_ini_file_name);
-      h_file = fopen(ini_path_filename, "r");
-    }
-    if ((NULL == h_file) || (NULL == (h_file = freopen(ini_path_filename, "w", h_file)))) {
-      // Hardcoded data used, nothing to save
-      return -1;
+      h_file = fopen(ini_path_filename, "r+");
+      if (NULL == h_file) {
+        // Hardcoded data used, nothing to save
+        return -1;
+      }
     }
   }
+  if (NULL != h_file) {
+    fclose(h_file);
+  }
 
-  // Copy the dictionary to the file
-  while (p_dictionary) {
-    if (p_dictionary->p_key && p_dictionary->p_value && p_dictionary->p_comment) {
-      fprintf(h_file, "%s = %s # %s\n", p_dictionary->p_key, p_dictionary->p_value, p_dictionary->p_comment);
-    }
-    else if (p_dictionary->p_key && p_dictionary->p_value) {
-      fprintf(h_file, "%s = %s\n", p_dictionary->p_key, p_dictionary->p_value);
-    }
-    else if (p_dictionary->p_comment) {
-      fprintf(h_file, "# %s\n", p_dictionary->p_comment);
+  // Serialize the writers of all the processes
+  p_lock = os_lock_file(ini_path_filename);
+  if (NULL == p_lock) {
+    return -1;
+  }
+
+  // Another process may have updated the file since it was loaded here,
+  // so only the values modified by this process are applied on top of it
+  p_output_dictionary = nvm_ini_load_dictionary(&p_file_dictionary, ini_path_filename);
+  if (NULL == p_output_dictionary) {
+    p_output_dictionary = p_dictionary;
+  }
+  else {
+    for (p_entry = p_dictionary; p_entry; p_entry = p_entry->p_next) {
+      if (p_entry->modified && p_entry->p_key && p_entry->p_value) {
+        nvm_dictionary_get_set_value(p_output_dictionary, p_entry->p_key, p_entry->p_value);
+      }
     }
-    else {
-      fprintf(h_file, "\n");
+  }
+
+  p_buffer = nvm_ini_serialize(p_output_dictionary, &buffer_size);
+  if (NULL != p_buffer) {
+    rc = os_replace_file(ini_path_filename, p_buffer, buffer_size);
+  }
+
+  os_unlock_file(p_lock);
+
+  if (0 == rc) {
+    for (p_entry = p_dictionary; p_entry; p_entry = p_entry->p_next) {
+      p_entry->modified = 0;
     }
-    p_dictionary = p_dictionary->p_next;
   }
 
-  // Close the file
-  fclose(h_file);
+  NVM_INI_FREE(p_buffer);
+  nvm_ini_free_dictionary(p_file_dictionary);
 
-  return 0;
+  return rc;
 }
@@ -11,6 +11,7 @@
 #define _INI_H_
 
 #include <export_api.h>
+#include <HashIndex.h>
 
 /**
 @brief Ini dictionary main object, contains all values and keys stored
@@ -22,6 +23,8 @@ typedef struct _dictionary {
   char                *p_value;         // Pointer to string - value
   char                *p_key;           // Pointer to string - key
   char                *p_comment;       // Pointer to string - comment
+  int                 modified;         // Value changed since it was loaded or saved
+  HASH_INDEX          index;            // Hash index of the keyed entries, first entry only
 } dictionary;
 
 /**
@@ -67,9 +70,14 @@ NVM_API const char * nvm_ini_get_string(dictionary *p_dictionary, const char *p_
 NVM_API int nvm_ini_set_value(dictionary *p_dictionary, const char *p_key, const char *p_value);
 
 /**
-@brief    Dump the dictionary to the file
+@brief    Dump the modified values of the dictionary to the file
+          Nothing is written when no value was modified. The values are merged
+          into the current file content under an advisory lock and the file is
+          replaced atomically, so concurrent processes or a crash never leave
+          a truncated file.
 @param    p_dictionary Pointer to the dictionary
 @param    p_filename Pointer to the file name
+@param    force_file_update Create the file in the install path if it does not exist
 @return   int 0 if Ok, -1 otherwise
 */
 NVM_API int nvm_ini_dump_to_file(dictionary *p_dictionary, const char *p_filename, int force_file_update);
@@ -42,6 +42,11 @@
 "# The other values will be ignored and won't affect the large payload access\n"
 "LARGE_PAYLOAD_DISABLED = 1\n"
 "\n"
+"# SMART and health snapshot lifetime in milliseconds\n"
+"# If the value equals 0 each PMem module is read once per command or API call\n"
+"# Other values keep the snapshot for the given time across commands\n"
+"SMART_SNAPSHOT_TTL_MS = 0\n"
+"\n"
 "# Application temporary files path configuration\n"
 "# The app is going to use the path to store various files required\n"
 "# during the execution\n"
@@ -13,6 +13,7 @@
 #include <unistd.h>
 #include <limits.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <os_str.h>
 
 #define	SYSFS_ACPI_PATH	"/sys/firmware/acpi/tables/"
@@ -160,3 +161,74 @@ int get_acpi_table(
 
 	return rc;
 }
+
+/*!
+ * Read the specified ACPI table into a newly allocated buffer
+ * with a single open of the sysfs file
+ */
+int get_acpi_table_alloc(
+		const char *signature,
+		struct acpi_table **pp_table)
+{
+	int rc = ACPI_ERR_BADTABLE;
+	struct acpi_table_header header;
+	struct acpi_table *p_table = NULL;
+	size_t body_size = 0;
+	size_t total_read = 0;
+	ssize_t bytes_read = 0;
+	char table_path[PATH_MAX];
+	int fd = -1;
+
+	if (!signature || !pp_table)
+	{
+		return ACPI_ERR_BADINPUT;
+	}
+	*pp_table = NULL;
+
+	snprintf(table_path, sizeof(table_path), "%s%s", SYSFS_ACPI_PATH, signature);
+	fd = open(table_path, O_RDONLY|O_CLOEXEC);
+	if (fd < 0)
+	{
+		return ACPI_ERR_TABLENOTFOUND;
+	}
+
+	if (read(fd, &header, sizeof(header)) != sizeof(header) ||
+		header.length < sizeof(header))
+	{
+		goto finish;
+	}
+
+	p_table = malloc(header.length);
+	if (!p_table)
+	{
+		goto finish;
+	}
+	os_memcpy(&(p_table->header), sizeof(struct acpi_table_header), &header, sizeof(header));
+
+	body_size = header.length - sizeof(header);
+	while (total_read < body_size)
+	{
+		bytes_read = read(fd, p_table->p_ext_tables + total_read, body_size - total_read);
+		if (bytes_read <= 0)
+		{
+			break;
+		}
+		total_read += bytes_read;
+	}
+
+	if (total_read == body_size)
+	{
+		rc = check_acpi_table(signature, p_table);
+		if (rc == ACPI_SUCCESS)
+		{
+			rc = (int)header.length;
+			*pp_table = p_table;
+			p_table = NULL;
+		}
+	}
+
+finish:
+	free(p_table);
+	close(fd);
+	return rc;
+}
@@ -82,6 +82,15 @@ int get_acpi_table(
 		struct acpi_table *p_table,
 		const unsigned int size);
 
+/*!
+ * Retrieve the specified ACPI table into a buffer allocated with malloc.
+ * The size and checksum of the table are verified.
+ * Returns the size of the table or a negative acpi_error.
+ */
+int get_acpi_table_alloc(
+		const char *signature,
+		struct acpi_table **pp_table);
+
 /*!
  * Verify the ACPI table size, checksum and signature
  */
@@ -278,13 +278,16 @@ int bios_write_large_payload(struct ndctl_dimm *p_dimm, struct fw_cmd *p_fw_cmd)
 }
 
 /*
- * Read the emulated bios large output mailbox
+ * Read the emulated bios large output mailbox, straight into the caller buffer
+ * when one is attached to the command
  */
 int bios_read_large_payload(struct ndctl_dimm *p_dimm, struct fw_cmd *p_fw_cmd)
 {
 	COMMON_LOG_ENTRY();
 	int rc = NVM_SUCCESS;
 	struct pt_bios_get_size mb_size;
+	unsigned char *p_large_output = (p_fw_cmd->pLargeOutputBuffer != NULL) ?
+		p_fw_cmd->pLargeOutputBuffer : p_fw_cmd->LargeOutputPayload;
 
 	if (!p_dimm)
 	{
@@ -354,8 +357,7 @@ int bios_read_large_payload(struct ndctl_dimm *p_dimm, struct fw_cmd *p_fw_cmd)
 							else
 							{
 								size_t return_size = ndctl_cmd_vendor_get_output(p_vendor_cmd,
-										p_fw_cmd->LargeOutputPayload +
-										current_offset, transfer_size);
+										p_large_output + current_offset, transfer_size);
 								if (return_size != transfer_size)
 								{
 									rc = NVM_ERR_GENERAL_OS_DRIVER_FAILURE;
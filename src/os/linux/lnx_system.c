@@ -24,6 +24,12 @@
 #include <sys/shm.h>
 #include <sys/types.h>
 #include <sys/ipc.h>
+#include <sys/mman.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/file.h>
 #include <string.h>
 #include <nvm_management.h>
 #include <os.h>
@@ -104,6 +110,68 @@ int os_start_process(const char *process_name, unsigned int *p_process_id)
 	return rc;
 }
 
+/*
+ * Map a regular file or a block device copy-on-write into memory.
+ * Changes made through the mapping are never written back to the file.
+ */
+void *os_map_file(const char *path, unsigned long long *p_size)
+{
+	void *p_addr = NULL;
+	struct stat file_stat;
+	unsigned long long size = 0;
+	int fd = open(path, O_RDONLY);
+
+	if (fd < 0 || p_size == NULL)
+	{
+		goto finish;
+	}
+
+	if (fstat(fd, &file_stat) != 0)
+	{
+		goto finish;
+	}
+
+	if (S_ISBLK(file_stat.st_mode))
+	{
+		if (ioctl(fd, BLKGETSIZE64, &size) != 0)
+		{
+			goto finish;
+		}
+	}
+	else
+	{
+		size = (unsigned long long)file_stat.st_size;
+	}
+
+	if (size == 0)
+	{
+		goto finish;
+	}
+
+	p_addr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	if (p_addr == MAP_FAILED)
+	{
+		p_addr = NULL;
+		goto finish;
+	}
+	*p_size = size;
+
+finish:
+	if (fd >= 0)
+	{
+		close(fd);
+	}
+	return p_addr;
+}
+
+/*
+ * Unmap a mapping created with os_map_file
+ */
+int os_unmap_file(void *p_addr, unsigned long long size)
+{
+	return munmap(p_addr, size);
+}
+
 /*
  * Stop a process
  */
@@ -118,17 +186,25 @@ int os_stop_process(unsigned int process_id)
 }
 
 /*
- * Create a thread on the current process
+ * Create a thread on the current process, returns 0 on success
  */
-void os_create_thread(unsigned long long *p_thread_id, void *(*callback)(void *), void *callback_arg)
+int os_create_thread(unsigned long long *p_thread_id, void *(*callback)(void *), void *callback_arg)
 {
-	pthread_create(
+	return pthread_create(
 			(pthread_t *)p_thread_id,
 			NULL, // default attributes
 			callback,
 			callback_arg);
 }
 
+/*
+ * Wait for a thread created with os_create_thread to finish
+ */
+int os_join_thread(unsigned long long thread_id)
+{
+	return pthread_join((pthread_t)thread_id, NULL);
+}
+
 /*
  * Retrieve the id of the current thread
  */
@@ -500,6 +576,107 @@ int os_mkdir(char *path)
   return 0;
 }
 
+/*
+* Take an exclusive advisory lock on "<path>.lock", NULL on error
+*/
+void *os_lock_file(const char *path)
+{
+  OS_PATH lock_path;
+  int *p_fd = NULL;
+
+  snprintf(lock_path, sizeof(lock_path), "%s.lock", path);
+  p_fd = malloc(sizeof(*p_fd));
+  if (NULL == p_fd) {
+    return NULL;
+  }
+  *p_fd = open(lock_path, O_RDWR | O_CREAT, 0644);
+  if (*p_fd < 0) {
+    free(p_fd);
+    return NULL;
+  }
+  while (0 != flock(*p_fd, LOCK_EX)) {
+    if (EINTR != errno) {
+      close(*p_fd);
+      free(p_fd);
+      return NULL;
+    }
+  }
+  return p_fd;
+}
+
+void os_unlock_file(void *p_lock)
+{
+  int *p_fd = (int *)p_lock;
+
+  if (NULL == p_fd) {
+    return;
+  }
+  flock(*p_fd, LOCK_UN);
+  close(*p_fd);
+  free(p_fd);
+}
+
+/*
+* Write the data to a temporary file, fsync it and rename it over the path,
+* return 0 on success, -1 on error
+*/
+int os_replace_file(const char *path, const char *p_data, size_t size)
+{
+  OS_PATH tmp_path;
+  OS_PATH dir_path;
+  struct stat file_stat;
+  ssize_t written = 0;
+  size_t offset = 0;
+  int fd = -1;
+  int dir_fd = -1;
+
+  snprintf(tmp_path, sizeof(tmp_path), "%s.%d.tmp", path, (int)getpid());
+  fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return -1;
+  }
+  // Keep the permissions of the file being replaced
+  if (0 == stat(path, &file_stat)) {
+    fchmod(fd, file_stat.st_mode & ACCESSPERMS);
+  }
+
+  while (offset < size) {
+    written = write(fd, p_data + offset, size - offset);
+    if (written < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      goto Error;
+    }
+    offset += (size_t)written;
+  }
+  if (0 != fsync(fd)) {
+    goto Error;
+  }
+  close(fd);
+  fd = -1;
+
+  if (0 != rename(tmp_path, path)) {
+    goto Error;
+  }
+
+  // Flush the directory entry so that the rename survives a crash as well
+  snprintf(dir_path, sizeof(dir_path), "%s", path);
+  dir_fd = open(dirname(dir_path), O_RDONLY);
+  if (dir_fd >= 0) {
+    fsync(dir_fd);
+    close(dir_fd);
+  }
+  return 0;
+
+Error:
+  if (fd >= 0) {
+    close(fd);
+  }
+  unlink(tmp_path);
+  return -1;
+}
+
 /*
  Get CPUID info for Linux. Depending on the inputRequestType,
   regs[0...3] will be populated with register values eax....edx
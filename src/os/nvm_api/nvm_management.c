@@ -8,7 +8,6 @@
  */
 
 #include "nvm_management.h"
-#include "nvm_output_parsing.h"
 #include <Uefi.h>
 #include <Library/UefiApplicationEntryPoint.h>
 #include <Library/UefiBootServicesTableLib.h>
@@ -22,6 +21,7 @@
 #include <Debug.h>
 #include <Types.h>
 #include <Utility.h>
+#include <HashIndex.h>
 #include <Version.h>
 #include <NvmInterface.h>
 #include <os_efi_bs_protocol.h>
@@ -35,6 +35,8 @@
 #include <os.h>
 #include <Dimm.h>
 #include <NvmDimmDriver.h>
+#include <AcpiParsing.h>
+#include <Pbr.h>
 #include <s_str.h>
 #include <wchar.h>
 #include <CommandParser.h>
@@ -52,9 +54,15 @@ OS_MUTEX *g_api_mutex;
 unsigned int g_dimm_cnt;
 int g_basic_commands = 0;
 DIMM_INFO *g_dimms;
+// Hash index of g_dimms by UID, each slot points to a g_dimms entry, NULL is a free slot
+static HASH_INDEX g_dimm_uid_index;
+// Address translation map of the current NFIT, built by the first translation
+static ADDRESS_TRANSLATION_MAP *g_translation_map;
 int get_dimm_id(const char *uid, UINT16 *dimm_id, unsigned int *dimm_handle);
 void dimm_info_to_device_discovery(DIMM_INFO *p_dimm, struct device_discovery *p_device);
 int g_nvm_initialized = 0;
+// Set while the driver binding is held for the whole nvm_init() session
+int g_driver_bound = 0;
 int get_fw_err_log_stats(const unsigned int dimm_id, const unsigned char log_level, const unsigned char log_type, LOG_INFO_DATA_RETURN *log_info);
 static int nvm_internal_init(BOOLEAN binding_start);
 static void nvm_internal_uninit(BOOLEAN binding_stop);
@@ -92,8 +100,10 @@ static int nvm_internal_init(BOOLEAN binding_start)
 
   if (g_nvm_initialized) {
 
-    // Clear PCD cache on any API entry point
-    ClearPcdCacheOnDimmList();
+    // Probe the cached PCD once on any API entry point, it is only reread when it changed
+    RequestPcdCacheProbe();
+    // SMART snapshots are shared by the consumers of one API call only, unless a TTL is configured
+    StartSmartSnapshotEpoch();
 
     return rc;
   }
@@ -149,6 +159,7 @@ static int nvm_internal_init(BOOLEAN binding_start)
   if (binding_start && (!g_fast_path && !g_basic_commands))
   {
     NvmDimmDriverDriverBindingStart(&gNvmDimmDriverDriverBinding, FakeBindHandle, NULL);
+    g_driver_bound = 1;
   }
 
   g_nvm_initialized = 1;
@@ -164,12 +175,82 @@ NVM_API void nvm_uninit()
   nvm_internal_uninit(TRUE);
 }
 
+NVM_API int nvm_refresh(const enum nvm_refresh_scope scope, const NVM_UID device_uid)
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  EFI_STATUS TmpReturnCode = EFI_SUCCESS;
+  EFI_HANDLE FakeBindHandle = (EFI_HANDLE)0x1;
+  DIMM *pDimm = NULL;
+  LIST_ENTRY *pDimmNode = NULL;
+  UINT16 dimm_id;
+  int nvm_status;
+
+  if (NVM_SUCCESS != (nvm_status = nvm_init())) {
+    NVDIMM_ERR("Failed to intialize nvm library %d\n", nvm_status);
+    return nvm_status;
+  }
+
+  if (!g_driver_bound) {
+    // Nothing is cached without the driver binding
+    return NVM_SUCCESS;
+  }
+
+  switch (scope) {
+  case NVM_REFRESH_ALL:
+    FREE_POOL_SAFE(g_dimms);
+    HashIndexFree(&g_dimm_uid_index);
+    g_dimm_cnt = 0;
+    // The map points into the NFIT the binding start parses again
+    FreeAddressTranslationMap(&g_translation_map);
+    NvmDimmDriverDriverBindingStop(&gNvmDimmDriverDriverBinding, FakeBindHandle, 0, NULL);
+    // The platform may have changed the tables since they were read
+    InvalidateAcpiTableCache();
+    ReturnCode = NvmDimmDriverDriverBindingStart(&gNvmDimmDriverDriverBinding, FakeBindHandle, NULL);
+    break;
+  case NVM_REFRESH_DEVICE:
+    if (NULL != device_uid) {
+      if (NVM_SUCCESS != (nvm_status = get_dimm_id(device_uid, &dimm_id, NULL))) {
+        NVDIMM_ERR("Failed to get dimm ID %d\n", nvm_status);
+        return NVM_ERR_DIMM_NOT_FOUND;
+      }
+      if (NULL == (pDimm = GetDimmByPid(dimm_id, &gNvmDimmData->PMEMDev.Dimms))) {
+        NVDIMM_ERR("Failed to get dimm by Pid (%d)\n", dimm_id);
+        return NVM_ERR_DIMM_NOT_FOUND;
+      }
+      ReturnCode = RefreshDimmInventoryEntry(pDimm);
+    } else {
+      LIST_FOR_EACH(pDimmNode, &gNvmDimmData->PMEMDev.Dimms) {
+        pDimm = DIMM_FROM_NODE(pDimmNode);
+        TmpReturnCode = RefreshDimmInventoryEntry(pDimm);
+        KEEP_ERROR(ReturnCode, TmpReturnCode);
+      }
+    }
+    break;
+  case NVM_REFRESH_REGIONS:
+    ReturnCode = CleanNamespacesAndISs();
+    break;
+  case NVM_REFRESH_PCD:
+    ReturnCode = ClearPcdCacheOnDimmList();
+    break;
+  default:
+    return NVM_ERR_INVALID_PARAMETER;
+  }
+
+  if (EFI_ERROR(ReturnCode)) {
+    NVDIMM_ERR("Refresh of scope %d failed (%d)\n", scope, ReturnCode);
+    return NVM_ERR_UNKNOWN;
+  }
+  return NVM_SUCCESS;
+}
+
 static void nvm_internal_uninit(BOOLEAN binding_stop)
 {
   EFI_HANDLE FakeBindHandle = (EFI_HANDLE)0x1;
 
-  if (binding_stop && (!g_fast_path && !g_basic_commands)) {
+  FreeAddressTranslationMap(&g_translation_map);
+  if (binding_stop && g_driver_bound) {
     NvmDimmDriverDriverBindingStop(&gNvmDimmDriverDriverBinding, FakeBindHandle, 0, NULL);
+    g_driver_bound = 0;
   }
   NvmDimmDriverUnload(FakeBindHandle);
   uninit_protocol_shell_parameters_protocol();
@@ -232,6 +313,8 @@ NVM_API int nvm_run_cli(int argc, char *argv[])
 {
   EFI_STATUS rc;
   int nvm_status;
+  // Reuse the state of an nvm_init() session instead of tearing it down afterwards
+  BOOLEAN session_active = (BOOLEAN)g_nvm_initialized;
 
   rc = init_protocol_shell_parameters_protocol(argc, argv);
   if (rc == EFI_INVALID_PARAMETER) {
@@ -254,18 +337,11 @@ NVM_API int nvm_run_cli(int argc, char *argv[])
   }
   rc = UefiToOsReturnCode(UefiMain(0, NULL));
 
-  //gOsShellParametersProtocol.StdOut will be overriden when
-  //-o xml is used (temp hack)
-  if (gOsShellParametersProtocol.StdOut != stdout) {
-    enum DisplayType dt;
-    UINT8 d;
-    wchar_t disp_name[DISP_NAME_LEN];
-    wchar_t disp_delims[DISP_DELIMS_LEN];
-    GetDisplayInfo(disp_name, DISP_NAME_LEN*sizeof(wchar_t), &d, disp_delims, DISP_DELIMS_LEN * sizeof(wchar_t));
-    dt = (enum DisplayType)d;
-    process_output(dt, disp_name, disp_delims, (int)rc, gOsShellParametersProtocol.StdOut, argc, argv);
-  }
-  nvm_internal_uninit(FALSE);
+  if (session_active) {
+    uninit_protocol_shell_parameters_protocol();
+  } else {
+    nvm_internal_uninit(FALSE);
+  }
   return (int)rc;
 }
 
@@ -972,12 +1048,11 @@ NVM_API int nvm_get_device_performance(const NVM_UID      device_uid,
     return rc;
   }
 
-  if (NULL == (cmd = (NVM_FW_CMD *)AllocatePool(sizeof(NVM_FW_CMD)))) {
+  if (NULL == (cmd = AllocateFwCmd())) {
     NVDIMM_ERR("Failed to allocate memory\n");
     goto finish;
   }
 
-  ZeroMem(cmd, sizeof(NVM_FW_CMD));
   ZeroMem(&mem_info_input, sizeof(mem_info_input));
   mem_info_input.MemoryPage = 1;
   UINT16 dimm_id;
@@ -1007,7 +1082,7 @@ NVM_API int nvm_get_device_performance(const NVM_UID      device_uid,
   }
 
 finish:
-  FREE_POOL_SAFE(cmd);
+  FreeFwCmd(cmd);
   return rc;
 }
 
@@ -1855,6 +1930,38 @@ Finish:
   return rc;
 }
 
+NVM_API int nvm_get_smart_snapshot_stats(const NVM_UID device_uid, struct smart_snapshot_stats *p_stats)
+{
+  UINT16 dimm_id;
+  DIMM *pDimm = NULL;
+  int rc = NVM_SUCCESS;
+
+  if (NULL == p_stats) {
+    NVDIMM_ERR("NULL input parameter\n");
+    return NVM_ERR_INVALID_PARAMETER;
+  }
+
+  if (NVM_SUCCESS != (rc = nvm_init())) {
+    NVDIMM_ERR("Failed to intialize nvm library %d\n", rc);
+    return rc;
+  }
+
+  if (NVM_SUCCESS != (rc = get_dimm_id(device_uid, &dimm_id, NULL))) {
+    NVDIMM_ERR("Failed to get dimm ID %d\n", rc);
+    return rc;
+  }
+
+  if (NULL == (pDimm = GetDimmByPid(dimm_id, &gNvmDimmData->PMEMDev.Dimms))) {
+    NVDIMM_ERR("Failed to get dimm by Pid (%d)\n", dimm_id);
+    return NVM_ERR_DIMM_NOT_FOUND;
+  }
+
+  memset(p_stats, 0, sizeof(*p_stats));
+  p_stats->hits = pDimm->SmartSnapshotHits;
+  p_stats->misses = pDimm->SmartSnapshotFetches;
+  return NVM_SUCCESS;
+}
+
 NVM_API int nvm_set_sensor_settings(const NVM_UID device_uid,
             const enum sensor_type type, const struct sensor_settings *p_settings)
 {
@@ -2408,9 +2515,12 @@ EFI_STATUS execute_cli_cmd(wchar_t * cmdline)
   struct CommandInput Input;
   struct Command Command;
 
-  ReturnCode = RegisterCommands();
-  if (EFI_ERROR(ReturnCode))
-    return NVM_ERR_UNKNOWN;
+  // The command set is registered once and reused by the following calls
+  if (!CommandsRegistered()) {
+    ReturnCode = RegisterCommands();
+    if (EFI_ERROR(ReturnCode))
+      return NVM_ERR_UNKNOWN;
+  }
 
   FillCommandInput(cmdline, &Input);
   ReturnCode = Parse(&Input, &Command);
@@ -2420,6 +2530,7 @@ EFI_STATUS execute_cli_cmd(wchar_t * cmdline)
     ReturnCode = ExecuteCmd(&Command);
   }
   FreeCommandInput(&Input);
+  FreeCommandStructure(&Command);
   return ReturnCode;
 }
 
@@ -2543,17 +2654,19 @@ Finish:
   return rc;
 }
 
-NVM_API int nvm_run_diagnostic(const NVM_UID device_uid,
-             const struct diagnostic *p_diagnostic, NVM_UINT32 *p_results)
+/**
+  Run the diagnostic test of p_diagnostic on one device, or on all of them
+  when device_uid is NULL. The caller frees *pp_result with FreeDiagnosticResult.
+**/
+static int run_diagnostic(const NVM_UID device_uid, const struct diagnostic *p_diagnostic,
+  DIAG_INFO **pp_result)
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
   UINT8 diag_tests = 0;
   UINT16 dimm_id;
   UINT16 *p_dimm_id;
-  CHAR16 *pFinalDiagnosticsResultStr = NULL;
   UINT32 dimm_count;
   int rc = NVM_SUCCESS;
-  DIAG_INFO *pFinalDiagnosticsResult = NULL;
 
   if (NULL == p_diagnostic)
     return NVM_ERR_INVALID_PARAMETER;
@@ -2569,7 +2682,7 @@ NVM_API int nvm_run_diagnostic(const NVM_UID device_uid,
   } else {
     if (NVM_SUCCESS != (rc = get_dimm_id((char *)device_uid, &dimm_id, NULL))) {
       NVDIMM_ERR("Failed to get dimm ID %d\n", rc);
-      goto Finish;
+      return rc;
     } else {
       dimm_count = 1;
       p_dimm_id = (UINT16 *)&dimm_id;
@@ -2585,8 +2698,7 @@ NVM_API int nvm_run_diagnostic(const NVM_UID device_uid,
   } else if (DIAG_TYPE_FW_CONSISTENCY == p_diagnostic->test) {
     diag_tests = DIAGNOSTIC_TEST_FW;
   } else {
-    rc = NVM_ERR_INVALID_PARAMETER;
-    goto Finish;
+    return NVM_ERR_INVALID_PARAMETER;
   }
 
   ReturnCode = gNvmDimmDriverNvmDimmConfig.StartDiagnostic(
@@ -2595,16 +2707,127 @@ NVM_API int nvm_run_diagnostic(const NVM_UID device_uid,
     dimm_count,
     diag_tests,
     DISPLAY_DIMM_ID_UID,
-    &pFinalDiagnosticsResult);
+    pp_result);
 
-  pFinalDiagnosticsResultStr = DiagnosticResultToStr(pFinalDiagnosticsResult);
-  Print(FORMAT_STR, pFinalDiagnosticsResultStr);
-  FreePool(pFinalDiagnosticsResult);
-  FreePool(pFinalDiagnosticsResultStr);
   if (EFI_ERROR(ReturnCode))
     rc = NVM_ERR_UNKNOWN;
 
-Finish:
+  return rc;
+}
+
+NVM_API int nvm_run_diagnostic(const NVM_UID device_uid,
+             const struct diagnostic *p_diagnostic, NVM_UINT32 *p_results)
+{
+  CHAR16 *pFinalDiagnosticsResultStr = NULL;
+  int rc = NVM_SUCCESS;
+  DIAG_INFO *pFinalDiagnosticsResult = NULL;
+  NVM_UINT32 event_index;
+
+  rc = run_diagnostic(device_uid, p_diagnostic, &pFinalDiagnosticsResult);
+
+  if (pFinalDiagnosticsResult != NULL) {
+    if (NULL != p_results) {
+      *p_results = 0;
+      for (event_index = 0; event_index < pFinalDiagnosticsResult->EventsNum; event_index++) {
+        if (pFinalDiagnosticsResult->pEvents[event_index].StateMask &
+            (DIAG_STATE_MASK_FAILED | DIAG_STATE_MASK_ABORTED)) {
+          (*p_results)++;
+        }
+      }
+    }
+    pFinalDiagnosticsResultStr = DiagnosticResultToStr(pFinalDiagnosticsResult);
+    Print(FORMAT_STR, pFinalDiagnosticsResultStr);
+    FREE_POOL_SAFE(pFinalDiagnosticsResultStr);
+    FreeDiagnosticResult(&pFinalDiagnosticsResult);
+  }
+
+  return rc;
+}
+
+static enum event_type diagnostic_to_event_type(enum diagnostic_test test)
+{
+  switch (test) {
+  case DIAG_TYPE_QUICK:
+    return EVENT_TYPE_DIAG_QUICK;
+  case DIAG_TYPE_PLATFORM_CONFIG:
+    return EVENT_TYPE_DIAG_PLATFORM_CONFIG;
+  case DIAG_TYPE_SECURITY:
+    return EVENT_TYPE_DIAG_SECURITY;
+  case DIAG_TYPE_FW_CONSISTENCY:
+    return EVENT_TYPE_DIAG_FW_CONSISTENCY;
+  default:
+    return EVENT_TYPE_DIAG;
+  }
+}
+
+static void diag_event_to_event(DIAG_EVENT *p_diag_event, enum event_type type, NVM_UINT32 event_id,
+  struct event *p_event)
+{
+  CHAR16 DimmUid[MAX_DIMM_UID_LENGTH];
+  DIMM *pDimm = NULL;
+  unsigned int j;
+
+  ZeroMem(p_event, sizeof(*p_event));
+  p_event->event_id = event_id;
+  p_event->type = type;
+  p_event->code = (NVM_UINT16)p_diag_event->EventCode;
+  p_event->time = time(NULL);
+
+  if (p_diag_event->StateMask & DIAG_STATE_MASK_ABORTED) {
+    p_event->severity = EVENT_SEVERITY_CRITICAL;
+    p_event->diag_result = DIAGNOSTIC_RESULT_ABORTED;
+  } else if (p_diag_event->StateMask & DIAG_STATE_MASK_FAILED) {
+    p_event->severity = EVENT_SEVERITY_CRITICAL;
+    p_event->diag_result = DIAGNOSTIC_RESULT_FAILED;
+  } else if (p_diag_event->StateMask & DIAG_STATE_MASK_WARNING) {
+    p_event->severity = EVENT_SEVERITY_WARN;
+    p_event->diag_result = DIAGNOSTIC_RESULT_WARNING;
+  } else {
+    p_event->severity = EVENT_SEVERITY_INFO;
+    p_event->diag_result = DIAGNOSTIC_RESULT_OK;
+  }
+
+  if (DIMM_PID_INVALID != p_diag_event->DimmId &&
+      NULL != (pDimm = GetDimmByPid(p_diag_event->DimmId, &gNvmDimmData->PMEMDev.Dimms))) {
+    ZeroMem(DimmUid, sizeof(DimmUid));
+    GetDimmUid(pDimm, DimmUid, MAX_DIMM_UID_LENGTH);
+    for (j = 0; j < MAX_DIMM_UID_LENGTH && j < NVM_MAX_UID_LEN - 1; j++) {
+      p_event->uid[j] = (char)DimmUid[j];
+    }
+  }
+
+  // The message is cut at the event message length like any other event
+  for (j = 0; NULL != p_diag_event->pMessage && L'\0' != p_diag_event->pMessage[j] && j < NVM_EVENT_MSG_LEN - 1; j++) {
+    p_event->message[j] = (char)p_diag_event->pMessage[j];
+  }
+}
+
+NVM_API int nvm_run_diagnostic_events(const NVM_UID device_uid,
+  const struct diagnostic *p_diagnostic, struct event *p_events, NVM_UINT32 *p_count)
+{
+  int rc = NVM_SUCCESS;
+  DIAG_INFO *p_result = NULL;
+  NVM_UINT32 event_index;
+
+  if (NULL == p_diagnostic || NULL == p_count || (NULL == p_events && 0 != *p_count))
+    return NVM_ERR_INVALID_PARAMETER;
+
+  rc = run_diagnostic(device_uid, p_diagnostic, &p_result);
+
+  if (NULL != p_result) {
+    for (event_index = 0; event_index < p_result->EventsNum && event_index < *p_count; event_index++) {
+      diag_event_to_event(&p_result->pEvents[event_index], diagnostic_to_event_type(p_diagnostic->test),
+        event_index, &p_events[event_index]);
+    }
+    if (p_result->EventsNum > *p_count && NVM_SUCCESS == rc) {
+      rc = NVM_ERR_BAD_SIZE;
+    }
+    *p_count = p_result->EventsNum;
+    FreeDiagnosticResult(&p_result);
+  } else if (NVM_SUCCESS == rc) {
+    *p_count = 0;
+  }
+
   return rc;
 }
 
@@ -2684,6 +2907,20 @@ NVM_API int nvm_toggle_debug_logging(const NVM_BOOL enabled)
   return DebugLoggerEnable(enabled);
 }
 
+static enum nvm_job_type long_op_to_job_type(PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *pLongOpStatus)
+{
+  if ((pLongOpStatus->CmdOpcode == PtSetSecInfo) && (pLongOpStatus->CmdSubcode == SubopOverwriteDimm)) {
+    return NVM_JOB_TYPE_SANITIZE;
+  }
+  else if ((pLongOpStatus->CmdOpcode == PtSetFeatures) && (pLongOpStatus->CmdSubcode == SubopAddressRangeScrub)) {
+    return NVM_JOB_TYPE_ARS;
+  }
+  else if ((pLongOpStatus->CmdOpcode == PtUpdateFw) && (pLongOpStatus->CmdSubcode == SubopUpdateFw)) {
+    return NVM_JOB_TYPE_FW_UPDATE;
+  }
+  return NVM_JOB_TYPE_UNKNOWN;
+}
+
 NVM_API int nvm_get_jobs(struct job *p_jobs, const NVM_UINT32 count)
 {
   EFI_STATUS ReturnCode = EFI_SUCCESS;
@@ -2717,19 +2954,18 @@ NVM_API int nvm_get_jobs(struct job *p_jobs, const NVM_UINT32 count)
     return NVM_ERR_BAD_SIZE;
   }
 
-  if (NULL == (cmd = (NVM_FW_CMD *)AllocatePool(sizeof(NVM_FW_CMD)))) {
+  if (NULL == (cmd = AllocateFwCmd())) {
     NVDIMM_ERR("Failed to allocate memory\n");
     return NVM_ERR_NOT_ENOUGH_FREE_SPACE;
   }
 
-  ZeroMem(cmd, sizeof(NVM_FW_CMD));
   pLongOpStatus = (PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *)cmd->OutPayload;
   // Populate the list of DIMM_INFO structures with relevant information
   CmdStub.pPrintCtx = NULL;
   ReturnCode = GetDimmList(&gNvmDimmDriverNvmDimmConfig, &CmdStub, DIMM_INFO_CATEGORY_NONE, &pDimms, &DimmCount);
   if (EFI_ERROR(ReturnCode)) {
     NVDIMM_ERR("Failed to get dimm list %d\n", (int)ReturnCode);
-    FreePool(cmd);
+    FreeFwCmd(cmd);
     return NVM_ERR_OPERATION_FAILED;
   }
 
@@ -2753,18 +2989,7 @@ NVM_API int nvm_get_jobs(struct job *p_jobs, const NVM_UINT32 count)
         p_jobs[i].status = NVM_JOB_STATUS_COMPLETE;
       }
 
-      if ((pLongOpStatus->CmdOpcode == PtSetSecInfo) && (pLongOpStatus->CmdSubcode == SubopOverwriteDimm)) {
-        p_jobs[i].type = NVM_JOB_TYPE_SANITIZE;
-      }
-      else if ((pLongOpStatus->CmdOpcode == PtSetFeatures) && (pLongOpStatus->CmdSubcode == SubopAddressRangeScrub)) {
-        p_jobs[i].type = NVM_JOB_TYPE_ARS;
-      }
-      else if ((pLongOpStatus->CmdOpcode == PtUpdateFw) && (pLongOpStatus->CmdSubcode == SubopUpdateFw)) {
-        p_jobs[i].type = NVM_JOB_TYPE_FW_UPDATE;
-      }
-      else {
-        p_jobs[i].type = NVM_JOB_TYPE_UNKNOWN;
-      }
+      p_jobs[i].type = long_op_to_job_type(pLongOpStatus);
       p_jobs[i].percent_complete = BCD_TO_BYTE(pLongOpStatus->Percent);
     }
     else {
@@ -2784,10 +3009,306 @@ NVM_API int nvm_get_jobs(struct job *p_jobs, const NVM_UINT32 count)
     p_jobs[i].result = NULL;
     job_index++;
   }
-  FreePool(cmd);
+  FreeFwCmd(cmd);
   return NVM_SUCCESS;
 }
 
+struct wait_for_jobs_context {
+  nvm_job_callback callback;
+  void *p_context;
+};
+
+static VOID long_op_to_job(DIMM *pDimm, PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *pLongOpStatus,
+  EFI_STATUS ReturnCode, struct job *p_job)
+{
+  CHAR16 DimmUid[MAX_DIMM_UID_LENGTH];
+  unsigned int j;
+
+  ZeroMem(p_job, sizeof(*p_job));
+  ZeroMem(DimmUid, sizeof(DimmUid));
+  GetDimmUid(pDimm, DimmUid, MAX_DIMM_UID_LENGTH);
+  for (j = 0; j < MAX_DIMM_UID_LENGTH; j++) {
+    p_job->uid[j] = (char)DimmUid[j];
+    p_job->affected_element[j] = (char)DimmUid[j];
+  }
+
+  if (EFI_SUCCESS == ReturnCode) {
+    p_job->status = NVM_JOB_STATUS_COMPLETE;
+  }
+  else if (EFI_NOT_STARTED == ReturnCode) {
+    p_job->status = NVM_JOB_STATUS_NOT_STARTED;
+  }
+  else if (EFI_TIMEOUT == ReturnCode) {
+    p_job->status = NVM_JOB_STATUS_RUNNING;
+  }
+  else {
+    p_job->status = NVM_JOB_STATUS_UNKNOWN;
+  }
+
+  if (EFI_NOT_STARTED == ReturnCode) {
+    p_job->type = NVM_JOB_TYPE_UNKNOWN;
+  }
+  else {
+    p_job->type = long_op_to_job_type(pLongOpStatus);
+    p_job->percent_complete = BCD_TO_BYTE(pLongOpStatus->Percent);
+  }
+}
+
+static VOID wait_for_jobs_completion(VOID *pContext, DIMM *pDimm,
+  PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *pLongOpStatus, EFI_STATUS ReturnCode)
+{
+  struct wait_for_jobs_context *p_wait_context = (struct wait_for_jobs_context *)pContext;
+  struct job job;
+
+  if (NULL == p_wait_context->callback) {
+    return;
+  }
+
+  long_op_to_job(pDimm, pLongOpStatus, ReturnCode, &job);
+  p_wait_context->callback(&job, p_wait_context->p_context);
+}
+
+NVM_API int nvm_wait_for_jobs(const NVM_UID *p_device_uids, const NVM_UINT32 device_uids_count,
+  const NVM_UINT32 timeout_sec, nvm_job_callback callback, void *p_context)
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  EFI_STATUS ReturnCodes[MAX_DIMMS];
+  DIMM *pDimms[MAX_DIMMS];
+  UINT32 DimmsNum = 0;
+  LIST_ENTRY *pDimmNode = NULL;
+  struct wait_for_jobs_context wait_context;
+  UINT16 dimm_id;
+  unsigned int i;
+  int rc = NVM_SUCCESS;
+
+  if (NULL != p_device_uids && (0 == device_uids_count || MAX_DIMMS < device_uids_count))
+    return NVM_ERR_INVALID_PARAMETER;
+
+  if (NVM_SUCCESS != (rc = nvm_init())) {
+    NVDIMM_ERR("Failed to intialize nvm library %d\n", rc);
+    return rc;
+  }
+
+  ZeroMem(pDimms, sizeof(pDimms));
+  ZeroMem(ReturnCodes, sizeof(ReturnCodes));
+
+  if (NULL != p_device_uids) {
+    for (i = 0; i < device_uids_count; ++i) {
+      if (NVM_SUCCESS != (rc = get_dimm_id(p_device_uids[i], &dimm_id, NULL))) {
+        NVDIMM_ERR("Failed to get dimm ID %d\n", rc);
+        return NVM_ERR_DIMM_NOT_FOUND;
+      }
+      if (NULL == (pDimms[DimmsNum] = GetDimmByPid(dimm_id, &gNvmDimmData->PMEMDev.Dimms))) {
+        NVDIMM_ERR("Failed to get dimm by Pid (%d)\n", dimm_id);
+        return NVM_ERR_DIMM_NOT_FOUND;
+      }
+      DimmsNum++;
+    }
+  }
+  else {
+    LIST_FOR_EACH(pDimmNode, &gNvmDimmData->PMEMDev.Dimms) {
+      if (DimmsNum >= MAX_DIMMS) {
+        break;
+      }
+      if (IsDimmManageable(DIMM_FROM_NODE(pDimmNode))) {
+        pDimms[DimmsNum++] = DIMM_FROM_NODE(pDimmNode);
+      }
+    }
+  }
+
+  if (0 == DimmsNum)
+    return NVM_SUCCESS;
+
+  wait_context.callback = callback;
+  wait_context.p_context = p_context;
+  ReturnCode = PollLongOpStatusOnDimms(pDimms, DimmsNum, 0, 0, timeout_sec,
+    wait_for_jobs_completion, &wait_context, ReturnCodes);
+
+  // A device without a job has nothing to wait for
+  rc = NVM_SUCCESS;
+  for (i = 0; i < DimmsNum; ++i) {
+    if (EFI_TIMEOUT == ReturnCodes[i]) {
+      rc = NVM_ERR_TIMEOUT;
+    }
+    else if (EFI_ERROR(ReturnCodes[i]) && EFI_NOT_STARTED != ReturnCodes[i] && NVM_SUCCESS == rc) {
+      rc = NVM_ERR_OPERATION_FAILED;
+    }
+  }
+  if (EFI_ERROR(ReturnCode) && NVM_SUCCESS == rc && EFI_NOT_STARTED != ReturnCode) {
+    rc = NVM_ERR_OPERATION_FAILED;
+  }
+  return rc;
+}
+
+/**
+  Job submitted through nvm_job_submit, nvm_job_handle points to it
+**/
+struct nvm_job_entry {
+  UINT16 dimm_id;             ///< DIMM running the long operation
+  enum nvm_job_type type;     ///< Expected long operation, NVM_JOB_TYPE_UNKNOWN for any
+  nvm_job_callback callback;  ///< Optional, called once when the job stops running
+  void *p_context;            ///< Passed to callback
+  NVM_BOOL done;              ///< The job stopped running and callback was called
+  struct job job;             ///< Last known state of the job
+};
+
+struct job_wait_context {
+  nvm_job_handle *p_handles;  ///< Jobs being polled
+  DIMM **pp_dimms;            ///< DIMM of each job
+  NVM_BOOL *p_polled;         ///< The poller already reported the job
+  UINT32 count;
+};
+
+static VOID job_wait_completion(VOID *pContext, DIMM *pDimm,
+  PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *pLongOpStatus, EFI_STATUS ReturnCode)
+{
+  struct job_wait_context *p_wait_context = (struct job_wait_context *)pContext;
+  nvm_job_handle handle = NULL;
+  UINT32 i;
+
+  // Several jobs may be tracked on the same DIMM, the poller reports it once per job
+  for (i = 0; i < p_wait_context->count; ++i) {
+    if (p_wait_context->pp_dimms[i] == pDimm && !p_wait_context->p_polled[i]) {
+      p_wait_context->p_polled[i] = TRUE;
+      handle = p_wait_context->p_handles[i];
+      break;
+    }
+  }
+  if (NULL == handle) {
+    return;
+  }
+
+  long_op_to_job(pDimm, pLongOpStatus, ReturnCode, &handle->job);
+  if (NVM_JOB_TYPE_UNKNOWN != handle->type && NVM_JOB_STATUS_NOT_STARTED != handle->job.status &&
+      handle->job.type != handle->type) {
+    NVDIMM_ERR("DIMM 0x%x reports a different long operation than the one submitted\n",
+      pDimm->DeviceHandle.AsUint32);
+    handle->job.status = NVM_JOB_STATUS_UNKNOWN;
+  }
+
+  if (NVM_JOB_STATUS_RUNNING == handle->job.status) {
+    return;
+  }
+  handle->done = TRUE;
+  if (NULL != handle->callback) {
+    handle->callback(&handle->job, handle->p_context);
+  }
+}
+
+NVM_API int nvm_job_submit(const NVM_UID device_uid, const enum nvm_job_type type,
+  nvm_job_callback callback, void *p_context, nvm_job_handle *p_handle)
+{
+  nvm_job_handle handle = NULL;
+  UINT16 dimm_id;
+  unsigned int j;
+  int rc = NVM_SUCCESS;
+
+  if (NULL == device_uid || NULL == p_handle)
+    return NVM_ERR_INVALID_PARAMETER;
+
+  *p_handle = NULL;
+
+  if (NVM_SUCCESS != (rc = nvm_init())) {
+    NVDIMM_ERR("Failed to intialize nvm library %d\n", rc);
+    return rc;
+  }
+
+  if (NVM_SUCCESS != (rc = get_dimm_id(device_uid, &dimm_id, NULL))) {
+    NVDIMM_ERR("Failed to get dimm ID %d\n", rc);
+    return NVM_ERR_DIMM_NOT_FOUND;
+  }
+
+  if (NULL == (handle = (nvm_job_handle)AllocateZeroPool(sizeof(*handle)))) {
+    NVDIMM_ERR("Failed to allocate memory\n");
+    return NVM_ERR_NOT_ENOUGH_FREE_SPACE;
+  }
+
+  handle->dimm_id = dimm_id;
+  handle->type = type;
+  handle->callback = callback;
+  handle->p_context = p_context;
+  handle->job.status = NVM_JOB_STATUS_UNKNOWN;
+  handle->job.type = type;
+  for (j = 0; j < MAX_DIMM_UID_LENGTH && device_uid[j] != '\0'; j++) {
+    handle->job.uid[j] = device_uid[j];
+    handle->job.affected_element[j] = device_uid[j];
+  }
+
+  *p_handle = handle;
+  return NVM_SUCCESS;
+}
+
+NVM_API int nvm_job_wait(const nvm_job_handle *p_handles, const NVM_UINT32 handles_count,
+  const NVM_UINT32 timeout_sec)
+{
+  EFI_STATUS ReturnCodes[MAX_DIMMS];
+  nvm_job_handle pending[MAX_DIMMS];
+  DIMM *pDimms[MAX_DIMMS];
+  NVM_BOOL polled[MAX_DIMMS];
+  struct job_wait_context wait_context;
+  UINT32 PendingNum = 0;
+  unsigned int i;
+  int rc = NVM_SUCCESS;
+
+  if (NULL == p_handles || 0 == handles_count || MAX_DIMMS < handles_count)
+    return NVM_ERR_INVALID_PARAMETER;
+
+  if (NVM_SUCCESS != (rc = nvm_init())) {
+    NVDIMM_ERR("Failed to intialize nvm library %d\n", rc);
+    return rc;
+  }
+
+  ZeroMem(ReturnCodes, sizeof(ReturnCodes));
+  ZeroMem(polled, sizeof(polled));
+
+  for (i = 0; i < handles_count; ++i) {
+    if (NULL == p_handles[i])
+      return NVM_ERR_INVALID_PARAMETER;
+    if (p_handles[i]->done)
+      continue;
+    if (NULL == (pDimms[PendingNum] = GetDimmByPid(p_handles[i]->dimm_id, &gNvmDimmData->PMEMDev.Dimms))) {
+      NVDIMM_ERR("Failed to get dimm by Pid (%d)\n", p_handles[i]->dimm_id);
+      return NVM_ERR_DIMM_NOT_FOUND;
+    }
+    pending[PendingNum++] = p_handles[i];
+  }
+
+  // All jobs share one poller, each round queries every DIMM still busy once
+  if (PendingNum > 0) {
+    wait_context.p_handles = pending;
+    wait_context.pp_dimms = pDimms;
+    wait_context.p_polled = polled;
+    wait_context.count = PendingNum;
+    PollLongOpStatusOnDimms(pDimms, PendingNum, 0, 0, timeout_sec,
+      job_wait_completion, &wait_context, ReturnCodes);
+  }
+
+  rc = NVM_SUCCESS;
+  for (i = 0; i < handles_count; ++i) {
+    if (NVM_JOB_STATUS_RUNNING == p_handles[i]->job.status) {
+      rc = NVM_ERR_TIMEOUT;
+    }
+    else if (NVM_JOB_STATUS_UNKNOWN == p_handles[i]->job.status && NVM_SUCCESS == rc) {
+      rc = NVM_ERR_OPERATION_FAILED;
+    }
+  }
+  return rc;
+}
+
+NVM_API int nvm_job_get(const nvm_job_handle handle, struct job *p_job)
+{
+  if (NULL == handle || NULL == p_job)
+    return NVM_ERR_INVALID_PARAMETER;
+
+  CopyMem_S(p_job, sizeof(*p_job), &handle->job, sizeof(handle->job));
+  return NVM_SUCCESS;
+}
+
+NVM_API void nvm_job_free(nvm_job_handle handle)
+{
+  FREE_POOL_SAFE(handle);
+}
+
 NVM_API int nvm_create_context()
 {
   return NVM_SUCCESS;
@@ -2937,6 +3458,448 @@ NVM_API int nvm_get_fw_err_log_stats(const NVM_UID      device_uid,
   return rc;
 }
 
+#define ERROR_LOG_STREAM_CHUNK   ERROR_LOG_MAX_COUNT
+
+/*
+* Last read sequence number of one log of one PMem module, as kept in a cursor file
+*/
+struct error_log_cursor {
+  NVM_UID       uid;
+  unsigned char log_level;
+  unsigned char log_type;
+  NVM_UINT16    next_seq_num;
+};
+
+/*
+* Per PMem module state of an error log stream, holding one chunk of entries
+*/
+struct error_log_stream_device {
+  NVM_UID             uid;
+  UINT16              dimm_id;
+  unsigned char       log_level;
+  unsigned char       log_type;
+  NVM_UINT16          next_seq_num;   // After the last entry read
+  NVM_UINT16          fetch_seq_num;  // First entry of the next chunk
+  NVM_BOOL            fetched_all;
+  NVM_BOOL            read_any;
+  ERROR_LOG_INFO      *p_entries;     // ERROR_LOG_STREAM_CHUNK entries
+  NVM_UINT32          entries_num;
+  NVM_UINT32          read_pos;
+  int                 rc;
+};
+
+struct error_log_stream {
+  unsigned char                   log_level;
+  unsigned char                   log_type;
+  OS_PATH                         cursor_file;
+  struct error_log_cursor         *p_cursors;
+  NVM_UINT32                      cursors_num;
+  struct error_log_stream_device  *p_devices;
+  NVM_UINT32                      devices_num;
+  NVM_UINT32                      device_pos;
+};
+
+/*
+* Sequence number of a parsed error log entry
+*/
+static NVM_UINT16 error_log_entry_seq_num(ERROR_LOG_INFO *p_entry)
+{
+  if (THERMAL_ERROR == p_entry->ErrorType) {
+    return ((THERMAL_ERROR_LOG_INFO *)p_entry->OutputData)->SequenceNum;
+  }
+  return ((MEDIA_ERROR_LOG_INFO *)p_entry->OutputData)->SequenceNum;
+}
+
+/*
+* Fetch the next chunk of entries of one PMem module in place of the chunk read
+*/
+static int fetch_error_log_chunk(struct error_log_stream_device *p_device)
+{
+  COMMAND_STATUS *pCommandStatus = NULL;
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  NVM_UINT16 seq_num = p_device->fetch_seq_num;
+  NVM_UINT16 last_seq_num = 0;
+  UINT32 fetched = ERROR_LOG_STREAM_CHUNK;
+
+  p_device->entries_num = 0;
+  p_device->read_pos = 0;
+
+  if (EFI_ERROR(InitializeCommandStatus(&pCommandStatus))) {
+    p_device->rc = NVM_ERR_NO_MEM;
+    return p_device->rc;
+  }
+
+  ReturnCode = gNvmDimmDriverNvmDimmConfig.GetErrorLog(&gNvmDimmDriverNvmDimmConfig,
+    &p_device->dimm_id, 1, p_device->log_type, p_device->fetch_seq_num, p_device->log_level,
+    &fetched, p_device->p_entries, pCommandStatus);
+  FreeCommandStatus(&pCommandStatus);
+  if (EFI_ERROR(ReturnCode)) {
+    p_device->rc = NVM_ERR_UNKNOWN;
+    return p_device->rc;
+  }
+
+  p_device->entries_num = fetched;
+  if (fetched > 0) {
+    last_seq_num = error_log_entry_seq_num(&p_device->p_entries[fetched - 1]);
+    p_device->fetch_seq_num = last_seq_num + 1;
+  }
+  // A short chunk ends the log. The sequence numbers wrap around at MAX_UINT16,
+  // a chunk not ending at or after the requested entry came from an older lap.
+  if (fetched < ERROR_LOG_STREAM_CHUNK || IsSequenceNumberAfter(seq_num, last_seq_num)) {
+    p_device->fetched_all = TRUE;
+  }
+  return NVM_SUCCESS;
+}
+
+/*
+* RunOnDimms worker fetching the first chunk of one PMem module
+*/
+static EFI_STATUS fetch_error_log_worker(DIMM *p_dimm, VOID *p_arg)
+{
+  struct error_log_stream_device *p_device = (struct error_log_stream_device *)p_arg;
+
+  return (NVM_SUCCESS == fetch_error_log_chunk(p_device)) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+/*
+* Load the cursors of all PMem modules and logs from a cursor file,
+* a missing file is the same as an empty one
+*/
+static int load_error_log_cursors(struct error_log_stream *p_stream)
+{
+  FILE *h_file = NULL;
+  struct error_log_cursor cursor;
+  struct error_log_cursor *p_grown = NULL;
+  unsigned int log_level;
+  unsigned int log_type;
+  unsigned int next_seq_num;
+  char line[NVM_MAX_UID_LEN + 32];
+  char uid_format[16];
+
+  if (NULL == (h_file = fopen(p_stream->cursor_file, "r"))) {
+    return NVM_SUCCESS;
+  }
+
+  snprintf(uid_format, sizeof(uid_format), "%%%ds %%u %%u %%u", NVM_MAX_UID_LEN - 1);
+  while (NULL != fgets(line, sizeof(line), h_file)) {
+    ZeroMem(&cursor, sizeof(cursor));
+    if (4 != sscanf(line, uid_format, cursor.uid, &log_level, &log_type, &next_seq_num)) {
+      continue;
+    }
+    cursor.log_level = (unsigned char)log_level;
+    cursor.log_type = (unsigned char)log_type;
+    cursor.next_seq_num = (NVM_UINT16)next_seq_num;
+
+    p_grown = ReallocatePool(p_stream->cursors_num * sizeof(cursor),
+      (p_stream->cursors_num + 1) * sizeof(cursor), p_stream->p_cursors);
+    if (NULL == p_grown) {
+      fclose(h_file);
+      return NVM_ERR_NO_MEM;
+    }
+    p_stream->p_cursors = p_grown;
+    p_stream->p_cursors[p_stream->cursors_num++] = cursor;
+  }
+
+  fclose(h_file);
+  return NVM_SUCCESS;
+}
+
+/*
+* Find the cursor of a PMem module log, NULL if it was never read
+*/
+static struct error_log_cursor *find_error_log_cursor(struct error_log_stream *p_stream, const char *uid)
+{
+  NVM_UINT32 i;
+
+  for (i = 0; i < p_stream->cursors_num; i++) {
+    if (0 == AsciiStrCmp(p_stream->p_cursors[i].uid, uid) &&
+        p_stream->p_cursors[i].log_level == p_stream->log_level &&
+        p_stream->p_cursors[i].log_type == p_stream->log_type) {
+      return &p_stream->p_cursors[i];
+    }
+  }
+  return NULL;
+}
+
+/*
+* Write all cursors to a temporary file and move it over the cursor file,
+* so an interrupted collector never leaves a truncated cursor file behind
+*/
+static int save_error_log_cursors(struct error_log_stream *p_stream)
+{
+  FILE *h_file = NULL;
+  char tmp_file[OS_PATH_LEN + sizeof(".tmp")];
+  NVM_UINT32 i;
+  int rc = NVM_SUCCESS;
+
+  snprintf(tmp_file, sizeof(tmp_file), "%s.tmp", p_stream->cursor_file);
+  if (NULL == (h_file = fopen(tmp_file, "w"))) {
+    return NVM_ERR_DUMP_FILE_OPERATION_FAILED;
+  }
+
+  for (i = 0; i < p_stream->cursors_num; i++) {
+    if (0 > fprintf(h_file, "%s %u %u %u\n", p_stream->p_cursors[i].uid, p_stream->p_cursors[i].log_level,
+        p_stream->p_cursors[i].log_type, p_stream->p_cursors[i].next_seq_num)) {
+      rc = NVM_ERR_DUMP_FILE_OPERATION_FAILED;
+    }
+  }
+
+  if (0 != fclose(h_file) || NVM_SUCCESS != rc || 0 != rename(tmp_file, p_stream->cursor_file)) {
+    remove(tmp_file);
+    rc = NVM_ERR_DUMP_FILE_OPERATION_FAILED;
+  }
+  return rc;
+}
+
+NVM_API int nvm_open_error_log_stream(const unsigned char log_level, const unsigned char log_type,
+  const char *cursor_file, struct error_log_stream **pp_stream)
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  struct error_log_stream *p_stream = NULL;
+  struct error_log_stream_device *p_device = NULL;
+  struct error_log_cursor *p_cursor = NULL;
+  DIMM_INFO *p_dimms = NULL;
+  UINT32 dimm_cnt = 0;
+  DIMM **pp_fetch_dimms = NULL;
+  VOID **pp_fetch_args = NULL;
+  EFI_STATUS *p_fetch_rcs = NULL;
+  NVM_UINT32 i;
+  int rc = NVM_SUCCESS;
+
+  if (log_level > 1 || log_type > 1 || NULL == pp_stream ||
+      (NULL != cursor_file && strlen(cursor_file) >= OS_PATH_LEN)) {
+    NVDIMM_ERR("Invalid input parameter\n");
+    return NVM_ERR_INVALID_PARAMETER;
+  }
+
+  if (NVM_SUCCESS != (rc = nvm_init())) {
+    NVDIMM_ERR("Failed to intialize nvm library %d\n", rc);
+    return rc;
+  }
+
+  if (NULL == (p_stream = AllocateZeroPool(sizeof(*p_stream)))) {
+    return NVM_ERR_NO_MEM;
+  }
+  p_stream->log_level = log_level;
+  p_stream->log_type = log_type;
+
+  if (NULL != cursor_file) {
+    snprintf(p_stream->cursor_file, sizeof(p_stream->cursor_file), "%s", cursor_file);
+    if (NVM_SUCCESS != (rc = load_error_log_cursors(p_stream))) {
+      goto Finish;
+    }
+  }
+
+  ReturnCode = gNvmDimmDriverNvmDimmConfig.GetDimmCount(&gNvmDimmDriverNvmDimmConfig, &dimm_cnt);
+  if (EFI_ERROR(ReturnCode)) {
+    rc = NVM_ERR_UNKNOWN;
+    goto Finish;
+  }
+
+  p_dimms = AllocateZeroPool(sizeof(DIMM_INFO) * dimm_cnt);
+  p_stream->p_devices = AllocateZeroPool(sizeof(*p_stream->p_devices) * dimm_cnt);
+  pp_fetch_dimms = AllocateZeroPool(sizeof(*pp_fetch_dimms) * dimm_cnt);
+  pp_fetch_args = AllocateZeroPool(sizeof(*pp_fetch_args) * dimm_cnt);
+  p_fetch_rcs = AllocateZeroPool(sizeof(*p_fetch_rcs) * dimm_cnt);
+  if (NULL == p_dimms || NULL == p_stream->p_devices || NULL == pp_fetch_dimms ||
+      NULL == pp_fetch_args || NULL == p_fetch_rcs) {
+    rc = NVM_ERR_NO_MEM;
+    goto Finish;
+  }
+
+  ReturnCode = gNvmDimmDriverNvmDimmConfig.GetDimms(&gNvmDimmDriverNvmDimmConfig, dimm_cnt, DIMM_INFO_CATEGORY_NONE, p_dimms);
+  if (EFI_ERROR(ReturnCode)) {
+    rc = NVM_ERR_UNKNOWN;
+    goto Finish;
+  }
+
+  for (i = 0; i < dimm_cnt; i++) {
+    if (MANAGEMENT_VALID_CONFIG != p_dimms[i].ManageabilityState) {
+      continue;
+    }
+    p_device = &p_stream->p_devices[p_stream->devices_num];
+    UnicodeStrToAsciiStrS(p_dimms[i].DimmUid, p_device->uid, NVM_MAX_UID_LEN);
+    p_device->dimm_id = p_dimms[i].DimmID;
+    p_device->log_level = log_level;
+    p_device->log_type = log_type;
+    p_device->rc = NVM_SUCCESS;
+    if (NULL != (p_cursor = find_error_log_cursor(p_stream, p_device->uid))) {
+      p_device->next_seq_num = p_cursor->next_seq_num;
+    }
+    p_device->fetch_seq_num = p_device->next_seq_num;
+    if (NULL == (p_device->p_entries = AllocateZeroPool(sizeof(ERROR_LOG_INFO) * ERROR_LOG_STREAM_CHUNK))) {
+      p_stream->devices_num++;
+      rc = NVM_ERR_NO_MEM;
+      goto Finish;
+    }
+    if (NULL == (pp_fetch_dimms[p_stream->devices_num] = GetDimmByPid(p_device->dimm_id, &gNvmDimmData->PMEMDev.Dimms))) {
+      p_stream->devices_num++;
+      rc = NVM_ERR_UNKNOWN;
+      goto Finish;
+    }
+    pp_fetch_args[p_stream->devices_num] = p_device;
+    p_stream->devices_num++;
+  }
+
+  // Only the first chunk of every PMem module is fetched here, the rest as the entries are read
+  RunOnDimms(pp_fetch_dimms, p_stream->devices_num, fetch_error_log_worker, pp_fetch_args, p_fetch_rcs);
+
+Finish:
+  FREE_POOL_SAFE(p_dimms);
+  FREE_POOL_SAFE(pp_fetch_dimms);
+  FREE_POOL_SAFE(pp_fetch_args);
+  FREE_POOL_SAFE(p_fetch_rcs);
+  if (NVM_SUCCESS != rc) {
+    nvm_close_error_log_stream(p_stream, FALSE);
+    p_stream = NULL;
+  }
+  *pp_stream = p_stream;
+  return rc;
+}
+
+NVM_API int nvm_read_error_log_stream(struct error_log_stream *p_stream, NVM_UID device_uid, ERROR_LOG *error_entry)
+{
+  struct error_log_stream_device *p_device = NULL;
+  int rc = NVM_SUCCESS;
+
+  if (NULL == p_stream || NULL == device_uid || NULL == error_entry) {
+    NVDIMM_ERR("Invalid input parameter\n");
+    return NVM_ERR_INVALID_PARAMETER;
+  }
+
+  while (p_stream->device_pos < p_stream->devices_num) {
+    p_device = &p_stream->p_devices[p_stream->device_pos];
+    AsciiStrCpyS(device_uid, NVM_MAX_UID_LEN, p_device->uid);
+
+    if (NVM_SUCCESS != p_device->rc) {
+      rc = p_device->rc;
+      p_stream->device_pos++;
+      return rc;
+    }
+
+    if (p_device->read_pos == p_device->entries_num && !p_device->fetched_all) {
+      fetch_error_log_chunk(p_device);
+      continue;
+    }
+
+    if (p_device->read_pos < p_device->entries_num) {
+      CopyMem_S(error_entry, sizeof(*error_entry), &p_device->p_entries[p_device->read_pos], sizeof(ERROR_LOG_INFO));
+      p_device->next_seq_num = error_log_entry_seq_num(&p_device->p_entries[p_device->read_pos]) + 1;
+      p_device->read_pos++;
+      p_device->read_any = TRUE;
+      return NVM_SUCCESS;
+    }
+
+    p_stream->device_pos++;
+  }
+
+  return NVM_SUCCESS_NO_ERROR_LOG_ENTRY;
+}
+
+NVM_API int nvm_close_error_log_stream(struct error_log_stream *p_stream, const NVM_BOOL save_cursor)
+{
+  struct error_log_stream_device *p_device = NULL;
+  struct error_log_cursor *p_cursor = NULL;
+  struct error_log_cursor *p_grown = NULL;
+  NVM_UINT32 i;
+  int rc = NVM_SUCCESS;
+
+  if (NULL == p_stream) {
+    return NVM_ERR_INVALID_PARAMETER;
+  }
+
+  if (save_cursor && '\0' != p_stream->cursor_file[0]) {
+    for (i = 0; i < p_stream->devices_num && NVM_SUCCESS == rc; i++) {
+      p_device = &p_stream->p_devices[i];
+      if (!p_device->read_any) {
+        continue;
+      }
+      if (NULL == (p_cursor = find_error_log_cursor(p_stream, p_device->uid))) {
+        p_grown = ReallocatePool(p_stream->cursors_num * sizeof(*p_cursor),
+          (p_stream->cursors_num + 1) * sizeof(*p_cursor), p_stream->p_cursors);
+        if (NULL == p_grown) {
+          rc = NVM_ERR_NO_MEM;
+          break;
+        }
+        p_stream->p_cursors = p_grown;
+        p_cursor = &p_stream->p_cursors[p_stream->cursors_num++];
+        ZeroMem(p_cursor, sizeof(*p_cursor));
+        AsciiStrCpyS(p_cursor->uid, NVM_MAX_UID_LEN, p_device->uid);
+        p_cursor->log_level = p_stream->log_level;
+        p_cursor->log_type = p_stream->log_type;
+      }
+      p_cursor->next_seq_num = p_device->next_seq_num;
+    }
+    if (NVM_SUCCESS == rc) {
+      rc = save_error_log_cursors(p_stream);
+    }
+  }
+
+  if (NULL != p_stream->p_devices) {
+    for (i = 0; i < p_stream->devices_num; i++) {
+      FREE_POOL_SAFE(p_stream->p_devices[i].p_entries);
+    }
+  }
+  FREE_POOL_SAFE(p_stream->p_devices);
+  FREE_POOL_SAFE(p_stream->p_cursors);
+  FreePool(p_stream);
+  return rc;
+}
+
+/*
+* Translate a batch of addresses with the address translation map of the
+* inventory, the map is built once and dropped by nvm_refresh(NVM_REFRESH_ALL)
+*/
+static int translate_addresses(struct device_address *p_addresses, const NVM_UINT32 count, BOOLEAN spa_to_dpa)
+{
+  EFI_STATUS ReturnCode = EFI_SUCCESS;
+  NvDimmRegionMappingStructure *pNvDimmRegionTable = NULL;
+  NVM_UINT32 i;
+  int rc = NVM_SUCCESS;
+
+  if (NULL == p_addresses || 0 == count) {
+    NVDIMM_ERR("Invalid input parameter\n");
+    return NVM_ERR_INVALID_PARAMETER;
+  }
+
+  if (NVM_SUCCESS != (rc = nvm_init())) {
+    NVDIMM_ERR("Failed to intialize nvm library %d\n", rc);
+    return rc;
+  }
+
+  if (NULL == g_translation_map) {
+    ReturnCode = BuildAddressTranslationMap(gNvmDimmData->PMEMDev.pFitHead, &g_translation_map);
+    if (EFI_ERROR(ReturnCode)) {
+      NVDIMM_ERR("Failed to build the address translation map %d\n", ReturnCode);
+      return (ReturnCode == EFI_OUT_OF_RESOURCES) ? NVM_ERR_NO_MEM : NVM_ERR_UNKNOWN;
+    }
+  }
+
+  for (i = 0; i < count; i++) {
+    if (spa_to_dpa) {
+      ReturnCode = TranslateSpaToDpa(g_translation_map, p_addresses[i].spa, &pNvDimmRegionTable, &p_addresses[i].dpa);
+      if (!EFI_ERROR(ReturnCode)) {
+        p_addresses[i].device_handle.handle = pNvDimmRegionTable->DeviceHandle.AsUint32;
+      }
+    } else {
+      ReturnCode = TranslateDpaToSpa(g_translation_map, p_addresses[i].device_handle.handle, p_addresses[i].dpa, &p_addresses[i].spa);
+    }
+    p_addresses[i].status = EFI_ERROR(ReturnCode) ? NVM_ERR_REGION_NOT_FOUND : NVM_SUCCESS;
+  }
+
+  return NVM_SUCCESS;
+}
+
+NVM_API int nvm_translate_spa_to_dpa(struct device_address *p_addresses, const NVM_UINT32 count)
+{
+  return translate_addresses(p_addresses, count, TRUE);
+}
+
+NVM_API int nvm_translate_dpa_to_spa(struct device_address *p_addresses, const NVM_UINT32 count)
+{
+  return translate_addresses(p_addresses, count, FALSE);
+}
+
 NVM_API int nvm_get_dimm_id(const NVM_UID device_uid,
           unsigned int *  dimm_id,
           unsigned int *  dimm_handle)
@@ -2951,11 +3914,46 @@ NVM_API int nvm_get_dimm_id(const NVM_UID device_uid,
   return rc;
 }
 
+/*
+* Check if the cached DIMM info has the looked up ASCII UID, matching exactly as StrCmp does
+*/
+static BOOLEAN dimm_uid_matching(VOID *p_item, CONST VOID *p_key)
+{
+  const char *uid = (const char *)p_key;
+  const CHAR16 *uid_wide = ((DIMM_INFO *)p_item)->DimmUid;
+
+  for (; *uid != '\0' && (CHAR16)(unsigned char)*uid == *uid_wide; uid++, uid_wide++);
+  return (*uid == '\0' && *uid_wide == L'\0');
+}
+
+/*
+* Build the UID hash index of the cached g_dimms. The ASCII and UCS-2 forms of
+* a UID hash to the same value, so lookups use the caller's UID without converting it.
+*/
+static int build_dimm_uid_index()
+{
+  unsigned int i;
+
+  if (EFI_ERROR(HashIndexInit(&g_dimm_uid_index, g_dimm_cnt))) {
+    NVDIMM_ERR("Failed to allocate memory\n");
+    return NVM_ERR_NO_MEM;
+  }
+
+  // Inserting in g_dimms order keeps the first DIMM with a given UID first in its probe sequence
+  for (i = 0; i < g_dimm_cnt; ++i) {
+    HashIndexInsert(&g_dimm_uid_index, HashUnicodeStr(g_dimms[i].DimmUid), &g_dimms[i]);
+  }
+  return NVM_SUCCESS;
+}
+
 int get_dimm_id(const char *uid, UINT16 *dimm_id, unsigned int *dimm_handle)
 {
   EFI_STATUS rc;
-  CHAR16 uid_wide[MAX_DIMM_UID_LENGTH];
-  unsigned int i;
+  DIMM_INFO *p_dimm;
+
+  if (NULL == uid) {
+    return NVM_ERR_INVALID_PARAMETER;
+  }
 
   if (NULL == g_dimms) {
     if (NVM_SUCCESS != nvm_get_number_of_devices(&g_dimm_cnt)) {
@@ -2978,21 +3976,21 @@ int get_dimm_id(const char *uid, UINT16 *dimm_id, unsigned int *dimm_handle)
     }
   }
 
-  rc = AsciiStrToUnicodeStrS(uid, uid_wide, MAX_DIMM_UID_LENGTH);
-  if (EFI_ERROR(rc)) {
-    NVDIMM_ERR("Failed while converting uid (%s) to UniCode. (%d)\n", uid, rc);
-    return NVM_ERR_UNKNOWN;
-  }
-  for (i = 0; i < g_dimm_cnt; ++i) {
-    if (0 == StrCmp(uid_wide, g_dimms[i].DimmUid)) {
-      if (dimm_id)
-        *dimm_id = g_dimms[i].DimmID;
-      if (dimm_handle)
-        *dimm_handle = g_dimms[i].DimmHandle;
-      return NVM_SUCCESS;
+  if (NULL == g_dimm_uid_index.ppSlots) {
+    if (NVM_SUCCESS != build_dimm_uid_index()) {
+      return NVM_ERR_UNKNOWN;
     }
   }
-  return NVM_ERR_UNKNOWN;
+
+  p_dimm = (DIMM_INFO *)HashIndexFind(&g_dimm_uid_index, HashAsciiStr(uid), dimm_uid_matching, uid);
+  if (NULL == p_dimm) {
+    return NVM_ERR_UNKNOWN;
+  }
+  if (dimm_id)
+    *dimm_id = p_dimm->DimmID;
+  if (dimm_handle)
+    *dimm_handle = p_dimm->DimmHandle;
+  return NVM_SUCCESS;
 }
 
 void dimm_info_to_device_discovery(DIMM_INFO *p_dimm, struct device_discovery *p_device)
@@ -3046,11 +4044,10 @@ int get_fw_err_log_stats(
   NVM_FW_CMD *cmd;
   PT_INPUT_PAYLOAD_GET_ERROR_LOG get_error_log_input;
 
-  if (NULL == (cmd = (NVM_FW_CMD *)AllocatePool(sizeof(NVM_FW_CMD)))) {
+  if (NULL == (cmd = AllocateFwCmd())) {
     NVDIMM_ERR("Failed to allocate memory\n");
     goto finish;
   }
-  ZeroMem(cmd, sizeof(NVM_FW_CMD));
   ZeroMem(&get_error_log_input, sizeof(get_error_log_input));
   get_error_log_input.SequenceNumber = 0;
   get_error_log_input.LogParameters.Separated.LogInfo = 1;
@@ -3069,8 +4066,7 @@ int get_fw_err_log_stats(
     rc = NVM_SUCCESS;
   }
 finish:
-  if (cmd)
-    FreePool(cmd);
+  FreeFwCmd(cmd);
   return rc;
 }
 
@@ -3105,12 +4101,11 @@ NVM_API int nvm_send_device_passthrough_cmd(const NVM_UID   device_uid,
     return rc;
   }
 
-  if (NULL == (cmd = (NVM_FW_CMD *)AllocatePool(sizeof(NVM_FW_CMD)))) {
+  if (NULL == (cmd = AllocateFwCmd())) {
     NVDIMM_ERR("Failed to allocate memory\n");
     goto finish;
   }
 
-  ZeroMem(cmd, sizeof(NVM_FW_CMD));
 
   if (NVM_SUCCESS != (rc = get_dimm_id((char *)device_uid, &dimm_id, &dimm_handle))) {
     NVDIMM_ERR("Failed to get dimm ID %d\n", rc);
@@ -3125,6 +4120,8 @@ NVM_API int nvm_send_device_passthrough_cmd(const NVM_UID   device_uid,
   cmd->OutputPayloadSize = p_cmd->output_payload_size;
   cmd->LargeInputPayloadSize = p_cmd->large_input_payload_size;
   cmd->LargeOutputPayloadSize = p_cmd->large_output_payload_size;
+  // The large output payload is read straight into the caller buffer
+  cmd->pLargeOutputBuffer = p_cmd->large_output_payload;
   CopyMem_S(cmd->LargeInputPayload, sizeof(cmd->LargeInputPayload), p_cmd->large_input_payload, cmd->LargeInputPayloadSize);
 
   if (EFI_SUCCESS != PassThruCommand(cmd, PT_TIMEOUT_INTERVAL))
@@ -3147,7 +4144,9 @@ NVM_API int nvm_send_device_passthrough_cmd(const NVM_UID   device_uid,
       rc = NVM_ERR_INVALID_PARAMETER;
       goto finish;
     }
-    CopyMem_S(p_cmd->large_output_payload, p_cmd->large_output_payload_size, cmd->LargeOutputPayload, cmd->LargeOutputPayloadSize);
+    if (NULL == cmd->pLargeOutputBuffer) {
+      CopyMem_S(p_cmd->large_output_payload, p_cmd->large_output_payload_size, cmd->LargeOutputPayload, cmd->LargeOutputPayloadSize);
+    }
     p_cmd->large_output_payload_size = cmd->LargeOutputPayloadSize;
   }
   else if (cmd->OutputPayloadSize)
@@ -3163,6 +4162,6 @@ NVM_API int nvm_send_device_passthrough_cmd(const NVM_UID   device_uid,
     p_cmd->output_payload_size = cmd->OutputPayloadSize;
   }
 finish:
-  FREE_POOL_SAFE(cmd);
+  FreeFwCmd(cmd);
   return rc;
 }
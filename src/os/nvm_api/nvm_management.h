@@ -539,6 +539,16 @@ enum fw_update_status {
   FW_UPDATE_FAILED  = 3  ///< FW Update Failed
 };
 
+/**
+ * Part of the library state that nvm_refresh() rebuilds
+ */
+enum nvm_refresh_scope {
+  NVM_REFRESH_ALL     = 0, ///< Rebind the driver: ACPI tables, PMem module inventory, regions and PCD
+  NVM_REFRESH_DEVICE  = 1, ///< Reread the inventory entry and PCD of one or all PMem modules
+  NVM_REFRESH_REGIONS = 2, ///< Rebuild the regions on next use
+  NVM_REFRESH_PCD     = 3  ///< Reread the PCD of every PMem module on next use
+};
+
 /**
  * ****************************************************************************
  * STRUCTURES
@@ -694,6 +704,23 @@ struct device_error_log_status {
   NVM_UINT8                             reserved[32];   ///< reserved
 };
 
+/**
+ * A stream of FW error log entries read from all manageable PMem modules.
+ * The layout is private to the library.
+ */
+struct error_log_stream;
+
+/**
+ * An address translated between the system physical address space and the
+ * device physical address space of a memory module
+ */
+struct device_address {
+  NVM_UINT64              spa;            ///< System physical address
+  NVM_NFIT_DEVICE_HANDLE  device_handle;  ///< The unique device handle of the memory module
+  NVM_UINT64              dpa;            ///< Device physical address on the memory module
+  int                     status;         ///< ::NVM_SUCCESS or the reason the address was not translated
+};
+
 /**
  * The status of a particular device
  */
@@ -777,6 +804,15 @@ struct sensor {
   NVM_UINT8             reserved[24];                    ///< reserved
 };
 
+/**
+ * Use of the SMART and health snapshot of a PMem module since the library was initialized.
+ */
+struct smart_snapshot_stats {
+  NVM_UINT32	hits;                                   ///< SMART and health reads served from the snapshot.
+  NVM_UINT32	misses;                                 ///< SMART and health reads sent to the PMem module.
+  NVM_UINT8	reserved[24];                           ///< reserved
+};
+
 /**
  * Device partition capacities (in bytes) used for a single device or aggregated across the server.
  */
@@ -1157,6 +1193,25 @@ NVM_API int nvm_init();
  */
 NVM_API void nvm_uninit();
 
+/**
+* @brief  Rebuild cached library state without ending the session.
+* The driver stays bound between nvm_init() and nvm_uninit(), including
+* for nvm_run_cli() calls made in between. Operations done through the
+* library invalidate what they change; use this call after the platform
+* was changed by other means.
+*
+* @param[in] scope Which part of the state to rebuild
+* @param[in] device_uid UID of the PMem module for ::NVM_REFRESH_DEVICE,
+*            NULL to refresh all PMem modules. Ignored for other scopes.
+*
+* @return
+*  ::NVM_SUCCESS @n
+*  ::NVM_ERR_INVALID_PARAMETER @n
+*  ::NVM_ERR_DIMM_NOT_FOUND @n
+*  ::NVM_ERR_UNKNOWN @n
+*/
+NVM_API int nvm_refresh(const enum nvm_refresh_scope scope, const NVM_UID device_uid);
+
 /**
 * @brief    Initialize the config file. Only the first call to the
 * function changes the conf file configuration, the following
@@ -1637,6 +1692,23 @@ NVM_API int nvm_get_sensors(const NVM_UID device_uid, struct sensor *p_sensors,
 */
 NVM_API int nvm_get_sensor(const NVM_UID device_uid, const enum sensor_type type, struct sensor *p_sensor);
 
+/**
+* @brief Retrieve how often the SMART and health data of the specified PMem module
+* was served from its snapshot instead of being read from the PMem module.
+* @remarks A snapshot is kept for one API call, or for the TTL configured with
+* SMART_SNAPSHOT_TTL_MS, and dropped by any FW command that may change it.
+* @param[in] device_uid
+*              The device identifier.
+* @param[out] p_stats
+*              A pointer to a #smart_snapshot_stats structure allocated by the caller.
+* @return
+*            ::NVM_SUCCESS @n
+*            ::NVM_ERR_INVALID_PARAMETER @n
+*            ::NVM_ERR_DIMM_NOT_FOUND @n
+*            ::NVM_ERR_UNKNOWN @n
+*/
+NVM_API int nvm_get_smart_snapshot_stats(const NVM_UID device_uid, struct smart_snapshot_stats *p_stats);
+
 /**
 * @brief Change the critical threshold on the specified health sensor for the specified
 * PMem module.
@@ -2209,6 +2281,32 @@ NVM_API int nvm_clear_injected_device_error(const NVM_UID device_uid, const stru
  */
 NVM_API int nvm_run_diagnostic(const NVM_UID device_uid, const struct diagnostic *p_diagnostic, NVM_UINT32 *p_results);
 
+/**
+ * @brief Run a diagnostic test on the device specified and return the
+ * events it reported, in the order they were reported.
+ * @param[in] device_uid
+ *              The device identifier, NULL to run the test on all devices.
+ * @param[in] p_diagnostic
+ *              A pointer to a #diagnostic structure containing the
+ *              diagnostic to run allocated by the caller.
+ * @param[in,out] p_events
+ *              An array of #event structures allocated by the caller. Each
+ *              event carries its diagnostic_result, code, device UID and
+ *              message.
+ * @param[in,out] p_count
+ *              In, the number of elements in p_events. Out, the number of
+ *              events the diagnostic reported.
+ * @pre The caller has administrative privileges.
+ * @pre The device is manageable.
+ * @return
+ *            ::NVM_SUCCESS @n
+ *            ::NVM_ERR_INVALID_PARAMETER @n
+ *            ::NVM_ERR_BAD_SIZE the events beyond *p_count were dropped @n
+ *            ::NVM_ERR_UNKNOWN @n
+ */
+NVM_API int nvm_run_diagnostic_events(const NVM_UID device_uid, const struct diagnostic *p_diagnostic,
+  struct event *p_events, NVM_UINT32 *p_count);
+
 /**
  * @brief Set the user preference config value in PMem module software.  See the Change Preferences section of the CLI
  * specification for a list of supported preferences and values.  Note, this API does not verify if the property key
@@ -2291,6 +2389,112 @@ NVM_API int nvm_toggle_debug_logging(const NVM_BOOL enabled);
  */
 NVM_API int nvm_get_jobs(struct job *p_jobs, const NVM_UINT32 count);
 
+/**
+ * @brief Callback of #nvm_wait_for_jobs, called once per device as soon as
+ * its job is no longer running or the timeout expired.
+ * @param[in] p_job Final #job information of the device, status is
+ *              ::NVM_JOB_STATUS_RUNNING when the timeout expired
+ * @param[in] p_context Context passed to #nvm_wait_for_jobs
+ */
+typedef void (*nvm_job_callback)(const struct job *p_job, void *p_context);
+
+/**
+ * @brief Waits for the jobs (sanitize, ARS, FW update) running on several
+ * devices. All devices are polled in one loop and share one timeout.
+ * @param[in] p_device_uids
+ *              Array of the UIDs of the devices to wait on, NULL for all
+ *              manageable devices.
+ * @param[in] device_uids_count
+ *              The number of elements in p_device_uids.
+ * @param[in] timeout_sec
+ *              Timeout shared by all devices.
+ * @param[in] callback
+ *              Optional, reports each device as soon as its job completes.
+ * @param[in] p_context
+ *              Passed to callback.
+ * @pre The caller must have administrative privileges.
+ * @return
+ *            ::NVM_SUCCESS @n
+ *            ::NVM_ERR_INVALID_PARAMETER @n
+ *            ::NVM_ERR_DIMM_NOT_FOUND @n
+ *            ::NVM_ERR_TIMEOUT @n
+ *            ::NVM_ERR_OPERATION_FAILED @n
+ */
+NVM_API int nvm_wait_for_jobs(const NVM_UID *p_device_uids, const NVM_UINT32 device_uids_count,
+  const NVM_UINT32 timeout_sec, nvm_job_callback callback, void *p_context);
+
+/**
+ * Opaque handle of a job submitted with #nvm_job_submit
+ */
+typedef struct nvm_job_entry *nvm_job_handle;
+
+/**
+ * @brief Submits a job (sanitize, ARS, FW update) started on a device, so it
+ * can be waited on with #nvm_job_wait instead of a thread per operation.
+ * @param[in] device_uid
+ *              The device running the job.
+ * @param[in] type
+ *              The expected job, ::NVM_JOB_TYPE_UNKNOWN to accept any.
+ * @param[in] callback
+ *              Optional, called once from #nvm_job_wait when the job stops
+ *              running.
+ * @param[in] p_context
+ *              Passed to callback.
+ * @param[out] p_handle
+ *              Handle of the job, released with #nvm_job_free.
+ * @pre The caller must have administrative privileges.
+ * @remarks The job itself is started by the blocking call of the operation,
+ * which returns as soon as the device accepted it.
+ * @return
+ *            ::NVM_SUCCESS @n
+ *            ::NVM_ERR_INVALID_PARAMETER @n
+ *            ::NVM_ERR_DIMM_NOT_FOUND @n
+ *            ::NVM_ERR_NOT_ENOUGH_FREE_SPACE @n
+ */
+NVM_API int nvm_job_submit(const NVM_UID device_uid, const enum nvm_job_type type,
+  nvm_job_callback callback, void *p_context, nvm_job_handle *p_handle);
+
+/**
+ * @brief Waits for several submitted jobs. The status of all jobs still
+ * running is queried in one batch per polling round and the jobs share one
+ * timeout.
+ * @param[in] p_handles
+ *              Array of the jobs to wait on.
+ * @param[in] handles_count
+ *              The number of elements in p_handles.
+ * @param[in] timeout_sec
+ *              Timeout shared by all jobs, 0 to query the progress once.
+ * @pre The caller must have administrative privileges.
+ * @remarks Use #nvm_job_get to read the progress of each job afterwards.
+ * @return
+ *            ::NVM_SUCCESS @n
+ *            ::NVM_ERR_INVALID_PARAMETER @n
+ *            ::NVM_ERR_DIMM_NOT_FOUND @n
+ *            ::NVM_ERR_TIMEOUT @n
+ *            ::NVM_ERR_OPERATION_FAILED @n
+ */
+NVM_API int nvm_job_wait(const nvm_job_handle *p_handles, const NVM_UINT32 handles_count,
+  const NVM_UINT32 timeout_sec);
+
+/**
+ * @brief Retrieves the #job information last read by #nvm_job_wait.
+ * @param[in] handle
+ *              Job returned by #nvm_job_submit.
+ * @param[out] p_job
+ *              A #job structure allocated by the caller.
+ * @return
+ *            ::NVM_SUCCESS @n
+ *            ::NVM_ERR_INVALID_PARAMETER @n
+ */
+NVM_API int nvm_job_get(const nvm_job_handle handle, struct job *p_job);
+
+/**
+ * @brief Releases a job returned by #nvm_job_submit.
+ * @param[in] handle
+ *              Job to release, may be NULL.
+ */
+NVM_API void nvm_job_free(nvm_job_handle handle);
+
 /**
  * @brief Initialize a new context
  */
@@ -2382,6 +2586,86 @@ NVM_API int nvm_get_fw_error_log_entry_cmd(const NVM_UID   device_uid, const uns
 
 NVM_API int nvm_get_fw_err_log_stats(const NVM_UID device_uid, struct device_error_log_status *error_log_stats);
 
+/**
+* @brief Open a stream of FW error log entries of all manageable PMem modules.
+* @remarks The first chunk of the logs of all PMem modules is fetched concurrently when
+* the stream is opened, later chunks are fetched as the entries are read. There is no
+* limit on the number of entries returned per PMem module.
+* When a cursor file is given, only the entries logged after the last entry read
+* in a previous stream with the same log level and type are returned.
+* @param[in] log_level Log entry log level (0: Low, 1: High)
+* @param[in] log_type Log entry log type (0: Media, 1: Thermal)
+* @param[in] cursor_file Optional file keeping the last read sequence number per PMem module
+* @param[out] pp_stream Opened stream, must be closed with nvm_close_error_log_stream
+* @return
+*            ::NVM_SUCCESS @n
+*            ::NVM_ERR_INVALID_PARAMETER @n
+*            ::NVM_ERR_NO_MEM @n
+*            ::NVM_ERR_UNKNOWN @n
+*/
+NVM_API int nvm_open_error_log_stream(const unsigned char log_level, const unsigned char log_type,
+  const char *cursor_file, struct error_log_stream **pp_stream);
+
+/**
+* @brief Read the next FW error log entry from a stream.
+* @remarks Entries are returned PMem module by PMem module in sequence number order.
+* A PMem module whose log could not be fetched is reported once with its error code,
+* reading may continue with the next PMem module afterwards.
+* @param[in] p_stream Stream opened with nvm_open_error_log_stream
+* @param[out] device_uid The device identifier of the entry
+* @param[out] error_entry pointer to buffer to store a single FW error log entry
+* @return
+*            ::NVM_SUCCESS @n
+*            ::NVM_SUCCESS_NO_ERROR_LOG_ENTRY No more entries in the stream @n
+*            ::NVM_ERR_INVALID_PARAMETER @n
+*            ::NVM_ERR_UNKNOWN @n
+*/
+NVM_API int nvm_read_error_log_stream(struct error_log_stream *p_stream, NVM_UID device_uid, ERROR_LOG *error_entry);
+
+/**
+* @brief Close a stream of FW error log entries.
+* @param[in] p_stream Stream opened with nvm_open_error_log_stream
+* @param[in] save_cursor If 1, the cursor file is updated with the last entries read
+* @return
+*            ::NVM_SUCCESS @n
+*            ::NVM_ERR_INVALID_PARAMETER @n
+*            ::NVM_ERR_DUMP_FILE_OPERATION_FAILED @n
+*/
+NVM_API int nvm_close_error_log_stream(struct error_log_stream *p_stream, const NVM_BOOL save_cursor);
+
+/**
+* @brief Translate system physical addresses to memory module device physical addresses.
+* @remarks The interleave rotation of every persistent and volatile SPA range is
+* computed once per call, so translating many addresses in one call is much cheaper
+* than one call per address.
+* @param[in,out] p_addresses
+*              Array of addresses allocated by the caller. The spa field is the input,
+*              device_handle, dpa and status are filled in for each address.
+* @param[in] count
+*              The number of elements in the array.
+* @return
+*            ::NVM_SUCCESS @n
+*            ::NVM_ERR_INVALID_PARAMETER @n
+*            ::NVM_ERR_NO_MEM @n
+*            ::NVM_ERR_UNKNOWN @n
+*/
+NVM_API int nvm_translate_spa_to_dpa(struct device_address *p_addresses, const NVM_UINT32 count);
+
+/**
+* @brief Translate memory module device physical addresses to system physical addresses.
+* @param[in,out] p_addresses
+*              Array of addresses allocated by the caller. The device_handle and dpa fields
+*              are the input, spa and status are filled in for each address.
+* @param[in] count
+*              The number of elements in the array.
+* @return
+*            ::NVM_SUCCESS @n
+*            ::NVM_ERR_INVALID_PARAMETER @n
+*            ::NVM_ERR_NO_MEM @n
+*            ::NVM_ERR_UNKNOWN @n
+*/
+NVM_API int nvm_translate_dpa_to_spa(struct device_address *p_addresses, const NVM_UINT32 count);
+
 /**
 * @brief Lock API
 */
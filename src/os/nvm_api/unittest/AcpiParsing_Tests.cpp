@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+#include <Uefi.h>
+#include <NvmTables.h>
+#include <AcpiParsing.h>
+}
+
+#define NFIT_DIMMS_NUM        6
+#define NFIT_LINE_SIZE        4096
+#define NFIT_ROTATIONS_NUM    16
+#define NFIT_DPA_BASE         0x10000ULL
+#define NFIT_SPA_BASE_A       0x100000000ULL
+#define NFIT_SPA_BASE_B       0x200000000ULL
+#define NFIT_SPA_BASE_C       0x300000000ULL
+#define NFIT_SPA_BASE_D       0x400000000ULL
+#define NFIT_NOT_INTERLEAVED_SIZE 0x40000ULL
+
+static GUID pm_guid = SPA_RANGE_PM_REGION_GUID;
+static GUID volatile_guid = SPA_RANGE_VOLATILE_REGION_GUID;
+
+/**
+  Synthetic NFIT, the sub-tables are appended in table order
+**/
+class NfitBuilder
+{
+public:
+  std::vector<UINT8> body;
+  std::vector<size_t> offsets;
+
+  template <typename T>
+  void Add(UINT16 type, T table, const std::vector<UINT32> &tail = std::vector<UINT32>())
+  {
+    table.Header.Type = type;
+    table.Header.Length = (UINT16)(sizeof(table) + tail.size() * sizeof(UINT32));
+    offsets.push_back(body.size());
+    body.insert(body.end(), (UINT8 *)&table, (UINT8 *)&table + sizeof(table));
+    body.insert(body.end(), (const UINT8 *)tail.data(), (const UINT8 *)(tail.data() + tail.size()));
+  }
+
+  void AddSpaRange(UINT16 index, const GUID &guid, UINT64 base, UINT64 length)
+  {
+    SpaRangeTbl table;
+
+    memset(&table, 0, sizeof(table));
+    table.SpaRangeDescriptionTableIndex = index;
+    table.AddressRangeTypeGuid = guid;
+    table.SystemPhysicalAddressRangeBase = base;
+    table.SystemPhysicalAddressRangeLength = length;
+    Add(NVDIMM_SPA_RANGE_TYPE, table);
+  }
+
+  void AddRegion(UINT32 dimm, UINT16 spa_index, UINT16 interleave_index, UINT16 ways, UINT64 size, UINT64 dpa_base)
+  {
+    NvDimmRegionMappingStructure table;
+
+    memset(&table, 0, sizeof(table));
+    table.DeviceHandle.AsUint32 = 0x1000 + dimm;
+    table.NvDimmPhysicalId = (UINT16)(dimm + 1);
+    table.SpaRangeDescriptionTableIndex = spa_index;
+    table.NvdimmControlRegionDescriptorTableIndex = (UINT16)(dimm + 1);
+    table.NvDimmRegionSize = size;
+    table.NvDimmPhysicalAddressRegionBase = dpa_base;
+    table.InterleaveStructureIndex = interleave_index;
+    table.InterleaveWays = ways;
+    Add(NVDIMM_NVDIMM_REGION_TYPE, table);
+  }
+
+  void AddInterleave(UINT16 index, const std::vector<UINT32> &lines_offsets)
+  {
+    InterleaveStruct table;
+
+    memset(&table, 0, sizeof(table));
+    table.InterleaveStructureIndex = index;
+    table.NumberOfLinesDescribed = (UINT32)lines_offsets.size();
+    table.LineSize = NFIT_LINE_SIZE;
+    Add(NVDIMM_INTERLEAVE_TYPE, table, lines_offsets);
+  }
+
+  void AddControlRegion(UINT16 index, UINT32 serial_number)
+  {
+    ControlRegionTbl table;
+
+    memset(&table, 0, sizeof(table));
+    table.ControlRegionDescriptorTableIndex = index;
+    table.SerialNumber = serial_number;
+    Add(NVDIMM_CONTROL_REGION_TYPE, table);
+  }
+
+  void AddFlushHint(UINT32 device_handle)
+  {
+    FlushHintTbl table;
+
+    memset(&table, 0, sizeof(table));
+    table.DeviceHandle.AsUint32 = device_handle;
+    Add(NVDIMM_FLUSH_HINT_TYPE, table);
+  }
+
+  std::vector<UINT8> Build()
+  {
+    NFitHeader header;
+    std::vector<UINT8> nfit;
+
+    memset(&header, 0, sizeof(header));
+    header.Header.Signature = SIGNATURE_32('N', 'F', 'I', 'T');
+    header.Header.Length = (UINT32)(sizeof(header) + body.size());
+    header.Header.Revision.AsUint8 = ACPI_REVISION_1;
+    nfit.insert(nfit.end(), (UINT8 *)&header, (UINT8 *)&header + sizeof(header));
+    nfit.insert(nfit.end(), body.begin(), body.end());
+    Checksum(nfit);
+    return nfit;
+  }
+
+  static void Checksum(std::vector<UINT8> &nfit)
+  {
+    UINT8 sum = 0;
+
+    ((NFitHeader *)nfit.data())->Header.Checksum = 0;
+    for (UINT8 byte : nfit) {
+      sum = (UINT8)(sum + byte);
+    }
+    ((NFitHeader *)nfit.data())->Header.Checksum = (UINT8)(0 - sum);
+  }
+};
+
+class AcpiParsing_Tests : public ::testing::Test
+{
+public:
+  NfitBuilder builder;
+  std::vector<UINT8> nfit;
+  ParsedFitHeader *p_fit;
+
+  /**
+    DIMMs 0-2 interleave three ways with two lines each in range 1, DIMMs 3-5
+    three ways with one line each in range 2. DIMM 0 has a second, not
+    interleaved region in range 3 and DIMM 1 a volatile one in range 4.
+    Range 1 is listed twice, lookups must return the first one.
+  **/
+  void SetUp()
+  {
+    UINT64 region_size_a = 2ULL * NFIT_LINE_SIZE * NFIT_ROTATIONS_NUM;
+    UINT64 region_size_b = 1ULL * NFIT_LINE_SIZE * NFIT_ROTATIONS_NUM;
+
+    builder.AddSpaRange(1, pm_guid, NFIT_SPA_BASE_A, 3 * region_size_a);
+    builder.AddSpaRange(2, pm_guid, NFIT_SPA_BASE_B, 3 * region_size_b);
+    builder.AddSpaRange(3, pm_guid, NFIT_SPA_BASE_C, NFIT_NOT_INTERLEAVED_SIZE);
+    builder.AddSpaRange(4, volatile_guid, NFIT_SPA_BASE_D, NFIT_NOT_INTERLEAVED_SIZE);
+    builder.AddSpaRange(1, pm_guid, 0x900000000ULL, 3 * region_size_a);
+    for (UINT32 dimm = 0; dimm < 3; dimm++) {
+      builder.AddInterleave((UINT16)(dimm + 1), {dimm, 3 + dimm});
+      builder.AddRegion(dimm, 1, (UINT16)(dimm + 1), 3, region_size_a, NFIT_DPA_BASE);
+    }
+    for (UINT32 dimm = 3; dimm < NFIT_DIMMS_NUM; dimm++) {
+      builder.AddInterleave((UINT16)(dimm + 1), {dimm - 3});
+      builder.AddRegion(dimm, 2, (UINT16)(dimm + 1), 3, region_size_b, NFIT_DPA_BASE);
+    }
+    builder.AddRegion(0, 3, 0, 1, NFIT_NOT_INTERLEAVED_SIZE, NFIT_DPA_BASE + region_size_a);
+    builder.AddRegion(1, 4, 0, 1, NFIT_NOT_INTERLEAVED_SIZE, NFIT_DPA_BASE + region_size_a);
+    for (UINT32 dimm = 0; dimm < NFIT_DIMMS_NUM; dimm++) {
+      builder.AddControlRegion((UINT16)(dimm + 1), 0xA000 + dimm);
+      builder.AddFlushHint(0x1000 + dimm);
+    }
+    // A second flush hint of DIMM 0, the last one wins
+    builder.AddFlushHint(0x1000);
+
+    nfit = builder.Build();
+    p_fit = NULL;
+    ASSERT_EQ(ParseNfitTable(nfit.data(), &p_fit), EFI_SUCCESS);
+  }
+
+  void TearDown()
+  {
+    FreeParsedNfit(&p_fit);
+  }
+
+  // The linear scan GetSpaRangeTable did before the index
+  SpaRangeTbl *ScanSpaRange(UINT16 index)
+  {
+    for (UINT32 i = 0; i < p_fit->SpaRangeTblesNum; i++) {
+      if (p_fit->ppSpaRangeTbles[i]->SpaRangeDescriptionTableIndex == index) {
+        return p_fit->ppSpaRangeTbles[i];
+      }
+    }
+    return NULL;
+  }
+};
+
+TEST_F(AcpiParsing_Tests, ParseCopiesEverySubTable)
+{
+  EXPECT_EQ(p_fit->SpaRangeTblesNum, 5u);
+  EXPECT_EQ(p_fit->InterleaveTblesNum, (UINT32)NFIT_DIMMS_NUM);
+  EXPECT_EQ(p_fit->NvDimmRegionMappingStructuresNum, (UINT32)NFIT_DIMMS_NUM + 2);
+  EXPECT_EQ(p_fit->ControlRegionTblesNum, (UINT32)NFIT_DIMMS_NUM);
+  EXPECT_EQ(p_fit->FlushHintTblesNum, (UINT32)NFIT_DIMMS_NUM + 1);
+  EXPECT_EQ(p_fit->BWRegionTblesNum, 0u);
+  EXPECT_EQ(memcmp(p_fit->pFit, nfit.data(), sizeof(NFitHeader)), 0);
+
+  // Every parsed sub-table holds the bytes of the table, in table order
+  std::vector<VOID *> parsed;
+  for (UINT32 i = 0; i < p_fit->SpaRangeTblesNum; i++) parsed.push_back(p_fit->ppSpaRangeTbles[i]);
+  for (UINT32 i = 0; i < p_fit->InterleaveTblesNum; i++) parsed.push_back(p_fit->ppInterleaveTbles[i]);
+  for (UINT32 i = 0; i < p_fit->NvDimmRegionMappingStructuresNum; i++) parsed.push_back(p_fit->ppNvDimmRegionMappingStructures[i]);
+  for (UINT32 i = 0; i < p_fit->ControlRegionTblesNum; i++) parsed.push_back(p_fit->ppControlRegionTbles[i]);
+  for (UINT32 i = 0; i < p_fit->FlushHintTblesNum; i++) parsed.push_back(p_fit->ppFlushHintTbles[i]);
+
+  size_t matched = 0;
+  for (size_t offset : builder.offsets) {
+    const UINT8 *p_source = builder.body.data() + offset;
+    UINT16 length = ((const SubTableHeader *)p_source)->Length;
+
+    for (VOID *p_table : parsed) {
+      if (((SubTableHeader *)p_table)->Type == ((const SubTableHeader *)p_source)->Type &&
+          memcmp(p_table, p_source, length) == 0) {
+        matched++;
+        break;
+      }
+    }
+  }
+  EXPECT_EQ(matched, builder.offsets.size());
+}
+
+TEST_F(AcpiParsing_Tests, ParseRejectsCorruptedTables)
+{
+  std::vector<UINT8> corrupted = nfit;
+  ParsedFitHeader *p_corrupted = NULL;
+
+  corrupted[sizeof(NFitHeader)] ^= 0x1;
+  EXPECT_EQ(ParseNfitTable(corrupted.data(), &p_corrupted), EFI_VOLUME_CORRUPTED);
+  EXPECT_EQ(p_corrupted, (ParsedFitHeader *)NULL);
+
+  // The last sub-table claims more bytes than the table has left
+  corrupted = nfit;
+  ((SubTableHeader *)(corrupted.data() + sizeof(NFitHeader) + builder.offsets.back()))->Length += 4;
+  NfitBuilder::Checksum(corrupted);
+  EXPECT_EQ(ParseNfitTable(corrupted.data(), &p_corrupted), EFI_INVALID_PARAMETER);
+  EXPECT_EQ(p_corrupted, (ParsedFitHeader *)NULL);
+}
+
+TEST_F(AcpiParsing_Tests, IndexedLookupsMatchLinearScans)
+{
+  for (UINT16 index = 0; index < 8; index++) {
+    SpaRangeTbl *p_spa_range = NULL;
+    InterleaveStruct *p_interleave = NULL;
+    InterleaveStruct *p_expected_interleave = NULL;
+
+    EXPECT_EQ(GetSpaRangeTable(p_fit, index, &p_spa_range) == EFI_SUCCESS, ScanSpaRange(index) != NULL);
+    EXPECT_EQ(p_spa_range, ScanSpaRange(index)) << "SPA range " << index;
+
+    for (UINT32 i = 0; i < p_fit->InterleaveTblesNum && p_expected_interleave == NULL; i++) {
+      if (p_fit->ppInterleaveTbles[i]->InterleaveStructureIndex == index) {
+        p_expected_interleave = p_fit->ppInterleaveTbles[i];
+      }
+    }
+    GetInterleaveTable(p_fit, index, &p_interleave);
+    EXPECT_EQ(p_interleave, p_expected_interleave) << "interleave " << index;
+  }
+  // The duplicated SPA range index resolves to the first table
+  SpaRangeTbl *p_spa_range = NULL;
+  ASSERT_EQ(GetSpaRangeTable(p_fit, 1, &p_spa_range), EFI_SUCCESS);
+  EXPECT_EQ(p_spa_range->SystemPhysicalAddressRangeBase, NFIT_SPA_BASE_A);
+
+  for (UINT16 pid = 1; pid <= NFIT_DIMMS_NUM + 1; pid++) {
+    NvDimmRegionMappingStructure *p_region = NULL;
+    NvDimmRegionMappingStructure *p_expected_region = NULL;
+    NvDimmRegionMappingStructure *p_expected_pm_region = NULL;
+    ControlRegionTbl *p_control_regions[4];
+    UINT32 control_regions_num = 4;
+
+    for (UINT32 i = 0; i < p_fit->NvDimmRegionMappingStructuresNum; i++) {
+      NvDimmRegionMappingStructure *p_table = p_fit->ppNvDimmRegionMappingStructures[i];
+
+      if (p_table->NvDimmPhysicalId == pid && p_expected_region == NULL) {
+        p_expected_region = p_table;
+      }
+      if (p_table->NvDimmPhysicalId == pid && p_expected_pm_region == NULL &&
+          memcmp(&ScanSpaRange(p_table->SpaRangeDescriptionTableIndex)->AddressRangeTypeGuid, &pm_guid, sizeof(GUID)) == 0 &&
+          p_table->SpaRangeDescriptionTableIndex == 3) {
+        p_expected_pm_region = p_table;
+      }
+    }
+
+    GetNvDimmRegionMappingStructureForPid(p_fit, pid, NULL, FALSE, 0, &p_region);
+    EXPECT_EQ(p_region, p_expected_region) << "PID " << pid;
+    p_region = NULL;
+    GetNvDimmRegionMappingStructureForPid(p_fit, pid, &pm_guid, TRUE, 3, &p_region);
+    EXPECT_EQ(p_region, p_expected_pm_region) << "PID " << pid;
+
+    ASSERT_EQ(GetControlRegionTablesForPID(p_fit, pid, p_control_regions, &control_regions_num), EFI_SUCCESS);
+    if (pid <= NFIT_DIMMS_NUM) {
+      ASSERT_EQ(control_regions_num, 1u) << "PID " << pid;
+      EXPECT_EQ(p_control_regions[0]->SerialNumber, 0xA000u + pid - 1);
+    } else {
+      EXPECT_EQ(control_regions_num, 0u);
+    }
+  }
+
+  // Flush hints by device handle return the last matching table
+  FlushHintTbl *p_flush_hint = NULL;
+  ASSERT_EQ(GetFlushHintTableForNvDimmRegionTable(p_fit, p_fit->ppNvDimmRegionMappingStructures[0], &p_flush_hint), EFI_SUCCESS);
+  EXPECT_EQ(p_flush_hint, p_fit->ppFlushHintTbles[p_fit->FlushHintTblesNum - 1]);
+}
+
+TEST_F(AcpiParsing_Tests, TranslationMatchesRdpaToSpaAndRoundTrips)
+{
+  ADDRESS_TRANSLATION_MAP *p_map = NULL;
+
+  ASSERT_EQ(BuildAddressTranslationMap(p_fit, &p_map), EFI_SUCCESS);
+  srand(33);
+
+  for (UINT32 i = 0; i < p_fit->NvDimmRegionMappingStructuresNum; i++) {
+    NvDimmRegionMappingStructure *p_region = p_fit->ppNvDimmRegionMappingStructures[i];
+    SpaRangeTbl *p_spa_range = NULL;
+    InterleaveStruct *p_interleave = NULL;
+
+    ASSERT_EQ(GetSpaRangeTable(p_fit, p_region->SpaRangeDescriptionTableIndex, &p_spa_range), EFI_SUCCESS);
+    if (p_region->InterleaveStructureIndex != 0) {
+      ASSERT_EQ(GetInterleaveTable(p_fit, p_region->InterleaveStructureIndex, &p_interleave), EFI_SUCCESS);
+    }
+
+    for (int round = 0; round < 1000; round++) {
+      UINT64 rdpa = ((UINT64)rand() << 16 ^ (UINT64)rand()) % p_region->NvDimmRegionSize;
+      UINT64 expected_spa = 0;
+      UINT64 spa = 0;
+      UINT64 dpa = 0;
+      NvDimmRegionMappingStructure *p_found = NULL;
+
+      ASSERT_EQ(RdpaToSpa(rdpa, p_region, p_spa_range, p_interleave, &expected_spa), EFI_SUCCESS);
+      ASSERT_EQ(TranslateDpaToSpa(p_map, p_region->DeviceHandle.AsUint32, p_region->NvDimmPhysicalAddressRegionBase + rdpa, &spa),
+        EFI_SUCCESS);
+      ASSERT_EQ(spa, expected_spa) << "region " << i << " rdpa " << rdpa;
+
+      ASSERT_EQ(TranslateSpaToDpa(p_map, spa, &p_found, &dpa), EFI_SUCCESS) << "spa " << spa;
+      EXPECT_EQ(p_found, p_region);
+      EXPECT_EQ(dpa, p_region->NvDimmPhysicalAddressRegionBase + rdpa);
+    }
+  }
+
+  // Every line of an interleaved range belongs to exactly one region
+  for (UINT64 spa = NFIT_SPA_BASE_A; spa < NFIT_SPA_BASE_A + 6ULL * NFIT_LINE_SIZE * NFIT_ROTATIONS_NUM; spa += 512) {
+    NvDimmRegionMappingStructure *p_found = NULL;
+    UINT64 dpa = 0;
+    UINT64 back = 0;
+
+    ASSERT_EQ(TranslateSpaToDpa(p_map, spa, &p_found, &dpa), EFI_SUCCESS) << "spa " << spa;
+    ASSERT_EQ(TranslateDpaToSpa(p_map, p_found->DeviceHandle.AsUint32, dpa, &back), EFI_SUCCESS);
+    EXPECT_EQ(back, spa);
+  }
+
+  NvDimmRegionMappingStructure *p_found = NULL;
+  UINT64 address = 0;
+  EXPECT_EQ(TranslateSpaToDpa(p_map, NFIT_SPA_BASE_A - 1, &p_found, &address), EFI_NOT_FOUND);
+  EXPECT_EQ(TranslateSpaToDpa(p_map, NFIT_SPA_BASE_C + NFIT_NOT_INTERLEAVED_SIZE, &p_found, &address), EFI_NOT_FOUND);
+  EXPECT_EQ(TranslateDpaToSpa(p_map, 0x1000, NFIT_DPA_BASE - 1, &address), EFI_NOT_FOUND);
+  EXPECT_EQ(TranslateDpaToSpa(p_map, 0x1FFF, NFIT_DPA_BASE, &address), EFI_NOT_FOUND);
+
+  FreeAddressTranslationMap(&p_map);
+  EXPECT_EQ(p_map, (ADDRESS_TRANSLATION_MAP *)NULL);
+}
+
+TEST_F(AcpiParsing_Tests, ParseBenchmark)
+{
+  const UINT32 sizes[] = {100, 1000, 10000};
+
+  for (UINT32 size : sizes) {
+    NfitBuilder large;
+    ParsedFitHeader *p_large = NULL;
+
+    // The sub-table length limits the NFIT to 4 GiB, control regions keep it well below
+    for (UINT32 i = 0; i < size; i++) {
+      large.AddControlRegion((UINT16)(i + 1), i);
+    }
+    std::vector<UINT8> large_nfit = large.Build();
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(ParseNfitTable(large_nfit.data(), &p_large), EFI_SUCCESS);
+    auto parse_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    ASSERT_EQ(p_large->ControlRegionTblesNum, size);
+    std::cout << size << " sub-tables parsed in " << parse_us << " us" << std::endl;
+    FreeParsedNfit(&p_large);
+  }
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <Uefi.h>
+#include <Btt.h>
+#include <Namespace.h>
+}
+
+#define BTT_TEST_IMAGE_SIZE       MIB_TO_BYTES(32)
+#define BTT_TEST_LBA_SIZE         512
+#define BTT_TEST_THREADS_NUM      16
+#define BTT_TEST_PASSES_NUM       4
+// Blocks written by each thread of the benchmark
+#define BTT_BENCHMARK_BLOCKS_NUM  1024
+
+/**
+  A BTT on a namespace image in memory, the OS build does its namespace I/O
+  on a mapped image like "ipmctl show -namespace -image" does.
+**/
+class Btt_Tests : public ::testing::Test
+{
+public:
+  std::vector<UINT8> image;
+  NAMESPACE ns;
+  GUID parent_uuid;
+  BTT *p_btt;
+
+  void SetUp()
+  {
+    std::vector<UINT8> block(BTT_TEST_LBA_SIZE, 0);
+
+    image.assign(BTT_TEST_IMAGE_SIZE, 0);
+    memset(&ns, 0, sizeof(ns));
+    memset(&parent_uuid, 0x5a, sizeof(parent_uuid));
+    ns.Major = NSINDEX_MAJOR;
+    ns.Minor = NSINDEX_MINOR_2;
+    ns.pImage = image.data();
+    ns.ImageSize = image.size();
+
+    p_btt = BttInit(image.size(), BTT_TEST_LBA_SIZE, &parent_uuid, &ns);
+    ASSERT_TRUE(p_btt != NULL);
+    // The first write lays the BTT out, which is not done concurrently
+    ASSERT_EQ(BttWrite(p_btt, 0, block.data()), EFI_SUCCESS);
+    ASSERT_TRUE(p_btt->Laidout);
+    ASSERT_GE(p_btt->NLanes, (UINT32)BTT_TEST_THREADS_NUM);
+  }
+
+  void TearDown()
+  {
+    if (p_btt != NULL) {
+      BttRelease(p_btt);
+    }
+  }
+
+  // Lanes are handed out up to NLanes, fewer lanes make the threads share them
+  void LimitLanes(UINT32 lanes_num)
+  {
+    p_btt->NLanes = lanes_num;
+    p_btt->NextLane = 0;
+  }
+
+  void ExpectAllLanesReleased()
+  {
+    for (UINT32 lane = 0; lane < p_btt->NFree; lane++) {
+      EXPECT_FALSE(p_btt->pLaneInUse[lane]) << "lane " << lane;
+    }
+  }
+};
+
+static void FillBlock(std::vector<UINT8> &block, UINT64 lba, UINT32 pass)
+{
+  for (size_t i = 0; i < block.size(); i++) {
+    block[i] = (UINT8)(lba * 7 + pass * 13 + i);
+  }
+}
+
+TEST_F(Btt_Tests, ConcurrentWritesKeepEveryBlock)
+{
+  const UINT64 blocks_per_thread = 64;
+  std::vector<std::thread> threads;
+  std::atomic<int> failures(0);
+
+  // Neighbour LBAs share a map cache line, each one is written by another thread
+  LimitLanes(4);
+  for (UINT32 t = 0; t < BTT_TEST_THREADS_NUM; t++) {
+    threads.emplace_back([&, t]() {
+      std::vector<UINT8> block(BTT_TEST_LBA_SIZE);
+
+      for (UINT32 pass = 0; pass < BTT_TEST_PASSES_NUM; pass++) {
+        for (UINT64 i = 0; i < blocks_per_thread; i++) {
+          UINT64 lba = i * BTT_TEST_THREADS_NUM + t;
+
+          FillBlock(block, lba, pass);
+          if (EFI_SUCCESS != BttWrite(p_btt, lba, block.data())) {
+            failures++;
+          }
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(failures.load(), 0);
+  ExpectAllLanesReleased();
+
+  // A map update lost to a concurrent write of the same cache line shows up as an older block
+  std::vector<UINT8> expected(BTT_TEST_LBA_SIZE);
+  std::vector<UINT8> blocks(blocks_per_thread * BTT_TEST_THREADS_NUM * BTT_TEST_LBA_SIZE);
+  ASSERT_EQ(BttReadBlocks(p_btt, 0, blocks_per_thread * BTT_TEST_THREADS_NUM, blocks.data()), EFI_SUCCESS);
+  for (UINT64 lba = 0; lba < blocks_per_thread * BTT_TEST_THREADS_NUM; lba++) {
+    FillBlock(expected, lba, BTT_TEST_PASSES_NUM - 1);
+    EXPECT_EQ(memcmp(&blocks[lba * BTT_TEST_LBA_SIZE], expected.data(), BTT_TEST_LBA_SIZE), 0) << "LBA " << lba;
+  }
+}
+
+TEST_F(Btt_Tests, AcquireLaneWaitsForRelease)
+{
+  UINT32 lane = 0;
+  UINT32 waiter_lane = MAX_UINT32;
+  EFI_STATUS waiter_rc = EFI_NOT_STARTED;
+  std::atomic<bool> acquired(false);
+
+  LimitLanes(1);
+  ASSERT_EQ(BttAcquireLane(p_btt, &lane), EFI_SUCCESS);
+
+  std::thread waiter([&]() {
+    waiter_rc = BttAcquireLane(p_btt, &waiter_lane);
+    acquired = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(acquired.load());
+
+  BttReleaseLane(p_btt, lane);
+  waiter.join();
+  EXPECT_EQ(waiter_rc, EFI_SUCCESS);
+  EXPECT_EQ(waiter_lane, lane);
+  BttReleaseLane(p_btt, waiter_lane);
+  ExpectAllLanesReleased();
+}
+
+TEST_F(Btt_Tests, LaneThroughputBenchmark)
+{
+  for (UINT32 lanes_num : {1u, 4u, 16u}) {
+    std::vector<std::thread> threads;
+    std::atomic<int> failures(0);
+
+    LimitLanes(lanes_num);
+    auto start = std::chrono::steady_clock::now();
+    for (UINT32 t = 0; t < BTT_TEST_THREADS_NUM; t++) {
+      threads.emplace_back([&, t]() {
+        std::vector<UINT8> block(BTT_TEST_LBA_SIZE);
+
+        for (UINT64 i = 0; i < BTT_BENCHMARK_BLOCKS_NUM; i++) {
+          UINT64 lba = t * BTT_BENCHMARK_BLOCKS_NUM + i;
+
+          FillBlock(block, lba, lanes_num);
+          if (EFI_SUCCESS != BttWrite(p_btt, lba, block.data())) {
+            failures++;
+          }
+        }
+      });
+    }
+    for (std::thread &thread : threads) {
+      thread.join();
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(failures.load(), 0);
+    ExpectAllLanesReleased();
+    std::cout << lanes_num << " lanes, " << BTT_TEST_THREADS_NUM << " threads: "
+      << (UINT64)BTT_TEST_THREADS_NUM * BTT_BENCHMARK_BLOCKS_NUM * 1000000 / (us ? us : 1) << " blocks/s" << std::endl;
+  }
+}
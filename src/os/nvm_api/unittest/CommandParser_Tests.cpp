@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <cwctype>
+#include <iostream>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <Uefi.h>
+#include <CommandParser.h>
+
+EFI_STATUS findVerb(UINTN *pStart, struct CommandInput *pInput, struct Command *pCommand);
+void FreeCommands();
+INTN StrICmp(CONST CHAR16 *pFirstString, CONST CHAR16 *pSecondString);
+}
+
+#define REGISTERED_VERBS_NUM  40
+#define FUZZ_ROUNDS           20000
+
+static const wchar_t verb_chars[] = L"abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789-_";
+
+static std::wstring RandomWord(size_t min_len, size_t max_len)
+{
+  std::wstring word;
+  size_t len = min_len + (size_t)rand() % (max_len - min_len + 1);
+
+  for (size_t i = 0; i < len; i++) {
+    word += verb_chars[(size_t)rand() % (sizeof(verb_chars) / sizeof(verb_chars[0]) - 1)];
+  }
+  return word;
+}
+
+static std::wstring RandomCase(std::wstring word)
+{
+  for (wchar_t &c : word) {
+    if (rand() % 2) {
+      c = (wchar_t)(iswupper(c) ? towlower(c) : towupper(c));
+    }
+  }
+  return word;
+}
+
+static bool EqualsIgnoreCase(const std::wstring &first, const std::wstring &second)
+{
+  if (first.size() != second.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < first.size(); i++) {
+    if (towlower(first[i]) != towlower(second[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+class CommandParser_Tests : public ::testing::Test
+{
+public:
+  std::vector<std::wstring> verbs;
+
+  void SetUp()
+  {
+    srand(45);
+    FreeCommands();
+    // Some verbs are registered by several commands, as show and set are
+    for (int i = 0; i < REGISTERED_VERBS_NUM; i++) {
+      std::wstring verb = (i % 4 == 3) ? RandomCase(verbs[(size_t)rand() % verbs.size()]) : RandomWord(1, VERB_LEN - 1);
+      Register(verb);
+    }
+  }
+
+  void TearDown()
+  {
+    FreeCommands();
+  }
+
+  void Register(const std::wstring &verb)
+  {
+    struct Command command = {};
+
+    wcsncpy(command.verb, verb.c_str(), VERB_LEN - 1);
+    ASSERT_EQ(RegisterCommand(&command), EFI_SUCCESS);
+    verbs.push_back(verb);
+  }
+
+  bool IsRegistered(const std::wstring &token)
+  {
+    for (const std::wstring &verb : verbs) {
+      if (EqualsIgnoreCase(verb, token)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  EFI_STATUS FindVerb(const std::wstring &token, struct Command *p_command)
+  {
+    std::wstring token_copy = token;
+    CHAR16 *p_token = &token_copy[0];
+    struct CommandInput input = {1, &p_token};
+    UINTN start = 0;
+
+    return findVerb(&start, &input, p_command);
+  }
+
+  std::wstring RandomToken()
+  {
+    const std::wstring &verb = verbs[(size_t)rand() % verbs.size()];
+
+    switch (rand() % 5) {
+    case 0:
+      return RandomCase(verb);
+    case 1:
+      return verb.substr(0, (size_t)rand() % verb.size());
+    case 2:
+      return verb + RandomWord(1, 3);
+    case 3:
+      return RandomWord(0, VERB_LEN - 1);
+    default:
+      return verb;
+    }
+  }
+};
+
+TEST_F(CommandParser_Tests, VerbLookupFuzzMatchesLinearScan)
+{
+  for (int round = 0; round < FUZZ_ROUNDS; round++) {
+    std::wstring token = RandomToken();
+    struct Command command = {};
+    EFI_STATUS rc = FindVerb(token, &command);
+
+    if (IsRegistered(token)) {
+      ASSERT_EQ(rc, EFI_SUCCESS) << "token \"" << std::string(token.begin(), token.end()) << "\"";
+      EXPECT_EQ(std::wstring(command.verb), token);
+    } else {
+      ASSERT_NE(rc, EFI_SUCCESS) << "token \"" << std::string(token.begin(), token.end()) << "\"";
+    }
+  }
+}
+
+TEST_F(CommandParser_Tests, VerbLookupSeesLateRegistrations)
+{
+  struct Command command = {};
+
+  // The verb index is built by the first lookup and has to be rebuilt after a registration
+  EXPECT_NE(FindVerb(L"zz-late-verb", &command), EFI_SUCCESS);
+  Register(L"zz-late-verb");
+  EXPECT_EQ(FindVerb(L"ZZ-Late-Verb", &command), EFI_SUCCESS);
+  EXPECT_EQ(FindVerb(verbs[0], &command), EFI_SUCCESS);
+}
+
+TEST_F(CommandParser_Tests, VerbLookupBenchmark)
+{
+  std::vector<std::wstring> tokens;
+  size_t found = 0;
+  size_t found_linear = 0;
+
+  // Only registered verbs, a miss also formats the syntax error
+  for (int round = 0; round < FUZZ_ROUNDS; round++) {
+    tokens.push_back(RandomCase(verbs[(size_t)rand() % verbs.size()]));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (const std::wstring &token : tokens) {
+    struct Command command = {};
+    found += (FindVerb(token, &command) == EFI_SUCCESS) ? 1 : 0;
+  }
+  auto index_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  // The scan findVerb did before the verb index
+  start = std::chrono::steady_clock::now();
+  for (const std::wstring &token : tokens) {
+    for (const std::wstring &verb : verbs) {
+      if (StrICmp(verb.c_str(), token.c_str()) == 0) {
+        found_linear++;
+        break;
+      }
+    }
+  }
+  auto linear_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << tokens.size() << " lookups over " << verbs.size() << " commands: verb index " << index_us
+    << " us, StrICmp scan " << linear_us << " us" << std::endl;
+  EXPECT_EQ(found, found_linear);
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+extern "C" {
+#include <Uefi.h>
+#include <Dimm.h>
+#include <Pbr.h>
+#include <PbrDcpmm.h>
+#include <PbrTypes.h>
+
+int init_protocol_bs();
+}
+
+// A FW command reply, in the order the passthrough reads them
+struct ScriptedReply
+{
+  UINT8 opcode;
+  UINT8 sub_opcode;
+  std::vector<UINT8> output;
+  std::vector<UINT8> large_output;
+};
+
+// Simulated mailbox latency of a PCD or LSA write, a chain of payload transactions
+#define SIMULATED_TRANSACTIONS_NUM    10
+#define SIMULATED_TRANSACTION_MS      2
+
+static EFI_STATUS SimulatedPcdWriteWorker(DIMM *p_dimm, VOID *p_arg)
+{
+  for (int i = 0; i < SIMULATED_TRANSACTIONS_NUM; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(SIMULATED_TRANSACTION_MS));
+  }
+  return (p_dimm->DimmID == *(UINT16 *)p_arg) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+}
+
+// Wall time in milliseconds of the simulated write on dimms_num DIMMs
+static long long TimeSimulatedPcdWrites(UINT32 dimms_num, std::vector<EFI_STATUS> &return_codes)
+{
+  std::vector<DIMM> dimms(dimms_num);
+  std::vector<DIMM *> p_dimms(dimms_num);
+  std::vector<UINT16> dimm_ids(dimms_num);
+  std::vector<VOID *> p_args(dimms_num);
+
+  for (UINT32 i = 0; i < dimms_num; i++) {
+    memset(&dimms[i], 0, sizeof(DIMM));
+    dimms[i].DimmID = (UINT16)(i + 1);
+    dimm_ids[i] = dimms[i].DimmID;
+    p_dimms[i] = &dimms[i];
+    p_args[i] = &dimm_ids[i];
+  }
+  return_codes.assign(dimms_num, EFI_NOT_STARTED);
+
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_EQ(RunOnDimms(p_dimms.data(), dimms_num, SimulatedPcdWriteWorker, p_args.data(), return_codes.data()), EFI_SUCCESS);
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+class Dimm_Tests : public ::testing::Test
+{
+public:
+  DIMM dimm;
+  UINT32 tag_id;
+
+  void SetUp()
+  {
+    // The boot services nvm_init() installs, the passthrough looks up the driver through them
+    init_protocol_bs();
+    memset(&dimm, 0, sizeof(dimm));
+    dimm.DimmID = 1;
+    dimm.DeviceHandle.AsUint32 = 0x1000;
+    ASSERT_EQ(PbrSetSession(NULL, 0), EFI_SUCCESS);
+    ASSERT_EQ(PbrSetMode(PBR_RECORD_MODE), EFI_SUCCESS);
+    ASSERT_EQ(PbrSetTag(PBR_DCPMM_CLI_SIG, L"dimm test", L"0", &tag_id), EFI_SUCCESS);
+  }
+
+  void TearDown()
+  {
+    PbrSetMode(PBR_NORMAL_MODE);
+    FreeCommandEffectLogCache();
+  }
+
+  // Successful replies, played back by the passthrough in this order
+  void Script(const std::vector<ScriptedReply> &replies)
+  {
+    for (const ScriptedReply &reply : replies) {
+      UINT32 out_size = (UINT32)reply.output.size();
+      UINT32 large_out_size = (UINT32)reply.large_output.size();
+      VOID *p_data = NULL;
+
+      ASSERT_EQ(PbrSetData(PBR_PASS_THRU_SIG, NULL, sizeof(PbrPassThruReq) + sizeof(PbrPassThruResp) + out_size + large_out_size,
+        FALSE, &p_data, NULL), EFI_SUCCESS);
+      PbrPassThruReq *p_req = (PbrPassThruReq *)p_data;
+      PbrPassThruResp *p_resp = (PbrPassThruResp *)(p_req + 1);
+
+      p_req->DimmId = dimm.DeviceHandle.AsUint32;
+      p_req->Opcode = reply.opcode;
+      p_req->SubOpcode = reply.sub_opcode;
+      p_resp->DimmId = p_req->DimmId;
+      p_resp->Status = FW_SUCCESS;
+      p_resp->PassthruReturnCode = EFI_SUCCESS;
+      p_resp->OutputPayloadSize = out_size;
+      p_resp->OutputLargePayloadSize = large_out_size;
+      // The passthrough reads the payloads right after the whole response header
+      if (0 != out_size) {
+        memcpy(p_resp + 1, reply.output.data(), out_size);
+      }
+      if (0 != large_out_size) {
+        memcpy((UINT8 *)(p_resp + 1) + out_size, reply.large_output.data(), large_out_size);
+      }
+    }
+    ASSERT_EQ(PbrSetMode(PBR_PLAYBACK_MODE), EFI_SUCCESS);
+    ASSERT_EQ(PbrResetSession(tag_id), EFI_SUCCESS);
+  }
+
+  EFI_STATUS Send(UINT8 opcode, UINT8 sub_opcode)
+  {
+    NVM_FW_CMD *p_cmd = new NVM_FW_CMD();
+    EFI_STATUS rc;
+
+    p_cmd->DimmID = dimm.DimmID;
+    p_cmd->Opcode = opcode;
+    p_cmd->SubOpcode = sub_opcode;
+    rc = PassThru(&dimm, p_cmd, PT_TIMEOUT_INTERVAL);
+    delete p_cmd;
+    return rc;
+  }
+
+  // Replies reading a CEL with one entry, over the mailbox the passthrough picks
+  std::vector<ScriptedReply> CelReplies(UINT8 opcode, UINT8 sub_opcode, UINT32 effects)
+  {
+    PT_OUTPUT_PAYLOAD_GET_COMMAND_EFFECT_LOG count;
+    PT_OUTPUT_PAYLOAD_GET_COMMAND_EFFECT_LOG entries;
+    BOOLEAN large_payload = FALSE;
+
+    memset(&count, 0, sizeof(count));
+    memset(&entries, 0, sizeof(entries));
+    count.LogTypeData.CelCount.LogEntryCount = 1;
+    entries.LogTypeData.CelEntries.CelEntry[0].Opcode.Separated.Opcode = opcode;
+    entries.LogTypeData.CelEntries.CelEntry[0].Opcode.Separated.SubOpcode = sub_opcode;
+    entries.LogTypeData.CelEntries.CelEntry[0].EffectName.AsUint32 = effects;
+    EXPECT_EQ(IsLargePayloadAvailable(&dimm, &large_payload), EFI_SUCCESS);
+
+    std::vector<UINT8> count_bytes((UINT8 *)&count, (UINT8 *)(&count + 1));
+    std::vector<UINT8> entry_bytes((UINT8 *)&entries, (UINT8 *)(&entries.LogTypeData.CelEntries.CelEntry[1]));
+    if (large_payload) {
+      return {{PtGetLog, SubopCommandEffectLog, count_bytes}, {PtGetLog, SubopCommandEffectLog, count_bytes, entry_bytes}};
+    }
+    entry_bytes.resize(sizeof(entries));
+    return {{PtGetLog, SubopCommandEffectLog, count_bytes}, {PtGetLog, SubopCommandEffectLog, entry_bytes}};
+  }
+
+  void TakeSnapshot(EFI_STATUS read_rc)
+  {
+    dimm.SmartSnapshotReturnCode = read_rc;
+    StampSmartSnapshot(&dimm);
+  }
+};
+
+TEST_F(Dimm_Tests, SmartSnapshotLastsOneInvocationWithoutTtl)
+{
+  TakeSnapshot(EFI_SUCCESS);
+  EXPECT_EQ(dimm.SmartSnapshotFetches, 1u);
+  EXPECT_TRUE(IsSmartSnapshotFresh(&dimm, 0, 0));
+
+  StartSmartSnapshotEpoch();
+  EXPECT_FALSE(IsSmartSnapshotFresh(&dimm, 0, 0));
+
+  // A failed read is returned once and read again by the next consumer
+  TakeSnapshot(EFI_DEVICE_ERROR);
+  EXPECT_EQ(dimm.SmartSnapshotFetches, 2u);
+  EXPECT_FALSE(IsSmartSnapshotFresh(&dimm, 0, 0));
+  EXPECT_FALSE(IsSmartSnapshotFresh(NULL, 0, 0));
+}
+
+TEST_F(Dimm_Tests, SmartSnapshotTtlOutlivesInvocations)
+{
+  TakeSnapshot(EFI_SUCCESS);
+  dimm.SmartSnapshotTimeMs = 1000;
+
+  StartSmartSnapshotEpoch();
+  EXPECT_TRUE(IsSmartSnapshotFresh(&dimm, 500, 1000));
+  EXPECT_TRUE(IsSmartSnapshotFresh(&dimm, 500, 1499));
+  EXPECT_FALSE(IsSmartSnapshotFresh(&dimm, 500, 1500));
+
+  // The TTL does not keep a snapshot a FW command dropped
+  dimm.SmartSnapshotValid = FALSE;
+  EXPECT_FALSE(IsSmartSnapshotFresh(&dimm, 500, 1000));
+}
+
+TEST_F(Dimm_Tests, MutatingFwCommandDropsSmartSnapshot)
+{
+  Script({
+    {PtGetSecInfo, SubopGetSecState}, {PtGetLog, SubopSmartHealth}, {PtSetFeatures, SubopAlarmThresholds},
+  });
+
+  TakeSnapshot(EFI_SUCCESS);
+  ASSERT_EQ(Send(PtGetSecInfo, SubopGetSecState), EFI_SUCCESS);
+  EXPECT_TRUE(IsSmartSnapshotFresh(&dimm, 0, 0));
+  ASSERT_EQ(Send(PtGetLog, SubopSmartHealth), EFI_SUCCESS);
+  EXPECT_TRUE(IsSmartSnapshotFresh(&dimm, 0, 0));
+
+  // Without a CEL entry a set command is taken as changing the SMART data
+  ASSERT_EQ(Send(PtSetFeatures, SubopAlarmThresholds), EFI_SUCCESS);
+  EXPECT_FALSE(IsSmartSnapshotFresh(&dimm, 0, 0));
+}
+
+TEST_F(Dimm_Tests, FirstFwCommandFetchesCommandEffectLog)
+{
+  std::vector<ScriptedReply> replies = CelReplies(PtSetFeatures, SubopAlarmThresholds, 0x1);
+
+  // The CEL is keyed by the FW version, read by the first command of the build
+  dimm.FwVer.FwProduct = 1;
+  dimm.FwVer.FwBuild = 2;
+  replies.push_back({PtSetFeatures, SubopAlarmThresholds});
+  replies.push_back({PtSetFeatures, SubopAlarmThresholds});
+  replies.push_back({PtSetAdminFeatures, SubopPlatformDataInfo});
+  Script(replies);
+
+  TakeSnapshot(EFI_SUCCESS);
+  ASSERT_EQ(Send(PtSetFeatures, SubopAlarmThresholds), EFI_SUCCESS);
+  EXPECT_TRUE(IsSmartSnapshotFresh(&dimm, 0, 0));
+  EXPECT_EQ(GetFwCmdEffect(&dimm, PtSetFeatures, SubopAlarmThresholds), FwCmdEffectReadOnly);
+
+  // Later commands use the cached CEL, a command without an entry is unknown
+  ASSERT_EQ(Send(PtSetFeatures, SubopAlarmThresholds), EFI_SUCCESS);
+  EXPECT_TRUE(IsSmartSnapshotFresh(&dimm, 0, 0));
+  ASSERT_EQ(Send(PtSetAdminFeatures, SubopPlatformDataInfo), EFI_SUCCESS);
+  EXPECT_FALSE(IsSmartSnapshotFresh(&dimm, 0, 0));
+}
+
+TEST_F(Dimm_Tests, PlaybackWithoutCommandEffectLogKeepsRecordsInStep)
+{
+  // A session recorded without the CEL read replays its commands unclassified
+  dimm.FwVer.FwProduct = 1;
+  dimm.FwVer.FwBuild = 3;
+  Script({{PtGetSecInfo, SubopGetSecState}, {PtSetFeatures, SubopAlarmThresholds}});
+
+  TakeSnapshot(EFI_SUCCESS);
+  ASSERT_EQ(Send(PtGetSecInfo, SubopGetSecState), EFI_SUCCESS);
+  EXPECT_TRUE(IsSmartSnapshotFresh(&dimm, 0, 0));
+  ASSERT_EQ(Send(PtSetFeatures, SubopAlarmThresholds), EFI_SUCCESS);
+  EXPECT_FALSE(IsSmartSnapshotFresh(&dimm, 0, 0));
+  EXPECT_EQ(GetFwCmdEffect(&dimm, PtSetFeatures, SubopAlarmThresholds), FwCmdEffectUnknown);
+}
+
+TEST_F(Dimm_Tests, ErrorLogSequenceNumbersWrapAround)
+{
+  EXPECT_TRUE(IsSequenceNumberAfter(2, 1));
+  EXPECT_FALSE(IsSequenceNumberAfter(1, 2));
+  EXPECT_FALSE(IsSequenceNumberAfter(7, 7));
+
+  // Entries logged after the wrap come after the last ones of the lap before
+  EXPECT_TRUE(IsSequenceNumberAfter(0, MAX_UINT16));
+  EXPECT_TRUE(IsSequenceNumberAfter(0x10, 0xFFF0));
+  EXPECT_FALSE(IsSequenceNumberAfter(0xFFF0, 0x10));
+}
+
+TEST_F(Dimm_Tests, RunOnDimmsOverlapsSimulatedLatency)
+{
+  const long long one_dimm_ms = SIMULATED_TRANSACTIONS_NUM * SIMULATED_TRANSACTION_MS;
+  std::vector<EFI_STATUS> return_codes;
+
+  // The latency is injected in the workers, a PBR session would serialize them
+  ASSERT_EQ(PbrSetMode(PBR_NORMAL_MODE), EFI_SUCCESS);
+  for (UINT32 dimms_num : {1u, 4u, 12u, 24u}) {
+    long long parallel_ms = TimeSimulatedPcdWrites(dimms_num, return_codes);
+
+    for (EFI_STATUS rc : return_codes) {
+      EXPECT_EQ(rc, EFI_SUCCESS);
+    }
+    std::cout << dimms_num << " DIMMs: " << parallel_ms << " ms, " << one_dimm_ms * dimms_num << " ms one after another" << std::endl;
+    if (dimms_num > 1) {
+      EXPECT_LT(parallel_ms, one_dimm_ms * dimms_num / 2);
+    }
+  }
+}
+
+TEST_F(Dimm_Tests, RunOnDimmsKeepsOrderDuringPlayback)
+{
+  const UINT32 dimms_num = 4;
+  std::vector<EFI_STATUS> return_codes;
+
+  // The recorded FW commands are replayed in order, one DIMM after another
+  Script({});
+  EXPECT_GE(TimeSimulatedPcdWrites(dimms_num, return_codes), (long long)SIMULATED_TRANSACTIONS_NUM * SIMULATED_TRANSACTION_MS * dimms_num);
+}
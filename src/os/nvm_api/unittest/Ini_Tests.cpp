@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+extern "C" {
+typedef struct _dictionary dictionary;
+dictionary *nvm_ini_load_dictionary(dictionary **pp_dictionary, const char *p_ini_file_name);
+void nvm_ini_free_dictionary(dictionary *p_dictionary);
+const char *nvm_ini_get_string(dictionary *p_dictionary, const char *p_key);
+int nvm_ini_set_value(dictionary *p_dictionary, const char *p_key, const char *p_value);
+int nvm_ini_dump_to_file(dictionary *p_dictionary, const char *p_filename, int force_file_update);
+}
+
+#define WRITERS_NUM     8
+#define WRITES_NUM      50
+
+class Ini_Tests : public ::testing::Test
+{
+public:
+  std::string ini_path;
+
+  void SetUp()
+  {
+    char path[] = "/tmp/ipmctl_ini_testXXXXXX";
+    int fd = mkstemp(path);
+
+    ASSERT_NE(fd, -1);
+    ini_path = path;
+    for (int i = 0; i < WRITERS_NUM; i++) {
+      std::string line = "KEY_" + std::to_string(i) + " = 0 # written by writer " + std::to_string(i) + "\n";
+      ASSERT_EQ(write(fd, line.c_str(), line.size()), (ssize_t)line.size());
+    }
+    close(fd);
+  }
+
+  void TearDown()
+  {
+    unlink(ini_path.c_str());
+    unlink((ini_path + ".lock").c_str());
+  }
+};
+
+TEST_F(Ini_Tests, ConcurrentDumpsKeepEveryWriterValue)
+{
+  std::atomic<int> failures(0);
+  std::atomic<bool> writers_done(false);
+  std::vector<std::thread> writers;
+
+  // Every writer loads its own dictionary, like separate ipmctl processes do
+  for (int writer = 0; writer < WRITERS_NUM; writer++) {
+    writers.push_back(std::thread([this, writer, &failures]() {
+      std::string key = "KEY_" + std::to_string(writer);
+
+      for (int write = 1; write <= WRITES_NUM; write++) {
+        dictionary *p_dictionary = NULL;
+
+        if (NULL == nvm_ini_load_dictionary(&p_dictionary, ini_path.c_str()) ||
+            0 != nvm_ini_set_value(p_dictionary, key.c_str(), std::to_string(write).c_str()) ||
+            0 != nvm_ini_dump_to_file(p_dictionary, ini_path.c_str(), 0)) {
+          failures++;
+        }
+        nvm_ini_free_dictionary(p_dictionary);
+      }
+    }));
+  }
+
+  // The file is replaced atomically, so a reader never sees it truncated
+  std::thread reader([this, &failures, &writers_done]() {
+    while (!writers_done) {
+      dictionary *p_dictionary = NULL;
+
+      if (NULL == nvm_ini_load_dictionary(&p_dictionary, ini_path.c_str())) {
+        failures++;
+        continue;
+      }
+      for (int i = 0; i < WRITERS_NUM; i++) {
+        if (NULL == nvm_ini_get_string(p_dictionary, ("KEY_" + std::to_string(i)).c_str())) {
+          failures++;
+        }
+      }
+      nvm_ini_free_dictionary(p_dictionary);
+    }
+  });
+
+  for (std::thread &writer : writers) {
+    writer.join();
+  }
+  writers_done = true;
+  reader.join();
+
+  EXPECT_EQ(failures, 0);
+
+  dictionary *p_dictionary = NULL;
+  ASSERT_NE(nvm_ini_load_dictionary(&p_dictionary, ini_path.c_str()), (dictionary *)NULL);
+  for (int i = 0; i < WRITERS_NUM; i++) {
+    const char *p_value = nvm_ini_get_string(p_dictionary, ("KEY_" + std::to_string(i)).c_str());
+
+    ASSERT_NE(p_value, (const char *)NULL) << "KEY_" << i;
+    EXPECT_EQ(atoi(p_value), WRITES_NUM) << "KEY_" << i;
+  }
+  nvm_ini_free_dictionary(p_dictionary);
+}
+
+TEST_F(Ini_Tests, DumpWithoutChangesKeepsFile)
+{
+  dictionary *p_dictionary = NULL;
+  struct stat before;
+  struct stat after;
+
+  ASSERT_EQ(stat(ini_path.c_str(), &before), 0);
+  ASSERT_NE(nvm_ini_load_dictionary(&p_dictionary, ini_path.c_str()), (dictionary *)NULL);
+  EXPECT_EQ(nvm_ini_set_value(p_dictionary, "KEY_0", "0"), 0);
+  EXPECT_EQ(nvm_ini_dump_to_file(p_dictionary, ini_path.c_str(), 0), 0);
+  nvm_ini_free_dictionary(p_dictionary);
+
+  // Setting the same value is not a change, so the file is not replaced
+  ASSERT_EQ(stat(ini_path.c_str(), &after), 0);
+  EXPECT_EQ(before.st_ino, after.st_ino);
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <Uefi.h>
+#include <Dimm.h>
+#include <Pbr.h>
+#include <PbrDcpmm.h>
+#include <PbrTypes.h>
+
+int init_protocol_bs();
+}
+
+#define JOB_DIMMS_NUM   3
+
+// Progress reported by the DIMMs, in the order the poller reads it
+struct ScriptedStatus
+{
+  UINT32 dimm;
+  UINT8 fw_status;
+  UINT8 long_op_status;
+  UINT16 percent;
+};
+
+struct PolledJob
+{
+  DIMM *p_dimm;
+  UINT16 percent;
+  UINT8 long_op_status;
+  EFI_STATUS rc;
+};
+
+static VOID RecordCompletion(VOID *pContext, DIMM *pDimm,
+  PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *pLongOpStatus, EFI_STATUS ReturnCode)
+{
+  std::vector<PolledJob> *p_jobs = (std::vector<PolledJob> *)pContext;
+  PolledJob job = {pDimm, pLongOpStatus->Percent, pLongOpStatus->Status, ReturnCode};
+
+  p_jobs->push_back(job);
+}
+
+class Job_Tests : public ::testing::Test
+{
+public:
+  DIMM dimms[JOB_DIMMS_NUM];
+  DIMM *p_dimms[JOB_DIMMS_NUM];
+  UINT32 tag_id;
+
+  void SetUp()
+  {
+    // The boot services nvm_init() installs, the passthrough looks up the driver through them
+    init_protocol_bs();
+    memset(dimms, 0, sizeof(dimms));
+    for (UINT32 i = 0; i < JOB_DIMMS_NUM; i++) {
+      dimms[i].DimmID = (UINT16)(i + 1);
+      dimms[i].DeviceHandle.AsUint32 = 0x1000 + i;
+      p_dimms[i] = &dimms[i];
+    }
+    ASSERT_EQ(PbrSetSession(NULL, 0), EFI_SUCCESS);
+    ASSERT_EQ(PbrSetMode(PBR_RECORD_MODE), EFI_SUCCESS);
+    ASSERT_EQ(PbrSetTag(PBR_DCPMM_CLI_SIG, L"job test", L"0", &tag_id), EFI_SUCCESS);
+  }
+
+  void TearDown()
+  {
+    PbrSetMode(PBR_NORMAL_MODE);
+  }
+
+  // Long operation status replies, played back by the passthrough in this order
+  void Script(const std::vector<ScriptedStatus> &statuses)
+  {
+    for (const ScriptedStatus &status : statuses) {
+      UINT32 size = sizeof(PbrPassThruReq) + sizeof(PbrPassThruResp) + sizeof(PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS);
+      VOID *p_data = NULL;
+
+      ASSERT_EQ(PbrSetData(PBR_PASS_THRU_SIG, NULL, size, FALSE, &p_data, NULL), EFI_SUCCESS);
+      PbrPassThruReq *p_req = (PbrPassThruReq *)p_data;
+      PbrPassThruResp *p_resp = (PbrPassThruResp *)(p_req + 1);
+      PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *p_long_op = (PT_OUTPUT_PAYLOAD_FW_LONG_OP_STATUS *)(p_resp + 1);
+
+      p_req->DimmId = dimms[status.dimm].DeviceHandle.AsUint32;
+      p_req->Opcode = PtGetLog;
+      p_req->SubOpcode = SubopLongOperationStat;
+      p_resp->DimmId = p_req->DimmId;
+      p_resp->Status = status.fw_status;
+      p_resp->PassthruReturnCode = (FW_SUCCESS == status.fw_status) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+      p_resp->OutputPayloadSize = sizeof(*p_long_op);
+      p_long_op->CmdOpcode = PtSetSecInfo;
+      p_long_op->CmdSubcode = SubopOverwriteDimm;
+      p_long_op->Percent = status.percent;
+      p_long_op->Status = status.long_op_status;
+    }
+    ASSERT_EQ(PbrSetMode(PBR_PLAYBACK_MODE), EFI_SUCCESS);
+    ASSERT_EQ(PbrResetSession(tag_id), EFI_SUCCESS);
+  }
+};
+
+TEST_F(Job_Tests, ScriptedProgressCompletesEachJobOnce)
+{
+  std::vector<PolledJob> jobs;
+  EFI_STATUS rcs[JOB_DIMMS_NUM];
+
+  // DIMM 0 sanitizes 10%, 50%, done; DIMM 1 runs no job; DIMM 2 finishes in the second round
+  Script({
+    {0, FW_SUCCESS, FW_DEVICE_BUSY, 0x10}, {1, FW_DATA_NOT_SET, 0, 0}, {2, FW_SUCCESS, FW_DEVICE_BUSY, 0x90},
+    {0, FW_SUCCESS, FW_DEVICE_BUSY, 0x50}, {2, FW_SUCCESS, FW_SUCCESS, 0x100},
+    {0, FW_SUCCESS, FW_SUCCESS, 0x100},
+  });
+
+  EXPECT_EQ(PollLongOpStatusOnDimms(p_dimms, JOB_DIMMS_NUM, PtSetSecInfo, SubopOverwriteDimm, 1,
+    RecordCompletion, &jobs, rcs), EFI_NOT_STARTED);
+
+  ASSERT_EQ(jobs.size(), (size_t)JOB_DIMMS_NUM);
+  EXPECT_EQ(jobs[0].p_dimm, &dimms[1]);
+  EXPECT_EQ(jobs[0].rc, EFI_NOT_STARTED);
+  EXPECT_EQ(jobs[1].p_dimm, &dimms[2]);
+  EXPECT_EQ(jobs[1].percent, 0x100);
+  EXPECT_EQ(jobs[2].p_dimm, &dimms[0]);
+  EXPECT_EQ(jobs[2].percent, 0x100);
+  EXPECT_EQ(jobs[2].long_op_status, FW_SUCCESS);
+  EXPECT_EQ(rcs[0], EFI_SUCCESS);
+  EXPECT_EQ(rcs[1], EFI_NOT_STARTED);
+  EXPECT_EQ(rcs[2], EFI_SUCCESS);
+}
+
+TEST_F(Job_Tests, ZeroTimeoutSamplesProgressOnce)
+{
+  std::vector<PolledJob> jobs;
+  EFI_STATUS rcs[2];
+
+  Script({{0, FW_SUCCESS, FW_DEVICE_BUSY, 0x10}, {1, FW_SUCCESS, FW_DEVICE_BUSY, 0x42}});
+
+  EXPECT_EQ(PollLongOpStatusOnDimms(p_dimms, 2, 0, 0, 0, RecordCompletion, &jobs, rcs), EFI_TIMEOUT);
+
+  // Still running jobs are reported with the progress that was read
+  ASSERT_EQ(jobs.size(), (size_t)2);
+  EXPECT_EQ(jobs[0].rc, EFI_TIMEOUT);
+  EXPECT_EQ(jobs[0].percent, 0x10);
+  EXPECT_EQ(jobs[1].rc, EFI_TIMEOUT);
+  EXPECT_EQ(jobs[1].percent, 0x42);
+  EXPECT_EQ(rcs[0], EFI_TIMEOUT);
+  EXPECT_EQ(rcs[1], EFI_TIMEOUT);
+}
+
+TEST_F(Job_Tests, DifferentLongOperationIsAnError)
+{
+  std::vector<PolledJob> jobs;
+  EFI_STATUS rc = EFI_SUCCESS;
+
+  Script({{0, FW_SUCCESS, FW_DEVICE_BUSY, 0x10}});
+
+  // The DIMM reports a sanitize, an ARS was expected
+  EXPECT_EQ(PollLongOpStatusOnDimms(p_dimms, 1, PtSetFeatures, SubopAddressRangeScrub, 1,
+    RecordCompletion, &jobs, &rc), EFI_DEVICE_ERROR);
+  ASSERT_EQ(jobs.size(), (size_t)1);
+  EXPECT_EQ(jobs[0].rc, EFI_DEVICE_ERROR);
+}
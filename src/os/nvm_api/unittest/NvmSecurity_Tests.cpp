@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <Uefi.h>
+#include <Dimm.h>
+#include <NvmSecurity.h>
+#include <NvmStatus.h>
+#include <Pbr.h>
+#include <PbrDcpmm.h>
+#include <PbrTypes.h>
+
+int init_protocol_bs();
+}
+
+#define SECURITY_TEST_DIMMS_NUM   3
+
+// A FW command reply, in the order the passthrough reads them
+struct ScriptedSecurityReply
+{
+  UINT32 dimm_idx;
+  UINT8 opcode;
+  UINT8 sub_opcode;
+  UINT8 status;
+  UINT32 security_state;    // Output of a get security state command
+};
+
+class NvmSecurity_Tests : public ::testing::Test
+{
+public:
+  DIMM dimms[SECURITY_TEST_DIMMS_NUM];
+  DIMM *p_dimms[SECURITY_TEST_DIMMS_NUM];
+  PT_SET_SECURITY_PAYLOAD payload;
+  UINT32 tag_id;
+
+  void SetUp()
+  {
+    // The boot services nvm_init() installs, the passthrough looks up the driver through them
+    init_protocol_bs();
+    memset(dimms, 0, sizeof(dimms));
+    memset(&payload, 0, sizeof(payload));
+    for (UINT32 i = 0; i < SECURITY_TEST_DIMMS_NUM; i++) {
+      dimms[i].DimmID = (UINT16)(i + 1);
+      dimms[i].DeviceHandle.AsUint32 = 0x1000 + i;
+      p_dimms[i] = &dimms[i];
+    }
+    payload.PassphraseType = SECURITY_USER_PASSPHRASE;
+    ASSERT_EQ(PbrSetSession(NULL, 0), EFI_SUCCESS);
+    ASSERT_EQ(PbrSetMode(PBR_RECORD_MODE), EFI_SUCCESS);
+    ASSERT_EQ(PbrSetTag(PBR_DCPMM_CLI_SIG, L"security test", L"0", &tag_id), EFI_SUCCESS);
+  }
+
+  void TearDown()
+  {
+    PbrSetMode(PBR_NORMAL_MODE);
+  }
+
+  // Replies played back by the passthrough in this order, a session keeps the DIMMs in order
+  void Script(const std::vector<ScriptedSecurityReply> &replies)
+  {
+    for (const ScriptedSecurityReply &reply : replies) {
+      UINT32 out_size = (PtGetSecInfo == reply.opcode) ? sizeof(PT_GET_SECURITY_PAYLOAD) : 0;
+      VOID *p_data = NULL;
+
+      ASSERT_EQ(PbrSetData(PBR_PASS_THRU_SIG, NULL, sizeof(PbrPassThruReq) + sizeof(PbrPassThruResp) + out_size,
+        FALSE, &p_data, NULL), EFI_SUCCESS);
+      PbrPassThruReq *p_req = (PbrPassThruReq *)p_data;
+      PbrPassThruResp *p_resp = (PbrPassThruResp *)(p_req + 1);
+
+      p_req->DimmId = dimms[reply.dimm_idx].DeviceHandle.AsUint32;
+      p_req->Opcode = reply.opcode;
+      p_req->SubOpcode = reply.sub_opcode;
+      p_resp->DimmId = p_req->DimmId;
+      p_resp->Status = reply.status;
+      p_resp->PassthruReturnCode = (FW_SUCCESS == reply.status) ? EFI_SUCCESS : EFI_DEVICE_ERROR;
+      p_resp->OutputPayloadSize = out_size;
+      if (0 != out_size) {
+        // The passthrough reads the payload right after the whole response header
+        ((PT_GET_SECURITY_PAYLOAD *)(p_resp + 1))->SecurityStatus.AsUint32 = reply.security_state;
+      }
+    }
+    ASSERT_EQ(PbrSetMode(PBR_PLAYBACK_MODE), EFI_SUCCESS);
+    ASSERT_EQ(PbrResetSession(tag_id), EFI_SUCCESS);
+  }
+};
+
+TEST_F(NvmSecurity_Tests, SecureEraseReportsEveryDimm)
+{
+  SECURE_ERASE_RESULT results[SECURITY_TEST_DIMMS_NUM];
+
+  Script({
+    {0, PtSetSecInfo, SubopSecEraseUnit, FW_SUCCESS, 0},
+    {0, PtGetSecInfo, SubopGetSecState, FW_SUCCESS, SECURITY_MASK_ENABLED},
+    {1, PtSetSecInfo, SubopSecEraseUnit, FW_INCORRECT_PASSPHRASE, 0},
+    {2, PtSetSecInfo, SubopSecEraseUnit, FW_SUCCESS, 0},
+    {2, PtGetSecInfo, SubopGetSecState, FW_SUCCESS, SECURITY_MASK_COUNTEXPIRED},
+  });
+
+  // The failed erase of the middle DIMM does not keep the last one from being erased
+  EXPECT_EQ(SecureEraseDimms(p_dimms, SECURITY_TEST_DIMMS_NUM, sizeof(payload), &payload, results), EFI_ACCESS_DENIED);
+
+  EXPECT_EQ(results[0].EraseReturnCode, EFI_SUCCESS);
+  EXPECT_EQ(results[0].StateReturnCode, EFI_SUCCESS);
+  EXPECT_EQ(results[0].SecurityState, (UINT32)SECURITY_MASK_ENABLED);
+
+  EXPECT_EQ(results[1].EraseReturnCode, EFI_ACCESS_DENIED);
+  EXPECT_EQ(results[1].StateReturnCode, EFI_NOT_STARTED);
+
+  EXPECT_EQ(results[2].EraseReturnCode, EFI_SUCCESS);
+  EXPECT_EQ(results[2].StateReturnCode, EFI_SUCCESS);
+  EXPECT_EQ(results[2].SecurityState, (UINT32)SECURITY_MASK_COUNTEXPIRED);
+}
+
+TEST_F(NvmSecurity_Tests, SecureEraseRejectsInvalidParameters)
+{
+  SECURE_ERASE_RESULT results[SECURITY_TEST_DIMMS_NUM];
+
+  EXPECT_EQ(SecureEraseDimms(NULL, 1, sizeof(payload), &payload, results), EFI_INVALID_PARAMETER);
+  EXPECT_EQ(SecureEraseDimms(p_dimms, 1, sizeof(payload), NULL, results), EFI_INVALID_PARAMETER);
+  EXPECT_EQ(SecureEraseDimms(p_dimms, 1, sizeof(payload), &payload, NULL), EFI_INVALID_PARAMETER);
+  EXPECT_EQ(SecureEraseDimms(p_dimms, MAX_DIMMS + 1, sizeof(payload), &payload, results), EFI_INVALID_PARAMETER);
+}
@@ -0,0 +1,493 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern "C" {
+#include <Uefi.h>
+#include <DataSet.h>
+#include <Printer.h>
+#include <Pbr.h>
+#include <PbrTypes.h>
+#include <Protocol/ShellParameters.h>
+#include <os_efi_shell_parameters_protocol.h>
+
+int nvm_run_cli(int argc, char *argv[]);
+}
+
+struct XmlNode
+{
+  std::wstring name;
+  std::map<std::wstring, std::wstring> attributes;
+  std::wstring text;
+  std::vector<XmlNode> children;
+};
+
+// A record of the structured output, a leaf data set with the keys of its parents
+struct OutputRecord
+{
+  std::wstring name;
+  std::map<std::wstring, std::wstring> keys;
+};
+
+static bool operator==(const OutputRecord &first, const OutputRecord &second)
+{
+  return first.name == second.name && first.keys == second.keys;
+}
+
+static std::ostream &operator<<(std::ostream &os, const OutputRecord &record)
+{
+  os << std::string(record.name.begin(), record.name.end()) << " {";
+  for (const auto &key : record.keys) {
+    os << " " << std::string(key.first.begin(), key.first.end()) << "="
+      << std::string(key.second.begin(), key.second.end());
+  }
+  return os << " }";
+}
+
+static std::wstring Trim(const std::wstring &str)
+{
+  size_t first = str.find_first_not_of(L" \t\r\n");
+  size_t last = str.find_last_not_of(L" \t\r\n");
+
+  return (std::wstring::npos == first) ? std::wstring() : str.substr(first, last - first + 1);
+}
+
+static std::wstring RemoveWhiteSpace(const std::wstring &str)
+{
+  std::wstring result;
+
+  for (wchar_t c : str) {
+    if (!iswspace(c)) {
+      result += c;
+    }
+  }
+  return result;
+}
+
+// Just enough XML for the printer output: elements, quoted attributes and text
+static bool ParseXmlElement(const std::wstring &xml, size_t &pos, XmlNode &node)
+{
+  size_t end = 0;
+
+  if (xml.compare(pos, 1, L"<") != 0) {
+    return false;
+  }
+  end = xml.find_first_of(L" \t\r\n/>", ++pos);
+  if (std::wstring::npos == end) {
+    return false;
+  }
+  node.name = xml.substr(pos, end - pos);
+  pos = end;
+
+  while (pos < xml.size() && xml[pos] != L'>' && xml[pos] != L'/') {
+    if (iswspace(xml[pos])) {
+      pos++;
+      continue;
+    }
+    size_t equal = xml.find(L'=', pos);
+    size_t quote = xml.find(L'"', equal);
+    size_t quote_end = xml.find(L'"', quote + 1);
+    if (std::wstring::npos == quote_end) {
+      return false;
+    }
+    node.attributes[Trim(xml.substr(pos, equal - pos))] = xml.substr(quote + 1, quote_end - quote - 1);
+    pos = quote_end + 1;
+  }
+  if (xml.compare(pos, 2, L"/>") == 0) {
+    pos += 2;
+    return true;
+  }
+  pos++;
+
+  while (pos < xml.size()) {
+    if (xml.compare(pos, 2, L"</") == 0) {
+      end = xml.find(L'>', pos);
+      if (std::wstring::npos == end || xml.substr(pos + 2, end - pos - 2) != node.name) {
+        return false;
+      }
+      pos = end + 1;
+      node.text = Trim(node.text);
+      return true;
+    } else if (xml[pos] == L'<') {
+      node.children.push_back(XmlNode());
+      if (!ParseXmlElement(xml, pos, node.children.back())) {
+        return false;
+      }
+    } else {
+      node.text += xml[pos++];
+    }
+  }
+  return false;
+}
+
+static bool ParseXml(const std::wstring &xml, XmlNode &root)
+{
+  size_t pos = xml.find(L'<');
+
+  // Skip the declaration
+  if (std::wstring::npos != pos && xml.compare(pos, 2, L"<?") == 0) {
+    pos = xml.find(L'<', xml.find(L"?>", pos));
+  }
+  if (std::wstring::npos == pos || !ParseXmlElement(xml, pos, root)) {
+    return false;
+  }
+  return Trim(xml.substr(pos)).empty();
+}
+
+// <Root><Record><Key>Value</Key>...</Record>...</Root>
+static std::vector<OutputRecord> NvmXmlRecords(const XmlNode &root)
+{
+  std::vector<OutputRecord> records;
+
+  for (const XmlNode &record_node : root.children) {
+    OutputRecord record;
+
+    record.name = record_node.name;
+    for (const XmlNode &key_node : record_node.children) {
+      record.keys[key_node.name] = key_node.text;
+    }
+    records.push_back(record);
+  }
+  return records;
+}
+
+// <output><list><structure typeName="Record"><field name="Key"><string>Value</string></field>...
+static std::vector<OutputRecord> EsxTableXmlRecords(const XmlNode &root)
+{
+  std::vector<OutputRecord> records;
+
+  for (const XmlNode &list : root.children) {
+    for (const XmlNode &structure : list.children) {
+      OutputRecord record;
+
+      record.name = structure.attributes.at(L"typeName");
+      for (const XmlNode &field : structure.children) {
+        record.keys[field.attributes.at(L"name")] =
+          field.children.empty() ? std::wstring() : field.children[0].text;
+      }
+      records.push_back(record);
+    }
+  }
+  return records;
+}
+
+typedef std::vector<std::pair<std::wstring, std::wstring>> KeyValues;
+
+// <structure typeName="KeyValue"><field name="Attribute Name">...Key...<field name="Value">...Value...
+static KeyValues EsxXmlKeyValues(const XmlNode &root)
+{
+  KeyValues key_values;
+
+  for (const XmlNode &list : root.children) {
+    for (const XmlNode &structure : list.children) {
+      if (structure.children.size() != 2 || structure.children[0].children.empty() ||
+          structure.children[1].children.empty()) {
+        return KeyValues();
+      }
+      key_values.push_back(std::make_pair(structure.children[0].children[0].text,
+        structure.children[1].children[0].text));
+    }
+  }
+  std::sort(key_values.begin(), key_values.end());
+  return key_values;
+}
+
+// The key/value pairs of all the records, the ESX key/value format does not keep the records apart
+static KeyValues RecordsKeyValues(const std::vector<OutputRecord> &records)
+{
+  KeyValues key_values;
+
+  for (const OutputRecord &record : records) {
+    key_values.insert(key_values.end(), record.keys.begin(), record.keys.end());
+  }
+  std::sort(key_values.begin(), key_values.end());
+  return key_values;
+}
+
+static void CollectDataSetKeys(DATA_SET_CONTEXT *p_data_set, std::map<std::wstring, std::wstring> &keys)
+{
+  KEY_VAL_INFO *p_key_info = NULL;
+  CHAR16 *p_val = NULL;
+
+  while (NULL != (p_key_info = GetNextKey(p_data_set, p_key_info))) {
+    GetKeyValueWideStr(p_data_set, p_key_info->Key, &p_val, NULL);
+    keys[RemoveWhiteSpace(p_key_info->Key)] = Trim(p_val);
+  }
+}
+
+/**
+  The records the data set is expected to print as, every leaf below the root
+  with the keys of the data sets between them.
+**/
+static void DataSetRecords(DATA_SET_CONTEXT *p_data_set, std::map<std::wstring, std::wstring> parent_keys,
+  std::vector<OutputRecord> &records)
+{
+  DATA_SET_CONTEXT *p_child = NULL;
+
+  if (IsLeaf(p_data_set)) {
+    OutputRecord record;
+
+    record.name = GetDataSetName(p_data_set);
+    CollectDataSetKeys(p_data_set, record.keys);
+    record.keys.insert(parent_keys.begin(), parent_keys.end());
+    records.push_back(record);
+    return;
+  }
+  CollectDataSetKeys(p_data_set, parent_keys);
+  while (NULL != (p_child = GetNextChildDataSet(p_data_set, p_child))) {
+    DataSetRecords(p_child, parent_keys, records);
+  }
+}
+
+static std::vector<OutputRecord> DataSetRecords(DATA_SET_CONTEXT *p_root)
+{
+  std::vector<OutputRecord> records;
+  DATA_SET_CONTEXT *p_child = NULL;
+
+  while (NULL != (p_child = GetNextChildDataSet(p_root, p_child))) {
+    DataSetRecords(p_child, std::map<std::wstring, std::wstring>(), records);
+  }
+  return records;
+}
+
+static std::wstring ReadWideFile(FILE *p_file)
+{
+  std::wstring content;
+  wint_t c = 0;
+
+  fflush(p_file);
+  rewind(p_file);
+  while (WEOF != (c = fgetwc(p_file))) {
+    content += (wchar_t)c;
+  }
+  return content;
+}
+
+/**
+  The printer writes through the shell parameters protocol, the tests point
+  its StdOut to a temporary file and parse what the printer wrote.
+**/
+class Printer_Tests : public ::testing::Test
+{
+public:
+  FILE *p_std_out_saved;
+  FILE *p_output;
+  PRINT_CONTEXT *p_printer_ctx;
+  DATA_SET_CONTEXT *p_root;
+
+  void SetUp()
+  {
+    p_std_out_saved = (FILE *)gOsShellParametersProtocol.StdOut;
+    p_output = tmpfile();
+    ASSERT_TRUE(p_output != NULL);
+    gOsShellParametersProtocol.StdOut = p_output;
+    p_printer_ctx = NULL;
+    ASSERT_EQ(PrinterCreateCtx(&p_printer_ctx), EFI_SUCCESS);
+    // As the CLI sets it up for the commands
+    PRINTER_CONFIGURE_BUFFERING(p_printer_ctx, ON);
+    p_root = NULL;
+  }
+
+  void TearDown()
+  {
+    gOsShellParametersProtocol.StdOut = p_std_out_saved;
+    if (p_printer_ctx != NULL) {
+      PrinterDestroyCtx(p_printer_ctx);
+    }
+    // The printer does not own the data sets it was given
+    if (p_root != NULL) {
+      FreeDataSet(p_root);
+    }
+    fclose(p_output);
+  }
+
+  // Two modules with their sensors, the keys of a module are repeated in its sensor records
+  void BuildSensorList()
+  {
+    const wchar_t *sensors[] = {L"Health", L"MediaTemperature", L"PercentageRemaining"};
+
+    p_root = CreateDataSet(NULL, (CHAR16 *)L"SensorList", NULL);
+    ASSERT_TRUE(p_root != NULL);
+    for (UINT32 dimm = 0; dimm < 2; dimm++) {
+      DATA_SET_CONTEXT *p_dimm = CreateDataSet(p_root, (CHAR16 *)L"DimmSensors", NULL);
+
+      ASSERT_TRUE(p_dimm != NULL);
+      ASSERT_EQ(SetKeyValueUint16(p_dimm, L"DimmID", (UINT16)(0x1001 + dimm), HEX), EFI_SUCCESS);
+      for (UINT32 sensor = 0; sensor < 3; sensor++) {
+        DATA_SET_CONTEXT *p_sensor = CreateDataSet(p_dimm, (CHAR16 *)L"Sensor", NULL);
+
+        ASSERT_TRUE(p_sensor != NULL);
+        ASSERT_EQ(SetKeyValueWideStr(p_sensor, L"Type", sensors[sensor]), EFI_SUCCESS);
+        ASSERT_EQ(SetKeyValueUint32(p_sensor, L"Current Value", dimm * 100 + sensor, DECIMAL), EFI_SUCCESS);
+        ASSERT_EQ(SetKeyValueWideStr(p_sensor, L"Alarm Enabled", L"  N/A "), EFI_SUCCESS);
+      }
+    }
+  }
+
+  void BuildDimmList()
+  {
+    p_root = CreateDataSet(NULL, (CHAR16 *)L"DimmList", NULL);
+    ASSERT_TRUE(p_root != NULL);
+    for (UINT32 dimm = 0; dimm < 4; dimm++) {
+      DATA_SET_CONTEXT *p_dimm = CreateDataSet(p_root, (CHAR16 *)L"Dimm", NULL);
+
+      ASSERT_TRUE(p_dimm != NULL);
+      ASSERT_EQ(SetKeyValueUint16(p_dimm, L"DimmID", (UINT16)(0x0001 + dimm), HEX), EFI_SUCCESS);
+      ASSERT_EQ(SetKeyValueUint64(p_dimm, L"Capacity", 0x7E00000000ULL, DECIMAL), EFI_SUCCESS);
+      ASSERT_EQ(SetKeyValueWideStr(p_dimm, L"Health State", L"Healthy"), EFI_SUCCESS);
+      ASSERT_EQ(SetKeyValueBool(p_dimm, L"Is New", (BOOLEAN)(dimm % 2)), EFI_SUCCESS);
+    }
+  }
+
+  std::wstring Print(PRINT_FORMAT_TYPE format)
+  {
+    p_printer_ctx->FormatType = format;
+    EXPECT_EQ(PrinterSetData(p_printer_ctx, EFI_SUCCESS, p_root), EFI_SUCCESS);
+    EXPECT_EQ(PrinterProcessSetBuffer(p_printer_ctx), EFI_SUCCESS);
+    return ReadWideFile(p_output);
+  }
+};
+
+TEST_F(Printer_Tests, NvmXmlMatchesDataSet)
+{
+  for (int list = 0; list < 2; list++) {
+    XmlNode root;
+
+    if (0 == list) {
+      BuildDimmList();
+    } else {
+      BuildSensorList();
+    }
+    std::vector<OutputRecord> expected = DataSetRecords(p_root);
+    std::wstring output = Print(XML);
+
+    ASSERT_TRUE(ParseXml(output, root)) << std::string(output.begin(), output.end());
+    EXPECT_EQ(root.name, std::wstring(GetDataSetName(p_root)));
+    EXPECT_EQ(NvmXmlRecords(root), expected) << std::string(output.begin(), output.end());
+
+    // The next list is printed on its own
+    FreeDataSet(p_root);
+    p_root = NULL;
+    ASSERT_EQ(ftruncate(fileno(p_output), 0), 0);
+    rewind(p_output);
+  }
+}
+
+TEST_F(Printer_Tests, EsxXmlMatchesDataSet)
+{
+  XmlNode root;
+
+  BuildSensorList();
+  PRINTER_ENABLE_ESX_XML_FORMAT(p_printer_ctx);
+  std::vector<OutputRecord> expected = DataSetRecords(p_root);
+  std::wstring output = Print(XML);
+
+  ASSERT_TRUE(ParseXml(output, root)) << std::string(output.begin(), output.end());
+  EXPECT_EQ(EsxXmlKeyValues(root), RecordsKeyValues(expected)) << std::string(output.begin(), output.end());
+}
+
+TEST_F(Printer_Tests, EsxTableXmlMatchesDataSet)
+{
+  XmlNode root;
+
+  BuildSensorList();
+  PRINTER_ENABLE_ESX_TABLE_XML_FORMAT(p_printer_ctx);
+  std::vector<OutputRecord> expected = DataSetRecords(p_root);
+  std::wstring output = Print(XML);
+
+  ASSERT_TRUE(ParseXml(output, root)) << std::string(output.begin(), output.end());
+  EXPECT_EQ(EsxTableXmlRecords(root), expected) << std::string(output.begin(), output.end());
+}
+
+/**
+  Runs an ipmctl command in a child process whose stdout is a file, against
+  the PMem modules of the platform or the session IPMCTL_TEST_SESSION names.
+  A process of its own gets a stdout the CLI can print wide characters to.
+**/
+static int RunCli(const std::vector<const char *> &args, const std::string &work_dir, std::wstring &output)
+{
+  std::string output_path = work_dir + "/cli_output";
+  int status = 0;
+  pid_t pid = fork();
+
+  if (0 == pid) {
+    const char *p_session_file = getenv("IPMCTL_TEST_SESSION");
+    std::vector<char> session;
+    std::vector<char *> argv;
+
+    if (0 != chdir(work_dir.c_str()) || NULL == freopen(output_path.c_str(), "w", stdout)) {
+      _exit(127);
+    }
+    if (NULL != p_session_file) {
+      std::ifstream file(p_session_file, std::ios::binary);
+
+      session.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      if (session.empty() || EFI_SUCCESS != PbrSetSession(session.data(), (UINT32)session.size()) ||
+          EFI_SUCCESS != PbrSetMode(PBR_PLAYBACK_MODE)) {
+        _exit(126);
+      }
+    }
+    argv.push_back((char *)"ipmctl");
+    for (const char *p_arg : args) {
+      argv.push_back((char *)p_arg);
+    }
+    argv.push_back(NULL);
+    status = nvm_run_cli((int)argv.size() - 1, argv.data());
+    fflush(stdout);
+    _exit(status & 0xFF);
+  }
+  if (pid < 0 || waitpid(pid, &status, 0) != pid) {
+    return -1;
+  }
+
+  FILE *p_file = fopen(output_path.c_str(), "r");
+  if (p_file != NULL) {
+    output = ReadWideFile(p_file);
+    fclose(p_file);
+  }
+  unlink(output_path.c_str());
+  return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+TEST_F(Printer_Tests, CliStructuredOutputMatchesAcrossFormats)
+{
+  char work_dir[] = "/tmp/ipmctl_printer_XXXXXX";
+  std::wstring nvm_xml_output;
+  std::wstring esx_output;
+  XmlNode nvm_xml_root;
+  XmlNode esx_root;
+  struct stat temp_file_stat;
+
+  ASSERT_TRUE(mkdtemp(work_dir) != NULL);
+  ASSERT_NE(RunCli({"show", "-o", "nvmxml", "-dimm"}, work_dir, nvm_xml_output), 127);
+  ASSERT_NE(RunCli({"show", "-o", "esxtable", "-dimm"}, work_dir, esx_output), 127);
+
+  // Nothing goes through a file in the working directory anymore
+  EXPECT_NE(stat((std::string(work_dir) + "/output.tmp").c_str(), &temp_file_stat), 0);
+  rmdir(work_dir);
+
+  if (!ParseXml(nvm_xml_output, nvm_xml_root) || nvm_xml_root.name != L"DimmList") {
+    // No modules to list, the platform has none or the library could not be initialized
+    GTEST_SKIP() << std::string(nvm_xml_output.begin(), nvm_xml_output.end());
+  }
+  ASSERT_TRUE(ParseXml(esx_output, esx_root)) << std::string(esx_output.begin(), esx_output.end());
+
+  // Both formats are printed from the same data set
+  std::vector<OutputRecord> records = NvmXmlRecords(nvm_xml_root);
+  EXPECT_FALSE(records.empty());
+  EXPECT_EQ(EsxTableXmlRecords(esx_root), records);
+}
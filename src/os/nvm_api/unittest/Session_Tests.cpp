@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <nvm_management.h>
+
+extern "C" {
+#include <Uefi.h>
+#include <Pbr.h>
+#include <PbrTypes.h>
+}
+
+#define SESSION_CALLS_NUM     20
+
+/**
+  Runs against the PMem modules of the platform, or against a session
+  recorded with "ipmctl start -session -mode record" and saved with
+  "ipmctl dump -destination <file> -session" when IPMCTL_TEST_SESSION
+  names the file.
+**/
+class Session_Tests : public ::testing::Test
+{
+public:
+  std::vector<char> session;
+
+  void SetUp()
+  {
+    const char *p_session_file = getenv("IPMCTL_TEST_SESSION");
+
+    if (NULL != p_session_file) {
+      std::ifstream file(p_session_file, std::ios::binary);
+
+      ASSERT_TRUE(file.good()) << p_session_file;
+      session.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+      ASSERT_EQ(PbrSetSession(session.data(), (UINT32)session.size()), EFI_SUCCESS);
+      ASSERT_EQ(PbrSetMode(PBR_PLAYBACK_MODE), EFI_SUCCESS);
+    }
+  }
+
+  void TearDown()
+  {
+    nvm_uninit();
+    if (!session.empty()) {
+      PbrSetMode(PBR_NORMAL_MODE);
+    }
+  }
+
+  // Every call replays the recording from its first command
+  void Rewind()
+  {
+    if (!session.empty()) {
+      PbrResetSession(0);
+    }
+  }
+};
+
+TEST_F(Session_Tests, RefreshAllKeepsInventory)
+{
+  unsigned int dimm_cnt = 0;
+  unsigned int refreshed_dimm_cnt = 0;
+
+  ASSERT_EQ(nvm_init(), NVM_SUCCESS);
+  ASSERT_EQ(nvm_get_number_of_devices(&dimm_cnt), NVM_SUCCESS);
+  if (0 == dimm_cnt) {
+    GTEST_SKIP();
+  }
+
+  // The ACPI tables are read again, an unchanged platform gives the same inventory
+  Rewind();
+  ASSERT_EQ(nvm_refresh(NVM_REFRESH_ALL, NULL), NVM_SUCCESS);
+  ASSERT_EQ(nvm_get_number_of_devices(&refreshed_dimm_cnt), NVM_SUCCESS);
+  EXPECT_EQ(refreshed_dimm_cnt, dimm_cnt);
+}
+
+TEST_F(Session_Tests, PerCallLatencyBenchmark)
+{
+  unsigned int dimm_cnt = 0;
+
+  ASSERT_EQ(nvm_init(), NVM_SUCCESS);
+  ASSERT_EQ(nvm_get_number_of_devices(&dimm_cnt), NVM_SUCCESS);
+  if (0 == dimm_cnt) {
+    GTEST_SKIP();
+  }
+  std::vector<device_discovery> devices(dimm_cnt);
+
+  // The driver stays bound for the session, a call reads the inventory
+  auto start = std::chrono::steady_clock::now();
+  for (int call = 0; call < SESSION_CALLS_NUM; call++) {
+    Rewind();
+    ASSERT_EQ(nvm_get_devices(devices.data(), (NVM_UINT8)dimm_cnt), NVM_SUCCESS);
+  }
+  auto session_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  // What every call paid before: rebind the driver, parse ACPI and rebuild the inventory
+  start = std::chrono::steady_clock::now();
+  for (int call = 0; call < SESSION_CALLS_NUM; call++) {
+    Rewind();
+    ASSERT_EQ(nvm_refresh(NVM_REFRESH_ALL, NULL), NVM_SUCCESS);
+    ASSERT_EQ(nvm_get_devices(devices.data(), (NVM_UINT8)dimm_cnt), NVM_SUCCESS);
+  }
+  auto rebind_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  std::cout << dimm_cnt << " PMem modules" << (session.empty() ? "" : " (recorded session)") << ": bound session "
+    << session_us / SESSION_CALLS_NUM << " us per call, rebind per call " << rebind_us / SESSION_CALLS_NUM << " us" << std::endl;
+  EXPECT_LT(session_us, rebind_us);
+}
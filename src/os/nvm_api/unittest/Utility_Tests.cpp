@@ -0,0 +1,323 @@
+/*
+ * Copyright (c) 2018, Intel Corporation.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#define EFI_SUCCESS 0ULL
+
+extern "C" {
+unsigned long long MergeSort(void *pArray, unsigned int Count, unsigned int ItemSize,
+  int (*Compare) (void *first, void *second));
+}
+
+struct SortItem
+{
+  unsigned int key;
+  unsigned int position;
+};
+
+static int CompareSortItem(void *first, void *second)
+{
+  SortItem *p_first = (SortItem *)first;
+  SortItem *p_second = (SortItem *)second;
+
+  if (p_first->key < p_second->key) {
+    return -1;
+  } else if (p_first->key > p_second->key) {
+    return 1;
+  }
+  return 0;
+}
+
+static bool SortItemLess(const SortItem &first, const SortItem &second)
+{
+  return first.key < second.key;
+}
+
+// Reference for the benchmark, the quadratic sort MergeSort replaced
+static void BubbleSortItems(std::vector<SortItem> &items)
+{
+  for (size_t i = 0; i + 1 < items.size(); i++) {
+    for (size_t j = 0; j + 1 < items.size() - i; j++) {
+      if (CompareSortItem(&items[j], &items[j + 1]) > 0) {
+        std::swap(items[j], items[j + 1]);
+      }
+    }
+  }
+}
+
+static std::vector<SortItem> RandomItems(size_t count, unsigned int key_range)
+{
+  std::vector<SortItem> items(count);
+
+  for (size_t i = 0; i < count; i++) {
+    items[i].key = (unsigned int)rand() % key_range;
+    items[i].position = (unsigned int)i;
+  }
+  return items;
+}
+
+class Utility_Tests : public ::testing::Test
+{
+public:
+};
+
+TEST_F(Utility_Tests, MergeSortRandomizedMatchesStableSort)
+{
+  const size_t sizes[] = {1, 2, 3, 7, 16, 17, 100, 1023, 4096};
+
+  srand(42);
+  for (size_t size : sizes) {
+    for (unsigned int round = 0; round < 20; round++) {
+      // A small key range forces many ties, which checks stability
+      std::vector<SortItem> items = RandomItems(size, (round % 2) ? 8 : 0x10000);
+      std::vector<SortItem> expected = items;
+
+      std::stable_sort(expected.begin(), expected.end(), SortItemLess);
+      ASSERT_EQ(MergeSort(items.data(), (unsigned int)size, sizeof(SortItem), CompareSortItem), EFI_SUCCESS);
+
+      for (size_t i = 0; i < size; i++) {
+        ASSERT_EQ(items[i].key, expected[i].key) << "size " << size << " index " << i;
+        ASSERT_EQ(items[i].position, expected[i].position) << "size " << size << " index " << i;
+      }
+    }
+  }
+}
+
+TEST_F(Utility_Tests, MergeSortRejectsInvalidParameters)
+{
+  SortItem item = {0, 0};
+
+  EXPECT_NE(MergeSort(NULL, 2, sizeof(SortItem), CompareSortItem), EFI_SUCCESS);
+  EXPECT_NE(MergeSort(&item, 1, sizeof(SortItem), NULL), EFI_SUCCESS);
+}
+
+TEST_F(Utility_Tests, MergeSortBenchmark)
+{
+  const size_t sizes[] = {10, 100, 10000};
+
+  srand(7);
+  for (size_t size : sizes) {
+    std::vector<SortItem> items = RandomItems(size, 0x10000);
+    std::vector<SortItem> bubble_items = items;
+
+    auto start = std::chrono::steady_clock::now();
+    ASSERT_EQ(MergeSort(items.data(), (unsigned int)size, sizeof(SortItem), CompareSortItem), EFI_SUCCESS);
+    auto merge_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    BubbleSortItems(bubble_items);
+    auto bubble_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "n=" << size << " merge sort " << merge_us << " us, bubble sort " << bubble_us << " us" << std::endl;
+    if (size >= 10000) {
+      EXPECT_LT(merge_us, bubble_us);
+    }
+  }
+}
+
+struct HashIndex
+{
+  void **pp_slots;
+  unsigned int capacity;
+};
+
+extern "C" {
+unsigned int HashUint32(unsigned int Key);
+unsigned int HashAsciiStr(const char *pStr);
+unsigned int HashUnicodeStr(const wchar_t *pStr);
+unsigned long long HashIndexInit(HashIndex *pIndex, unsigned int ItemsNum);
+void HashIndexFree(HashIndex *pIndex);
+void HashIndexInsert(HashIndex *pIndex, unsigned int Hash, void *pItem);
+void *HashIndexFind(HashIndex *pIndex, unsigned int Hash, unsigned char (*Match) (void *pItem, const void *pKey), const void *pKey);
+}
+
+static unsigned char IsSortItemKeyMatching(void *p_item, const void *p_key)
+{
+  return ((SortItem *)p_item)->key == *(const unsigned int *)p_key;
+}
+
+TEST_F(Utility_Tests, HashAsciiAndUnicodeStrMatch)
+{
+  EXPECT_EQ(HashAsciiStr("8089-a2"), HashUnicodeStr(L"8089-a2"));
+  EXPECT_NE(HashAsciiStr("8089-a2"), HashAsciiStr("8089-a3"));
+}
+
+TEST_F(Utility_Tests, HashIndexFindsFirstInsertedItem)
+{
+  std::vector<SortItem> items = RandomItems(1000, 64);
+  HashIndex index = {NULL, 0};
+
+  ASSERT_EQ(HashIndexInit(&index, (unsigned int)items.size()), EFI_SUCCESS);
+  EXPECT_GE(index.capacity, 2 * items.size());
+  for (SortItem &item : items) {
+    HashIndexInsert(&index, HashUint32(item.key), &item);
+  }
+
+  // Duplicated keys return the item inserted first, as a list scan would
+  for (unsigned int key = 0; key < 64; key++) {
+    SortItem *p_expected = NULL;
+    for (SortItem &item : items) {
+      if (item.key == key) {
+        p_expected = &item;
+        break;
+      }
+    }
+    EXPECT_EQ(HashIndexFind(&index, HashUint32(key), IsSortItemKeyMatching, &key), (void *)p_expected);
+  }
+
+  HashIndexFree(&index);
+  EXPECT_EQ(index.pp_slots, (void **)NULL);
+  unsigned int key = 0;
+  EXPECT_EQ(HashIndexFind(&index, HashUint32(key), IsSortItemKeyMatching, &key), (void *)NULL);
+}
+
+struct RangeIndexEntry
+{
+  unsigned long long start;
+  unsigned long long end;
+  unsigned long long max_end;
+};
+
+struct RangeIndex
+{
+  RangeIndexEntry *p_entries;
+  unsigned int capacity;
+  unsigned int entries_num;
+  unsigned char built;
+};
+
+extern "C" {
+unsigned long long RangeIndexInit(RangeIndex *pIndex, unsigned int RangesNum);
+void RangeIndexFree(RangeIndex *pIndex);
+unsigned long long RangeIndexInsert(RangeIndex *pIndex, unsigned long long Start, unsigned long long Length);
+unsigned long long RangeIndexBuild(RangeIndex *pIndex);
+unsigned char RangeIndexOverlaps(RangeIndex *pIndex, unsigned long long Address, unsigned long long Length);
+}
+
+struct AddressRange
+{
+  unsigned long long start;
+  unsigned long long length;
+};
+
+// Reference for the index, the per record scan of the ARS list it replaced
+static bool RangesOverlapLinear(const std::vector<AddressRange> &ranges, unsigned long long address,
+  unsigned long long length)
+{
+  if (length == 0) {
+    return false;
+  }
+  for (const AddressRange &range : ranges) {
+    if (range.length != 0 && range.start <= address + length - 1 && address <= range.start + range.length - 1) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static std::vector<AddressRange> RandomRanges(size_t count, unsigned long long space, unsigned long long max_length)
+{
+  std::vector<AddressRange> ranges(count);
+
+  for (AddressRange &range : ranges) {
+    range.start = (unsigned long long)rand() % space;
+    range.length = (unsigned long long)rand() % (max_length + 1);
+  }
+  return ranges;
+}
+
+static void BuildRangeIndex(RangeIndex *p_index, const std::vector<AddressRange> &ranges)
+{
+  ASSERT_EQ(RangeIndexInit(p_index, (unsigned int)ranges.size()), EFI_SUCCESS);
+  for (const AddressRange &range : ranges) {
+    ASSERT_EQ(RangeIndexInsert(p_index, range.start, range.length), EFI_SUCCESS);
+  }
+  ASSERT_EQ(RangeIndexBuild(p_index), EFI_SUCCESS);
+}
+
+TEST_F(Utility_Tests, RangeIndexRandomizedMatchesLinearScan)
+{
+  const size_t sizes[] = {0, 1, 2, 5, 64, 1000};
+
+  srand(26);
+  for (size_t size : sizes) {
+    for (unsigned int round = 0; round < 10; round++) {
+      // Long ranges in a small space nest and overlap, short ones in a large space leave gaps
+      std::vector<AddressRange> ranges = (round % 2) ? RandomRanges(size, 0x1000, 0x200) : RandomRanges(size, 0x100000, 0x10);
+      RangeIndex index = {NULL, 0, 0, 0};
+
+      BuildRangeIndex(&index, ranges);
+      for (unsigned int query = 0; query < 2000; query++) {
+        unsigned long long address = (unsigned long long)rand() % 0x101000;
+        unsigned long long length = (unsigned long long)rand() % 0x40;
+
+        ASSERT_EQ((bool)RangeIndexOverlaps(&index, address, length), RangesOverlapLinear(ranges, address, length))
+          << "size " << size << " address 0x" << std::hex << address << " length 0x" << length;
+      }
+      RangeIndexFree(&index);
+    }
+  }
+}
+
+TEST_F(Utility_Tests, RangeIndexHandlesAddressSpaceEnd)
+{
+  RangeIndex index = {NULL, 0, 0, 0};
+
+  BuildRangeIndex(&index, {{0xFFFFFFFFFFFFF000ULL, 0x2000}, {0x1000, 0x10}});
+  EXPECT_TRUE(RangeIndexOverlaps(&index, 0xFFFFFFFFFFFFFFFFULL, 1));
+  EXPECT_TRUE(RangeIndexOverlaps(&index, 0xFFFFFFFFFFFFFF00ULL, 0x1000));
+  EXPECT_FALSE(RangeIndexOverlaps(&index, 0x1010, 0xFFFFFFFFFFFFDFF0ULL));
+  EXPECT_TRUE(RangeIndexOverlaps(&index, 0x1010, 0xFFFFFFFFFFFFDFF1ULL));
+  EXPECT_FALSE(RangeIndexOverlaps(&index, 0x1000, 0));
+
+  // An index that is not built answers no overlap, as when the ARS list is not loaded
+  RangeIndexFree(&index);
+  EXPECT_FALSE(RangeIndexOverlaps(&index, 0x1000, 0x10));
+  ASSERT_EQ(RangeIndexInit(&index, 1), EFI_SUCCESS);
+  ASSERT_EQ(RangeIndexInsert(&index, 0x1000, 0x10), EFI_SUCCESS);
+  EXPECT_NE(RangeIndexInsert(&index, 0x2000, 0x10), EFI_SUCCESS);
+  EXPECT_FALSE(RangeIndexOverlaps(&index, 0x1000, 0x10));
+  RangeIndexFree(&index);
+}
+
+TEST_F(Utility_Tests, RangeIndexBenchmark)
+{
+  const size_t records_num = 10000;
+  const size_t queries_num = 10000;
+  std::vector<AddressRange> ranges;
+  std::vector<AddressRange> queries;
+  RangeIndex index = {NULL, 0, 0, 0};
+  size_t index_hits = 0;
+  size_t linear_hits = 0;
+
+  srand(10);
+  ranges = RandomRanges(records_num, 1ULL << 40, 0x1000);
+  queries = RandomRanges(queries_num, 1ULL << 40, 0x10000);
+
+  auto start = std::chrono::steady_clock::now();
+  BuildRangeIndex(&index, ranges);
+  for (const AddressRange &query : queries) {
+    index_hits += RangeIndexOverlaps(&index, query.start, query.length);
+  }
+  auto index_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  for (const AddressRange &query : queries) {
+    linear_hits += RangesOverlapLinear(ranges, query.start, query.length);
+  }
+  auto linear_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(index_hits, linear_hits);
+  std::cout << records_num << " ARS records, " << queries_num << " checks: index " << index_us
+    << " us (with build), linear scan " << linear_us << " us" << std::endl;
+  EXPECT_LT(index_us, linear_us);
+  RangeIndexFree(&index);
+}
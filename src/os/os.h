@@ -72,11 +72,30 @@ struct nvm_driver_capabilities
 extern void os_get_locale_dir(OS_PATH locale_dir);
 extern char * os_get_cwd(OS_PATH buffer, size_t size);
 extern int os_mkdir(char *path);
+/*
+ Exclusive advisory lock shared by the processes using the file, the lock is taken
+ on a companion "<path>.lock" file. Returns NULL on error.
+*/
+extern void *os_lock_file(const char *path);
+extern void os_unlock_file(void *p_lock);
+/*
+ Atomically replace the file content: the data is written to a temporary file in
+ the same directory, flushed to the disk and renamed over the file.
+ Return 0 on success, -1 on error
+*/
+extern int os_replace_file(const char *path, const char *p_data, size_t size);
+extern void *os_map_file(const char *path, unsigned long long *p_size);
+extern int os_unmap_file(void *p_addr, unsigned long long size);
 
 extern int os_start_process(const char *process_name, unsigned int *p_process_id);
 extern int os_stop_process(unsigned int process_id);
 extern void os_sleep(unsigned long time);
-extern void os_create_thread(unsigned long long *p_thread_id, void *(*callback)(void *), void *callback_arg);
+/*
+ Returns 0 when the thread was started, p_thread_id is only valid then.
+ Every started thread must be joined with os_join_thread, which releases it.
+*/
+extern int os_create_thread(unsigned long long *p_thread_id, void *(*callback)(void *), void *callback_arg);
+extern int os_join_thread(unsigned long long thread_id);
 extern unsigned long long os_get_thread_id();
 
 extern OS_MUTEX *os_mutex_init(const char *name);
@@ -99,6 +99,7 @@ struct fw_cmd {
    unsigned char SubOpcode;
    unsigned char Status;
    unsigned char DsmStatus;
+   unsigned char *pLargeOutputBuffer; // Optional, receives the large output payload instead of LargeOutputPayload
 };
 #pragma pack(pop)
 
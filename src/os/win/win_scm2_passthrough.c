@@ -38,7 +38,8 @@ int win_scm2_passthrough(struct fw_cmd *p_cmd, unsigned int *p_dsm_status)
       p_cmd->OutPayload, p_cmd->OutputPayloadSize);
 
   scm_err = read_large_ouptut_payload(scm_err, p_dsm_status, p_cmd->DimmID,
-      p_cmd->LargeOutputPayload, p_cmd->LargeOutputPayloadSize);
+      (p_cmd->pLargeOutputBuffer != NULL) ? p_cmd->pLargeOutputBuffer : p_cmd->LargeOutputPayload,
+      p_cmd->LargeOutputPayloadSize);
 
   return scm_err;
 }
@@ -106,6 +106,60 @@ int os_start_process(const char *process_name, unsigned int *p_process_id)
 	return rc;
 }
 
+/*
+ * Map a file copy-on-write into memory.
+ * Changes made through the mapping are never written back to the file.
+ */
+void *os_map_file(const char *path, unsigned long long *p_size)
+{
+	void *p_addr = NULL;
+	HANDLE mapping = NULL;
+	LARGE_INTEGER size;
+	HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+			NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+	if (file == INVALID_HANDLE_VALUE || p_size == NULL)
+	{
+		goto finish;
+	}
+
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		goto finish;
+	}
+
+	mapping = CreateFileMapping(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if (mapping == NULL)
+	{
+		goto finish;
+	}
+
+	p_addr = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+	if (p_addr)
+	{
+		*p_size = (unsigned long long)size.QuadPart;
+	}
+
+finish:
+	if (mapping)
+	{
+		CloseHandle(mapping);
+	}
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file);
+	}
+	return p_addr;
+}
+
+/*
+ * Unmap a mapping created with os_map_file
+ */
+int os_unmap_file(void *p_addr, unsigned long long size)
+{
+	return UnmapViewOfFile(p_addr) ? 0 : -1;
+}
+
 /*
  * Stop a process given the process handle
  */
@@ -139,17 +193,42 @@ void os_sleep(unsigned long time)
 }
 
 /*
- * Create a thread on the current process
+ * Create a thread on the current process, returns 0 on success
  */
-void os_create_thread(unsigned long long *p_thread_id, void *(*callback)(void *), void * callback_arg)
+int os_create_thread(unsigned long long *p_thread_id, void *(*callback)(void *), void * callback_arg)
 {
-	CreateThread(
+	HANDLE handle = CreateThread(
 			NULL, // default security
 			0,  // default stack size
 			(LPTHREAD_START_ROUTINE)callback,
 			(LPVOID)callback_arg,
 			0, // Immediately run thread
-			(LPDWORD)p_thread_id);
+			NULL);
+	if (handle == NULL)
+	{
+		return -1;
+	}
+	// The id of an exited thread can be reused, keep the handle until os_join_thread
+	*p_thread_id = (unsigned long long)(UINT_PTR)handle;
+	return 0;
+}
+
+/*
+ * Wait for a thread created with os_create_thread to finish
+ */
+int os_join_thread(unsigned long long thread_id)
+{
+	int rc = -1;
+	HANDLE handle = (HANDLE)(UINT_PTR)thread_id;
+	if (handle)
+	{
+		if (WaitForSingleObject(handle, INFINITE) == WAIT_OBJECT_0)
+		{
+			rc = 0;
+		}
+		CloseHandle(handle);
+	}
+	return rc;
 }
 
 /*
@@ -969,6 +1048,90 @@ int os_mkdir(char *path)
   return 0;
 }
 
+/*
+* Take an exclusive advisory lock on "<path>.lock", NULL on error
+*/
+void *os_lock_file(const char *path)
+{
+	char lock_path[OS_PATH_LEN];
+	OVERLAPPED overlapped = { 0 };
+	HANDLE h_lock;
+
+	snprintf(lock_path, sizeof(lock_path), "%s.lock", path);
+	h_lock = CreateFileA(lock_path, GENERIC_READ | GENERIC_WRITE,
+		FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == h_lock)
+	{
+		return NULL;
+	}
+	if (!LockFileEx(h_lock, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped))
+	{
+		CloseHandle(h_lock);
+		return NULL;
+	}
+	return h_lock;
+}
+
+void os_unlock_file(void *p_lock)
+{
+	OVERLAPPED overlapped = { 0 };
+
+	if (NULL == p_lock)
+	{
+		return;
+	}
+	UnlockFileEx((HANDLE)p_lock, 0, MAXDWORD, MAXDWORD, &overlapped);
+	CloseHandle((HANDLE)p_lock);
+}
+
+/*
+* Write the data to a temporary file, flush it and move it over the path,
+* return 0 on success, -1 on error
+*/
+int os_replace_file(const char *path, const char *p_data, size_t size)
+{
+	char tmp_path[OS_PATH_LEN];
+	HANDLE h_file;
+	DWORD written = 0;
+	size_t offset = 0;
+
+	snprintf(tmp_path, sizeof(tmp_path), "%s.%lu.tmp", path, GetCurrentProcessId());
+	h_file = CreateFileA(tmp_path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == h_file)
+	{
+		return -1;
+	}
+
+	while (offset < size)
+	{
+		if (!WriteFile(h_file, p_data + offset, (DWORD)(size - offset), &written, NULL))
+		{
+			goto Error;
+		}
+		offset += written;
+	}
+	if (!FlushFileBuffers(h_file))
+	{
+		goto Error;
+	}
+	CloseHandle(h_file);
+	h_file = INVALID_HANDLE_VALUE;
+
+	if (!MoveFileExA(tmp_path, path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+	{
+		goto Error;
+	}
+	return 0;
+
+Error:
+	if (INVALID_HANDLE_VALUE != h_file)
+	{
+		CloseHandle(h_file);
+	}
+	DeleteFileA(tmp_path);
+	return -1;
+}
+
 /*
  Get CPUID info for windows. Depending on the inputRequestType,
   regs[0...3] will be populated with register values eax....edx